@@ -0,0 +1,268 @@
+/* THIS FILE IS GENERATED BY gen_metrics.py. DO NOT HAND EDIT. */
+
+#include "../fd_metrics_base.h"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_OFF  (174UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_SUCCESS_OFF  (174UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_SUCCESS_NAME "quic_tile_non_quic_reassembly_append_success"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_SUCCESS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_SUCCESS_DESC "Result of fragment reassembly for a non-QUIC UDP transaction. (Success)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_OVERSIZE_OFF  (175UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_OVERSIZE_NAME "quic_tile_non_quic_reassembly_append_error_oversize"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_OVERSIZE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_OVERSIZE_DESC "Result of fragment reassembly for a non-QUIC UDP transaction. (Oversize message)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_SKIP_OFF  (176UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_SKIP_NAME "quic_tile_non_quic_reassembly_append_error_skip"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_SKIP_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_SKIP_DESC "Result of fragment reassembly for a non-QUIC UDP transaction. (Out-of-order data within QUIC stream)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_STATE_OFF  (177UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_STATE_NAME "quic_tile_non_quic_reassembly_append_error_state"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_STATE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_ERROR_STATE_DESC "Result of fragment reassembly for a non-QUIC UDP transaction. (Unexpected slot state)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_OFF  (178UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_SUCCESS_OFF  (178UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_SUCCESS_NAME "quic_tile_non_quic_reassembly_publish_success"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_SUCCESS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_SUCCESS_DESC "Result of publishing reassmbled fragment for a non-QUIC UDP transaction. (Success)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_OFF  (179UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_NAME "quic_tile_non_quic_reassembly_publish_error_oversize"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_DESC "Result of publishing reassmbled fragment for a non-QUIC UDP transaction. (Oversize message)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_SKIP_OFF  (180UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_SKIP_NAME "quic_tile_non_quic_reassembly_publish_error_skip"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_SKIP_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_SKIP_DESC "Result of publishing reassmbled fragment for a non-QUIC UDP transaction. (Out-of-order data within QUIC stream)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_STATE_OFF  (181UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_STATE_NAME "quic_tile_non_quic_reassembly_publish_error_state"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_STATE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_ERROR_STATE_DESC "Result of publishing reassmbled fragment for a non-QUIC UDP transaction. (Unexpected slot state)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_OFF  (182UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_SUCCESS_OFF  (182UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_SUCCESS_NAME "quic_tile_reassembly_append_success"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_SUCCESS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_SUCCESS_DESC "Result of fragment reassembly for a QUIC transaction. (Success)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_OVERSIZE_OFF  (183UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_OVERSIZE_NAME "quic_tile_reassembly_append_error_oversize"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_OVERSIZE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_OVERSIZE_DESC "Result of fragment reassembly for a QUIC transaction. (Oversize message)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_SKIP_OFF  (184UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_SKIP_NAME "quic_tile_reassembly_append_error_skip"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_SKIP_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_SKIP_DESC "Result of fragment reassembly for a QUIC transaction. (Out-of-order data within QUIC stream)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_STATE_OFF  (185UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_STATE_NAME "quic_tile_reassembly_append_error_state"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_STATE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_APPEND_ERROR_STATE_DESC "Result of fragment reassembly for a QUIC transaction. (Unexpected slot state)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_OFF  (186UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_SUCCESS_OFF  (186UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_SUCCESS_NAME "quic_tile_reassembly_publish_success"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_SUCCESS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_SUCCESS_DESC "Result of publishing reassmbled fragment for a QUIC transaction. (Success)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_OFF  (187UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_NAME "quic_tile_reassembly_publish_error_oversize"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_OVERSIZE_DESC "Result of publishing reassmbled fragment for a QUIC transaction. (Oversize message)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_SKIP_OFF  (188UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_SKIP_NAME "quic_tile_reassembly_publish_error_skip"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_SKIP_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_SKIP_DESC "Result of publishing reassmbled fragment for a QUIC transaction. (Out-of-order data within QUIC stream)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_STATE_OFF  (189UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_STATE_NAME "quic_tile_reassembly_publish_error_state"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_STATE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_PUBLISH_ERROR_STATE_DESC "Result of publishing reassmbled fragment for a QUIC transaction. (Unexpected slot state)"
+
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_NOTIFY_CLOBBERED_OFF  (190UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_NOTIFY_CLOBBERED_NAME "quic_tile_reassembly_notify_clobbered"
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_NOTIFY_CLOBBERED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_REASSEMBLY_NOTIFY_CLOBBERED_DESC "Reassembly slot was clobbered before it was notified."
+
+#define FD_METRICS_COUNTER_QUIC_TILE_QUIC_PACKET_TOO_SMALL_OFF  (191UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_QUIC_PACKET_TOO_SMALL_NAME "quic_tile_quic_packet_too_small"
+#define FD_METRICS_COUNTER_QUIC_TILE_QUIC_PACKET_TOO_SMALL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_QUIC_PACKET_TOO_SMALL_DESC "Count of packets received on the QUIC port that were too small to be a valid IP packet."
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_SMALL_OFF  (192UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_SMALL_NAME "quic_tile_non_quic_packet_too_small"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_SMALL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_SMALL_DESC "Count of packets received on the non-QUIC port that were too small to be a valid IP packet."
+
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_LARGE_OFF  (193UL)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_LARGE_NAME "quic_tile_non_quic_packet_too_large"
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_LARGE_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_PACKET_TOO_LARGE_DESC "Count of packets received on the non-QUIC port that were too large to be a valid transaction."
+
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_PACKETS_OFF  (194UL)
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_PACKETS_NAME "quic_received_packets"
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_PACKETS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_PACKETS_DESC "Number of IP packets received."
+
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_BYTES_OFF  (195UL)
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_BYTES_NAME "quic_received_bytes"
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_BYTES_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_RECEIVED_BYTES_DESC "Total bytes received (including IP, UDP, QUIC headers)."
+
+#define FD_METRICS_COUNTER_QUIC_SENT_PACKETS_OFF  (196UL)
+#define FD_METRICS_COUNTER_QUIC_SENT_PACKETS_NAME "quic_sent_packets"
+#define FD_METRICS_COUNTER_QUIC_SENT_PACKETS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_SENT_PACKETS_DESC "Number of IP packets sent."
+
+#define FD_METRICS_COUNTER_QUIC_SENT_BYTES_OFF  (197UL)
+#define FD_METRICS_COUNTER_QUIC_SENT_BYTES_NAME "quic_sent_bytes"
+#define FD_METRICS_COUNTER_QUIC_SENT_BYTES_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_SENT_BYTES_DESC "Total bytes sent (including IP, UDP, QUIC headers)."
+
+#define FD_METRICS_GAUGE_QUIC_CONNECTIONS_ACTIVE_OFF  (198UL)
+#define FD_METRICS_GAUGE_QUIC_CONNECTIONS_ACTIVE_NAME "quic_connections_active"
+#define FD_METRICS_GAUGE_QUIC_CONNECTIONS_ACTIVE_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_QUIC_CONNECTIONS_ACTIVE_DESC "The number of currently active QUIC connections."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CREATED_OFF  (199UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CREATED_NAME "quic_connections_created"
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CREATED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CREATED_DESC "The total number of connections that have been created."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CLOSED_OFF  (200UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CLOSED_NAME "quic_connections_closed"
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CLOSED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_CLOSED_DESC "Number of connections gracefully closed."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_ABORTED_OFF  (201UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_ABORTED_NAME "quic_connections_aborted"
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_ABORTED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_ABORTED_DESC "Number of connections aborted."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_RETRIED_OFF  (202UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_RETRIED_NAME "quic_connections_retried"
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_RETRIED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTIONS_RETRIED_DESC "Number of connections established with retry."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_NO_SLOTS_OFF  (203UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_NO_SLOTS_NAME "quic_connection_error_no_slots"
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_NO_SLOTS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_NO_SLOTS_DESC "Number of connections that failed to create due to lack of slots."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_TLS_FAIL_OFF  (204UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_TLS_FAIL_NAME "quic_connection_error_tls_fail"
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_TLS_FAIL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_TLS_FAIL_DESC "Number of connections that aborted due to TLS failure."
+
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_RETRY_FAIL_OFF  (205UL)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_RETRY_FAIL_NAME "quic_connection_error_retry_fail"
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_RETRY_FAIL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_CONNECTION_ERROR_RETRY_FAIL_DESC "Number of connections that failed during retry (e.g. invalid token)."
+
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKES_CREATED_OFF  (206UL)
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKES_CREATED_NAME "quic_handshakes_created"
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKES_CREATED_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKES_CREATED_DESC "Number of handshake flows created."
+
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKE_ERROR_ALLOC_FAIL_OFF  (207UL)
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKE_ERROR_ALLOC_FAIL_NAME "quic_handshake_error_alloc_fail"
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKE_ERROR_ALLOC_FAIL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_HANDSHAKE_ERROR_ALLOC_FAIL_DESC "Number of handshakes dropped due to alloc fail."
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_OFF  (208UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_CLIENT_OFF  (208UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_CLIENT_NAME "quic_stream_opened_bidi_client"
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_CLIENT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_CLIENT_DESC "Number of streams opened. (Bidirectional client)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_SERVER_OFF  (209UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_SERVER_NAME "quic_stream_opened_bidi_server"
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_SERVER_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_BIDI_SERVER_DESC "Number of streams opened. (Bidirectional server)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_CLIENT_OFF  (210UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_CLIENT_NAME "quic_stream_opened_uni_client"
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_CLIENT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_CLIENT_DESC "Number of streams opened. (Unidirectional client)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_SERVER_OFF  (211UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_SERVER_NAME "quic_stream_opened_uni_server"
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_SERVER_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_OPENED_UNI_SERVER_DESC "Number of streams opened. (Unidirectional server)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_OFF  (212UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_CNT  (4UL)
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_CLIENT_OFF  (212UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_CLIENT_NAME "quic_stream_closed_bidi_client"
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_CLIENT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_CLIENT_DESC "Number of streams closed. (Bidirectional client)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_SERVER_OFF  (213UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_SERVER_NAME "quic_stream_closed_bidi_server"
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_SERVER_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_BIDI_SERVER_DESC "Number of streams closed. (Bidirectional server)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_CLIENT_OFF  (214UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_CLIENT_NAME "quic_stream_closed_uni_client"
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_CLIENT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_CLIENT_DESC "Number of streams closed. (Unidirectional client)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_SERVER_OFF  (215UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_SERVER_NAME "quic_stream_closed_uni_server"
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_SERVER_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_CLOSED_UNI_SERVER_DESC "Number of streams closed. (Unidirectional server)"
+
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_OFF  (216UL)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_CNT  (4UL)
+
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_CLIENT_OFF  (216UL)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_CLIENT_NAME "quic_stream_active_bidi_client"
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_CLIENT_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_CLIENT_DESC "Number of active streams. (Bidirectional client)"
+
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_SERVER_OFF  (217UL)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_SERVER_NAME "quic_stream_active_bidi_server"
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_SERVER_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_BIDI_SERVER_DESC "Number of active streams. (Bidirectional server)"
+
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_CLIENT_OFF  (218UL)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_CLIENT_NAME "quic_stream_active_uni_client"
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_CLIENT_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_CLIENT_DESC "Number of active streams. (Unidirectional client)"
+
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_SERVER_OFF  (219UL)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_SERVER_NAME "quic_stream_active_uni_server"
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_SERVER_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_QUIC_STREAM_ACTIVE_UNI_SERVER_DESC "Number of active streams. (Unidirectional server)"
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_EVENTS_OFF  (220UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_EVENTS_NAME "quic_stream_received_events"
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_EVENTS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_EVENTS_DESC "Number of stream RX events."
+
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_BYTES_OFF  (221UL)
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_BYTES_NAME "quic_stream_received_bytes"
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_BYTES_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_QUIC_STREAM_RECEIVED_BYTES_DESC "Total stream payload bytes received."
+
+
+#define FD_METRICS_QUIC_TOTAL (48UL)
+extern const fd_metrics_meta_t FD_METRICS_QUIC[FD_METRICS_QUIC_TOTAL];
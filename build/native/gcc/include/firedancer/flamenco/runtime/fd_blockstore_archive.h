@@ -0,0 +1,338 @@
+#ifndef HEADER_fd_src_flamenco_runtime_fd_blockstore_archive_h
+#define HEADER_fd_src_flamenco_runtime_fd_blockstore_archive_h
+
+/* fd_blockstore_archive is an on-disk archival tier for fd_blockstore.
+
+   The blockstore only keeps a bounded window of slots in memory.  The
+   archive tails the blockstore's finalized root and appends every
+   finalized block to an append-only file before the blockstore evicts
+   it, so that transaction queries and repair requests can still be
+   answered for slots that have left the in-memory window.
+
+   The file is a sequence of self-describing block records and is meant
+   to be mmap'd read-only.  All offsets inside a record are relative to
+   the record, so the file can be mapped at any address by any process.
+
+   | file hdr | rec 0 | rec 1 | ... | rec n-1 |
+
+   Each record is laid out as follows (every region is aligned to
+   FD_BLOCKSTORE_ARCHIVE_REC_ALIGN):
+
+   | rec hdr | shreds | micros | txns | merkle proofs | block data |
+
+   Shreds are stored in a compact form (the data shred header and a
+   reference into the merkle proof region) rather than as fixed-size
+   fd_block_shred_t, which carry room for the deepest possible proof.
+
+   The slot index (slot->record) and the txn signature index
+   (sig->record, txn) are kept in memory by every join and are rebuilt
+   by scanning the file on open.  Records are published by writing the
+   record header last, so fd_blockstore_archive_refresh can be used by
+   read-only joins to pick up records appended by the writer.
+
+   An archive is a local object, as it holds a file descriptor and a
+   mapping that are only valid in the process that created them.  There
+   should be at most one writer per archive file.  Within a process, the
+   query APIs may be called concurrently with appends from another
+   thread, but not concurrently with open or close. */
+
+#include "fd_blockstore.h"
+
+/* clang-format off */
+#define FD_BLOCKSTORE_ARCHIVE_ALIGN     (128UL)
+#define FD_BLOCKSTORE_ARCHIVE_MAGIC     (0xf17eda2ce7a2c400UL) /* firedancer archive version 0 */
+#define FD_BLOCKSTORE_ARCHIVE_REC_MAGIC (0xf17eda2ce7a2c4ecUL) /* firedancer archive record    */
+#define FD_BLOCKSTORE_ARCHIVE_REC_ALIGN (64UL)
+/* clang-format on */
+
+/* fd_blockstore_archive_hdr is the header at the start of an archive
+   file.  The first record starts at FD_BLOCKSTORE_ARCHIVE_REC_ALIGN. */
+
+struct fd_blockstore_archive_hdr {
+  ulong magic;
+  ulong rec_cnt_hint; /* records in the file as of the last clean close, informational only */
+};
+typedef struct fd_blockstore_archive_hdr fd_blockstore_archive_hdr_t;
+
+/* fd_blockstore_archive_rec is the header of an archived block.  The
+   *_off fields are byte offsets from the start of the record. */
+
+struct fd_blockstore_archive_rec {
+  ulong     magic;       /* FD_BLOCKSTORE_ARCHIVE_REC_MAGIC, written last */
+  ulong     rec_sz;      /* total record size, multiple of FD_BLOCKSTORE_ARCHIVE_REC_ALIGN */
+  ulong     slot;
+  ulong     parent_slot;
+  long      ts;          /* timestamp in nanosecs */
+  ulong     height;      /* block height */
+  fd_hash_t bank_hash;
+  ulong     flags;       /* fd_block_t flags at the time the block was archived */
+  ulong     shreds_off;  /* fd_blockstore_archive_shred_t[shreds_cnt] */
+  ulong     shreds_cnt;
+  ulong     micros_off;  /* fd_block_micro_t[micros_cnt] */
+  ulong     micros_cnt;
+  ulong     txns_off;    /* fd_block_txn_ref_t[txns_cnt] */
+  ulong     txns_cnt;
+  ulong     merkle_off;  /* merkle proofs of all shreds, back to back */
+  ulong     merkle_sz;
+  ulong     data_off;    /* block data */
+  ulong     data_sz;
+};
+typedef struct fd_blockstore_archive_rec fd_blockstore_archive_rec_t;
+
+/* fd_blockstore_archive_shred is the compact form of fd_block_shred_t.
+   merkle_off is relative to the record's merkle region and off is
+   relative to the record's data region. */
+
+struct fd_blockstore_archive_shred {
+  uchar hdr[FD_SHRED_DATA_HEADER_SZ]; /* data shred header */
+  uint  merkle_off;
+  uint  merkle_sz;
+  ulong off;
+};
+typedef struct fd_blockstore_archive_shred fd_blockstore_archive_shred_t;
+
+struct fd_blockstore_archive_slot {
+  ulong slot;
+  ulong next;
+  ulong rec_off; /* offset of the record in the file */
+};
+typedef struct fd_blockstore_archive_slot fd_blockstore_archive_slot_t;
+
+/* clang-format off */
+#define MAP_NAME         fd_blockstore_archive_slot_map
+#define MAP_T            fd_blockstore_archive_slot_t
+#define MAP_KEY          slot
+#include "../../util/tmpl/fd_map_giant.c"
+/* clang-format on */
+
+struct fd_blockstore_archive_txn {
+  fd_blockstore_txn_key_t sig;
+  ulong                   next;
+  ulong                   rec_off; /* offset of the record in the file */
+  ulong                   txn_idx; /* index into the record's txns */
+};
+typedef struct fd_blockstore_archive_txn fd_blockstore_archive_txn_t;
+
+/* clang-format off */
+#define MAP_NAME             fd_blockstore_archive_txn_map
+#define MAP_T                fd_blockstore_archive_txn_t
+#define MAP_KEY              sig
+#define MAP_KEY_T            fd_blockstore_txn_key_t
+#define MAP_KEY_EQ(k0,k1)    fd_blockstore_txn_key_equal(k0,k1)
+#define MAP_KEY_HASH(k,seed) fd_blockstore_txn_key_hash(k, seed)
+#include "../../util/tmpl/fd_map_giant.c"
+/* clang-format on */
+
+#define FD_BLOCKSTORE_ARCHIVE_MERKLE_MAX (FD_SHRED_MERKLE_ROOT_SZ + FD_SHRED_MERKLE_NODE_SZ*9U)
+
+struct __attribute__((aligned(FD_BLOCKSTORE_ARCHIVE_ALIGN))) fd_blockstore_archive_private {
+  ulong magic;
+  ulong seed;
+  ulong slot_max;   /* capacity of the slot index */
+  int   lg_txn_max; /* capacity of the txn index */
+
+  /* Concurrency: the indices may be queried by other threads while the
+     writer appends.  Records themselves are immutable once indexed. */
+
+  fd_readwrite_lock_t lock;
+
+  /* File */
+
+  int           fd;        /* -1 if not open */
+  long          pid;       /* process that opened the file, the mapping is only valid there */
+  int           writable;
+  uchar const * map;       /* read-only mapping of the first file_max bytes of the file */
+  ulong         file_max;  /* max size of the file */
+  ulong         file_sz;   /* bytes of the file covered by valid records */
+  ulong         rec_cnt;   /* valid records in the file, indexed or not */
+
+  /* Indices */
+
+  fd_blockstore_archive_slot_t * slot_map;
+  fd_blockstore_archive_txn_t *  txn_map;
+  ulong                          idx_off; /* offset of the oldest indexed record */
+  ulong                          slot_lo; /* min slot indexed, ULONG_MAX if none */
+  ulong                          slot_hi; /* max slot archived, 0 if none */
+
+  /* Scratch */
+
+  ulong * path;     /* slot_max slots, used by sync */
+  uchar * stage;    /* process-local record image, grown on demand by the writer */
+  ulong   stage_sz;
+};
+typedef struct fd_blockstore_archive_private fd_blockstore_archive_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* Construction API */
+
+/* fd_blockstore_archive_{align,footprint} return the required alignment
+   and footprint of a memory region suitable for use as an archive with
+   an index of up to slot_max slots and 2^lg_txn_max txn signatures.
+   The indices cover the most recent records of the file.  Once either
+   is full, the oldest records are dropped from both indices (but not
+   from the file) to make room. */
+
+FD_FN_CONST ulong
+fd_blockstore_archive_align( void );
+
+FD_FN_CONST ulong
+fd_blockstore_archive_footprint( ulong slot_max, int lg_txn_max );
+
+/* fd_blockstore_archive_new formats an unused memory region for use as
+   an archive.  Returns shmem on success and NULL on failure (logs
+   details).  The archive is not attached to a file until
+   fd_blockstore_archive_open. */
+
+void *
+fd_blockstore_archive_new( void * shmem, ulong seed, ulong slot_max, int lg_txn_max );
+
+fd_blockstore_archive_t *
+fd_blockstore_archive_join( void * sharchive );
+
+void *
+fd_blockstore_archive_leave( fd_blockstore_archive_t * archive );
+
+void *
+fd_blockstore_archive_delete( void * sharchive );
+
+/* fd_blockstore_archive_open attaches the archive to the file at path.
+   If writable, the file is created if it does not exist and the archive
+   may be appended to until the file reaches file_max bytes.  Existing
+   records are indexed.  A torn record at the end of the file (e.g. the
+   writer crashed while appending) is ignored, and truncated away if
+   writable.  Valid records are never truncated, even if they do not
+   fit in the indices.  Returns FD_BLOCKSTORE_OK on success and an FD_BLOCKSTORE_ERR
+   code on failure (logs details). */
+
+int
+fd_blockstore_archive_open( fd_blockstore_archive_t * archive,
+                            char const *              path,
+                            ulong                     file_max,
+                            int                       writable );
+
+/* fd_blockstore_archive_close detaches the archive from its file and
+   clears the indices. */
+
+void
+fd_blockstore_archive_close( fd_blockstore_archive_t * archive );
+
+/* fd_blockstore_archive_refresh indexes any records appended to the file
+   since the last open or refresh, e.g. by a writer in another process.
+   Returns the number of newly indexed records. */
+
+ulong
+fd_blockstore_archive_refresh( fd_blockstore_archive_t * archive );
+
+/* Operations */
+
+/* fd_blockstore_archive_block appends the block at slot to the archive.
+   Returns FD_BLOCKSTORE_OK on success (including if the slot is still
+   indexed), FD_BLOCKSTORE_ERR_SLOT_MISSING if the slot does not have a
+   complete block, FD_BLOCKSTORE_ERR_NO_MEM if the file is full or the
+   staging buffer cannot be grown and FD_BLOCKSTORE_ERR_UNKNOWN on an I/O
+   error.
+
+   The block is copied out under the blockstore read lock, which is
+   released before the file is written.  The caller must not hold the
+   blockstore lock. */
+
+int
+fd_blockstore_archive_block( fd_blockstore_archive_t * archive,
+                             fd_blockstore_t *         blockstore,
+                             ulong                     slot );
+
+/* fd_blockstore_archive_sync archives every block on the path from
+   root back to the most recently archived slot (or as far back as the
+   blockstore has blocks), oldest first.  root should be a finalized
+   slot, e.g. the super-majority root, so that only blocks that cannot be
+   pruned by fork choice are archived.  Calling this at least once per
+   slot_max slots guarantees that no finalized block is evicted from the
+   blockstore before it is archived.  Takes the blockstore read lock
+   while walking the path and copying out each block, never across file
+   I/O.  Returns the number of blocks archived. */
+
+ulong
+fd_blockstore_archive_sync( fd_blockstore_archive_t * archive,
+                            fd_blockstore_t *         blockstore,
+                            ulong                     root );
+
+/* fd_blockstore_archive_attach makes fd_blockstore_txn_query_volatile
+   fall back to archive for transactions no longer in the blockstore.
+   archive must be in the same wksp as blockstore.  Lookups only hit the
+   archive in the process that opened it, other joiners of the
+   blockstore see the transaction as missing.
+   fd_blockstore_archive_detach undoes it, and must be called before the
+   archive is closed or deleted.  Both take the blockstore write lock. */
+
+void
+fd_blockstore_archive_attach( fd_blockstore_archive_t * archive,
+                              fd_blockstore_t *         blockstore );
+
+void
+fd_blockstore_archive_detach( fd_blockstore_t * blockstore );
+
+/* Queries
+
+   These return pointers into / copies out of the read-only mapping and
+   do not touch the blockstore.  Returned pointers are valid until the
+   archive is closed.  Only records still in the indices are found. */
+
+/* fd_blockstore_archive_rec_query returns the record for slot, or NULL
+   if the slot is not archived. */
+
+fd_blockstore_archive_rec_t const *
+fd_blockstore_archive_rec_query( fd_blockstore_archive_t * archive, ulong slot );
+
+FD_FN_PURE static inline uchar const *
+fd_blockstore_archive_rec_data( fd_blockstore_archive_rec_t const * rec ) {
+  return (uchar const *)rec + rec->data_off;
+}
+
+FD_FN_PURE static inline fd_blockstore_archive_shred_t const *
+fd_blockstore_archive_rec_shreds( fd_blockstore_archive_rec_t const * rec ) {
+  return (fd_blockstore_archive_shred_t const *)( (uchar const *)rec + rec->shreds_off );
+}
+
+FD_FN_PURE static inline fd_block_micro_t const *
+fd_blockstore_archive_rec_micros( fd_blockstore_archive_rec_t const * rec ) {
+  return (fd_block_micro_t const *)( (uchar const *)rec + rec->micros_off );
+}
+
+FD_FN_PURE static inline fd_block_txn_ref_t const *
+fd_blockstore_archive_rec_txns( fd_blockstore_archive_rec_t const * rec ) {
+  return (fd_block_txn_ref_t const *)( (uchar const *)rec + rec->txns_off );
+}
+
+/* fd_blockstore_archive_parent_slot_query returns the parent of slot, or
+   FD_SLOT_NULL if the slot is not archived. */
+
+ulong
+fd_blockstore_archive_parent_slot_query( fd_blockstore_archive_t * archive, ulong slot );
+
+/* fd_blockstore_archive_shred_query_copy_data reconstructs the data shred
+   at (slot, shred_idx) into buf, with the same semantics as
+   fd_buf_shred_query_copy_data.  shred_idx of UINT_MAX queries the last
+   shred of the slot.  Returns the shred size or -1 on failure. */
+
+long
+fd_blockstore_archive_shred_query_copy_data( fd_blockstore_archive_t * archive,
+                                             ulong                     slot,
+                                             uint                      shred_idx,
+                                             void *                    buf,
+                                             ulong                     buf_max );
+
+/* fd_blockstore_archive_txn_query looks up the transaction for sig with
+   the same semantics as fd_blockstore_txn_query_volatile.  txn_out
+   meta_gaddr is always 0, as transaction metadata is not archived. */
+
+int
+fd_blockstore_archive_txn_query( fd_blockstore_archive_t * archive,
+                                 uchar const               sig[static FD_ED25519_SIG_SZ],
+                                 fd_blockstore_txn_map_t * txn_out,
+                                 long *                    blk_ts,
+                                 uchar                     txn_data_out[FD_TXN_MTU] );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_fd_blockstore_archive_h */
@@ -0,0 +1,152 @@
+#ifndef HEADER_fd_src_flamenco_runtime_fd_hashes_h
+#define HEADER_fd_src_flamenco_runtime_fd_hashes_h
+
+#include "../fd_flamenco_base.h"
+#include "../types/fd_types.h"
+#include "../../funk/fd_funk.h"
+
+#define FD_PUBKEY_HASH_PAIR_ALIGN (16UL)
+struct __attribute__((aligned(FD_PUBKEY_HASH_PAIR_ALIGN))) fd_pubkey_hash_pair {
+  fd_pubkey_t const * pubkey;
+  fd_hash_t   const * hash;
+};
+typedef struct fd_pubkey_hash_pair fd_pubkey_hash_pair_t;
+#define FD_PUBKEY_HASH_PAIR_FOOTPRINT (sizeof(fd_pubkey_hash_pair_t))
+
+FD_PROTOTYPES_BEGIN
+
+void fd_hash_account_deltas( fd_pubkey_hash_pair_t * pairs, ulong pairs_len, fd_hash_t * hash, fd_exec_slot_ctx_t * slot_ctx );
+
+int fd_update_hash_bank( fd_exec_slot_ctx_t * slot_ctx,
+                         fd_capture_ctx_t * capture_ctx,
+                         fd_hash_t * hash,
+                         ulong signature_cnt );
+int
+fd_update_hash_bank_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                           fd_capture_ctx_t *   capture_ctx,
+                           fd_hash_t *          hash,
+                           ulong                signature_cnt,
+                           fd_tpool_t *         tpool,
+                           ulong                max_workers );
+
+int
+fd_print_account_hashes( fd_exec_slot_ctx_t * slot_ctx,
+                         fd_tpool_t *         tpool,
+                         ulong                max_workers );
+/* fd_hash_account_v0 is the legacy method to compute the account
+   hash.  It includes the following content:
+    - lamports
+    - slot
+    - rent_epoch
+    - data
+    - executable
+    - owner
+    - pubkey
+
+   Writes the resulting hash to hash, and returns hash. */
+
+void const *
+fd_hash_account_v0( uchar                     hash[ static 32 ],
+                    fd_account_meta_t const * account,
+                    uchar const               pubkey[ static 32 ],
+                    uchar const             * data,
+                    ulong                     slot );
+
+/* fd_hash_account_v1 was introduced in Oct-2022 via
+   https://github.com/solana-labs/solana/pull/28405 and is enabled via
+   the "account_hash_ignore_slot" feature gate.
+
+   It is like fd_hash_account_with_slot, but omits the slot param. */
+
+void const *
+fd_hash_account_v1( uchar                     hash  [ static 32 ],
+                    fd_account_meta_t const * account,
+                    uchar const               pubkey[ static 32 ],
+                    uchar const             * data );
+
+/* fd_hash_account_current chooses the correct account hash function
+   based on feature activation state. */
+
+void const *
+fd_hash_account_current( uchar                      hash  [ static 32 ],
+                         fd_account_meta_t const *  account,
+                         uchar const                pubkey[ static 32 ],
+                         uchar const *              data,
+                         fd_exec_slot_ctx_t const * slot_ctx );
+
+/* Generate a complete accounts_hash of the entire account database. */
+int
+fd_accounts_hash( fd_exec_slot_ctx_t * slot_ctx,
+                  fd_hash_t * accounts_hash,
+                  fd_funk_txn_t * child_txn,
+                  ulong do_hash_verify,
+                  int with_dead );
+
+/* fd_accounts_hash_tpool computes the same accounts hash of the root
+   as fd_accounts_hash( slot_ctx, accounts_hash, NULL, 0, 0 ), e.g. the
+   epoch accounts hash, splitting the walk of the record map and the
+   sort of the accounts across max_workers tpool workers.  Falls back
+   to fd_accounts_hash if tpool is NULL or max_workers<2.  The root
+   must not be modified while this runs. */
+int
+fd_accounts_hash_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                        fd_hash_t *          accounts_hash,
+                        fd_tpool_t *         tpool,
+                        ulong                max_workers );
+
+/* Generate a non-incremental hash of the entire account database. */
+int
+fd_snapshot_hash( fd_exec_slot_ctx_t * slot_ctx,
+                  fd_hash_t * accounts_hash,
+                  fd_funk_txn_t * child_txn,
+                  uint check_hash,
+                  int with_dead );
+
+/* The accounts lthash is a lattice hash over the whole account
+   database: the sum of lthash(account hash) over every live account.
+   It lives in slot_bank.lthash and, if slot_ctx->enable_lthash is
+   set, is maintained incrementally by fd_update_hash_bank(_tpool),
+   which folds in the change of every account of the slot's funk txn
+   against its parent version.  Maintaining it costs O(changed
+   accounts) per slot rather than a walk of the database.  Calling
+   fd_update_hash_bank(_tpool) again for the same slot recomputes the
+   change of the slot rather than applying it twice.  Nothing in
+   consensus depends on it yet, so it is off by default (see the
+   ledger tool's --lthash option).
+
+   fd_accounts_init_lthash_tpool (re)computes the accounts lthash from
+   scratch as seen from slot_ctx->funk_txn, splitting the walk of the
+   record map across max_workers tpool workers (tpool may be NULL for
+   a serial walk).  This is done once, e.g. after loading a snapshot.
+   fd_accounts_init_lthash is the serial version.
+
+   fd_accounts_check_lthash recomputes the accounts lthash from scratch
+   and FD_TESTs that it matches the maintained one.  This is O(database)
+   and meant for debugging.
+
+   fd_accounts_lthash_checksum compresses the maintained accounts
+   lthash into a 32 byte blake3 checksum of the full state in O(1).
+   It is logged with the bank hash of every slot while the lthash is
+   maintained. */
+
+int
+fd_accounts_init_lthash_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                               fd_tpool_t *         tpool,
+                               ulong                max_workers );
+
+int
+fd_accounts_init_lthash( fd_exec_slot_ctx_t * slot_ctx );
+
+void
+fd_accounts_check_lthash( fd_exec_slot_ctx_t * slot_ctx );
+
+void
+fd_accounts_lthash_checksum( fd_exec_slot_ctx_t const * slot_ctx,
+                             fd_hash_t *                checksum );
+
+void
+fd_calculate_epoch_accounts_hash_values(fd_exec_slot_ctx_t * slot_ctx);
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_fd_hashes_h */
@@ -0,0 +1,115 @@
+#ifndef HEADER_fd_src_flamenco_runtime_fd_txn_sched_h
+#define HEADER_fd_src_flamenco_runtime_fd_txn_sched_h
+
+/* fd_txn_sched schedules a batch of txns on a tpool according to their
+   account conflicts.
+
+   The conflict graph of the batch is built once.  Each account tracks
+   the last txn that wrote it and the txns that have read it since.  A
+   txn that writes an account depends on the last writer and on all
+   readers since; a txn that reads an account depends on the last
+   writer only.  This yields at most two edges per account reference
+   and edges only ever point from earlier to later txns in the batch.
+
+   The caller's thread then acts as the dispatcher.  Txns are admitted
+   (prepared) in block order: a txn is prepared and handed to an idle
+   worker once all of its predecessors have been finalized and all
+   earlier txns have been admitted.  A txn is finalized (and its
+   successors released) as soon as its worker returns.  There are no
+   barriers between groups of txns, so while a txn waits for a hot
+   account, the txns admitted before it keep running.  Prepare and
+   finalize always run on the dispatcher, one txn at a time; only
+   execution runs on the workers.  Txns that do not conflict may be
+   executed and finalized in any order.
+
+   Admitting in block order lets prepare charge per-block budgets (such
+   as cost limits) exactly as serial execution would, while still
+   seeing the account state left by the earlier txns it conflicts
+   with. */
+
+#include "../fd_flamenco_base.h"
+#include "../../util/tpool/fd_tpool.h"
+
+#define FD_TXN_SCHED_IDX_NULL (ULONG_MAX)
+
+/* fd_txn_sched_acct_t is an account referenced by a txn. */
+
+struct fd_txn_sched_acct {
+  fd_pubkey_t const * pubkey;
+  int                 writable;
+};
+typedef struct fd_txn_sched_acct fd_txn_sched_acct_t;
+
+struct fd_txn_sched_link {
+  ulong txn_idx;
+  ulong next;
+};
+typedef struct fd_txn_sched_link fd_txn_sched_link_t;
+
+struct fd_txn_sched {
+  ulong                 txn_cnt;
+  ulong *               in_deg;     /* in_deg[i] is the number of unfinalized predecessors of txn i */
+  ulong *               succ_head;  /* succ_head[i] is the head of the list of txns that depend on txn i */
+  fd_txn_sched_link_t * link;       /* Edge and reader list storage, indexed by succ_head and next */
+  ulong                 link_cnt;
+};
+typedef struct fd_txn_sched fd_txn_sched_t;
+
+/* fd_txn_sched_prepare_fn_t is called on the dispatcher right before
+   txn_idx is executed, in block order.  Every earlier txn that
+   conflicts with txn_idx has been finalized.  Returns 0 if the txn
+   should be executed and non-zero if execution should be skipped (the
+   txn is still finalized). */
+
+typedef int
+(* fd_txn_sched_prepare_fn_t)( void * ctx,
+                               ulong  txn_idx );
+
+/* fd_txn_sched_finalize_fn_t is called on the dispatcher once txn_idx
+   has been executed (or skipped).  The txns that depend on txn_idx are
+   released when it returns. */
+
+typedef void
+(* fd_txn_sched_finalize_fn_t)( void * ctx,
+                                ulong  txn_idx );
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_txn_sched_build builds the conflict graph of txn_cnt txns.  The
+   accounts referenced by txn i are acct[ acct_off[i], acct_off[i+1] ).
+   The all-zero address (the system program, which is always demoted to
+   read-only) never introduces a conflict.  The graph is allocated from
+   the caller's current scratch frame and is valid until that frame is
+   popped.  Returns sched. */
+
+fd_txn_sched_t *
+fd_txn_sched_build( fd_txn_sched_t *            sched,
+                    ulong                       txn_cnt,
+                    ulong const *               acct_off,
+                    fd_txn_sched_acct_t const * acct );
+
+/* fd_txn_sched_run runs every txn of sched.  Txn i is executed by
+   calling
+
+     execute( execute_tpool, t0,t1, ctx, NULL,0UL, 0UL,txn_cnt, i,i+1, t,t+1 )
+
+   on tpool worker t in (t0,t1), or on the caller (t==t0) if tpool is
+   NULL or t1-t0<=1.  The caller must not be any of the workers (t0,t1)
+   and these must be idle on entry.  They are idle again on return.
+   Allocates from the caller's scratch.  Returns the number of txns
+   finalized, which is txn_cnt. */
+
+ulong
+fd_txn_sched_run( fd_txn_sched_t *           sched,
+                  fd_tpool_t *               tpool,
+                  ulong                      t0,
+                  ulong                      t1,
+                  fd_txn_sched_prepare_fn_t  prepare,
+                  fd_tpool_task_t            execute,
+                  void *                     execute_tpool,
+                  fd_txn_sched_finalize_fn_t finalize,
+                  void *                     ctx );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_fd_txn_sched_h */
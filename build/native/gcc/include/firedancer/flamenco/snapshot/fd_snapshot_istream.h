@@ -0,0 +1,308 @@
+#ifndef HEADER_fd_src_flamenco_snapshot_fd_snapshot_istream_h
+#define HEADER_fd_src_flamenco_snapshot_fd_snapshot_istream_h
+
+#include "../../util/archive/fd_tar.h"
+#include "../../ballet/zstd/fd_zstd.h"
+#include "../../util/tpool/fd_tpool.h"
+
+/* Input stream API ***************************************************/
+
+/* Below are APIs to support the streaming read pipeline.
+
+   TODO: The indirect call architecture used here is suboptimal.
+         In the future, we'd want to use a fd_tango based message
+         passing architecture to allow streamlining the pipeline across
+         multiple cores.  This scales better, is more secure, faster,
+         and more flexible.  However, it requires non-trivial tile
+         orchestration, which is still being worked on at the time of
+         writing.*/
+
+/* Below is an experimental object-oriented API for handling output
+   streams of data.  It is dynamically dispatched (C++ style virtual
+   function tables) */
+
+struct fd_io_istream_vt {
+
+  /* Virtual version of fd_io_read
+     Assumed to be blocking (TODO fix) */
+
+  int
+  (* read)( void *  _this,
+            void *  _dst,
+            ulong   dst_max,
+            ulong * _dst_sz );
+
+};
+
+typedef struct fd_io_istream_vt fd_io_istream_vt_t;
+
+struct fd_io_istream_obj {
+  void *                     this;
+  fd_io_istream_vt_t const * vt;
+};
+
+typedef struct fd_io_istream_obj fd_io_istream_obj_t;
+
+FD_PROTOTYPES_BEGIN
+
+static inline int
+fd_io_istream_obj_read( fd_io_istream_obj_t * obj,
+                        void *                dst,
+                        ulong                 dst_max,
+                        ulong *               dst_sz ) {
+  return obj->vt->read( obj->this, dst, dst_max, dst_sz );
+}
+
+FD_PROTOTYPES_END
+
+
+/* fd_io_istream_zstd_t implements fd_io_istream_vt_t. ****************/
+
+#ifdef FD_HAS_ZSTD
+
+struct fd_io_istream_zstd {
+  fd_zstd_dstream_t * dstream;  /* borrowed for lifetime of self */
+  fd_io_istream_obj_t src;
+
+# define FD_IO_ISTREAM_ZSTD_BUFSZ (8192UL)  /* should probably be configurable at runtime */
+  uchar   in_buf[ FD_IO_ISTREAM_ZSTD_BUFSZ ];
+  uchar * in_cur;  /* in_cur in [in_buf,in_end) */
+  uchar * in_end;  /* in_end in [in_buf,in_buf+FD_IO_ISTREAM_ZSTD_BUFSZ) */
+
+  int dirty;
+};
+
+typedef struct fd_io_istream_zstd fd_io_istream_zstd_t;
+
+FD_PROTOTYPES_BEGIN
+
+fd_io_istream_zstd_t *
+fd_io_istream_zstd_new( void *              mem,
+                        fd_zstd_dstream_t * dstream,
+                        fd_io_istream_obj_t src );
+
+void *
+fd_io_istream_zstd_delete( fd_io_istream_zstd_t * this );
+
+int
+fd_io_istream_zstd_read( void *  _this,
+                         void *  dst,
+                         ulong   dst_max,
+                         ulong * dst_sz );
+
+extern fd_io_istream_vt_t const fd_io_istream_zstd_vt;
+
+static inline fd_io_istream_obj_t
+fd_io_istream_zstd_virtual( fd_io_istream_zstd_t * this ) {
+  return (fd_io_istream_obj_t) {
+    .this = this,
+    .vt   = &fd_io_istream_zstd_vt
+  };
+}
+
+FD_PROTOTYPES_END
+
+
+/* fd_io_istream_zstd_para_t implements fd_io_istream_vt_t. ***********/
+
+/* fd_io_istream_zstd_para_t decompresses a multi-frame Zstandard stream
+   using multiple threads.  The compressed source is read into an input
+   arena and split at frame boundaries (which are located without
+   decompressing).  Whole frames are handed out in stream order to a
+   ring of slots.  Each slot owns a dstream and a double-buffered output
+   buffer and is serviced by a dedicated tpool worker.  A worker
+   decompresses its frame into one half of the output buffer at a time
+   and is redispatched as soon as a half is free, so it keeps going
+   while the reader drains the other half.  Reads return the
+   decompressed bytes in stream order, so the object is a drop-in
+   replacement for fd_io_istream_zstd_t.
+
+   in_max is the size of the input arena, which is shared by all slots.
+   It bounds the total compressed size of the frames in flight.  A
+   frame larger than in_max is decompressed single-threaded while it is
+   streamed from the source (like fd_io_istream_zstd_t).  Parallel
+   decompression resumes at the next frame boundary.  out_max is the
+   size of each slot's output buffer (two halves of out_max/2).  Memory
+   usage is roughly
+
+     in_max + slot_cnt*( out_max + fd_zstd_dstream_footprint( window_sz ) )
+
+   Frames are decoded ahead of the reader by up to slot_cnt frames (as
+   many as fit into the arena).  Snapshots should thus be made of many
+   frames smaller than in_max/slot_cnt for this to pay off (see
+   README.md).
+
+   If tpool is NULL, the object has a single slot and decompresses
+   synchronously on the caller's thread.  Otherwise, slot i is serviced
+   by tpool worker t0+i for i in [0,t1-t0).  The workers must be idle
+   and must not be used by the caller while the object is in use.
+   Worker 0 (the caller) cannot be used. */
+
+struct fd_io_istream_zstd_para_slot {
+  fd_zstd_dstream_t * dstream;
+  uchar const *       in_beg;     /* frame is [in_beg,in_end) of the input arena */
+  uchar const *       in_cur;     /* next compressed byte of this frame */
+  uchar const *       in_end;
+  uchar *             out_buf;    /* two halves of out_half bytes */
+  ulong               out_half;
+  ulong               out_sz[2];  /* decompressed bytes in each half */
+  ulong               out_off;    /* bytes of half out_rd already read */
+  uint                out_rd;     /* half to read next */
+  uint                out_cnt;    /* halves holding unread output (0, 1 or 2) */
+  uint                out_wr;     /* half written by the last dispatch */
+  int                 busy;       /* 1 if dispatched to a worker */
+  int                 err;        /* 0 if frame incomplete, -1 if complete, errno-like on failure */
+};
+
+typedef struct fd_io_istream_zstd_para_slot fd_io_istream_zstd_para_slot_t;
+
+struct fd_io_istream_zstd_para {
+  fd_io_istream_obj_t src;
+
+  fd_tpool_t * tpool;   /* NULL if synchronous */
+  ulong        t0;      /* first worker index */
+
+  /* Input arena.  Holds the frames in flight (in stream order, wrapped
+     around the end of the arena at most once) followed by the bytes
+     read from src but not yet handed to a slot (the stage). */
+
+  uchar *      in_buf;
+  ulong        in_max;
+  uchar *      stage;
+  ulong        stage_sz;
+  int          src_eof;
+
+  /* Ring of slots.  slot[ (head+i)%slot_cnt ] for i in [0,cnt) hold
+     frames in stream order. */
+
+  fd_io_istream_zstd_para_slot_t * slot;
+  ulong        slot_cnt;
+  ulong        head;
+  ulong        cnt;
+
+  int          stream;  /* 1 while streaming a frame larger than in_max */
+  int          dirty;   /* stream mode: output not yet flushed */
+};
+
+typedef struct fd_io_istream_zstd_para fd_io_istream_zstd_para_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_io_istream_zstd_para_{align,footprint} return the requirements of
+   the memory region backing a fd_io_istream_zstd_para_t.  slot_cnt is
+   t1-t0 (or 1 for synchronous use).  out_max must be even.  Returns 0
+   for invalid params. */
+
+FD_FN_CONST ulong
+fd_io_istream_zstd_para_align( void );
+
+FD_FN_CONST ulong
+fd_io_istream_zstd_para_footprint( ulong slot_cnt,
+                                   ulong window_sz,
+                                   ulong in_max,
+                                   ulong out_max );
+
+/* fd_io_istream_zstd_para_new formats a memory region as a
+   fd_io_istream_zstd_para_t that reads compressed data from src.
+   If tpool is non-NULL, requires 0<t0<t1<=fd_tpool_worker_cnt(tpool)
+   and slot_cnt==t1-t0.  Returns the object on success and NULL on
+   failure (logs details). */
+
+fd_io_istream_zstd_para_t *
+fd_io_istream_zstd_para_new( void *              mem,
+                             fd_tpool_t *        tpool,
+                             ulong               t0,
+                             ulong               t1,
+                             ulong               window_sz,
+                             ulong               in_max,
+                             ulong               out_max,
+                             fd_io_istream_obj_t src );
+
+/* fd_io_istream_zstd_para_delete waits for any in-flight frame and
+   releases the memory region back to the caller. */
+
+void *
+fd_io_istream_zstd_para_delete( fd_io_istream_zstd_para_t * this );
+
+int
+fd_io_istream_zstd_para_read( void *  _this,
+                              void *  dst,
+                              ulong   dst_max,
+                              ulong * dst_sz );
+
+extern fd_io_istream_vt_t const fd_io_istream_zstd_para_vt;
+
+static inline fd_io_istream_obj_t
+fd_io_istream_zstd_para_virtual( fd_io_istream_zstd_para_t * this ) {
+  return (fd_io_istream_obj_t) {
+    .this = this,
+    .vt   = &fd_io_istream_zstd_para_vt
+  };
+}
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_ZSTD */
+
+
+/* fd_io_istream_file_t implements fd_io_istream_vt_t. ****************/
+
+struct fd_io_istream_file {
+  int fd;
+};
+
+typedef struct fd_io_istream_file fd_io_istream_file_t;
+
+FD_PROTOTYPES_BEGIN
+
+fd_io_istream_file_t *
+fd_io_istream_file_new( void * mem,
+                        int    fd );
+
+void *
+fd_io_istream_file_delete( fd_io_istream_file_t * this );
+
+int
+fd_io_istream_file_read( void *  _this,
+                         void *  dst,
+                         ulong   dst_max,
+                         ulong * dst_sz );
+
+extern fd_io_istream_vt_t const fd_io_istream_file_vt;
+
+static inline fd_io_istream_obj_t
+fd_io_istream_file_virtual( fd_io_istream_file_t * this ) {
+  return (fd_io_istream_obj_t) {
+    .this = this,
+    .vt   = &fd_io_istream_file_vt
+  };
+}
+
+FD_PROTOTYPES_END
+
+
+/* fd_tar_io_reader_t reads a tar from an fd_io_istream_obj_t source. */
+
+struct fd_tar_io_reader {
+  fd_tar_reader_t *   reader;  /* borrowed for lifetime */
+  fd_io_istream_obj_t src;
+};
+
+typedef struct fd_tar_io_reader fd_tar_io_reader_t;
+
+FD_PROTOTYPES_BEGIN
+
+fd_tar_io_reader_t *
+fd_tar_io_reader_new( void *              mem,
+                      fd_tar_reader_t *   reader,
+                      fd_io_istream_obj_t src );
+
+void *
+fd_tar_io_reader_delete( fd_tar_io_reader_t * this );
+
+int
+fd_tar_io_reader_advance( fd_tar_io_reader_t * this );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_snapshot_fd_snapshot_istream_h */
@@ -0,0 +1,181 @@
+#ifndef HEADER_fd_src_funk_fd_funk_archive_h
+#define HEADER_fd_src_funk_fd_funk_archive_h
+
+/* fd_funk_archive provides a cold tier for the records of a funk's last
+   published transaction.  It is backed by an append-only file that is
+   a flat sequence of entries.  Each entry is a fd_funk_archive_ent_t
+   header, optionally followed by the record value bytes:
+
+     VAL   - the value of a published record at the time it was written
+     ERASE - the published record with the given key was removed
+     MARK  - checkpoint, see below
+
+   Published records are written out incrementally by
+   fd_funk_archive_flush, which is meant to be called periodically (e.g.
+   from a housekeeping loop) with a bound on the amount of work per
+   call.  Records that have been written out and not modified since are
+   tagged ARCHIVED.  fd_funk_archive_evict releases the wksp value
+   resources of ARCHIVED records, turning them COLD.  A COLD record keeps
+   its funk metadata (so queries still find it) but has no value until
+   it is faulted back in from the file with fd_funk_archive_fault.
+   fd_funk_archive_query_global is a drop-in for
+   fd_funk_rec_query_global that does this transparently.
+
+   When a flush pass over all records completes without a publish in
+   between, a MARK is appended with the last published xid and the
+   number of published records at that point.  The state of the file up
+   to the last MARK is then a consistent image of the last published
+   transaction and fd_funk_archive_restore can rebuild a funk from it
+   (as COLD records) without reloading a snapshot.  Entries after the
+   last MARK are discarded on restore.
+
+   Funk does not track published records that are erased.  Callers that
+   erase records of the last published transaction after they were
+   archived should log the erase with fd_funk_archive_erase (restore
+   detects a missed erase by the record count check against the MARK).
+
+   A fd_funk_archive_t is a local object (it holds a file descriptor)
+   and cannot be shared between processes.  flush, evict and restore
+   modify published records and have the same concurrency requirements
+   as other funk write operations (i.e. they should be called within a
+   fd_funk_start_write / fd_funk_end_write block).  fault is safe to
+   call concurrently with other faults and funk reads but not
+   concurrently with funk operations that modify published records
+   (e.g. publish). */
+
+#include "fd_funk.h"
+
+#if FD_HAS_HOSTED
+
+#define FD_FUNK_ARCHIVE_MAGIC (0xf17eda2ce7a4c400UL) /* firedancer funk archive version 0 */
+
+#define FD_FUNK_ARCHIVE_ENT_TYPE_VAL   (1U)
+#define FD_FUNK_ARCHIVE_ENT_TYPE_ERASE (2U)
+#define FD_FUNK_ARCHIVE_ENT_TYPE_MARK  (3U)
+
+struct fd_funk_archive_ent {
+  ulong             magic;    /* ==FD_FUNK_ARCHIVE_MAGIC */
+  uint              type;     /* FD_FUNK_ARCHIVE_ENT_TYPE_* */
+  uint              val_sz;   /* VAL: num value bytes following this header, 0 otherwise */
+  ulong             val_hash; /* VAL: fd_hash of the value bytes, MARK: number of published records */
+  fd_funk_txn_xid_t xid;      /* MARK: last published xid, zero otherwise */
+  fd_funk_rec_key_t key;      /* VAL/ERASE: record key, zero otherwise */
+};
+
+typedef struct fd_funk_archive_ent fd_funk_archive_ent_t;
+
+struct fd_funk_archive {
+  int   fd;          /* File backing the cold tier, not owned by the archive */
+  ulong file_sz;     /* Append offset */
+
+  /* Flush pass state.  flush_cursor is a rec_map iterator,
+     0 indicates the next flush starts a new pass. */
+
+  ulong             flush_cursor;
+  ulong             flush_rec_cnt;   /* Published records seen so far this pass */
+  fd_funk_txn_xid_t flush_xid[1];    /* Last published xid when the pass started */
+  ulong             evict_cursor;    /* rec_map iterator, 0 indicates start over */
+
+  volatile int      fault_lock;
+
+  /* Statistics */
+
+  ulong write_cnt;
+  ulong evict_cnt;
+  ulong fault_cnt;
+  ulong mark_cnt;
+};
+
+typedef struct fd_funk_archive fd_funk_archive_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_funk_archive_init initializes the archive with the file fd (which
+   should be open for reading and writing).  New entries are appended at
+   the current end of the file.  Returns archive on success and NULL on
+   failure (logs details).  The archive does not take ownership of fd. */
+
+fd_funk_archive_t *
+fd_funk_archive_init( fd_funk_archive_t * archive,
+                      int                 fd );
+
+/* fd_funk_archive_fini finalizes the archive.  Returns the underlying
+   memory region.  Does not close the file. */
+
+void *
+fd_funk_archive_fini( fd_funk_archive_t * archive );
+
+/* fd_funk_archive_flush visits up to rec_cnt_max records of funk and
+   appends the value of every published record that is neither ARCHIVED
+   nor COLD to the archive, tagging them ARCHIVED.  Visits resume where
+   the previous call left off.  Returns the number of records written
+   and stores FD_FUNK_SUCCESS or a FD_FUNK_ERR_* in *opt_err (if opt_err
+   is non-NULL).  On failure, the record that could not be written is
+   retried by the next call. */
+
+ulong
+fd_funk_archive_flush( fd_funk_archive_t * archive,
+                       fd_funk_t *         funk,
+                       ulong               rec_cnt_max,
+                       int *               opt_err );
+
+/* fd_funk_archive_evict visits up to rec_cnt_max records of funk and
+   makes every ARCHIVED record visited COLD, releasing its value
+   resources.  Returns the number of records evicted.  Callers must
+   ensure no references obtained through fd_funk_val of the evicted
+   records remain in use.  Records whose values were not allocated by
+   the funk (speed load) are skipped. */
+
+ulong
+fd_funk_archive_evict( fd_funk_archive_t * archive,
+                       fd_funk_t *         funk,
+                       ulong               rec_cnt_max );
+
+/* fd_funk_archive_fault loads the value of the COLD record rec back
+   into the funk's wksp.  No-op if rec is not COLD.  Returns rec on
+   success and NULL on failure (stores a FD_FUNK_ERR_* in *opt_err if
+   opt_err is non-NULL, logs details).  On return, rec is ARCHIVED. */
+
+fd_funk_rec_t const *
+fd_funk_archive_fault( fd_funk_archive_t *   archive,
+                       fd_funk_t *           funk,
+                       fd_funk_rec_t const * rec,
+                       int *                 opt_err );
+
+/* fd_funk_archive_query_global is fd_funk_rec_query_global that also
+   faults in the returned record if it is COLD.  Returns NULL if the
+   record does not exist or could not be faulted in. */
+
+fd_funk_rec_t const *
+fd_funk_archive_query_global( fd_funk_archive_t *       archive,
+                              fd_funk_t *               funk,
+                              fd_funk_txn_t const *     txn,
+                              fd_funk_rec_key_t const * key );
+
+/* fd_funk_archive_erase appends an ERASE entry for key.  Returns
+   FD_FUNK_SUCCESS on success and a FD_FUNK_ERR_* on failure. */
+
+int
+fd_funk_archive_erase( fd_funk_archive_t *       archive,
+                       fd_funk_rec_key_t const * key );
+
+/* fd_funk_archive_restore rebuilds the last published records of funk
+   from the archive up to its last MARK.  Every restored record is COLD.
+   Assumes funk has no records and no in-preparation transactions (e.g.
+   it was just created).  Entries after the last MARK are truncated
+   from the file.  On success, returns FD_FUNK_SUCCESS and stores the
+   xid of the MARK at opt_xid (if non-NULL).  Returns FD_FUNK_ERR_KEY if
+   the archive has no MARK and FD_FUNK_ERR_SYS / FD_FUNK_ERR_INVAL /
+   FD_FUNK_ERR_REC on I/O errors, a corrupt or inconsistent archive or
+   a full record map. */
+
+int
+fd_funk_archive_restore( fd_funk_archive_t * archive,
+                         fd_funk_t *         funk,
+                         fd_funk_txn_xid_t * opt_xid );
+
+FD_PROTOTYPES_END
+
+#endif /* FD_HAS_HOSTED */
+
+#endif /* HEADER_fd_src_funk_fd_funk_archive_h */
@@ -29,6 +29,8 @@ fi
 
 # find dump/test-vectors/instr/fixtures -type f -name '*.fix' -exec ./$OBJDIR/unit-test/test_exec_instr --log-path $LOG_PATH/test_exec_instr --log-level-stderr 4 {} +
 ./$OBJDIR/unit-test/test_exec_instr --log-path $LOG_PATH/test_exec_instr --log-level-stderr 4 `cat contrib/test/instr-fixtures.list`
+# Same fixtures with sBPF programs run as native code
+./$OBJDIR/unit-test/test_exec_instr --log-path $LOG_PATH/test_exec_instr_jit --log-level-stderr 4 --vm-jit 1 `cat contrib/test/instr-fixtures.list`
 
 zstd -df dump/test-vectors/elf_loader/fixtures/*.zst
 # find dump/test-vectors/elf_loader/fixtures -type f -name '*.fix' -exec ./$OBJDIR/unit-test/test_elf_loader --log-path $LOG_PATH/test_elf_loader --log-level-stderr 4 {} +
@@ -38,8 +40,8 @@ num_exec_instr_tests_raw=`find dump/test-vectors/instr/fixtures -type f -name '*
 num_elf_tests_raw=`find dump/test-vectors/elf_loader/fixtures -type f -name '*.fix' | wc -l`
 num_exec_instr_tests="`cat contrib/test/instr-fixtures.list | wc -l`"
 num_elf_tests="`cat contrib/test/elf-loader-fixtures.list | wc -l`"
-total_tests=$((num_exec_instr_tests + num_elf_tests))
-total_tests_missing=$((num_exec_instr_tests_raw + num_elf_tests_raw - total_tests))
+total_tests=$((2*num_exec_instr_tests + num_elf_tests))
+total_tests_missing=$((num_exec_instr_tests_raw + num_elf_tests_raw - num_exec_instr_tests - num_elf_tests))
 
 failed=`grep -wR FAIL $LOG_PATH | wc -l`
 passed=`grep -wR OK $LOG_PATH | wc -l`
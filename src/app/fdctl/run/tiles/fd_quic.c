@@ -8,6 +8,7 @@
 #include "../../../../waltz/xdp/fd_xsk.h"
 #include "../../../../waltz/ip/fd_netlink.h"
 #include "../../../../disco/quic/fd_tpu.h"
+#include "../../../../disco/shred/fd_stake_ci.h"
 
 #include <linux/unistd.h>
 #include <sys/random.h>
@@ -31,7 +32,52 @@
    packets being received by net tiles and forwarded on via. a mux
    (multiplexer).  An arbitrary number of QUIC tiles can be run, and
    these will round-robin packets from the networking queues based on
-   the source IP address. */
+   the source IP address.
+
+   The tile also follows stake weight updates.  When the handshake with
+   a peer completes, the identity it authenticated with is looked up.
+   Unstaked peers are limited to a smaller number of concurrent streams
+   and staked peers are prioritized in proportion to their stake when
+   streams from the shared pool are handed out, so that unstaked spam
+   can't crowd out staked senders.  Conns that are already up are
+   reweighed when the stakes change. */
+
+#define IN_CNT       3
+#define NET_IN_IDX   0
+#define SIGN_IN_IDX  1
+#define STAKE_IN_IDX 2
+
+/* STAKE_WEIGHT_SCALE is the stream weight (see
+   fd_quic_conn_set_stream_weight) a peer holding all of the stake
+   would receive, in addition to the weight of 1 given to everyone. */
+
+#define STAKE_WEIGHT_SCALE (FD_QUIC_CONN_STREAM_WEIGHT_MAX-1UL)
+
+/* The stakes of the newest epoch received, by identity */
+
+struct quic_stake {
+  fd_pubkey_t key;
+  uint        hash;
+  ulong       stake;
+};
+typedef struct quic_stake quic_stake_t;
+
+static const fd_pubkey_t quic_null_pubkey = {{ 0 }};
+
+#define MAP_NAME              quic_stake_map
+#define MAP_T                 quic_stake_t
+#define MAP_KEY_T             fd_pubkey_t
+#define MAP_KEY_NULL          quic_null_pubkey
+#define MAP_KEY_EQUAL_IS_SLOW 1
+#define MAP_MEMOIZE           1
+#define MAP_KEY_INVAL(k)      MAP_KEY_EQUAL((k),MAP_KEY_NULL)
+#define MAP_KEY_EQUAL(k0,k1)  (!memcmp( (k0).key, (k1).key, 32UL ))
+#define MAP_KEY_HASH(key)     ((uint)fd_ulong_hash( fd_ulong_load_8( (key).uc ) ))
+#include "../../../../util/tmpl/fd_map_dynamic.c"
+
+/* Twice the max number of staked identities in a stake update */
+
+#define STAKE_MAP_LG_SLOT_CNT (fd_ulong_find_msb_w_default( MAX_SHRED_DESTS-1UL, 0 ) + 2)
 
 typedef struct {
   fd_tpu_reasm_t * reasm;
@@ -67,6 +113,21 @@ typedef struct {
 
   fd_wksp_t * verify_out_mem;
 
+  quic_stake_t *      stake_map;     /* stake by identity for stake_epoch */
+  ulong               stake_epoch;   /* epoch of the stakes in stake_map, ULONG_MAX if none */
+  ulong               stake_total;   /* total stake of stake_epoch */
+  ulong               stake_pending_epoch;
+  ulong               stake_pending_cnt;
+  fd_stake_weight_t * stake_pending; /* stake update being received, MAX_SHRED_DESTS entries */
+
+  fd_quic_conn_t ** conns; /* live conns by conn_idx, NULL if none */
+  ulong             unstaked_stream_cnt;
+  ulong             staked_stream_cnt;
+
+  fd_wksp_t * stake_in_mem;
+  ulong       stake_in_chunk0;
+  ulong       stake_in_wmark;
+
   struct {
     ulong legacy_reasm_append [ FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_APPEND_CNT ];
     ulong legacy_reasm_publish[ FD_METRICS_COUNTER_QUIC_TILE_NON_QUIC_REASSEMBLY_PUBLISH_CNT ];
@@ -108,10 +169,13 @@ quic_limits( fd_topo_tile_t const * tile ) {
     .stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_SERVER  ] = 0,
     .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_BIDI_CLIENT ] = 0,
     .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_BIDI_SERVER ] = 0,
-    .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_CLIENT  ] = tile->quic.max_concurrent_streams_per_connection,
+    /* raised for staked peers in quic_conn_new */
+    .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_CLIENT  ] = fd_ulong_min( tile->quic.max_concurrent_streams_per_unstaked_connection,
+                                                                           tile->quic.max_concurrent_streams_per_connection ),
     .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_SERVER  ] = 0,
     .stream_sparsity                               = FD_QUIC_DEFAULT_SPARSITY,
     .stream_pool_cnt                               = tile->quic.stream_pool_cnt,
+    .hs_service_max                                = tile->quic.max_handshakes_per_service,
   };
   return limits;
 }
@@ -128,6 +192,9 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, alignof( fd_quic_ctx_t ), sizeof( fd_quic_ctx_t )      );
   l = FD_LAYOUT_APPEND( l, fd_aio_align(),           fd_aio_footprint()           );
   l = FD_LAYOUT_APPEND( l, fd_quic_align(),          fd_quic_footprint( &limits ) );
+  l = FD_LAYOUT_APPEND( l, quic_stake_map_align(),   quic_stake_map_footprint( STAKE_MAP_LG_SLOT_CNT ) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_stake_weight_t), MAX_SHRED_DESTS*sizeof(fd_stake_weight_t) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_quic_conn_t *),  limits.conn_cnt*sizeof(fd_quic_conn_t *) );
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
@@ -231,17 +298,85 @@ metrics_write( void * _ctx ) {
   FD_MCNT_SET(  QUIC, STREAM_RECEIVED_BYTES,  ctx->quic->metrics.stream_rx_byte_cnt );
 }
 
+/* quic_peer_stake returns the stake in lamports of the validator with
+   the given identity in stake_epoch, or 0 if unknown. */
+
+static ulong
+quic_peer_stake( fd_quic_ctx_t * ctx,
+                 uchar const *   identity ) {
+  fd_pubkey_t const * key = fd_type_pun_const( identity );
+  if( FD_UNLIKELY( quic_stake_map_key_inval( *key ) ) ) return 0UL;
+
+  quic_stake_t const * ele = quic_stake_map_query( ctx->stake_map, *key, NULL );
+  return ele ? ele->stake : 0UL;
+}
+
+/* quic_conn_set_stake sets the stream limit and stream weight of conn
+   for the stake of its peer.  Staked peers get the full stream limit,
+   and are prioritized for streams by stake. */
+
+static void
+quic_conn_set_stake( fd_quic_ctx_t *  ctx,
+                     fd_quic_conn_t * conn ) {
+  ulong stake  = quic_peer_stake( ctx, conn->peer_identity );
+  ulong weight = 1UL;
+  if( FD_UNLIKELY( stake && ctx->stake_total ) ) {
+    double share = (double)stake / (double)ctx->stake_total;
+    weight = fd_ulong_min( 1UL + (ulong)( share * (double)STAKE_WEIGHT_SCALE ), FD_QUIC_CONN_STREAM_WEIGHT_MAX );
+  }
+
+  ulong stream_cnt = fd_ulong_if( weight>1UL, ctx->staked_stream_cnt, ctx->unstaked_stream_cnt );
+  if( FD_LIKELY( conn->stream_weight==weight &&
+                 fd_quic_conn_get_max_streams( conn, FD_QUIC_TYPE_UNIDIR )==stream_cnt ) ) return;
+
+  fd_quic_conn_set_stream_weight( conn, weight );
+  fd_quic_conn_set_max_streams( conn, FD_QUIC_TYPE_UNIDIR, stream_cnt );
+}
+
+/* quic_stake_update replaces the stakes with the update received in
+   during_frag, and reweighs the live conns.  The update for epoch E
+   carries the stakes the leader schedule of E is computed from, which
+   are the stakes active during epoch E-1, so the newest epoch received
+   is the one in effect.  An update for an older epoch, e.g. one
+   replayed at startup, is ignored. */
+
+static void
+quic_stake_update( fd_quic_ctx_t * ctx ) {
+  if( FD_UNLIKELY( ctx->stake_epoch!=ULONG_MAX && ctx->stake_pending_epoch<ctx->stake_epoch ) ) return;
+
+  quic_stake_map_clear( ctx->stake_map );
+  ulong stake_total = 0UL;
+  for( ulong i=0UL; i<ctx->stake_pending_cnt; i++ ) {
+    fd_stake_weight_t const * w = ctx->stake_pending + i;
+    if( FD_UNLIKELY( quic_stake_map_key_inval( w->key ) ) ) continue;
+    quic_stake_t * ele = quic_stake_map_query( ctx->stake_map, w->key, NULL );
+    if( FD_UNLIKELY( !ele ) ) ele = quic_stake_map_insert( ctx->stake_map, w->key );
+    else                      stake_total -= ele->stake; /* duplicate, last one wins */
+    ele->stake   = w->stake;
+    stake_total += w->stake;
+  }
+  ctx->stake_epoch = ctx->stake_pending_epoch;
+  ctx->stake_total = stake_total;
+
+  ulong conn_cnt = ctx->quic->limits.conn_cnt;
+  for( ulong i=0UL; i<conn_cnt; i++ ) {
+    fd_quic_conn_t * conn = ctx->conns[ i ];
+    if( FD_LIKELY( conn ) ) quic_conn_set_stake( ctx, conn );
+  }
+}
+
 static void
 before_frag( void * _ctx,
              ulong  in_idx,
              ulong  seq,
              ulong  sig,
              int *  opt_filter ) {
-  (void)in_idx;
   (void)seq;
 
   fd_quic_ctx_t * ctx = (fd_quic_ctx_t *)_ctx;
 
+  if( FD_UNLIKELY( in_idx==STAKE_IN_IDX ) ) return;
+
   ulong proto = fd_disco_netmux_sig_proto( sig );
   if( FD_UNLIKELY( proto!=DST_PROTO_TPU_UDP && proto!=DST_PROTO_TPU_QUIC ) ) {
     *opt_filter = 1;
@@ -263,13 +398,25 @@ during_frag( void * _ctx,
              ulong  chunk,
              ulong  sz,
              int *  opt_filter ) {
-  (void)in_idx;
   (void)seq;
   (void)sig;
   (void)opt_filter;
 
   fd_quic_ctx_t * ctx = (fd_quic_ctx_t *)_ctx;
 
+  if( FD_UNLIKELY( in_idx==STAKE_IN_IDX ) ) {
+    if( FD_UNLIKELY( chunk<ctx->stake_in_chunk0 || chunk>ctx->stake_in_wmark ) )
+      FD_LOG_ERR(( "chunk %lu %lu corrupt, not in range [%lu,%lu]", chunk, sz,
+            ctx->stake_in_chunk0, ctx->stake_in_wmark ));
+
+    uchar const * dcache_entry = fd_chunk_to_laddr_const( ctx->stake_in_mem, chunk );
+    ulong staked_cnt = fd_stake_ci_stake_msg_staked_cnt( dcache_entry );
+    fd_memcpy( ctx->stake_pending, fd_stake_ci_stake_msg_weights( dcache_entry ), staked_cnt*sizeof(fd_stake_weight_t) );
+    ctx->stake_pending_epoch = fd_stake_ci_stake_msg_epoch( dcache_entry );
+    ctx->stake_pending_cnt   = staked_cnt;
+    return;
+  }
+
   if( FD_UNLIKELY( chunk<ctx->in_chunk0 || chunk>ctx->in_wmark || sz > FD_NET_MTU ) )
     FD_LOG_ERR(( "chunk %lu %lu corrupt, not in range [%lu,%lu]", chunk, sz, ctx->in_chunk0, ctx->in_wmark ));
 
@@ -287,7 +434,6 @@ after_frag( void *             _ctx,
             ulong *            opt_tsorig,
             int *              opt_filter,
             fd_mux_context_t * mux ) {
-  (void)in_idx;
   (void)seq;
   (void)opt_chunk;
   (void)opt_tsorig;
@@ -296,6 +442,11 @@ after_frag( void *             _ctx,
 
   fd_quic_ctx_t * ctx = (fd_quic_ctx_t *)_ctx;
 
+  if( FD_UNLIKELY( in_idx==STAKE_IN_IDX ) ) {
+    quic_stake_update( ctx );
+    return;
+  }
+
   ulong proto = fd_disco_netmux_sig_proto( *opt_sig );
 
   if( FD_LIKELY( proto==DST_PROTO_TPU_QUIC ) ) {
@@ -339,6 +490,19 @@ quic_conn_new( fd_quic_conn_t * conn,
   fd_quic_ctx_t * ctx = (fd_quic_ctx_t *)_ctx;
 
   conn->local_conn_id = ++ctx->conn_seq;
+
+  ctx->conns[ conn->conn_idx ] = conn;
+  quic_conn_set_stake( ctx, conn );
+}
+
+/* quic_conn_final is invoked by the QUIC engine when a connection is
+   about to be freed. */
+static void
+quic_conn_final( fd_quic_conn_t * conn,
+                 void *           _ctx ) {
+  fd_quic_ctx_t * ctx = (fd_quic_ctx_t *)_ctx;
+
+  if( FD_LIKELY( ctx->conns[ conn->conn_idx ]==conn ) ) ctx->conns[ conn->conn_idx ] = NULL;
 }
 
 /* quic_stream_new is called back by the QUIC engine whenever an open
@@ -562,11 +726,15 @@ static void
 unprivileged_init( fd_topo_t *      topo,
                    fd_topo_tile_t * tile,
                    void *           scratch ) {
-  if( FD_UNLIKELY( tile->in_cnt!=2UL ||
-                   strcmp( topo->links[ tile->in_link_id[ 0UL ] ].name, "net_quic" ) ||
-                   strcmp( topo->links[ tile->in_link_id[ 1UL ] ].name, "sign_quic" ) ) )
-    FD_LOG_ERR(( "quic tile has none or unexpected input links %lu %s %s",
-                 tile->in_cnt, topo->links[ tile->in_link_id[ 0 ] ].name, topo->links[ tile->in_link_id[ 1 ] ].name ));
+  if( FD_UNLIKELY( tile->in_cnt!=IN_CNT ||
+                   strcmp( topo->links[ tile->in_link_id[ NET_IN_IDX   ] ].name, "net_quic" ) ||
+                   strcmp( topo->links[ tile->in_link_id[ SIGN_IN_IDX  ] ].name, "sign_quic" ) ||
+                   strcmp( topo->links[ tile->in_link_id[ STAKE_IN_IDX ] ].name, "stake_out" ) ) )
+    FD_LOG_ERR(( "quic tile has none or unexpected input links %lu %s %s %s",
+                 tile->in_cnt,
+                 tile->in_cnt>0UL ? topo->links[ tile->in_link_id[ 0 ] ].name : "-",
+                 tile->in_cnt>1UL ? topo->links[ tile->in_link_id[ 1 ] ].name : "-",
+                 tile->in_cnt>2UL ? topo->links[ tile->in_link_id[ 2 ] ].name : "-" ));
 
   if( FD_UNLIKELY( tile->out_cnt!=2UL ||
                    strcmp( topo->links[ tile->out_link_id[ 0UL ] ].name, "quic_net" ) ||
@@ -585,7 +753,7 @@ unprivileged_init( fd_topo_t *      topo,
 
   /* End privileged allocs */
 
-  fd_topo_link_t * sign_in = &topo->links[ tile->in_link_id[ 1UL ] ];
+  fd_topo_link_t * sign_in = &topo->links[ tile->in_link_id[ SIGN_IN_IDX ] ];
   fd_topo_link_t * sign_out = &topo->links[ tile->out_link_id[ 1UL ] ];
   FD_TEST( fd_keyguard_client_join( fd_keyguard_client_new( ctx->keyguard_client,
                                                             sign_out->mcache,
@@ -600,6 +768,20 @@ unprivileged_init( fd_topo_t *      topo,
   fd_quic_t * quic = fd_quic_join( fd_quic_new( FD_SCRATCH_ALLOC_APPEND( l, fd_quic_align(), fd_quic_footprint( &limits ) ), &limits ) );
   if( FD_UNLIKELY( !quic ) ) FD_LOG_ERR(( "fd_quic_join failed" ));
 
+  void * _stake_map = FD_SCRATCH_ALLOC_APPEND( l, quic_stake_map_align(), quic_stake_map_footprint( STAKE_MAP_LG_SLOT_CNT ) );
+  ctx->stake_map = quic_stake_map_join( quic_stake_map_new( _stake_map, STAKE_MAP_LG_SLOT_CNT ) );
+  if( FD_UNLIKELY( !ctx->stake_map ) ) FD_LOG_ERR(( "quic_stake_map_join failed" ));
+  ctx->stake_epoch         = ULONG_MAX;
+  ctx->stake_total         = 0UL;
+  ctx->stake_pending_epoch = 0UL;
+  ctx->stake_pending_cnt   = 0UL;
+  ctx->stake_pending     = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_stake_weight_t), MAX_SHRED_DESTS*sizeof(fd_stake_weight_t) );
+
+  ctx->conns = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_quic_conn_t *), limits.conn_cnt*sizeof(fd_quic_conn_t *) );
+  for( ulong i=0UL; i<limits.conn_cnt; i++ ) ctx->conns[ i ] = NULL;
+  ctx->staked_stream_cnt   = limits.stream_cnt        [ FD_QUIC_STREAM_TYPE_UNI_CLIENT ];
+  ctx->unstaked_stream_cnt = limits.initial_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_CLIENT ];
+
   quic->config.role                       = FD_QUIC_ROLE_SERVER;
   quic->config.net.ip_addr                = tile->quic.ip_addr;
   quic->config.net.listen_udp_port        = tile->quic.quic_transaction_listen_port;
@@ -614,7 +796,7 @@ unprivileged_init( fd_topo_t *      topo,
 
   quic->cb.conn_new         = quic_conn_new;
   quic->cb.conn_hs_complete = NULL;
-  quic->cb.conn_final       = NULL;
+  quic->cb.conn_final       = quic_conn_final;
   quic->cb.stream_new       = quic_stream_new;
   quic->cb.stream_receive   = quic_stream_receive;
   quic->cb.stream_notify    = quic_stream_notify;
@@ -634,6 +816,7 @@ unprivileged_init( fd_topo_t *      topo,
     fd_topo_link_t * link = &topo->links[ tile->in_link_id[ i ] ];
 
     if( FD_UNLIKELY( !tile->in_link_poll[ i ] ) ) continue;
+    if( FD_UNLIKELY( i==STAKE_IN_IDX          ) ) continue;
 
     if( FD_UNLIKELY( topo->objs[ link0->dcache_obj_id ].wksp_id!=topo->objs[ link->dcache_obj_id ].wksp_id ) ) FD_LOG_ERR(( "quic tile reads input from multiple workspaces" ));
     if( FD_UNLIKELY( link0->mtu!=link->mtu         ) ) FD_LOG_ERR(( "quic tile reads input from multiple links with different MTUs" ));
@@ -643,6 +826,11 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->in_chunk0 = fd_disco_compact_chunk0( ctx->in_mem );
   ctx->in_wmark  = fd_disco_compact_wmark ( ctx->in_mem, link0->mtu );
 
+  fd_topo_link_t * stake_in = &topo->links[ tile->in_link_id[ STAKE_IN_IDX ] ];
+  ctx->stake_in_mem    = topo->workspaces[ topo->objs[ stake_in->dcache_obj_id ].wksp_id ].wksp;
+  ctx->stake_in_chunk0 = fd_dcache_compact_chunk0( ctx->stake_in_mem, stake_in->dcache );
+  ctx->stake_in_wmark  = fd_dcache_compact_wmark ( ctx->stake_in_mem, stake_in->dcache, stake_in->mtu );
+
   fd_topo_link_t * net_out = &topo->links[ tile->out_link_id[ 0 ] ];
 
   ctx->net_out_mcache = net_out->mcache;
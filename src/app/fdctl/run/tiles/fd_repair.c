@@ -425,20 +425,13 @@ repair_get_shred( ulong  slot,
   if( FD_UNLIKELY( blockstore == NULL ) ) {
     return -1;
   }
-  fd_blockstore_start_read( blockstore );
-
+  /* Lock-free reads so that serving repair never stalls shred insertion */
   if( shred_idx == UINT_MAX ) {
-    fd_slot_meta_t * meta = fd_blockstore_slot_meta_query( blockstore, slot );
-    if( meta == NULL ) {
-      fd_blockstore_end_read( blockstore );
-      return -1L;
-    }
-    shred_idx = (uint)meta->last_index;
+    fd_slot_meta_t meta;
+    if( fd_blockstore_slot_meta_query_volatile( blockstore, slot, NULL, &meta ) ) return -1L;
+    shred_idx = (uint)meta.last_index;
   }
-  long sz = fd_buf_shred_query_copy_data( blockstore, slot, shred_idx, buf, buf_max );
-
-  fd_blockstore_end_read( blockstore );
-  return sz;
+  return fd_buf_shred_query_copy_data_volatile( blockstore, slot, shred_idx, buf, buf_max );
 }
 
 static ulong
@@ -449,17 +442,7 @@ repair_get_parent( ulong  slot,
   if( FD_UNLIKELY( blockstore == NULL ) ) {
     return FD_SLOT_NULL;
   }
-  fd_blockstore_start_read( blockstore );
-
-  fd_slot_meta_t * meta = fd_blockstore_slot_meta_query( blockstore, slot );
-  if( meta == NULL ) {
-    fd_blockstore_end_read( blockstore );
-    return FD_SLOT_NULL;
-  }
-  ulong res = meta->parent_slot;
-
-  fd_blockstore_end_read( blockstore );
-  return res;
+  return fd_blockstore_parent_slot_query_volatile( blockstore, slot );
 }
 
 static void
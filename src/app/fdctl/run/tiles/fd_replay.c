@@ -358,15 +358,14 @@ during_frag( void * _ctx,
   //   ctx->parent_slot = max_slot;
   // }
 
-  fd_blockstore_start_read( ctx->blockstore );
-  fd_block_t * block_ = fd_blockstore_block_query( ctx->blockstore, ctx->curr_slot );
-  if( FD_LIKELY( block_ ) ) {
+  fd_block_t     block_[1];
+  fd_slot_meta_t slot_meta_[1];
+  if( FD_LIKELY( !fd_blockstore_slot_meta_query_volatile( ctx->blockstore, ctx->curr_slot, block_, slot_meta_ ) ) ) {
     if( fd_uchar_extract_bit( block_->flags, FD_BLOCK_FLAG_PROCESSED ) ) {
       FD_LOG_WARNING(( "block already processed - slot: %lu", ctx->curr_slot ));
       *opt_filter = 1;
     }
   }
-  fd_blockstore_end_read( ctx->blockstore );
 }
 
 void
@@ -381,9 +380,10 @@ vote_txn_signer( void *        signer_ctx,
 static void
 slot_ctx_restore( fd_replay_tile_ctx_t * ctx, ulong slot, fd_exec_slot_ctx_t * slot_ctx ) {
   fd_funk_txn_t *   txn_map    = fd_funk_txn_map( ctx->funk, fd_funk_wksp( ctx->funk ) );
-  fd_hash_t const * block_hash = fd_blockstore_block_hash_query( ctx->blockstore, slot );
+  fd_hash_t         block_hash[1];
+  int               hash_err   = fd_blockstore_block_hash_query_volatile( ctx->blockstore, slot, block_hash );
   FD_LOG_DEBUG(("Current slot %lu", slot));
-  if( !block_hash ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
+  if( hash_err ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
   fd_funk_txn_xid_t xid;
   fd_memcpy( xid.uc, block_hash, sizeof( fd_funk_txn_xid_t ) );
   xid.ul[0]             = slot;
@@ -576,7 +576,7 @@ after_frag( void *             _ctx,
       fork->slot_ctx.funk_txn = fd_funk_txn_prepare(ctx->funk, fork->slot_ctx.funk_txn, &xid, 1);
       fd_funk_end_write( ctx->funk );
 
-      int res = fd_runtime_publish_old_txns( &fork->slot_ctx, ctx->capture_ctx );
+      int res = fd_runtime_publish_old_txns( &fork->slot_ctx, ctx->capture_ctx, ctx->tpool, ctx->max_workers );
       if( res != FD_RUNTIME_EXECUTE_SUCCESS ) {
         FD_LOG_ERR(( "txn publishing failed" ));
       }
@@ -907,7 +907,7 @@ read_snapshot( void * _ctx, char const * snapshotfile, char const * incremental
 
   const char * snapshot = snapshotfile;
   if( strncmp( snapshot, "wksp:", 5 ) != 0 ) {
-    fd_snapshot_load( snapshot, ctx->slot_ctx, false, false, FD_SNAPSHOT_TYPE_FULL );
+    fd_snapshot_load_tpool( snapshot, ctx->slot_ctx, false, false, FD_SNAPSHOT_TYPE_FULL, ctx->tpool, ctx->max_workers );
   } else {
     fd_runtime_recover_banks( ctx->slot_ctx, 0 );
   }
@@ -915,7 +915,7 @@ read_snapshot( void * _ctx, char const * snapshotfile, char const * incremental
   /* Load incremental */
 
   if( strlen( incremental ) > 0 ) {
-    fd_snapshot_load( incremental, ctx->slot_ctx, false, false, FD_SNAPSHOT_TYPE_INCREMENTAL );
+    fd_snapshot_load_tpool( incremental, ctx->slot_ctx, false, false, FD_SNAPSHOT_TYPE_INCREMENTAL, ctx->tpool, ctx->max_workers );
     ctx->epoch_ctx->bank_hash_cmp = ctx->bank_hash_cmp;
   }
 
@@ -91,6 +91,13 @@
 #define NET_OUT_IDX     0
 #define SIGN_OUT_IDX    1
 
+#define IN_CNT          5UL
+
+/* PREFILL_DEPTH is the number of Turbine tree prefill requests that can
+   be queued.  When it's full, the oldest request is dropped, which only
+   means its shreds compute their destinations when they are relayed. */
+#define PREFILL_DEPTH   16UL
+
 #define MAX_SLOTS_PER_EPOCH 432000UL
 
 #define DCACHE_ENTRIES_PER_FEC_SET (4UL)
@@ -145,6 +152,22 @@ typedef struct {
   ulong send_fec_set_idx;
   ulong tsorig;  /* timestamp of the last packet in compressed form */
 
+  /* Ranges of shreds whose destinations should be computed ahead of
+     time with fd_shred_dest_prefill, so the shuffle is not on the relay
+     path.  They are serviced in after_credit once every in has been
+     polled without finding a frag (idle_cnt>=IN_CNT).  Requests
+     [prefill_head, prefill_tail) are pending, indexed mod
+     PREFILL_DEPTH. */
+  struct {
+    ulong slot;
+    uint  idx0;
+    uint  idx_cnt;
+    int   is_data;
+  } prefill[ PREFILL_DEPTH ];
+  ulong prefill_head;
+  ulong prefill_tail;
+  ulong idle_cnt;
+
   /* Includes Ethernet, IP, UDP headers */
   ulong shred_buffer_sz;
   uchar shred_buffer[ FD_NET_MTU ];
@@ -277,15 +300,64 @@ finalize_new_cluster_contact_info( fd_shred_ctx_t * ctx ) {
   fd_stake_ci_dest_add_fini( ctx->stake_ci, ctx->new_dest_cnt );
 }
 
+static inline void
+prefill_push( fd_shred_ctx_t * ctx,
+              ulong            slot,
+              int              is_data,
+              uint             idx0,
+              ulong            idx_cnt ) {
+  if( FD_LIKELY( ctx->prefill_tail!=ctx->prefill_head ) ) {
+    /* Most shreds of a FEC set arrive back to back, skip duplicates of
+       the last request */
+    ulong last = (ctx->prefill_tail-1UL) % PREFILL_DEPTH;
+    if( FD_LIKELY( (ctx->prefill[ last ].slot==slot) & (ctx->prefill[ last ].is_data==is_data) &
+                   (ctx->prefill[ last ].idx0==idx0) ) ) return;
+  }
+  if( FD_UNLIKELY( ctx->prefill_tail-ctx->prefill_head>=PREFILL_DEPTH ) ) ctx->prefill_head++;
+
+  ulong i = ctx->prefill_tail++ % PREFILL_DEPTH;
+  ctx->prefill[ i ].slot    = slot;
+  ctx->prefill[ i ].idx0    = idx0;
+  ctx->prefill[ i ].idx_cnt = (uint)idx_cnt;
+  ctx->prefill[ i ].is_data = is_data;
+}
+
+static inline void
+after_credit( void *             _ctx,
+              fd_mux_context_t * mux,
+              int *              opt_poll_in ) {
+  (void)mux;
+  (void)opt_poll_in;
+
+  fd_shred_ctx_t * ctx = (fd_shred_ctx_t *)_ctx;
+
+  /* Only compute destinations ahead of time when we are idle, so this
+     never delays relaying a shred that has already arrived.  One
+     request per iteration bounds the delay for a shred that arrives
+     while we are doing it. */
+  if( FD_LIKELY( ctx->idle_cnt<IN_CNT ) ) { ctx->idle_cnt++; return; }
+  if( FD_LIKELY( ctx->prefill_head==ctx->prefill_tail ) ) return;
+
+  ulong i = ctx->prefill_head++ % PREFILL_DEPTH;
+  fd_shred_dest_t * sdest = fd_stake_ci_get_sdest_for_slot( ctx->stake_ci, ctx->prefill[ i ].slot );
+  if( FD_UNLIKELY( !sdest ) ) return;
+
+  const ulong fanout = 200UL;
+  fd_shred_dest_prefill( sdest, ctx->prefill[ i ].slot, ctx->prefill[ i ].is_data, ctx->prefill[ i ].idx0,
+                         ctx->prefill[ i ].idx_cnt, fanout, fanout );
+}
+
 static void
-before_frag( void * ctx,
+before_frag( void * _ctx,
              ulong  in_idx,
              ulong  seq,
              ulong  sig,
              int *  opt_filter ) {
-  (void)ctx;
   (void)seq;
 
+  fd_shred_ctx_t * ctx = (fd_shred_ctx_t *)_ctx;
+  ctx->idle_cnt = 0UL;
+
   if( FD_LIKELY( in_idx==NET_IN_IDX ) ) {
     *opt_filter = fd_disco_netmux_sig_proto( sig )!=DST_PROTO_SHRED;
   } else if( FD_LIKELY( in_idx==POH_IN_IDX ) ) {
@@ -570,6 +642,14 @@ after_frag( void *             _ctx,
       if( FD_UNLIKELY( !dests ) ) return;
 
       for( ulong j=0UL; j<*max_dest_cnt; j++ ) send_shred( ctx, *out_shred, sdest, dests[ j ], ctx->tsorig );
+
+      /* Once idle, compute the Turbine tree for the rest of this shred's
+         FEC set so those shreds, received or recovered, are relayed
+         without computing a shuffle. */
+      uint  idx0;
+      ulong idx_cnt = fd_shred_dest_fec_set_window( shred, &idx0 );
+      int   is_data = fd_shred_type( shred->variant ) & FD_SHRED_TYPEMASK_DATA;
+      prefill_push( ctx, shred->slot, !!is_data, idx0, idx_cnt );
     }
     if( FD_LIKELY( rv!=FD_FEC_RESOLVER_SHRED_COMPLETES ) ) return;
 
@@ -640,6 +720,16 @@ after_frag( void *             _ctx,
 
   /* Send only the ones we didn't receive. */
   for( ulong i=0UL; i<k; i++ ) for( ulong j=0UL; j<*max_dest_cnt; j++ ) send_shred( ctx, new_shreds[ i ], sdest, dests[ j*out_stride+i ], ctx->tsorig );
+
+  if( FD_LIKELY( in_idx!=NET_IN_IDX ) ) {
+    /* As the leader, the next FEC set of this slot most likely has the
+       same layout and continues where this one ended, so compute its
+       roots while idle. */
+    fd_shred_t const * last_data   = (fd_shred_t const *)set->data_shreds  [ set->data_shred_cnt  -1UL ];
+    fd_shred_t const * last_parity = (fd_shred_t const *)set->parity_shreds[ set->parity_shred_cnt-1UL ];
+    prefill_push( ctx, last_data->slot,   1, last_data->idx  +1U, set->data_shred_cnt   );
+    prefill_push( ctx, last_parity->slot, 0, last_parity->idx+1U, set->parity_shred_cnt );
+  }
 }
 
 static void
@@ -668,7 +758,7 @@ static void
 unprivileged_init( fd_topo_t *      topo,
                    fd_topo_tile_t * tile,
                    void *           scratch ) {
-  if( FD_UNLIKELY( tile->in_cnt!=5UL ||
+  if( FD_UNLIKELY( tile->in_cnt!=IN_CNT ||
                    strcmp( topo->links[ tile->in_link_id[ NET_IN_IDX     ] ].name, "net_shred" )    ||
                    strcmp( topo->links[ tile->in_link_id[ POH_IN_IDX     ] ].name, "poh_shred"  )    ||
                    strcmp( topo->links[ tile->in_link_id[ STAKE_IN_IDX   ] ].name, "stake_out"  )    ||
@@ -840,6 +930,10 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->send_fec_set_idx    = ULONG_MAX;
 
+  ctx->prefill_head = 0UL;
+  ctx->prefill_tail = 0UL;
+  ctx->idle_cnt     = 0UL;
+
   ctx->shred_buffer_sz  = 0UL;
   fd_memset( ctx->shred_buffer, 0xFF, FD_NET_MTU );
 
@@ -905,6 +999,7 @@ fd_topo_run_tile_t fd_tile_shred = {
   .mux_flags                = FD_MUX_FLAG_MANUAL_PUBLISH | FD_MUX_FLAG_COPY,
   .burst                    = 4UL,
   .mux_ctx                  = mux_ctx,
+  .mux_after_credit         = after_credit,
   .mux_before_frag          = before_frag,
   .mux_during_frag          = during_frag,
   .mux_after_frag           = after_frag,
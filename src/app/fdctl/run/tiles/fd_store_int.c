@@ -323,9 +323,9 @@ fd_store_tile_slot_prepare( fd_store_tile_ctx_t * ctx,
       FD_LOG_ERR(( "could not find slot meta" ));
     }
 
-    fd_hash_t const * block_hash = fd_blockstore_block_hash_query( ctx->blockstore, slot );
-    if( block_hash == NULL ) {
-      FD_LOG_ERR(( "could not find slot meta" ));
+    fd_hash_t block_hash[1];
+    if( FD_UNLIKELY( fd_blockstore_block_hash_query_volatile( ctx->blockstore, slot, block_hash ) ) ) {
+      FD_LOG_ERR(( "could not find block hash" ));
     }
 
     FD_STORE( ulong, out_buf, slot_meta->parent_slot );
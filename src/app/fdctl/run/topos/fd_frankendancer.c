@@ -170,6 +170,8 @@ fd_topo_frankendancer( config_t * config ) {
     /**/               fd_topob_tile_in(  topo, "quic",     i,           "metric_in", "sign_quic",      i,          FD_TOPOB_UNRELIABLE, FD_TOPOB_UNPOLLED );
     /**/               fd_topob_tile_out( topo, "sign",   0UL,                        "sign_quic",      i                                                  );
   }
+  /* QUIC tiles prioritize streams of staked peers. */
+  FOR(quic_tile_cnt)   fd_topob_tile_in(  topo, "quic",     i,           "metric_in", "stake_out",      0UL,        FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED   );
   for( ulong i=0UL; i<shred_tile_cnt; i++ ) {
     /**/               fd_topob_tile_in(  topo, "sign",   0UL,           "metric_in", "shred_sign",     i,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED   );
     /**/               fd_topob_tile_out( topo, "shred",  i,                          "shred_sign",     i                                                    );
@@ -244,7 +246,9 @@ fd_topo_frankendancer( config_t * config ) {
       tile->quic.quic_transaction_listen_port   = config->tiles.quic.quic_transaction_listen_port;
       tile->quic.idle_timeout_millis            = config->tiles.quic.idle_timeout_millis;
       tile->quic.retry                          = config->tiles.quic.retry;
+      tile->quic.max_handshakes_per_service     = config->tiles.quic.max_handshakes_per_service;
       tile->quic.max_concurrent_streams_per_connection = config->tiles.quic.max_concurrent_streams_per_connection;
+      tile->quic.max_concurrent_streams_per_unstaked_connection = config->tiles.quic.max_concurrent_streams_per_unstaked_connection;
       tile->quic.stream_pool_cnt                = config->tiles.quic.stream_pool_cnt;
 
     } else if( FD_UNLIKELY( !strcmp( tile->name, "verify" ) ) ) {
@@ -26,6 +26,7 @@
 #include "../../flamenco/shredcap/fd_shredcap.h"
 #include "../../flamenco/runtime/program/fd_bpf_program_util.h"
 #include "../../flamenco/snapshot/fd_snapshot.h"
+#include "../../flamenco/snapshot/fd_snapshot_create.h"
 
 #pragma GCC diagnostic ignored "-Wformat"
 #pragma GCC diagnostic ignored "-Wformat-extra-args"
@@ -58,9 +59,11 @@ static void usage( char const * progname ) {
   fprintf( stderr, " --genesis <genesis snapshot file>          genesis snapshot file\n" );
   fprintf( stderr, " --incremental <incremental snapshot file>  incremental snapshot file\n" );
   fprintf( stderr, " --index-max <ulong>                        number of records to index in funk\n" );
+  fprintf( stderr, " --lthash <bool>                            maintain the accounts lthash during replay and check it at the end\n" );
   fprintf( stderr, " --minified-rocksdb <mini rocksdb dir>      minified rocksdb directory\n" );
   fprintf( stderr, " --on-demand-block-history <ulong>          on demand block history\n" ); /* On demand block reading */
   fprintf( stderr, " --on-demand-block-ingest <int>             on demand block ingest\n" );
+  fprintf( stderr, " --on-demand-block-prefetch <ulong>         number of slots to read ahead of execution on a dedicated tile\n" );
   fprintf( stderr, " --page-cnt <page count>                    number of pages for anon wksp\n" );
   fprintf( stderr, " --pruned-index-max <ulong>                 number of records to index in pruned funk\n" ); /* Prune related */
   fprintf( stderr, " --pruned-page-cnt <ulong>                  number of pages for pruned anon wksp\n" );
@@ -71,6 +74,7 @@ static void usage( char const * progname ) {
   fprintf( stderr, " --shred-max <ulong>                        max shred\n" );
   fprintf( stderr, " --slot-history <ulong>                     number of slots to keep in blockstore\n" );
   fprintf( stderr, " --snapshot <snapshot file>                 snapshot file\n" );
+  fprintf( stderr, " --snapshot-out <snapshot dir>              create a snapshot of the last replayed slot in this directory\n" );
   fprintf( stderr, " --start-slot <ulong>                       start slot\n" );
   fprintf( stderr, " --trash-hash <ulong>                       trash hash for invalidation\n" );
   fprintf( stderr, " --txns-max <ulong>                         number of transactions to store in funk\n" );
@@ -78,6 +82,7 @@ static void usage( char const * progname ) {
   fprintf( stderr, " --verify-acc-hash <uint>                   verify account hash against ledger\n" );
   fprintf( stderr, " --verify-funky <int>                       verify funky account database integrity\n" );
   fprintf( stderr, " --verify-hash <hash>                       verify hash\n" );
+  fprintf( stderr, " --vm-jit <int>                             run sBPF programs as native code (off by default)\n" );
   fprintf( stderr, " --wksp-name <workspace name>               workspace name\n" );
 }
 
@@ -101,6 +106,7 @@ struct fd_ledger_args {
   ulong             txns_max;
   ulong             index_max;
   char const *      snapshot;
+  char const *      snapshot_out;
   char const *      incremental;
   char const *      genesis;
   char const *      mini_db_dir;
@@ -110,6 +116,7 @@ struct fd_ledger_args {
   ulong             pages_pruned;
   ulong             index_max_pruned;
   int               abort_on_mismatch;
+  int               vm_jit;
   int               on_demand_block_ingest;
   char const *      capture_fpath; /* solcap */
   int               capture_txns;
@@ -117,6 +124,7 @@ struct fd_ledger_args {
   ulong             checkpt_freq;
   int               checkpt_mismatch;
   ulong             on_demand_block_history;
+  ulong             on_demand_block_prefetch;
   int               dump_insn_to_pb;
   ulong             dump_insn_start_slot;
   char const *      dump_insn_sig_filter;
@@ -129,9 +137,7 @@ struct fd_ledger_args {
   ulong             vote_acct_max;
   char const *      rocksdb_list[ 32UL ]; /* [ Max items ] */
   ulong             rocksdb_list_cnt;
-  #ifdef _ENABLE_LTHASH
   char const *      lthash;
-  #endif
 
 };
 typedef struct fd_ledger_args fd_ledger_args_t;
@@ -159,6 +165,15 @@ fd_valloc_t allocator_setup( fd_wksp_t * wksp, char const * allocator ) {
 static void *
 setup_tpool( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_valloc_t valloc ) {
   runtime_args->tcnt = fd_tile_cnt();
+  /* The last tile is reserved for on demand block prefetch */
+  if( runtime_args->on_demand_block_ingest && runtime_args->on_demand_block_prefetch ) {
+    if( runtime_args->tcnt < 2UL ) {
+      FD_LOG_WARNING(( "on demand block prefetch requires at least 2 tiles, disabling" ));
+      runtime_args->on_demand_block_prefetch = 0UL;
+    } else {
+      runtime_args->tcnt--;
+    }
+  }
   uchar * tpool_scr_mem = NULL;
   fd_tpool_t * tpool = NULL;
   if( runtime_args->tcnt > 1 ) {
@@ -186,6 +201,200 @@ setup_tpool( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_vall
   return tpool_scr_mem;
 }
 
+/* On demand block ingest *****************************************************/
+
+/* fd_ledger_ingest_t tracks the position of on demand block ingest in
+   the list of rocksdbs.  Blocks are either imported serially by the
+   replay loop right before they are executed or, if prefetch is
+   enabled, by a dedicated tile that runs up to prefetch slots ahead of
+   execution so the rocksdb reads and deshredding of upcoming slots
+   overlap with the execution of earlier ones. */
+
+struct fd_ledger_ingest {
+  fd_ledger_args_t *     ledger_args;
+  fd_blockstore_t *      blockstore;
+  fd_valloc_t            valloc;
+  int                    copy_txn_status;
+  ulong                  trash_hash;
+  uchar                  trash_hash_buf[ 32 ];
+  ulong                  end_slot;
+
+  fd_rocksdb_t           rocks_db;
+  fd_rocksdb_root_iter_t iter;
+  fd_slot_meta_t         slot_meta;
+  ulong                  curr_rocksdb_idx;
+  fd_rocksdb_block_t     block;
+
+  /* Prefetch state.  exec_slot is written by the replay loop and is the
+     slot currently being executed.  ready_slot is written by the
+     prefetch tile; every slot below it has been ingested.  halt is set
+     by the replay loop to stop the prefetch tile early. */
+  ulong                  start_slot;
+  ulong                  prefetch;
+  ulong                  exec_slot;
+  ulong                  ready_slot;
+  int                    halt;
+};
+typedef struct fd_ledger_ingest fd_ledger_ingest_t;
+
+static void
+ingest_init( fd_ledger_ingest_t * ingest, ulong start_slot ) {
+  fd_rocksdb_init( &ingest->rocks_db, ingest->ledger_args->rocksdb_list[ 0UL ] );
+  fd_rocksdb_root_iter_new( &ingest->iter );
+  if( fd_rocksdb_root_iter_seek( &ingest->iter, &ingest->rocks_db, start_slot, &ingest->slot_meta, ingest->valloc ) ) {
+    FD_LOG_ERR(( "unable to seek to first slot" ));
+  }
+  ingest->start_slot = start_slot;
+  ingest->exec_slot  = start_slot;
+  ingest->ready_slot = start_slot;
+}
+
+static void
+ingest_fini( fd_ledger_ingest_t * ingest ) {
+  fd_rocksdb_block_destroy( &ingest->block );
+  fd_rocksdb_root_iter_destroy( &ingest->iter );
+  fd_rocksdb_destroy( &ingest->rocks_db );
+}
+
+/* ingest_slot imports slot into the blockstore if rocksdb has it and
+   the blockstore does not, then advances the root iterator past it
+   (moving on to the next rocksdb in the list if needed).
+
+   As in the serial replay loop this replaces, the iterator is only
+   advanced once slot has a block.  A slot without one (e.g. skipped,
+   so the iterator already points at a later root) is not replayed and
+   leaves the iterator where it is, so that the later root is still
+   imported when the replay loop gets to it. */
+
+static void
+ingest_slot( fd_ledger_ingest_t * ingest, ulong slot ) {
+  fd_blockstore_t * blockstore = ingest->blockstore;
+
+  fd_blockstore_start_read( blockstore );
+  int exists = fd_blockstore_block_query( blockstore, slot ) != NULL;
+  fd_blockstore_end_read( blockstore );
+
+  if( !exists && ingest->slot_meta.slot == slot ) {
+    uchar const * hash_override = slot == ingest->trash_hash ? ingest->trash_hash_buf : NULL;
+    if( FD_UNLIKELY( fd_rocksdb_block_read( &ingest->rocks_db, &ingest->slot_meta, &ingest->block, hash_override ) ||
+                     fd_rocksdb_block_insert( &ingest->rocks_db, &ingest->block, blockstore, ingest->copy_txn_status ) ) ) {
+      FD_LOG_ERR(( "Failed to import block %lu", slot ));
+    }
+    fd_blockstore_start_read( blockstore );
+    exists = fd_blockstore_block_query( blockstore, slot ) != NULL;
+    fd_blockstore_end_read( blockstore );
+  }
+
+  if( !exists || slot >= ingest->end_slot ) return;
+
+  int ret = fd_rocksdb_root_iter_next( &ingest->iter, &ingest->slot_meta, ingest->valloc );
+  if( ret<0 ) {
+    ret = fd_rocksdb_get_meta( &ingest->rocks_db, slot+1UL, &ingest->slot_meta, ingest->valloc );
+    if( ret<0 ) {
+      /* If slot doesn't exist try to look in the next indexed rocksdb */
+      if( ++ingest->curr_rocksdb_idx>=ingest->ledger_args->rocksdb_list_cnt ) {
+        FD_LOG_ERR(( "Failed to get meta for slot %lu", slot+1UL ));
+      }
+      fd_rocksdb_root_iter_destroy( &ingest->iter );
+      fd_rocksdb_destroy( &ingest->rocks_db );
+
+      fd_memset( &ingest->rocks_db,  0, sizeof(fd_rocksdb_t)           );
+      fd_memset( &ingest->iter,      0, sizeof(fd_rocksdb_root_iter_t) );
+      fd_memset( &ingest->slot_meta, 0, sizeof(fd_slot_meta_t)         );
+
+      fd_rocksdb_init( &ingest->rocks_db, ingest->ledger_args->rocksdb_list[ ingest->curr_rocksdb_idx ] );
+      fd_rocksdb_root_iter_new( &ingest->iter );
+      ret = fd_rocksdb_root_iter_seek( &ingest->iter, &ingest->rocks_db, slot+1UL, &ingest->slot_meta, ingest->valloc );
+      if( ret<0 ) {
+        FD_LOG_ERR(( "Failed to seek to slot %lu", slot+1UL ));
+      }
+    }
+  }
+}
+
+/* ingest_prefetch_task runs on the prefetch tile.  It ingests slots in
+   order, staying at most prefetch slots ahead of the slot being
+   executed so that prefetched blocks are not evicted from the
+   blockstore before they are replayed. */
+
+static int
+ingest_prefetch_task( int     argc,
+                      char ** argv ) {
+  (void)argc;
+  fd_ledger_ingest_t * ingest = (fd_ledger_ingest_t *)fd_type_pun( argv );
+
+  for( ulong slot = ingest->start_slot; slot <= ingest->end_slot; ++slot ) {
+    while( slot > FD_VOLATILE_CONST( ingest->exec_slot ) + ingest->prefetch ) {
+      if( FD_UNLIKELY( FD_VOLATILE_CONST( ingest->halt ) ) ) return 0;
+      FD_SPIN_PAUSE();
+    }
+    if( FD_UNLIKELY( FD_VOLATILE_CONST( ingest->halt ) ) ) return 0;
+
+    ingest_slot( ingest, slot );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( ingest->ready_slot ) = slot+1UL;
+  }
+  return 0;
+}
+
+/* runtime_snapshot_create writes a snapshot of the bank of slot, the
+   last replayed slot, to the directory ledger_args->snapshot_out. */
+
+static void
+runtime_snapshot_create( fd_runtime_ctx_t * state,
+                         fd_ledger_args_t * ledger_args,
+                         ulong              slot ) {
+  fd_exec_slot_ctx_t * slot_ctx  = state->slot_ctx;
+  fd_slot_bank_t *     slot_bank = &slot_ctx->slot_bank;
+  fd_funk_t *          funk      = slot_ctx->acc_mgr->funk;
+
+  /* fd_runtime_block_eval_tpool already moved the bank on to the next
+     slot.  Point it back at the slot that was executed. */
+
+  ulong parent_slot = fd_blockstore_parent_slot_query_volatile( slot_ctx->blockstore, slot );
+  if( FD_UNLIKELY( parent_slot==FD_SLOT_NULL ) ) {
+    FD_LOG_WARNING(( "not creating snapshot: slot %lu has no parent in the blockstore", slot ));
+    return;
+  }
+  slot_bank->slot            = slot;
+  slot_bank->prev_slot       = parent_slot;
+  slot_bank->max_tick_height = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx )->ticks_per_slot * (slot + 1);
+
+  char hash_cstr[ FD_BASE58_ENCODED_32_SZ ];
+  fd_base58_encode_32( slot_bank->banks_hash.uc, NULL, hash_cstr );
+  char path[ PATH_MAX ];
+  if( FD_UNLIKELY( !fd_cstr_printf_check( path, PATH_MAX, NULL, "%s/snapshot-%lu-%s.tar.zst", ledger_args->snapshot_out, slot, hash_cstr ) ) ) {
+    FD_LOG_WARNING(( "not creating snapshot: --snapshot-out too long" ));
+    return;
+  }
+
+  ulong const worker_cnt     = fd_ulong_max( state->max_workers, 1UL );
+  int   const compress_lvl   = 3;
+  ulong const compress_bufsz = 1UL<<22;
+  ulong const funk_rec_cnt   = fd_funk_rec_max( funk );
+  ulong const batch_acc_cnt  = 1UL<<14;
+  ulong const max_accv_sz    = 1UL<<24;
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)slot, 0UL ) );
+
+  void * mem = fd_wksp_alloc_laddr( ledger_args->wksp, fd_snapshot_create_align(),
+      fd_snapshot_create_footprint( worker_cnt, compress_lvl, compress_bufsz, funk_rec_cnt, batch_acc_cnt ), 1UL );
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "not creating snapshot: out of workspace memory" ));
+    return;
+  }
+  fd_snapshot_create_t * create = fd_snapshot_create_new( mem, slot_ctx, path, worker_cnt, compress_lvl, compress_bufsz,
+                                                          funk_rec_cnt, batch_acc_cnt, max_accv_sz, rng );
+  if( FD_LIKELY( create ) ) {
+    if( FD_UNLIKELY( !fd_snapshot_create_tpool( create, slot_ctx, state->tpool, worker_cnt ) ) )
+      FD_LOG_WARNING(( "failed to create snapshot %s", path ));
+    fd_snapshot_create_delete( create );
+  }
+  fd_wksp_free_laddr( mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+}
+
 int
 runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_ledger_args_t * ledger_args ) {
   fd_funk_start_write( state->slot_ctx->acc_mgr->funk );
@@ -203,9 +412,17 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
 
   fd_calculate_epoch_accounts_hash_values( state->slot_ctx );
 
+  /* Maintain the accounts lthash while replaying, starting from a full
+     computation as the restored one may be stale */
+  state->slot_ctx->enable_lthash = ( NULL != ledger_args->lthash ) && ( strcmp( ledger_args->lthash, "true" ) == 0 );
+  if( state->slot_ctx->enable_lthash ) {
+    fd_accounts_init_lthash_tpool( state->slot_ctx, state->tpool, state->max_workers );
+  }
+
   long              replay_time = -fd_log_wallclock();
   ulong             txn_cnt     = 0;
   ulong             slot_cnt    = 0;
+  int               mismatch    = 0;
   fd_blockstore_t * blockstore  = state->slot_ctx->blockstore;
 
   ulong prev_slot = state->slot_ctx->slot_bank.slot;
@@ -213,15 +430,31 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
   ulong start_slot = state->slot_ctx->slot_bank.slot + 1;
 
   /* On demand rocksdb ingest */
-  fd_rocksdb_t rocks_db       = {0};
-  fd_rocksdb_root_iter_t iter = {0};
-  fd_slot_meta_t slot_meta    = {0};
-  ulong curr_rocksdb_idx      = 0UL;
+  fd_ledger_ingest_t ingest[1]     = {0};
+  fd_tile_exec_t *   prefetch_exec = NULL;
   if( runtime_args->on_demand_block_ingest ) {
-    fd_rocksdb_init( &rocks_db, ledger_args->rocksdb_list[ 0UL ] );
-    fd_rocksdb_root_iter_new( &iter );
-    if( fd_rocksdb_root_iter_seek( &iter, &rocks_db, start_slot, &slot_meta, state->slot_ctx->valloc ) ) {
-      FD_LOG_ERR(( "unable to seek to first slot" ));
+    ingest->ledger_args     = ledger_args;
+    ingest->blockstore      = blockstore;
+    ingest->valloc          = state->slot_ctx->valloc;
+    ingest->copy_txn_status = runtime_args->copy_txn_status;
+    ingest->trash_hash      = runtime_args->trash_hash;
+    ingest->end_slot        = runtime_args->end_slot;
+    memset( ingest->trash_hash_buf, 0xFE, sizeof(ingest->trash_hash_buf) );
+    ingest_init( ingest, start_slot );
+
+    /* Prefetched blocks and the block history both have to fit in the
+       blockstore without eviction */
+    ulong prefetch = runtime_args->on_demand_block_prefetch;
+    ulong history  = runtime_args->on_demand_block_history;
+    if( prefetch && prefetch + history >= blockstore->slot_max ) {
+      prefetch = fd_ulong_if( blockstore->slot_max > history + 1UL, blockstore->slot_max - history - 1UL, 0UL );
+      FD_LOG_WARNING(( "on demand block prefetch limited to %lu slots by blockstore slot_max %lu", prefetch, blockstore->slot_max ));
+    }
+    ingest->prefetch = prefetch;
+    if( prefetch ) {
+      prefetch_exec = fd_tile_exec_new( fd_tile_cnt() - 1UL, ingest_prefetch_task, 0, fd_type_pun( ingest ) );
+      if( FD_UNLIKELY( !prefetch_exec ) ) FD_LOG_ERR(( "failed to launch block prefetch tile" ));
+      FD_LOG_NOTICE(( "prefetching up to %lu blocks ahead of execution", prefetch ));
     }
   }
 
@@ -236,10 +469,6 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
     fd_funk_end_write( state->capture_ctx->pruned_funk );
   }
 
-  /* Setup trash_hash */
-  uchar trash_hash_buf[32];
-  memset( trash_hash_buf, 0xFE, sizeof(trash_hash_buf) );
-
   for( ulong slot = start_slot; slot <= runtime_args->end_slot; ++slot ) {
     state->slot_ctx->slot_bank.prev_slot = prev_slot;
     state->slot_ctx->slot_bank.slot      = slot;
@@ -253,14 +482,16 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
     }
 
     if( runtime_args->on_demand_block_ingest ) {
-      if( fd_blockstore_block_query( blockstore, slot ) == NULL && slot_meta.slot == slot ) {
-        int err = fd_rocksdb_import_block_blockstore( &rocks_db, &slot_meta, blockstore,
-                                                      runtime_args->copy_txn_status, slot == (runtime_args->trash_hash) ? trash_hash_buf : NULL );
-        if( FD_UNLIKELY( err ) ) {
-          FD_LOG_ERR(( "Failed to import block %lu", start_slot ));
-        }
+      if( prefetch_exec ) {
+        FD_VOLATILE( ingest->exec_slot ) = slot;
+        while( FD_VOLATILE_CONST( ingest->ready_slot ) <= slot ) FD_SPIN_PAUSE();
+        FD_COMPILER_MFENCE();
+      } else {
+        ingest_slot( ingest, slot );
       }
+      fd_blockstore_start_write( blockstore );
       fd_blockstore_slot_remove( blockstore, slot - runtime_args->on_demand_block_history );
+      fd_blockstore_end_write( blockstore );
     }
 
     fd_blockstore_start_read( blockstore );
@@ -287,9 +518,10 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
     txn_cnt += blk_txn_cnt;
     slot_cnt++;
 
-    fd_blockstore_start_read( blockstore );
-    fd_hash_t const * expected = fd_blockstore_block_hash_query( blockstore, slot );
-    if( FD_UNLIKELY( !expected ) ) FD_LOG_ERR( ( "slot %lu is missing its hash", slot ) );
+    /* Don't hold the read lock while checking (or checkpointing on a
+       mismatch), the prefetcher may be inserting blocks. */
+    fd_hash_t expected[1];
+    if( FD_UNLIKELY( fd_blockstore_block_hash_query_volatile( blockstore, slot, expected ) ) ) FD_LOG_ERR( ( "slot %lu is missing its hash", slot ) );
     else if( FD_UNLIKELY( 0 != memcmp( state->slot_ctx->slot_bank.poh.hash, expected->hash, 32UL ) ) ) {
       FD_LOG_WARNING(( "PoH hash mismatch! slot=%lu expected=%32J, got=%32J",
                         slot,
@@ -300,13 +532,18 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
         fd_runtime_checkpt( state->capture_ctx, state->slot_ctx, ULONG_MAX );
       }
       if( state->abort_on_mismatch ) {
-        fd_blockstore_end_read( blockstore );
-        return 1;
+        mismatch = 1;
+        break;
       }
     }
 
-    expected = fd_blockstore_bank_hash_query( blockstore, slot );
-    if( FD_UNLIKELY( !expected ) ) {
+    fd_blockstore_start_read( blockstore );
+    fd_hash_t const * bank_hash = fd_blockstore_bank_hash_query( blockstore, slot );
+    int               bank_hash_found = !!bank_hash;
+    if( FD_LIKELY( bank_hash_found ) ) *expected = *bank_hash;
+    fd_blockstore_end_read( blockstore );
+
+    if( FD_UNLIKELY( !bank_hash_found ) ) {
       FD_LOG_ERR(( "slot %lu is missing its bank hash", slot ));
     } else if( FD_UNLIKELY( 0 != memcmp( state->slot_ctx->slot_bank.banks_hash.hash,
                                          expected->hash,
@@ -320,48 +557,35 @@ runtime_replay( fd_runtime_ctx_t * state, fd_runtime_args_t * runtime_args, fd_l
         fd_runtime_checkpt( state->capture_ctx, state->slot_ctx, ULONG_MAX );
       }
       if( state->abort_on_mismatch ) {
-        fd_blockstore_end_read( blockstore );
-        return 1;
+        mismatch = 1;
+        break;
       }
     }
-    fd_blockstore_end_read( blockstore );
 
     prev_slot = slot;
+  }
 
-    if( runtime_args->on_demand_block_ingest && slot < runtime_args->end_slot ) {
-      int ret = fd_rocksdb_root_iter_next( &iter, &slot_meta, state->slot_ctx->valloc );
-      if( ret<0 ) {
-        ret = fd_rocksdb_get_meta( &rocks_db, slot+1UL, &slot_meta, state->slot_ctx->valloc );
-        if( ret<0 ) {
-          /* If slot doesn't exist try to look in the next indexed rocksdb */
-          if( ++curr_rocksdb_idx>=ledger_args->rocksdb_list_cnt ) {
-            FD_LOG_ERR(( "Failed to get meta for slot %lu", slot+1UL ));
-          }
-          fd_rocksdb_root_iter_destroy( &iter );
-          fd_rocksdb_destroy( &rocks_db );
-
-          fd_memset( &rocks_db,  0, sizeof(fd_rocksdb_t)           );
-          fd_memset( &iter,      0, sizeof(fd_rocksdb_root_iter_t) );
-          fd_memset( &slot_meta, 0, sizeof(fd_slot_meta_t)         );
-
-          fd_rocksdb_init( &rocks_db, ledger_args->rocksdb_list[ curr_rocksdb_idx ] );
-          fd_rocksdb_root_iter_new( &iter );
-          ret = fd_rocksdb_root_iter_seek( &iter, &rocks_db, slot+1UL, &slot_meta, state->slot_ctx->valloc );
-          if( ret<0 ) {
-            FD_LOG_ERR(( "Failed to seek to slot %lu", slot+1UL ));
-          }
-        }
-      }
-    }
+  if( prefetch_exec ) {
+    FD_VOLATILE( ingest->halt ) = 1;
+    fd_tile_exec_delete( prefetch_exec, NULL );
+  }
+  if( runtime_args->on_demand_block_ingest ) {
+    ingest_fini( ingest );
   }
 
-  if( state->tpool ) {
-    fd_tpool_fini( state->tpool );
+  if( FD_UNLIKELY( mismatch ) ) return 1;
+
+  if( state->slot_ctx->enable_lthash ) {
+    fd_accounts_check_lthash( state->slot_ctx );
+    FD_LOG_NOTICE(( "accounts lthash maintained over %lu slots matches a full recompute", slot_cnt ));
   }
 
-  if( runtime_args->on_demand_block_ingest ) {
-    fd_rocksdb_root_iter_destroy( &iter );
-    fd_rocksdb_destroy( &rocks_db );
+  if( ledger_args->snapshot_out && slot_cnt ) {
+    runtime_snapshot_create( state, ledger_args, prev_slot );
+  }
+
+  if( state->tpool ) {
+    fd_tpool_fini( state->tpool );
   }
 
   replay_time += fd_log_wallclock();
@@ -713,6 +937,7 @@ ingest( fd_ledger_args_t * args ) {
   fd_acc_mgr_t mgr[1];
   slot_ctx->acc_mgr = fd_acc_mgr_new( mgr, funk );
   slot_ctx->blockstore = args->blockstore;
+  slot_ctx->enable_lthash = ( NULL != args->lthash ) && ( strcmp( args->lthash, "true" ) == 0 );
 
   /* Load in snapshot(s) */
   if( args->snapshot ) {
@@ -764,12 +989,11 @@ ingest( fd_ledger_args_t * args ) {
     }
   }
 
-  #ifdef _ENABLE_LTHASH
-    if( (NULL != args->lthash) && ( strcmp( args->lthash, "true" ) == 0) ) {
-      fd_accounts_init_lthash( slot_ctx );
-      fd_accounts_check_lthash( slot_ctx );
-    }
-  #endif
+  /* The snapshot load (or the genesis bank hash) seeded the accounts
+     lthash, check it against a full recompute */
+  if( slot_ctx->enable_lthash ) {
+    fd_accounts_check_lthash( slot_ctx );
+  }
 
   if( args->verify_hash ) {
     fd_funk_rec_t * rec_map  = fd_funk_rec_map( funk, wksp );
@@ -881,6 +1105,7 @@ replay( fd_ledger_args_t * args ) {
 
   /* TODO: update so that we aren't piping through every argument twice */
   runtime_args.abort_on_mismatch       = args->abort_on_mismatch;
+  runtime_args.vm_jit                  = args->vm_jit;
   runtime_args.cmd                     = args->cmd;
   runtime_args.end_slot                = args->end_slot;
   runtime_args.allocator               = args->allocator;
@@ -892,6 +1117,7 @@ replay( fd_ledger_args_t * args ) {
   runtime_args.copy_txn_status         = args->copy_txn_status;
   runtime_args.on_demand_block_ingest  = args->on_demand_block_ingest;
   runtime_args.on_demand_block_history = args->on_demand_block_history;
+  runtime_args.on_demand_block_prefetch = args->on_demand_block_prefetch;
   runtime_args.dump_insn_to_pb         = args->dump_insn_to_pb;
   runtime_args.dump_insn_start_slot    = args->dump_insn_start_slot;
   runtime_args.dump_insn_sig_filter    = args->dump_insn_sig_filter;
@@ -1095,6 +1321,7 @@ prune( fd_ledger_args_t * args ) {
   runtime_args.allocator = "wksp";
   runtime_args.on_demand_block_ingest = args->on_demand_block_ingest;
   runtime_args.on_demand_block_history = args->on_demand_block_history;
+  runtime_args.on_demand_block_prefetch = args->on_demand_block_prefetch;
   runtime_args.funk_wksp = unpruned_wksp;
 
   fd_runtime_ctx_t state = {0};
@@ -1315,6 +1542,7 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   ulong        txns_max                = fd_env_strip_cmdline_ulong( &argc, &argv, "--txn-max",                 NULL,      1000 );
   int          verify_funk             = fd_env_strip_cmdline_int  ( &argc, &argv, "--verify-funky",            NULL, 0         );
   char const * snapshot                = fd_env_strip_cmdline_cstr ( &argc, &argv, "--snapshot",                NULL, NULL      );
+  char const * snapshot_out            = fd_env_strip_cmdline_cstr ( &argc, &argv, "--snapshot-out",            NULL, NULL      );
   char const * incremental             = fd_env_strip_cmdline_cstr ( &argc, &argv, "--incremental",             NULL, NULL      );
   char const * genesis                 = fd_env_strip_cmdline_cstr ( &argc, &argv, "--genesis",                 NULL, NULL      );
   int          copy_txn_status         = fd_env_strip_cmdline_int  ( &argc, &argv, "--copy-txn-status",         NULL, 0         );
@@ -1342,8 +1570,10 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   int          checkpt_mismatch        = fd_env_strip_cmdline_int  ( &argc, &argv, "--checkpt-mismatch",        NULL, 0         );
   char const * allocator               = fd_env_strip_cmdline_cstr ( &argc, &argv, "--allocator",               NULL, "wksp"    );
   int          abort_on_mismatch       = fd_env_strip_cmdline_int  ( &argc, &argv, "--abort-on-mismatch",       NULL, 1         );
+  int          vm_jit                  = fd_env_strip_cmdline_int  ( &argc, &argv, "--vm-jit",                  NULL, 0         );
   int          on_demand_block_ingest  = fd_env_strip_cmdline_int  ( &argc, &argv, "--on-demand-block-ingest",  NULL, 0         );
   ulong        on_demand_block_history = fd_env_strip_cmdline_ulong( &argc, &argv, "--on-demand-block-history", NULL, 100       );
+  ulong        on_demand_block_prefetch = fd_env_strip_cmdline_ulong( &argc, &argv, "--on-demand-block-prefetch", NULL, 0UL   );
   int          dump_insn_to_pb         = fd_env_strip_cmdline_int  ( &argc, &argv, "--dump-insn-to-pb",         NULL, 0         );
   ulong        dump_insn_start_slot    = fd_env_strip_cmdline_ulong( &argc, &argv, "--dump-insn-start-slot",    NULL, 0         );
   char const * dump_insn_sig_filter    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--dump-insn-sig-filter",    NULL, NULL      );
@@ -1351,10 +1581,7 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   ulong        vote_acct_max           = fd_env_strip_cmdline_ulong( &argc, &argv, "--vote_acct_max",           NULL, 2000000UL );
   int          use_funk_wksp           = fd_env_strip_cmdline_int  ( &argc, &argv, "--use-funk-wksp",           NULL, 1         );
   char const * rocksdb_list            = fd_env_strip_cmdline_cstr ( &argc, &argv, "--rocksdb",                 NULL, NULL      );
-
-  #ifdef _ENABLE_LTHASH
-  char const * lthash             = fd_env_strip_cmdline_cstr ( &argc, &argv, "--lthash",           NULL, "false"   );
-  #endif
+  char const * lthash                  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--lthash",                  NULL, "false"   );
 
   // TODO: Add argument validation. Make sure that we aren't including any arguments that aren't parsed for
 
@@ -1429,6 +1656,7 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   args->funk_only               = funk_only;
   args->copy_txn_status         = copy_txn_status;
   args->snapshot                = snapshot;
+  args->snapshot_out            = snapshot_out;
   args->incremental             = incremental;
   args->genesis                 = genesis;
   args->shredcap                = shredcap;
@@ -1446,8 +1674,10 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   args->checkpt_mismatch        = checkpt_mismatch;
   args->allocator               = allocator;
   args->abort_on_mismatch       = abort_on_mismatch;
+  args->vm_jit                  = vm_jit;
   args->on_demand_block_ingest  = on_demand_block_ingest;
   args->on_demand_block_history = on_demand_block_history;
+  args->on_demand_block_prefetch = on_demand_block_prefetch;
   args->dump_insn_to_pb         = dump_insn_to_pb;
   args->dump_insn_start_slot    = dump_insn_start_slot;
   args->dump_insn_sig_filter    = dump_insn_sig_filter;
@@ -1460,9 +1690,7 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
     FD_LOG_NOTICE(( "rocksdb_list[%lu] = %s", i, args->rocksdb_list[i] ));
   }
 
-  #ifdef _ENABLE_LTHASH
   args->lthash           = lthash;
-  #endif
 
   return 0;
 }
@@ -9,7 +9,7 @@
 
 /* TODO: Do we need to support ivlen other than 12? */
 
-static void
+void
 fd_aes_gcm_setiv( fd_aes_gcm_t * gcm,
                   uchar const    iv[ static 12 ] ) {
 
@@ -65,6 +65,16 @@ fd_aes_256_gcm_init( fd_aes_gcm_t * aes_gcm,
   fd_aes_gcm_init( aes_gcm, key, 32UL, iv );
 }
 
+/* fd_aes_gcm_setiv prepares an fd_aes_gcm_t previously initialized
+   with fd_aes_gcm_init for a new message with the given 12 byte iv.
+   The key schedule and GHASH tables are retained, so this is much
+   cheaper than a full init when many messages are processed under the
+   same key (e.g. QUIC packets on a connection). */
+
+void
+fd_aes_gcm_setiv( fd_aes_gcm_t * aes_gcm,
+                  uchar const    iv[ static 12 ] );
+
 /* fd_aes_gcm_aead_{encrypt,decrypt} implements the AES-GCM AEAD cipher
    c points to the ciphertext buffer.  p points to the plaintext buffer.
    sz is the length of the p and c buffers.  p,c,sz do not have align-
@@ -65,15 +65,15 @@ fd_aesni_set_decrypt_key( uchar const *  user_key,
 
 __attribute__((sysv_abi))
 void
-fd_aesni_encrypt( uchar const *  in,
-                  uchar *        out,
-                  fd_aes_key_t * key );
+fd_aesni_encrypt( uchar const *        in,
+                  uchar *              out,
+                  fd_aes_key_t const * key );
 
 __attribute__((sysv_abi))
 void
-fd_aesni_decrypt( uchar const *  in,
-                  uchar *        out,
-                  fd_aes_key_t * key );
+fd_aesni_decrypt( uchar const *        in,
+                  uchar *              out,
+                  fd_aes_key_t const * key );
 
 #define fd_aes_encrypt         fd_aesni_encrypt
 #define fd_aes_decrypt         fd_aesni_decrypt
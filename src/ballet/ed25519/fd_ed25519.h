@@ -129,6 +129,35 @@ fd_ed25519_verify_batch_single_msg( uchar const   msg[], /* msg_sz */
                                     fd_sha512_t * shas[ 1 ],               /* batch_sz */
                                     uchar const   batch_sz );
 
+/* fd_ed25519_verify_batch verifies a batch of batch_sz independent
+   signatures, each over its own message and with its own public key,
+   according to the same rules as fd_ed25519_verify.
+
+   msgs[i] points to the first byte of a msg_szs[i] byte memory region
+   holding the i-th message, sigs[i] to the 64 byte signature and
+   public_keys[i] to the 32 byte public key.  On return, errs[i] holds
+   the result of verifying the i-th signature (FD_ED25519_SUCCESS or a
+   FD_ED25519_ERR_* code).  Signatures are checked individually, so
+   the results match calling fd_ed25519_verify on each tuple; batching
+   lets the SHA-512 of the messages run with the vectorized batch
+   implementation.  Messages longer than FD_ED25519_VERIFY_BATCH_MSG_MAX
+   are hashed one at a time.
+
+   batch_sz must be in [1,FD_ED25519_VERIFY_BATCH_MAX].  Returns
+   FD_ED25519_SUCCESS if every signature verified and the error code of
+   the first failing signature otherwise. */
+
+#define FD_ED25519_VERIFY_BATCH_MAX     (16UL)
+#define FD_ED25519_VERIFY_BATCH_MSG_MAX (1280UL)
+
+int
+fd_ed25519_verify_batch( uchar const * const msgs[],        /* batch_sz */
+                         ulong const         msg_szs[],     /* batch_sz */
+                         uchar const * const sigs[],        /* batch_sz, each 64 bytes */
+                         uchar const * const public_keys[], /* batch_sz, each 32 bytes */
+                         int                 errs[],        /* batch_sz */
+                         ulong               batch_sz );
+
 /* fd_ed25519_strerror converts an FD_ED25519_SUCCESS / FD_ED25519_ERR_*
    code into a human readable cstr.  The lifetime of the returned
    pointer is infinite.  The returned pointer is always to a non-NULL
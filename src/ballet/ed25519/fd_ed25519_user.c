@@ -308,6 +308,93 @@ int fd_ed25519_verify_batch_single_msg( uchar const   msg[], /* msg_sz */
 #undef MAX
 }
 
+int
+fd_ed25519_verify_batch( uchar const * const msgs[],
+                         ulong const         msg_szs[],
+                         uchar const * const sigs[],
+                         uchar const * const public_keys[],
+                         int                 errs[],
+                         ulong               batch_sz ) {
+  if( FD_UNLIKELY( batch_sz==0UL || batch_sz>FD_ED25519_VERIFY_BATCH_MAX ) ) {
+    return FD_ED25519_ERR_SIG;
+  }
+
+  fd_ed25519_point_t Aprime[ FD_ED25519_VERIFY_BATCH_MAX ];
+  fd_ed25519_point_t R     [ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar              k     [ FD_ED25519_VERIFY_BATCH_MAX ][ 64 ];
+
+  /* Each k_j is SHA512(r || A || M), which the batch SHA-512 API wants
+     contiguous in memory */
+  uchar pre[ FD_ED25519_VERIFY_BATCH_MAX ][ 64UL+FD_ED25519_VERIFY_BATCH_MSG_MAX ];
+
+  fd_sha512_t _sha[1];
+  fd_sha512_t * sha = NULL;
+
+  uchar _batch[ FD_SHA512_BATCH_FOOTPRINT ] __attribute__((aligned(FD_SHA512_BATCH_ALIGN)));
+  fd_sha512_batch_t * batch = fd_sha512_batch_init( _batch );
+
+  /* Validate scalars, decompress public keys and points R_j, check low
+     order points and compute k_j */
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    uchar const * r          = sigs[ j ];
+    uchar const * S          = sigs[ j ] + 32;
+    uchar const * public_key = public_keys[ j ];
+
+    errs[ j ] = FD_ED25519_SUCCESS;
+
+    if( FD_UNLIKELY( !fd_curve25519_scalar_validate( S ) ) ) {
+      errs[ j ] = FD_ED25519_ERR_SIG;
+      continue;
+    }
+
+    int res = fd_ed25519_point_frombytes_2x( &Aprime[j], public_key, &R[j], r );
+    if( FD_UNLIKELY( res ) ) {
+      errs[ j ] = res == 1 ? FD_ED25519_ERR_PUBKEY : FD_ED25519_ERR_SIG;
+      continue;
+    }
+    if( FD_UNLIKELY( fd_ed25519_affine_is_small_order( &Aprime[j] ) ) ) {
+      errs[ j ] = FD_ED25519_ERR_PUBKEY;
+      continue;
+    }
+    if( FD_UNLIKELY( fd_ed25519_affine_is_small_order( &R[j] ) ) ) {
+      errs[ j ] = FD_ED25519_ERR_SIG;
+      continue;
+    }
+
+    ulong msg_sz = msg_szs[ j ];
+    if( FD_LIKELY( msg_sz<=FD_ED25519_VERIFY_BATCH_MSG_MAX ) ) {
+      fd_memcpy( pre[j],      r,          32UL   );
+      fd_memcpy( pre[j]+32UL, public_key, 32UL   );
+      fd_memcpy( pre[j]+64UL, msgs[ j ],  msg_sz );
+      fd_sha512_batch_add( batch, pre[j], 64UL+msg_sz, k[j] );
+    } else {
+      if( !sha ) sha = fd_sha512_join( fd_sha512_new( _sha ) );
+      fd_sha512_fini( fd_sha512_append( fd_sha512_append( fd_sha512_append( fd_sha512_init( sha ),
+                      r, 32UL ), public_key, 32UL ), msgs[ j ], msg_sz ), k[j] );
+    }
+  }
+  fd_sha512_batch_fini( batch );
+  if( sha ) fd_sha512_delete( fd_sha512_leave( sha ) );
+
+  /* Check the group equation [S]B = R + [k]A' for each signature */
+  int err = FD_ED25519_SUCCESS;
+  for( ulong j=0UL; j<batch_sz; j++ ) {
+    if( FD_LIKELY( errs[ j ]==FD_ED25519_SUCCESS ) ) {
+      uchar const * S = sigs[ j ] + 32;
+      fd_curve25519_scalar_reduce( k[j], k[j] );
+
+      fd_ed25519_point_t Rcmp[1];
+      fd_ed25519_point_neg( &Aprime[j], &Aprime[j] );
+      fd_ed25519_double_scalar_mul_base( Rcmp, k[j], &Aprime[j], S );
+      if( FD_UNLIKELY( !fd_ed25519_point_eq_z1( Rcmp, &R[j] ) ) ) {
+        errs[ j ] = FD_ED25519_ERR_MSG;
+      }
+    }
+    if( FD_UNLIKELY( errs[ j ] && !err ) ) err = errs[ j ];
+  }
+  return err;
+}
+
 char const *
 fd_ed25519_strerror( int err ) {
   switch( err ) {
@@ -1009,6 +1009,76 @@ test_verify( fd_rng_t *    rng,
   }
 }
 
+void
+test_verify_batch( fd_rng_t *    rng,
+                   fd_sha512_t * sha ) {
+  static uchar msgs[ FD_ED25519_VERIFY_BATCH_MAX ][ 2048 ];
+  ulong        szs [ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar        sigs[ FD_ED25519_VERIFY_BATCH_MAX ][ 64 ];
+  uchar        pubs[ FD_ED25519_VERIFY_BATCH_MAX ][ 32 ];
+  uchar const * msg_ptrs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar const * sig_ptrs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  uchar const * pub_ptrs[ FD_ED25519_VERIFY_BATCH_MAX ];
+  int           errs    [ FD_ED25519_VERIFY_BATCH_MAX ];
+
+  for( ulong rem=256UL; rem; rem-- ) {
+    ulong batch_sz = 1UL + fd_rng_ulong_roll( rng, FD_ED25519_VERIFY_BATCH_MAX );
+    for( ulong j=0UL; j<batch_sz; j++ ) {
+      uchar prv[ 32 ];
+      /* Mostly gossip sized messages, some too long to batch hash */
+      szs[j] = fd_rng_ulong_roll( rng, (fd_rng_uint( rng ) & 7U) ? 1281UL : 2049UL );
+      for( ulong b=0UL; b<szs[j]; b++ ) msgs[j][b] = fd_rng_uchar( rng );
+      fd_ed25519_public_from_private( pubs[j], fd_rng_b256( rng, prv ), sha );
+      fd_ed25519_sign( sigs[j], msgs[j], szs[j], pubs[j], prv, sha );
+
+      uint r = fd_rng_uint( rng );
+      if( !(r & 7U) ) sigs[j][ fd_rng_uint_roll( rng, 64U ) ] ^= (uchar)(1U<<(r>>29));
+      if( !(r & 56U) && szs[j] ) msgs[j][ fd_rng_ulong_roll( rng, szs[j] ) ] ^= (uchar)1;
+      if( !(r & 448U) ) pubs[j][ fd_rng_uint_roll( rng, 32U ) ] ^= (uchar)(1U<<(r>>29));
+
+      msg_ptrs[j] = msgs[j]; sig_ptrs[j] = sigs[j]; pub_ptrs[j] = pubs[j];
+    }
+
+    int err = fd_ed25519_verify_batch( msg_ptrs, szs, sig_ptrs, pub_ptrs, errs, batch_sz );
+    int first = FD_ED25519_SUCCESS;
+    for( ulong j=0UL; j<batch_sz; j++ ) {
+      int ref = fd_ed25519_verify( msgs[j], szs[j], sigs[j], pubs[j], sha );
+      FD_TEST( errs[j]==ref );
+      if( ref && !first ) first = ref;
+    }
+    FD_TEST( err==first );
+  }
+
+  /* Bench against one at a time verification of gossip sized messages */
+
+  ulong sz = 256UL;
+  for( ulong j=0UL; j<FD_ED25519_VERIFY_BATCH_MAX; j++ ) {
+    uchar prv[ 32 ];
+    szs[j] = sz;
+    fd_ed25519_public_from_private( pubs[j], fd_rng_b256( rng, prv ), sha );
+    fd_ed25519_sign( sigs[j], msgs[j], sz, pubs[j], prv, sha );
+  }
+  FD_TEST( fd_ed25519_verify_batch( msg_ptrs, szs, sig_ptrs, pub_ptrs, errs, FD_ED25519_VERIFY_BATCH_MAX )==FD_ED25519_SUCCESS );
+
+  ulong iter = 1000UL;
+  long dt = fd_log_wallclock();
+  for( ulong rem=iter; rem; rem-- ) {
+    FD_COMPILER_FORGET( sha );
+    for( ulong j=0UL; j<FD_ED25519_VERIFY_BATCH_MAX; j++ ) fd_ed25519_verify( msgs[j], sz, sigs[j], pubs[j], sha );
+  }
+  dt = fd_log_wallclock() - dt;
+  char cstr[128];
+  log_bench( fd_cstr_printf( cstr, 128UL, NULL, "fd_ed25519_verify(%lu) x %lu", sz, FD_ED25519_VERIFY_BATCH_MAX ), iter*FD_ED25519_VERIFY_BATCH_MAX, dt );
+
+  dt = fd_log_wallclock();
+  for( ulong rem=iter; rem; rem-- ) {
+    FD_COMPILER_MFENCE();
+    fd_ed25519_verify_batch( msg_ptrs, szs, sig_ptrs, pub_ptrs, errs, FD_ED25519_VERIFY_BATCH_MAX );
+  }
+  dt = fd_log_wallclock() - dt;
+  log_bench( fd_cstr_printf( cstr, 128UL, NULL, "fd_ed25519_verify_batch(%lu / %lu)", sz, FD_ED25519_VERIFY_BATCH_MAX ), iter*FD_ED25519_VERIFY_BATCH_MAX, dt );
+}
+
 void
 test_wycheproofs( fd_sha512_t * sha ) {
   char cstr[128];
@@ -1113,6 +1183,7 @@ main( int     argc,
   test_public_from_private( rng, sha );
   test_sign               ( rng, sha );
   test_verify             ( rng, sha );
+  test_verify_batch       ( rng, sha );
 
   test_wycheproofs( sha );
   test_cctv       ( sha );
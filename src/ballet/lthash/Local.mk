@@ -1,2 +1,5 @@
 $(call add-hdrs,fd_lthash.h)
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_lthash_batch_avx512,fd_ballet)
+endif
 $(call make-unit-test,test_lthash,test_lthash,fd_ballet fd_util)
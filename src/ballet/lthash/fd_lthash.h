@@ -56,4 +56,190 @@ fd_lthash_sub( fd_lthash_value_t * restrict       r,
 
 FD_PROTOTYPES_END
 
+#if 0 /* LtHash batch API details */
+
+/* FD_LTHASH_BATCH_{ALIGN,FOOTPRINT} return the alignment and footprint
+   in bytes required for a region of memory to can hold the state of an
+   in-progress batch of lthash accumulations.  ALIGN will be an integer
+   power of 2 and FOOTPRINT will be a multiple of ALIGN.  These are to
+   facilitate compile time declarations. */
+
+#define FD_LTHASH_BATCH_ALIGN     ...
+#define FD_LTHASH_BATCH_FOOTPRINT ...
+
+/* FD_LTHASH_BATCH_MAX returns the batch size used under the hood.
+   Will be positive.  Users should not normally need use this for
+   anything. */
+
+#define FD_LTHASH_BATCH_MAX       ...
+
+/* A fd_lthash_batch_t is an opaque handle for a set of lthash
+   accumulations. */
+
+struct fd_lthash_private_batch;
+typedef struct fd_lthash_private_batch fd_lthash_batch_t;
+
+/* fd_lthash_batch_{align,footprint} return
+   FD_LTHASH_BATCH_{ALIGN,FOOTPRINT} respectively. */
+
+ulong fd_lthash_batch_align    ( void );
+ulong fd_lthash_batch_footprint( void );
+
+/* fd_lthash_batch_init starts a new batch of lthash accumulations into
+   the lthash value pointed to by sum.  The state of the in-progress
+   batch will be held in the memory region whose first byte in the local
+   address space is pointed to by mem.  The region should have the
+   appropriate alignment and footprint and should not be read, changed
+   or deleted until fini is called on the in-progress batch.  Likewise,
+   sum should not be read, written or deleted until fini.
+
+   Returns a handle to the in-progress batch.  As this is used in HPC
+   contexts, does no input validation. */
+
+fd_lthash_batch_t *
+fd_lthash_batch_init( void *              mem,
+                      fd_lthash_value_t * sum );
+
+/* fd_lthash_batch_add adds lthash(data[0,sz)) to the sum of the
+   in-progress batch.  That is, after fini, sum will have been
+   incremented as if by fd_lthash_add of the lthash of every message
+   added.  The message should not be changed or deleted until fini.
+
+   The accelerated implementations expand messages of at most 64 bytes
+   (a single BLAKE3 block, which covers the 32 byte account hashes that
+   replay accumulates) several at a time.  Longer messages are still
+   supported but are expanded one at a time.
+
+   Returns batch.  As this is used in HPC contexts, does no input
+   validation. */
+
+fd_lthash_batch_t *
+fd_lthash_batch_add( fd_lthash_batch_t * batch,
+                     void const *        data,
+                     ulong               sz );
+
+/* fd_lthash_batch_fini finishes a batch.  On return, sum holds the
+   result.  Returns a pointer to the memory region used to hold the
+   batch state (contents undefined). */
+
+void *
+fd_lthash_batch_fini( fd_lthash_batch_t * batch );
+
+#endif
+
+#ifndef FD_LTHASH_BATCH_IMPL
+#if FD_HAS_AVX512
+#define FD_LTHASH_BATCH_IMPL 1
+#else
+#define FD_LTHASH_BATCH_IMPL 0
+#endif
+#endif
+
+#if FD_LTHASH_BATCH_IMPL==0 /* Reference batching implementation */
+
+#define FD_LTHASH_BATCH_ALIGN     (8UL)
+#define FD_LTHASH_BATCH_FOOTPRINT (8UL)
+#define FD_LTHASH_BATCH_MAX       (1UL)
+
+struct fd_lthash_private_batch {
+  fd_lthash_value_t * sum;
+};
+
+typedef struct fd_lthash_private_batch fd_lthash_batch_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST static inline ulong fd_lthash_batch_align    ( void ) { return alignof(fd_lthash_batch_t); }
+FD_FN_CONST static inline ulong fd_lthash_batch_footprint( void ) { return sizeof (fd_lthash_batch_t); }
+
+static inline fd_lthash_batch_t *
+fd_lthash_batch_init( void *              mem,
+                      fd_lthash_value_t * sum ) {
+  fd_lthash_batch_t * batch = (fd_lthash_batch_t *)mem;
+  batch->sum = sum;
+  return batch;
+}
+
+static inline fd_lthash_batch_t *
+fd_lthash_batch_add( fd_lthash_batch_t * batch,
+                     void const *        data,
+                     ulong               sz ) {
+  fd_lthash_t       lthash[1];
+  fd_lthash_value_t value [1];
+  fd_lthash_add( batch->sum, fd_lthash_fini( fd_lthash_append( fd_lthash_init( lthash ), data, sz ), value ) );
+  return batch;
+}
+
+static inline void * fd_lthash_batch_fini( fd_lthash_batch_t * batch ) { return (void *)batch; }
+
+FD_PROTOTYPES_END
+
+#elif FD_LTHASH_BATCH_IMPL==1 /* AVX-512 accelerated batching implementation */
+
+#define FD_LTHASH_BATCH_ALIGN     (128UL)
+#define FD_LTHASH_BATCH_FOOTPRINT (384UL)
+#define FD_LTHASH_BATCH_MAX       (16UL)
+
+/* This is exposed here to facilitate inlining various operations */
+
+struct __attribute__((aligned(FD_LTHASH_BATCH_ALIGN))) fd_lthash_private_batch {
+  void const *        data[ FD_LTHASH_BATCH_MAX ];
+  ulong               sz  [ FD_LTHASH_BATCH_MAX ];
+  fd_lthash_value_t * sum;
+  ulong               cnt;
+};
+
+typedef struct fd_lthash_private_batch fd_lthash_batch_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* Internal use only */
+
+void
+fd_lthash_private_batch_avx512( ulong                batch_cnt,  /* In [1,FD_LTHASH_BATCH_MAX] */
+                                void const * const * batch_data, /* Indexed [0,batch_cnt) */
+                                ulong const *        batch_sz,   /* Indexed [0,batch_cnt) */
+                                fd_lthash_value_t *  sum );
+
+FD_FN_CONST static inline ulong fd_lthash_batch_align    ( void ) { return alignof(fd_lthash_batch_t); }
+FD_FN_CONST static inline ulong fd_lthash_batch_footprint( void ) { return sizeof (fd_lthash_batch_t); }
+
+static inline fd_lthash_batch_t *
+fd_lthash_batch_init( void *              mem,
+                      fd_lthash_value_t * sum ) {
+  fd_lthash_batch_t * batch = (fd_lthash_batch_t *)mem;
+  batch->sum = sum;
+  batch->cnt = 0UL;
+  return batch;
+}
+
+static inline fd_lthash_batch_t *
+fd_lthash_batch_add( fd_lthash_batch_t * batch,
+                     void const *        data,
+                     ulong               sz ) {
+  ulong batch_cnt = batch->cnt;
+  batch->data[ batch_cnt ] = data;
+  batch->sz  [ batch_cnt ] = sz;
+  batch_cnt++;
+  if( FD_UNLIKELY( batch_cnt==FD_LTHASH_BATCH_MAX ) ) {
+    fd_lthash_private_batch_avx512( batch_cnt, batch->data, batch->sz, batch->sum );
+    batch_cnt = 0UL;
+  }
+  batch->cnt = batch_cnt;
+  return batch;
+}
+
+static inline void *
+fd_lthash_batch_fini( fd_lthash_batch_t * batch ) {
+  ulong batch_cnt = batch->cnt;
+  if( FD_LIKELY( batch_cnt ) ) fd_lthash_private_batch_avx512( batch_cnt, batch->data, batch->sz, batch->sum );
+  return (void *)batch;
+}
+
+FD_PROTOTYPES_END
+
+#else
+#error "Unsupported FD_LTHASH_BATCH_IMPL"
+#endif
+
 #endif /* HEADER_fd_src_ballet_lthash_fd_lthash_h */
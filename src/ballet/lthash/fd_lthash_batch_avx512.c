@@ -0,0 +1,156 @@
+#define FD_LTHASH_BATCH_IMPL 1
+
+#include "fd_lthash.h"
+#include "../../util/simd/fd_avx512.h"
+
+FD_STATIC_ASSERT( FD_LTHASH_BATCH_MAX==16UL,                               compat );
+FD_STATIC_ASSERT( FD_LTHASH_BATCH_FOOTPRINT==sizeof(fd_lthash_batch_t),    compat );
+FD_STATIC_ASSERT( FD_LTHASH_LEN_BYTES==2UL*FD_LTHASH_BATCH_MAX*64UL,       compat );
+
+/* An lthash is the first 2048 bytes of BLAKE3 XOF output, i.e. 32
+   output blocks of 64 bytes.  For a message that fits in one BLAKE3
+   block (at most 64 bytes), output block j is the compression of that
+   block with the IV as chaining value, counter j and the
+   CHUNK_START|CHUNK_END|ROOT flags.  The 32 compressions of a message
+   only differ in the counter, so we run them as two passes of 16
+   lanes (counters 0-15 and 16-31) with the message words broadcast.
+
+   Lane j of output word i then holds word i of output block j.  Rather
+   than transposing after every message, we accumulate the outputs of
+   all the messages of the batch in this transposed layout (the 16-bit
+   lthash lanes never straddle a 32-bit word, so the adds commute with
+   the transpose) and transpose once per batch. */
+
+#define FD_LTHASH_PRIVATE_FLAGS (1U|2U|8U) /* CHUNK_START | CHUNK_END | ROOT */
+
+static uint const fd_lthash_private_iv[8] = {
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU, 0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+static uchar const fd_lthash_private_sched[7][16] = {
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+  {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+  {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+  { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+  { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+  {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+  { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 },
+};
+
+/* fd_lthash_private_xof16 computes the 16 output blocks of the single
+   block message m (block_len sz) with counters given by the lanes of
+   ctr and adds them (as 16-bit lanes) into the transposed accumulator
+   acc. */
+
+static inline void
+fd_lthash_private_xof16( uint const m[ 16 ],
+                         uint       sz,
+                         wwu_t      ctr,
+                         wwu_t      acc[ 16 ] ) {
+  uint const * iv = fd_lthash_private_iv;
+
+  wwu_t v0 = wwu_bcast( iv[0] ); wwu_t v1 = wwu_bcast( iv[1] ); wwu_t v2 = wwu_bcast( iv[2] ); wwu_t v3 = wwu_bcast( iv[3] );
+  wwu_t v4 = wwu_bcast( iv[4] ); wwu_t v5 = wwu_bcast( iv[5] ); wwu_t v6 = wwu_bcast( iv[6] ); wwu_t v7 = wwu_bcast( iv[7] );
+  wwu_t v8 = wwu_bcast( iv[0] ); wwu_t v9 = wwu_bcast( iv[1] ); wwu_t va = wwu_bcast( iv[2] ); wwu_t vb = wwu_bcast( iv[3] );
+  wwu_t vc = ctr;                wwu_t vd = wwu_zero();
+  wwu_t ve = wwu_bcast( sz );    wwu_t vf = wwu_bcast( FD_LTHASH_PRIVATE_FLAGS );
+
+# define G(a,b,c,d,x,y) do {                                            \
+    a = wwu_add( wwu_add( a, b ), wwu_bcast( x ) ); d = wwu_ror( wwu_xor( d, a ), 16 ); \
+    c = wwu_add( c, d );                            b = wwu_ror( wwu_xor( b, c ), 12 ); \
+    a = wwu_add( wwu_add( a, b ), wwu_bcast( y ) ); d = wwu_ror( wwu_xor( d, a ),  8 ); \
+    c = wwu_add( c, d );                            b = wwu_ror( wwu_xor( b, c ),  7 ); \
+  } while(0)
+
+  for( ulong r=0UL; r<7UL; r++ ) {
+    uchar const * s = fd_lthash_private_sched[ r ];
+    G( v0, v4, v8, vc, m[ s[ 0] ], m[ s[ 1] ] );
+    G( v1, v5, v9, vd, m[ s[ 2] ], m[ s[ 3] ] );
+    G( v2, v6, va, ve, m[ s[ 4] ], m[ s[ 5] ] );
+    G( v3, v7, vb, vf, m[ s[ 6] ], m[ s[ 7] ] );
+    G( v0, v5, va, vf, m[ s[ 8] ], m[ s[ 9] ] );
+    G( v1, v6, vb, vc, m[ s[10] ], m[ s[11] ] );
+    G( v2, v7, v8, vd, m[ s[12] ], m[ s[13] ] );
+    G( v3, v4, v9, ve, m[ s[14] ], m[ s[15] ] );
+  }
+
+# undef G
+
+  /* XOF output words are v[i]^v[i+8] and v[i+8]^cv[i] */
+
+  acc[ 0] = _mm512_add_epi16( acc[ 0], wwu_xor( v0, v8 ) );
+  acc[ 1] = _mm512_add_epi16( acc[ 1], wwu_xor( v1, v9 ) );
+  acc[ 2] = _mm512_add_epi16( acc[ 2], wwu_xor( v2, va ) );
+  acc[ 3] = _mm512_add_epi16( acc[ 3], wwu_xor( v3, vb ) );
+  acc[ 4] = _mm512_add_epi16( acc[ 4], wwu_xor( v4, vc ) );
+  acc[ 5] = _mm512_add_epi16( acc[ 5], wwu_xor( v5, vd ) );
+  acc[ 6] = _mm512_add_epi16( acc[ 6], wwu_xor( v6, ve ) );
+  acc[ 7] = _mm512_add_epi16( acc[ 7], wwu_xor( v7, vf ) );
+  acc[ 8] = _mm512_add_epi16( acc[ 8], wwu_xor( v8, wwu_bcast( iv[0] ) ) );
+  acc[ 9] = _mm512_add_epi16( acc[ 9], wwu_xor( v9, wwu_bcast( iv[1] ) ) );
+  acc[10] = _mm512_add_epi16( acc[10], wwu_xor( va, wwu_bcast( iv[2] ) ) );
+  acc[11] = _mm512_add_epi16( acc[11], wwu_xor( vb, wwu_bcast( iv[3] ) ) );
+  acc[12] = _mm512_add_epi16( acc[12], wwu_xor( vc, wwu_bcast( iv[4] ) ) );
+  acc[13] = _mm512_add_epi16( acc[13], wwu_xor( vd, wwu_bcast( iv[5] ) ) );
+  acc[14] = _mm512_add_epi16( acc[14], wwu_xor( ve, wwu_bcast( iv[6] ) ) );
+  acc[15] = _mm512_add_epi16( acc[15], wwu_xor( vf, wwu_bcast( iv[7] ) ) );
+}
+
+/* fd_lthash_private_fold transposes the accumulator acc of output
+   blocks [16*half,16*half+16) and adds it into sum. */
+
+static inline void
+fd_lthash_private_fold( fd_lthash_value_t * sum,
+                        ulong               half,
+                        wwu_t const         acc[ 16 ] ) {
+  wwu_t b[ 16 ];
+  wwu_transpose_16x16( acc[ 0], acc[ 1], acc[ 2], acc[ 3], acc[ 4], acc[ 5], acc[ 6], acc[ 7],
+                       acc[ 8], acc[ 9], acc[10], acc[11], acc[12], acc[13], acc[14], acc[15],
+                       b[ 0], b[ 1], b[ 2], b[ 3], b[ 4], b[ 5], b[ 6], b[ 7],
+                       b[ 8], b[ 9], b[10], b[11], b[12], b[13], b[14], b[15] );
+  uint * out = (uint *)( sum->bytes + half*1024UL );
+  for( ulong j=0UL; j<16UL; j++ ) wwu_st( out + 16UL*j, _mm512_add_epi16( wwu_ld( out + 16UL*j ), b[ j ] ) );
+}
+
+void
+fd_lthash_private_batch_avx512( ulong                batch_cnt,
+                                void const * const * batch_data,
+                                ulong const *        batch_sz,
+                                fd_lthash_value_t *  sum ) {
+
+  wwu_t acc_lo[ 16 ];
+  wwu_t acc_hi[ 16 ];
+  for( ulong i=0UL; i<16UL; i++ ) { acc_lo[ i ] = wwu_zero(); acc_hi[ i ] = wwu_zero(); }
+
+  wwu_t ctr_lo = wwu( 0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U, 10U, 11U, 12U, 13U, 14U, 15U );
+  wwu_t ctr_hi = wwu_add( ctr_lo, wwu_bcast( 16U ) );
+
+  ulong fast_cnt = 0UL;
+  for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+    void const * data = batch_data[ batch_idx ];
+    ulong        sz   = batch_sz  [ batch_idx ];
+
+    if( FD_UNLIKELY( sz>64UL ) ) {
+      /* Multi-block messages take the reference path */
+      fd_lthash_t       lthash[1];
+      fd_lthash_value_t value [1];
+      fd_lthash_add( sum, fd_lthash_fini( fd_lthash_append( fd_lthash_init( lthash ), data, sz ), value ) );
+      continue;
+    }
+
+    /* Load the zero padded message block (BLAKE3 is little endian) */
+
+    uint m[ 16 ] __attribute__((aligned(64)));
+    wwu_st( m, wwu_zero() );
+    fd_memcpy( m, data, sz );
+
+    fd_lthash_private_xof16( m, (uint)sz, ctr_lo, acc_lo );
+    fd_lthash_private_xof16( m, (uint)sz, ctr_hi, acc_hi );
+    fast_cnt++;
+  }
+
+  if( FD_LIKELY( fast_cnt ) ) {
+    fd_lthash_private_fold( sum, 0UL, acc_lo );
+    fd_lthash_private_fold( sum, 1UL, acc_hi );
+  }
+}
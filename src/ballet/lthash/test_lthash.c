@@ -204,6 +204,81 @@ main( int     argc,
     FD_LOG_ERR(( "FAIL fd_lthash_zero()" ));
   }
 
+  /* Test the batch API against the reference, including messages that
+     are too long for the accelerated path */
+
+  uchar batch_mem[ FD_LTHASH_BATCH_FOOTPRINT ] __attribute__((aligned(FD_LTHASH_BATCH_ALIGN)));
+  FD_TEST( fd_lthash_batch_align()==FD_LTHASH_BATCH_ALIGN );
+  FD_TEST( fd_lthash_batch_footprint()==FD_LTHASH_BATCH_FOOTPRINT );
+
+# define DATA_MAX  (96UL)
+# define BATCH_MAX (40UL)
+  uchar data[ BATCH_MAX ][ DATA_MAX ];
+  ulong sz  [ BATCH_MAX ];
+  for( ulong iter=0UL; iter<1000UL; iter++ ) {
+    ulong batch_cnt = fd_rng_ulong_roll( rng, BATCH_MAX+1UL );
+
+    FD_TEST( fd_lthash_zero( value )==value );
+    FD_TEST( fd_lthash_zero( tmp   )==tmp   );
+    fd_lthash_value_t _ref[1];
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) {
+      sz[ batch_idx ] = fd_rng_ulong_roll( rng, (fd_rng_uint( rng ) & 1U) ? 65UL : DATA_MAX+1UL );
+      for( ulong b=0UL; b<sz[ batch_idx ]; b++ ) data[ batch_idx ][ b ] = fd_rng_uchar( rng );
+      fd_lthash_add( tmp, fd_lthash_fini( fd_lthash_append( fd_lthash_init( hash ), data[ batch_idx ], sz[ batch_idx ] ), _ref ) );
+    }
+
+    fd_lthash_batch_t * batch = fd_lthash_batch_init( batch_mem, value );
+    FD_TEST( batch );
+    for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) FD_TEST( fd_lthash_batch_add( batch, data[ batch_idx ], sz[ batch_idx ] )==batch );
+    FD_TEST( fd_lthash_batch_fini( batch )==(void *)batch_mem );
+
+    if( FD_UNLIKELY( memcmp( value, tmp, 2048 ) ) ) {
+      FD_LOG_ERR(( "FAIL lthash batch (iter %lu, batch_cnt %lu)", iter, batch_cnt ));
+    }
+  }
+# undef BATCH_MAX
+# undef DATA_MAX
+
+  /* Benchmark accumulating account hashes (32 byte messages) */
+
+  uchar acc_hash[ 32 ];
+  for( ulong b=0UL; b<32UL; b++ ) acc_hash[ b ] = fd_rng_uchar( rng );
+
+  FD_LOG_NOTICE(( "Benchmarking incremental" ));
+  do {
+    /* warmup */
+    for( ulong rem=10UL; rem; rem-- ) fd_lthash_add( value, fd_lthash_fini( fd_lthash_append( fd_lthash_init( hash ), acc_hash, 32UL ), tmp ) );
+
+    /* for real */
+    ulong iter = 100000UL;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) fd_lthash_add( value, fd_lthash_fini( fd_lthash_append( fd_lthash_init( hash ), acc_hash, 32UL ), tmp ) );
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "~%6.3f M accounts/s / core", (double)((float)iter*1e3f / (float)dt) ));
+  } while(0);
+
+  FD_LOG_NOTICE(( "Benchmarking batched" ));
+  for( ulong batch_cnt=1UL; batch_cnt<=32UL; batch_cnt<<=1 ) {
+
+    /* warmup */
+    for( ulong rem=10UL; rem; rem-- ) {
+      fd_lthash_batch_t * batch = fd_lthash_batch_init( batch_mem, value );
+      for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) fd_lthash_batch_add( batch, acc_hash, 32UL );
+      fd_lthash_batch_fini( batch );
+    }
+
+    /* for real */
+    ulong iter = 100000UL / batch_cnt;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      fd_lthash_batch_t * batch = fd_lthash_batch_init( batch_mem, value );
+      for( ulong batch_idx=0UL; batch_idx<batch_cnt; batch_idx++ ) fd_lthash_batch_add( batch, acc_hash, 32UL );
+      fd_lthash_batch_fini( batch );
+    }
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "~%6.3f M accounts/s / core (batch_cnt %2lu)", (double)((float)(iter*batch_cnt)*1e3f / (float)dt), batch_cnt ));
+  }
+
   fd_rng_delete( fd_rng_leave( rng ) );
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
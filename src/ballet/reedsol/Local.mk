@@ -13,6 +13,14 @@ $(call add-objs,fd_reedsol_recover_64,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_128,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_256,fd_reedsol)
 $(call add-objs,fd_reedsol_pi,fd_reedsol)
+ifdef FD_HAS_GFNI
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_reedsol_recover_gfni512_32,fd_reedsol)
+$(call add-objs,fd_reedsol_recover_gfni512_64,fd_reedsol)
+$(call add-objs,fd_reedsol_recover_gfni512_128,fd_reedsol)
+$(call add-objs,fd_reedsol_recover_gfni512_256,fd_reedsol)
+endif
+endif
 $(call make-unit-test,test_reedsol,test_reedsol,fd_reedsol fd_util)
 ifdef FD_HAS_HOSTED
 $(call make-fuzz-test,fuzz_reedsol,fuzz_reedsol,fd_reedsol fd_util)
@@ -66,6 +66,21 @@ fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
 
   if( FD_UNLIKELY( i<16UL ) )
     return fd_reedsol_private_recover_var_16( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
+
+# if FD_REEDSOL_ARITH_IMPL==3
+  /* The wide kernels need at least one full 64 byte vector per shred.
+     Real shreds are much bigger than that, so this is the common case. */
+  if( FD_LIKELY( rs->shred_sz>=64UL ) ) {
+    if( FD_LIKELY(   i<32UL ) )
+      return fd_reedsol_private_recover_var_32_gfni512( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
+    if( FD_LIKELY(   i<64UL ) )
+      return fd_reedsol_private_recover_var_64_gfni512( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
+    if( FD_LIKELY(   i<128UL ) )
+      return fd_reedsol_private_recover_var_128_gfni512( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
+    return fd_reedsol_private_recover_var_256_gfni512( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
+  }
+# endif
+
   if( FD_LIKELY(   i<32UL ) )
     return fd_reedsol_private_recover_var_32( rs->shred_sz, rs->recover.shred, data_shred_cnt, parity_shred_cnt, rs->recover.erased );
   if( FD_LIKELY(   i<64UL ) )
@@ -0,0 +1,50 @@
+#ifndef HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni512_h
+#define HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni512_h
+
+#ifndef HEADER_fd_src_ballet_reedsol_fd_reedsol_private_h
+#error "Do not include this file directly; use fd_reedsol_private.h"
+#endif
+
+/* Same as fd_reedsol_arith_gfni.h, but operates on 64 bytes of each
+   shred at a time using 512-bit vectors.  This is only used to build
+   the wide recovery kernels (see fd_reedsol_recover_gfni512_*.c), so
+   W_ATTR and friends still come from fd_avx.h, which is what the Pi
+   computation expects.  AVX-512 requires GCC>=10, so the workaround
+   for the older GCC bug in fd_reedsol_arith_gfni.h isn't needed. */
+
+#include "../../util/simd/fd_avx.h"
+#include "../../util/simd/fd_avx512.h"
+
+typedef __m512i gf_t;
+
+#define GF_WIDTH 64UL
+
+FD_PROTOTYPES_BEGIN
+
+#define gf_ldu(p)   _mm512_loadu_si512( (void const *)(p) )
+#define gf_stu(p,x) _mm512_storeu_si512( (void *)(p), (x) )
+#define gf_zero()   _mm512_setzero_si512()
+
+/* The constant table stores each 8x8 bit matrix replicated to fill 32
+   bytes, so we broadcast that to both halves of the vector. */
+extern uchar const fd_reedsol_arith_consts_gfni_mul[]  __attribute__((aligned(128)));
+
+#define GF_ADD _mm512_xor_si512
+
+#define GF_OR  _mm512_or_si512
+
+#define GF_MUL( a, c ) (__extension__({                                                                                      \
+    gf_t _a = (a);                                                                                                           \
+    int  _c = (c);                                                                                                           \
+    /* c is known at compile time, so this is not a runtime branch */                                                        \
+    ((_c==0) ? gf_zero() : ((_c==1) ? _a :                                                                                   \
+     _mm512_gf2p8affine_epi64_epi8( _a, _mm512_broadcast_i64x4( wb_ld( fd_reedsol_arith_consts_gfni_mul + 32*_c ) ), 0 ) )); \
+  }))
+
+#define GF_MUL_VAR( a, c ) (_mm512_gf2p8affine_epi64_epi8( (a), _mm512_broadcast_i64x4( wb_ld( fd_reedsol_arith_consts_gfni_mul + 32*(c) ) ), 0 ))
+
+#define GF_ANY( x ) (0UL != (ulong)_mm512_test_epi8_mask( (x), (x) ))
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_reedsol_fd_reedsol_arith_gfni512_h */
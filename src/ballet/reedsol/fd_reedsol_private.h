@@ -13,7 +13,12 @@
      0 - unaccelerated
      1 - AVX accelerated
      2 - GFNI accelerated with AVX2
-     3 - GFNI accelerated with AVX512 */
+     3 - GFNI accelerated with AVX512
+     4 - GFNI accelerated with 512-bit vectors
+
+   Implementation 4 is never selected by default.  The wide recovery
+   kernels (fd_reedsol_recover_gfni512_*.c) select it explicitly when
+   building with implementation 3, since it requires shred_sz>=64. */
 
 #ifndef FD_REEDSOL_ARITH_IMPL
 #if FD_HAS_GFNI && FD_HAS_AVX512
@@ -33,6 +38,8 @@
 #include "fd_reedsol_arith_avx2.h"
 #elif FD_REEDSOL_ARITH_IMPL==2 || FD_REEDSOL_ARITH_IMPL==3
 #include "fd_reedsol_arith_gfni.h"
+#elif FD_REEDSOL_ARITH_IMPL==4
+#include "fd_reedsol_arith_gfni512.h"
 #else
 #error "Unsupported FD_REEDSOL_ARITH_IMPL"
 #endif
@@ -155,6 +162,40 @@ fd_reedsol_private_recover_var_256( ulong           shred_sz,
                                     ulong           parity_shred_cnt,
                                     uchar const *   erased );
 
+#if FD_HAS_GFNI && FD_HAS_AVX512
+/* fd_reedsol_private_recover_var_{n}_gfni512 are the same as the above,
+   but process 64 bytes of each shred at a time.  They additionally
+   require shred_sz>=64. */
+
+int
+fd_reedsol_private_recover_var_32_gfni512( ulong           shred_sz,
+                                           uchar * const * shred,
+                                           ulong           data_shred_cnt,
+                                           ulong           parity_shred_cnt,
+                                           uchar const *   erased );
+
+int
+fd_reedsol_private_recover_var_64_gfni512( ulong           shred_sz,
+                                           uchar * const * shred,
+                                           ulong           data_shred_cnt,
+                                           ulong           parity_shred_cnt,
+                                           uchar const *   erased );
+
+int
+fd_reedsol_private_recover_var_128_gfni512( ulong           shred_sz,
+                                            uchar * const * shred,
+                                            ulong           data_shred_cnt,
+                                            ulong           parity_shred_cnt,
+                                            uchar const *   erased );
+
+int
+fd_reedsol_private_recover_var_256_gfni512( ulong           shred_sz,
+                                            uchar * const * shred,
+                                            ulong           data_shred_cnt,
+                                            ulong           parity_shred_cnt,
+                                            uchar const *   erased );
+#endif
+
 /* This below functions generate what:
 
      S. -J. Lin, T. Y. Al-Naffouri, Y. S. Han and W. -H. Chung, "Novel
@@ -0,0 +1,12 @@
+/* 512-bit version of fd_reedsol_recover_128.c.  Same source, but built
+   with gf_t holding 64 bytes of each shred instead of 32.  See
+   FD_REEDSOL_ARITH_IMPL in fd_reedsol_private.h. */
+
+#define FD_REEDSOL_ARITH_IMPL 4
+
+#define fd_reedsol_private_recover_var_128 fd_reedsol_private_recover_var_128_gfni512
+#define fd_reedsol_fft_128_0               fd_reedsol_fft_128_0_gfni512
+#define fd_reedsol_ifft_128_0              fd_reedsol_ifft_128_0_gfni512
+
+#include "fd_reedsol_recover_128.c"
+#include "wrapped_impl/fd_reedsol_fft_impl_128_0.c"
@@ -0,0 +1,12 @@
+/* 512-bit version of fd_reedsol_recover_256.c.  Same source, but built
+   with gf_t holding 64 bytes of each shred instead of 32.  See
+   FD_REEDSOL_ARITH_IMPL in fd_reedsol_private.h. */
+
+#define FD_REEDSOL_ARITH_IMPL 4
+
+#define fd_reedsol_private_recover_var_256 fd_reedsol_private_recover_var_256_gfni512
+#define fd_reedsol_fft_256_0               fd_reedsol_fft_256_0_gfni512
+#define fd_reedsol_ifft_256_0              fd_reedsol_ifft_256_0_gfni512
+
+#include "fd_reedsol_recover_256.c"
+#include "wrapped_impl/fd_reedsol_fft_impl_256_0.c"
@@ -0,0 +1,9 @@
+/* 512-bit version of fd_reedsol_recover_32.c.  Same source, but built
+   with gf_t holding 64 bytes of each shred instead of 32.  See
+   FD_REEDSOL_ARITH_IMPL in fd_reedsol_private.h. */
+
+#define FD_REEDSOL_ARITH_IMPL 4
+
+#define fd_reedsol_private_recover_var_32 fd_reedsol_private_recover_var_32_gfni512
+
+#include "fd_reedsol_recover_32.c"
@@ -843,6 +843,121 @@ test_recover( fd_rng_t * rng ) {
   }
 }
 
+/* The widest recovery kernels process 64 bytes of each shred at a
+   time, and fall back to narrower ones for small shreds.  Make sure odd
+   shred sizes on either side of that boundary recover correctly. */
+static void
+test_recover_shred_sz( fd_rng_t * rng ) {
+  uchar * d[ FD_REEDSOL_DATA_SHREDS_MAX   ];
+  uchar * p[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  uchar * r[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  for( ulong i=0UL; i<FD_REEDSOL_DATA_SHREDS_MAX;   i++ )  d[ i ] = data_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  p[ i ] = parity_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  r[ i ] = recovered_shreds + SHRED_SZ*i;
+
+  ulong const cnts[ 4 ] = { 12UL, 24UL, 48UL, 67UL }; /* One for each of the 32, 64, 128, and 256 kernels */
+  for( ulong shred_sz=32UL; shred_sz<=200UL; shred_sz+=7UL ) {
+    for( ulong c=0UL; c<4UL; c++ ) {
+      ulong d_cnt = cnts[ c ];
+      ulong p_cnt = cnts[ c ];
+      for( ulong i=0UL; i<d_cnt; i++ ) for( ulong j=0UL; j<shred_sz; j++ ) d[ i ][ j ] = fd_rng_uchar( rng );
+
+      fd_reedsol_t * rs = fd_reedsol_encode_init( mem, shred_sz );
+      for( ulong i=0UL; i<d_cnt; i++ ) fd_reedsol_encode_add_data_shred(   rs, d[ i ] );
+      for( ulong i=0UL; i<p_cnt; i++ ) fd_reedsol_encode_add_parity_shred( rs, p[ i ] );
+      fd_reedsol_encode_fini( rs );
+
+      /* Erase all the data shreds */
+      rs = fd_reedsol_recover_init( mem, shred_sz );
+      for( ulong i=0UL; i<d_cnt; i++ ) fd_reedsol_recover_add_erased_shred( rs, 1, r[ i ] );
+      for( ulong i=0UL; i<p_cnt; i++ ) fd_reedsol_recover_add_rcvd_shred(  rs, 0, p[ i ] );
+      FD_TEST( FD_REEDSOL_SUCCESS==fd_reedsol_recover_fini( rs ) );
+      for( ulong i=0UL; i<d_cnt; i++ ) FD_TEST( 0==memcmp( d[ i ], r[ i ], shred_sz ) );
+
+      /* Corrupt the last byte, which is only covered by the overlapping
+         final vector. */
+      p[ p_cnt-1UL ][ shred_sz-1UL ] ^= (uchar)1;
+      rs = fd_reedsol_recover_init( mem, shred_sz );
+      for( ulong i=0UL; i<d_cnt; i++ ) fd_reedsol_recover_add_rcvd_shred( rs, 1, d[ i ] );
+      for( ulong i=0UL; i<p_cnt; i++ ) fd_reedsol_recover_add_rcvd_shred( rs, 0, p[ i ] );
+      FD_TEST( FD_REEDSOL_ERR_CORRUPT==fd_reedsol_recover_fini( rs ) );
+      p[ p_cnt-1UL ][ shred_sz-1UL ] ^= (uchar)1;
+    }
+  }
+}
+
+/* Sweeps recovery throughput over FEC set sizes and erasure patterns.
+   Which recovery kernel gets used depends on how far into the FEC set
+   we need to go to find data_shred_cnt un-erased shreds, so the sweep
+   covers all of them. */
+static void
+test_recover_performance_sweep( fd_rng_t * rng ) {
+  uchar * d[ FD_REEDSOL_DATA_SHREDS_MAX   ];
+  uchar * p[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  uchar * r[ FD_REEDSOL_PARITY_SHREDS_MAX ];
+  for( ulong i=0UL; i<FD_REEDSOL_DATA_SHREDS_MAX;   i++ )  d[ i ] = data_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  p[ i ] = parity_shreds + SHRED_SZ*i;
+  for( ulong i=0UL; i<FD_REEDSOL_PARITY_SHREDS_MAX; i++ )  r[ i ] = recovered_shreds + SHRED_SZ*i;
+
+  for( ulong j=0UL; j<SHRED_SZ*FD_REEDSOL_DATA_SHREDS_MAX; j++ ) data_shreds[ j ] = fd_rng_uchar( rng );
+
+  ulong        const cnts[ 4 ]     = { 16UL, 32UL, 64UL, 67UL };
+  char const * const pattern[ 5 ]  = { "none", "parity", "data", "even", "random" };
+  ulong        const test_count    = 2000UL;
+  ulong        const warmup_count  =  500UL; /* Instruction cache and vector unit warm up */
+
+  for( ulong c=0UL; c<4UL; c++ ) {
+    ulong cnt = cnts[ c ];
+    fd_reedsol_t * rs = fd_reedsol_encode_init( mem, SHRED_SZ );
+    for( ulong i=0UL; i<cnt; i++ ) fd_reedsol_encode_add_parity_shred( fd_reedsol_encode_add_data_shred( rs, d[ i ] ), p[ i ] );
+    fd_reedsol_encode_fini( rs );
+
+    for( ulong k=0UL; k<5UL; k++ ) {
+      /* erased[ i ] for shred i (data then parity), with exactly cnt
+         shreds erased except for the "none" pattern. */
+      uchar erased[ 2UL*FD_REEDSOL_DATA_SHREDS_MAX ];
+      for( ulong i=0UL; i<2UL*cnt; i++ ) {
+        switch( k ) {
+          case 0UL: erased[ i ] = 0;                      break;
+          case 1UL: erased[ i ] = (uchar)(i>=cnt);        break;
+          case 2UL: erased[ i ] = (uchar)(i< cnt);        break;
+          case 3UL: erased[ i ] = (uchar)(!(i&1UL));      break;
+          default:  erased[ i ] = 0;                      break;
+        }
+      }
+      if( k==4UL ) { /* reservoir sample cnt of the 2 cnt shreds */
+        ulong erased_cnt = 0UL;
+        for( ulong i=0UL; i<2UL*cnt; i++ ) {
+          erased[ i ] = (uchar)(fd_rng_ulong_roll( rng, 2UL*cnt-i ) < (cnt-erased_cnt));
+          erased_cnt += erased[ i ];
+        }
+      }
+
+      long dt = 0L;
+      for( ulong iter=0UL; iter<test_count+warmup_count; iter++ ) {
+        ulong r_idx = 0UL;
+        rs = fd_reedsol_recover_init( mem, SHRED_SZ );
+        for( ulong i=0UL; i<cnt; i++ ) {
+          if( erased[ i ] ) fd_reedsol_recover_add_erased_shred( rs, 1, r[ r_idx++ ] );
+          else              fd_reedsol_recover_add_rcvd_shred(   rs, 1, d[ i ]       );
+        }
+        for( ulong i=0UL; i<cnt; i++ ) {
+          if( erased[ cnt+i ] ) fd_reedsol_recover_add_erased_shred( rs, 0, r[ r_idx++ ] );
+          else                  fd_reedsol_recover_add_rcvd_shred(   rs, 0, p[ i ]       );
+        }
+        long t0 = fd_log_wallclock();
+        FD_TEST( FD_REEDSOL_SUCCESS==fd_reedsol_recover_fini( rs ) );
+        if( FD_LIKELY( iter>=warmup_count ) ) dt += fd_log_wallclock() - t0;
+      }
+
+      FD_LOG_NOTICE(( "recover %2lu:%2lu %-6s erased: %10.3f ns ( %f Gbps )",
+                      cnt, cnt, pattern[ k ],
+                      (double)dt/(double)test_count,
+                      (double)(test_count * 2UL * cnt * SHRED_SZ * 8UL) / ((double)dt) ));
+    }
+  }
+}
+
 static void
 test_recover_performance( fd_rng_t *    rng ) {
   ulong const test_count = 90000UL;
@@ -999,7 +1114,9 @@ main( int     argc,
   battery_performance_generic( rng, 32UL, 32UL, 5000UL );
   test_encode_vs_ref( rng );
   test_recover( rng );
+  test_recover_shred_sz( rng );
   test_recover_performance( rng );
+  test_recover_performance_sweep( rng );
   test_pi_all( rng );
   test_linearity_all( rng );
   test_fft_all();
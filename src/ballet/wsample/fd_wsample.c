@@ -544,14 +544,74 @@ fd_wsample_remove_idx( fd_wsample_t * sampler,
   fd_wsample_remove( sampler, r );
 }
 
-/* For now, implement the _many functions as loops over the single
-   sample functions.  It is possible to do better though. */
+#if FD_HAS_AVX512 && R==9
+/* fd_wsample_map_sample8 is a batched version of
+   fd_wsample_map_sample_i that descends the tree for 8 independent
+   queries at once, one per lane.  Each query must be in [0,
+   unremoved_weight).  Returns the sampled indices, one per lane.
+
+   Rather than loading the node for each query and comparing it against
+   a broadcast query value, we gather the jth left sum of each lane's
+   node, so that at each level, lane k's child index is the number of
+   left sums <= query k, exactly as in the single query version.
+   Because the left sums of a node are non-decreasing, the amount to
+   subtract from the query, l[i-1] in the notation above, is the largest
+   left sum <= the query (or 0 if there isn't one), which we can
+   accumulate with masked maxes as we go.  Unlike the single query
+   version, we don't need to track the weight of the subtree, since
+   sampling with replacement doesn't need it.
+
+   The gathers for a given level all touch the same 8 cache lines, so
+   after the first one they hit L1, and the 8 descents proceed in
+   lockstep, which lets the CPU overlap the cache misses that otherwise
+   serialize a single descent. */
+static inline wwv_t
+fd_wsample_map_sample8( fd_wsample_t const * sampler,
+                        wwv_t                query ) {
+  void const * tree = sampler->tree;
+
+  wwv_t cursor = wwv_zero();
+  for( ulong h=0UL; h<sampler->height; h++ ) {
+    wwv_t base      = wwv_shl( cursor, 3 ); /* index of left_sum[0] of each lane's node, in ulongs */
+    wwv_t child_idx = wwv_zero();
+    wwv_t lm1       = wwv_zero();
+    for( ulong j=0UL; j<R-1UL; j++ ) {
+      wwv_t    ls   = _mm512_i64gather_epi64( wwv_add( base, wwv_bcast( j ) ), tree, 8 );
+      __mmask8 mask = _mm512_cmple_epu64_mask( ls, query );
+      child_idx = _mm512_mask_add_epi64( child_idx, mask, child_idx, wwv_one() );
+      lm1       = _mm512_mask_max_epu64( lm1,       mask, lm1,       ls        );
+    }
+    query  = wwv_sub( query, lm1 );
+    cursor = wwv_add( wwv_add( wwv_mul( cursor, wwv_bcast( R ) ), child_idx ), wwv_one() );
+  }
+  return wwv_sub( cursor, wwv_bcast( sampler->internal_node_cnt ) );
+}
+#endif
+
+/* sample_many draws all its random values from the same distribution,
+   so the descents are independent and can be batched.  The random
+   values are still drawn in order, so the results are identical to
+   calling fd_wsample_sample cnt times.  The _and_remove variant has a
+   dependency between consecutive samples, so it is implemented as a
+   loop over the single sample function. */
 
 void
 fd_wsample_sample_many( fd_wsample_t * sampler,
                         ulong        * idxs,
                         ulong          cnt  ) {
-  for( ulong i=0UL; i<cnt; i++ ) idxs[i] = fd_wsample_sample( sampler );
+  ulong S = sampler->unremoved_weight;
+  if( FD_UNLIKELY( !S ) ) {
+    for( ulong i=0UL; i<cnt; i++ ) idxs[ i ] = FD_WSAMPLE_EMPTY;
+    return;
+  }
+  ulong i=0UL;
+#if FD_HAS_AVX512 && R==9
+  for( ; i+8UL<=cnt; i+=8UL ) {
+    for( ulong j=0UL; j<8UL; j++ ) idxs[ i+j ] = fd_chacha20rng_ulong_roll( sampler->rng, S );
+    wwv_stu( idxs+i, fd_wsample_map_sample8( sampler, wwv_ldu( idxs+i ) ) );
+  }
+#endif
+  for( ; i<cnt; i++ ) idxs[ i ] = fd_wsample_map_sample_i( sampler, fd_chacha20rng_ulong_roll( sampler->rng, S ) ).idx;
 }
 
 void
@@ -145,7 +145,10 @@ void fd_wsample_seed_rng( fd_chacha20rng_t * rng, uchar seed[static 32] );
 
    The _many variants of the function store the ith index they sampled
    in idxs[i] for i in [0, cnt).  The other variants of the function
-   simply return the sampled index.
+   simply return the sampled index.  fd_wsample_sample_many produces
+   exactly the same samples as calling fd_wsample_sample cnt times, but
+   it batches the tree searches, so it is substantially faster when cnt
+   is more than a handful.
 
    If the sampler has no unremoved elements, these functions will
    return/store FD_WSAMPLE_EMPTY.
@@ -365,6 +365,90 @@ test_map( void ) {
   fd_chacha20rng_delete( fd_chacha20rng_leave( rng ) );
 }
 
+/* sample_many batches the tree descents, but it must produce exactly
+   the same samples as calling sample in a loop. */
+static void
+test_sample_many( void ) {
+  fd_chacha20rng_t _rng1[1];
+  fd_chacha20rng_t _rng2[1];
+  fd_chacha20rng_t * rng1 = fd_chacha20rng_join( fd_chacha20rng_new( _rng1, FD_CHACHA20RNG_MODE_SHIFT ) );
+  fd_chacha20rng_t * rng2 = fd_chacha20rng_join( fd_chacha20rng_new( _rng2, FD_CHACHA20RNG_MODE_SHIFT ) );
+
+  ulong idxs[ 1000UL ];
+  for( ulong sz=1UL; sz<=MAX; sz=sz*3UL+1UL ) {
+    void * pl1 = fd_wsample_new_init( _shmem , rng1, sz, 1, FD_WSAMPLE_HINT_POWERLAW_REMOVE );
+    void * pl2 = fd_wsample_new_init( _shmem2, rng2, sz, 1, FD_WSAMPLE_HINT_POWERLAW_REMOVE );
+    for( ulong i=0UL; i<sz; i++ ) pl1 = fd_wsample_new_add( pl1, 2000000UL / (i+1UL) );
+    for( ulong i=0UL; i<sz; i++ ) pl2 = fd_wsample_new_add( pl2, 2000000UL / (i+1UL) );
+    fd_wsample_t * sample1 = fd_wsample_join( fd_wsample_new_fini( pl1 ) );
+    fd_wsample_t * sample2 = fd_wsample_join( fd_wsample_new_fini( pl2 ) );
+
+    for( ulong cnt=0UL; cnt<=1000UL; cnt=cnt*2UL+1UL ) {
+      seed[ 0 ]++;
+      fd_wsample_seed_rng( rng1, seed );
+      fd_wsample_seed_rng( rng2, seed );
+
+      /* Remove a few elements so the batched descent sees an unevenly
+         populated tree. */
+      for( ulong i=0UL; i<sz/4UL; i++ ) {
+        fd_wsample_remove_idx( sample1, (i*7UL)%sz );
+        fd_wsample_remove_idx( sample2, (i*7UL)%sz );
+      }
+
+      fd_wsample_sample_many( sample1, idxs, cnt );
+      for( ulong i=0UL; i<cnt; i++ ) FD_TEST( idxs[ i ]==fd_wsample_sample( sample2 ) );
+
+      fd_wsample_restore_all( sample1 );
+      fd_wsample_restore_all( sample2 );
+    }
+    fd_wsample_delete( fd_wsample_leave( sample1 ) );
+    fd_wsample_delete( fd_wsample_leave( sample2 ) );
+  }
+
+  /* Everything removed */
+  void * partial = fd_wsample_new_init( _shmem, rng1, 9UL, 0, FD_WSAMPLE_HINT_FLAT );
+  for( ulong i=0UL; i<9UL; i++ ) partial = fd_wsample_new_add( partial, 1UL );
+  fd_wsample_t * tree = fd_wsample_join( fd_wsample_new_fini( partial ) );
+  for( ulong i=0UL; i<9UL; i++ ) fd_wsample_remove_idx( tree, i );
+  fd_wsample_sample_many( tree, idxs, 17UL );
+  for( ulong i=0UL; i<17UL; i++ ) FD_TEST( idxs[ i ]==FD_WSAMPLE_EMPTY );
+  fd_wsample_delete( fd_wsample_leave( tree ) );
+
+  fd_chacha20rng_delete( fd_chacha20rng_leave( rng2 ) );
+  fd_chacha20rng_delete( fd_chacha20rng_leave( rng1 ) );
+}
+
+static void
+bench_sample_many( void ) {
+  fd_chacha20rng_t _rng[1];
+  fd_chacha20rng_t * rng = fd_chacha20rng_join( fd_chacha20rng_new( _rng, FD_CHACHA20RNG_MODE_MOD ) );
+  fd_wsample_seed_rng( rng, seed );
+
+  void * partial = fd_wsample_new_init( _shmem, rng, MAX, 0, FD_WSAMPLE_HINT_POWERLAW_NOREMOVE );
+  for( ulong i=0UL; i<MAX; i++ ) partial = fd_wsample_new_add( partial, 2000000UL / (i+1UL) );
+  fd_wsample_t * tree = fd_wsample_join( fd_wsample_new_fini( partial ) );
+
+  ulong idxs[ 1024UL ];
+  ulong iter = 1000UL;
+
+  FD_LOG_NOTICE(( "Benchmarking fd_wsample_sample (%lu elements)", MAX ));
+  long dt = -fd_log_wallclock();
+  for( ulong rem=iter; rem; rem-- ) for( ulong i=0UL; i<1024UL; i++ ) idxs[ i ] = fd_wsample_sample( tree );
+  dt += fd_log_wallclock();
+  FD_COMPILER_UNPREDICTABLE( idxs[ 0 ] );
+  FD_LOG_NOTICE(( "  ~%6.3f ns / sample", (double)dt / (double)(1024UL*iter) ));
+
+  FD_LOG_NOTICE(( "Benchmarking fd_wsample_sample_many (%lu elements)", MAX ));
+  dt = -fd_log_wallclock();
+  for( ulong rem=iter; rem; rem-- ) fd_wsample_sample_many( tree, idxs, 1024UL );
+  dt += fd_log_wallclock();
+  FD_COMPILER_UNPREDICTABLE( idxs[ 0 ] );
+  FD_LOG_NOTICE(( "  ~%6.3f ns / sample", (double)dt / (double)(1024UL*iter) ));
+
+  fd_wsample_delete( fd_wsample_leave( tree ) );
+  fd_chacha20rng_delete( fd_chacha20rng_leave( rng ) );
+}
+
 static void
 test_empty( void ) {
   fd_chacha20rng_t _rng[1];
@@ -419,12 +503,15 @@ main( int     argc,
   test_sharing();
   test_restore_disabled();
   test_remove_idx();
+  test_sample_many();
   test_empty();
   test_footprint();
 
   test_probability_dist_replacement();
   test_probability_dist_noreplacement();
 
+  bench_sample_many();
+
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
   return 0;
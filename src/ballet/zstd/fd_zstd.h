@@ -86,6 +86,17 @@ fd_zstd_peek( fd_zstd_peek_t * peek,
               void const *     buf,
               ulong            bufsz );
 
+/* fd_zstd_frame_sz returns the compressed size of the frame starting
+   at buf (including its header and checksum), without decompressing
+   it.  bufsz is the number of bytes available at buf.  Returns 0UL if
+   buf does not yet contain the complete frame (caller should retry
+   with more data).  Returns ULONG_MAX on decode error.  Useful to split
+   a multi-frame stream into independently decompressable pieces. */
+
+FD_FN_PURE ulong
+fd_zstd_frame_sz( void const * buf,
+                  ulong        bufsz );
+
 /* fd_zstd_dstream_{align,footprint} return the parameters of the
    memory region backing a fd_zstd_dstream_t.  max_window_sz is the
    largest window size that this object is able to handle. */
@@ -152,6 +163,70 @@ fd_zstd_dstream_read( fd_zstd_dstream_t *     dstream,
                       uchar *                 out_end,
                       ulong *                 opt_errcode );
 
+/* Compress API *******************************************************/
+
+/* fd_zstd_cstream_t provides streaming compression into Zstandard
+   frames.  Produces one frame at a time. */
+
+struct fd_zstd_cstream;
+typedef struct fd_zstd_cstream fd_zstd_cstream_t;
+
+/* fd_zstd_cstream_{align,footprint} return the parameters of the
+   memory region backing a fd_zstd_cstream_t.  level is the Zstandard
+   compression level. */
+
+FD_FN_CONST ulong
+fd_zstd_cstream_align( void );
+
+ulong
+fd_zstd_cstream_footprint( int level );
+
+/* fd_zstd_cstream_new creates a new cstream object backed by the memory
+   region at mem.  mem matches align and footprint requirements for the
+   given compression level.  Returns a handle to the newly created
+   cstream object on success.  On failure, returns NULL.  Reasons for
+   failure include invalid level. */
+
+fd_zstd_cstream_t *
+fd_zstd_cstream_new( void * mem,
+                     int    level );
+
+/* fd_zstd_cstream_delete destroys the cstream object and releases its
+   memory region back to the caller. */
+
+void *
+fd_zstd_cstream_delete( fd_zstd_cstream_t * cstream );
+
+/* fd_zstd_cstream_reset discards any partially compressed frame, such
+   that the next compress starts a new frame. */
+
+void
+fd_zstd_cstream_reset( fd_zstd_cstream_t * cstream );
+
+/* fd_zstd_cstream_compress compresses a fragment of data.  Arguments
+   are as in fd_zstd_dstream_read, with in and out swapped roles.  If
+   end_frame is non-zero, the current frame is closed once all of the
+   input has been consumed.
+
+   Compressed data may be buffered internally until the frame is
+   closed (the frame content of concatenated calls is the concatenation
+   of all input fragments).  Returns 0 if progress was made and the
+   caller should continue with more input (or, if *in_p<in_end or
+   end_frame is set, with more output space).  Returns -1 if end_frame
+   was set and the frame was completely written out, in which case the
+   next call starts a new frame.  Returns EPROTO on error, the caller
+   should reset the cstream in this case.  If opt_errcode!=NULL and an
+   error occured, *opt_errcode is set accordingly. */
+
+int
+fd_zstd_cstream_compress( fd_zstd_cstream_t *     cstream,
+                          uchar const ** restrict in_p,
+                          uchar const *           in_end,
+                          uchar ** restrict       out_p,
+                          uchar *                 out_end,
+                          int                     end_frame,
+                          ulong *                 opt_errcode );
+
 FD_PROTOTYPES_END
 
 #endif /* FD_HAS_ZSTD */
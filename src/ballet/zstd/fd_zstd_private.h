@@ -15,3 +15,19 @@ struct __attribute__((aligned(FD_ZSTD_DSTREAM_ALIGN))) fd_zstd_dstream {
 
   __extension__ uchar mem[0];
 };
+
+#define FD_ZSTD_CSTREAM_ALIGN (32UL)
+#define FD_ZSTD_CSTREAM_MAGIC (0x6b1c3e0d94a25f71UL)  /* random */
+
+struct __attribute__((aligned(FD_ZSTD_CSTREAM_ALIGN))) fd_zstd_cstream {
+  /* This point is 32-byte aligned */
+
+  ulong magic;
+  ulong mem_sz;
+
+  uchar pad[16];
+
+  /* This point is 32-byte aligned */
+
+  __extension__ uchar mem[0];
+};
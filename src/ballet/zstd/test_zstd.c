@@ -3,6 +3,7 @@
 #include "../../util/fd_util.h"
 #include <stdalign.h>
 #include <stddef.h>
+#include <stdlib.h>
 
 #if !FD_HAS_ZSTD
 #error "fd_compress requires Zstandard"
@@ -12,6 +13,8 @@
 
 FD_STATIC_ASSERT( alignof ( fd_zstd_dstream_t      )==FD_ZSTD_DSTREAM_ALIGN, layout );
 FD_STATIC_ASSERT( offsetof( fd_zstd_dstream_t, mem )==FD_ZSTD_DSTREAM_ALIGN, layout );
+FD_STATIC_ASSERT( alignof ( fd_zstd_cstream_t      )==FD_ZSTD_CSTREAM_ALIGN, layout );
+FD_STATIC_ASSERT( offsetof( fd_zstd_cstream_t, mem )==FD_ZSTD_CSTREAM_ALIGN, layout );
 
 /* Test vectors */
 
@@ -130,6 +133,98 @@ test_decompress( void ) {
   FD_TEST( dstream->magic==0UL );
 }
 
+static void
+test_compress( void ) {
+  FD_TEST( fd_zstd_cstream_align()==FD_ZSTD_CSTREAM_ALIGN );
+
+  FD_TEST( !fd_zstd_cstream_new( NULL, 1000 ) );  /* bad level */
+
+  int   level  = 3;
+  ulong mem_sz = fd_zstd_cstream_footprint( level );
+  uchar * mem  = aligned_alloc( FD_ZSTD_CSTREAM_ALIGN, fd_ulong_align_up( mem_sz, FD_ZSTD_CSTREAM_ALIGN ) );
+  FD_TEST( mem );
+
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( mem, level );
+  FD_TEST( cstream );
+  FD_TEST( cstream->magic==FD_ZSTD_CSTREAM_MAGIC );
+
+  ulong window_sz = 1UL<<22;
+  ulong dmem_sz   = fd_zstd_dstream_footprint( window_sz );
+  uchar * dmem    = aligned_alloc( FD_ZSTD_DSTREAM_ALIGN, fd_ulong_align_up( dmem_sz, FD_ZSTD_DSTREAM_ALIGN ) );
+  FD_TEST( dmem );
+  fd_zstd_dstream_t * dstream = fd_zstd_dstream_new( dmem, window_sz );
+  FD_TEST( dstream );
+
+  static uchar data[ 65536 ];
+  for( ulong j=0UL; j<sizeof(data); j++ ) data[ j ] = (uchar)( (j*j)>>7 );
+
+  /* Two frames, each fed in small fragments, drained through a small
+     output buffer */
+
+  static uchar comp[ 2UL*sizeof(data) ];
+  uchar * comp_cur = comp;
+  ulong   frame_sz[2];
+  for( ulong k=0UL; k<2UL; k++ ) {
+    uchar * frame = comp_cur;
+    for( ulong off=0UL; off<sizeof(data); off+=1000UL ) {
+      uchar const * in_cur = data + off;
+      uchar const * in_end = data + fd_ulong_min( off+1000UL, sizeof(data) );
+      while( in_cur<in_end ) {
+        int rc = fd_zstd_cstream_compress( cstream, &in_cur, in_end, &comp_cur, fd_ptr_if( comp_cur+7UL<comp+sizeof(comp), comp_cur+7UL, comp+sizeof(comp) ), 0, NULL );
+        FD_TEST( rc==0 );
+      }
+    }
+    for(;;) {
+      uchar const * in_cur = data;
+      int rc = fd_zstd_cstream_compress( cstream, &in_cur, data, &comp_cur, comp_cur+7UL, 1, NULL );
+      FD_TEST( rc<=0 );
+      if( rc==-1 ) break;
+    }
+    frame_sz[ k ] = (ulong)( comp_cur - frame );
+    FD_TEST( fd_zstd_frame_sz( frame, frame_sz[ k ] )==frame_sz[ k ] );
+  }
+  FD_TEST( frame_sz[0]<sizeof(data) );
+
+  /* Concatenated frames decompress to the concatenated content */
+
+  static uchar out[ 2UL*sizeof(data) ];
+  uchar const * in_cur  = comp;
+  uchar *       out_cur = out;
+  for( ulong k=0UL; k<2UL; k++ ) {
+    int rc = fd_zstd_dstream_read( dstream, &in_cur, comp_cur, &out_cur, out+sizeof(out), NULL );
+    FD_TEST( rc==-1 );
+  }
+  FD_TEST( in_cur ==comp_cur         );
+  FD_TEST( out_cur==out+sizeof(out)  );
+  FD_TEST( 0==memcmp( out,              data, sizeof(data) ) );
+  FD_TEST( 0==memcmp( out+sizeof(data), data, sizeof(data) ) );
+
+  /* Abort partial compress */
+
+  do {
+    uchar const * in_cur = data;
+    uchar * comp_cur = comp;
+    FD_TEST( 0==fd_zstd_cstream_compress( cstream, &in_cur, data+100UL, &comp_cur, comp+sizeof(comp), 0, NULL ) );
+    fd_zstd_cstream_reset( cstream );
+    in_cur   = (uchar const *)"AAAA";
+    comp_cur = comp;
+    FD_TEST( -1==fd_zstd_cstream_compress( cstream, &in_cur, in_cur+4, &comp_cur, comp+sizeof(comp), 1, NULL ) );
+
+    fd_zstd_dstream_reset( dstream );
+    uchar const * dec_cur = comp;
+    out_cur = out;
+    FD_TEST( -1==fd_zstd_dstream_read( dstream, &dec_cur, comp_cur, &out_cur, out+sizeof(out), NULL ) );
+    FD_TEST( out_cur==out+4 );
+    FD_TEST( 0==memcmp( out, "AAAA", 4 ) );
+  } while(0);
+
+  FD_TEST( fd_zstd_dstream_delete( dstream )==dmem );
+  FD_TEST( fd_zstd_cstream_delete( cstream )==mem );
+  FD_TEST( cstream->magic==0UL );
+  free( dmem );
+  free( mem );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -147,7 +242,23 @@ main( int     argc,
              ( _peek->frame_content_sz   == ULONG_MAX  ) );
   }
 
+  /* Frame splitting */
+
+  do {
+    uchar stream[ sizeof(test_zstd_comp_0)+sizeof(test_zstd_comp_1) ];
+    fd_memcpy( stream,                           test_zstd_comp_0, sizeof(test_zstd_comp_0) );
+    fd_memcpy( stream+sizeof(test_zstd_comp_0), test_zstd_comp_1, sizeof(test_zstd_comp_1) );
+    for( ulong j=0UL; j<sizeof(test_zstd_comp_0); j++ )
+      FD_TEST( fd_zstd_frame_sz( stream, j )==0UL );
+    for( ulong j=sizeof(test_zstd_comp_0); j<=sizeof(stream); j++ )
+      FD_TEST( fd_zstd_frame_sz( stream, j )==sizeof(test_zstd_comp_0) );
+    FD_TEST( fd_zstd_frame_sz( stream+sizeof(test_zstd_comp_0), sizeof(test_zstd_comp_1) )==sizeof(test_zstd_comp_1) );
+    stream[0] = 0x00;  /* bad magic */
+    FD_TEST( fd_zstd_frame_sz( stream, sizeof(stream) )==ULONG_MAX );
+  } while(0);
+
   test_decompress();
+  test_compress();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -112,9 +112,10 @@ fd_forks_rollback( fd_forks_t * forks, ulong slot ) {
   fork->slot = slot;
 
   fd_funk_txn_t *   txn_map    = fd_funk_txn_map( forks->funk, fd_funk_wksp( forks->funk ) );
-  fd_hash_t const * block_hash = fd_blockstore_block_hash_query( forks->blockstore, slot );
+  fd_hash_t         block_hash[1];
+  int               hash_err   = fd_blockstore_block_hash_query_volatile( forks->blockstore, slot, block_hash );
   FD_LOG_NOTICE( ( "trying to restore %lu", slot_ctx->slot_bank.slot ) );
-  if( !block_hash ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
+  if( hash_err ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
   fd_funk_txn_xid_t xid;
   fd_memcpy( xid.uc, block_hash, sizeof( fd_funk_txn_xid_t ) );
   xid.ul[0]             = slot;
@@ -96,8 +96,7 @@ fd_tower_fork_update( fd_tower_t * tower, fd_fork_t * fork ) {
 
   /* Get the parent key. Every slot except the root must have a parent. */
 
-  fd_blockstore_start_read( blockstore );
-  ulong parent_slot = fd_blockstore_parent_slot_query( blockstore, fork->slot );
+  ulong parent_slot = fd_blockstore_parent_slot_query_volatile( blockstore, fork->slot );
 #if FD_TOWER_USE_HANDHOLDING
   /* we must have a parent slot and bank hash, given we just executed
      its child. if not, likely a bug in blockstore pruning. */
@@ -105,7 +104,6 @@ fd_tower_fork_update( fd_tower_t * tower, fd_fork_t * fork ) {
     FD_LOG_ERR( ( "missing parent slot for curr slot %lu", fork->slot ) );
   };
 #endif
-  fd_blockstore_end_read( blockstore );
 
   /* Insert the new fork head into ghost. */
 
@@ -1,6 +1,7 @@
 #include "../../ballet/shred/fd_shred.h"
 #include "../../ballet/shred/fd_fec_set.h"
 #include "../../ballet/bmtree/fd_bmtree.h"
+#include "../../ballet/sha256/fd_sha256.h"
 #include "../../ballet/sha512/fd_sha512.h"
 #include "../../ballet/ed25519/fd_ed25519.h"
 #include "../../ballet/reedsol/fd_reedsol.h"
@@ -118,10 +119,13 @@ struct __attribute__((aligned(FD_FEC_RESOLVER_ALIGN))) fd_fec_resolver {
   fd_fec_set_t * * complete_list;
   void         * * bmtree_free_list;
 
-  /* sha512 and reedsol are used for calculations while adding a shred.
-     Their state outside a call to add_shred is indeterminate. */
+  /* sha512, sha256 and reedsol are used for calculations while adding
+     a shred.  Their state outside a call to add_shred is indeterminate.
+     sha256 is only used to batch the Merkle leaf computations of the
+     shreds recovered when a FEC set completes. */
   fd_sha512_t   sha512[1];
   fd_reedsol_t  reedsol[1];
+  uchar         sha256[ FD_SHA256_BATCH_FOOTPRINT ] __attribute__((aligned(FD_SHA256_BATCH_ALIGN)));
 
   /* The footprint for the objects follows the struct and is in the same
      order as the pointers, namely:
@@ -495,25 +499,23 @@ int fd_fec_resolver_add_shred( fd_fec_resolver_t    * resolver,
     FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
     return FD_FEC_RESOLVER_SHRED_REJECTED;
   }
-  /* Iterate over recovered shreds, add them to the Merkle tree,
-     populate headers and signatures. */
+  /* Iterate over recovered shreds, populate headers, and compute their
+     Merkle leaves.  As in the shredder, we write the leaf prefix into
+     the tail of the not yet populated signature so that the leaves can
+     be hashed in place and in parallel with the batch SHA-256 API.
+     Hashing ~1 kB per recovered shred is the bulk of the work here. */
+  fd_bmtree_node_t leaves[ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
+  fd_sha256_batch_t * sha256 = fd_sha256_batch_init( resolver->sha256 );
   for( ulong i=0UL; i<set->data_shred_cnt; i++ ) {
     if( !d_rcvd_test( set->data_shred_rcvd, i ) ) {
-      fd_bmtree_hash_leaf( leaf, set->data_shreds[i]+sizeof(fd_ed25519_sig_t), reedsol_protected_sz, FD_BMTREE_LONG_PREFIX_SZ );
-      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, i, leaf, NULL, 0, NULL ) ) ) {
-        freelist_push_tail( free_list,        set  );
-        bmtrlist_push_tail( bmtree_free_list, tree );
-        FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
-        return FD_FEC_RESOLVER_SHRED_REJECTED;
-      }
-
-      fd_memcpy( set->data_shreds[i], shred, sizeof(fd_ed25519_sig_t) );
+      uchar * leaf_data = set->data_shreds[i] + sizeof(fd_ed25519_sig_t) - FD_BMTREE_LONG_PREFIX_SZ;
+      fd_memcpy( leaf_data, fd_bmtree_leaf_prefix, FD_BMTREE_LONG_PREFIX_SZ );
+      fd_sha256_batch_add( sha256, leaf_data, FD_BMTREE_LONG_PREFIX_SZ+reedsol_protected_sz, leaves[i].hash );
     }
   }
   for( ulong i=0UL; i<set->parity_shred_cnt; i++ ) {
     if( !p_rcvd_test( set->parity_shred_rcvd, i ) ) {
       fd_shred_t * p_shred = (fd_shred_t *)set->parity_shreds[i]; /* We can't parse because we haven't populated the header */
-      fd_memcpy( p_shred->signature, shred->signature, sizeof(fd_ed25519_sig_t) );
       p_shred->variant       = fd_shred_variant( FD_SHRED_TYPE_MERKLE_CODE, (uchar)tree_depth );
       p_shred->slot          = shred->slot;
       p_shred->idx           = (uint)(i + parity_idx0);
@@ -523,13 +525,38 @@ int fd_fec_resolver_add_shred( fd_fec_resolver_t    * resolver,
       p_shred->code.code_cnt = (ushort)set->parity_shred_cnt;
       p_shred->code.idx      = (ushort)i;
 
-      fd_bmtree_hash_leaf( leaf, set->parity_shreds[i]+ sizeof(fd_ed25519_sig_t), reedsol_protected_sz+0x19UL, FD_BMTREE_LONG_PREFIX_SZ );
-      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, set->data_shred_cnt + i, leaf, NULL, 0, NULL ) ) ) {
+      uchar * leaf_data = set->parity_shreds[i] + sizeof(fd_ed25519_sig_t) - FD_BMTREE_LONG_PREFIX_SZ;
+      fd_memcpy( leaf_data, fd_bmtree_leaf_prefix, FD_BMTREE_LONG_PREFIX_SZ );
+      fd_sha256_batch_add( sha256, leaf_data, FD_BMTREE_LONG_PREFIX_SZ+reedsol_protected_sz+0x19UL, leaves[set->data_shred_cnt+i].hash );
+    }
+  }
+  fd_sha256_batch_fini( sha256 );
+
+  /* Add the recovered leaves to the Merkle tree and populate the
+     signatures we clobbered above. */
+  for( ulong i=0UL; i<set->data_shred_cnt; i++ ) {
+    if( !d_rcvd_test( set->data_shred_rcvd, i ) ) {
+      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, i, leaves+i, NULL, 0, NULL ) ) ) {
+        freelist_push_tail( free_list,        set  );
+        bmtrlist_push_tail( bmtree_free_list, tree );
+        FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
+        return FD_FEC_RESOLVER_SHRED_REJECTED;
+      }
+
+      fd_memcpy( set->data_shreds[i], shred, sizeof(fd_ed25519_sig_t) );
+    }
+  }
+  for( ulong i=0UL; i<set->parity_shred_cnt; i++ ) {
+    if( !p_rcvd_test( set->parity_shred_rcvd, i ) ) {
+      ulong leaf_idx = set->data_shred_cnt + i;
+      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, leaf_idx, leaves+leaf_idx, NULL, 0, NULL ) ) ) {
         freelist_push_tail( free_list,        set  );
         bmtrlist_push_tail( bmtree_free_list, tree );
         FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
         return FD_FEC_RESOLVER_SHRED_REJECTED;
       }
+
+      fd_memcpy( set->parity_shreds[i], shred->signature, sizeof(fd_ed25519_sig_t) );
     }
   }
 
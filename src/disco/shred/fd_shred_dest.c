@@ -120,6 +120,10 @@ fd_shred_dest_new( void                           * mem,
   sdest->unstaked_cnt               = unstaked_cnt;
   sdest->pubkey_to_idx_map          = pubkey_to_idx_map;
   sdest->source_validator_orig_idx  = query->idx;
+  sdest->cache_fanout               = 0UL;
+  sdest->cache_dest_cnt             = 0UL;
+  sdest->cache_ring_next            = 0UL;
+  for( ulong i=0UL; i<FD_SHRED_DEST_CACHE_CNT; i++ ) sdest->cache[ i ].slot = ULONG_MAX;
 
   return (void *)sdest;
 }
@@ -212,6 +216,36 @@ sample_unstaked( fd_shred_dest_t * sdest ) {
 }
 
 
+static inline void
+fill_input( shred_dest_input_t  * h_in,
+            ulong                 slot,
+            int                   is_data,
+            uint                  idx,
+            fd_pubkey_t const   * leader ) {
+  h_in->slot = slot;
+  h_in->type = fd_uchar_if( is_data, 0xA5, 0x5A );
+  h_in->idx  = idx;
+  memcpy( h_in->leader_pubkey, leader, 32UL );
+}
+
+static inline int
+shred_is_data( fd_shred_t const * shred ) {
+  uchar shred_type = fd_shred_type( shred->variant );
+  return (shred_type==FD_SHRED_TYPE_LEGACY_DATA) | (shred_type==FD_SHRED_TYPE_MERKLE_DATA);
+}
+
+static inline void
+hash_seeds( fd_shred_dest_t          * sdest,
+            shred_dest_input_t const * dest_hash_inputs,
+            ulong                      cnt,
+            uchar                      dest_hash_output[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ] ) {
+  fd_sha256_batch_t * sha256 = fd_sha256_batch_init( sdest->_sha256_batch );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_sha256_batch_add( sha256, dest_hash_inputs+i, sizeof(shred_dest_input_t), dest_hash_output[ i ] );
+  }
+  fd_sha256_batch_fini( sha256 );
+}
+
 /* Returns 0 on success */
 static inline int
 compute_seeds( fd_shred_dest_t           * sdest,
@@ -222,49 +256,24 @@ compute_seeds( fd_shred_dest_t           * sdest,
                uchar                       dest_hash_output[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ] ) {
 
   shred_dest_input_t dest_hash_inputs [ FD_SHRED_DEST_MAX_SHRED_CNT ];
-  fd_sha256_batch_t * sha256 = fd_sha256_batch_init( sdest->_sha256_batch );
 
   for( ulong i=0UL; i<shred_cnt; i++ ) {
-    shred_dest_input_t * h_in  = dest_hash_inputs+i;
     fd_shred_t const   * shred = input_shreds[i];
     if( FD_UNLIKELY( shred->slot != slot ) ) return -1;
-
-    uchar shred_type = fd_shred_type( shred->variant );
-    h_in->slot = slot;
-    h_in->type = fd_uchar_if( (shred_type==FD_SHRED_TYPE_LEGACY_DATA) | (shred_type==FD_SHRED_TYPE_MERKLE_DATA), 0xA5, 0x5A );
-    h_in->idx  = shred->idx;
-    memcpy( h_in->leader_pubkey, leader, 32UL );
-
-    fd_sha256_batch_add( sha256, dest_hash_inputs+i,   sizeof(shred_dest_input_t), dest_hash_output[ i ] );
+    fill_input( dest_hash_inputs+i, slot, shred_is_data( shred ), shred->idx, leader );
   }
-  fd_sha256_batch_fini( sha256 );
+  hash_seeds( sdest, dest_hash_inputs, shred_cnt, dest_hash_output );
   return 0;
 }
 
 
-fd_shred_dest_idx_t *
-fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
-                             fd_shred_t const * const * input_shreds,
-                             ulong                      shred_cnt,
-                             fd_shred_dest_idx_t      * out ) {
-
-  if( FD_UNLIKELY( shred_cnt==0UL ) ) return out;
-
-  if( FD_UNLIKELY( sdest->cnt<=1UL ) ) {
-    /* We are the only validator that we know about, and we can't send
-       it to ourself, so there's nobody we can send the shred to. */
-    for( ulong i=0UL; i<shred_cnt; i++ ) out[ i ] = FD_SHRED_DEST_NO_DEST;
-    return out;
-  }
-
-  uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
-
-  ulong slot = input_shreds[0]->slot;
-  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
-  if( FD_UNLIKELY( !leader ) ) return NULL;
-
-  if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
-
+/* compute_first_seeded computes the root of the Turbine tree for each
+   of the shred_cnt seeds and stores it in out[i]. */
+static void
+compute_first_seeded( fd_shred_dest_t     * sdest,
+                      uchar                 dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ],
+                      ulong                 shred_cnt,
+                      fd_shred_dest_idx_t * out ) {
   /* If we're calling this, we must be the leader.  That means we had
      some stake when the leader schedule was created, but maybe not
      anymore?  This version of the code is safe either way, but I should
@@ -280,58 +289,29 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
     else                                     out[i] = (ushort)sample_unstaked_noprepare( sdest, sdest->source_validator_orig_idx );
   }
   fd_wsample_restore_all( sdest->staked );
-
-  return out;
 }
 
-fd_shred_dest_idx_t *
-fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
-                                fd_shred_t const * const * input_shreds,
-                                ulong                      shred_cnt,
-                                fd_shred_dest_idx_t      * out,
-                                ulong                      out_stride,
-                                ulong                      fanout,
-                                ulong                      dest_cnt,
-                                ulong                    * opt_max_dest_cnt ) {
-
-  /* The logic here is a little tricky since we are keeping track of
-     staked and unstaked separately and only logically concatenating
-     them [staked, unstaked] , but that does allow us to skip some
-     samples sometimes.  We're operating from the source validator's
-     perspective here, so everything in the first person singular refers
-     to the source validator. */
+/* compute_children_seeded does the bulk of the work for
+   fd_shred_dest_compute_children once the seeds are known.  Seed i
+   corresponds to column i of out.  leader_idx is the index of the
+   leader or ULONG_MAX if the leader is not a known destination.  The
+   checks for quick exits must have been done by the caller.  Returns 0
+   on success and -1 on failure. */
+static int
+compute_children_seeded( fd_shred_dest_t     * sdest,
+                         uchar                 dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ],
+                         ulong                 shred_cnt,
+                         ulong                 leader_idx,
+                         int                   leader_is_staked,
+                         fd_shred_dest_idx_t * out,
+                         ulong                 out_stride,
+                         ulong                 fanout,
+                         ulong                 dest_cnt,
+                         ulong               * max_dest_cnt_out ) {
 
   ulong my_orig_idx = sdest->source_validator_orig_idx;
   int   i_am_staked = my_orig_idx<sdest->staked_cnt;
 
-  fd_ulong_store_if( !!opt_max_dest_cnt, opt_max_dest_cnt, 0UL );
-
-  if( FD_UNLIKELY( (shred_cnt==0UL) | (dest_cnt==0UL) ) ) return out; /* Nothing to do */
-
-  ulong               slot   = input_shreds[0]->slot;
-  fd_pubkey_t const * leader = fd_epoch_leaders_get   ( sdest->lsched, slot );
-  pubkey_to_idx_t *   query  = pubkey_to_idx_query( sdest->pubkey_to_idx_map, *leader, NULL );
-  int                 leader_is_staked = query ? (query->idx<sdest->staked_cnt): 0;
-  ulong               leader_idx       = query ?  query->idx                   : ULONG_MAX;
-  if( FD_UNLIKELY( !leader                 ) ) return NULL; /* Unknown slot */
-  if( FD_UNLIKELY( leader_idx==my_orig_idx ) ) return NULL; /* I am the leader. Use compute_first */
-
-  if( FD_UNLIKELY( (sdest->cnt<=1UL) |                    /* We don't know about a single destination, so we can't send
-                                                             anything. */
-        ( (!i_am_staked) & (sdest->staked_cnt-(ulong)leader_is_staked>fanout) ) ) ) {
-    /* My position is somewhere after all the staked nodes, which means
-       my shuffled index is always greater than fanout.  That means I'm
-       always at the bottom of the Turbine tree so I don't have to send
-       any shreds to anyone. */
-    for( ulong j=0UL; j<dest_cnt; j++ ) for( ulong i=0UL; i<shred_cnt; i++ ) out[ j*out_stride + i ] = FD_SHRED_DEST_NO_DEST;
-    return out;
-  }
-
-  uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
-
-
-  if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
-
   ulong max_dest_cnt = 0UL;
 
   ulong staked_shuffle[ sdest->staked_cnt+1UL ];
@@ -339,7 +319,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
 
   for( ulong i=0UL; i<shred_cnt; i++ ) {
     /* Remove the leader. */
-    if( FD_LIKELY( query && leader_is_staked ) ) fd_wsample_remove_idx( sdest->staked, leader_idx );
+    if( FD_LIKELY( leader_is_staked ) ) fd_wsample_remove_idx( sdest->staked, leader_idx );
 
     ulong my_idx         = 0UL;
     fd_wsample_seed_rng( fd_wsample_get_rng( sdest->staked ), dest_hash_outputs[ i ] ); /* Seeds both samplers since the rng is shared */
@@ -353,13 +333,13 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
          start of the function. */
       staked_shuffle_populated_cnt = sdest->staked_cnt + 1UL;
       fd_wsample_sample_and_remove_many( sdest->staked, staked_shuffle, staked_shuffle_populated_cnt );
-      my_idx += sdest->staked_cnt - (ulong)(query && leader_is_staked);
+      my_idx += sdest->staked_cnt - (ulong)leader_is_staked;
 
       prepare_unstaked_sampling( sdest, leader_idx );
       while( my_idx <= fanout ) {
         ulong sample = sample_unstaked( sdest );
         if( FD_UNLIKELY( sample==my_orig_idx      ) ) break; /* Found me! */
-        if( FD_UNLIKELY( sample==FD_WSAMPLE_EMPTY ) ) return NULL; /* I couldn't find myself.  This should be impossible. */
+        if( FD_UNLIKELY( sample==FD_WSAMPLE_EMPTY ) ) return -1; /* I couldn't find myself.  This should be impossible. */
         my_idx++;
       }
     } else {
@@ -372,7 +352,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
            safe. */
         ulong sample = staked_shuffle[ my_idx ];
         if( FD_UNLIKELY( sample==my_orig_idx      ) ) break; /* Found me! */
-        if( FD_UNLIKELY( sample==FD_WSAMPLE_EMPTY ) ) return NULL; /* I couldn't find myself.  This should be impossible. */
+        if( FD_UNLIKELY( sample==FD_WSAMPLE_EMPTY ) ) return -1; /* I couldn't find myself.  This should be impossible. */
         my_idx++;
       }
     }
@@ -439,10 +419,300 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
     fd_wsample_restore_all( sdest->staked );
 
   }
+  *max_dest_cnt_out = max_dest_cnt;
+  return 0;
+}
+
+static inline fd_shred_dest_cache_t *
+cache_entry( fd_shred_dest_t * sdest,
+             ulong             slot,
+             ulong             key ) {
+  /* Consecutive shreds of the same slot land in consecutive entries.
+     Roots and children are never both needed for the same slot, so the
+     roots are just offset by a quarter of the cache. */
+  ulong h = (key>>1) + (key&1UL)*(FD_SHRED_DEST_CACHE_CNT/4UL) + slot*(FD_SHRED_DEST_CACHE_CNT/2UL+1UL);
+  return sdest->cache + (h & (FD_SHRED_DEST_CACHE_CNT-1UL));
+}
+
+static inline ulong
+cache_key( uint idx,
+           int  is_data,
+           int  is_first ) {
+  return ((ulong)idx<<2) | ((ulong)!is_data<<1) | (ulong)!!is_first;
+}
+
+/* cache_hit returns 1 if entry holds the destinations of key in slot,
+   i.e. it was filled for it and its destinations have not been
+   overwritten in the ring since. */
+static inline int
+cache_hit( fd_shred_dest_t       const * sdest,
+           fd_shred_dest_cache_t const * entry,
+           ulong                         slot,
+           ulong                         key ) {
+  return (entry->slot==slot) & (entry->key==key) &
+         ((entry->dest_cnt==0UL) | (sdest->cache_ring_next-entry->dest_off<=FD_SHRED_DEST_CACHE_RING_CNT));
+}
+
+/* cache_fill computes the destinations of the shreds of slot with the
+   given keys and stores them in the cache.  The keys must all be roots
+   or all be children.  Same return values as compute_children_seeded.
+   cnt must be in [1, FD_SHRED_DEST_MAX_SHRED_CNT] and the keys must map
+   to distinct cache entries.  Since the ring holds the destinations of
+   at least FD_SHRED_DEST_MAX_SHRED_CNT shreds, a fill never evicts
+   itself. */
+static int
+cache_fill( fd_shred_dest_t   * sdest,
+            fd_pubkey_t const * leader,
+            ulong               slot,
+            ulong               leader_idx,
+            int                 leader_is_staked,
+            ulong const       * keys,
+            ulong               cnt ) {
+  int   is_first = (int)(keys[0]&1UL);
+  ulong dest_cnt = fd_ulong_if( is_first, 1UL, sdest->cache_dest_cnt );
+
+  shred_dest_input_t  dest_hash_inputs [ FD_SHRED_DEST_MAX_SHRED_CNT ];
+  uchar               dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
+  fd_shred_dest_idx_t fill_out         [ FD_SHRED_DEST_MAX_SHRED_CNT*FD_SHRED_DEST_CACHE_DEST_MAX ];
+
+  for( ulong w=0UL; w<cnt; w++ ) fill_input( dest_hash_inputs+w, slot, !(keys[w]&2UL), (uint)(keys[w]>>2), leader );
+  hash_seeds( sdest, dest_hash_inputs, cnt, dest_hash_outputs );
+
+  if( is_first ) {
+    compute_first_seeded( sdest, dest_hash_outputs, cnt, fill_out );
+  } else {
+    ulong fill_max;
+    if( FD_UNLIKELY( compute_children_seeded( sdest, dest_hash_outputs, cnt, leader_idx, leader_is_staked,
+                                              fill_out, cnt, sdest->cache_fanout, dest_cnt, &fill_max ) ) ) return -1;
+  }
+
+  for( ulong w=0UL; w<cnt; w++ ) {
+    fd_shred_dest_cache_t * entry     = cache_entry( sdest, slot, keys[w] );
+    ulong                   dest_off  = sdest->cache_ring_next;
+    ulong                   entry_cnt = 0UL;
+    while( (entry_cnt<dest_cnt) && (fill_out[ entry_cnt*cnt + w ]!=FD_SHRED_DEST_NO_DEST) ) {
+      sdest->cache_ring[ (dest_off+entry_cnt) & (FD_SHRED_DEST_CACHE_RING_CNT-1UL) ] = fill_out[ entry_cnt*cnt + w ];
+      entry_cnt++;
+    }
+    entry->slot            = slot;
+    entry->key             = keys[w];
+    entry->dest_off        = dest_off;
+    entry->dest_cnt        = entry_cnt;
+    sdest->cache_ring_next = dest_off + entry_cnt;
+  }
+  return 0;
+}
+
+static inline void
+cache_reset( fd_shred_dest_t * sdest,
+             ulong             fanout,
+             ulong             dest_cnt ) {
+  if( FD_UNLIKELY( (sdest->cache_fanout!=fanout) | (sdest->cache_dest_cnt!=dest_cnt) ) ) {
+    for( ulong i=0UL; i<FD_SHRED_DEST_CACHE_CNT; i++ ) sdest->cache[ i ].slot = ULONG_MAX;
+    sdest->cache_fanout   = fanout;
+    sdest->cache_dest_cnt = dest_cnt;
+  }
+}
+
+/* compute_cached implements fd_shred_dest_compute_first (is_first=1,
+   dest_cnt=1) and fd_shred_dest_compute_children (is_first=0, after
+   cache_reset) using the cache.  Shreds that miss are computed together
+   (so their seed hashes are batched) and inserted into the cache.  Same
+   return values as compute_children_seeded. */
+static int
+compute_cached( fd_shred_dest_t          * sdest,
+                fd_shred_t const * const * input_shreds,
+                ulong                      shred_cnt,
+                fd_pubkey_t const        * leader,
+                ulong                      slot,
+                ulong                      leader_idx,
+                int                        leader_is_staked,
+                int                        is_first,
+                fd_shred_dest_idx_t      * out,
+                ulong                      out_stride,
+                ulong                      dest_cnt,
+                ulong                    * max_dest_cnt_out ) {
+
+  ulong keys    [ FD_SHRED_DEST_MAX_SHRED_CNT ];
+  ulong miss    [ FD_SHRED_DEST_MAX_SHRED_CNT ];
+  ulong miss_cnt = 0UL;
+
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    fd_shred_t const * shred = input_shreds[i];
+    if( FD_UNLIKELY( shred->slot!=slot ) ) return -1;
+    keys[i] = cache_key( shred->idx, shred_is_data( shred ), is_first );
+
+    fd_shred_dest_cache_t * entry = cache_entry( sdest, slot, keys[i] );
+    if( FD_UNLIKELY( !cache_hit( sdest, entry, slot, keys[i] ) ) ) {
+      /* Two misses that collide in the cache have to be filled
+         separately.  Flush what we have so far. */
+      for( ulong m=0UL; m<miss_cnt; m++ ) {
+        if( FD_UNLIKELY( cache_entry( sdest, slot, miss[m] )==entry ) ) {
+          if( FD_UNLIKELY( cache_fill( sdest, leader, slot, leader_idx, leader_is_staked, miss, miss_cnt ) ) ) return -1;
+          miss_cnt = 0UL;
+          break;
+        }
+      }
+      miss[ miss_cnt++ ] = keys[i];
+    }
+  }
+  if( FD_LIKELY( miss_cnt ) ) {
+    if( FD_UNLIKELY( cache_fill( sdest, leader, slot, leader_idx, leader_is_staked, miss, miss_cnt ) ) ) return -1;
+  }
+
+  ulong max_dest_cnt = 0UL;
+  for( ulong i=0UL; i<shred_cnt; i++ ) {
+    fd_shred_dest_cache_t const * entry = cache_entry( sdest, slot, keys[i] );
+    if( FD_UNLIKELY( !cache_hit( sdest, entry, slot, keys[i] ) ) ) {
+      /* Evicted by a later fill in this call */
+      if( FD_UNLIKELY( cache_fill( sdest, leader, slot, leader_idx, leader_is_staked, keys+i, 1UL ) ) ) return -1;
+    }
+    ulong entry_cnt = entry->dest_cnt;
+    for( ulong j=0UL;       j<entry_cnt; j++ ) out[ j*out_stride + i ] = sdest->cache_ring[ (entry->dest_off+j) & (FD_SHRED_DEST_CACHE_RING_CNT-1UL) ];
+    for( ulong j=entry_cnt; j<dest_cnt;  j++ ) out[ j*out_stride + i ] = FD_SHRED_DEST_NO_DEST;
+    max_dest_cnt = fd_ulong_max( max_dest_cnt, entry_cnt );
+  }
+
+  *max_dest_cnt_out = max_dest_cnt;
+  return 0;
+}
+
+fd_shred_dest_idx_t *
+fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
+                             fd_shred_t const * const * input_shreds,
+                             ulong                      shred_cnt,
+                             fd_shred_dest_idx_t      * out ) {
+
+  if( FD_UNLIKELY( shred_cnt==0UL ) ) return out;
+
+  if( FD_UNLIKELY( sdest->cnt<=1UL ) ) {
+    /* We are the only validator that we know about, and we can't send
+       it to ourself, so there's nobody we can send the shred to. */
+    for( ulong i=0UL; i<shred_cnt; i++ ) out[ i ] = FD_SHRED_DEST_NO_DEST;
+    return out;
+  }
+
+  ulong slot = input_shreds[0]->slot;
+  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
+  if( FD_UNLIKELY( !leader ) ) return NULL;
+
+  ulong max_dest_cnt;
+  if( FD_UNLIKELY( compute_cached( sdest, input_shreds, shred_cnt, leader, slot, ULONG_MAX, 0, 1,
+                                   out, 1UL, 1UL, &max_dest_cnt ) ) ) return NULL;
+  return out;
+}
+
+fd_shred_dest_idx_t *
+fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
+                                fd_shred_t const * const * input_shreds,
+                                ulong                      shred_cnt,
+                                fd_shred_dest_idx_t      * out,
+                                ulong                      out_stride,
+                                ulong                      fanout,
+                                ulong                      dest_cnt,
+                                ulong                    * opt_max_dest_cnt ) {
+
+  /* The logic here is a little tricky since we are keeping track of
+     staked and unstaked separately and only logically concatenating
+     them [staked, unstaked] , but that does allow us to skip some
+     samples sometimes.  We're operating from the source validator's
+     perspective here, so everything in the first person singular refers
+     to the source validator. */
+
+  ulong my_orig_idx = sdest->source_validator_orig_idx;
+  int   i_am_staked = my_orig_idx<sdest->staked_cnt;
+
+  fd_ulong_store_if( !!opt_max_dest_cnt, opt_max_dest_cnt, 0UL );
+
+  if( FD_UNLIKELY( (shred_cnt==0UL) | (dest_cnt==0UL) ) ) return out; /* Nothing to do */
+
+  ulong               slot   = input_shreds[0]->slot;
+  fd_pubkey_t const * leader = fd_epoch_leaders_get   ( sdest->lsched, slot );
+  pubkey_to_idx_t *   query  = pubkey_to_idx_query( sdest->pubkey_to_idx_map, *leader, NULL );
+  int                 leader_is_staked = query ? (query->idx<sdest->staked_cnt): 0;
+  ulong               leader_idx       = query ?  query->idx                   : ULONG_MAX;
+  if( FD_UNLIKELY( !leader                 ) ) return NULL; /* Unknown slot */
+  if( FD_UNLIKELY( leader_idx==my_orig_idx ) ) return NULL; /* I am the leader. Use compute_first */
+
+  if( FD_UNLIKELY( (sdest->cnt<=1UL) |                    /* We don't know about a single destination, so we can't send
+                                                             anything. */
+        ( (!i_am_staked) & (sdest->staked_cnt-(ulong)leader_is_staked>fanout) ) ) ) {
+    /* My position is somewhere after all the staked nodes, which means
+       my shuffled index is always greater than fanout.  That means I'm
+       always at the bottom of the Turbine tree so I don't have to send
+       any shreds to anyone. */
+    for( ulong j=0UL; j<dest_cnt; j++ ) for( ulong i=0UL; i<shred_cnt; i++ ) out[ j*out_stride + i ] = FD_SHRED_DEST_NO_DEST;
+    return out;
+  }
+
+  ulong max_dest_cnt = 0UL;
+
+  if( FD_LIKELY( dest_cnt<=FD_SHRED_DEST_CACHE_DEST_MAX ) ) {
+    cache_reset( sdest, fanout, dest_cnt );
+    if( FD_UNLIKELY( compute_cached( sdest, input_shreds, shred_cnt, leader, slot, leader_idx, leader_is_staked, 0,
+                                     out, out_stride, dest_cnt, &max_dest_cnt ) ) ) return NULL;
+  } else {
+    uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
+
+    if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
+    if( FD_UNLIKELY( compute_children_seeded( sdest, dest_hash_outputs, shred_cnt, leader_idx, leader_is_staked,
+                                              out, out_stride, fanout, dest_cnt, &max_dest_cnt ) ) ) return NULL;
+  }
+
   fd_ulong_store_if( !!opt_max_dest_cnt, opt_max_dest_cnt, max_dest_cnt );
   return out;
 }
 
+fd_shred_dest_t *
+fd_shred_dest_prefill( fd_shred_dest_t * sdest,
+                       ulong             slot,
+                       int               is_data,
+                       uint              idx0,
+                       ulong             idx_cnt,
+                       ulong             fanout,
+                       ulong             dest_cnt ) {
+
+  ulong my_orig_idx = sdest->source_validator_orig_idx;
+  int   i_am_staked = my_orig_idx<sdest->staked_cnt;
+
+  if( FD_UNLIKELY( !idx_cnt ) ) return sdest;
+
+  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
+  if( FD_UNLIKELY( !leader ) ) return NULL; /* Unknown slot */
+  pubkey_to_idx_t *   query  = pubkey_to_idx_query( sdest->pubkey_to_idx_map, *leader, NULL );
+  int                 leader_is_staked = query ? (query->idx<sdest->staked_cnt): 0;
+  ulong               leader_idx       = query ?  query->idx                   : ULONG_MAX;
+  int                 is_first         = leader_idx==my_orig_idx;
+
+  /* Same quick exits as compute_first and compute_children: nothing to
+     cache */
+  if( is_first ) {
+    if( FD_UNLIKELY( sdest->cnt<=1UL ) ) return sdest;
+  } else {
+    if( FD_UNLIKELY( (dest_cnt==0UL) | (dest_cnt>FD_SHRED_DEST_CACHE_DEST_MAX) ) ) return sdest;
+    if( FD_UNLIKELY( (sdest->cnt<=1UL) |
+          ( (!i_am_staked) & (sdest->staked_cnt-(ulong)leader_is_staked>fanout) ) ) ) return sdest;
+    cache_reset( sdest, fanout, dest_cnt );
+  }
+
+  idx_cnt = fd_ulong_min( fd_ulong_min( idx_cnt, FD_SHRED_DEST_MAX_SHRED_CNT ), (ulong)UINT_MAX+1UL-(ulong)idx0 );
+
+  /* The window is at most FD_SHRED_DEST_MAX_SHRED_CNT consecutive keys
+     of the same type, which map to distinct cache entries. */
+  ulong keys[ FD_SHRED_DEST_MAX_SHRED_CNT ];
+  ulong key_cnt = 0UL;
+  for( ulong w=0UL; w<idx_cnt; w++ ) {
+    ulong                         key   = cache_key( idx0+(uint)w, is_data, is_first );
+    fd_shred_dest_cache_t const * entry = cache_entry( sdest, slot, key );
+    if( FD_LIKELY( cache_hit( sdest, entry, slot, key ) ) ) continue;
+    keys[ key_cnt++ ] = key;
+  }
+  if( FD_UNLIKELY( !key_cnt ) ) return sdest;
+
+  if( FD_UNLIKELY( cache_fill( sdest, leader, slot, leader_idx, leader_is_staked, keys, key_cnt ) ) ) return NULL;
+  return sdest;
+}
+
 fd_shred_dest_idx_t
 fd_shred_dest_pubkey_to_idx( fd_shred_dest_t   * sdest,
                              fd_pubkey_t const * pubkey     ) {
@@ -46,6 +46,33 @@ typedef struct pubkey_to_idx pubkey_to_idx_t;
 #define FD_SHRED_DEST_ALIGN (128UL)
 FD_STATIC_ASSERT( FD_SHRED_DEST_ALIGN>=FD_SHA256_BATCH_ALIGN, fd_shred_dest_private_align );
 
+/* The destinations of the source validator for a shred (its children
+   in the Turbine tree, or the root if it is the leader) depend only on
+   (slot, shred type, shred idx) and the leader of the slot, so
+   fd_shred_dest_compute_{first,children} cache them.
+   fd_shred_dest_prefill fills the cache for a range of shreds at once
+   (amortizing the leader lookup and batching the seed hashes), so it
+   can be done ahead of time when the caller is idle.  The cache is
+   direct mapped with FD_SHRED_DEST_CACHE_CNT entries (a power of 2).
+   The destinations themselves are stored in a ring of
+   FD_SHRED_DEST_CACHE_RING_CNT indices (a power of 2) shared by all
+   entries, since most shreds have either no children (the source
+   validator is a leaf) or a full fanout of them.  An entry is evicted
+   when its destinations are overwritten in the ring.  Children are
+   only cached for dest_cnt<=FD_SHRED_DEST_CACHE_DEST_MAX. */
+#define FD_SHRED_DEST_CACHE_CNT      (512UL)
+#define FD_SHRED_DEST_CACHE_RING_CNT (32768UL)
+#define FD_SHRED_DEST_CACHE_DEST_MAX (200UL)
+FD_STATIC_ASSERT( FD_SHRED_DEST_CACHE_RING_CNT>=FD_SHRED_DEST_MAX_SHRED_CNT*FD_SHRED_DEST_CACHE_DEST_MAX, fd_shred_dest_cache_ring );
+
+struct fd_shred_dest_cache {
+  ulong slot;     /* ULONG_MAX if the entry is empty */
+  ulong key;      /* idx<<2 | is_code<<1 | is_first */
+  ulong dest_off; /* The destinations are at ring[ dest_off, dest_off+dest_cnt ) (mod FD_SHRED_DEST_CACHE_RING_CNT) */
+  ulong dest_cnt; /* Number of real destinations */
+};
+typedef struct fd_shred_dest_cache fd_shred_dest_cache_t;
+
 struct __attribute__((aligned(FD_SHRED_DEST_ALIGN))) fd_shred_dest_private {
   uchar      _sha256_batch[ FD_SHA256_BATCH_FOOTPRINT ]  __attribute__((aligned(FD_SHA256_BATCH_ALIGN)));
   fd_chacha20rng_t rng[1];
@@ -72,6 +99,16 @@ struct __attribute__((aligned(FD_SHRED_DEST_ALIGN))) fd_shred_dest_private {
   pubkey_to_idx_t * pubkey_to_idx_map; /* maps pubkey -> [0, staked_cnt+unstaked_cnt) */
 
   ulong source_validator_orig_idx; /* in [0, staked_cnt+unstaked_cnt) */
+
+  /* The cached children were computed with this fanout and dest_cnt.
+     A call with different values flushes the cache.  cache_ring_next
+     is the total number of destinations ever stored in cache_ring. */
+  ulong                 cache_fanout;
+  ulong                 cache_dest_cnt;
+  ulong                 cache_ring_next;
+  fd_shred_dest_cache_t cache     [ FD_SHRED_DEST_CACHE_CNT      ];
+  fd_shred_dest_idx_t   cache_ring[ FD_SHRED_DEST_CACHE_RING_CNT ];
+
   /* Struct followed by:
      * pubkey_to_idx map
      * all_destinations
@@ -150,7 +187,8 @@ static inline ulong fd_shred_dest_cnt_all     ( fd_shred_dest_t * sdest ) { retu
    function is a no-op.  Returns out on success and NULL on failure.
    This function uses the sha256 batch API internally for performance,
    which is why it operates on several shreds at the same time as
-   opposed to one at a time. */
+   opposed to one at a time.  Like fd_shred_dest_compute_children,
+   results are served from the per-object cache when possible. */
 fd_shred_dest_idx_t *
 fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
                              fd_shred_t const * const * input_shreds,
@@ -188,6 +226,10 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
    cases may be much lower (especially if the source validator has low
    stake).
 
+   Results are served from the per-object cache described above when
+   possible and shreds that miss are inserted into it.  Caching never
+   changes the results.
+
    Returns out on success and NULL on failure. */
 /* TODO: Would it be better if out were transposed? Should I get rid of
    stride? */
@@ -201,6 +243,57 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
                                 ulong                      dest_cnt,
                                 ulong                    * opt_max_dest_cnt );
 
+/* fd_shred_dest_fec_set_window returns the number of shreds of the same
+   type as shred in its FEC set and stores the index of the first one
+   in *idx0.  Code shreds carry the layout of their FEC set.  For data
+   shreds, only the start of the FEC set is known, so this assumes the
+   usual 32 data shreds per FEC set.  Malformed shreds get a window of
+   just themselves.  The result is in [1, FD_SHRED_DEST_MAX_SHRED_CNT]
+   and *idx0+result does not overflow a uint. */
+static inline ulong
+fd_shred_dest_fec_set_window( fd_shred_t const * shred,
+                              uint             * idx0 ) {
+  uchar type    = fd_shred_type( shred->variant );
+  int   is_data = (type==FD_SHRED_TYPE_LEGACY_DATA) | (type==FD_SHRED_TYPE_MERKLE_DATA);
+  uint  idx     = shred->idx;
+  uint  lo;
+  ulong cnt;
+  if( is_data ) {
+    lo  = shred->fec_set_idx;
+    cnt = 32UL;
+  } else {
+    lo  = idx - (uint)shred->code.idx;
+    cnt = shred->code.code_cnt;
+  }
+  int valid = (lo<=idx) & ((ulong)(idx-lo)<cnt) & (cnt<=FD_SHRED_DEST_MAX_SHRED_CNT) & ((ulong)lo+cnt<=(ulong)UINT_MAX+1UL);
+  *idx0 = fd_uint_if( valid, lo, idx );
+  return fd_ulong_if( valid, cnt, 1UL );
+}
+
+/* fd_shred_dest_prefill computes the source validator's destinations
+   for the idx_cnt shreds of slot with the given type (data if is_data,
+   code otherwise) and indices [idx0, idx0+idx_cnt) that aren't already
+   cached, and stores them in the cache.  If the source validator is
+   the leader of slot, these are the results of
+   fd_shred_dest_compute_first, otherwise the results of
+   fd_shred_dest_compute_children with the same fanout and dest_cnt.
+   Prefilling never changes the results of either, so indices past the
+   end of the slot or a wrong guess of the FEC set layout only cost
+   some wasted work.  This is meant to be called when the caller is
+   idle, typically with a window from fd_shred_dest_fec_set_window
+   once the first shred of a FEC set has been relayed, or with the
+   indices of the next FEC set when the caller is the leader.  idx_cnt
+   must be in [0, FD_SHRED_DEST_MAX_SHRED_CNT].  Returns sdest on
+   success and NULL on failure (unknown slot). */
+fd_shred_dest_t *
+fd_shred_dest_prefill( fd_shred_dest_t * sdest,
+                       ulong             slot,
+                       int               is_data,
+                       uint              idx0,
+                       ulong             idx_cnt,
+                       ulong             fanout,
+                       ulong             dest_cnt );
+
 /* fd_shred_dest_idx_to_dest maps a destination index (as produced by
    fd_shred_dest_compute_children or fd_shred_dest_compute_first) to an
    actual destination.  The lifetime of the returned pointer is the same
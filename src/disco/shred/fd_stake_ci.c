@@ -47,21 +47,17 @@ fd_stake_ci_stake_msg_init( fd_stake_ci_t * info,
                             uchar const   * new_message ) {
   ulong const * hdr = fd_type_pun_const( new_message );
 
-  ulong epoch               = hdr[ 0 ];
-  ulong staked_cnt          = hdr[ 1 ];
+  ulong epoch               = fd_stake_ci_stake_msg_epoch     ( new_message );
+  ulong staked_cnt          = fd_stake_ci_stake_msg_staked_cnt( new_message );
   ulong start_slot          = hdr[ 2 ];
   ulong slot_cnt            = hdr[ 3 ];
 
-  if( FD_UNLIKELY( staked_cnt > MAX_SHRED_DESTS ) )
-    FD_LOG_ERR(( "The stakes -> Firedancer splice sent a malformed update with %lu stakes in it,"
-                 " but the maximum allowed is %lu", staked_cnt, MAX_SHRED_DESTS ));
-
   info->scratch->epoch      = epoch;
   info->scratch->start_slot = start_slot;
   info->scratch->slot_cnt   = slot_cnt;
   info->scratch->staked_cnt = staked_cnt;
 
-  fd_memcpy( info->stake_weight, hdr+4UL, sizeof(fd_stake_weight_t)*staked_cnt );
+  fd_memcpy( info->stake_weight, fd_stake_ci_stake_msg_weights( new_message ), sizeof(fd_stake_weight_t)*staked_cnt );
 }
 
 static inline void
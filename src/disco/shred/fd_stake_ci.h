@@ -91,6 +91,35 @@ fd_stake_ci_t * fd_stake_ci_join( void * mem );
 void * fd_stake_ci_leave ( fd_stake_ci_t * info );
 void * fd_stake_ci_delete( void          * mem  );
 
+/* fd_stake_ci_stake_msg_{epoch, staked_cnt, weights} decode a stake
+   weights message (see fd_stake_ci_stake_msg_init below) for consumers
+   that need the stakes but not the leader schedule or shred
+   destinations.  They return the epoch the message is for, the number
+   of staked pubkeys in it, and a pointer to the first of its stake
+   weights, which lives as long as the message.  msg points to the first
+   byte of the dcache entry.  fd_stake_ci_stake_msg_staked_cnt logs an
+   error and terminates the process if the message holds more than
+   MAX_SHRED_DESTS stakes. */
+
+static inline ulong
+fd_stake_ci_stake_msg_epoch( uchar const * msg ) {
+  return FD_LOAD( ulong, msg );
+}
+
+static inline ulong
+fd_stake_ci_stake_msg_staked_cnt( uchar const * msg ) {
+  ulong staked_cnt = FD_LOAD( ulong, msg+8UL );
+  if( FD_UNLIKELY( staked_cnt > MAX_SHRED_DESTS ) )
+    FD_LOG_ERR(( "The stakes -> Firedancer splice sent a malformed update with %lu stakes in it,"
+                 " but the maximum allowed is %lu", staked_cnt, MAX_SHRED_DESTS ));
+  return staked_cnt;
+}
+
+static inline fd_stake_weight_t const *
+fd_stake_ci_stake_msg_weights( uchar const * msg ) {
+  return fd_type_pun_const( msg+32UL );
+}
+
 /* fd_stake_ci_stake_msg_{init, fini} are used to handle messages
    containing stake weight updates from the Rust side of the splice, and
    fd_stake_ci_dest_add_{init, fini} are used to handle messages
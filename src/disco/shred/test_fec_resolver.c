@@ -244,6 +244,99 @@ test_rolloff( void ) {
   fd_fec_resolver_delete( fd_fec_resolver_leave( resolver ) );
 }
 
+/* test_merkle_root derives the Merkle root of a shred the way a
+   receiver checks a single shred: hash its leaf and walk its inclusion
+   proof. */
+
+static void
+test_merkle_root( fd_bmtree_node_t * root,
+                  uchar const *      shred_mem ) {
+  fd_shred_t const * shred = fd_shred_parse( shred_mem, 2048UL );
+  FD_TEST( shred );
+
+  ulong tree_depth   = fd_shred_merkle_cnt( shred->variant );
+  ulong protected_sz = 1115UL - 20UL*tree_depth + 0x58UL - 0x40UL;
+  if( fd_shred_type( shred->variant )==FD_SHRED_TYPE_MERKLE_CODE ) protected_sz += 0x59UL - 0x40UL;
+
+  ulong shred_idx = fd_ulong_if( fd_shred_type( shred->variant )==FD_SHRED_TYPE_MERKLE_DATA,
+                                 shred->idx - shred->fec_set_idx, shred->code.data_cnt + shred->code.idx );
+
+  fd_bmtree_node_t leaf[1];
+  fd_bmtree_hash_leaf( leaf, shred_mem+sizeof(fd_ed25519_sig_t), protected_sz, FD_BMTREE_LONG_PREFIX_SZ );
+  FD_TEST( fd_bmtree_from_proof( leaf, shred_idx, root, (uchar const *)fd_shred_merkle_nodes( shred ), tree_depth,
+                                 FD_SHRED_MERKLE_NODE_SZ, FD_BMTREE_LONG_PREFIX_SZ ) );
+}
+
+/* Shreds recovered with Reed-Solomon have their Merkle leaves hashed in
+   a batch.  Every shred of the recovered set, taken on its own, must
+   still prove the root the leader signed. */
+
+static void
+test_recovered_roots( void ) {
+  signer_ctx_t signer_ctx[ 1 ];
+  signer_ctx_init( signer_ctx, test_private_key );
+
+  FD_TEST( _shredder==fd_shredder_new( _shredder, test_signer, signer_ctx, (ushort)0 ) );
+  fd_shredder_t * shredder = fd_shredder_join( _shredder );           FD_TEST( shredder );
+  uchar const * pubkey = test_private_key+32UL;
+  fd_fec_set_t const * out_fec[1];
+  fd_shred_t   const * out_shred[1];
+
+  fd_entry_batch_meta_t meta[1];
+  fd_memset( meta, 0, sizeof(fd_entry_batch_meta_t) );
+  meta->block_complete = 1;
+
+  FD_TEST( fd_shredder_init_batch( shredder, test_bin, test_bin_sz, 0UL, meta ) );
+
+  fd_fec_set_t _set[ 1 ];
+  uchar * ptr = fec_set_memory;
+  ptr = allocate_fec_set( _set, ptr );
+
+  fd_fec_set_t out_sets[ 4UL ];
+  for( ulong i=0UL; i<4UL; i++ ) ptr = allocate_fec_set( out_sets+i, ptr );
+
+  fd_fec_resolver_t * resolver = fd_fec_resolver_join( fd_fec_resolver_new( resolver_mem, 2UL, 1UL, 1UL, 1UL, out_sets ) );
+
+  fd_sha512_t _sha512[1]; fd_sha512_t * sha512 = fd_sha512_join( fd_sha512_new( _sha512 ) );
+
+  ulong set_cnt = fd_shredder_count_fec_sets( test_bin_sz );
+  for( ulong i=0UL; i<set_cnt; i++ ) {
+    fd_fec_set_t * set = fd_shredder_next_fec_set( shredder, _set );
+    FD_TEST( set->parity_shred_cnt>=set->data_shred_cnt );
+
+    fd_bmtree_node_t expected[1];
+    test_merkle_root( expected, set->data_shreds[ 0 ] );
+
+    /* Even sets recover every data shred and the parity shreds past the
+       ones received.  Odd sets receive every other data shred and fill
+       in with parity shreds from the back. */
+    ulong need = set->data_shred_cnt;
+    if( i&1UL ) {
+      for( ulong j=1UL; j<set->data_shred_cnt; j+=2UL ) { ADD_SHRED( resolver, set->data_shreds[ j ], OKAY ); need--; }
+      ulong j = set->parity_shred_cnt-1UL;
+      for( ; need>1UL; j--, need-- ) ADD_SHRED( resolver, set->parity_shreds[ j ], OKAY );
+      ADD_SHRED( resolver, set->parity_shreds[ j ], COMPLETES );
+    } else {
+      for( ulong j=0UL; j<need-1UL; j++ ) ADD_SHRED( resolver, set->parity_shreds[ j ], OKAY );
+      ADD_SHRED( resolver, set->parity_shreds[ need-1UL ], COMPLETES );
+    }
+    FD_TEST( sets_eq( set, *out_fec ) );
+
+    for( ulong j=0UL; j<(*out_fec)->data_shred_cnt+(*out_fec)->parity_shred_cnt; j++ ) {
+      uchar const * shred_mem = fd_ptr_if( j<(*out_fec)->data_shred_cnt, (*out_fec)->data_shreds[ j ],
+                                           (*out_fec)->parity_shreds[ j-(*out_fec)->data_shred_cnt ] );
+      fd_bmtree_node_t root[1];
+      test_merkle_root( root, shred_mem );
+      FD_TEST( fd_memeq( root->hash, expected->hash, 32UL ) );
+      FD_TEST( FD_ED25519_SUCCESS==fd_ed25519_verify( root->hash, 32UL, shred_mem, pubkey, sha512 ) );
+    }
+  }
+  FD_TEST( fd_shredder_fini_batch( shredder ) );
+
+  fd_sha512_delete( fd_sha512_leave( sha512 ) );
+  fd_fec_resolver_delete( fd_fec_resolver_leave( resolver ) );
+}
+
 static void
 perf_test( void ) {
   for( ulong i=0UL; i<PERF_TEST_SZ; i++ )  perf_test_entry_batch[ i ] = (uchar)i;
@@ -291,6 +384,7 @@ main( int     argc,
   test_interleaved();
   test_one_batch();
   test_rolloff();
+  test_recovered_roots();
 
 
   FD_LOG_NOTICE(( "pass" ));
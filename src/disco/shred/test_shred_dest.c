@@ -326,6 +326,220 @@ test_errors( void ) {
   fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
 }
 
+static void
+test_cache( void ) {
+  ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
+  fd_shred_dest_weighted_t const * info = (fd_shred_dest_weighted_t const *)testnet_dest_info;
+
+  fd_rng_t _rng[1]; fd_rng_t * r = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+
+  ulong staked = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    stakes[i].key = info[i].pubkey;
+    stakes[i].stake = info[i].stake_lamports;
+    staked += (info[i].stake_lamports>0UL);
+  }
+  fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 10000UL, staked, stakes ) );
+
+  /* A highly staked source (often has children) and an unstaked one */
+  ulong srcs[2] = { 0UL, cnt-1UL };
+  for( ulong s=0UL; s<2UL; s++ ) {
+    fd_pubkey_t const * src_key = &info[ srcs[s] ].pubkey;
+    fd_shred_dest_t * sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, src_key ) );
+
+    /* One FEC set of 32 data and 32 code shreds */
+    fd_shred_t shred[64];
+    fd_shred_t const * shred_ptr[64];
+    memset( shred, 0, sizeof(shred) );
+
+    static fd_shred_dest_idx_t cached  [ 64*201 ];
+    static fd_shred_dest_idx_t uncached[ 64*201 ];
+
+    for( ulong iter=0UL; iter<40UL; iter++ ) {
+      ulong slot = 1UL + fd_rng_ulong_roll( r, 10000UL );
+      if( FD_UNLIKELY( !memcmp( fd_epoch_leaders_get( lsched, slot ), src_key, 32UL ) ) ) continue;
+
+      uint fec_set_idx = 32U*fd_rng_uint_roll( r, 20U );
+      uint code_base   = 32U*fd_rng_uint_roll( r, 20U );
+      for( ulong j=0UL; j<64UL; j++ ) {
+        shred[j].slot        = slot;
+        shred[j].fec_set_idx = fec_set_idx;
+        if( j<32UL ) {
+          shred[j].variant = fd_shred_variant( FD_SHRED_TYPE_MERKLE_DATA, 2 );
+          shred[j].idx     = fec_set_idx + (uint)j;
+        } else {
+          shred[j].variant       = fd_shred_variant( FD_SHRED_TYPE_MERKLE_CODE, 2 );
+          shred[j].idx           = code_base + (uint)(j-32UL);
+          shred[j].code.data_cnt = 32;
+          shred[j].code.code_cnt = 32;
+          shred[j].code.idx      = (ushort)(j-32UL);
+        }
+      }
+      /* Shreds arrive in a random order */
+      for( ulong j=0UL; j<64UL; j++ ) shred_ptr[j] = shred+j;
+      for( ulong j=63UL; j>0UL; j-- ) {
+        ulong k = fd_rng_ulong_roll( r, j+1UL );
+        fd_shred_t const * t = shred_ptr[j]; shred_ptr[j] = shred_ptr[k]; shred_ptr[k] = t;
+      }
+
+      /* dest_cnt>FD_SHRED_DEST_CACHE_DEST_MAX bypasses the cache.  Half
+         the time, prefill the cache from the first shred to arrive,
+         otherwise compute each shred on a miss. */
+      ulong max_cached[1]; ulong max_uncached[1];
+      ulong max_one = 0UL;
+      if( iter&1UL ) {
+        uint  idx0;
+        ulong idx_cnt = fd_shred_dest_fec_set_window( shred_ptr[0], &idx0 );
+        FD_TEST( idx_cnt==32UL );
+        FD_TEST( idx0==shred_ptr[0]->idx-(shred_ptr[0]->idx%32U) );
+        int is_data = fd_shred_type( shred_ptr[0]->variant )==FD_SHRED_TYPE_MERKLE_DATA;
+        FD_TEST( fd_shred_dest_prefill( sdest, slot, is_data, idx0, idx_cnt, 200UL, 200UL )==sdest );
+      }
+      for( ulong j=0UL; j<64UL; j++ ) {
+        ulong max[1];
+        FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr+j, 1UL, cached+j, 64UL, 200UL, 200UL, max ) );
+        max_one = fd_ulong_max( max_one, *max );
+      }
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, uncached, 64UL, 200UL, 201UL, max_uncached ) );
+      FD_TEST( max_one==*max_uncached );
+      for( ulong j=0UL; j<64UL*200UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+      for( ulong j=0UL; j<64UL;       j++ ) FD_TEST( uncached[200UL*64UL+j]==FD_SHRED_DEST_NO_DEST );
+
+      /* Now all cached, in one batch */
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, cached, 64UL, 200UL, 200UL, max_cached ) );
+      FD_TEST( *max_cached==*max_uncached );
+      for( ulong j=0UL; j<64UL*200UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+
+      /* Changing the parameters flushes the cache */
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, cached,   64UL, 100UL, 100UL, NULL ) );
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, uncached, 64UL, 100UL, 201UL, NULL ) );
+      for( ulong j=0UL; j<64UL*100UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+    }
+    fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  }
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
+  fd_rng_delete( fd_rng_leave( r ) );
+}
+
+static void
+test_cache_first( void ) {
+  ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
+  fd_shred_dest_weighted_t const * info = (fd_shred_dest_weighted_t const *)testnet_dest_info;
+
+  ulong staked = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    stakes[i].key = info[i].pubkey;
+    stakes[i].stake = info[i].stake_lamports;
+    staked += (info[i].stake_lamports>0UL);
+  }
+  fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 10000UL, staked, stakes ) );
+
+  fd_shred_t shred[64];
+  fd_shred_t const * shred_ptr[64];
+  memset( shred, 0, sizeof(shred) );
+  fd_shred_dest_idx_t cached[64], uncached[64];
+  static fd_shred_dest_idx_t children[ 64*201 ], children_uncached[ 64*201 ];
+
+  for( ulong slot=4UL; slot<10000UL; slot+=4UL*97UL ) {
+    fd_pubkey_t const * leader = fd_epoch_leaders_get( lsched, slot );
+    fd_shred_dest_t * sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, leader ) );
+
+    for( ulong j=0UL; j<64UL; j++ ) {
+      shred_ptr[j]     = shred+j;
+      shred[j].slot    = slot;
+      shred[j].variant = fd_shred_variant( j<32UL ? FD_SHRED_TYPE_MERKLE_DATA : FD_SHRED_TYPE_MERKLE_CODE, 2 );
+      shred[j].idx     = 64U + (uint)(j%32UL);
+    }
+
+    /* Cold, one at a time, then the whole FEC set from the cache */
+    for( ulong j=0UL; j<64UL; j++ ) FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr+j, 1UL, uncached+j ) );
+    FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, 64UL, cached ) );
+    for( ulong j=0UL; j<64UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+
+    /* Prefill the next FEC set as the leader does, and check it against
+       a fresh object */
+    FD_TEST( fd_shred_dest_prefill( sdest, slot, 1, 96U, 32UL, 200UL, 200UL )==sdest );
+    FD_TEST( fd_shred_dest_prefill( sdest, slot, 0, 96U, 32UL, 200UL, 200UL )==sdest );
+    for( ulong j=0UL; j<64UL; j++ ) shred[j].idx += 32U;
+    FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, 64UL, cached ) );
+
+    FD_TEST( !fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, children, 64UL, 200UL, 200UL, NULL ) );
+
+    fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+    sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, leader ) );
+    FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, 64UL, uncached ) );
+    for( ulong j=0UL; j<64UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+
+    fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+
+    /* Roots and children of the same shreds are cached separately.  A
+       non-leader never needs roots, but nothing stops it from asking. */
+    sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, &info[ slot%cnt ].pubkey ) );
+    if( FD_UNLIKELY( !memcmp( leader, &info[ slot%cnt ].pubkey, 32UL ) ) ) { fd_shred_dest_delete( fd_shred_dest_leave( sdest ) ); continue; }
+    FD_TEST( fd_shred_dest_compute_first   ( sdest, shred_ptr, 64UL, cached ) );
+    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, children,          64UL, 200UL, 200UL, NULL ) );
+    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 64UL, children_uncached, 64UL, 200UL, 201UL, NULL ) );
+    for( ulong j=0UL; j<64UL*200UL; j++ ) FD_TEST( children[j]==children_uncached[j] );
+    FD_TEST( fd_shred_dest_compute_first   ( sdest, shred_ptr, 64UL, uncached ) );
+    for( ulong j=0UL; j<64UL; j++ ) FD_TEST( cached[j]==uncached[j] );
+    fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  }
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
+}
+
+/* test_cache_ring checks that entries whose destinations have been
+   overwritten in the ring are recomputed correctly. */
+static void
+test_cache_ring( void ) {
+  ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
+  fd_shred_dest_weighted_t const * info = (fd_shred_dest_weighted_t const *)testnet_dest_info;
+
+  ulong staked = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    stakes[i].key = info[i].pubkey;
+    stakes[i].stake = info[i].stake_lamports;
+    staked += (info[i].stake_lamports>0UL);
+  }
+  fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 10000UL, staked, stakes ) );
+
+  fd_shred_t shred[134];
+  fd_shred_t const * shred_ptr[134];
+  memset( shred, 0, sizeof(shred) );
+  for( ulong j=0UL; j<134UL; j++ ) {
+    shred_ptr[j]     = shred+j;
+    shred[j].slot    = 1UL;
+    shred[j].variant = fd_shred_variant( FD_SHRED_TYPE_MERKLE_CODE, 2 );
+    shred[j].idx     = (uint)j;
+  }
+  static fd_shred_dest_idx_t first [ 134*200 ];
+  static fd_shred_dest_idx_t cached[ 134*200 ];
+  ulong max_first[1], max_cached[1];
+
+  /* The most staked validator is on the first layer for most shreds,
+     so it has a full fanout of children and a few FEC sets wrap the
+     ring. */
+  ulong src_idx = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) if( info[i].stake_lamports>info[src_idx].stake_lamports ) src_idx = i;
+  FD_TEST( memcmp( fd_epoch_leaders_get( lsched, 1UL ), &info[ src_idx ].pubkey, 32UL ) );
+  fd_shred_dest_t * sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, &info[ src_idx ].pubkey ) );
+  FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 134UL, first, 134UL, 200UL, 200UL, max_first ) );
+  FD_TEST( *max_first==200UL );
+  ulong slot = 1UL;
+
+  /* Push enough other shreds through to overwrite the whole ring */
+  for( uint k=0U; k<16U; k++ ) {
+    FD_TEST( fd_shred_dest_prefill( sdest, slot, 1, 134U*k, 134UL, 200UL, 200UL )==sdest );
+  }
+  FD_TEST( sdest->cache_ring_next>=134UL*200UL+FD_SHRED_DEST_CACHE_RING_CNT );
+
+  FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 134UL, cached, 134UL, 200UL, 200UL, max_cached ) );
+  FD_TEST( *max_cached==*max_first );
+  for( ulong j=0UL; j<134UL*200UL; j++ ) FD_TEST( cached[j]==first[j] );
+
+  fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
+}
+
 static void
 test_performance( void ) {
   ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
@@ -379,6 +593,44 @@ test_performance( void ) {
   dt += fd_log_wallclock();
   FD_LOG_NOTICE(( "Compute children (16 shred/batch): %.2f ns/shred", (double)dt / (double)(16UL*TEST_CNT) ));
 #undef TEST_CNT
+
+  /* Relaying a FEC set of 32 data shreds one shred at a time: without
+     the cache, from a cold cache, and after prefilling it (the part
+     done while idle is timed separately) */
+#define TEST_CNT 2000
+  for( ulong j=0UL; j<16UL; j++ ) shred[j].variant = fd_shred_variant( FD_SHRED_TYPE_MERKLE_DATA, 2 );
+  long dt_bypass = 0L; long dt_cold = 0L; long dt_prefill = 0L; long dt_hit = 0L;
+  for( ulong j=0UL; j<TEST_CNT; j++ ) {
+    uint idx0 = (uint)(j*32UL);
+    dt_bypass -= fd_log_wallclock();
+    for( uint k=0U; k<32U; k++ ) {
+      shred[0].idx = idx0+k;
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result, 1UL, 200UL, 201UL, max_dest_cnt ) );
+    }
+    dt_bypass += fd_log_wallclock();
+    dt_cold   -= fd_log_wallclock();
+    for( uint k=0U; k<32U; k++ ) {
+      shred[0].idx = idx0+k;
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result, 1UL, 200UL, 200UL, max_dest_cnt ) );
+    }
+    dt_cold    += fd_log_wallclock();
+    idx0       += (uint)(32UL*TEST_CNT);
+    dt_prefill -= fd_log_wallclock();
+    FD_TEST( fd_shred_dest_prefill( sdest, 1UL, 1, idx0, 32UL, 200UL, 200UL )==sdest );
+    dt_prefill += fd_log_wallclock();
+    dt_hit     -= fd_log_wallclock();
+    for( uint k=0U; k<32U; k++ ) {
+      shred[0].idx = idx0+k;
+      FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result, 1UL, 200UL, 200UL, max_dest_cnt ) );
+    }
+    dt_hit += fd_log_wallclock();
+  }
+  double shred_cnt = (double)(32UL*TEST_CNT);
+  FD_LOG_NOTICE(( "Compute children uncached: %.2f ns/shred, cold cache: %.2f ns/shred", (double)dt_bypass/shred_cnt, (double)dt_cold/shred_cnt ));
+  FD_LOG_NOTICE(( "Compute children prefilled: %.2f ns/shred while idle + %.2f ns/shred on relay", (double)dt_prefill/shred_cnt, (double)dt_hit/shred_cnt ));
+#undef TEST_CNT
+  fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
 }
 
 int
@@ -398,6 +650,10 @@ main( int     argc,
   test_t1_vary_radix();
   FD_LOG_NOTICE(( "Testing batching" ));
   test_batching();
+  FD_LOG_NOTICE(( "Testing cache" ));
+  test_cache();
+  test_cache_first();
+  test_cache_ring();
   FD_LOG_NOTICE(( "Testing contact change" ));
   test_change_contact();
   FD_LOG_NOTICE(( "Testing performance" ));
@@ -156,6 +156,7 @@ typedef struct {
       ulong  max_inflight_quic_packets;
       ulong  tx_buf_size;
       ulong  max_concurrent_streams_per_connection;
+      ulong  max_concurrent_streams_per_unstaked_connection;
       ulong  stream_pool_cnt;
       uint   ip_addr;
       uchar  src_mac_addr[ 6 ];
@@ -163,6 +164,7 @@ typedef struct {
       ulong  idle_timeout_millis;
       char   identity_key_path[ PATH_MAX ];
       int    retry;
+      ulong  max_handshakes_per_service;
     } quic;
 
     struct {
@@ -200,6 +200,16 @@ fd_replay_pending_iter_next( fd_replay_t * replay, long now, ulong i ) {
 fd_fork_t *
 fd_replay_slot_prepare( fd_replay_t * replay, ulong slot ) {
 
+  /* We already executed this block.  Most calls are for such blocks, so
+     check without blocking the shred inserter first. */
+
+  fd_block_t     blk_copy[1];
+  fd_slot_meta_t slot_meta_copy[1];
+  if( FD_LIKELY( !fd_blockstore_slot_meta_query_volatile( replay->blockstore, slot, blk_copy, slot_meta_copy ) &&
+                 fd_uchar_extract_bit( blk_copy->flags, FD_BLOCK_FLAG_PROCESSED ) ) ) {
+    return NULL;
+  }
+
   fd_blockstore_start_read( replay->blockstore );
 
   ulong re_adds[2];
@@ -266,6 +276,15 @@ fd_replay_slot_prepare( fd_replay_t * replay, ulong slot ) {
     goto end;
   }
 
+  /* Mark the block as prepared, and thus unsafe to remove. */
+
+  block->flags = fd_uchar_set_bit( block->flags, FD_BLOCK_FLAG_PREPARED );
+
+  /* Block data ptr remains valid outside of the rw lock for the lifetime of the block alloc.
+     Restoring a fork below only needs funk and the block hash, which is read without the lock. */
+
+  fd_blockstore_end_read( replay->blockstore );
+
   /* Query for the fork to execute the block on in the frontier */
 
   fd_fork_t * fork = fd_fork_frontier_ele_query(
@@ -297,14 +316,6 @@ fd_replay_slot_prepare( fd_replay_t * replay, ulong slot ) {
     fd_fork_frontier_ele_insert( replay->forks->frontier, fork, replay->forks->pool );
   }
 
-  /* Mark the block as prepared, and thus unsafe to remove. */
-
-  block->flags = fd_uchar_set_bit( block->flags, FD_BLOCK_FLAG_PREPARED );
-
-  /* Block data ptr remains valid outside of the rw lock for the lifetime of the block alloc. */
-
-  fd_blockstore_end_read( replay->blockstore );
-
   /* Add slots to pending. */
 
   for( uint i = 0; i < re_adds_cnt; ++i ) {
@@ -474,9 +485,10 @@ fd_replay_slot_repair( fd_replay_t * replay, ulong slot ) {
 void
 fd_replay_slot_ctx_restore( fd_replay_t * replay, ulong slot, fd_exec_slot_ctx_t * slot_ctx ) {
   fd_funk_txn_t *   txn_map    = fd_funk_txn_map( replay->funk, fd_funk_wksp( replay->funk ) );
-  fd_hash_t const * block_hash = fd_blockstore_block_hash_query( replay->blockstore, slot );
+  fd_hash_t         block_hash[1];
+  int               hash_err   = fd_blockstore_block_hash_query_volatile( replay->blockstore, slot, block_hash );
   FD_LOG_DEBUG(("Current slot %lu", slot));
-  if( !block_hash ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
+  if( hash_err ) FD_LOG_ERR( ( "missing block hash of slot we're trying to restore" ) );
   fd_funk_txn_xid_t xid;
   fd_memcpy( xid.uc, block_hash, sizeof( fd_funk_txn_xid_t ) );
   xid.ul[0]             = slot;
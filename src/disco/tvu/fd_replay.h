@@ -21,6 +21,7 @@
 #include "../../flamenco/runtime/context/fd_capture_ctx.h"
 #include "../../flamenco/runtime/context/fd_exec_slot_ctx.h"
 #include "../../flamenco/runtime/fd_blockstore.h"
+#include "../../flamenco/runtime/fd_blockstore_archive.h"
 #include "../../flamenco/runtime/fd_runtime.h"
 #include "fd_pending_slots.h"
 #include "../shred/fd_fec_resolver.h"
@@ -72,6 +73,7 @@ struct __attribute__((aligned(128UL))) fd_replay {
   /* external joins */
   fd_acc_mgr_t *        acc_mgr;
   fd_blockstore_t *     blockstore;
+  fd_blockstore_archive_t * archive; /* finalized blocks evicted from the blockstore, NULL if none */
   fd_exec_epoch_ctx_t * epoch_ctx;
   fd_forks_t *          forks;
   fd_funk_t *           funk;
@@ -82,6 +82,19 @@ fd_store_slot_prepare( fd_store_t *   store,
                        ulong *        repair_slot_out,
                        uchar const ** block_out,
                        ulong *        block_sz_out ) {
+  *repair_slot_out = 0;
+
+  /* We already prepared or executed this block.  Most calls are for
+     such blocks, so check without blocking the shred inserter first. */
+
+  fd_block_t     blk_copy[1];
+  fd_slot_meta_t slot_meta_copy[1];
+  if( FD_LIKELY( !fd_blockstore_slot_meta_query_volatile( store->blockstore, slot, blk_copy, slot_meta_copy ) &&
+                 ( fd_uchar_extract_bit( blk_copy->flags, FD_BLOCK_FLAG_PREPARED  ) ||
+                   fd_uchar_extract_bit( blk_copy->flags, FD_BLOCK_FLAG_PROCESSED ) ) ) ) {
+    return FD_STORE_SLOT_PREPARE_ALREADY_EXECUTED;
+  }
+
   fd_blockstore_start_read( store->blockstore );
 
   ulong re_adds[2];
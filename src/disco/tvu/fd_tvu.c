@@ -75,6 +75,7 @@
 #include "../../flamenco/fd_flamenco.h"
 #include "../../flamenco/runtime/fd_hashes.h"
 #include "../../flamenco/runtime/program/fd_bpf_program_util.h"
+#include "../../flamenco/vm/fd_vm_jit.h"
 #include "../../flamenco/runtime/sysvar/fd_sysvar_epoch_schedule.h"
 #include "../../flamenco/snapshot/fd_snapshot.h"
 #include "fd_replay.h"
@@ -252,19 +253,18 @@ static long
 repair_serv_get_shred( ulong slot, uint shred_idx, void * buf, ulong buf_max, void * arg ) {
   fd_replay_t * replay = (fd_replay_t *)arg;
   fd_blockstore_t * blockstore = replay->blockstore;
-  fd_blockstore_start_read( blockstore );
-
-  if( shred_idx == UINT_MAX ) {
-    fd_slot_meta_t * meta = fd_blockstore_slot_meta_query( blockstore, slot );
-    if( meta == NULL ) {
-      fd_blockstore_end_read( blockstore );
-      return -1L;
-    }
-    shred_idx = (uint)meta->last_index;
+  /* Lock-free reads so that serving repair never stalls shred insertion */
+  long sz = -1L;
+  fd_slot_meta_t meta;
+  if( shred_idx != UINT_MAX ) {
+    sz = fd_buf_shred_query_copy_data_volatile( blockstore, slot, shred_idx, buf, buf_max );
+  } else if( !fd_blockstore_slot_meta_query_volatile( blockstore, slot, NULL, &meta ) ) {
+    sz = fd_buf_shred_query_copy_data_volatile( blockstore, slot, (uint)meta.last_index, buf, buf_max );
+  }
+  /* Fall back to the archive for slots evicted from the blockstore */
+  if( sz < 0L && replay->archive ) {
+    sz = fd_blockstore_archive_shred_query_copy_data( replay->archive, slot, shred_idx, buf, buf_max );
   }
-  long sz = fd_buf_shred_query_copy_data( blockstore, slot, shred_idx, buf, buf_max );
-
-  fd_blockstore_end_read( blockstore );
   return sz;
 }
 
@@ -272,17 +272,11 @@ static ulong
 repair_serv_get_parent( ulong slot, void * arg ) {
   fd_replay_t * replay = (fd_replay_t *)arg;
   fd_blockstore_t * blockstore = replay->blockstore;
-  fd_blockstore_start_read( blockstore );
-
-  fd_slot_meta_t * meta = fd_blockstore_slot_meta_query( blockstore, slot );
-  if( meta == NULL ) {
-    fd_blockstore_end_read( blockstore );
-    return FD_SLOT_NULL;
+  ulong parent_slot = fd_blockstore_parent_slot_query_volatile( blockstore, slot );
+  if( parent_slot == FD_SLOT_NULL && replay->archive ) {
+    parent_slot = fd_blockstore_archive_parent_slot_query( replay->archive, slot );
   }
-  ulong res = meta->parent_slot;
-
-  fd_blockstore_end_read( blockstore );
-  return res;
+  return parent_slot;
 }
 
 /* Convert a host:port string to a repair network address. If host is
@@ -514,6 +508,10 @@ fd_tvu_main( fd_runtime_ctx_t *    runtime_ctx,
       }
     }
 
+    /* Spill newly finalized blocks to the archive before the blockstore
+       evicts them */
+    if( replay->archive ) fd_blockstore_archive_sync( replay->archive, replay->blockstore, replay->smr );
+
     /* Allow other threads to add pendings */
     struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)1e6 };
     nanosleep(&ts, NULL);
@@ -841,6 +839,33 @@ typedef struct {
   fd_fec_resolver_t * fec_resolver;
 } turbine_setup_t;
 
+/* Sensible defaults for the archive indices: about a day of slots, and
+   one txn per KiB of archive (a typical txn plus its share of the shred
+   headers), within bounds.  Once full, the indices drop the oldest
+   records. */
+#define FD_TVU_ARCHIVE_SLOT_MAX       (1UL << 18UL)
+#define FD_TVU_ARCHIVE_LG_TXN_MAX_MIN (16)
+#define FD_TVU_ARCHIVE_LG_TXN_MAX_MAX (25)
+
+fd_blockstore_archive_t * blockstore_archive_setup( fd_wksp_t * wksp, fd_runtime_args_t * args ) {
+  if( !args->blockstore_archive || args->blockstore_archive[0] == '\0' ) return NULL;
+  ulong file_max   = args->blockstore_archive_sz_gb << 30UL;
+  int   lg_txn_max = fd_int_max( FD_TVU_ARCHIVE_LG_TXN_MAX_MIN,
+                                 fd_int_min( FD_TVU_ARCHIVE_LG_TXN_MAX_MAX, fd_ulong_find_msb_w_default( file_max >> 10UL, 0 ) ) );
+
+  void * shmem = fd_wksp_alloc_laddr( wksp,
+                                      fd_blockstore_archive_align(),
+                                      fd_blockstore_archive_footprint( FD_TVU_ARCHIVE_SLOT_MAX, lg_txn_max ),
+                                      1UL );
+  if( shmem == NULL ) FD_LOG_ERR( ( "failed to allocate a blockstore archive" ) );
+  fd_blockstore_archive_t * archive = fd_blockstore_archive_join(
+      fd_blockstore_archive_new( shmem, 42UL, FD_TVU_ARCHIVE_SLOT_MAX, lg_txn_max ) );
+  if( archive == NULL ) FD_LOG_ERR( ( "failed to create a blockstore archive" ) );
+  if( fd_blockstore_archive_open( archive, args->blockstore_archive, file_max, 1 ) )
+    FD_LOG_ERR( ( "failed to open blockstore archive %s", args->blockstore_archive ) );
+  return archive;
+}
+
 void turbine_setup( fd_wksp_t * wksp, turbine_setup_t * out ) {
   FD_TEST( wksp );
   fd_memset( out, 0, sizeof( turbine_setup_t ) );
@@ -1322,6 +1347,9 @@ fd_tvu_main_setup( fd_runtime_ctx_t *    runtime_ctx,
     } FD_SCRATCH_SCOPE_END;
 
     replay_setup_out.replay->blockstore  = blockstore_setup_out.blockstore;
+    replay_setup_out.replay->archive     = blockstore_archive_setup( wksp, args );
+    if( replay_setup_out.replay->archive )
+      fd_blockstore_archive_attach( replay_setup_out.replay->archive, replay_setup_out.replay->blockstore );
     replay_setup_out.replay->funk        = funk_setup_out.funk;
     replay_setup_out.replay->acc_mgr     = runtime_ctx->_acc_mgr;
     replay_setup_out.replay->epoch_ctx   = slot_ctx_setup_out.exec_epoch_ctx;
@@ -1365,6 +1393,9 @@ fd_tvu_main_setup( fd_runtime_ctx_t *    runtime_ctx,
   }
 
   runtime_ctx->abort_on_mismatch = (uchar)args->abort_on_mismatch;
+
+  /* Native sBPF execution is opt-in */
+  fd_vm_jit_enable( args->vm_jit );
 }
 
 int
@@ -1384,6 +1415,10 @@ fd_tvu_parse_args( fd_runtime_args_t * args, int argc, char ** argv ) {
 
   args->blockstore_wksp_name =
       fd_env_strip_cmdline_cstr( &argc, &argv, "--blockstore-wksp", NULL, NULL );
+  args->blockstore_archive =
+      fd_env_strip_cmdline_cstr( &argc, &argv, "--blockstore-archive", NULL, NULL );
+  args->blockstore_archive_sz_gb =
+      fd_env_strip_cmdline_ulong( &argc, &argv, "--blockstore-archive-sz-gb", NULL, 64UL );
   args->funk_wksp_name = fd_env_strip_cmdline_cstr( &argc, &argv, "--funk-wksp", NULL, NULL );
   args->gossip_peer_addr =
       fd_env_strip_cmdline_cstr( &argc, &argv, "--gossip-peer-addr", NULL, ":1024" );
@@ -1425,6 +1460,7 @@ fd_tvu_parse_args( fd_runtime_args_t * args, int argc, char ** argv ) {
   args->retrace       = fd_env_strip_cmdline_int( &argc, &argv, "--retrace", NULL, 0 );
   args->abort_on_mismatch =
       (uchar)fd_env_strip_cmdline_int( &argc, &argv, "--abort-on-mismatch", NULL, 0 );
+  args->vm_jit           = fd_env_strip_cmdline_int  ( &argc, &argv, "--vm-jit", NULL, 0 );
   args->checkpt_freq     = fd_env_strip_cmdline_ulong( &argc, &argv, "--checkpt-freq", NULL, ULONG_MAX );
   args->checkpt_path     = fd_env_strip_cmdline_cstr( &argc, &argv, "--checkpt-path", NULL, NULL );
   args->checkpt_mismatch = fd_env_strip_cmdline_int ( &argc, &argv, "--checkpt-mismatch", NULL, 0 );
@@ -1466,6 +1502,13 @@ fd_tvu_main_teardown( fd_runtime_ctx_t * tvu_args, fd_replay_t * replay ) {
     fd_fork_frontier_delete( fd_fork_frontier_leave( replay->forks->frontier ) );
     fd_fork_pool_delete( fd_fork_pool_leave( replay->forks->pool ) );
 
+    if( replay->archive ) {
+      fd_blockstore_archive_detach( replay->blockstore );
+      fd_blockstore_archive_close( replay->archive );
+      fd_wksp_free_laddr( fd_blockstore_archive_delete( fd_blockstore_archive_leave( replay->archive ) ) );
+      replay->archive = NULL;
+    }
+
     /* TODO @yunzhang: I added this and hopefully this is
      * the right place toclose the shred log file */
     if( replay->shred_cap != NULL) {
@@ -3,5 +3,7 @@ ifdef FD_HAS_INT128
 $(call add-hdrs,fd_gossip.h)
 $(call add-objs,fd_gossip,fd_flamenco)
 $(call make-bin,fd_gossip_spy,fd_gossip_spy,fd_flamenco fd_ballet fd_funk fd_util)
+$(call make-unit-test,test_gossip_pull_req,test_gossip_pull_req,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_gossip_pull_req)
 endif
 endif
@@ -23,6 +23,15 @@
 #define FD_ACTIVE_KEY_MAX (1<<8)
 /* Max number of values that can be remembered */
 #define FD_VALUE_KEY_MAX (1<<16)
+/* Log2 of the number of hash prefix partitions of the value table */
+#define FD_VALUE_PART_LG_CNT 12
+/* Log2 of the number of independently locked shards of the value table */
+#define FD_VALUE_SHARD_LG_CNT 3
+#define FD_VALUE_SHARD_CNT (1UL<<FD_VALUE_SHARD_LG_CNT)
+/* Max number of values in a shard */
+#define FD_VALUE_SHARD_KEY_MAX (FD_VALUE_KEY_MAX>>FD_VALUE_SHARD_LG_CNT)
+/* Number of hash prefix partitions in a shard */
+#define FD_VALUE_SHARD_PART_CNT (1UL<<(FD_VALUE_PART_LG_CNT-FD_VALUE_SHARD_LG_CNT))
 /* Max number of pending timed events */
 #define FD_PENDING_MAX (1<<9)
 /* Number of bloom filter bits in an outgoing pull request packet */
@@ -31,6 +40,9 @@
 #define FD_BLOOM_MAX_KEYS 32U
 /* Max number of packets in an outgoing pull request batch */
 #define FD_BLOOM_MAX_PACKETS 32U
+/* Max number of pull response packets built under a shard lock before
+   they are sent */
+#define FD_PULL_RESP_OUTBOX_MAX 16U
 /* Number of bloom bits in a push prune filter */
 #define FD_PRUNE_NUM_BITS (512U*8U) /* 0.5 Kbyte */
 /* Number of bloom keys in a push prune filter */
@@ -158,6 +170,34 @@ typedef struct fd_value_elem fd_value_elem_t;
 #define MAP_T        fd_value_elem_t
 #include "../../util/tmpl/fd_map_giant.c"
 
+/* Value index entry. Indexed the same as the value table, and holds
+   the fields needed to run a pull filter against a value so that
+   servicing a pull request only touches the full value on a miss. The
+   entries of each hash prefix partition form a doubly linked list. */
+struct fd_value_idx {
+    fd_hash_t key;
+    ulong wallclock;
+    ulong prev;
+    ulong next;
+};
+typedef struct fd_value_idx fd_value_idx_t;
+
+/* A shard of the value table. Values are assigned to shards by the
+   high bits of their hash, so a shard is a contiguous range of hash
+   prefix partitions. Each shard has its own lock so that values can
+   be received and pull requests serviced on several threads at
+   once. */
+struct __attribute__((aligned(128UL))) fd_value_shard {
+    /* Concurrency lock */
+    volatile ulong lock;
+    /* Table of values in the shard */
+    fd_value_elem_t * values;
+    /* Index of the values, and the heads of the partition lists */
+    fd_value_idx_t * value_idx;
+    ulong * value_parts;
+};
+typedef struct fd_value_shard fd_value_shard_t;
+
 /* Weights table element. This table stores the weight for each peer
    (determined by stake). */
 struct fd_weights_elem {
@@ -273,8 +313,14 @@ struct fd_gossip {
     fd_gossip_peer_addr_t * inactives;
     ulong inactives_cnt;
 #define INACTIVES_MAX 1024U
-    /* Table of crds values that we have received in the last 5 minutes, keys by hash */
-    fd_value_elem_t * values;
+    /* Table of crds values that we have received in the last 5
+       minutes, keys by hash, sharded by the high bits of the hash. The
+       values of a shard are further indexed by hash prefix partition,
+       mirroring the mask/mask_bits partitioning of pull filters so
+       that a pull request only visits its own part of the table. Lock
+       order is the global lock before a shard lock, and at most one
+       shard is locked at a time. */
+    fd_value_shard_t value_shards[FD_VALUE_SHARD_CNT];
     /* The last timestamp hash that we pushed our own contact info */
     long last_contact_time;
     fd_hash_t last_contact_info_key;
@@ -313,6 +359,79 @@ struct fd_gossip {
     fd_gossip_peer_addr_t entrypoints[16];
 };
 
+/* Hash prefix partition of a value */
+static inline ulong
+fd_value_part_idx( fd_hash_t const * hash ) {
+  return hash->ul[0] >> (64U - FD_VALUE_PART_LG_CNT);
+}
+
+/* Shard holding a value */
+static inline fd_value_shard_t *
+fd_gossip_value_shard( fd_gossip_t * glob, fd_hash_t const * hash ) {
+  return glob->value_shards + (hash->ul[0] >> (64U - FD_VALUE_SHARD_LG_CNT));
+}
+
+static void
+fd_value_shard_lock( fd_value_shard_t * shard ) {
+  for(;;) {
+    if( FD_LIKELY( !FD_ATOMIC_CAS( &shard->lock, 0UL, 1UL) ) ) break;
+    FD_SPIN_PAUSE();
+  }
+  FD_COMPILER_MFENCE();
+}
+
+static void
+fd_value_shard_unlock( fd_value_shard_t * shard ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( shard->lock ) = 0UL;
+}
+
+/* Insert a new value into a shard and its index. The caller holds the
+   shard lock and promises the key is not in the shard and the shard is
+   not full. */
+static fd_value_elem_t *
+fd_gossip_value_insert( fd_value_shard_t * shard, fd_hash_t const * key, ulong wallclock ) {
+  fd_value_elem_t * ele = fd_value_table_insert(shard->values, key);
+  ele->wallclock = wallclock;
+  ulong idx = (ulong)(ele - shard->values);
+  fd_value_idx_t * ent = shard->value_idx + idx;
+  fd_hash_copy(&ent->key, key);
+  ent->wallclock = wallclock;
+  ulong * head = shard->value_parts + (fd_value_part_idx(key) & (FD_VALUE_SHARD_PART_CNT-1UL));
+  ent->prev = ULONG_MAX;
+  ent->next = *head;
+  if (*head != ULONG_MAX)
+    shard->value_idx[*head].prev = idx;
+  *head = idx;
+  return ele;
+}
+
+/* Remove a value from a shard and its index. The caller holds the
+   shard lock. */
+static void
+fd_gossip_value_remove_locked( fd_value_shard_t * shard, fd_hash_t const * key ) {
+  fd_value_elem_t * ele = fd_value_table_query(shard->values, key, NULL);
+  if (ele == NULL)
+    return;
+  fd_value_idx_t * ent = shard->value_idx + (ulong)(ele - shard->values);
+  if (ent->prev == ULONG_MAX)
+    shard->value_parts[fd_value_part_idx(key) & (FD_VALUE_SHARD_PART_CNT-1UL)] = ent->next;
+  else
+    shard->value_idx[ent->prev].next = ent->next;
+  if (ent->next != ULONG_MAX)
+    shard->value_idx[ent->next].prev = ent->prev;
+  fd_value_table_remove( shard->values, key );
+}
+
+/* Remove a value from the table */
+static void
+fd_gossip_value_remove( fd_gossip_t * glob, fd_hash_t const * key ) {
+  fd_value_shard_t * shard = fd_gossip_value_shard(glob, key);
+  fd_value_shard_lock(shard);
+  fd_gossip_value_remove_locked(shard, key);
+  fd_value_shard_unlock(shard);
+}
+
 ulong
 fd_gossip_align ( void ) { return 128UL; }
 
@@ -324,7 +443,11 @@ fd_gossip_footprint( void ) {
   l = FD_LAYOUT_APPEND( l, fd_active_table_align(), fd_active_table_footprint(FD_ACTIVE_KEY_MAX) );
   l = FD_LAYOUT_APPEND( l, alignof(fd_gossip_peer_addr_t), INACTIVES_MAX*sizeof(fd_gossip_peer_addr_t) );
   l = FD_LAYOUT_APPEND( l, alignof(fd_hash_t), FD_NEED_PUSH_MAX*sizeof(fd_hash_t) );
-  l = FD_LAYOUT_APPEND( l, fd_value_table_align(), fd_value_table_footprint(FD_VALUE_KEY_MAX) );
+  for (ulong i = 0; i < FD_VALUE_SHARD_CNT; ++i) {
+    l = FD_LAYOUT_APPEND( l, fd_value_table_align(), fd_value_table_footprint(FD_VALUE_SHARD_KEY_MAX) );
+    l = FD_LAYOUT_APPEND( l, alignof(fd_value_idx_t), FD_VALUE_SHARD_KEY_MAX*sizeof(fd_value_idx_t) );
+    l = FD_LAYOUT_APPEND( l, alignof(ulong), FD_VALUE_SHARD_PART_CNT*sizeof(ulong) );
+  }
   l = FD_LAYOUT_APPEND( l, fd_pending_pool_align(), fd_pending_pool_footprint(FD_PENDING_MAX) );
   l = FD_LAYOUT_APPEND( l, fd_pending_heap_align(), fd_pending_heap_footprint(FD_PENDING_MAX) );
   l = FD_LAYOUT_APPEND( l, fd_stats_table_align(), fd_stats_table_footprint(FD_STATS_KEY_MAX) );
@@ -350,8 +473,15 @@ fd_gossip_new ( void * shmem, ulong seed ) {
   glob->inactives = (fd_gossip_peer_addr_t*)FD_SCRATCH_ALLOC_APPEND(l, alignof(fd_gossip_peer_addr_t), INACTIVES_MAX*sizeof(fd_gossip_peer_addr_t));
   glob->need_push = (fd_hash_t*)FD_SCRATCH_ALLOC_APPEND(l, alignof(fd_hash_t), FD_NEED_PUSH_MAX*sizeof(fd_hash_t));
 
-  shm = FD_SCRATCH_ALLOC_APPEND(l, fd_value_table_align(), fd_value_table_footprint(FD_VALUE_KEY_MAX));
-  glob->values = fd_value_table_join(fd_value_table_new(shm, FD_VALUE_KEY_MAX, seed));
+  for (ulong i = 0; i < FD_VALUE_SHARD_CNT; ++i) {
+    fd_value_shard_t * shard = glob->value_shards + i;
+    shm = FD_SCRATCH_ALLOC_APPEND(l, fd_value_table_align(), fd_value_table_footprint(FD_VALUE_SHARD_KEY_MAX));
+    shard->values = fd_value_table_join(fd_value_table_new(shm, FD_VALUE_SHARD_KEY_MAX, seed));
+    shard->value_idx = (fd_value_idx_t*)FD_SCRATCH_ALLOC_APPEND(l, alignof(fd_value_idx_t), FD_VALUE_SHARD_KEY_MAX*sizeof(fd_value_idx_t));
+    shard->value_parts = (ulong*)FD_SCRATCH_ALLOC_APPEND(l, alignof(ulong), FD_VALUE_SHARD_PART_CNT*sizeof(ulong));
+    for (ulong j = 0; j < FD_VALUE_SHARD_PART_CNT; ++j)
+      shard->value_parts[j] = ULONG_MAX;
+  }
 
   glob->last_contact_time = 0;
   shm = FD_SCRATCH_ALLOC_APPEND(l, fd_pending_pool_align(), fd_pending_pool_footprint(FD_PENDING_MAX));
@@ -389,7 +519,8 @@ fd_gossip_delete ( void * shmap ) {
   fd_peer_table_delete( fd_peer_table_leave( glob->peers ) );
   fd_active_table_delete( fd_active_table_leave( glob->actives ) );
 
-  fd_value_table_delete( fd_value_table_leave( glob->values ) );
+  for (ulong i = 0; i < FD_VALUE_SHARD_CNT; ++i)
+    fd_value_table_delete( fd_value_table_leave( glob->value_shards[i].values ) );
   fd_pending_pool_delete( fd_pending_pool_leave( glob->event_pool ) );
   fd_pending_heap_delete( fd_pending_heap_leave( glob->event_heap ) );
   fd_stats_table_delete( fd_stats_table_leave( glob->stats ) );
@@ -555,13 +686,21 @@ fd_gossip_add_pending( fd_gossip_t * glob, long when ) {
   return ev;
 }
 
-/* Send raw data as a UDP packet to an address */
+/* Send raw data as a UDP packet to an address. The caller does not
+   hold the global lock. */
 static void
-fd_gossip_send_raw( fd_gossip_t * glob, const fd_gossip_peer_addr_t * dest, void * data, size_t sz) {
+fd_gossip_send_packet( fd_gossip_t * glob, const fd_gossip_peer_addr_t * dest, void * data, size_t sz) {
   if ( sz > PACKET_DATA_SIZE )
     FD_LOG_ERR(("sending oversized packet, size=%lu", sz));
-  fd_gossip_unlock( glob );
   (*glob->send_fun)(data, sz, dest, glob->send_arg);
+}
+
+/* Send raw data as a UDP packet to an address. The caller holds the
+   global lock, which is released while sending. */
+static void
+fd_gossip_send_raw( fd_gossip_t * glob, const fd_gossip_peer_addr_t * dest, void * data, size_t sz) {
+  fd_gossip_unlock( glob );
+  fd_gossip_send_packet( glob, dest, data, sz );
   fd_gossip_lock( glob );
 }
 
@@ -819,7 +958,13 @@ fd_gossip_random_pull( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
     return;
 
   /* Compute the number of packets needed for all the bloom filter parts */
-  ulong nitems = fd_value_table_key_cnt(glob->values);
+  ulong nitems = 0;
+  for (ulong i = 0; i < FD_VALUE_SHARD_CNT; ++i) {
+    fd_value_shard_t * shard = glob->value_shards + i;
+    fd_value_shard_lock(shard);
+    nitems += fd_value_table_key_cnt(shard->values);
+    fd_value_shard_unlock(shard);
+  }
   ulong nkeys = 1;
   ulong npackets = 1;
   uint nmaskbits = 0;
@@ -854,14 +999,17 @@ fd_gossip_random_pull( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
   ulong bits[CHUNKSIZE * FD_BLOOM_MAX_PACKETS];
   fd_memset(bits, 0, CHUNKSIZE*8U*npackets);
   ulong expire = FD_NANOSEC_TO_MILLI(glob->now) - FD_GOSSIP_VALUE_EXPIRE;
-  for( fd_value_table_iter_t iter = fd_value_table_iter_init( glob->values );
-       !fd_value_table_iter_done( glob->values, iter );
-       iter = fd_value_table_iter_next( glob->values, iter ) ) {
-    fd_value_elem_t * ele = fd_value_table_iter_ele( glob->values, iter );
+  for (ulong k = 0; k < FD_VALUE_SHARD_CNT; ++k) {
+  fd_value_shard_t * shard = glob->value_shards + k;
+  fd_value_shard_lock(shard);
+  for( fd_value_table_iter_t iter = fd_value_table_iter_init( shard->values );
+       !fd_value_table_iter_done( shard->values, iter );
+       iter = fd_value_table_iter_next( shard->values, iter ) ) {
+    fd_value_elem_t * ele = fd_value_table_iter_ele( shard->values, iter );
     fd_hash_t * hash = &(ele->key);
     /* Purge expired values */
     if (ele->wallclock < expire) {
-      fd_value_table_remove( glob->values, hash );
+      fd_gossip_value_remove_locked( shard, hash );
       continue;
     }
     /* Choose which filter packet based on the high bits in the hash */
@@ -877,6 +1025,8 @@ fd_gossip_random_pull( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
       }
     }
   }
+  fd_value_shard_unlock(shard);
+  }
 
   /* Assemble the packets */
   fd_gossip_msg_t gmsg;
@@ -900,7 +1050,7 @@ fd_gossip_random_pull( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
 
   for (uint i = 0; i < npackets; ++i) {
     /* Update the filter mask specific part */
-    filter->mask = (nmaskbits == 0 ? ~0UL : ((i << (64U - nmaskbits)) | (~0UL >> nmaskbits)));
+    filter->mask = (nmaskbits == 0 ? ~0UL : (((ulong)i << (64U - nmaskbits)) | (~0UL >> nmaskbits)));
     filter->filter.num_bits_set = num_bits_set[i];
     bitvec->bits.vec = bits + (i*CHUNKSIZE);
     fd_gossip_send(glob, &ele->key, &gmsg);
@@ -1015,10 +1165,20 @@ fd_gossip_random_ping( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
   fd_gossip_make_ping(glob, &arg2);
 }
 
-/* Process an incoming crds value */
-static void
-fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_pubkey_t * pubkey, fd_crds_value_t* crd) {
-  /* Verify the signature */
+/* An incoming crds value waiting for its signature to be checked */
+struct fd_gossip_verify_elem {
+    fd_crds_value_t * crd;
+    fd_pubkey_t * pubkey;
+    ulong wallclock;
+    ulong datalen;
+    uchar data[PACKET_DATA_SIZE]; /* Signed (serialized) crds data */
+};
+typedef struct fd_gossip_verify_elem fd_gossip_verify_elem_t;
+
+/* Work out who signed an incoming crds value and serialize the signed
+   data. Returns nonzero if the value should be dropped. */
+static int
+fd_gossip_prepare_crds_value(fd_gossip_t * glob, fd_pubkey_t * pubkey, fd_crds_value_t* crd, fd_gossip_verify_elem_t * elem) {
   ulong wallclock;
   switch (crd->data.discriminant) {
   case fd_crds_data_enum_contact_info_v1:
@@ -1071,26 +1231,28 @@ fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
   }
   if (memcmp(pubkey->uc, glob->public_key->uc, 32U) == 0)
     /* Ignore my own messages */
-    return;
-  uchar buf[PACKET_DATA_SIZE];
+    return -1;
   fd_bincode_encode_ctx_t ctx;
-  ctx.data = buf;
-  ctx.dataend = buf + PACKET_DATA_SIZE;
+  ctx.data = elem->data;
+  ctx.dataend = elem->data + PACKET_DATA_SIZE;
   if ( fd_crds_data_encode( &crd->data, &ctx ) ) {
     FD_LOG_ERR(("fd_crds_data_encode failed"));
-    return;
-  }
-  fd_sha512_t sha[1];
-  if (fd_ed25519_verify( /* msg */ buf,
-                         /* sz  */ (ulong)((uchar*)ctx.data - buf),
-                         /* sig */ crd->signature.uc,
-                         /* public_key */ pubkey->uc,
-                         sha )) {
-    FD_LOG_DEBUG(("received crds_value with invalid signature"));
-    return;
+    return -1;
   }
+  elem->crd = crd;
+  elem->pubkey = pubkey;
+  elem->wallclock = wallclock;
+  elem->datalen = (ulong)((uchar*)ctx.data - elem->data);
+  return 0;
+}
 
+/* Process an incoming crds value whose signature has been verified.
+   The caller does not hold the global lock. */
+static void
+fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_pubkey_t * pubkey, ulong wallclock, fd_crds_value_t* crd) {
   /* Perform the value hash to get the value table key */
+  uchar buf[PACKET_DATA_SIZE];
+  fd_bincode_encode_ctx_t ctx;
   ctx.data = buf;
   ctx.dataend = buf + PACKET_DATA_SIZE;
   if ( fd_crds_value_encode( crd, &ctx ) ) {
@@ -1104,8 +1266,24 @@ fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
   fd_hash_t key;
   fd_sha256_fini( sha2, key.uc );
 
-  fd_value_elem_t * msg = fd_value_table_query(glob->values, &key, NULL);
-  if (msg != NULL) {
+  /* Store the value for later pushing/duplicate detection */
+  fd_value_shard_t * shard = fd_gossip_value_shard(glob, &key);
+  fd_value_shard_lock(shard);
+  fd_value_elem_t * msg = fd_value_table_query(shard->values, &key, NULL);
+  int dup = (msg != NULL);
+  int full = (!dup && fd_value_table_is_full(shard->values));
+  if (!dup && !full) {
+    msg = fd_gossip_value_insert(shard, &key, wallclock);
+    fd_hash_copy(&msg->origin, pubkey);
+
+    /* We store the serialized form for convenience */
+    fd_memcpy(msg->data, buf, datalen);
+    msg->datalen = datalen;
+  }
+  fd_value_shard_unlock(shard);
+
+  fd_gossip_lock( glob );
+  if (dup) {
     /* Already have this value */
     glob->recv_dup_cnt++;
     if (from != NULL) {
@@ -1132,22 +1310,16 @@ fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
         found_origin: ;
       }
     }
+    fd_gossip_unlock( glob );
     return;
   }
 
-  /* Store the value for later pushing/duplicate detection */
   glob->recv_nondup_cnt++;
-  if (fd_value_table_is_full(glob->values)) {
+  if (full) {
+    fd_gossip_unlock( glob );
     FD_LOG_DEBUG(("too many values"));
     return;
   }
-  msg = fd_value_table_insert(glob->values, &key);
-  msg->wallclock = wallclock;
-  fd_hash_copy(&msg->origin, pubkey);
-
-  /* We store the serialized form for convenience */
-  fd_memcpy(msg->data, buf, datalen);
-  msg->datalen = datalen;
 
   if (glob->need_push_cnt < FD_NEED_PUSH_MAX) {
     /* Remember that I need to push this value */
@@ -1193,7 +1365,50 @@ fd_gossip_recv_crds_value(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
   /* Deliver the data upstream */
   fd_gossip_unlock( glob );
   (*glob->deliver_fun)(&crd->data, glob->deliver_arg);
-  fd_gossip_lock( glob );
+}
+
+/* Process the crds values of a push message or pull response. The
+   signatures are checked a batch at a time, then the values with good
+   signatures are applied in their original order. The caller does not
+   hold the global lock, so signature checking runs in parallel when
+   packets are received on several threads. */
+static void
+fd_gossip_recv_crds_values(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_pubkey_t * pubkey, fd_crds_value_t * crds, ulong crds_len) {
+  fd_gossip_verify_elem_t elems[FD_ED25519_VERIFY_BATCH_MAX];
+  uchar const * msgs[FD_ED25519_VERIFY_BATCH_MAX];
+  ulong msg_szs[FD_ED25519_VERIFY_BATCH_MAX];
+  uchar const * sigs[FD_ED25519_VERIFY_BATCH_MAX];
+  uchar const * keys[FD_ED25519_VERIFY_BATCH_MAX];
+  int errs[FD_ED25519_VERIFY_BATCH_MAX];
+
+  ulong i = 0;
+  while (i < crds_len) {
+    /* Fill a batch */
+    ulong cnt = 0;
+    for ( ; i < crds_len && cnt < FD_ED25519_VERIFY_BATCH_MAX; ++i) {
+      fd_gossip_verify_elem_t * elem = elems + cnt;
+      if (fd_gossip_prepare_crds_value(glob, pubkey, crds + i, elem))
+        continue;
+      msgs[cnt] = elem->data;
+      msg_szs[cnt] = elem->datalen;
+      sigs[cnt] = elem->crd->signature.uc;
+      keys[cnt] = elem->pubkey->uc;
+      cnt++;
+    }
+    if (cnt == 0)
+      break;
+
+    /* Verify the signatures */
+    fd_ed25519_verify_batch(msgs, msg_szs, sigs, keys, errs, cnt);
+
+    for (ulong j = 0; j < cnt; ++j) {
+      if (errs[j]) {
+        FD_LOG_DEBUG(("received crds_value with invalid signature"));
+        continue;
+      }
+      fd_gossip_recv_crds_value(glob, from, elems[j].pubkey, elems[j].wallclock, elems[j].crd);
+    }
+  }
 }
 
 /* Handle a prune request from somebody else */
@@ -1274,16 +1489,10 @@ fd_gossip_push_updated_contact(fd_gossip_t * glob) {
 
   if (glob->last_contact_time != 0) {
     /* Remove the old contact value */
-    fd_value_elem_t * ele = fd_value_table_query(glob->values, &glob->last_contact_info_key, NULL);
-    if (ele != NULL) {
-      fd_value_table_remove( glob->values, &glob->last_contact_info_key );
-    }
+    fd_gossip_value_remove( glob, &glob->last_contact_info_key );
 
     /* Remove the old version value */
-    ele = fd_value_table_query(glob->values, &glob->last_contact_version_key, NULL);
-    if (ele != NULL) {
-      fd_value_table_remove( glob->values, &glob->last_contact_version_key );
-    }
+    fd_gossip_value_remove( glob, &glob->last_contact_version_key );
 
   }
 
@@ -1308,41 +1517,55 @@ fd_gossip_push_updated_contact(fd_gossip_t * glob) {
   }
 }
 
-/* Respond to a pull request */
+/* Respond to a pull request. The caller does not hold the global
+   lock. The value table is scanned one shard at a time, so requests
+   can be serviced on several threads at once. Response packets are
+   built in a local outbox while a shard is locked and only sent once
+   it is unlocked, so that a slow send_fun never stalls the receivers
+   of a shard, and send_fun may call back into gossip. */
 static void
 fd_gossip_handle_pull_req(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_gossip_pull_req_t * msg) {
+  fd_gossip_lock( glob );
   fd_active_elem_t * val = fd_active_table_query(glob->actives, from, NULL);
   if (val == NULL || val->pongtime == 0) {
     /* Ping new peers before responding to requests */
-    if (fd_pending_pool_free( glob->event_pool ) < 100U)
-      return;
-    fd_pending_event_arg_t arg2;
-    fd_gossip_peer_addr_copy(&arg2.key, from);
-    fd_gossip_make_ping(glob, &arg2);
+    if (fd_pending_pool_free( glob->event_pool ) >= 100U) {
+      fd_pending_event_arg_t arg2;
+      fd_gossip_peer_addr_copy(&arg2.key, from);
+      fd_gossip_make_ping(glob, &arg2);
+    }
+    fd_gossip_unlock( glob );
     return;
   }
 
+  /* Push an updated version of my contact info into values */
+  fd_gossip_push_updated_contact(glob);
+  fd_gossip_unlock( glob );
+
   /* Encode an empty pull response as a template */
   fd_gossip_msg_t gmsg;
   fd_gossip_msg_new_disc(&gmsg, fd_gossip_msg_enum_pull_resp);
   fd_gossip_pull_resp_t * pull_resp = &gmsg.inner.pull_resp;
   fd_hash_copy( &pull_resp->pubkey, glob->public_key );
 
-  uchar buf[PACKET_DATA_SIZE];
+  /* One extra packet holds the one being filled when the outbox is
+     full */
+  uchar outbox[FD_PULL_RESP_OUTBOX_MAX+1U][PACKET_DATA_SIZE];
   fd_bincode_encode_ctx_t ctx;
-  ctx.data = buf;
-  ctx.dataend = buf + PACKET_DATA_SIZE;
+  ctx.data = outbox[0];
+  ctx.dataend = outbox[0] + PACKET_DATA_SIZE;
   if ( fd_gossip_msg_encode( &gmsg, &ctx ) ) {
     FD_LOG_WARNING(("fd_gossip_msg_encode failed"));
     return;
   }
-  /* Reach into buffer to get the number of values */
-  uchar * newend = (uchar *)ctx.data;
+  /* Size of an empty response. The number of values is the last field. */
+  ulong hdr_sz = (ulong)((uchar *)ctx.data - outbox[0]);
+  ulong outbox_sz[FD_PULL_RESP_OUTBOX_MAX];
+  ulong outbox_cnt = 0;
+  uchar * buf = outbox[0];
+  uchar * newend = buf + hdr_sz;
   ulong * crds_len = (ulong *)(newend - sizeof(ulong));
 
-  /* Push an updated version of my contact info into values */
-  fd_gossip_push_updated_contact(glob);
-
   /* Apply the bloom filter to my table of values */
   fd_crds_filter_t * filter = &msg->filter;
   ulong nkeys = filter->filter.keys_len;
@@ -1353,15 +1576,35 @@ fd_gossip_handle_pull_req(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
   ulong hits = 0;
   ulong misses = 0;
   uint npackets = 0;
-  for( fd_value_table_iter_t iter = fd_value_table_iter_init( glob->values );
-       !fd_value_table_iter_done( glob->values, iter );
-       iter = fd_value_table_iter_next( glob->values, iter ) ) {
-    fd_value_elem_t * ele = fd_value_table_iter_ele( glob->values, iter );
-    fd_hash_t * hash = &(ele->key);
-    if (ele->wallclock < expire)
+  /* Only visit the partitions covered by the filter mask. When the
+     filter is finer than the partitioning, the remaining mask bits are
+     checked per value. */
+  uint nbits = fd_uint_min(filter->mask_bits, FD_VALUE_PART_LG_CNT);
+  ulong part_lo = (nbits == 0U ? 0UL : (filter->mask >> (64U - nbits)) << (FD_VALUE_PART_LG_CNT - nbits));
+  ulong part_hi = part_lo + (1UL << (FD_VALUE_PART_LG_CNT - nbits));
+  ulong part = part_lo;
+  /* Number of values of the partition already visited when the walk
+     was interrupted by a full outbox */
+  ulong skip = 0;
+  while (part < part_hi) {
+  /* Partitions are visited in order, so the shards are too */
+  ulong shard_idx = part / FD_VALUE_SHARD_PART_CNT;
+  fd_value_shard_t * shard = glob->value_shards + shard_idx;
+  int full = 0;
+  fd_value_shard_lock(shard);
+  for (; part < part_hi && part / FD_VALUE_SHARD_PART_CNT == shard_idx; ++part, skip = 0) {
+  ulong visited = 0;
+  for (ulong idx = shard->value_parts[part & (FD_VALUE_SHARD_PART_CNT-1UL)]; idx != ULONG_MAX; ++visited) {
+    fd_value_idx_t * ent = shard->value_idx + idx;
+    fd_value_elem_t * ele = shard->values + idx;
+    idx = ent->next;
+    if (visited < skip)
+      continue;
+    fd_hash_t * hash = &(ent->key);
+    if (ent->wallclock < expire)
       continue;
     /* Execute the bloom filter */
-    if (filter->mask_bits != 0U) {
+    if (filter->mask_bits > FD_VALUE_PART_LG_CNT) {
       ulong m = (~0UL >> filter->mask_bits);
       if ((hash->ul[0] | m) != filter->mask)
         continue;
@@ -1380,27 +1623,56 @@ fd_gossip_handle_pull_req(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
       hits++;
       continue;
     }
-    misses++;
     /* Add the value in already encoded form */
     if (newend + ele->datalen - buf > PACKET_DATA_SIZE) {
-      /* Packet is getting too large. Flush it */
-      ulong sz = (ulong)(newend - buf);
-      fd_gossip_send_raw(glob, from, buf, sz);
-      char tmp[100];
-      FD_LOG_DEBUG(("sent msg type %d to %s size=%lu", gmsg.discriminant, fd_gossip_addr_str(tmp, sizeof(tmp), from), sz));
-      ++npackets;
-      newend = (uchar *)ctx.data;
+      /* Packet is getting too large. Move on to the next one. */
+      outbox_sz[outbox_cnt++] = (ulong)(newend - buf);
+      buf = outbox[outbox_cnt];
+      fd_memcpy(buf, outbox[0], hdr_sz);
+      newend = buf + hdr_sz;
+      crds_len = (ulong *)(newend - sizeof(ulong));
       *crds_len = 0;
+      if (outbox_cnt == FD_PULL_RESP_OUTBOX_MAX) {
+        /* Send what we have and pick up from this value. Values that
+           come and go in the meantime may be skipped or sent twice,
+           which the requester copes with. */
+        skip = visited;
+        full = 1;
+        break;
+      }
     }
+    misses++;
     fd_memcpy(newend, ele->data, ele->datalen);
     newend += ele->datalen;
     (*crds_len)++;
   }
+  if (full)
+    break;
+  }
+  fd_value_shard_unlock(shard);
+
+  /* Flush the finished packets, and carry the one being filled over to
+     the next shard */
+  for (ulong i = 0; i < outbox_cnt; ++i) {
+    fd_gossip_send_packet(glob, from, outbox[i], outbox_sz[i]);
+    char tmp[100];
+    FD_LOG_DEBUG(("sent msg type %d to %s size=%lu", gmsg.discriminant, fd_gossip_addr_str(tmp, sizeof(tmp), from), outbox_sz[i]));
+    ++npackets;
+  }
+  if (outbox_cnt) {
+    ulong sz = (ulong)(newend - buf);
+    fd_memcpy(outbox[0], buf, sz);
+    buf = outbox[0];
+    newend = buf + sz;
+    crds_len = (ulong *)(buf + hdr_sz - sizeof(ulong));
+    outbox_cnt = 0;
+  }
+  }
 
   /* Flush final packet */
-  if (newend > (uchar *)ctx.data) {
+  if (*crds_len) {
     ulong sz = (ulong)(newend - buf);
-    fd_gossip_send_raw(glob, from, buf, sz);
+    fd_gossip_send_packet(glob, from, buf, sz);
     char tmp[100];
     FD_LOG_DEBUG(("sent msg type %d to %s size=%lu", gmsg.discriminant, fd_gossip_addr_str(tmp, sizeof(tmp), from), sz));
     ++npackets;
@@ -1410,7 +1682,8 @@ fd_gossip_handle_pull_req(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from
     FD_LOG_DEBUG(("responded to pull request with %lu values in %u packets (%lu filtered out)", misses, npackets, hits));
 }
 
-/* Handle any gossip message */
+/* Handle any gossip message. The caller does not hold the global
+   lock. */
 static void
 fd_gossip_recv(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_gossip_msg_t * gmsg) {
   switch (gmsg->discriminant) {
@@ -1419,24 +1692,28 @@ fd_gossip_recv(fd_gossip_t * glob, const fd_gossip_peer_addr_t * from, fd_gossip
     break;
   case fd_gossip_msg_enum_pull_resp: {
     fd_gossip_pull_resp_t * pull_resp = &gmsg->inner.pull_resp;
-    for (ulong i = 0; i < pull_resp->crds_len; ++i)
-      fd_gossip_recv_crds_value(glob, NULL, &pull_resp->pubkey, pull_resp->crds + i);
+    fd_gossip_recv_crds_values(glob, NULL, &pull_resp->pubkey, pull_resp->crds, pull_resp->crds_len);
     break;
   }
   case fd_gossip_msg_enum_push_msg: {
     fd_gossip_push_msg_t * push_msg = &gmsg->inner.push_msg;
-    for (ulong i = 0; i < push_msg->crds_len; ++i)
-      fd_gossip_recv_crds_value(glob, from, &push_msg->pubkey, push_msg->crds + i);
+    fd_gossip_recv_crds_values(glob, from, &push_msg->pubkey, push_msg->crds, push_msg->crds_len);
     break;
   }
   case fd_gossip_msg_enum_prune_msg:
+    fd_gossip_lock( glob );
     fd_gossip_handle_prune(glob, from, &gmsg->inner.prune_msg);
+    fd_gossip_unlock( glob );
     break;
   case fd_gossip_msg_enum_ping:
+    fd_gossip_lock( glob );
     fd_gossip_handle_ping(glob, from, &gmsg->inner.ping);
+    fd_gossip_unlock( glob );
     break;
   case fd_gossip_msg_enum_pong:
+    fd_gossip_lock( glob );
     fd_gossip_handle_pong(glob, from, &gmsg->inner.pong);
+    fd_gossip_unlock( glob );
     break;
   }
 }
@@ -1559,8 +1836,20 @@ fd_gossip_push( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
     fd_hash_t * h = glob->need_push + ((glob->need_push_head++) & (FD_NEED_PUSH_MAX-1));
     glob->need_push_cnt--;
 
-    fd_value_elem_t * msg = fd_value_table_query(glob->values, h, NULL);
-    if (msg == NULL || msg->wallclock < expire)
+    /* Copy the value out of its shard since the global lock is
+       released while sending */
+    fd_value_elem_t msg[1];
+    fd_value_shard_t * shard = fd_gossip_value_shard(glob, h);
+    fd_value_shard_lock(shard);
+    fd_value_elem_t * ele = fd_value_table_query(shard->values, h, NULL);
+    int skip = (ele == NULL || ele->wallclock < expire);
+    if (!skip) {
+      fd_hash_copy(&msg->origin, &ele->origin);
+      fd_memcpy(msg->data, ele->data, ele->datalen);
+      msg->datalen = ele->datalen;
+    }
+    fd_value_shard_unlock(shard);
+    if (skip)
       continue;
 
     /* Iterate across push states */
@@ -1646,22 +1935,26 @@ fd_gossip_push_value_nolock( fd_gossip_t * glob, fd_crds_data_t * data, fd_hash_
     fd_hash_copy( key_opt, &key );
 
   /* Store the value for later pushing/duplicate detection */
-  fd_value_elem_t * msg = fd_value_table_query(glob->values, &key, NULL);
+  fd_value_shard_t * shard = fd_gossip_value_shard(glob, &key);
+  fd_value_shard_lock(shard);
+  fd_value_elem_t * msg = fd_value_table_query(shard->values, &key, NULL);
   if (msg != NULL) {
     /* Already have this value, which is strange! */
+    fd_value_shard_unlock(shard);
     return -1;
   }
-  if (fd_value_table_is_full(glob->values)) {
+  if (fd_value_table_is_full(shard->values)) {
+    fd_value_shard_unlock(shard);
     FD_LOG_DEBUG(("too many values"));
     return -1;
   }
-  msg = fd_value_table_insert(glob->values, &key);
-  msg->wallclock = FD_NANOSEC_TO_MILLI(glob->now); /* convert to ms */
+  msg = fd_gossip_value_insert(shard, &key, FD_NANOSEC_TO_MILLI(glob->now)); /* convert to ms */
   fd_hash_copy(&msg->origin, glob->public_key);
 
   /* We store the serialized form for convenience */
   fd_memcpy(msg->data, buf, datalen);
   msg->datalen = datalen;
+  fd_value_shard_unlock(shard);
 
   if (glob->need_push_cnt < FD_NEED_PUSH_MAX) {
     /* Remember that I need to push this value */
@@ -1763,11 +2056,12 @@ fd_gossip_log_stats( fd_gossip_t * glob, fd_pending_event_arg_t * arg ) {
     ev->fun = fd_gossip_log_stats;
   }
 
-  if( glob->recv_pkt_cnt == 0 )
+  /* Packets are counted outside the lock */
+  ulong recv_pkt_cnt = FD_ATOMIC_XCHG( &glob->recv_pkt_cnt, 0UL );
+  if( recv_pkt_cnt == 0 )
     FD_LOG_WARNING(("received no gossip packets!!"));
   else
-    FD_LOG_NOTICE(("received %lu packets", glob->recv_pkt_cnt));
-  glob->recv_pkt_cnt = 0;
+    FD_LOG_NOTICE(("received %lu packets", recv_pkt_cnt));
   FD_LOG_NOTICE(("received %lu dup values and %lu new", glob->recv_dup_cnt, glob->recv_nondup_cnt));
   glob->recv_dup_cnt = glob->recv_nondup_cnt = 0;
   FD_LOG_NOTICE(("pushed %lu values and filtered %lu", glob->push_cnt, glob->not_push_cnt));
@@ -1856,9 +2150,8 @@ fd_gossip_continue( fd_gossip_t * glob ) {
 /* Pass a raw gossip packet into the protocol. msg_name is the unix socket address of the sender */
 int
 fd_gossip_recv_packet( fd_gossip_t * glob, uchar const * msg, ulong msglen, fd_gossip_peer_addr_t const * from ) {
-  fd_gossip_lock( glob );
   FD_SCRATCH_SCOPE_BEGIN {
-    glob->recv_pkt_cnt++;
+    FD_ATOMIC_FETCH_AND_ADD( &glob->recv_pkt_cnt, 1UL );
     /* Deserialize the message */
     fd_gossip_msg_t gmsg;
     fd_bincode_decode_ctx_t ctx;
@@ -1867,12 +2160,10 @@ fd_gossip_recv_packet( fd_gossip_t * glob, uchar const * msg, ulong msglen, fd_g
     ctx.valloc  = fd_scratch_virtual();
     if (fd_gossip_msg_decode(&gmsg, &ctx)) {
       FD_LOG_WARNING(("corrupt gossip message"));
-      fd_gossip_unlock( glob );
       return -1;
     }
     if (ctx.data != ctx.dataend) {
       FD_LOG_WARNING(("corrupt gossip message"));
-      fd_gossip_unlock( glob );
       return -1;
     }
 
@@ -1880,8 +2171,6 @@ fd_gossip_recv_packet( fd_gossip_t * glob, uchar const * msg, ulong msglen, fd_g
 
     FD_LOG_DEBUG(("recv msg type %d from %s", gmsg.discriminant, fd_gossip_addr_str(tmp, sizeof(tmp), from)));
     fd_gossip_recv(glob, from, &gmsg);
-
-    fd_gossip_unlock( glob );
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
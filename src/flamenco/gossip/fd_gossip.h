@@ -101,7 +101,10 @@ int fd_gossip_start( fd_gossip_t * glob );
  * called inside the main spin loop. calling settime first is recommended. */
 int fd_gossip_continue( fd_gossip_t * glob );
 
-/* Pass a raw gossip packet into the protocol. addr is the address of the sender */
+/* Pass a raw gossip packet into the protocol. addr is the address of the sender.
+ * May be called from several threads at once (each with its own scratch
+ * space), in which case the deliver and send callbacks can also be
+ * invoked concurrently. */
 int fd_gossip_recv_packet( fd_gossip_t * glob, uchar const * msg, ulong msglen, fd_gossip_peer_addr_t const * addr );
 
 const char * fd_gossip_addr_str( char * dst, ulong dstlen, fd_gossip_peer_addr_t const * src );
@@ -0,0 +1,362 @@
+/* Test and bench for servicing gossip pull requests.  Pull requests
+   are recorded from the gossip instance's own pull request generator
+   (or read from a pcap of captured gossip traffic with --pcap) and
+   replayed against a value table that has since grown, checking each
+   response against a brute force scan of the table.  The bench is
+   repeated with the requests spread over all tiles, and once more
+   with a send callback that calls back into gossip. */
+
+#include "fd_gossip.c"
+#include "../../util/net/fd_pcap.h"
+#include <stdlib.h>
+
+#define REQ_MAX (1024UL)
+
+static uchar req_buf[ REQ_MAX ][ PACKET_DATA_SIZE ];
+static ulong req_sz [ REQ_MAX ];
+static ulong req_cnt;
+
+static int   recording;
+static ulong resp_pkt_cnt;
+static ulong resp_val_cnt;
+
+/* Set while responses are checked on a single tile, when no shard may
+   be locked during a send */
+static fd_gossip_t * unlocked_glob;
+
+/* Number of values the send callback may still push back into gossip */
+static ulong reenter_cnt;
+static ulong reenter_token;
+
+static void
+push_values( fd_gossip_t * glob,
+             ulong         cnt,
+             ulong         token );
+
+static void
+test_send( uchar const *                 msg,
+           size_t                        msglen,
+           fd_gossip_peer_addr_t const * addr,
+           void *                        arg ) {
+  (void)addr;
+  if( recording ) {
+    if( req_cnt<REQ_MAX ) {
+      fd_memcpy( req_buf[ req_cnt ], msg, msglen );
+      req_sz[ req_cnt++ ] = msglen;
+    }
+    return;
+  }
+  /* Pull responses are a 4 byte discriminant, the 32 byte responder
+     pubkey and the 8 byte value count */
+  FD_TEST( msglen>=44UL );
+  FD_TEST( FD_LOAD( uint, msg )==fd_gossip_msg_enum_pull_resp );
+  FD_ATOMIC_FETCH_AND_ADD( &resp_pkt_cnt, 1UL );
+  FD_ATOMIC_FETCH_AND_ADD( &resp_val_cnt, FD_LOAD( ulong, msg+36UL ) );
+  if( unlocked_glob ) {
+    for( ulong k=0UL; k<FD_VALUE_SHARD_CNT; k++ ) FD_TEST( !unlocked_glob->value_shards[ k ].lock );
+  }
+  /* Would deadlock if the responder still held the value's shard */
+  ulong cnt = FD_VOLATILE_CONST( reenter_cnt );
+  if( cnt && FD_ATOMIC_CAS( &reenter_cnt, cnt, cnt-1UL )==cnt ) {
+    push_values( (fd_gossip_t *)arg, 1UL, FD_ATOMIC_FETCH_AND_ADD( &reenter_token, 1UL ) );
+  }
+}
+
+static void
+test_sign( void *        ctx,
+           uchar *       sig,
+           uchar const * buffer,
+           ulong         len ) {
+  (void)ctx; (void)buffer; (void)len;
+  fd_memset( sig, 0, 64UL );
+}
+
+static void
+push_values( fd_gossip_t * glob,
+             ulong         cnt,
+             ulong         token ) {
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_crds_data_t crd;
+    fd_crds_data_new_disc( &crd, fd_crds_data_enum_node_instance );
+    crd.inner.node_instance.timestamp = 0UL;
+    crd.inner.node_instance.token     = token+i;
+    FD_TEST( !fd_gossip_push_value( glob, &crd, NULL ) );
+  }
+}
+
+static ulong
+table_cnt( fd_gossip_t * glob ) {
+  ulong cnt = 0UL;
+  for( ulong k=0UL; k<FD_VALUE_SHARD_CNT; k++ ) cnt += fd_value_table_key_cnt( glob->value_shards[ k ].values );
+  return cnt;
+}
+
+/* Number of values a pull request should get back, computed the slow
+   way by scanning the whole value table */
+
+static ulong
+ref_resp_cnt( fd_gossip_t *            glob,
+              fd_crds_filter_t const * filter ) {
+  ulong expire = FD_NANOSEC_TO_MILLI(glob->now) - FD_GOSSIP_PULL_TIMEOUT;
+  ulong cnt = 0UL;
+  for( ulong k=0UL; k<FD_VALUE_SHARD_CNT; k++ ) {
+  fd_value_elem_t * values = glob->value_shards[ k ].values;
+  for( fd_value_table_iter_t iter = fd_value_table_iter_init( values );
+       !fd_value_table_iter_done( values, iter );
+       iter = fd_value_table_iter_next( values, iter ) ) {
+    fd_value_elem_t * ele = fd_value_table_iter_ele( values, iter );
+    if( ele->wallclock<expire ) continue;
+    if( filter->mask_bits && (ele->key.ul[0] | (~0UL>>filter->mask_bits))!=filter->mask ) continue;
+    int miss = 0;
+    for( ulong i=0UL; i<filter->filter.keys_len; i++ ) {
+      ulong pos = fd_gossip_bloom_pos( &ele->key, filter->filter.keys[i], filter->filter.bits.len );
+      if( !( filter->filter.bits.bits.vec[ pos>>6 ] & (1UL<<(pos&63UL)) ) ) { miss = 1; break; }
+    }
+    cnt += (ulong)miss;
+  }
+  }
+  return cnt;
+}
+
+/* Replays a strided subset of the requests on a tile */
+
+static fd_gossip_t *           bench_glob;
+static fd_gossip_peer_addr_t * bench_peer;
+static ulong                   bench_iter_cnt;
+
+static int
+bench_tile( int     argc,
+            char ** argv ) {
+  ulong tile_idx = (ulong)(uint)argc;
+  ulong tile_cnt = (ulong)argv;
+  static uchar scratch_smem[ FD_TILE_MAX ][ 1UL<<16 ];
+         ulong scratch_fmem[ 4 ];
+  fd_scratch_attach( scratch_smem[ tile_idx ], scratch_fmem,
+                     sizeof(scratch_smem[ tile_idx ]), sizeof(scratch_fmem)/sizeof(ulong) );
+  for( ulong iter=0UL; iter<bench_iter_cnt; iter++ ) {
+    for( ulong i=tile_idx; i<req_cnt; i+=tile_cnt ) {
+      fd_gossip_recv_packet( bench_glob, req_buf[ i ], req_sz[ i ], bench_peer );
+    }
+  }
+  fd_scratch_detach( NULL );
+  return 0;
+}
+
+static void
+load_pcap( char const * path ) {
+  FILE * file = fopen( path, "rb" );
+  if( FD_UNLIKELY( !file ) ) FD_LOG_ERR(( "fopen(%s) failed", path ));
+  fd_pcap_iter_t * iter = fd_pcap_iter_new( file ); FD_TEST( iter );
+  for(;;) {
+    uchar hdr[ 2048UL ]; ulong hdr_sz = sizeof(hdr);
+    uchar pld[ 2048UL ]; ulong pld_sz = sizeof(pld);
+    long  ts;
+    if( !fd_pcap_iter_next_split( iter, hdr, &hdr_sz, pld, &pld_sz, &ts ) ) break;
+    if( req_cnt>=REQ_MAX ) break;
+    if( pld_sz<4UL || pld_sz>PACKET_DATA_SIZE || FD_LOAD( uint, pld )!=fd_gossip_msg_enum_pull_req ) continue;
+    fd_memcpy( req_buf[ req_cnt ], pld, pld_sz );
+    req_sz[ req_cnt++ ] = pld_sz;
+  }
+  FD_TEST( fd_pcap_iter_delete( iter )==file );
+  if( FD_UNLIKELY( fclose( file ) ) ) FD_LOG_ERR(( "fclose failed" ));
+  FD_LOG_NOTICE(( "loaded %lu pull requests from %s", req_cnt, path ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * pcap      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--pcap",      NULL, NULL    );
+  ulong        value_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--value-cnt", NULL, 49152UL );
+  ulong        new_cnt   = fd_env_strip_cmdline_ulong( &argc, &argv, "--new-cnt",   NULL, 4096UL  );
+  ulong        iter_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt",  NULL, 16UL    );
+  ulong        re_cnt    = fd_env_strip_cmdline_ulong( &argc, &argv, "--re-cnt",    NULL, 1024UL  );
+
+  /* Leave headroom for uneven filling of the value shards */
+  FD_TEST( value_cnt+new_cnt+re_cnt+2UL<=FD_VALUE_KEY_MAX-FD_VALUE_KEY_MAX/8UL );
+
+  static uchar scratch_smem[ 1UL<<20 ];
+         ulong scratch_fmem[ 4 ];
+  fd_scratch_attach( scratch_smem, scratch_fmem,
+                     sizeof(scratch_smem), sizeof(scratch_fmem)/sizeof(ulong) );
+
+  void * shmem = aligned_alloc( fd_gossip_align(), fd_gossip_footprint() ); FD_TEST( shmem );
+  fd_gossip_t * glob = fd_gossip_join( fd_gossip_new( shmem, 42UL ) );     FD_TEST( glob );
+
+  fd_pubkey_t public_key = { .ul = { 1UL, 2UL, 3UL, 4UL } };
+  fd_gossip_config_t config = {
+    .public_key    = &public_key,
+    .my_addr       = { .addr = 0x0100000a, .port = fd_ushort_bswap( 8001 ) },
+    .shred_version = 1,
+    .send_fun      = test_send,
+    .send_arg      = glob,
+    .sign_fun      = test_sign,
+  };
+  FD_TEST( !fd_gossip_set_config( glob, &config ) );
+  fd_gossip_settime( glob, (long)1e15 );
+
+  /* A peer that already answered our pings */
+
+  fd_gossip_peer_addr_t peer = { .addr = 0x0200000a, .port = fd_ushort_bswap( 8001 ) };
+  fd_active_elem_t * active = fd_active_table_insert( glob->actives, &peer );
+  fd_active_new_value( active );
+  active->pongtime = glob->now;
+  active->weight   = 1UL;
+
+  fd_gossip_lock( glob );
+  fd_gossip_push_updated_contact( glob );
+  fd_gossip_unlock( glob );
+  push_values( glob, value_cnt, 0UL );
+
+  if( pcap ) {
+    load_pcap( pcap );
+  } else {
+    recording = 1;
+    fd_gossip_lock( glob );
+    fd_gossip_random_pull( glob, NULL );
+    fd_gossip_unlock( glob );
+    recording = 0;
+    FD_LOG_NOTICE(( "recorded %lu pull requests for %lu values", req_cnt, table_cnt( glob ) ));
+  }
+  FD_TEST( req_cnt );
+
+  /* Values the requester has not seen yet */
+
+  push_values( glob, new_cnt, value_cnt );
+
+  /* Check every response against a full scan */
+
+  unlocked_glob = glob;
+  ulong tot_ref = 0UL;
+  for( ulong i=0UL; i<req_cnt; i++ ) {
+    FD_SCRATCH_SCOPE_BEGIN {
+      fd_gossip_msg_t gmsg;
+      fd_bincode_decode_ctx_t ctx = {
+        .data    = req_buf[ i ],
+        .dataend = req_buf[ i ] + req_sz[ i ],
+        .valloc  = fd_scratch_virtual()
+      };
+      FD_TEST( !fd_gossip_msg_decode( &gmsg, &ctx ) );
+      ulong ref = ref_resp_cnt( glob, &gmsg.inner.pull_req.filter );
+
+      resp_val_cnt = 0UL;
+      FD_TEST( !fd_gossip_recv_packet( glob, req_buf[ i ], req_sz[ i ], &peer ) );
+      FD_TEST( resp_val_cnt==ref );
+      tot_ref += ref;
+    } FD_SCRATCH_SCOPE_END;
+  }
+  FD_LOG_NOTICE(( "%lu values returned for %lu new values", tot_ref, new_cnt ));
+  /* Every recorded value is in the requester's bloom filters, so only
+     new values (less false positives) come back */
+  if( !pcap ) FD_TEST( tot_ref && tot_ref<=new_cnt );
+
+  /* A request whose filter has no bits set gets the whole table back,
+     which takes many trips through a full outbox */
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    fd_gossip_msg_t gmsg;
+    fd_bincode_decode_ctx_t ctx = {
+      .data    = req_buf[ 0 ],
+      .dataend = req_buf[ 0 ] + req_sz[ 0 ],
+      .valloc  = fd_scratch_virtual()
+    };
+    FD_TEST( !fd_gossip_msg_decode( &gmsg, &ctx ) );
+    fd_crds_filter_t * filter = &gmsg.inner.pull_req.filter;
+    fd_memset( filter->filter.bits.bits.vec, 0, filter->filter.bits.bits.vec_len*sizeof(ulong) );
+    filter->mask      = ~0UL;
+    filter->mask_bits = 0U;
+
+    uchar all_buf[ PACKET_DATA_SIZE ];
+    fd_bincode_encode_ctx_t ectx = { .data = all_buf, .dataend = all_buf+sizeof(all_buf) };
+    FD_TEST( !fd_gossip_msg_encode( &gmsg, &ectx ) );
+    ulong ref = ref_resp_cnt( glob, filter );
+    FD_TEST( ref==table_cnt( glob ) );
+
+    resp_pkt_cnt = 0UL;
+    resp_val_cnt = 0UL;
+    FD_TEST( !fd_gossip_recv_packet( glob, all_buf, (ulong)((uchar *)ectx.data-all_buf), &peer ) );
+    FD_TEST( resp_val_cnt==ref );
+    FD_TEST( resp_pkt_cnt>FD_PULL_RESP_OUTBOX_MAX );
+    FD_LOG_NOTICE(( "whole table request: %lu values in %lu packets", resp_val_cnt, resp_pkt_cnt ));
+  } FD_SCRATCH_SCOPE_END;
+  unlocked_glob = NULL;
+
+  /* Bench */
+
+  resp_pkt_cnt = 0UL;
+  resp_val_cnt = 0UL;
+  long dt = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    for( ulong i=0UL; i<req_cnt; i++ ) {
+      fd_gossip_recv_packet( glob, req_buf[ i ], req_sz[ i ], &peer );
+    }
+  }
+  dt += fd_log_wallclock();
+  ulong tot_req = iter_cnt*req_cnt;
+  FD_LOG_NOTICE(( "%lu pull requests against %lu values: %.3f us/request, %lu response packets",
+                  tot_req, table_cnt( glob ),
+                  (double)dt/(1e3*(double)tot_req), resp_pkt_cnt ));
+
+  /* Same requests on all tiles at once.  Every request gets the same
+     response as before. */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( tile_cnt>1UL ) {
+    bench_glob     = glob;
+    bench_peer     = &peer;
+    bench_iter_cnt = iter_cnt;
+    ulong ref_val_cnt = resp_val_cnt;
+    resp_pkt_cnt = 0UL;
+    resp_val_cnt = 0UL;
+    fd_tile_exec_t * exec[ FD_TILE_MAX ];
+    dt = -fd_log_wallclock();
+    for( ulong t=1UL; t<tile_cnt; t++ ) {
+      exec[ t ] = fd_tile_exec_new( t, bench_tile, (int)t, (char **)tile_cnt );
+      FD_TEST( exec[ t ] );
+    }
+    fd_scratch_detach( NULL );
+    bench_tile( 0, (char **)tile_cnt );
+    for( ulong t=1UL; t<tile_cnt; t++ ) FD_TEST( !fd_tile_exec_delete( exec[ t ], NULL ) );
+    dt += fd_log_wallclock();
+    fd_scratch_attach( scratch_smem, scratch_fmem,
+                       sizeof(scratch_smem), sizeof(scratch_fmem)/sizeof(ulong) );
+    FD_TEST( resp_val_cnt==ref_val_cnt );
+    FD_LOG_NOTICE(( "%lu pull requests on %lu tiles: %.3f us/request", tot_req, tile_cnt, (double)dt/(1e3*(double)tot_req) ));
+  }
+
+  /* Same again while the send callback pushes values of its own, as a
+     sending tile that also publishes would.  Responses only grow. */
+
+  ulong before_cnt = table_cnt( glob );
+  bench_glob     = glob;
+  bench_peer     = &peer;
+  bench_iter_cnt = 1UL;
+  ulong ref_val_cnt = resp_val_cnt / iter_cnt;
+  resp_val_cnt   = 0UL;
+  reenter_token  = value_cnt+new_cnt;
+  reenter_cnt    = re_cnt;
+  fd_tile_exec_t * exec[ FD_TILE_MAX ];
+  for( ulong t=1UL; t<tile_cnt; t++ ) {
+    exec[ t ] = fd_tile_exec_new( t, bench_tile, (int)t, (char **)tile_cnt );
+    FD_TEST( exec[ t ] );
+  }
+  fd_scratch_detach( NULL );
+  bench_tile( 0, (char **)tile_cnt );
+  for( ulong t=1UL; t<tile_cnt; t++ ) FD_TEST( !fd_tile_exec_delete( exec[ t ], NULL ) );
+  fd_scratch_attach( scratch_smem, scratch_fmem,
+                     sizeof(scratch_smem), sizeof(scratch_fmem)/sizeof(ulong) );
+  ulong pushed_cnt = re_cnt - reenter_cnt;
+  reenter_cnt = 0UL;
+  FD_TEST( table_cnt( glob )==before_cnt+pushed_cnt );
+  FD_TEST( resp_val_cnt>=ref_val_cnt );
+  FD_LOG_NOTICE(( "%lu values pushed from the send callback on %lu tiles", pushed_cnt, tile_cnt ));
+
+  FD_TEST( fd_gossip_delete( fd_gossip_leave( glob ) )==shmem );
+  free( shmem );
+  fd_scratch_detach( NULL );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
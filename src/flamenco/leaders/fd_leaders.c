@@ -79,8 +79,14 @@ fd_epoch_leaders_new( void                    * shmem,
   for( ulong i=0UL; i<pub_cnt; i++ ) _wsample = fd_wsample_new_add( _wsample, stakes[i].stake );
   fd_wsample_t * wsample = fd_wsample_join( fd_wsample_new_fini( _wsample ) );
 
-  /* Generate samples.  We need uints, so we can't use sample_many. */
-  for( ulong i=0UL; i<sched_cnt; i++ ) sched[ i ] = (uint)fd_wsample_sample( wsample );
+  /* Generate samples.  We need uints, so sample_many into a small
+     buffer of ulongs and narrow them. */
+  ulong idxs[ 64UL ];
+  for( ulong i=0UL; i<sched_cnt; i+=64UL ) {
+    ulong cnt = fd_ulong_min( sched_cnt-i, 64UL );
+    fd_wsample_sample_many( wsample, idxs, cnt );
+    for( ulong j=0UL; j<cnt; j++ ) sched[ i+j ] = (uint)idxs[ j ];
+  }
 
   /* Clean up the wsample object */
   fd_wsample_delete( fd_wsample_leave( wsample ) );
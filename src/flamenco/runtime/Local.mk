@@ -10,6 +10,13 @@ $(call add-objs,fd_bank_hash_cmp,fd_flamenco)
 
 $(call add-hdrs,fd_blockstore.h fd_readwrite_lock.h)
 $(call add-objs,fd_blockstore,fd_flamenco)
+$(call make-unit-test,test_blockstore,test_blockstore,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_blockstore,)
+
+$(call add-hdrs,fd_blockstore_archive.h)
+$(call add-objs,fd_blockstore_archive,fd_flamenco)
+$(call make-unit-test,test_blockstore_archive,test_blockstore_archive,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_blockstore_archive,)
 
 $(call add-hdrs,fd_borrowed_account.h)
 $(call add-objs,fd_borrowed_account,fd_flamenco)
@@ -19,6 +26,8 @@ $(call add-objs,fd_executor,fd_flamenco)
 
 $(call add-hdrs,fd_hashes.h)
 $(call add-objs,fd_hashes,fd_flamenco)
+$(call make-unit-test,test_hashes,test_hashes,fd_flamenco fd_funk fd_ballet fd_util)
+$(call run-unit-test,test_hashes,)
 
 $(call add-hdrs,fd_pubkey_utils.h)
 $(call add-objs,fd_pubkey_utils,fd_flamenco)
@@ -27,6 +36,15 @@ $(call add-hdrs,fd_rent_lists.h)
 
 $(call add-hdrs,fd_runtime.h fd_runtime_init.h fd_runtime_err.h)
 $(call add-objs,fd_runtime fd_runtime_init,fd_flamenco)
+ifdef FD_HAS_SECP256K1
+$(call make-unit-test,test_runtime_sched,test_runtime_sched,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_runtime_sched,)
+endif
+
+$(call add-hdrs,fd_txn_sched.h)
+$(call add-objs,fd_txn_sched,fd_flamenco)
+$(call make-unit-test,test_txn_sched,test_txn_sched,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_txn_sched,)
 endif
 
 $(call add-hdrs,fd_system_ids.h)
@@ -37,4 +55,6 @@ $(call run-unit-test,test_system_ids,)
 ifdef FD_HAS_ROCKSDB
 $(call add-hdrs,fd_rocksdb.h)
 $(call add-objs,fd_rocksdb,fd_flamenco)
+$(call make-unit-test,test_rocksdb,test_rocksdb,fd_flamenco fd_ballet fd_util,$(ROCKSDB_LIBS))
+$(call run-unit-test,test_rocksdb,)
 endif
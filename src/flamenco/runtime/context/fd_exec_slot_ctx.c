@@ -24,6 +24,7 @@ fd_exec_slot_ctx_new( void *      mem,
   fd_exec_slot_ctx_t * self = (fd_exec_slot_ctx_t *) mem;
   self->valloc = valloc;
   fd_slot_bank_new(&self->slot_bank);
+  self->lthash_slot = ULONG_MAX;
 
   self->sysvar_cache = fd_sysvar_cache_new( fd_valloc_malloc( valloc, fd_sysvar_cache_align(), fd_sysvar_cache_footprint() ), valloc );
   self->account_compute_table = fd_account_compute_table_join( fd_account_compute_table_new( fd_valloc_malloc( valloc, fd_account_compute_table_align(), fd_account_compute_table_footprint( 10000 ) ), 10000, 0 ) );
@@ -234,6 +235,12 @@ fd_exec_slot_ctx_recover_( fd_exec_slot_ctx_t *   slot_ctx,
     }
   } while (0);
 
+  /* Move hard forks (written back to the manifest of snapshots created
+     from this bank) */
+
+  slot_bank->hard_forks = oldbank->hard_forks;
+  fd_memset( &oldbank->hard_forks, 0, sizeof(fd_hard_forks_t) );
+
   /* Move EpochStakes */
   do {
     ulong epoch = fd_slot_to_epoch( &epoch_bank->epoch_schedule, slot_bank->slot, NULL );
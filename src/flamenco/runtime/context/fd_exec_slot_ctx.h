@@ -72,6 +72,11 @@ struct __attribute__((aligned(8UL))) fd_exec_slot_ctx {
 
   fd_sysvar_cache_t *      sysvar_cache;
   fd_account_compute_elem_t * account_compute_table;
+
+  /* Accounts lthash maintenance (see fd_hashes.h) */
+  int                      enable_lthash;
+  ulong                    lthash_slot;       /* Slot lthash_base was captured for, ULONG_MAX if none */
+  uchar                    lthash_base[2048]; /* slot_bank.lthash at the start of lthash_slot */
 };
 
 #define FD_EXEC_SLOT_CTX_ALIGN     (alignof(fd_exec_slot_ctx_t))
@@ -97,6 +97,13 @@ fd_acc_mgr_set_slots_per_epoch( fd_exec_slot_ctx_t * slot_ctx,
   fd_funk_repartition( acc_mgr->funk, (uint)slots_per_epoch, fd_rent_lists_cb, slot_ctx );
 }
 
+void
+fd_acc_mgr_part_set( fd_acc_mgr_t *  acc_mgr,
+                     fd_funk_rec_t * rec ) {
+  if( acc_mgr->slots_per_epoch != 0 )
+    fd_funk_part_set( acc_mgr->funk, rec, (uint)fd_rent_lists_key_to_bucket( acc_mgr, rec ) );
+}
+
 fd_account_meta_t const *
 fd_acc_mgr_view_raw( fd_acc_mgr_t *         acc_mgr,
                      fd_funk_txn_t const *  txn,
@@ -335,12 +342,15 @@ fd_acc_mgr_unlock( fd_acc_mgr_t * acc_mgr ) {
 }
 
 struct fd_acc_mgr_save_task_args {
-  fd_acc_mgr_t * acc_mgr;
+  fd_acc_mgr_t *            acc_mgr;
+  fd_funk_txn_t *           txn;
+  fd_borrowed_account_t * * accounts;
+  fd_funk_rec_t * *         recs;
 };
 typedef struct fd_acc_mgr_save_task_args fd_acc_mgr_save_task_args_t;
 
 struct fd_acc_mgr_save_task_info {
-  fd_borrowed_account_t * * accounts;
+  ulong * account_idxs;
   ulong accounts_cnt;
   int result;
 };
@@ -357,8 +367,29 @@ fd_acc_mgr_save_task( void *tpool,
   fd_acc_mgr_save_task_args_t * task_args = (fd_acc_mgr_save_task_args_t *)args;
   fd_acc_mgr_save_task_info_t * task_info = (fd_acc_mgr_save_task_info_t *)tpool + m0;
 
+  fd_acc_mgr_t * acc_mgr = task_args->acc_mgr;
+  fd_funk_t *    funk    = acc_mgr->funk;
+  fd_wksp_t *    wksp    = fd_funk_wksp( funk );
+
   for( ulong i = 0; i < task_info->accounts_cnt; i++ ) {
-    int err = fd_acc_mgr_save(task_args->acc_mgr,task_info->accounts[i] );
+    ulong                   account_idx = task_info->account_idxs[i];
+    fd_borrowed_account_t * account     = task_args->accounts[ account_idx ];
+
+    /* Batches are sharded by account address, so a given record is only
+       ever touched by one task. */
+    fd_funk_rec_key_t key = fd_acc_funk_key( account->pubkey );
+    int err;
+    fd_funk_rec_t * rec = (fd_funk_rec_t *)fd_funk_rec_insert_para( funk, task_args->txn, &key, &err );
+    if( rec == NULL ) FD_LOG_ERR(( "unable to insert a new record, error %d", err ));
+    account->rec = rec;
+    task_args->recs[ account_idx ] = rec;
+
+    ulong reclen = sizeof(fd_account_meta_t)+account->const_meta->dlen;
+    if( fd_funk_val_truncate( account->rec, reclen, fd_funk_alloc( funk, wksp ), wksp, &err ) == NULL ) {
+      FD_LOG_ERR(( "unable to allocate account value, err %d", err ));
+    }
+
+    err = fd_acc_mgr_save( acc_mgr, account );
     if( FD_UNLIKELY( err != FD_ACC_MGR_SUCCESS ) ) {
       task_info->result = err;
       return;
@@ -388,15 +419,22 @@ fd_acc_mgr_save_many_tpool( fd_acc_mgr_t *          acc_mgr,
     ulong * batch_szs = fd_scratch_alloc( 8UL, batch_cnt * sizeof(ulong) );
     fd_memset( batch_szs, 0, batch_cnt * sizeof(ulong) );
 
-    /* Compute the batch sizes */
+    /* Compute the batch sizes.  Accounts are assigned to batches by
+       address so duplicate accounts land in the same batch (and are
+       saved in order). */
     for( ulong i = 0; i < accounts_cnt; i++ ) {
-      ulong batch_idx = i & batch_mask;
+      ulong batch_idx = fd_ulong_hash( accounts[i]->pubkey->ul[0] ) & batch_mask;
       batch_szs[batch_idx]++;
     }
 
-    fd_borrowed_account_t * * task_accounts = fd_scratch_alloc( 8UL, accounts_cnt * sizeof(fd_borrowed_account_t *) );
+    ulong * task_account_idxs = fd_scratch_alloc( 8UL, accounts_cnt * sizeof(ulong) );
     fd_acc_mgr_save_task_info_t * task_infos = fd_scratch_alloc( 8UL, batch_cnt * sizeof(fd_acc_mgr_save_task_info_t) );
-    fd_borrowed_account_t * * task_accounts_cursor = task_accounts;
+    ulong * task_account_idxs_cursor = task_account_idxs;
+
+    /* recs[i] is the record accounts[i] was saved into (NULL if its
+       task failed before getting to it) */
+    fd_funk_rec_t * * recs = fd_scratch_alloc( 8UL, accounts_cnt * sizeof(fd_funk_rec_t *) );
+    fd_memset( recs, 0, accounts_cnt * sizeof(fd_funk_rec_t *) );
 
     /* Construct the batches */
     for( ulong i = 0; i < batch_cnt; i++ ) {
@@ -404,53 +442,51 @@ fd_acc_mgr_save_many_tpool( fd_acc_mgr_t *          acc_mgr,
       fd_acc_mgr_save_task_info_t * task_info = &task_infos[i];
 
       task_info->accounts_cnt = 0;
-      task_info->accounts = task_accounts_cursor;
+      task_info->account_idxs = task_account_idxs_cursor;
       task_info->result = 0;
 
-      task_accounts_cursor += batch_sz;
+      task_account_idxs_cursor += batch_sz;
     }
 
-    fd_funk_start_write( funk );
-    
     for( ulong i = 0; i < accounts_cnt; i++ ) {
-      fd_borrowed_account_t * account = accounts[i];
-      ulong batch_idx = i & batch_mask;
+      ulong batch_idx = fd_ulong_hash( accounts[i]->pubkey->ul[0] ) & batch_mask;
       fd_acc_mgr_save_task_info_t * task_info = &task_infos[batch_idx];
-      task_info->accounts[task_info->accounts_cnt++] = account;
-      fd_funk_rec_key_t key = fd_acc_funk_key( account->pubkey );
-      fd_funk_rec_t * rec = (fd_funk_rec_t *)fd_funk_rec_query( funk, txn, &key );
-      if( rec == NULL ) {
-        int err;
-        rec = (fd_funk_rec_t *)fd_funk_rec_insert( funk, txn, &key, &err );
-        if( rec == NULL ) FD_LOG_ERR(( "unable to insert a new record, error %s", err ));
-      }
-      account->rec = rec;
-      if ( acc_mgr->slots_per_epoch != 0 )
-        fd_funk_part_set(funk, rec, (uint)fd_rent_lists_key_to_bucket( acc_mgr, rec ));
-      ulong reclen = sizeof(fd_account_meta_t)+account->const_meta->dlen;
-      int err;
-      if( fd_funk_val_truncate( account->rec, reclen, fd_funk_alloc( acc_mgr->funk, wksp ), wksp, &err ) == NULL ) {
-        FD_LOG_ERR(( "unable to allocate account value, err %d", err ));
-      }
+      task_info->account_idxs[task_info->accounts_cnt++] = i;
     }
 
     fd_acc_mgr_save_task_args_t task_args = {
-      .acc_mgr = acc_mgr
+      .acc_mgr  = acc_mgr,
+      .txn      = txn,
+      .accounts = accounts,
+      .recs     = recs
     };
 
-    /* Save accounts in a thread pool */
-    fd_tpool_exec_all_taskq( tpool, 0, max_workers, fd_acc_mgr_save_task, task_infos, &task_args, NULL, 1, 0, batch_cnt );
+    fd_funk_start_write( funk );
 
-    fd_funk_end_write( funk );
+    /* Insert and save accounts in a thread pool */
+    fd_tpool_exec_all_taskq( tpool, 0, max_workers, fd_acc_mgr_save_task, task_infos, &task_args, NULL, 1, 0, batch_cnt );
 
-    /* Check results */
+    int result = FD_ACC_MGR_SUCCESS;
     for( ulong i = 0; i < batch_cnt; i++ ) {
-      fd_acc_mgr_save_task_info_t * task_info = &task_infos[i];
-      if( task_info->result != FD_ACC_MGR_SUCCESS ) {
-        return task_info->result;
+      if( task_infos[i].result != FD_ACC_MGR_SUCCESS ) {
+        result = task_infos[i].result;
+        break;
       }
     }
 
-    return FD_ACC_MGR_SUCCESS;
+    /* Rent partition lists are shared between records so these are
+       updated serially.  A task stops at its first failed save, so
+       skip the accounts it never inserted. */
+    if( acc_mgr->slots_per_epoch != 0 ) {
+      for( ulong i = 0; i < accounts_cnt; i++ ) {
+        fd_funk_rec_t * rec = recs[i];
+        if( FD_UNLIKELY( !rec ) ) continue;
+        fd_funk_part_set( funk, rec, (uint)fd_rent_lists_key_to_bucket( acc_mgr, rec ) );
+      }
+    }
+
+    fd_funk_end_write( funk );
+
+    return result;
   } FD_SCRATCH_SCOPE_END;
 }
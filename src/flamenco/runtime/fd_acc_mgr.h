@@ -265,6 +265,17 @@ void
 fd_acc_mgr_set_slots_per_epoch( fd_exec_slot_ctx_t * slot_ctx,
                                 ulong                slots_per_epoch );
 
+/* fd_acc_mgr_part_set places the account record rec into the rent
+   partition of its pubkey.  No-op if rent partitioning is not set up
+   (slots_per_epoch==0).  This is what fd_acc_mgr_modify_raw does for
+   every record it hands out; it is exposed for callers that create
+   account records without going through the account manager (e.g.
+   parallel snapshot restore).  Not thread safe. */
+
+void
+fd_acc_mgr_part_set( fd_acc_mgr_t *  acc_mgr,
+                     fd_funk_rec_t * rec );
+
 /* fd_acc_mgr_strerror converts an fd_acc_mgr error code into a human
    readable cstr.  The lifetime of the returned pointer is infinite and
    the call itself is thread safe.  The returned pointer is always to a
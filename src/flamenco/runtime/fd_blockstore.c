@@ -1,4 +1,5 @@
 #include "fd_blockstore.h"
+#include "fd_blockstore_archive.h"
 
 ulong
 fd_blockstore_align( void ) {
@@ -210,6 +211,7 @@ fd_blockstore_new( void * shmem,
 
   blockstore->lg_txn_max    = lg_txn_max;
   blockstore->txn_map_gaddr = fd_wksp_gaddr_fast( wksp, txn_map );
+  blockstore->archive_gaddr = 0UL;
 
   blockstore->alloc_gaddr = fd_wksp_gaddr_fast( wksp, alloc );
 
@@ -897,10 +899,11 @@ fd_buf_shred_query( fd_blockstore_t * blockstore, ulong slot, uint shred_idx ) {
   fd_buf_shred_t *     shred_pool = fd_buf_shred_pool( blockstore );
   fd_buf_shred_map_t * shred_map  = fd_buf_shred_map( blockstore );
   fd_shred_key_t              key        = { .slot = slot, .idx = shred_idx };
-  fd_buf_shred_t *     query =
-      fd_buf_shred_map_ele_query( shred_map, &key, NULL, shred_pool );
+  /* query_const does not reorder the chain, so concurrent readers are fine */
+  fd_buf_shred_t const *     query =
+      fd_buf_shred_map_ele_query_const( shred_map, &key, NULL, shred_pool );
   if( FD_UNLIKELY( !query ) ) return NULL;
-  return &query->hdr;
+  return (fd_shred_t *)&query->hdr;
 }
 
 long
@@ -910,8 +913,8 @@ fd_buf_shred_query_copy_data( fd_blockstore_t * blockstore, ulong slot, uint shr
   fd_buf_shred_t *     shred_pool = fd_buf_shred_pool( blockstore );
   fd_buf_shred_map_t * shred_map  = fd_buf_shred_map( blockstore );
   fd_shred_key_t              key        = { .slot = slot, .idx = shred_idx };
-  fd_buf_shred_t *     shred =
-      fd_buf_shred_map_ele_query( shred_map, &key, NULL, shred_pool );
+  fd_buf_shred_t const *     shred =
+      fd_buf_shred_map_ele_query_const( shred_map, &key, NULL, shred_pool );
   if( shred ) {
     ulong sz = fd_shred_sz( &shred->hdr );
     if( sz > buf_max ) return -1;
@@ -943,6 +946,79 @@ fd_buf_shred_query_copy_data( fd_blockstore_t * blockstore, ulong slot, uint shr
   return (long)FD_SHRED_MIN_SZ;
 }
 
+long
+fd_buf_shred_query_copy_data_volatile( fd_blockstore_t * blockstore, ulong slot, uint shred_idx, void * buf, ulong buf_max ) {
+  /* WARNING: this code is extremely delicate. Do NOT modify without
+     understanding all the invariants. In particular, we must never
+     dereference through a corrupt pointer. It's OK for the
+     destination data to be overwritten/invalid as long as the memory
+     location is valid. As long as we don't crash, we can validate the
+     data after it is read. */
+  if( buf_max < FD_SHRED_MAX_SZ ) return -1;
+
+  fd_wksp_t *                      wksp       = fd_blockstore_wksp( blockstore );
+  fd_buf_shred_t const *           shred_pool = fd_buf_shred_pool( blockstore );
+  fd_buf_shred_map_t const *       shred_map  = fd_buf_shred_map( blockstore );
+  fd_blockstore_slot_map_t const * slot_map   = fd_wksp_laddr_fast( wksp, blockstore->slot_map_gaddr );
+  fd_shred_key_t                   key        = { .slot = slot, .idx = shred_idx };
+  for(;;) {
+    uint seqnum;
+    if( FD_UNLIKELY( fd_readwrite_start_concur_read( &blockstore->lock, &seqnum ) ) ) continue;
+
+    /* Buffered shred of an incomplete block */
+
+    fd_buf_shred_t const * shred =
+        fd_buf_shred_map_ele_query_safe( shred_map, &key, NULL, shred_pool, blockstore->shred_max );
+    if( shred ) {
+      ulong sz = fd_shred_sz( &shred->hdr );
+      if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+      if( sz > buf_max ) return -1;
+      fd_memcpy( buf, shred->raw, sz );
+      if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+      return (long)sz;
+    }
+
+    /* Shred of a complete block */
+
+    fd_blockstore_slot_map_t const * query = fd_blockstore_slot_map_query_safe( slot_map, &slot, NULL );
+    if( FD_UNLIKELY( !query ) ) {
+      if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+      return -1;
+    }
+    ulong last_index = query->slot_meta.last_index;
+    ulong blk_gaddr  = query->block_gaddr;
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( !blk_gaddr || shred_idx > last_index ) ) return -1;
+
+    fd_block_t const * blk = fd_wksp_laddr_fast( wksp, blk_gaddr );
+    ulong shreds_gaddr = blk->shreds_gaddr;
+    ulong shreds_cnt   = blk->shreds_cnt;
+    ulong data_gaddr   = blk->data_gaddr;
+    ulong data_sz      = blk->data_sz;
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( !shreds_gaddr || !data_gaddr || shred_idx >= shreds_cnt ) ) return -1;
+
+    fd_block_shred_t blk_shred;
+    fd_memcpy( &blk_shred, (fd_block_shred_t const *)fd_wksp_laddr_fast( wksp, shreds_gaddr ) + shred_idx, sizeof(fd_block_shred_t) );
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+
+    ulong sz        = fd_shred_payload_sz( &blk_shred.hdr );
+    ulong merkle_sz = blk_shred.merkle_sz;
+    if( FD_UNLIKELY( blk_shred.off + sz > data_sz || merkle_sz > sizeof(blk_shred.merkle) ) ) return -1;
+    ulong tot_sz = FD_SHRED_DATA_HEADER_SZ + sz + merkle_sz;
+    if( tot_sz > buf_max ) return -1;
+    fd_memcpy( buf, &blk_shred.hdr, FD_SHRED_DATA_HEADER_SZ );
+    fd_memcpy( (uchar*)buf + FD_SHRED_DATA_HEADER_SZ, (uchar const *)fd_wksp_laddr_fast( wksp, data_gaddr ) + blk_shred.off, sz );
+    fd_memcpy( (uchar*)buf + FD_SHRED_DATA_HEADER_SZ + sz, blk_shred.merkle, merkle_sz );
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+
+    if( tot_sz >= FD_SHRED_MIN_SZ ) return (long)tot_sz;
+    /* Zero pad */
+    fd_memset( (uchar*)buf + tot_sz, 0, FD_SHRED_MIN_SZ - tot_sz );
+    return (long)FD_SHRED_MIN_SZ;
+  }
+}
+
 fd_block_t *
 fd_blockstore_block_query( fd_blockstore_t * blockstore, ulong slot ) {
   fd_blockstore_slot_map_t * query =
@@ -1061,10 +1137,12 @@ fd_blockstore_slot_meta_query_volatile( fd_blockstore_t * blockstore, ulong slot
     if( FD_UNLIKELY( !query ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
     fd_memcpy( slot_meta_out, &query->slot_meta, sizeof( fd_slot_meta_t ) );
     ulong blk_gaddr = query->block_gaddr;
-    if( FD_UNLIKELY( !blk_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
 
     if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
 
+    if( !blk_out ) return FD_BLOCKSTORE_OK;
+    if( FD_UNLIKELY( !blk_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+
     fd_block_t * blk = fd_wksp_laddr_fast( wksp, blk_gaddr );
     fd_memcpy( blk_out, blk, sizeof(fd_block_t) );
 
@@ -1074,6 +1152,68 @@ fd_blockstore_slot_meta_query_volatile( fd_blockstore_t * blockstore, ulong slot
   }
 }
 
+ulong
+fd_blockstore_parent_slot_query_volatile( fd_blockstore_t * blockstore, ulong slot ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+  fd_blockstore_slot_map_t const * slot_map = fd_wksp_laddr_fast( wksp, blockstore->slot_map_gaddr );
+  for(;;) {
+    uint seqnum;
+    if( FD_UNLIKELY( fd_readwrite_start_concur_read( &blockstore->lock, &seqnum ) ) ) continue;
+
+    fd_blockstore_slot_map_t const * query = fd_blockstore_slot_map_query_safe( slot_map, &slot, NULL );
+    ulong parent_slot = ( query ? query->slot_meta.parent_slot : FD_SLOT_NULL );
+
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+
+    return parent_slot;
+  }
+}
+
+int
+fd_blockstore_block_hash_query_volatile( fd_blockstore_t * blockstore, ulong slot, fd_hash_t * hash_out ) {
+  /* WARNING: this code is extremely delicate. Do NOT modify without
+     understanding all the invariants. In particular, we must never
+     dereference through a corrupt pointer. It's OK for the
+     destination data to be overwritten/invalid as long as the memory
+     location is valid. As long as we don't crash, we can validate the
+     data after it is read. */
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+  fd_blockstore_slot_map_t const * slot_map = fd_wksp_laddr_fast( wksp, blockstore->slot_map_gaddr );
+  for(;;) {
+    uint seqnum;
+    if( FD_UNLIKELY( fd_readwrite_start_concur_read( &blockstore->lock, &seqnum ) ) ) continue;
+
+    fd_blockstore_slot_map_t const * query = fd_blockstore_slot_map_query_safe( slot_map, &slot, NULL );
+    if( FD_UNLIKELY( !query ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+    ulong blk_gaddr = query->block_gaddr;
+
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( !blk_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+
+    fd_block_t const * blk = fd_wksp_laddr_fast( wksp, blk_gaddr );
+    ulong micros_gaddr = blk->micros_gaddr;
+    ulong micros_cnt   = blk->micros_cnt;
+    ulong data_gaddr   = blk->data_gaddr;
+    ulong data_sz      = blk->data_sz;
+
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( !micros_gaddr || !micros_cnt || !data_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+
+    fd_block_micro_t const * micros = fd_wksp_laddr_fast( wksp, micros_gaddr );
+    ulong off = micros[ micros_cnt - 1 ].off;
+
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( off + sizeof(fd_microblock_hdr_t) > data_sz ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+
+    fd_microblock_hdr_t const * last_micro = (fd_microblock_hdr_t const *)( (uchar const *)fd_wksp_laddr_fast( wksp, data_gaddr ) + off );
+    fd_memcpy( hash_out->uc, last_micro->hash, sizeof(fd_hash_t) );
+
+    if( FD_UNLIKELY( fd_readwrite_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+
+    return FD_BLOCKSTORE_OK;
+  }
+}
+
 fd_blockstore_txn_map_t *
 fd_blockstore_txn_query( fd_blockstore_t * blockstore, uchar const sig[FD_ED25519_SIG_SZ] ) {
   fd_blockstore_txn_key_t key;
@@ -1084,8 +1224,8 @@ fd_blockstore_txn_query( fd_blockstore_t * blockstore, uchar const sig[FD_ED2551
       NULL );
 }
 
-int
-fd_blockstore_txn_query_volatile( fd_blockstore_t * blockstore, uchar const sig[FD_ED25519_SIG_SZ], fd_blockstore_txn_map_t * txn_out, long * blk_ts, uchar txn_data_out[FD_TXN_MTU] ) {
+static int
+fd_blockstore_txn_query_volatile_mem( fd_blockstore_t * blockstore, uchar const sig[FD_ED25519_SIG_SZ], fd_blockstore_txn_map_t * txn_out, long * blk_ts, uchar txn_data_out[FD_TXN_MTU] ) {
   /* WARNING: this code is extremely delicate. Do NOT modify without
      understanding all the invariants. In particular, we must never
      dereference through a corrupt pointer. It's OK for the
@@ -1132,6 +1272,19 @@ fd_blockstore_txn_query_volatile( fd_blockstore_t * blockstore, uchar const sig[
   }
 }
 
+int
+fd_blockstore_txn_query_volatile( fd_blockstore_t * blockstore, uchar const sig[FD_ED25519_SIG_SZ], fd_blockstore_txn_map_t * txn_out, long * blk_ts, uchar txn_data_out[FD_TXN_MTU] ) {
+  int err = fd_blockstore_txn_query_volatile_mem( blockstore, sig, txn_out, blk_ts, txn_data_out );
+  if( FD_LIKELY( err!=FD_BLOCKSTORE_ERR_TXN_MISSING ) ) return err;
+
+  /* Not (or no longer) in the blockstore, try the archive */
+
+  ulong archive_gaddr = FD_VOLATILE_CONST( blockstore->archive_gaddr );
+  if( !archive_gaddr ) return err;
+  fd_blockstore_archive_t * archive = fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), archive_gaddr );
+  return fd_blockstore_archive_txn_query( archive, sig, txn_out, blk_ts, txn_data_out );
+}
+
 void
 fd_blockstore_block_height_set( fd_blockstore_t * blockstore, ulong slot, ulong block_height ) {
   fd_block_t * query = fd_blockstore_block_query( blockstore, slot );
@@ -262,6 +262,8 @@ struct __attribute__((aligned(FD_BLOCKSTORE_ALIGN))) fd_blockstore_private {
   int   lg_txn_max;
   ulong txn_map_gaddr;
 
+  ulong archive_gaddr; /* fd_blockstore_archive_t txn queries fall back to, 0 if none */
+
   /* The blockstore alloc is used for allocating wksp resources for shred headers, microblock
      headers, and blocks.  This is an fd_alloc. Allocations from this allocator will be tagged with
      wksp_tag and operations on this allocator will use concurrency group 0. */
@@ -447,6 +449,13 @@ fd_buf_shred_query( fd_blockstore_t * blockstore, ulong slot, uint shred_idx );
 long
 fd_buf_shred_query_copy_data( fd_blockstore_t * blockstore, ulong slot, uint shred_idx, void * buf, ulong buf_max );
 
+/* fd_buf_shred_query_copy_data_volatile is the same as
+ * fd_buf_shred_query_copy_data but does not take the read lock and
+ * never blocks writers. It works for shreds of both incomplete and
+ * complete blocks, as used for serving repair. */
+long
+fd_buf_shred_query_copy_data_volatile( fd_blockstore_t * blockstore, ulong slot, uint shred_idx, void * buf, ulong buf_max );
+
 /* Query blockstore for block at slot. Returns a pointer to the block or NULL if not in
  * blockstore. The returned pointer lifetime is until the block is removed. Check return value for
  * error info. */
@@ -488,17 +497,34 @@ uchar *
 fd_blockstore_block_query_volatile( fd_blockstore_t * blockstore, ulong slot, fd_valloc_t alloc, fd_block_t * blk_out, fd_slot_meta_t * slot_meta_out, ulong * data_sz_out );
 
 /* Query the block metadata in a thread-safe manner which will
-   not block writes. The metadata is copied out. */
+   not block writes. The metadata is copied out. blk_out can be NULL
+   if you are only interested in the slot meta, in which case the slot
+   does not need a block yet. */
 int
 fd_blockstore_slot_meta_query_volatile( fd_blockstore_t * blockstore, ulong slot, fd_block_t * blk_out, fd_slot_meta_t * slot_meta_out );
 
-/* Query the transaction data for the given signature */
+/* Query the parent slot of slot in a thread-safe manner which will not
+   block writes. Returns FD_SLOT_NULL if the slot is missing. */
+ulong
+fd_blockstore_parent_slot_query_volatile( fd_blockstore_t * blockstore, ulong slot );
+
+/* Query the block hash (final poh hash) at slot in a thread-safe
+   manner which will not block writes. The hash is copied out. */
+int
+fd_blockstore_block_hash_query_volatile( fd_blockstore_t * blockstore, ulong slot, fd_hash_t * hash_out );
+
+/* Query the transaction data for the given signature.  Only sees
+   transactions still in the blockstore, see
+   fd_blockstore_txn_query_volatile for archived ones. */
 fd_blockstore_txn_map_t *
 fd_blockstore_txn_query( fd_blockstore_t * blockstore, uchar const sig[static FD_ED25519_SIG_SZ] );
 
 /* Query the transaction data for the given signature in a thread
    safe manner. The transaction data is copied out. txn_data_out can
-   be NULL if you are only interested in the transaction metadata. */
+   be NULL if you are only interested in the transaction metadata.
+   Falls back to the archive attached with fd_blockstore_archive_attach
+   if the transaction is no longer in the blockstore, in which case
+   txn_out meta_gaddr is 0. */
 int
 fd_blockstore_txn_query_volatile( fd_blockstore_t * blockstore, uchar const sig[static FD_ED25519_SIG_SZ], fd_blockstore_txn_map_t * txn_out, long * blk_ts, uchar txn_data_out[FD_TXN_MTU] );
 
@@ -0,0 +1,688 @@
+#define _DEFAULT_SOURCE
+#include "fd_blockstore_archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ulong
+fd_blockstore_archive_align( void ) {
+  return FD_BLOCKSTORE_ARCHIVE_ALIGN;
+}
+
+ulong
+fd_blockstore_archive_footprint( ulong slot_max, int lg_txn_max ) {
+  /* clang-format off */
+  return FD_LAYOUT_FINI(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND( FD_LAYOUT_INIT,
+      alignof(fd_blockstore_archive_t),        sizeof(fd_blockstore_archive_t) ),
+      fd_blockstore_archive_slot_map_align(),  fd_blockstore_archive_slot_map_footprint( slot_max ) ),
+      fd_blockstore_archive_txn_map_align(),   fd_blockstore_archive_txn_map_footprint( 1UL<<lg_txn_max ) ),
+      alignof(ulong),                          sizeof(ulong)*slot_max ),
+    fd_blockstore_archive_align() );
+  /* clang-format on */
+}
+
+void *
+fd_blockstore_archive_new( void * shmem, ulong seed, ulong slot_max, int lg_txn_max ) {
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL archive" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_blockstore_archive_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned archive" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !slot_max || lg_txn_max<0 || lg_txn_max>40 ) ) {
+    FD_LOG_WARNING(( "bad slot_max or lg_txn_max" ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( l, shmem );
+  fd_blockstore_archive_t * archive = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_blockstore_archive_t), sizeof(fd_blockstore_archive_t) );
+  void * slot_map = FD_SCRATCH_ALLOC_APPEND( l, fd_blockstore_archive_slot_map_align(), fd_blockstore_archive_slot_map_footprint( slot_max ) );
+  void * txn_map  = FD_SCRATCH_ALLOC_APPEND( l, fd_blockstore_archive_txn_map_align(),  fd_blockstore_archive_txn_map_footprint( 1UL<<lg_txn_max ) );
+  void * path     = FD_SCRATCH_ALLOC_APPEND( l, alignof(ulong), sizeof(ulong)*slot_max );
+  FD_SCRATCH_ALLOC_FINI( l, fd_blockstore_archive_align() );
+
+  fd_memset( archive, 0, sizeof(fd_blockstore_archive_t) );
+  archive->slot_max   = slot_max;
+  archive->lg_txn_max = lg_txn_max;
+  archive->seed       = seed;
+  archive->fd         = -1;
+  archive->slot_lo    = ULONG_MAX;
+  archive->slot_hi    = 0UL;
+  archive->stage      = NULL;
+  archive->stage_sz   = 0UL;
+  fd_readwrite_new( &archive->lock );
+
+  archive->slot_map = fd_blockstore_archive_slot_map_join( fd_blockstore_archive_slot_map_new( slot_map, slot_max, seed ) );
+  archive->txn_map  = fd_blockstore_archive_txn_map_join( fd_blockstore_archive_txn_map_new( txn_map, 1UL<<lg_txn_max, seed ) );
+  archive->path     = (ulong *)path;
+  if( FD_UNLIKELY( !archive->slot_map || !archive->txn_map ) ) {
+    FD_LOG_WARNING(( "failed to create archive indices" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( archive->magic ) = FD_BLOCKSTORE_ARCHIVE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_blockstore_archive_t *
+fd_blockstore_archive_join( void * sharchive ) {
+  fd_blockstore_archive_t * archive = (fd_blockstore_archive_t *)sharchive;
+
+  if( FD_UNLIKELY( !archive ) ) {
+    FD_LOG_WARNING(( "NULL archive" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( archive->magic!=FD_BLOCKSTORE_ARCHIVE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return archive;
+}
+
+void *
+fd_blockstore_archive_leave( fd_blockstore_archive_t * archive ) {
+  if( FD_UNLIKELY( !archive ) ) {
+    FD_LOG_WARNING(( "NULL archive" ));
+    return NULL;
+  }
+
+  return (void *)archive;
+}
+
+void *
+fd_blockstore_archive_delete( void * sharchive ) {
+  fd_blockstore_archive_t * archive = (fd_blockstore_archive_t *)sharchive;
+
+  if( FD_UNLIKELY( !archive ) ) {
+    FD_LOG_WARNING(( "NULL archive" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( archive->magic!=FD_BLOCKSTORE_ARCHIVE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( archive->fd!=-1 ) ) fd_blockstore_archive_close( archive );
+
+  fd_blockstore_archive_slot_map_delete( fd_blockstore_archive_slot_map_leave( archive->slot_map ) );
+  fd_blockstore_archive_txn_map_delete( fd_blockstore_archive_txn_map_leave( archive->txn_map ) );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( archive->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return (void *)archive;
+}
+
+/* fd_blockstore_archive_pwrite writes sz bytes at file offset off,
+   retrying short writes.  Returns 0 on success and errno on failure. */
+
+static int
+fd_blockstore_archive_pwrite( int fd, void const * buf, ulong sz, ulong off ) {
+  uchar const * p = (uchar const *)buf;
+  while( sz ) {
+    long wsz = pwrite( fd, p, sz, (long)off );
+    if( FD_UNLIKELY( wsz<0L ) ) {
+      if( errno==EINTR ) continue;
+      return errno;
+    }
+    p   += (ulong)wsz;
+    sz  -= (ulong)wsz;
+    off += (ulong)wsz;
+  }
+  return 0;
+}
+
+/* fd_blockstore_archive_rec_validate returns 1 if the record at file
+   offset off is complete and internally consistent given the first
+   file_sz bytes of the file are readable, and 0 otherwise. */
+
+static int
+fd_blockstore_archive_rec_validate( fd_blockstore_archive_t const * archive, ulong off, ulong file_sz ) {
+  if( FD_UNLIKELY( off + sizeof(fd_blockstore_archive_rec_t) > file_sz ) ) return 0;
+  fd_blockstore_archive_rec_t const * rec = (fd_blockstore_archive_rec_t const *)( archive->map + off );
+  if( FD_UNLIKELY( FD_VOLATILE_CONST( rec->magic )!=FD_BLOCKSTORE_ARCHIVE_REC_MAGIC ) ) return 0;
+  FD_COMPILER_MFENCE();
+  ulong rec_sz = rec->rec_sz;
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( rec_sz, FD_BLOCKSTORE_ARCHIVE_REC_ALIGN ) ||
+                   rec_sz < sizeof(fd_blockstore_archive_rec_t) ||
+                   rec_sz > file_sz - off ) ) return 0;
+  if( FD_UNLIKELY( rec->shreds_cnt > FD_SHRED_MAX_PER_SLOT ) ) return 0;
+  if( FD_UNLIKELY( rec->shreds_off + rec->shreds_cnt*sizeof(fd_blockstore_archive_shred_t) > rec->micros_off ||
+                   rec->micros_off + rec->micros_cnt*sizeof(fd_block_micro_t)              > rec->txns_off   ||
+                   rec->txns_off   + rec->txns_cnt  *sizeof(fd_block_txn_ref_t)            > rec->merkle_off ||
+                   rec->merkle_off + rec->merkle_sz                                        > rec->data_off   ||
+                   rec->data_off   + rec->data_sz                                          > rec_sz          ||
+                   rec->shreds_off < sizeof(fd_blockstore_archive_rec_t) ) ) return 0;
+  return 1;
+}
+
+/* fd_blockstore_archive_rec_evict drops the oldest indexed record from
+   the indices.  The record stays in the file.  Caller holds the write
+   lock. */
+
+static void
+fd_blockstore_archive_rec_evict( fd_blockstore_archive_t * archive ) {
+  ulong                               off  = archive->idx_off;
+  fd_blockstore_archive_rec_t const * rec  = (fd_blockstore_archive_rec_t const *)( archive->map + off );
+  ulong                               slot = rec->slot;
+
+  fd_blockstore_archive_slot_t * slot_entry = fd_blockstore_archive_slot_map_query( archive->slot_map, &slot, NULL );
+  if( FD_LIKELY( slot_entry && slot_entry->rec_off==off ) ) fd_blockstore_archive_slot_map_remove( archive->slot_map, &slot );
+
+  uchar const *              data = fd_blockstore_archive_rec_data( rec );
+  fd_block_txn_ref_t const * txns = fd_blockstore_archive_rec_txns( rec );
+  for( ulong j = 0; j < rec->txns_cnt; j++ ) {
+    if( FD_UNLIKELY( txns[j].id_off + sizeof(fd_blockstore_txn_key_t) > rec->data_sz ) ) continue;
+    fd_blockstore_txn_key_t sig;
+    fd_memcpy( &sig, data + txns[j].id_off, sizeof(sig) );
+    fd_blockstore_archive_txn_t * txn_entry = fd_blockstore_archive_txn_map_query( archive->txn_map, &sig, NULL );
+    if( FD_LIKELY( txn_entry && txn_entry->rec_off==off ) ) fd_blockstore_archive_txn_map_remove( archive->txn_map, &sig );
+  }
+
+  archive->idx_off = off + rec->rec_sz;
+  archive->slot_lo = archive->idx_off < archive->file_sz
+                   ? ( (fd_blockstore_archive_rec_t const *)( archive->map + archive->idx_off ) )->slot
+                   : ULONG_MAX;
+}
+
+/* fd_blockstore_archive_rec_index adds the validated record at file
+   offset off, which is right after the last indexed record, to the slot
+   and txn indices.  If the indices are full, the oldest records are
+   dropped from them first, so indexing never fails.  Caller holds the
+   write lock and has already advanced file_sz past the record. */
+
+static void
+fd_blockstore_archive_rec_index( fd_blockstore_archive_t * archive, ulong off ) {
+  fd_blockstore_archive_rec_t const * rec  = (fd_blockstore_archive_rec_t const *)( archive->map + off );
+  ulong                               slot = rec->slot;
+
+  if( FD_UNLIKELY( fd_blockstore_archive_slot_map_query( archive->slot_map, &slot, NULL ) ) ) {
+    FD_LOG_WARNING(( "slot %lu archived more than once, keeping the first record", slot ));
+    return;
+  }
+
+  ulong txn_max = fd_blockstore_archive_txn_map_key_max( archive->txn_map );
+  while( archive->idx_off < off &&
+         ( fd_blockstore_archive_slot_map_is_full( archive->slot_map ) ||
+           fd_blockstore_archive_txn_map_key_cnt( archive->txn_map ) + fd_ulong_min( rec->txns_cnt, txn_max ) > txn_max ) ) {
+    fd_blockstore_archive_rec_evict( archive );
+  }
+
+  fd_blockstore_archive_slot_t * slot_entry = fd_blockstore_archive_slot_map_insert( archive->slot_map, &slot );
+  slot_entry->rec_off = off;
+
+  uchar const *              data = fd_blockstore_archive_rec_data( rec );
+  fd_block_txn_ref_t const * txns = fd_blockstore_archive_rec_txns( rec );
+  for( ulong j = 0; j < rec->txns_cnt; j++ ) {
+    if( FD_UNLIKELY( fd_blockstore_archive_txn_map_is_full( archive->txn_map ) ) ) break;
+    if( FD_UNLIKELY( txns[j].id_off + sizeof(fd_blockstore_txn_key_t) > rec->data_sz ) ) continue;
+    fd_blockstore_txn_key_t sig;
+    fd_memcpy( &sig, data + txns[j].id_off, sizeof(sig) );
+    if( FD_UNLIKELY( fd_blockstore_archive_txn_map_query( archive->txn_map, &sig, NULL ) ) ) continue;
+    fd_blockstore_archive_txn_t * txn_entry = fd_blockstore_archive_txn_map_insert( archive->txn_map, &sig );
+    txn_entry->rec_off = off;
+    txn_entry->txn_idx = j;
+  }
+
+  archive->slot_lo = fd_ulong_min( archive->slot_lo, slot );
+  archive->slot_hi = fd_ulong_max( archive->slot_hi, slot );
+}
+
+ulong
+fd_blockstore_archive_refresh( fd_blockstore_archive_t * archive ) {
+  if( FD_UNLIKELY( archive->fd==-1 ) ) return 0UL;
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( archive->fd, &st ) ) ) {
+    FD_LOG_WARNING(( "fstat failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return 0UL;
+  }
+  ulong file_sz = fd_ulong_min( (ulong)st.st_size, archive->file_max );
+
+  fd_readwrite_start_write( &archive->lock );
+  ulong cnt = 0UL;
+  for(;;) {
+    ulong off = archive->file_sz;
+    if( !fd_blockstore_archive_rec_validate( archive, off, file_sz ) ) break;
+    archive->file_sz = off + ( (fd_blockstore_archive_rec_t const *)( archive->map + off ) )->rec_sz;
+    archive->rec_cnt++;
+    fd_blockstore_archive_rec_index( archive, off );
+    cnt++;
+  }
+  fd_readwrite_end_write( &archive->lock );
+  return cnt;
+}
+
+int
+fd_blockstore_archive_open( fd_blockstore_archive_t * archive,
+                            char const *              path,
+                            ulong                     file_max,
+                            int                       writable ) {
+  if( FD_UNLIKELY( archive->fd!=-1 ) ) {
+    FD_LOG_WARNING(( "archive already open" ));
+    return FD_BLOCKSTORE_ERR_UNKNOWN;
+  }
+
+  if( FD_UNLIKELY( file_max < FD_BLOCKSTORE_ARCHIVE_REC_ALIGN ) ) {
+    FD_LOG_WARNING(( "file_max too small" ));
+    return FD_BLOCKSTORE_ERR_NO_MEM;
+  }
+
+  int fd = open( path, writable ? ( O_RDWR | O_CREAT ) : O_RDONLY, 0644 );
+  if( FD_UNLIKELY( fd<0 ) ) {
+    FD_LOG_WARNING(( "open(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    return FD_BLOCKSTORE_ERR_UNKNOWN;
+  }
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( fd, &st ) ) ) {
+    FD_LOG_WARNING(( "fstat(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    close( fd );
+    return FD_BLOCKSTORE_ERR_UNKNOWN;
+  }
+
+  if( st.st_size==0L && writable ) {
+    fd_blockstore_archive_hdr_t hdr = { .magic = FD_BLOCKSTORE_ARCHIVE_MAGIC, .rec_cnt_hint = 0UL };
+    if( FD_UNLIKELY( ftruncate( fd, (long)FD_BLOCKSTORE_ARCHIVE_REC_ALIGN ) ||
+                     fd_blockstore_archive_pwrite( fd, &hdr, sizeof(hdr), 0UL ) ) ) {
+      FD_LOG_WARNING(( "failed to initialize %s (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+      close( fd );
+      return FD_BLOCKSTORE_ERR_UNKNOWN;
+    }
+    st.st_size = (long)FD_BLOCKSTORE_ARCHIVE_REC_ALIGN;
+  }
+
+  if( FD_UNLIKELY( (ulong)st.st_size > file_max ) ) {
+    FD_LOG_WARNING(( "%s is larger than file_max %lu", path, file_max ));
+    close( fd );
+    return FD_BLOCKSTORE_ERR_NO_MEM;
+  }
+
+  fd_blockstore_archive_hdr_t hdr;
+  if( FD_UNLIKELY( (ulong)st.st_size < FD_BLOCKSTORE_ARCHIVE_REC_ALIGN ||
+                   pread( fd, &hdr, sizeof(hdr), 0L )!=(long)sizeof(hdr) ||
+                   hdr.magic!=FD_BLOCKSTORE_ARCHIVE_MAGIC ) ) {
+    FD_LOG_WARNING(( "%s is not a blockstore archive", path ));
+    close( fd );
+    return FD_BLOCKSTORE_ERR_UNKNOWN;
+  }
+
+  /* Map the whole allowed range up front so appends never require a
+     remap.  Pages past the end of the file are never touched. */
+
+  void * map = mmap( NULL, file_max, PROT_READ, MAP_SHARED, fd, 0L );
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    close( fd );
+    return FD_BLOCKSTORE_ERR_NO_MEM;
+  }
+
+  archive->fd       = fd;
+  archive->pid      = (long)getpid();
+  archive->writable = !!writable;
+  archive->map      = (uchar const *)map;
+  archive->file_max = file_max;
+  archive->file_sz  = FD_BLOCKSTORE_ARCHIVE_REC_ALIGN;
+  archive->idx_off  = FD_BLOCKSTORE_ARCHIVE_REC_ALIGN;
+  archive->rec_cnt  = 0UL;
+
+  ulong rec_cnt = fd_blockstore_archive_refresh( archive );
+
+  if( FD_UNLIKELY( writable && archive->file_sz < (ulong)st.st_size ) ) {
+    FD_LOG_WARNING(( "truncating %lu bytes of torn records from %s", (ulong)st.st_size - archive->file_sz, path ));
+    if( FD_UNLIKELY( ftruncate( fd, (long)archive->file_sz ) ) ) {
+      FD_LOG_WARNING(( "ftruncate(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+      fd_blockstore_archive_close( archive );
+      return FD_BLOCKSTORE_ERR_UNKNOWN;
+    }
+  }
+
+  FD_LOG_NOTICE(( "opened blockstore archive %s - records: %lu, size: %lu, indexed slots: [%lu, %lu]",
+                  path, rec_cnt, archive->file_sz, archive->slot_lo, archive->slot_hi ));
+  return FD_BLOCKSTORE_OK;
+}
+
+void
+fd_blockstore_archive_close( fd_blockstore_archive_t * archive ) {
+  if( FD_UNLIKELY( archive->fd==-1 ) ) return;
+
+  if( archive->writable ) {
+    fd_blockstore_archive_hdr_t hdr = {
+      .magic        = FD_BLOCKSTORE_ARCHIVE_MAGIC,
+      .rec_cnt_hint = archive->rec_cnt
+    };
+    if( FD_UNLIKELY( fd_blockstore_archive_pwrite( archive->fd, &hdr, sizeof(hdr), 0UL ) ) )
+      FD_LOG_WARNING(( "failed to update archive header (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+
+  if( FD_UNLIKELY( munmap( (void *)archive->map, archive->file_max ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( close( archive->fd ) ) )
+    FD_LOG_WARNING(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  if( archive->stage && FD_UNLIKELY( munmap( archive->stage, archive->stage_sz ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  archive->fd       = -1;
+  archive->pid      = 0L;
+  archive->writable = 0;
+  archive->map      = NULL;
+  archive->file_max = 0UL;
+  archive->file_sz  = 0UL;
+  archive->idx_off  = 0UL;
+  archive->rec_cnt  = 0UL;
+  archive->stage    = NULL;
+  archive->stage_sz = 0UL;
+  archive->slot_lo  = ULONG_MAX;
+  archive->slot_hi  = 0UL;
+
+  /* Reformat the indices in place */
+
+  fd_readwrite_start_write( &archive->lock );
+  void * slot_map = fd_blockstore_archive_slot_map_delete( fd_blockstore_archive_slot_map_leave( archive->slot_map ) );
+  void * txn_map  = fd_blockstore_archive_txn_map_delete( fd_blockstore_archive_txn_map_leave( archive->txn_map ) );
+  archive->slot_map = fd_blockstore_archive_slot_map_join( fd_blockstore_archive_slot_map_new( slot_map, archive->slot_max, archive->seed ) );
+  archive->txn_map  = fd_blockstore_archive_txn_map_join( fd_blockstore_archive_txn_map_new( txn_map, 1UL<<archive->lg_txn_max, archive->seed ) );
+  fd_readwrite_end_write( &archive->lock );
+}
+
+/* fd_blockstore_archive_stage_block lays out the record for the block
+   at slot and copies it into archive->stage with a zero magic.  Caller
+   holds the blockstore read lock.  If the stage is too small, returns
+   FD_BLOCKSTORE_ERR_NO_MEM with *_rec_sz set to the required size and
+   copies nothing. */
+
+static int
+fd_blockstore_archive_stage_block( fd_blockstore_archive_t * archive,
+                                   fd_blockstore_t *         blockstore,
+                                   ulong                     slot,
+                                   ulong *                   _rec_sz ) {
+  fd_wksp_t *                      wksp       = fd_blockstore_wksp( blockstore );
+  fd_blockstore_slot_map_t const * slot_entry = fd_blockstore_slot_map_query( fd_blockstore_slot_map( blockstore ), &slot, NULL );
+  if( FD_UNLIKELY( !slot_entry || !slot_entry->block_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+  fd_block_t const * block = fd_wksp_laddr_fast( wksp, slot_entry->block_gaddr );
+  if( FD_UNLIKELY( fd_uchar_extract_bit( block->flags, FD_BLOCK_FLAG_SNAPSHOT ) ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
+
+  fd_block_shred_t const *   shreds = block->shreds_cnt ? fd_wksp_laddr_fast( wksp, block->shreds_gaddr ) : NULL;
+  fd_block_micro_t const *   micros = block->micros_cnt ? fd_wksp_laddr_fast( wksp, block->micros_gaddr ) : NULL;
+  fd_block_txn_ref_t const * txns   = block->txns_cnt   ? fd_wksp_laddr_fast( wksp, block->txns_gaddr )   : NULL;
+  uchar const *              data   = block->data_sz    ? fd_wksp_laddr_fast( wksp, block->data_gaddr )   : NULL;
+
+  /* Lay out the record */
+
+  fd_blockstore_archive_rec_t rec;
+  fd_memset( &rec, 0, sizeof(rec) );
+  rec.slot        = slot;
+  rec.parent_slot = slot_entry->slot_meta.parent_slot;
+  rec.ts          = block->ts;
+  rec.height      = block->height;
+  rec.bank_hash   = block->bank_hash;
+  rec.flags       = block->flags;
+  rec.shreds_cnt  = block->shreds_cnt;
+  rec.micros_cnt  = block->micros_cnt;
+  rec.txns_cnt    = block->txns_cnt;
+  rec.data_sz     = block->data_sz;
+  for( ulong i = 0; i < rec.shreds_cnt; i++ ) rec.merkle_sz += fd_ulong_min( shreds[i].merkle_sz, FD_BLOCKSTORE_ARCHIVE_MERKLE_MAX );
+
+  ulong const align = FD_BLOCKSTORE_ARCHIVE_REC_ALIGN;
+  rec.shreds_off = fd_ulong_align_up( sizeof(fd_blockstore_archive_rec_t),                                  align );
+  rec.micros_off = fd_ulong_align_up( rec.shreds_off + rec.shreds_cnt*sizeof(fd_blockstore_archive_shred_t), align );
+  rec.txns_off   = fd_ulong_align_up( rec.micros_off + rec.micros_cnt*sizeof(fd_block_micro_t),              align );
+  rec.merkle_off = fd_ulong_align_up( rec.txns_off   + rec.txns_cnt  *sizeof(fd_block_txn_ref_t),            align );
+  rec.data_off   = fd_ulong_align_up( rec.merkle_off + rec.merkle_sz,                                         align );
+  rec.rec_sz     = fd_ulong_align_up( rec.data_off   + rec.data_sz,                                           align );
+
+  *_rec_sz = rec.rec_sz;
+  if( FD_UNLIKELY( rec.rec_sz > archive->stage_sz ) ) return FD_BLOCKSTORE_ERR_NO_MEM;
+
+  /* Copy the record image, padding included so no stale bytes reach
+     the file */
+
+  uchar * stage = archive->stage;
+  fd_memset( stage, 0, rec.rec_sz );
+  fd_memcpy( stage, &rec, sizeof(rec) );
+
+  fd_blockstore_archive_shred_t * dst_shreds = (fd_blockstore_archive_shred_t *)( stage + rec.shreds_off );
+  uchar *                         dst_merkle = stage + rec.merkle_off;
+  ulong                           merkle_off = 0UL;
+  for( ulong i = 0; i < rec.shreds_cnt; i++ ) {
+    ulong msz = fd_ulong_min( shreds[i].merkle_sz, FD_BLOCKSTORE_ARCHIVE_MERKLE_MAX );
+    fd_memcpy( dst_shreds[i].hdr, &shreds[i].hdr, FD_SHRED_DATA_HEADER_SZ );
+    dst_shreds[i].merkle_off = (uint)merkle_off;
+    dst_shreds[i].merkle_sz  = (uint)msz;
+    dst_shreds[i].off        = shreds[i].off;
+    fd_memcpy( dst_merkle + merkle_off, shreds[i].merkle, msz );
+    merkle_off += msz;
+  }
+  if( rec.micros_cnt ) fd_memcpy( stage + rec.micros_off, micros, rec.micros_cnt*sizeof(fd_block_micro_t)   );
+  if( rec.txns_cnt   ) fd_memcpy( stage + rec.txns_off,   txns,   rec.txns_cnt  *sizeof(fd_block_txn_ref_t) );
+  if( rec.data_sz    ) fd_memcpy( stage + rec.data_off,   data,   rec.data_sz                               );
+  return FD_BLOCKSTORE_OK;
+}
+
+/* fd_blockstore_archive_stage_reserve grows the stage to hold at least
+   sz bytes.  Returns FD_BLOCKSTORE_OK or FD_BLOCKSTORE_ERR_NO_MEM. */
+
+static int
+fd_blockstore_archive_stage_reserve( fd_blockstore_archive_t * archive, ulong sz ) {
+  if( FD_LIKELY( sz <= archive->stage_sz ) ) return FD_BLOCKSTORE_OK;
+  sz = fd_ulong_align_up( fd_ulong_max( sz, 2UL*archive->stage_sz ), FD_SHMEM_NORMAL_PAGE_SZ );
+  void * stage = mmap( NULL, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0L );
+  if( FD_UNLIKELY( stage==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(%lu KiB) failed (%i-%s)", sz>>10, errno, fd_io_strerror( errno ) ));
+    return FD_BLOCKSTORE_ERR_NO_MEM;
+  }
+  if( archive->stage && FD_UNLIKELY( munmap( archive->stage, archive->stage_sz ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  archive->stage    = (uchar *)stage;
+  archive->stage_sz = sz;
+  return FD_BLOCKSTORE_OK;
+}
+
+int
+fd_blockstore_archive_block( fd_blockstore_archive_t * archive,
+                             fd_blockstore_t *         blockstore,
+                             ulong                     slot ) {
+  if( FD_UNLIKELY( archive->fd==-1 || !archive->writable ) ) return FD_BLOCKSTORE_ERR_UNKNOWN;
+  if( FD_UNLIKELY( fd_blockstore_archive_slot_map_query( archive->slot_map, &slot, NULL ) ) ) return FD_BLOCKSTORE_OK;
+
+  /* Copy the block out under the read lock, growing the stage outside
+     of it if needed.  The file I/O below does not hold up blockstore
+     writers. */
+
+  ulong rec_sz = 0UL;
+  int   err;
+  for(;;) {
+    fd_blockstore_start_read( blockstore );
+    err = fd_blockstore_archive_stage_block( archive, blockstore, slot, &rec_sz );
+    fd_blockstore_end_read( blockstore );
+    if( FD_LIKELY( err!=FD_BLOCKSTORE_ERR_NO_MEM ) ) break;
+    err = fd_blockstore_archive_stage_reserve( archive, rec_sz );
+    if( FD_UNLIKELY( err ) ) return err;
+  }
+  if( FD_UNLIKELY( err ) ) return err;
+
+  ulong off = archive->file_sz;
+  if( FD_UNLIKELY( rec_sz > archive->file_max - off ) ) return FD_BLOCKSTORE_ERR_NO_MEM;
+
+  /* Write the record with a zero magic, then the magic.  A reader (or a
+     reopen after a crash) only sees the record once the magic lands, at
+     which point the rest of the record is in place. */
+
+  ulong magic = FD_BLOCKSTORE_ARCHIVE_REC_MAGIC;
+  int   io_err = 0;
+  if( FD_UNLIKELY( ftruncate( archive->fd, (long)( off + rec_sz ) ) ) ) io_err = errno;
+  if( !io_err ) io_err = fd_blockstore_archive_pwrite( archive->fd, archive->stage, rec_sz,        off );
+  if( !io_err ) io_err = fd_blockstore_archive_pwrite( archive->fd, &magic,         sizeof(magic), off );
+  if( FD_UNLIKELY( io_err ) ) {
+    FD_LOG_WARNING(( "failed to archive slot %lu (%i-%s)", slot, io_err, fd_io_strerror( io_err ) ));
+    if( FD_UNLIKELY( ftruncate( archive->fd, (long)off ) ) )
+      FD_LOG_WARNING(( "ftruncate failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return FD_BLOCKSTORE_ERR_UNKNOWN;
+  }
+
+  fd_readwrite_start_write( &archive->lock );
+  archive->file_sz = off + rec_sz;
+  archive->rec_cnt++;
+  fd_blockstore_archive_rec_index( archive, off );
+  fd_readwrite_end_write( &archive->lock );
+  return FD_BLOCKSTORE_OK;
+}
+
+ulong
+fd_blockstore_archive_sync( fd_blockstore_archive_t * archive,
+                            fd_blockstore_t *         blockstore,
+                            ulong                     root ) {
+  if( FD_UNLIKELY( archive->fd==-1 || !archive->writable ) ) return 0UL;
+
+  /* Walk back from root to the most recent archived ancestor */
+
+  fd_blockstore_start_read( blockstore );
+  fd_blockstore_slot_map_t * slot_map = fd_blockstore_slot_map( blockstore );
+  ulong                      path_cnt = 0UL;
+  ulong                      curr     = root;
+  while( path_cnt < archive->slot_max && curr!=FD_SLOT_NULL ) {
+    if( archive->slot_hi && curr <= archive->slot_hi ) break;
+    fd_blockstore_slot_map_t const * slot_entry = fd_blockstore_slot_map_query( slot_map, &curr, NULL );
+    if( FD_UNLIKELY( !slot_entry || !slot_entry->block_gaddr ) ) break;
+    fd_block_t const * block = fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), slot_entry->block_gaddr );
+    if( FD_UNLIKELY( fd_uchar_extract_bit( block->flags, FD_BLOCK_FLAG_SNAPSHOT ) ) ) break;
+    archive->path[ path_cnt++ ] = curr;
+    if( FD_UNLIKELY( slot_entry->slot_meta.parent_slot >= curr ) ) break;
+    curr = slot_entry->slot_meta.parent_slot;
+  }
+  fd_blockstore_end_read( blockstore );
+
+  /* Archive oldest first so slot_hi only advances over archived slots.
+     Each block is copied out under the read lock by
+     fd_blockstore_archive_block, the file is written without it. */
+
+  ulong cnt = 0UL;
+  while( path_cnt ) {
+    ulong slot = archive->path[ --path_cnt ];
+    int   err  = fd_blockstore_archive_block( archive, blockstore, slot );
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "failed to archive slot %lu (%d)", slot, err ));
+      break;
+    }
+    cnt++;
+  }
+  return cnt;
+}
+
+void
+fd_blockstore_archive_attach( fd_blockstore_archive_t * archive,
+                              fd_blockstore_t *         blockstore ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+  if( FD_UNLIKELY( fd_wksp_containing( archive )!=wksp ) ) {
+    FD_LOG_WARNING(( "archive is not in the blockstore's wksp, not attaching" ));
+    return;
+  }
+  fd_blockstore_start_write( blockstore );
+  blockstore->archive_gaddr = fd_wksp_gaddr_fast( wksp, archive );
+  fd_blockstore_end_write( blockstore );
+}
+
+void
+fd_blockstore_archive_detach( fd_blockstore_t * blockstore ) {
+  fd_blockstore_start_write( blockstore );
+  blockstore->archive_gaddr = 0UL;
+  fd_blockstore_end_write( blockstore );
+}
+
+fd_blockstore_archive_rec_t const *
+fd_blockstore_archive_rec_query( fd_blockstore_archive_t * archive, ulong slot ) {
+  if( FD_UNLIKELY( archive->fd==-1 || archive->pid!=(long)getpid() ) ) return NULL;
+  fd_readwrite_start_read( &archive->lock );
+  fd_blockstore_archive_slot_t const * slot_entry =
+      fd_blockstore_archive_slot_map_query_const( archive->slot_map, &slot, NULL );
+  ulong rec_off = slot_entry ? slot_entry->rec_off : 0UL;
+  fd_readwrite_end_read( &archive->lock );
+  if( FD_UNLIKELY( !rec_off ) ) return NULL;
+  return (fd_blockstore_archive_rec_t const *)( archive->map + rec_off );
+}
+
+ulong
+fd_blockstore_archive_parent_slot_query( fd_blockstore_archive_t * archive, ulong slot ) {
+  fd_blockstore_archive_rec_t const * rec = fd_blockstore_archive_rec_query( archive, slot );
+  if( FD_UNLIKELY( !rec ) ) return FD_SLOT_NULL;
+  return rec->parent_slot;
+}
+
+long
+fd_blockstore_archive_shred_query_copy_data( fd_blockstore_archive_t * archive,
+                                             ulong                     slot,
+                                             uint                      shred_idx,
+                                             void *                    buf,
+                                             ulong                     buf_max ) {
+  if( buf_max < FD_SHRED_MAX_SZ ) return -1;
+
+  fd_blockstore_archive_rec_t const * rec = fd_blockstore_archive_rec_query( archive, slot );
+  if( FD_UNLIKELY( !rec || !rec->shreds_cnt ) ) return -1;
+  if( shred_idx==UINT_MAX ) shred_idx = (uint)( rec->shreds_cnt - 1UL );
+  if( FD_UNLIKELY( shred_idx >= rec->shreds_cnt ) ) return -1;
+
+  fd_blockstore_archive_shred_t const * shred = fd_blockstore_archive_rec_shreds( rec ) + shred_idx;
+  ulong sz        = fd_shred_payload_sz( (fd_shred_t const *)shred->hdr );
+  ulong merkle_sz = shred->merkle_sz;
+  if( FD_UNLIKELY( shred->off + sz > rec->data_sz ||
+                   (ulong)shred->merkle_off + merkle_sz > rec->merkle_sz ) ) return -1;
+  ulong tot_sz = FD_SHRED_DATA_HEADER_SZ + sz + merkle_sz;
+  if( tot_sz > buf_max ) return -1;
+  fd_memcpy( buf, shred->hdr, FD_SHRED_DATA_HEADER_SZ );
+  fd_memcpy( (uchar*)buf + FD_SHRED_DATA_HEADER_SZ, fd_blockstore_archive_rec_data( rec ) + shred->off, sz );
+  fd_memcpy( (uchar*)buf + FD_SHRED_DATA_HEADER_SZ + sz, (uchar const *)rec + rec->merkle_off + shred->merkle_off, merkle_sz );
+  if( tot_sz >= FD_SHRED_MIN_SZ ) return (long)tot_sz;
+  /* Zero pad */
+  fd_memset( (uchar*)buf + tot_sz, 0, FD_SHRED_MIN_SZ - tot_sz );
+  return (long)FD_SHRED_MIN_SZ;
+}
+
+int
+fd_blockstore_archive_txn_query( fd_blockstore_archive_t * archive,
+                                 uchar const               sig[FD_ED25519_SIG_SZ],
+                                 fd_blockstore_txn_map_t * txn_out,
+                                 long *                    blk_ts,
+                                 uchar                     txn_data_out[FD_TXN_MTU] ) {
+  if( FD_UNLIKELY( archive->fd==-1 || archive->pid!=(long)getpid() ) ) return FD_BLOCKSTORE_ERR_TXN_MISSING;
+
+  fd_blockstore_txn_key_t key;
+  fd_memcpy( &key, sig, sizeof(key) );
+  fd_readwrite_start_read( &archive->lock );
+  fd_blockstore_archive_txn_t const * txn_entry =
+      fd_blockstore_archive_txn_map_query_const( archive->txn_map, &key, NULL );
+  ulong rec_off = txn_entry ? txn_entry->rec_off : 0UL;
+  ulong txn_idx = txn_entry ? txn_entry->txn_idx : 0UL;
+  fd_readwrite_end_read( &archive->lock );
+  if( FD_UNLIKELY( !rec_off ) ) return FD_BLOCKSTORE_ERR_TXN_MISSING;
+
+  fd_blockstore_archive_rec_t const * rec = (fd_blockstore_archive_rec_t const *)( archive->map + rec_off );
+  fd_block_txn_ref_t const *          ref = fd_blockstore_archive_rec_txns( rec ) + txn_idx;
+  if( FD_UNLIKELY( ref->txn_off + ref->sz > rec->data_sz || ref->sz > FD_TXN_MTU ) ) return FD_BLOCKSTORE_ERR_TXN_MISSING;
+
+  fd_memset( txn_out, 0, sizeof(fd_blockstore_txn_map_t) );
+  txn_out->sig    = key;
+  txn_out->slot   = rec->slot;
+  txn_out->offset = ref->txn_off;
+  txn_out->sz     = ref->sz;
+  if( blk_ts ) *blk_ts = rec->ts;
+  if( txn_data_out ) fd_memcpy( txn_data_out, fd_blockstore_archive_rec_data( rec ) + ref->txn_off, ref->sz );
+  return FD_BLOCKSTORE_OK;
+}
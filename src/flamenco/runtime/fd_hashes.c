@@ -34,20 +34,17 @@ fd_pubkey_hash_pair_compare(fd_pubkey_hash_pair_t const * a, fd_pubkey_hash_pair
 #define FD_ACCOUNT_DELTAS_MERKLE_FANOUT (16UL)
 #define FD_ACCOUNT_DELTAS_MAX_MERKLE_HEIGHT (16UL)
 
-void
-fd_hash_account_deltas( fd_pubkey_hash_pair_t * pairs, ulong pairs_len, fd_hash_t * hash, fd_exec_slot_ctx_t * slot_ctx FD_PARAM_UNUSED ) {
+/* fd_hash_account_deltas_sorted is fd_hash_account_deltas for pairs
+   that are already sorted by pubkey. */
+
+static void
+fd_hash_account_deltas_sorted( fd_pubkey_hash_pair_t const * pairs, ulong pairs_len, fd_hash_t * hash, fd_exec_slot_ctx_t * slot_ctx FD_PARAM_UNUSED ) {
   fd_sha256_t shas[FD_ACCOUNT_DELTAS_MAX_MERKLE_HEIGHT];
   uchar       num_hashes[FD_ACCOUNT_DELTAS_MAX_MERKLE_HEIGHT+1];
 
   // Init the number of hashes
   fd_memset( num_hashes, 0, sizeof(num_hashes) );
 
-  // FD_LOG_DEBUG(("sorting %d", pairs_len));
-  // long timer_sort = -fd_log_wallclock();
-  sort_pubkey_hash_pair_inplace( pairs, pairs_len );
-  // timer_sort += fd_log_wallclock();
-  // FD_LOG_DEBUG(("sorting done %6.3f ms", (double)timer_sort*(1e-6)));
-
   // FD_LOG_DEBUG(("fancy bmtree started"));
   for( ulong j = 0; j < FD_ACCOUNT_DELTAS_MAX_MERKLE_HEIGHT; ++j ) {
     fd_sha256_init( &shas[j] );
@@ -183,6 +180,17 @@ fd_hash_account_deltas( fd_pubkey_hash_pair_t * pairs, ulong pairs_len, fd_hash_
   // If the level at the `height' was rolled into, do something about it
 }
 
+void
+fd_hash_account_deltas( fd_pubkey_hash_pair_t * pairs, ulong pairs_len, fd_hash_t * hash, fd_exec_slot_ctx_t * slot_ctx ) {
+  // FD_LOG_DEBUG(("sorting %d", pairs_len));
+  // long timer_sort = -fd_log_wallclock();
+  sort_pubkey_hash_pair_inplace( pairs, pairs_len );
+  // timer_sort += fd_log_wallclock();
+  // FD_LOG_DEBUG(("sorting done %6.3f ms", (double)timer_sort*(1e-6)));
+
+  fd_hash_account_deltas_sorted( pairs, pairs_len, hash, slot_ctx );
+}
+
 
 void
 fd_calculate_epoch_accounts_hash_values(fd_exec_slot_ctx_t * slot_ctx) {
@@ -272,6 +280,133 @@ fd_account_lthash( fd_lthash_value_t *       lthash_value,
   return;
 }
 
+/* fd_account_rec_lthash_msg returns the stored hash of the account
+   version rec, whose lthash is the contribution of rec to the accounts
+   lthash.  Returns NULL if rec contributes nothing: there is no such
+   account (rec NULL), it was erased or it has no lamports. */
+
+static uchar const *
+fd_account_rec_lthash_msg( fd_funk_t *           funk,
+                           fd_funk_rec_t const * rec ) {
+  if( !rec || ( rec->flags & FD_FUNK_REC_FLAG_ERASE ) || fd_funk_val_sz( rec )<sizeof(fd_account_meta_t) ) return NULL;
+  fd_account_meta_t const * meta = fd_funk_val_const( rec, fd_funk_wksp( funk ) );
+  return meta->info.lamports ? meta->hash : NULL;
+}
+
+/* fd_accounts_lthash_delta_task accumulates the change of the accounts
+   lthash caused by the account records recs[m0,m1) of the slot's funk
+   txn: the contributions of the records go to reduce[2*n0] and those
+   of the versions visible from the parent txn to reduce[2*n0+1].  Both
+   sides are expanded in batches.  This only reads funk, so the records
+   of a slot can be split across workers. */
+
+static void
+fd_accounts_lthash_delta_task( void *tpool,
+                               ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
+                               void *args,
+                               void *reduce, ulong stride FD_PARAM_UNUSED,
+                               ulong l0 FD_PARAM_UNUSED, ulong l1 FD_PARAM_UNUSED,
+                               ulong m0, ulong m1,
+                               ulong n0, ulong n1 FD_PARAM_UNUSED ) {
+  fd_exec_slot_ctx_t *          slot_ctx = (fd_exec_slot_ctx_t *)tpool;
+  fd_funk_rec_t const * const * recs     = (fd_funk_rec_t const * const *)args;
+  fd_lthash_value_t *           sums     = (fd_lthash_value_t *)reduce + 2UL*n0;
+
+  fd_funk_t *     funk    = slot_ctx->acc_mgr->funk;
+  fd_funk_txn_t * txn_map = fd_funk_txn_map( funk, fd_funk_wksp( funk ) );
+  fd_funk_txn_t * parent  = fd_funk_txn_parent( slot_ctx->funk_txn, txn_map );
+
+  uchar add_mem[ FD_LTHASH_BATCH_FOOTPRINT ] __attribute__((aligned(FD_LTHASH_BATCH_ALIGN)));
+  uchar sub_mem[ FD_LTHASH_BATCH_FOOTPRINT ] __attribute__((aligned(FD_LTHASH_BATCH_ALIGN)));
+  fd_lthash_batch_t * add = fd_lthash_batch_init( add_mem, sums+0 );
+  fd_lthash_batch_t * sub = fd_lthash_batch_init( sub_mem, sums+1 );
+
+  /* The stored hashes stay put until the batches are finished as funk
+     isn't modified here */
+  for( ulong i = m0; i < m1; i++ ) {
+    uchar const * msg = fd_account_rec_lthash_msg( funk, recs[i] );
+    if( msg ) fd_lthash_batch_add( add, msg, 32UL );
+
+    fd_funk_rec_t const * old_rec = NULL;
+    fd_acc_mgr_view_raw( slot_ctx->acc_mgr, parent, fd_type_pun_const( recs[i]->pair.key[0].uc ), &old_rec, NULL );
+    msg = fd_account_rec_lthash_msg( funk, old_rec );
+    if( msg ) fd_lthash_batch_add( sub, msg, 32UL );
+  }
+
+  fd_lthash_batch_fini( add );
+  fd_lthash_batch_fini( sub );
+}
+
+static void
+fd_accounts_lthash_compute( fd_exec_slot_ctx_t * slot_ctx,
+                            fd_lthash_value_t *  out,
+                            fd_tpool_t *         tpool,
+                            ulong                max_workers );
+
+/* fd_accounts_lthash_update brings the accounts lthash of the slot bank
+   up to date with the account hashes stored in the slot's funk txn.
+   The change is computed over every account record of the txn against
+   the parent version and applied to the lthash the slot started from,
+   so calling this again for the same slot (e.g. after more accounts
+   were modified) gives the same result as calling it once.  Without a
+   txn the root is modified in place (e.g. at genesis), the previous
+   versions are gone and the lthash is recomputed from scratch. */
+
+static void
+fd_accounts_lthash_update( fd_exec_slot_ctx_t * slot_ctx,
+                           fd_tpool_t *         tpool,
+                           ulong                max_workers ) {
+  if( !slot_ctx->enable_lthash ) return;
+
+  fd_funk_t *     funk = slot_ctx->acc_mgr->funk;
+  fd_funk_txn_t * txn  = slot_ctx->funk_txn;
+  ulong part_cnt = ( tpool && max_workers>1UL ) ? max_workers : 1UL;
+
+  /* An added and a subtracted accumulator per worker */
+  fd_lthash_value_t * sums = fd_valloc_malloc( slot_ctx->valloc, FD_LTHASH_ALIGN, 2UL * part_cnt * sizeof(fd_lthash_value_t) );
+  if( FD_UNLIKELY( !sums ) ) FD_LOG_ERR(( "failed to allocate lthash accumulators" ));
+
+  if( FD_UNLIKELY( !txn ) ) {
+    fd_accounts_lthash_compute( slot_ctx, sums, tpool, max_workers );
+    fd_memcpy( slot_ctx->slot_bank.lthash, sums[0].bytes, FD_LTHASH_LEN_BYTES );
+    fd_valloc_free( slot_ctx->valloc, sums );
+    return;
+  }
+
+  if( slot_ctx->lthash_slot!=slot_ctx->slot_bank.slot ) {
+    fd_memcpy( slot_ctx->lthash_base, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES );
+    slot_ctx->lthash_slot = slot_ctx->slot_bank.slot;
+  }
+
+  ulong rec_cnt = 0;
+  for( fd_funk_rec_t const * rec = fd_funk_txn_first_rec( funk, txn ); rec; rec = fd_funk_txn_next_rec( funk, rec ) ) {
+    rec_cnt += !!fd_funk_key_is_acc( rec->pair.key );
+  }
+  fd_funk_rec_t const * * recs = fd_valloc_malloc( slot_ctx->valloc, 8UL, fd_ulong_max( rec_cnt, 1UL ) * sizeof(fd_funk_rec_t const *) );
+  if( FD_UNLIKELY( !recs ) ) FD_LOG_ERR(( "failed to allocate lthash record list" ));
+  rec_cnt = 0;
+  for( fd_funk_rec_t const * rec = fd_funk_txn_first_rec( funk, txn ); rec; rec = fd_funk_txn_next_rec( funk, rec ) ) {
+    if( fd_funk_key_is_acc( rec->pair.key ) ) recs[ rec_cnt++ ] = rec;
+  }
+
+  for( ulong i = 0; i < 2UL*part_cnt; i++ ) fd_lthash_zero( &sums[i] );
+  if( part_cnt>1UL ) fd_tpool_exec_all_batch( tpool, 0, max_workers, fd_accounts_lthash_delta_task, slot_ctx, recs, sums, 1, 0, rec_cnt );
+  else               fd_accounts_lthash_delta_task( slot_ctx, 0UL, 1UL, recs, sums, 1UL, 0UL, rec_cnt, 0UL, rec_cnt, 0UL, 1UL );
+
+  /* The slot bank copies aren't necessarily aligned for lthash
+     arithmetic, hence the round trip through a local. */
+  fd_lthash_value_t acc[1];
+  fd_memcpy( acc->bytes, slot_ctx->lthash_base, FD_LTHASH_LEN_BYTES );
+  for( ulong i = 0; i < part_cnt; i++ ) {
+    fd_lthash_add( acc, &sums[2UL*i+0UL] );
+    fd_lthash_sub( acc, &sums[2UL*i+1UL] );
+  }
+  fd_memcpy( slot_ctx->slot_bank.lthash, acc->bytes, FD_LTHASH_LEN_BYTES );
+
+  fd_valloc_free( slot_ctx->valloc, recs );
+  fd_valloc_free( slot_ctx->valloc, sums );
+}
+
 // slot_ctx should be const.
 static void
 fd_hash_bank( fd_exec_slot_ctx_t * slot_ctx,
@@ -324,6 +459,12 @@ fd_hash_bank( fd_exec_slot_ctx_t * slot_ctx,
                    slot_ctx->account_delta_hash.hash,
                    slot_ctx->signature_cnt,
                    slot_ctx->slot_bank.poh.hash ) );
+
+  if( slot_ctx->enable_lthash ) {
+    fd_hash_t lthash_checksum;
+    fd_accounts_lthash_checksum( slot_ctx, &lthash_checksum );
+    FD_LOG_NOTICE(( "slot %lu accounts lthash checksum %32J", slot_ctx->slot_bank.slot, lthash_checksum.hash ));
+  }
 }
 
 struct fd_accounts_hash_task_info {
@@ -477,26 +618,6 @@ fd_update_hash_bank_tpool( fd_exec_slot_ctx_t * slot_ctx,
       FD_LOG_ERR(( "failed to modify account during bank hash" ));
     }
 
-#ifdef _ENABLE_LTHASH
-  // Subtract the previous hash from the running total
-  fd_lthash_t lthash;
-
-  fd_lthash_init( &lthash );
-  fd_lthash_append( &lthash, acc_rec->meta->hash, 32 );
-  fd_lthash_value_t old_lthash_value;
-  fd_lthash_fini( &lthash, &old_lthash_value );
-
-  fd_lthash_value_t * acc = (fd_lthash_value_t *)fd_type_pun(slot_ctx->slot_bank.lthash);
-
-  fd_lthash_sub( acc, &old_lthash_value );
-
-  // Add the new hash
-  fd_lthash_value_t new_lthash_value;
-  fd_account_lthash( &new_lthash_value, slot_ctx, acc_rec->meta, acc_key, acc_rec->const_data );
-
-  fd_lthash_add( acc, &new_lthash_value );
-#endif
-
     /* Update hash */
 
     memcpy( acc_rec->meta->hash, task_info->acc_hash->hash, sizeof(fd_hash_t) );
@@ -534,12 +655,16 @@ fd_update_hash_bank_tpool( fd_exec_slot_ctx_t * slot_ctx,
 
   // FD_LOG_DEBUG(("slot %ld, dirty %ld", slot_ctx->slot_bank.slot, dirty_key_cnt));
 
+  /* Fold the accounts of the slot into the running accounts lthash.
+     This is O(changed accounts) instead of a walk of the database. */
+  fd_accounts_lthash_update( slot_ctx, tpool, max_workers );
+
   slot_ctx->signature_cnt = signature_cnt;
   fd_hash_bank( slot_ctx, capture_ctx, hash, dirty_keys, dirty_key_cnt);
 
 #ifdef _ENABLE_LTHASH
   // Sanity-check LT Hash
-  fd_accounts_check_lthash( slot_ctx );
+  if( slot_ctx->enable_lthash ) fd_accounts_check_lthash( slot_ctx );
 #endif
 
   for( ulong i = 0; i < task_infos_sz; i++ ) {
@@ -700,6 +825,8 @@ fd_update_hash_bank( fd_exec_slot_ctx_t * slot_ctx,
     fd_pubkey_t const *       acc_key  = fd_type_pun_const( rec->pair.key[0].uc );
 
     if( !fd_funk_key_is_acc( rec->pair.key  ) ) continue;
+    /* Dead accounts erased by an earlier call for this slot */
+    if( rec->flags & FD_FUNK_REC_FLAG_ERASE ) continue;
     if( !fd_funk_rec_is_modified( funk, rec ) ) continue;
 
     /* Get dirty account */
@@ -799,15 +926,14 @@ fd_update_hash_bank( fd_exec_slot_ctx_t * slot_ctx,
 
   // FD_LOG_DEBUG(("slot %ld, dirty %ld", slot_ctx->slot_bank.slot, dirty_key_cnt));
 
+  fd_accounts_lthash_update( slot_ctx, NULL, 0UL );
+
   slot_ctx->signature_cnt = signature_cnt;
   fd_hash_bank( slot_ctx, capture_ctx, hash, dirty_keys, dirty_key_cnt );
 
 #ifdef _ENABLE_LTHASH
   // Sanity-check LT Hash
-  fd_accounts_check_lthash( slot_ctx );
-
-  // Check that the old account_delta_hash is the same as the lthash
-  FD_TEST( 0==memcmp( slot_ctx->slot_bank.lthash, slot_ctx->account_delta_hash.hash, sizeof(fd_hash_t) ) );
+  if( slot_ctx->enable_lthash ) fd_accounts_check_lthash( slot_ctx );
 #endif
 
   fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx );
@@ -891,26 +1017,6 @@ fd_hash_account_current( uchar                      hash  [ static 32 ],
     return fd_hash_account_v0( hash, account, pubkey, data, slot_ctx->slot_bank.slot );
 }
 
-struct accounts_hash {
-  fd_funk_rec_t * key;
-  ulong  hash;
-};
-typedef struct accounts_hash accounts_hash_t;
-
-#define MAP_NAME accounts_hash
-#define MAP_KEY_T fd_funk_rec_t *
-#define MAP_HASH_T ulong
-#define MAP_KEY_EQUAL(k0,k1) ((NULL != k0) && (NULL != k1) && fd_funk_rec_key_eq( k0->pair.key, k1->pair.key ))
-#define MAP_KEY_HASH(p) fd_funk_rec_key_hash( p->pair.key, 2887034UL )
-#define MAP_KEY_EQUAL_IS_SLOW 1
-#define MAP_KEY_NULL 0UL
-#define MAP_KEY_INVAL(k) (NULL == k)
-
-// #define MAP_KEY_COPY(kd,ks)   fd_funk_xid_key_pair_copy((kd),(ks))
-
-#define MAP_T    accounts_hash_t
-#include "../../util/tmpl/fd_map_dynamic.c"
-
 int
 fd_accounts_hash( fd_exec_slot_ctx_t * slot_ctx, fd_hash_t *accounts_hash, fd_funk_txn_t * child_txn, ulong do_hash_verify, int with_dead ) {
   FD_LOG_NOTICE(("accounts_hash start for txn %p, do_hash_verify=%s, with_dead=%s", (void *)child_txn, do_hash_verify ? "true" : "false", with_dead ? "true": "false"));
@@ -1006,122 +1112,245 @@ fd_snapshot_hash( fd_exec_slot_ctx_t * slot_ctx, fd_hash_t *accounts_hash, fd_fu
   return fd_accounts_hash(slot_ctx, accounts_hash, child_txn, check_hash, with_dead );
 }
 
-#ifdef _ENABLE_LTHASH
+/* The parallel accounts hash buckets the pairs by the first byte of
+   the pubkey, which is also the most significant byte of the sort
+   order.  The buckets are laid out back to back, each holding the
+   pairs found by partition 0, then partition 1, ..., so that sorting
+   each bucket in place sorts the whole array. */
+
+#define FD_ACCOUNTS_HASH_BUCKET_CNT (256UL)
+
+struct fd_accounts_hash_walk {
+  fd_funk_t *             funk;
+  ulong                   part_cnt;
+  ulong *                 cursor; /* cursor[ part_idx*FD_ACCOUNTS_HASH_BUCKET_CNT + bucket ] */
+  fd_pubkey_hash_pair_t * pairs;  /* NULL when counting */
+  ulong const *           bucket_off;
+};
+typedef struct fd_accounts_hash_walk fd_accounts_hash_walk_t;
+
+/* fd_accounts_hash_walk_task walks partition m0 of the record map for
+   the root accounts fd_accounts_hash would include (live, with a sane
+   executable flag).  When counting, it counts them by bucket into its
+   cursors; otherwise it writes their pairs at its cursors. */
+
+static void
+fd_accounts_hash_walk_task( void *tpool,
+                            ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
+                            void *args FD_PARAM_UNUSED,
+                            void *reduce FD_PARAM_UNUSED, ulong stride FD_PARAM_UNUSED,
+                            ulong l0 FD_PARAM_UNUSED, ulong l1 FD_PARAM_UNUSED,
+                            ulong m0, ulong m1 FD_PARAM_UNUSED,
+                            ulong n0 FD_PARAM_UNUSED, ulong n1 FD_PARAM_UNUSED ) {
+  fd_accounts_hash_walk_t * walk    = (fd_accounts_hash_walk_t *)tpool;
+  fd_funk_t *               funk    = walk->funk;
+  fd_wksp_t *               wksp    = fd_funk_wksp( funk );
+  fd_funk_rec_t *           rec_map = fd_funk_rec_map( funk, wksp );
+  ulong *                   cursor  = walk->cursor + m0*FD_ACCOUNTS_HASH_BUCKET_CNT;
+
+  ulong e0; ulong e1;
+  FD_TPOOL_PARTITION( 0UL, fd_funk_rec_map_key_max( rec_map ), 1UL, m0, walk->part_cnt, e0, e1 );
+
+  /* Map iterators count down and iterator i refers to element i-1 */
+  for( fd_funk_rec_map_iter_t iter = fd_funk_rec_map_iter_next( rec_map, e1+1UL );
+       iter>e0;
+       iter = fd_funk_rec_map_iter_next( rec_map, iter ) ) {
+    fd_funk_rec_t const * rec = fd_funk_rec_map_iter_ele_const( rec_map, iter );
+    if( !fd_funk_key_is_acc( rec->pair.key ) ) continue;
+    if( !fd_funk_txn_idx_is_null( fd_funk_txn_idx( rec->txn_cidx ) ) ) continue;
+
+    fd_account_meta_t const * metadata = fd_funk_val_const( rec, wksp );
+    if( metadata->info.lamports==0 ) continue;
+    if( (metadata->info.executable & ~1)!=0 ) continue;
+
+    ulong bucket = rec->pair.key->uc[0];
+    if( walk->pairs ) {
+      fd_pubkey_hash_pair_t * pair = walk->pairs + cursor[ bucket ];
+      pair->pubkey = (fd_pubkey_t const *)rec->pair.key->uc;
+      pair->hash   = (fd_hash_t const *)metadata->hash;
+    }
+    cursor[ bucket ]++;
+  }
+}
+
+static void
+fd_accounts_hash_sort_task( void *tpool,
+                            ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
+                            void *args FD_PARAM_UNUSED,
+                            void *reduce FD_PARAM_UNUSED, ulong stride FD_PARAM_UNUSED,
+                            ulong l0 FD_PARAM_UNUSED, ulong l1 FD_PARAM_UNUSED,
+                            ulong m0, ulong m1 FD_PARAM_UNUSED,
+                            ulong n0 FD_PARAM_UNUSED, ulong n1 FD_PARAM_UNUSED ) {
+  fd_accounts_hash_walk_t * walk = (fd_accounts_hash_walk_t *)tpool;
+  ulong b0 = walk->bucket_off[ m0 ];
+  sort_pubkey_hash_pair_inplace( walk->pairs + b0, walk->bucket_off[ m0+1UL ] - b0 );
+}
+
 int
-fd_accounts_init_lthash( fd_exec_slot_ctx_t * slot_ctx ) {
-  // Initialize the lhash value to zero
-  fd_lthash_value_t * acc_lthash = (fd_lthash_value_t *)fd_type_pun_const( slot_ctx->slot_bank.lthash );
-  fd_lthash_zero( acc_lthash );
+fd_accounts_hash_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                        fd_hash_t *          accounts_hash,
+                        fd_tpool_t *         tpool,
+                        ulong                max_workers ) {
+  if( !tpool || max_workers<2UL ) return fd_accounts_hash( slot_ctx, accounts_hash, NULL, 0UL, 0 );
+
+  long dt = -fd_log_wallclock();
+
+  ulong part_cnt = max_workers;
+  ulong * cursor = fd_valloc_malloc( slot_ctx->valloc, alignof(ulong), part_cnt * FD_ACCOUNTS_HASH_BUCKET_CNT * sizeof(ulong) );
+  if( FD_UNLIKELY( !cursor ) ) FD_LOG_ERR(( "failed to allocate accounts hash cursors" ));
+  fd_memset( cursor, 0, part_cnt * FD_ACCOUNTS_HASH_BUCKET_CNT * sizeof(ulong) );
+
+  ulong bucket_off[ FD_ACCOUNTS_HASH_BUCKET_CNT+1UL ];
+  fd_accounts_hash_walk_t walk[1] = {{
+    .funk       = slot_ctx->acc_mgr->funk,
+    .part_cnt   = part_cnt,
+    .cursor     = cursor,
+    .pairs      = NULL,
+    .bucket_off = bucket_off
+  }};
+
+  /* Count, then turn the counts into the cursors of the bucket major,
+     partition minor layout */
+
+  fd_tpool_exec_all_rrobin( tpool, 0, max_workers, fd_accounts_hash_walk_task, walk, NULL, NULL, 1, 0, part_cnt );
+
+  ulong pair_cnt = 0UL;
+  for( ulong b = 0UL; b < FD_ACCOUNTS_HASH_BUCKET_CNT; b++ ) {
+    bucket_off[ b ] = pair_cnt;
+    for( ulong p = 0UL; p < part_cnt; p++ ) {
+      ulong cnt = cursor[ p*FD_ACCOUNTS_HASH_BUCKET_CNT + b ];
+      cursor[ p*FD_ACCOUNTS_HASH_BUCKET_CNT + b ] = pair_cnt;
+      pair_cnt += cnt;
+    }
+  }
+  bucket_off[ FD_ACCOUNTS_HASH_BUCKET_CNT ] = pair_cnt;
 
-  // Iterate over all accounts in the database
-  fd_funk_t *     funk = slot_ctx->acc_mgr->funk;
+  walk->pairs = fd_valloc_malloc( slot_ctx->valloc, FD_PUBKEY_HASH_PAIR_ALIGN, fd_ulong_max( pair_cnt, 1UL ) * sizeof(fd_pubkey_hash_pair_t) );
+  if( FD_UNLIKELY( !walk->pairs ) ) FD_LOG_ERR(( "failed to allocate %lu accounts hash pairs", pair_cnt ));
 
-  for (
-    fd_funk_rec_t const *rec = fd_funk_txn_first_rec( funk, NULL); NULL != rec; rec = fd_funk_txn_next_rec(funk, rec))
-    {
-      if ( fd_funk_key_is_acc( rec->pair.key ) ) {
-        void const * data = fd_funk_val( rec, fd_funk_wksp(funk) );
-        fd_account_meta_t const * metadata = (fd_account_meta_t const *)fd_type_pun_const( data );
-        FD_TEST ( metadata->magic == FD_ACCOUNT_META_MAGIC );
+  /* Nothing is written to funk in between, so the second walk finds
+     exactly the accounts the first one counted */
 
-        // Create the lthash for this account, by hashing the account hash
-        fd_lthash_t lthash;
-        fd_lthash_init( &lthash );
-        fd_lthash_append( &lthash, metadata->hash, 32 );
+  fd_tpool_exec_all_rrobin( tpool, 0, max_workers, fd_accounts_hash_walk_task, walk, NULL, NULL, 1, 0, part_cnt );
+  fd_tpool_exec_all_rrobin( tpool, 0, max_workers, fd_accounts_hash_sort_task, walk, NULL, NULL, 1, 0, FD_ACCOUNTS_HASH_BUCKET_CNT );
 
-        fd_lthash_value_t lthash_val;
-        fd_lthash_fini( &lthash, &lthash_val );
+  fd_hash_account_deltas_sorted( walk->pairs, pair_cnt, accounts_hash, slot_ctx );
 
-        // Add this to the accumulator
-        fd_lthash_add( acc_lthash, &lthash_val );
-      } // if ( fd_funk_key_is_acc( rec->pair.key ) )
-    } // fd_funk_rec_t const *rec = fd_f
+  fd_valloc_free( slot_ctx->valloc, walk->pairs );
+  fd_valloc_free( slot_ctx->valloc, cursor );
 
-    return 0;
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "accounts hash of %lu accounts computed in %6.3f s", pair_cnt, (double)dt * 1e-9 ));
+  return 0;
 }
 
-/* Re-computes the lthash from the current slot */
-void
-fd_accounts_check_lthash( fd_exec_slot_ctx_t * slot_ctx ) {
-  fd_funk_t *     funk = slot_ctx->acc_mgr->funk;
-  fd_wksp_t *     wksp = fd_funk_wksp( funk );
-  fd_funk_rec_t * rec_map  = fd_funk_rec_map( funk, wksp );
-  fd_funk_txn_t * txn_map  = fd_funk_txn_map( funk, wksp );
-
-  // How many txns are we dealing with?
-  ulong txn_cnt = 1;
-  fd_funk_txn_t * txn = slot_ctx->funk_txn;
-  while (NULL != txn) {
-    txn_cnt++;
-    txn = fd_funk_txn_parent( txn, txn_map );
-  }
+/* fd_accounts_lthash_part sums the lthash contributions of the
+   accounts visible from the slot's funk txn whose records live in
+   partition part_idx of part_cnt of the record map element range. */
 
-  fd_funk_txn_t ** txns = fd_alloca_check(sizeof(fd_funk_txn_t *), sizeof(fd_funk_txn_t *) * txn_cnt);
-  if ( FD_UNLIKELY(NULL == txns))
-    FD_LOG_ERR(("Out of scratch space?"));
-
-  // Lay it flat to make it easier to walk backwards up the chain from
-  // the root
-  txn = slot_ctx->funk_txn;
-  ulong txn_idx = txn_cnt;
-  while (1) {
-    txns[--txn_idx] = txn;
-    if (NULL == txn)
-      break;
-    txn = fd_funk_txn_parent( txn, txn_map );
+static void
+fd_accounts_lthash_part( fd_exec_slot_ctx_t * slot_ctx,
+                         fd_lthash_value_t *  sum,
+                         ulong                part_idx,
+                         ulong                part_cnt ) {
+  fd_funk_t *     funk    = slot_ctx->acc_mgr->funk;
+  fd_funk_rec_t * rec_map = fd_funk_rec_map( funk, fd_funk_wksp( funk ) );
+
+  fd_lthash_zero( sum );
+
+  uchar batch_mem[ FD_LTHASH_BATCH_FOOTPRINT ] __attribute__((aligned(FD_LTHASH_BATCH_ALIGN)));
+  fd_lthash_batch_t * batch = fd_lthash_batch_init( batch_mem, sum );
+
+  ulong e0; ulong e1;
+  FD_TPOOL_PARTITION( 0UL, fd_funk_rec_map_key_max( rec_map ), 1UL, part_idx, part_cnt, e0, e1 );
+
+  /* Map iterators count down and iterator i refers to element i-1 */
+  for( fd_funk_rec_map_iter_t iter = fd_funk_rec_map_iter_next( rec_map, e1+1UL );
+       iter>e0;
+       iter = fd_funk_rec_map_iter_next( rec_map, iter ) ) {
+    fd_funk_rec_t const * rec = fd_funk_rec_map_iter_ele_const( rec_map, iter );
+    if( !fd_funk_key_is_acc( rec->pair.key ) ) continue;
+
+    /* Only count the version of the account visible from the txn */
+    fd_funk_rec_t const *     vis_rec = NULL;
+    fd_account_meta_t const * meta    = fd_acc_mgr_view_raw( slot_ctx->acc_mgr, slot_ctx->funk_txn, fd_type_pun_const( rec->pair.key[0].uc ), &vis_rec, NULL );
+    if( !meta || vis_rec!=rec || !meta->info.lamports ) continue;
+
+    /* Same contribution as fd_account_rec_lthash_msg (the hash stays put
+       until the batch is finished as funk isn't modified here) */
+    fd_lthash_batch_add( batch, meta->hash, 32UL );
   }
 
-  // How many total records are we dealing with?
-  ulong           num_iter_accounts = fd_funk_rec_map_key_cnt( rec_map );
-
-  int accounts_hash_slots = fd_ulong_find_msb(num_iter_accounts  ) + 1;
-
-  FD_LOG_WARNING(("allocating memory for hash.  num_iter_accounts: %d   slots: %d", num_iter_accounts, accounts_hash_slots));
-  void * hashmem = fd_valloc_malloc( slot_ctx->valloc, accounts_hash_align(), accounts_hash_footprint(accounts_hash_slots));
-  FD_LOG_WARNING(("initializing memory for hash"));
-  accounts_hash_t * hash_map = accounts_hash_join(accounts_hash_new(hashmem, accounts_hash_slots));
-
-  FD_LOG_WARNING(("copying in accounts"));
-
-  // walk up the transactions...
-  for (ulong idx = 0; idx < txn_cnt; idx++) {
-    FD_LOG_WARNING(("txn idx %d", idx));
-    for (fd_funk_rec_t const *rec = fd_funk_txn_first_rec( funk, txns[idx]);
-         NULL != rec;
-         rec = fd_funk_txn_next_rec(funk, rec)) {
-      if ( fd_funk_key_is_acc( rec->pair.key ) ) {
-        accounts_hash_t * q = accounts_hash_query(hash_map, (fd_funk_rec_t *) rec, NULL);
-        if (NULL != q)
-          accounts_hash_remove(hash_map, q);
-        if (!(rec->flags & FD_FUNK_REC_FLAG_ERASE))
-          accounts_hash_insert(hash_map, (fd_funk_rec_t *) rec);
-      }
-    }
-  }
+  fd_lthash_batch_fini( batch );
+}
 
-  // Initialize the accumulator to zero
-  fd_lthash_value_t acc_lthash;
-  fd_lthash_zero( &acc_lthash );
-
-  ulong slot_cnt = accounts_hash_slot_cnt(hash_map);;
-  for( ulong slot_idx=0UL; slot_idx<slot_cnt; slot_idx++ ) {
-    accounts_hash_t *slot = &hash_map[slot_idx];
-    if (FD_UNLIKELY (NULL != slot->key)) {
-      void const * data = fd_funk_val_const( slot->key, wksp );
-      fd_account_meta_t const * metadata = (fd_account_meta_t const *)fd_type_pun_const( data );
-
-      // Add the hash to the accumulator
-      fd_lthash_t lthash;
-      fd_lthash_init( &lthash );
-      fd_lthash_append( &lthash, metadata->hash, 32 );
-      fd_lthash_value_t lthash_val;
-      fd_lthash_fini( &lthash, &lthash_val );
-      fd_lthash_add( &acc_lthash, &lthash_val );
-    }
-  }
+static void
+fd_accounts_lthash_part_task( void *tpool,
+                              ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
+                              void *args,
+                              void *reduce FD_PARAM_UNUSED, ulong stride FD_PARAM_UNUSED,
+                              ulong l0 FD_PARAM_UNUSED, ulong l1,
+                              ulong m0, ulong m1 FD_PARAM_UNUSED,
+                              ulong n0 FD_PARAM_UNUSED, ulong n1 FD_PARAM_UNUSED ) {
+  fd_accounts_lthash_part( (fd_exec_slot_ctx_t *)tpool, (fd_lthash_value_t *)args + m0, m0, l1 );
+}
 
-  // Compare the accumulator to the slot
-  fd_lthash_value_t * acc = (fd_lthash_value_t *)fd_type_pun_const( slot_ctx->slot_bank.lthash );
-  FD_TEST( memcmp( acc, &acc_lthash, sizeof( fd_lthash_value_t ) ) == 0 );
+/* fd_accounts_lthash_compute computes the accounts lthash of the whole
+   database as seen from the slot's funk txn into out, fanning out over
+   the tpool if there is one. */
+
+static void
+fd_accounts_lthash_compute( fd_exec_slot_ctx_t * slot_ctx,
+                            fd_lthash_value_t *  out,
+                            fd_tpool_t *         tpool,
+                            ulong                max_workers ) {
+  ulong part_cnt = ( tpool && max_workers>1UL ) ? max_workers : 1UL;
+
+  fd_lthash_value_t * sums = fd_valloc_malloc( slot_ctx->valloc, FD_LTHASH_ALIGN, part_cnt * sizeof(fd_lthash_value_t) );
+  if( FD_UNLIKELY( !sums ) ) FD_LOG_ERR(( "failed to allocate lthash accumulators" ));
+
+  if( part_cnt>1UL ) fd_tpool_exec_all_rrobin( tpool, 0, max_workers, fd_accounts_lthash_part_task, slot_ctx, sums, NULL, 1, 0, part_cnt );
+  else               fd_accounts_lthash_part( slot_ctx, sums, 0UL, 1UL );
+
+  for( ulong i = 1; i < part_cnt; i++ ) fd_lthash_add( &sums[0], &sums[i] );
+  fd_memcpy( out->bytes, sums[0].bytes, FD_LTHASH_LEN_BYTES );
+
+  fd_valloc_free( slot_ctx->valloc, sums );
+}
+
+int
+fd_accounts_init_lthash_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                               fd_tpool_t *         tpool,
+                               ulong                max_workers ) {
+  long dt = -fd_log_wallclock();
+
+  fd_lthash_value_t acc[1];
+  fd_accounts_lthash_compute( slot_ctx, acc, tpool, max_workers );
+  fd_memcpy( slot_ctx->slot_bank.lthash, acc->bytes, FD_LTHASH_LEN_BYTES );
+
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "accounts lthash initialized in %6.3f s", (double)dt * 1e-9 ));
+  return 0;
+}
+
+int
+fd_accounts_init_lthash( fd_exec_slot_ctx_t * slot_ctx ) {
+  return fd_accounts_init_lthash_tpool( slot_ctx, NULL, 0UL );
+}
+
+/* Re-computes the lthash from the current slot */
+void
+fd_accounts_check_lthash( fd_exec_slot_ctx_t * slot_ctx ) {
+  fd_lthash_value_t acc[1];
+  fd_accounts_lthash_compute( slot_ctx, acc, NULL, 0UL );
+  FD_TEST( 0==memcmp( acc->bytes, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES ) );
+}
+
+void
+fd_accounts_lthash_checksum( fd_exec_slot_ctx_t const * slot_ctx,
+                             fd_hash_t *                checksum ) {
+  fd_blake3_t b3[1];
+  fd_blake3_init( b3 );
+  fd_blake3_append( b3, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES );
+  fd_blake3_fini( b3, checksum->hash );
 }
-#endif
@@ -506,18 +506,60 @@ fd_rocksdb_insert_entry( fd_rocksdb_t * db,
   return 0;
 }
 
-int
-fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
-                                    fd_slot_meta_t *  m,
-                                    fd_blockstore_t * blockstore,
-                                    int txnstatus,
-                                    const uchar *hash_override ) // How much effort should we go to here to confirm the size of the hash override?
-{
-  fd_blockstore_start_write( blockstore );
+void
+fd_rocksdb_block_destroy( fd_rocksdb_block_t * block ) {
+  free( block->shred_buf );
+  free( block->shred_off );
+  fd_memset( block, 0, sizeof(fd_rocksdb_block_t) );
+}
+
+/* fd_rocksdb_block_reserve grows the shred buffers of block so that
+   they can hold at least shred_cnt shreds totaling buf_sz bytes.
+   Returns 0 on success and -1 on allocation failure (block buffers
+   are left unchanged). */
+
+static int
+fd_rocksdb_block_reserve( fd_rocksdb_block_t * block,
+                          ulong                shred_cnt,
+                          ulong                buf_sz ) {
+  if( FD_UNLIKELY( shred_cnt+1UL > block->shred_max ) ) {
+    ulong   max = fd_ulong_max( shred_cnt+1UL, 2UL*block->shred_max );
+    ulong * off = realloc( block->shred_off, max*sizeof(ulong) );
+    if( FD_UNLIKELY( !off ) ) return -1;
+    block->shred_off = off;
+    block->shred_max = max;
+  }
+  if( FD_UNLIKELY( buf_sz > block->shred_buf_max ) ) {
+    ulong   max = fd_ulong_max( buf_sz, 2UL*block->shred_buf_max );
+    uchar * buf = realloc( block->shred_buf, max );
+    if( FD_UNLIKELY( !buf ) ) return -1;
+    block->shred_buf     = buf;
+    block->shred_buf_max = max;
+  }
+  return 0;
+}
 
-  ulong slot = m->slot;
+int
+fd_rocksdb_block_read( fd_rocksdb_t *         db,
+                       fd_slot_meta_t const * m,
+                       fd_rocksdb_block_t *   block,
+                       uchar const *          hash_override ) {
+  ulong slot      = m->slot;
   ulong start_idx = 0;
-  ulong end_idx = m->received;
+  ulong end_idx   = m->received;
+
+  block->slot          = slot;
+  block->shred_cnt     = 0UL;
+  block->has_ts        = 0;
+  block->ts            = 0L;
+  block->height        = 0UL;
+  block->has_bank_hash = 0;
+
+  if( FD_UNLIKELY( fd_rocksdb_block_reserve( block, end_idx, end_idx*FD_SHRED_MIN_SZ ) ) ) {
+    FD_LOG_WARNING(( "failed to allocate shred buffer for slot %lu", slot ));
+    return -1;
+  }
+  block->shred_off[ 0 ] = 0UL;
 
   rocksdb_iterator_t* iter = rocksdb_create_iterator_cf(db->db, db->ro, db->cf_handles[FD_ROCKSDB_CFIDX_DATA_SHRED]);
 
@@ -535,7 +577,7 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
       size_t klen = 0;
       const char* key = rocksdb_iter_key(iter, &klen); // There is no need to free key
       if (klen != 16)  // invalid key
-        continue;
+        continue;      // the iterator stays put, so shreds from here on are not read
       cur_slot = fd_ulong_bswap(*((ulong *) &key[0]));
       index = fd_ulong_bswap(*((ulong *) &key[8]));
     }
@@ -543,14 +585,12 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
     if (!valid || cur_slot != slot) {
       FD_LOG_WARNING(("missing shreds for slot %ld", slot));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
     if (index != i) {
       FD_LOG_WARNING(("missing shred %ld at index %ld for slot %ld", i, index, slot));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
@@ -560,158 +600,263 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
     if (data == NULL) {
       FD_LOG_WARNING(("failed to read shred %ld/%ld", slot, i));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
-    // This just correctly selects from inside the data pointer to the
-    // actual data without a memory copy
-    fd_shred_t const * shred = fd_shred_parse( data, (ulong) dlen );
-    if (shred == NULL) {
-      FD_LOG_WARNING(("failed to parse shred %ld/%ld", slot, i));
+    /* The iterator value is only valid until the next step, so stash a
+       copy of the shred for fd_rocksdb_block_insert. */
+    ulong off = block->shred_off[ i ];
+    if( FD_UNLIKELY( fd_rocksdb_block_reserve( block, end_idx, off+(ulong)dlen ) ) ) {
+      FD_LOG_WARNING(("failed to allocate shred buffer for slot %ld", slot));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
-      return -1;
-    }
-    int rc = fd_buf_shred_insert( blockstore, shred );
-    if (rc != FD_BLOCKSTORE_OK_SLOT_COMPLETE && rc != FD_BLOCKSTORE_OK) {
-      FD_LOG_WARNING(("failed to store shred %ld/%ld", slot, i));
-      rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
+    fd_memcpy( block->shred_buf + off, data, (ulong)dlen );
+    block->shred_off[ i+1UL ] = off + (ulong)dlen;
+    block->shred_cnt          = i+1UL;
 
     rocksdb_iter_next(iter);
   }
 
   rocksdb_iter_destroy(iter);
 
-  fd_wksp_t * wksp = fd_wksp_containing( blockstore );
-  fd_blockstore_slot_map_t * block_map = fd_blockstore_slot_map( blockstore );
-  fd_blockstore_slot_map_t * block_entry = fd_blockstore_slot_map_query( block_map, &slot, NULL );
-  if( FD_LIKELY( block_entry && block_entry->block_gaddr ) ) {
-    fd_block_t * blk = fd_wksp_laddr_fast( wksp, block_entry->block_gaddr );
-    size_t vallen = 0;
-    char * err = NULL;
-    char * res = rocksdb_get_cf(
-      db->db,
-      db->ro,
-      db->cf_handles[ FD_ROCKSDB_CFIDX_BLOCKTIME ],
-      (char const *)&slot_be, sizeof(ulong),
-      &vallen,
-      &err );
-    if( FD_UNLIKELY( err ) ) {
-      FD_LOG_WARNING(( "rocksdb: %s", err ));
-      free( err );
-    } else if(vallen == sizeof(ulong)) {
-      blk->ts = (*(long*)res)*((long)1e9); /* Convert to nanos */
-      free(res);
-    }
+  size_t vallen = 0;
+  char * err = NULL;
+  char * res = rocksdb_get_cf(
+    db->db,
+    db->ro,
+    db->cf_handles[ FD_ROCKSDB_CFIDX_BLOCKTIME ],
+    (char const *)&slot_be, sizeof(ulong),
+    &vallen,
+    &err );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "rocksdb: %s", err ));
+    free( err );
+  } else if(vallen == sizeof(ulong)) {
+    block->ts     = (*(long*)res)*((long)1e9); /* Convert to nanos */
+    block->has_ts = 1;
+    free(res);
+  }
+
+  vallen = 0;
+  err = NULL;
+  res = rocksdb_get_cf(
+    db->db,
+    db->ro,
+    db->cf_handles[ FD_ROCKSDB_CFIDX_BLOCK_HEIGHT ],
+    (char const *)&slot_be, sizeof(ulong),
+    &vallen,
+    &err );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "rocksdb: %s", err ));
+    free( err );
+  } else if(vallen == sizeof(ulong)) {
+    block->height = *(ulong*)res;
+    free(res);
+  }
 
-    vallen = 0;
-    err = NULL;
+  vallen = 0;
+  err = NULL;
+  if (NULL != hash_override) {
+    fd_memcpy( block->bank_hash.hash, hash_override, 32UL );
+    block->has_bank_hash = 1;
+  } else {
     res = rocksdb_get_cf(
       db->db,
-      db->ro,
-      db->cf_handles[ FD_ROCKSDB_CFIDX_BLOCK_HEIGHT ],
-      (char const *)&slot_be, sizeof(ulong),
-      &vallen,
-      &err );
-    blk->height = 0;
+        db->ro,
+        db->cf_handles[ FD_ROCKSDB_CFIDX_BANK_HASHES ],
+        (char const *)&slot_be, sizeof(ulong),
+        &vallen,
+        &err );
     if( FD_UNLIKELY( err ) ) {
       FD_LOG_WARNING(( "rocksdb: %s", err ));
       free( err );
-    } else if(vallen == sizeof(ulong)) {
-      blk->height = *(ulong*)res;
-      free(res);
+    } else {
+      /* The frozen hash decoder does not allocate, so any valloc works
+         here.  Using libc keeps this callable from threads without an
+         attached scratch region. */
+      fd_bincode_decode_ctx_t decode = {
+        .data    = res,
+        .dataend = res + vallen,
+        .valloc  = fd_libc_alloc_virtual(),
+      };
+      fd_frozen_hash_versioned_t versioned;
+      int decode_err = fd_frozen_hash_versioned_decode( &versioned, &decode );
+      if( FD_UNLIKELY( decode_err!=FD_BINCODE_SUCCESS ) ) goto cleanup;
+      if( FD_UNLIKELY( decode.data!=decode.dataend    ) ) goto cleanup;
+      if( FD_UNLIKELY( versioned.discriminant !=fd_frozen_hash_versioned_enum_current ) ) goto cleanup;
+      /* Success */
+      fd_memcpy( block->bank_hash.hash, versioned.inner.current.frozen_hash.hash, 32UL );
+      block->has_bank_hash = 1;
+    cleanup:
+      free( res );
     }
+  }
 
-    vallen = 0;
-    err = NULL;
-    if (NULL != hash_override)
-      fd_memcpy( blk->bank_hash.hash, hash_override, 32UL );
-    else {
-      res = rocksdb_get_cf(
-        db->db,
-          db->ro,
-          db->cf_handles[ FD_ROCKSDB_CFIDX_BANK_HASHES ],
-          (char const *)&slot_be, sizeof(ulong),
-          &vallen,
-          &err );
-      if( FD_UNLIKELY( err ) ) {
-        FD_LOG_WARNING(( "rocksdb: %s", err ));
-        free( err );
-      } else {
-        fd_scratch_push();
-        fd_bincode_decode_ctx_t decode = {
-          .data    = res,
-          .dataend = res + vallen,
-          .valloc  = fd_scratch_virtual(),
-        };
-        fd_frozen_hash_versioned_t versioned;
-        int decode_err = fd_frozen_hash_versioned_decode( &versioned, &decode );
-        if( FD_UNLIKELY( decode_err!=FD_BINCODE_SUCCESS ) ) goto cleanup;
-        if( FD_UNLIKELY( decode.data!=decode.dataend    ) ) goto cleanup;
-        if( FD_UNLIKELY( versioned.discriminant !=fd_frozen_hash_versioned_enum_current ) ) goto cleanup;
-        /* Success */
-        fd_memcpy( blk->bank_hash.hash, versioned.inner.current.frozen_hash.hash, 32UL );
-      cleanup:
-        free( res );
-        fd_scratch_pop();
-      }
-    }
+  return 0;
+}
+
+/* fd_rocksdb_import_txn_status copies the transaction statuses of every
+   txn in slot's block from rocksdb into blockstore.  The rocksdb
+   queries are done without holding the blockstore lock: the first
+   signature of each txn is gathered under a read lock, the statuses are
+   fetched and then attached to the txn map under a write lock. */
+
+static void
+fd_rocksdb_import_txn_status( fd_rocksdb_t *    db,
+                              ulong             slot,
+                              fd_blockstore_t * blockstore ) {
+  fd_wksp_t *                wksp      = fd_wksp_containing( blockstore );
+  fd_blockstore_slot_map_t * block_map = fd_blockstore_slot_map( blockstore );
+
+  /* Gather the first signature of each txn */
+
+  fd_blockstore_start_read( blockstore );
+  fd_blockstore_slot_map_t * block_entry = fd_blockstore_slot_map_query( block_map, &slot, NULL );
+  if( FD_UNLIKELY( !block_entry || !block_entry->block_gaddr ) ) {
+    fd_blockstore_end_read( blockstore );
+    return;
   }
+  fd_block_t *         blk      = fd_wksp_laddr_fast( wksp, block_entry->block_gaddr );
+  uchar *              data     = fd_wksp_laddr_fast( wksp, blk->data_gaddr );
+  fd_block_txn_ref_t * txns     = fd_wksp_laddr_fast( wksp, blk->txns_gaddr );
+  ulong                txns_cnt = blk->txns_cnt;
+
+  fd_blockstore_txn_key_t * sigs  = malloc( fd_ulong_max( txns_cnt, 1UL )*sizeof(fd_blockstore_txn_key_t) );
+  void **                   raws  = malloc( fd_ulong_max( txns_cnt, 1UL )*sizeof(void *) );
+  ulong *                   szs   = malloc( fd_ulong_max( txns_cnt, 1UL )*sizeof(ulong) );
+  if( FD_UNLIKELY( !sigs || !raws || !szs ) ) FD_LOG_ERR(( "failed to allocate txn status buffers for slot %lu", slot ));
+
+  ulong sig_cnt      = 0UL;
+  ulong last_txn_off = ULONG_MAX;
+  for( ulong j = 0; j < txns_cnt; ++j ) {
+    if( txns[j].txn_off == last_txn_off ) continue;
+    last_txn_off = txns[j].txn_off;
+    fd_memcpy( &sigs[ sig_cnt++ ], data + txns[j].id_off, sizeof(fd_blockstore_txn_key_t) );
+  }
+  fd_blockstore_end_read( blockstore );
 
-  if( txnstatus ) {
-    fd_alloc_t * alloc = fd_wksp_laddr_fast( wksp, blockstore->alloc_gaddr );
-    fd_blockstore_txn_map_t *   txn_map   = fd_wksp_laddr_fast( wksp, blockstore->txn_map_gaddr );
-    if( FD_LIKELY( block_entry && block_entry->block_gaddr ) ) {
-      fd_block_t * blk = fd_wksp_laddr_fast( wksp, block_entry->block_gaddr );
-      uchar * data = fd_wksp_laddr_fast( wksp, blk->data_gaddr );
-      fd_block_txn_ref_t * txns = fd_wksp_laddr_fast( wksp, blk->txns_gaddr );
-      ulong meta_gaddr = 0;
-      ulong meta_sz = 0;
-      int meta_owned = 0;
-      ulong last_txn_off = ULONG_MAX;
-      for ( ulong j = 0; j < blk->txns_cnt; ++j ) {
-        fd_blockstore_txn_key_t sig;
-        fd_memcpy( &sig, data + txns[j].id_off, sizeof( sig ) );
-        fd_blockstore_txn_map_t * txn_map_entry = fd_blockstore_txn_map_query( txn_map, &sig, NULL );
-        if( FD_UNLIKELY( !txn_map_entry ) ) {
-          FD_LOG_WARNING(("missing transaction %64J", &sig));
-          continue;
-        }
+  /* Query rocksdb */
 
-        if( txns[j].txn_off != last_txn_off ) {
-          last_txn_off = txns[j].txn_off;
-          ulong sz;
-          void * raw = fd_rocksdb_get_txn_status_raw( db, slot, &sig, &sz );
-          if( raw == NULL ) {
-            meta_gaddr = 0;
-            meta_sz = 0;
-            meta_owned = 0;
-          } else {
-            void * laddr = fd_alloc_malloc( alloc, 1, sz );
-            fd_memcpy(laddr, raw, sz);
-            free(raw);
-            meta_gaddr = fd_wksp_gaddr_fast( wksp, laddr );
-            meta_sz = sz;
-            meta_owned = 1;
-          }
+  for( ulong k = 0; k < sig_cnt; ++k ) {
+    raws[k] = fd_rocksdb_get_txn_status_raw( db, slot, &sigs[k], &szs[k] );
+  }
+
+  /* Attach the statuses */
+
+  fd_blockstore_start_write( blockstore );
+  block_entry = fd_blockstore_slot_map_query( block_map, &slot, NULL );
+  if( FD_LIKELY( block_entry && block_entry->block_gaddr ) ) {
+    fd_alloc_t *              alloc   = fd_wksp_laddr_fast( wksp, blockstore->alloc_gaddr );
+    fd_blockstore_txn_map_t * txn_map = fd_wksp_laddr_fast( wksp, blockstore->txn_map_gaddr );
+    blk  = fd_wksp_laddr_fast( wksp, block_entry->block_gaddr );
+    data = fd_wksp_laddr_fast( wksp, blk->data_gaddr );
+    txns = fd_wksp_laddr_fast( wksp, blk->txns_gaddr );
+    ulong meta_gaddr = 0;
+    ulong meta_sz = 0;
+    int meta_owned = 0;
+    ulong k = ULONG_MAX;
+    last_txn_off = ULONG_MAX;
+    for ( ulong j = 0; j < blk->txns_cnt; ++j ) {
+      fd_blockstore_txn_key_t sig;
+      fd_memcpy( &sig, data + txns[j].id_off, sizeof( sig ) );
+
+      if( txns[j].txn_off != last_txn_off ) {
+        last_txn_off = txns[j].txn_off;
+        k++;
+        void * raw = raws[k];
+        if( raw == NULL ) {
+          meta_gaddr = 0;
+          meta_sz = 0;
+          meta_owned = 0;
+        } else {
+          ulong sz = szs[k];
+          void * laddr = fd_alloc_malloc( alloc, 1, sz );
+          fd_memcpy(laddr, raw, sz);
+          meta_gaddr = fd_wksp_gaddr_fast( wksp, laddr );
+          meta_sz = sz;
+          meta_owned = 1;
         }
+      }
 
-        txn_map_entry->meta_gaddr = meta_gaddr;
-        txn_map_entry->meta_sz = meta_sz;
-        txn_map_entry->meta_owned = meta_owned;
-        meta_owned = 0;
+      fd_blockstore_txn_map_t * txn_map_entry = fd_blockstore_txn_map_query( txn_map, &sig, NULL );
+      if( FD_UNLIKELY( !txn_map_entry ) ) {
+        FD_LOG_WARNING(("missing transaction %64J", &sig));
+        continue;
       }
+
+      txn_map_entry->meta_gaddr = meta_gaddr;
+      txn_map_entry->meta_sz = meta_sz;
+      txn_map_entry->meta_owned = meta_owned;
+      meta_owned = 0;
+    }
+  }
+  fd_blockstore_end_write( blockstore );
+
+  for( ulong k = 0; k < sig_cnt; ++k ) free( raws[k] );
+  free( szs  );
+  free( raws );
+  free( sigs );
+}
+
+int
+fd_rocksdb_block_insert( fd_rocksdb_t *             db,
+                         fd_rocksdb_block_t const * block,
+                         fd_blockstore_t *          blockstore,
+                         int                        txnstatus ) {
+  ulong slot = block->slot;
+
+  fd_blockstore_start_write( blockstore );
+
+  for( ulong i = 0; i < block->shred_cnt; i++ ) {
+    // This just correctly selects from inside the data pointer to the
+    // actual data without a memory copy
+    fd_shred_t const * shred = fd_shred_parse( block->shred_buf + block->shred_off[ i ],
+                                               block->shred_off[ i+1UL ] - block->shred_off[ i ] );
+    if (shred == NULL) {
+      FD_LOG_WARNING(("failed to parse shred %ld/%ld", slot, i));
+      fd_blockstore_end_write(blockstore);
+      return -1;
     }
+    int rc = fd_buf_shred_insert( blockstore, shred );
+    if (rc != FD_BLOCKSTORE_OK_SLOT_COMPLETE && rc != FD_BLOCKSTORE_OK) {
+      FD_LOG_WARNING(("failed to store shred %ld/%ld", slot, i));
+      fd_blockstore_end_write(blockstore);
+      return -1;
+    }
+  }
+
+  fd_wksp_t * wksp = fd_wksp_containing( blockstore );
+  fd_blockstore_slot_map_t * block_map = fd_blockstore_slot_map( blockstore );
+  fd_blockstore_slot_map_t * block_entry = fd_blockstore_slot_map_query( block_map, &slot, NULL );
+  if( FD_LIKELY( block_entry && block_entry->block_gaddr ) ) {
+    fd_block_t * blk = fd_wksp_laddr_fast( wksp, block_entry->block_gaddr );
+    if( block->has_ts        ) blk->ts = block->ts;
+    blk->height = block->height;
+    if( block->has_bank_hash ) fd_memcpy( blk->bank_hash.hash, block->bank_hash.hash, 32UL );
   }
 
   fd_blockstore_end_write(blockstore);
+
+  if( txnstatus ) fd_rocksdb_import_txn_status( db, slot, blockstore );
+
   return 0;
 }
 
+int
+fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
+                                    fd_slot_meta_t *  m,
+                                    fd_blockstore_t * blockstore,
+                                    int txnstatus,
+                                    const uchar *hash_override ) // How much effort should we go to here to confirm the size of the hash override?
+{
+  fd_rocksdb_block_t block = {0};
+  int err = fd_rocksdb_block_read( db, m, &block, hash_override );
+  if( FD_LIKELY( !err ) ) err = fd_rocksdb_block_insert( db, &block, blockstore, txnstatus );
+  fd_rocksdb_block_destroy( &block );
+  return err;
+}
+
 int
 fd_rocksdb_import_block_shredcap( fd_rocksdb_t *             db,
                                     fd_slot_meta_t *           metadata,
@@ -56,6 +56,31 @@ typedef struct fd_rocksdb_root_iter fd_rocksdb_root_iter_t;
 #define FD_ROCKSDB_ROOT_ITER_FOOTPRINT sizeof(fd_rocksdb_root_iter_t)
 #define FD_ROCKSDB_ROOT_ITER_ALIGN (8UL)
 
+/* fd_rocksdb_block_t holds everything needed from rocksdb to import
+   one slot into a blockstore: the raw data shreds of the slot plus the
+   block time, block height and bank hash.  Splitting the rocksdb reads
+   (fd_rocksdb_block_read) from the blockstore insert
+   (fd_rocksdb_block_insert) lets callers read upcoming slots without
+   holding the blockstore lock, e.g. on a prefetch thread while earlier
+   slots are executing.  The shred buffers are malloc-backed, grown on
+   demand and reused across reads.  Zero initialize before first use
+   and release with fd_rocksdb_block_destroy. */
+
+struct fd_rocksdb_block {
+  ulong     slot;
+  ulong     shred_cnt;     /* Number of shreds read */
+  ulong *   shred_off;     /* Shred i is shred_buf[ shred_off[i], shred_off[i+1] ) */
+  uchar *   shred_buf;
+  ulong     shred_max;     /* Capacity of shred_off in entries */
+  ulong     shred_buf_max; /* Capacity of shred_buf in bytes */
+  int       has_ts;
+  long      ts;            /* Block time in nanos, valid if has_ts */
+  ulong     height;        /* Block height, 0 if unknown */
+  int       has_bank_hash;
+  fd_hash_t bank_hash;     /* Valid if has_bank_hash */
+};
+typedef struct fd_rocksdb_block fd_rocksdb_block_t;
+
 FD_PROTOTYPES_BEGIN
 
 void *
@@ -225,7 +250,41 @@ fd_rocksdb_insert_entry( fd_rocksdb_t * db,
                          const char *   value,
                          ulong          value_len );
 
-/* Import from rocksdb into blockstore */
+/* fd_rocksdb_block_read reads the data shreds and block metadata of the
+   slot described by m into block.  Does not touch any blockstore and is
+   safe to call concurrently with readers and writers of the blockstore
+   (rocksdb reads are thread safe).  If hash_override is non-NULL, it
+   points to a 32 byte bank hash used instead of the one in rocksdb.
+   Returns 0 on success and -1 on failure (logs details). */
+
+int
+fd_rocksdb_block_read( fd_rocksdb_t *         db,
+                       fd_slot_meta_t const * m,
+                       fd_rocksdb_block_t *   block,
+                       uchar const *          hash_override );
+
+/* fd_rocksdb_block_insert inserts a block previously read with
+   fd_rocksdb_block_read into blockstore.  The blockstore write lock is
+   only held while the shreds are deshredded and the metadata is
+   stored.  If txnstatus is set, the transaction statuses of the block
+   are also copied from db; the rocksdb queries for those are made
+   without holding the blockstore lock.  Returns 0 on success and -1 on
+   failure (logs details). */
+
+int
+fd_rocksdb_block_insert( fd_rocksdb_t *             db,
+                         fd_rocksdb_block_t const * block,
+                         fd_blockstore_t *          blockstore,
+                         int                        txnstatus );
+
+/* fd_rocksdb_block_destroy frees the buffers held by block and zeroes
+   it. */
+
+void
+fd_rocksdb_block_destroy( fd_rocksdb_block_t * block );
+
+/* Import from rocksdb into blockstore.  Equivalent to a
+   fd_rocksdb_block_read followed by a fd_rocksdb_block_insert. */
 
 int
 fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
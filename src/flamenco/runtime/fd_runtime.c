@@ -4,6 +4,7 @@
 #include "fd_executor.h"
 #include "fd_account.h"
 #include "fd_hashes.h"
+#include "fd_txn_sched.h"
 #include "sysvar/fd_sysvar_cache.h"
 #include "sysvar/fd_sysvar_clock.h"
 #include "sysvar/fd_sysvar_epoch_schedule.h"
@@ -843,6 +844,73 @@ fd_collect_fee_task( void *tpool,
   task_info->fee = fee;
 }
 
+/* fd_runtime_prepare_txn_check runs the checks of phase 2 that come
+   before fee collection: the recent blockhash must be in the block hash
+   queue (unless this is a durable nonce txn), the accounts must fit the
+   loaded data size limit and the fee payer must be able to pay the fee.
+   These read the nonce account and every account of the txn, so the
+   earlier txns of the block that write any of them must have been
+   finalized.  Returns 0 on success. */
+
+static int
+fd_runtime_prepare_txn_check( fd_exec_slot_ctx_t * slot_ctx,
+                              fd_exec_txn_ctx_t *  txn_ctx ) {
+  /* https://github.com/firedancer-io/solana/blob/4b31032e68f85848b02fcc4c9e580d57f32ec04b/runtime/src/bank.rs#L4672 */
+  int err;
+  int is_nonce = fd_has_nonce_account( txn_ctx, &err );
+  if( ( NULL == txn_ctx->txn_descriptor ) || !is_nonce ) {
+    fd_hash_t * blockhash = (fd_hash_t *)((uchar *)txn_ctx->_txn_raw->raw + txn_ctx->txn_descriptor->recent_blockhash_off);
+
+    fd_hash_hash_age_pair_t_mapnode_t key;
+    fd_memcpy( key.elem.key.uc, blockhash, sizeof(fd_hash_t) );
+
+    if ( fd_hash_hash_age_pair_t_map_find( slot_ctx->slot_bank.block_hash_queue.ages_pool, slot_ctx->slot_bank.block_hash_queue.ages_root, &key ) == NULL ) {
+      return FD_RUNTIME_TXN_ERR_BLOCKHASH_NOT_FOUND;
+    }
+  }
+
+  err = fd_executor_check_txn_accounts( txn_ctx );
+  if ( err != FD_RUNTIME_EXECUTE_SUCCESS ) {
+    return err;
+  }
+
+  return 0;
+}
+
+/* fd_runtime_txn_check_blockhash is the part of
+   fd_runtime_prepare_txn_check that does not depend on account state.
+   It rejects a txn whose recent blockhash is not in the block hash
+   queue, unless the txn might use a durable nonce (its first
+   instruction advances a writable account).  Whether it does depends on
+   the nonce account, so that is left to fd_runtime_prepare_txn_check.
+   The block hash queue does not change while a block executes, so this
+   can run before any txn of the batch.  Returns 0 on success. */
+
+static int
+fd_runtime_txn_check_blockhash( fd_exec_slot_ctx_t const * slot_ctx,
+                                fd_exec_txn_ctx_t const *  txn_ctx ) {
+  fd_txn_t const * txn = txn_ctx->txn_descriptor;
+  uchar const *    raw = txn_ctx->_txn_raw->raw;
+
+  if( txn->instr_cnt ) {
+    fd_txn_instr_t const * instr   = &txn->instr[0];
+    fd_acct_addr_t const * prog_id = fd_txn_get_acct_addrs( txn, raw ) + instr->program_id;
+    if( !memcmp( prog_id->b, fd_solana_system_program_id.key, sizeof(fd_pubkey_t) ) &&
+        instr->data_sz==4UL && instr->acct_cnt &&
+        FD_LOAD( uint, fd_txn_get_instr_data( instr, raw ) )==(uint)fd_system_program_instruction_enum_advance_nonce_account &&
+        fd_txn_is_writable( txn, fd_txn_get_instr_accts( instr, raw )[0] ) ) {
+      return 0;
+    }
+  }
+
+  fd_hash_hash_age_pair_t_mapnode_t key;
+  fd_memcpy( key.elem.key.uc, raw + txn->recent_blockhash_off, sizeof(fd_hash_t) );
+  if( fd_hash_hash_age_pair_t_map_find( slot_ctx->slot_bank.block_hash_queue.ages_pool, slot_ctx->slot_bank.block_hash_queue.ages_root, &key ) == NULL ) {
+    return FD_RUNTIME_TXN_ERR_BLOCKHASH_NOT_FOUND;
+  }
+  return 0;
+}
+
 int
 fd_runtime_prepare_txns_phase2_tpool( fd_exec_slot_ctx_t * slot_ctx,
                                       fd_execute_txn_task_info_t * task_info,
@@ -860,24 +928,8 @@ fd_runtime_prepare_txns_phase2_tpool( fd_exec_slot_ctx_t * slot_ctx,
     for (ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++) {
       fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
 
-      /* https://github.com/firedancer-io/solana/blob/4b31032e68f85848b02fcc4c9e580d57f32ec04b/runtime/src/bank.rs#L4672 */
-      int err;
-      int is_nonce = fd_has_nonce_account( txn_ctx, &err );
-      if( ( NULL == txn_ctx->txn_descriptor ) || !is_nonce ) {
-        fd_hash_t * blockhash = (fd_hash_t *)((uchar *)txn_ctx->_txn_raw->raw + txn_ctx->txn_descriptor->recent_blockhash_off);
-
-        fd_hash_hash_age_pair_t_mapnode_t key;
-        fd_memcpy( key.elem.key.uc, blockhash, sizeof(fd_hash_t) );
-
-        if ( fd_hash_hash_age_pair_t_map_find( slot_ctx->slot_bank.block_hash_queue.ages_pool, slot_ctx->slot_bank.block_hash_queue.ages_root, &key ) == NULL ) {
-          task_info[ txn_idx ].txn->flags = 0;
-          res |= FD_RUNTIME_TXN_ERR_BLOCKHASH_NOT_FOUND;
-          continue;
-        }
-      }
-
-      err = fd_executor_check_txn_accounts( txn_ctx );
-      if ( err != FD_RUNTIME_EXECUTE_SUCCESS ) {
+      int err = fd_runtime_prepare_txn_check( slot_ctx, txn_ctx );
+      if( err != 0 ) {
         task_info[ txn_idx ].txn->flags = 0;
         res |= err;
         continue;
@@ -892,6 +944,9 @@ fd_runtime_prepare_txns_phase2_tpool( fd_exec_slot_ctx_t * slot_ctx,
 
     fd_tpool_exec_all_rrobin( tpool, 0, max_workers, fd_collect_fee_task, collect_fee_task_infos, NULL, NULL, 1, 0, fee_payer_accs_cnt );
 
+    /* Only save the fee payers that were charged (a fee payer that
+       could not be loaded has nothing to save) */
+    ulong fee_payer_save_cnt = 0;
     for (ulong fee_payer_idx = 0; fee_payer_idx < fee_payer_accs_cnt; fee_payer_idx++) {
       fd_collect_fee_task_info_t * collect_fee_task_info = &collect_fee_task_infos[fee_payer_idx];
       if( FD_UNLIKELY( collect_fee_task_info->result!=0 ) ) {
@@ -901,9 +956,10 @@ fd_runtime_prepare_txns_phase2_tpool( fd_exec_slot_ctx_t * slot_ctx,
         continue;
       }
       slot_ctx->slot_bank.collected_fees += collect_fee_task_info->fee;
+      fee_payer_accs[ fee_payer_save_cnt++ ] = fee_payer_accs[ fee_payer_idx ];
     }
 
-    int err = fd_acc_mgr_save_many_tpool( slot_ctx->acc_mgr, slot_ctx->funk_txn, fee_payer_accs, fee_payer_accs_cnt, tpool, max_workers );
+    int err = fd_acc_mgr_save_many_tpool( slot_ctx->acc_mgr, slot_ctx->funk_txn, fee_payer_accs, fee_payer_save_cnt, tpool, max_workers );
     if( FD_UNLIKELY( err ) ) {
       FD_LOG_WARNING(( "fd_acc_mgr_save_many failed (%d-%s)", err, fd_acc_mgr_strerror( err ) ));
       return -1;
@@ -1122,13 +1178,17 @@ fd_runtime_write_transaction_status( fd_capture_ctx_t * capture_ctx,
   }
 }
 
-int
-fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
-                                fd_capture_ctx_t * capture_ctx,
-                                fd_execute_txn_task_info_t * task_info,
-                                ulong txn_cnt,
-                                fd_tpool_t * tpool,
-                                ulong max_workers ) {
+/* fd_runtime_finalize_txns_save_tpool writes the accounts modified by
+   the txns to funk.  This is the part of finalization the txns that
+   conflict with these depend on. */
+
+static int
+fd_runtime_finalize_txns_save_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                                     fd_capture_ctx_t * capture_ctx,
+                                     fd_execute_txn_task_info_t * task_info,
+                                     ulong txn_cnt,
+                                     fd_tpool_t * tpool,
+                                     ulong max_workers ) {
   FD_SCRATCH_SCOPE_BEGIN {
     ulong accounts_to_save_cnt = 0;
 
@@ -1158,11 +1218,6 @@ fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
         fd_funk_end_write( capture_ctx->pruned_funk );
       }
 
-      /* For ledgers that contain txn status, decode and write out for solcap */
-      if ( capture_ctx != NULL && capture_ctx->capture && capture_ctx->capture_txns ) {
-        fd_runtime_write_transaction_status( capture_ctx, slot_ctx, txn_ctx, exec_txn_err );
-      }
-
       for ( ulong i = 0; i < txn_ctx->accounts_cnt; i++) {
         if( txn_ctx->nonce_accounts[i] ) {
           accounts_to_save_cnt++;
@@ -1173,9 +1228,6 @@ fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
         continue;
       }
 
-      int dirty_vote_acc  = txn_ctx->dirty_vote_acc;
-      int dirty_stake_acc = txn_ctx->dirty_stake_acc;
-
       for( ulong i = 0; i < txn_ctx->accounts_cnt; i++ ) {
         fd_borrowed_account_t * acc_rec = &txn_ctx->borrowed_accounts[i];
 
@@ -1183,43 +1235,6 @@ fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
           continue;
         }
 
-        if( dirty_vote_acc && 0==memcmp( acc_rec->const_meta->info.owner, &fd_solana_vote_program_id, sizeof(fd_pubkey_t) ) ) {
-          fd_vote_store_account( slot_ctx, acc_rec );
-          FD_SCRATCH_SCOPE_BEGIN {
-            fd_vote_state_versioned_t vsv[1];
-            fd_bincode_decode_ctx_t decode_vsv =
-              { .data    = acc_rec->const_data,
-                .dataend = acc_rec->const_data + acc_rec->const_meta->dlen,
-                .valloc  = fd_scratch_virtual() };
-
-            int err = fd_vote_state_versioned_decode( vsv, &decode_vsv );
-            if( err ) break; /* out of scratch scope */
-
-            fd_vote_block_timestamp_t const * ts = NULL;
-            switch( vsv->discriminant ) {
-            case fd_vote_state_versioned_enum_v0_23_5:
-              ts = &vsv->inner.v0_23_5.last_timestamp;
-              break;
-            case fd_vote_state_versioned_enum_v1_14_11:
-              ts = &vsv->inner.v1_14_11.last_timestamp;
-              break;
-            case fd_vote_state_versioned_enum_current:
-              ts = &vsv->inner.current.last_timestamp;
-              break;
-            default:
-              __builtin_unreachable();
-            }
-
-            fd_vote_record_timestamp_vote_with_slot( slot_ctx, acc_rec->pubkey, ts->timestamp, ts->slot );
-          }
-          FD_SCRATCH_SCOPE_END;
-        }
-
-        if( dirty_stake_acc && 0==memcmp( acc_rec->const_meta->info.owner, &fd_solana_stake_program_id, sizeof(fd_pubkey_t) ) ) {
-          // TODO does this correctly handle stake account close?
-          fd_store_stake_delegation( slot_ctx, acc_rec );
-        }
-
         if( txn_ctx->unknown_accounts[i] ) {
           memset( acc_rec->meta->hash, 0xFF, sizeof(fd_hash_t) );
           if( FD_FEATURE_ACTIVE( slot_ctx, set_exempt_rent_epoch_max ) ) {
@@ -1300,40 +1315,133 @@ fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
       return -1;
     }
 
-    for( ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++ ) {
-      /* Transaction was skipped due to preparation failure. */
-      if( task_info[txn_idx].txn->flags == 0) {
+    return 0;
+  } FD_SCRATCH_SCOPE_END;
+}
+
+/* fd_runtime_finalize_txns_post does the rest of finalization: it
+   captures the txn status, updates the vote and stake caches and
+   timestamp votes in slot_bank from the modified accounts, and frees
+   the txn ctxs.  Txns are processed in the order given. */
+
+static int
+fd_runtime_finalize_txns_post( fd_exec_slot_ctx_t * slot_ctx,
+                               fd_capture_ctx_t * capture_ctx,
+                               fd_execute_txn_task_info_t * task_info,
+                               ulong txn_cnt ) {
+  for( ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++ ) {
+    /* Transaction was skipped due to preparation failure. */
+    if( task_info[txn_idx].txn->flags == 0) {
+      continue;
+    }
+
+    fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
+    int exec_txn_err = task_info[txn_idx].exec_res;
+
+    /* For ledgers that contain txn status, decode and write out for solcap */
+    if ( capture_ctx != NULL && capture_ctx->capture && capture_ctx->capture_txns ) {
+      fd_runtime_write_transaction_status( capture_ctx, slot_ctx, txn_ctx, exec_txn_err );
+    }
+
+    if( exec_txn_err != 0 ) {
+      continue;
+    }
+
+    int dirty_vote_acc  = txn_ctx->dirty_vote_acc;
+    int dirty_stake_acc = txn_ctx->dirty_stake_acc;
+
+    for( ulong i = 0; i < txn_ctx->accounts_cnt; i++ ) {
+      fd_borrowed_account_t * acc_rec = &txn_ctx->borrowed_accounts[i];
+
+      if( !fd_txn_account_is_writable_idx(txn_ctx->txn_descriptor, txn_ctx->accounts, (int)i) ) {
         continue;
       }
 
-      fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
+      if( dirty_vote_acc && 0==memcmp( acc_rec->const_meta->info.owner, &fd_solana_vote_program_id, sizeof(fd_pubkey_t) ) ) {
+        fd_vote_store_account( slot_ctx, acc_rec );
+        FD_SCRATCH_SCOPE_BEGIN {
+          fd_vote_state_versioned_t vsv[1];
+          fd_bincode_decode_ctx_t decode_vsv =
+            { .data    = acc_rec->const_data,
+              .dataend = acc_rec->const_data + acc_rec->const_meta->dlen,
+              .valloc  = fd_scratch_virtual() };
+
+          int err = fd_vote_state_versioned_decode( vsv, &decode_vsv );
+          if( err ) break; /* out of scratch scope */
+
+          fd_vote_block_timestamp_t const * ts = NULL;
+          switch( vsv->discriminant ) {
+          case fd_vote_state_versioned_enum_v0_23_5:
+            ts = &vsv->inner.v0_23_5.last_timestamp;
+            break;
+          case fd_vote_state_versioned_enum_v1_14_11:
+            ts = &vsv->inner.v1_14_11.last_timestamp;
+            break;
+          case fd_vote_state_versioned_enum_current:
+            ts = &vsv->inner.current.last_timestamp;
+            break;
+          default:
+            __builtin_unreachable();
+          }
 
-      for( ulong i = 0; i < txn_ctx->accounts_cnt; i++ ) {
-        fd_borrowed_account_t * acc_rec = &txn_ctx->borrowed_accounts[i];
-        void * acc_rec_data = fd_borrowed_account_destroy( acc_rec );
-        if( acc_rec_data != NULL ) {
-          fd_valloc_free( txn_ctx->valloc, acc_rec_data );
+          fd_vote_record_timestamp_vote_with_slot( slot_ctx, acc_rec->pubkey, ts->timestamp, ts->slot );
         }
+        FD_SCRATCH_SCOPE_END;
+      }
+
+      if( dirty_stake_acc && 0==memcmp( acc_rec->const_meta->info.owner, &fd_solana_stake_program_id, sizeof(fd_pubkey_t) ) ) {
+        // TODO does this correctly handle stake account close?
+        fd_store_stake_delegation( slot_ctx, acc_rec );
       }
     }
+  }
 
-    fd_funk_start_write( slot_ctx->acc_mgr->funk );
-    int ret = fd_funk_txn_merge_all_children(slot_ctx->acc_mgr->funk, slot_ctx->funk_txn, 1);
-    fd_funk_end_write( slot_ctx->acc_mgr->funk );
-    if( ret != FD_FUNK_SUCCESS ) {
-      FD_LOG_ERR(( "failed merging funk transaction: (%i-%s) ", ret, fd_funk_strerror(ret) ));
+  for( ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++ ) {
+    /* Transaction was skipped due to preparation failure. */
+    if( task_info[txn_idx].txn->flags == 0) {
+      continue;
     }
 
-    for (ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++) {
-      fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
-      fd_valloc_free( txn_ctx->valloc, fd_instr_info_pool_delete( fd_instr_info_pool_leave( txn_ctx->instr_info_pool ) ) );
-      fd_valloc_free( slot_ctx->valloc, txn_ctx );
+    fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
+
+    for( ulong i = 0; i < txn_ctx->accounts_cnt; i++ ) {
+      fd_borrowed_account_t * acc_rec = &txn_ctx->borrowed_accounts[i];
+      void * acc_rec_data = fd_borrowed_account_destroy( acc_rec );
+      if( acc_rec_data != NULL ) {
+        fd_valloc_free( txn_ctx->valloc, acc_rec_data );
+      }
     }
+  }
 
-    return 0;
-  } FD_SCRATCH_SCOPE_END;
+  fd_funk_start_write( slot_ctx->acc_mgr->funk );
+  int ret = fd_funk_txn_merge_all_children(slot_ctx->acc_mgr->funk, slot_ctx->funk_txn, 1);
+  fd_funk_end_write( slot_ctx->acc_mgr->funk );
+  if( ret != FD_FUNK_SUCCESS ) {
+    FD_LOG_ERR(( "failed merging funk transaction: (%i-%s) ", ret, fd_funk_strerror(ret) ));
+  }
+
+  for (ulong txn_idx = 0; txn_idx < txn_cnt; txn_idx++) {
+    fd_exec_txn_ctx_t * txn_ctx = task_info[txn_idx].txn_ctx;
+    fd_valloc_free( txn_ctx->valloc, fd_instr_info_pool_delete( fd_instr_info_pool_leave( txn_ctx->instr_info_pool ) ) );
+    fd_valloc_free( slot_ctx->valloc, txn_ctx );
+  }
+
+  return 0;
 }
 
+int
+fd_runtime_finalize_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
+                                fd_capture_ctx_t * capture_ctx,
+                                fd_execute_txn_task_info_t * task_info,
+                                ulong txn_cnt,
+                                fd_tpool_t * tpool,
+                                ulong max_workers ) {
+  int res = fd_runtime_finalize_txns_save_tpool( slot_ctx, capture_ctx, task_info, txn_cnt, tpool, max_workers );
+  if( res != 0 ) {
+    return res;
+  }
+  return fd_runtime_finalize_txns_post( slot_ctx, capture_ctx, task_info, txn_cnt );
+}
 
 /* Make sure there are no dependent txns! */
 int
@@ -1369,110 +1477,74 @@ fd_runtime_execute_txns_tpool( fd_exec_slot_ctx_t * slot_ctx,
   return 0;
 }
 
-struct fd_pubkey_map_node {
-  fd_pubkey_t pubkey;
-  uint        hash;
+/* Dependency driven execution
+
+   Txns are dispatched by fd_txn_sched (see fd_txn_sched.h): the caller
+   admits txns in block order and finalizes them as they complete, while
+   workers (0,max_workers) execute them.  A txn is admitted once all
+   txns it conflicts with earlier in the batch have been finalized.
+
+   Admission runs phase 2 (the account checks and fee collection) and
+   phase 3 (the block and account cost limits).  Phase 2 reads the nonce
+   account and every account of the txn, so it has to wait for the
+   earlier writers of these, exactly like execution.  Since admission is
+   in block order, the cost limits are charged for the txns that passed
+   phase 2, in the same order as serial execution.  Only the blockhash
+   check, which depends on nothing but the block hash queue, runs before
+   any txn of the batch.
+
+   While workers execute, the dispatcher only writes the funk records of
+   the fee payers of the txns it admits and of the accounts written by
+   the txns it finalizes.  No running txn references any of these
+   accounts, and funk records are initialized before they are linked
+   into the record map (see fd_funk_rec_insert_para), so lookups of
+   other accounts by the workers are unaffected.  The rest of
+   finalization - txn status capture, the vote and stake caches and
+   timestamp votes in slot_bank, merging funk txns and freeing txn ctxs
+   back to slot_ctx->valloc - is deferred until all txns of the batch
+   have executed, and then done in block order. */
+
+struct fd_runtime_txn_sched_ctx {
+  fd_exec_slot_ctx_t *         slot_ctx;
+  fd_capture_ctx_t *           capture_ctx;
+  fd_execute_txn_task_info_t * task_infos;
+  fd_tpool_t *                 tpool;
+  int                          res;
 };
-typedef struct fd_pubkey_map_node fd_pubkey_map_node_t;
-
-#define MAP_NAME                fd_pubkey_map
-#define MAP_T                   fd_pubkey_map_node_t
-#define MAP_KEY                 pubkey
-#define MAP_KEY_T               fd_pubkey_t
-#define MAP_KEY_NULL            pubkey_null
-#define MAP_KEY_INVAL( k )      !( memcmp( &k, &pubkey_null, sizeof( fd_pubkey_t ) ) )
-#define MAP_KEY_EQUAL( k0, k1 ) !( memcmp( ( &k0 ), ( &k1 ), sizeof( fd_pubkey_t ) ) )
-#define MAP_KEY_EQUAL_IS_SLOW   1
-#define MAP_KEY_HASH( key )     ( (uint)( fd_hash( 0UL, &key, sizeof( fd_pubkey_t ) ) ) )
-#define MAP_MEMOIZE             1
-#include "../../util/tmpl/fd_map_dynamic.c"
-
-/* return 0 on failure, 1 if exists, 2 if inserted */
-static uint
-fd_pubkey_map_insert_if_not_in( fd_pubkey_map_node_t * map,
-                                fd_pubkey_t            pubkey ) {
-  /* Check if entry already exists */
-  fd_pubkey_map_node_t * entry = fd_pubkey_map_query( map, pubkey, NULL );
-  if( entry )
-    return 1;
+typedef struct fd_runtime_txn_sched_ctx fd_runtime_txn_sched_ctx_t;
 
-  /* Insert new */
-  entry = fd_pubkey_map_insert( map, pubkey );
-  if( FD_UNLIKELY( !entry ) ) return 0;  /* check for internal map collision */
+static int
+fd_runtime_txn_sched_prepare( void * _ctx,
+                              ulong  txn_idx ) {
+  fd_runtime_txn_sched_ctx_t * ctx       = (fd_runtime_txn_sched_ctx_t *)_ctx;
+  fd_execute_txn_task_info_t * task_info = &ctx->task_infos[ txn_idx ];
+  if( task_info->txn->flags==0 ) return 1;
+
+  /* Check the accounts and collect the fee serially on the dispatcher
+     (the workers are busy) */
+  int res = fd_runtime_prepare_txns_phase2_tpool( ctx->slot_ctx, task_info, 1UL, ctx->tpool, 1UL );
+  if( res != 0 ) {
+    FD_LOG_WARNING(("Fail prep 2"));
+    ctx->res |= res;
+  }
+  if( task_info->txn->flags==0 ) return 1;
 
-  return 2;
+  res = fd_runtime_prepare_txns_phase3( ctx->slot_ctx, task_info, 1UL );
+  if( res != 0 ) {
+    FD_LOG_WARNING(("Fail prep 3"));
+    ctx->res |= res;
+  }
+  return task_info->txn->flags==0;
 }
 
-void
-fd_runtime_generate_wave( fd_execute_txn_task_info_t * task_infos,
-                          ulong * prev_incomplete_txn_idxs,
-                          ulong prev_incomplete_txn_idxs_cnt,
-                          ulong prev_accounts_cnt,
-                          ulong * incomplete_txn_idxs,
-                          ulong * _incomplete_txn_idxs_cnt,
-                          ulong * _incomplete_accounts_cnt,
-                          fd_execute_txn_task_info_t * wave_task_infos,
-                          ulong * _wave_task_infos_cnt ) {
-  FD_SCRATCH_SCOPE_BEGIN {
-    int lg_slot_cnt = fd_ulong_find_msb( prev_accounts_cnt ) + 1;
-    void * read_map_mem = fd_scratch_alloc( fd_pubkey_map_align(), fd_pubkey_map_footprint( lg_slot_cnt ) );
-    fd_pubkey_map_node_t * read_map = fd_pubkey_map_join( fd_pubkey_map_new( read_map_mem, lg_slot_cnt ) );
-
-    void * write_map_mem = fd_scratch_alloc( fd_pubkey_map_align(), fd_pubkey_map_footprint( lg_slot_cnt ) );
-    fd_pubkey_map_node_t * write_map = fd_pubkey_map_join( fd_pubkey_map_new( write_map_mem, lg_slot_cnt ) );
-
-    ulong incomplete_txn_idxs_cnt = 0;
-    ulong wave_task_infos_cnt = 0;
-    ulong accounts_in_wave = 0;
-    for( ulong i = 0; i < prev_incomplete_txn_idxs_cnt; i++ ) {
-      ulong txn_idx = prev_incomplete_txn_idxs[i];
-      uint is_executable_now = 1;
-      fd_execute_txn_task_info_t * task_info = &task_infos[txn_idx];
-      // if( FD_UNLIKELY( accounts_in_wave >= (() - FD_TXN_ACCT_ADDR_MAX) ) ) {
-      //   incomplete_txn_idxs[incomplete_txn_idxs_cnt++] = txn_idx;
-      //   continue;
-      // }
-
-      for( ulong j = 0; j < task_info->txn_ctx->accounts_cnt; j++ ) {
-        if( fd_pubkey_map_query( write_map, task_info->txn_ctx->accounts[j], NULL ) != NULL ) {
-          is_executable_now = 0;
-          break;
-        }
-        if( fd_txn_account_is_writable_idx( task_info->txn_ctx->txn_descriptor, task_info->txn_ctx->accounts, (int)j ) ) {
-          if( fd_pubkey_map_query( read_map, task_info->txn_ctx->accounts[j], NULL ) != NULL ) {
-            is_executable_now = 0;
-            break;
-          }
-        }
-      }
-
-      if( !is_executable_now ) {
-        incomplete_txn_idxs[incomplete_txn_idxs_cnt++] = txn_idx;
-      } else {
-        wave_task_infos[wave_task_infos_cnt++] = *task_info;
-      }
-
-      /* Include txn in wave */
-      for( ulong j = 0; j < task_info->txn_ctx->accounts_cnt; j++ ) {
-        if( fd_txn_account_is_writable_idx( task_info->txn_ctx->txn_descriptor, task_info->txn_ctx->accounts, (int)j) ) {
-          uint ins_res = fd_pubkey_map_insert_if_not_in( write_map, task_info->txn_ctx->accounts[j] );
-          if( ins_res == 2 ) {
-            accounts_in_wave++;
-          }
-        } else {
-          uint ins_res = fd_pubkey_map_insert_if_not_in( read_map, task_info->txn_ctx->accounts[j] );
-          if( ins_res == 2 ) {
-            accounts_in_wave++;
-          }
-        }
-      }
-
-    }
+static void
+fd_runtime_txn_sched_finalize( void * _ctx,
+                               ulong  txn_idx ) {
+  fd_runtime_txn_sched_ctx_t * ctx       = (fd_runtime_txn_sched_ctx_t *)_ctx;
+  fd_execute_txn_task_info_t * task_info = &ctx->task_infos[ txn_idx ];
 
-    *_incomplete_txn_idxs_cnt = incomplete_txn_idxs_cnt;
-    *_incomplete_accounts_cnt = prev_accounts_cnt - accounts_in_wave;
-    *_wave_task_infos_cnt = wave_task_infos_cnt;
-  } FD_SCRATCH_SCOPE_END;
+  ctx->slot_ctx->signature_cnt += task_info->txn_ctx->txn_descriptor->signature_cnt;
+  ctx->res |= fd_runtime_finalize_txns_save_tpool( ctx->slot_ctx, ctx->capture_ctx, task_info, 1UL, ctx->tpool, 1UL );
 }
 
 int
@@ -1484,70 +1556,70 @@ fd_runtime_execute_txns_in_waves_tpool( fd_exec_slot_ctx_t * slot_ctx,
                                         ulong max_workers ) {
   FD_SCRATCH_SCOPE_BEGIN {
     fd_execute_txn_task_info_t * task_infos = fd_scratch_alloc( 8, txn_cnt * sizeof(fd_execute_txn_task_info_t));
-    fd_execute_txn_task_info_t * wave_task_infos = fd_scratch_alloc( 8, txn_cnt * sizeof(fd_execute_txn_task_info_t));
-    ulong wave_task_infos_cnt = 0;
 
     int res = fd_runtime_prepare_txns_phase1( slot_ctx, task_infos, txns, txn_cnt );
     if( res != 0 ) {
       FD_LOG_WARNING(("Fail prep 1"));
     }
 
-    ulong * incomplete_txn_idxs = fd_scratch_alloc( 8UL, txn_cnt * sizeof(ulong) );
-    ulong incomplete_txn_idxs_cnt = txn_cnt;
-    ulong incomplete_accounts_cnt = 0;
-
-    /* Setup all txns as incomplete and set the capture context */
+    /* Set the capture context and collect the account references of
+       every txn to build the conflict graph */
+    ulong * acct_off = fd_scratch_alloc( 8UL, (txn_cnt+1UL) * sizeof(ulong) );
+    acct_off[0] = 0UL;
     for( ulong i = 0; i < txn_cnt; i++ ) {
-      incomplete_txn_idxs[i] = i;
-      incomplete_accounts_cnt += task_infos[i].txn_ctx->accounts_cnt;
+      acct_off[i+1] = acct_off[i] + task_infos[i].txn_ctx->accounts_cnt;
       task_infos[i].txn_ctx->capture_ctx = capture_ctx;
 
       txns[i].flags = FD_TXN_P_FLAGS_SANITIZE_SUCCESS;
     }
 
-    ulong * next_incomplete_txn_idxs = fd_scratch_alloc( 8UL, txn_cnt * sizeof(ulong) );
-    ulong next_incomplete_txn_idxs_cnt = 0;
-    ulong next_incomplete_accounts_cnt = 0;
-
-    double cum_wave_time_ms = 0.0;
-    while( incomplete_txn_idxs_cnt > 0 ) {
-      long wave_time = -fd_log_wallclock();
-      fd_runtime_generate_wave( task_infos, incomplete_txn_idxs, incomplete_txn_idxs_cnt, incomplete_accounts_cnt,
-                                next_incomplete_txn_idxs, &next_incomplete_txn_idxs_cnt, &next_incomplete_accounts_cnt,
-                                wave_task_infos, &wave_task_infos_cnt );
-      ulong * temp_incomplete_txn_idxs = incomplete_txn_idxs;
-      incomplete_txn_idxs = next_incomplete_txn_idxs;
-      next_incomplete_txn_idxs = temp_incomplete_txn_idxs;
-      incomplete_txn_idxs_cnt = next_incomplete_txn_idxs_cnt;
-
-      res |= fd_runtime_prepare_txns_phase2_tpool( slot_ctx, wave_task_infos, wave_task_infos_cnt, tpool, max_workers );
-      if( res != 0 ) {
-        FD_LOG_WARNING(("Fail prep 2"));
+    fd_txn_sched_acct_t * accts = fd_scratch_alloc( alignof(fd_txn_sched_acct_t), acct_off[txn_cnt] * sizeof(fd_txn_sched_acct_t) );
+    for( ulong i = 0; i < txn_cnt; i++ ) {
+      fd_exec_txn_ctx_t const * txn_ctx = task_infos[i].txn_ctx;
+      for( ulong j = 0; j < txn_ctx->accounts_cnt; j++ ) {
+        accts[ acct_off[i]+j ] = (fd_txn_sched_acct_t){
+          .pubkey   = &txn_ctx->accounts[j],
+          .writable = fd_txn_account_is_writable_idx( txn_ctx->txn_descriptor, txn_ctx->accounts, (int)j )
+        };
       }
+    }
 
-      res |= fd_runtime_prepare_txns_phase3( slot_ctx, wave_task_infos, wave_task_infos_cnt );
-      if( res != 0 ) {
-        FD_LOG_WARNING(("Fail prep 3"));
+    /* Reject txns with an unknown recent blockhash.  Everything else
+       is checked when the txn is admitted. */
+    for( ulong i = 0; i < txn_cnt; i++ ) {
+      int err = fd_runtime_txn_check_blockhash( slot_ctx, task_infos[i].txn_ctx );
+      if( err != 0 ) {
+        txns[i].flags = 0;
+        res |= err;
       }
+    }
 
-      fd_tpool_exec_all_taskq( tpool, 0, max_workers, fd_runtime_execute_txn_task, wave_task_infos, NULL, NULL, 1, 0, wave_task_infos_cnt );
-      res |= fd_runtime_finalize_txns_tpool( slot_ctx, capture_ctx, wave_task_infos, wave_task_infos_cnt, tpool, max_workers );
-      if( res != 0 ) {
-        return res;
-      }
+    fd_txn_sched_t sched[1];
+    fd_txn_sched_build( sched, txn_cnt, acct_off, accts );
 
-      for( ulong j = 0UL; j < wave_task_infos_cnt; j++ ) {
-        slot_ctx->signature_cnt += wave_task_infos[j].txn_ctx->txn_descriptor->signature_cnt;
-      }
-      wave_time += fd_log_wallclock();
-      double wave_time_ms = (double)wave_time * 1e-6;
-      cum_wave_time_ms += wave_time_ms;
-      (void)cum_wave_time_ms;
-      // FD_LOG_INFO(( "wave executed - sz: %lu, accounts: %lu, elapsed: %6.6f ms, cum: %6.6f ms", wave_task_infos_cnt, incomplete_accounts_cnt - next_incomplete_accounts_cnt, wave_time_ms, cum_wave_time_ms ));
+    fd_runtime_txn_sched_ctx_t ctx = {
+      .slot_ctx    = slot_ctx,
+      .capture_ctx = capture_ctx,
+      .task_infos  = task_infos,
+      .tpool       = tpool,
+      .res         = res
+    };
+    ulong done_txn_cnt = fd_txn_sched_run( sched, tpool, 0UL, max_workers,
+                                           fd_runtime_txn_sched_prepare,
+                                           fd_runtime_execute_txn_task, task_infos,
+                                           fd_runtime_txn_sched_finalize, &ctx );
+
+    /* Edges only point from earlier to later txns so the graph is
+       acyclic and every txn is eventually released. */
+    if( FD_UNLIKELY( done_txn_cnt != txn_cnt ) ) {
+      FD_LOG_ERR(( "txn dependency graph did not drain (%lu of %lu txns executed)", done_txn_cnt, txn_cnt ));
     }
+
+    ctx.res |= fd_runtime_finalize_txns_post( slot_ctx, capture_ctx, task_infos, txn_cnt );
+
     slot_ctx->slot_bank.transaction_count += txn_cnt;
 
-    return res;
+    return ctx.res;
   } FD_SCRATCH_SCOPE_END;
 }
 
@@ -2289,7 +2361,9 @@ fd_runtime_checkpt( fd_capture_ctx_t * capture_ctx,
 
 int
 fd_runtime_publish_old_txns( fd_exec_slot_ctx_t * slot_ctx,
-                             fd_capture_ctx_t * capture_ctx ) {
+                             fd_capture_ctx_t * capture_ctx,
+                             fd_tpool_t * tpool,
+                             ulong max_workers ) {
   /* Publish any transaction older than 31 slots */
   fd_funk_t * funk = slot_ctx->acc_mgr->funk;
   fd_funk_txn_t * txnmap = fd_funk_txn_map(funk, fd_funk_wksp(funk));
@@ -2309,7 +2383,9 @@ fd_runtime_publish_old_txns( fd_exec_slot_ctx_t * slot_ctx,
       if (FD_FEATURE_ACTIVE(slot_ctx, epoch_accounts_hash)) {
         fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx );
         if (txn->xid.ul[0] >= epoch_bank->eah_start_slot) {
-          fd_accounts_hash( slot_ctx, &slot_ctx->slot_bank.epoch_account_hash, NULL, 0, 0 );
+          /* This walks the whole root with the write lock held, so
+             spread it over the tpool */
+          fd_accounts_hash_tpool( slot_ctx, &slot_ctx->slot_bank.epoch_account_hash, tpool, max_workers );
           epoch_bank->eah_start_slot = ULONG_MAX;
         }
       }
@@ -2338,7 +2414,7 @@ fd_runtime_block_eval_tpool(fd_exec_slot_ctx_t *slot_ctx,
                                 ulong * txn_cnt ) {
   (void)scheduler;
 
-  int err = fd_runtime_publish_old_txns( slot_ctx, capture_ctx );
+  int err = fd_runtime_publish_old_txns( slot_ctx, capture_ctx, tpool, max_workers );
   if( err != 0 ) {
     return err;
   }
@@ -2353,21 +2429,19 @@ fd_runtime_block_eval_tpool(fd_exec_slot_ctx_t *slot_ctx,
   /* Use the blockhash as the funk xid */
   fd_funk_txn_xid_t xid;
 
-  fd_blockstore_start_read(slot_ctx->blockstore);
   ulong slot = slot_ctx->slot_bank.slot;
-  fd_hash_t const * hash = fd_blockstore_block_hash_query(slot_ctx->blockstore, slot);
-  if( hash == NULL ) {
+  fd_hash_t hash;
+  if( fd_blockstore_block_hash_query_volatile(slot_ctx->blockstore, slot, &hash) ) {
     ret = FD_RUNTIME_EXECUTE_GENERIC_ERR;
     FD_LOG_WARNING(("missing blockhash for %lu", slot));
   } else {
-    fd_memcpy(xid.uc, hash->uc, sizeof(fd_funk_txn_xid_t));
+    fd_memcpy(xid.uc, hash.uc, sizeof(fd_funk_txn_xid_t));
     xid.ul[0] = slot_ctx->slot_bank.slot;
     /* push a new transaction on the stack */
     fd_funk_start_write( funk );
     slot_ctx->funk_txn = fd_funk_txn_prepare(funk, slot_ctx->funk_txn, &xid, 1);
     fd_funk_end_write( funk );
   }
-  fd_blockstore_end_read(slot_ctx->blockstore);
 
   if( FD_RUNTIME_EXECUTE_SUCCESS == ret ) {
     ret = fd_runtime_block_verify_tpool(&block_info, &slot_ctx->slot_bank.poh, &slot_ctx->slot_bank.poh, slot_ctx->valloc, tpool, max_workers);
@@ -2416,16 +2490,11 @@ fd_runtime_rollback_to( fd_exec_slot_ctx_t * slot_ctx, ulong slot ) {
   fd_blockstore_t * blockstore = slot_ctx->blockstore;
   FD_LOG_WARNING(("rolling back to slot %lu", slot));
   /* Get the blockhash, which is used as the funk transaction id */
-  fd_blockstore_start_read(blockstore);
-  fd_hash_t const * hash = fd_blockstore_block_hash_query(blockstore, slot);
-  if( !hash ) {
-    fd_blockstore_end_read(blockstore);
-    return -1;
-  }
+  fd_hash_t hash;
+  if( fd_blockstore_block_hash_query_volatile(blockstore, slot, &hash) ) return -1;
   fd_funk_txn_xid_t xid;
-  fd_memcpy(xid.uc, hash, sizeof(fd_funk_txn_xid_t));
+  fd_memcpy(xid.uc, hash.uc, sizeof(fd_funk_txn_xid_t));
   xid.ul[0] = slot;
-  fd_blockstore_end_read(blockstore);
   /* Switch to the funk transaction */
   fd_funk_txn_t * txn = fd_funk_txn_query(&xid, txnmap);
   if( !txn) return -1;
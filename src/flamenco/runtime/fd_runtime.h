@@ -71,6 +71,8 @@ typedef struct fd_runtime_ctx fd_runtime_ctx_t;
 
 struct fd_runtime_args {
   char const * blockstore_wksp_name;
+  char const * blockstore_archive;
+  ulong        blockstore_archive_sz_gb;
   char const * funk_wksp_name;
   char const * gossip_peer_addr;
   char const * incremental_snapshot;
@@ -95,6 +97,7 @@ struct fd_runtime_args {
   char const * check_hash;
   int          retrace;
   int          abort_on_mismatch;
+  int          vm_jit;
   ulong        end_slot;
   ulong        index_max;
   ulong        page_cnt;
@@ -111,6 +114,7 @@ struct fd_runtime_args {
   char const * dump_insn_output_dir;
   int          on_demand_block_ingest;
   ulong        on_demand_block_history;
+  ulong        on_demand_block_prefetch;
   int          copy_txn_status;
   ulong        trash_hash;
   fd_wksp_t *  funk_wksp;
@@ -178,9 +182,15 @@ ulong
 fd_runtime_block_collect_txns( fd_block_info_t const * block_info,
                                fd_txn_p_t * out_txns );
 
+/* fd_runtime_publish_old_txns publishes the funk txn of the slot that
+   became rooted.  The epoch accounts hash, if due, is computed over
+   the tpool (which may be NULL). */
+
 int
 fd_runtime_publish_old_txns( fd_exec_slot_ctx_t * slot_ctx,
-                             fd_capture_ctx_t * capture_ctx );
+                             fd_capture_ctx_t * capture_ctx,
+                             fd_tpool_t * tpool,
+                             ulong max_workers );
 
 int
 fd_runtime_block_eval_tpool( fd_exec_slot_ctx_t * slot_ctx,
@@ -192,6 +202,14 @@ fd_runtime_block_eval_tpool( fd_exec_slot_ctx_t * slot_ctx,
                              ulong scheduler,
                              ulong * txn_cnt );
 
+/* fd_runtime_execute_txns_in_waves_tpool executes a batch of txns on
+   tpool workers (0,max_workers) using fd_txn_sched.  The caller
+   checks, charges and dispatches txns to idle workers in block order,
+   each once every txn it conflicts with earlier in the batch has been
+   finalized.  Txns that do not conflict may execute in any order.  The
+   result matches executing the txns one at a time in block order.
+   Executes on the caller if max_workers<=1. */
+
 int
 fd_runtime_execute_txns_in_waves_tpool( fd_exec_slot_ctx_t * slot_ctx,
                                         fd_capture_ctx_t * capture_ctx,
@@ -0,0 +1,195 @@
+#include "fd_txn_sched.h"
+
+struct fd_txn_sched_acct_ele {
+  fd_pubkey_t pubkey;
+  uint        hash;
+  ulong       writer;      /* Last txn to write the account, IDX_NULL if none */
+  ulong       reader_head; /* List of txns that read it since then */
+};
+typedef struct fd_txn_sched_acct_ele fd_txn_sched_acct_ele_t;
+
+#define MAP_NAME                fd_txn_sched_acct_map
+#define MAP_T                   fd_txn_sched_acct_ele_t
+#define MAP_KEY                 pubkey
+#define MAP_KEY_T               fd_pubkey_t
+#define MAP_KEY_NULL            pubkey_null
+#define MAP_KEY_INVAL( k )      !( memcmp( &k, &pubkey_null, sizeof( fd_pubkey_t ) ) )
+#define MAP_KEY_EQUAL( k0, k1 ) !( memcmp( ( &k0 ), ( &k1 ), sizeof( fd_pubkey_t ) ) )
+#define MAP_KEY_EQUAL_IS_SLOW   1
+#define MAP_KEY_HASH( key )     ( (uint)( fd_hash( 0UL, &key, sizeof( fd_pubkey_t ) ) ) )
+#define MAP_MEMOIZE             1
+#include "../../util/tmpl/fd_map_dynamic.c"
+
+static inline void
+fd_txn_sched_add_edge( fd_txn_sched_t * sched,
+                       ulong            src,
+                       ulong            dst ) {
+  if( src==FD_TXN_SCHED_IDX_NULL || src==dst ) return;
+  ulong link_idx           = sched->link_cnt++;
+  sched->link[ link_idx ]  = (fd_txn_sched_link_t){ .txn_idx = dst, .next = sched->succ_head[ src ] };
+  sched->succ_head[ src ]  = link_idx;
+  sched->in_deg[ dst ]++;
+}
+
+fd_txn_sched_t *
+fd_txn_sched_build( fd_txn_sched_t *            sched,
+                    ulong                       txn_cnt,
+                    ulong const *               acct_off,
+                    fd_txn_sched_acct_t const * acct ) {
+
+  /* Each account reference adds at most one edge from the last writer,
+     and either one reader list entry or one edge per reader in the
+     list (which it then empties).  Every reader list entry is thus
+     turned into at most one edge, bounding the link count by three per
+     reference. */
+
+  ulong acct_ref_cnt = acct_off[ txn_cnt ];
+
+  sched->txn_cnt   = txn_cnt;
+  sched->in_deg    = fd_scratch_alloc( alignof(ulong), txn_cnt * sizeof(ulong) );
+  sched->succ_head = fd_scratch_alloc( alignof(ulong), txn_cnt * sizeof(ulong) );
+  sched->link      = fd_scratch_alloc( alignof(fd_txn_sched_link_t), 3UL * acct_ref_cnt * sizeof(fd_txn_sched_link_t) );
+  sched->link_cnt  = 0UL;
+
+  for( ulong txn_idx = 0UL; txn_idx < txn_cnt; txn_idx++ ) {
+    sched->in_deg   [ txn_idx ] = 0UL;
+    sched->succ_head[ txn_idx ] = FD_TXN_SCHED_IDX_NULL;
+  }
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    int lg_slot_cnt = fd_ulong_find_msb( fd_ulong_max( acct_ref_cnt, 1UL ) ) + 2;
+    void * map_mem = fd_scratch_alloc( fd_txn_sched_acct_map_align(), fd_txn_sched_acct_map_footprint( lg_slot_cnt ) );
+    fd_txn_sched_acct_ele_t * acct_map = fd_txn_sched_acct_map_join( fd_txn_sched_acct_map_new( map_mem, lg_slot_cnt ) );
+
+    for( ulong txn_idx = 0UL; txn_idx < txn_cnt; txn_idx++ ) {
+      for( ulong j = acct_off[ txn_idx ]; j < acct_off[ txn_idx+1UL ]; j++ ) {
+        fd_pubkey_t const * pubkey = acct[ j ].pubkey;
+        if( FD_UNLIKELY( !memcmp( pubkey, &pubkey_null, sizeof(fd_pubkey_t) ) ) ) continue;
+
+        fd_txn_sched_acct_ele_t * ele = fd_txn_sched_acct_map_query( acct_map, *pubkey, NULL );
+        if( !ele ) {
+          ele = fd_txn_sched_acct_map_insert( acct_map, *pubkey );
+          if( FD_UNLIKELY( !ele ) ) FD_LOG_ERR(( "txn sched account map full" )); /* sized from acct_ref_cnt, never happens */
+          ele->writer      = FD_TXN_SCHED_IDX_NULL;
+          ele->reader_head = FD_TXN_SCHED_IDX_NULL;
+        }
+
+        fd_txn_sched_add_edge( sched, ele->writer, txn_idx );
+
+        if( acct[ j ].writable ) {
+          for( ulong r = ele->reader_head; r != FD_TXN_SCHED_IDX_NULL; r = sched->link[ r ].next ) {
+            fd_txn_sched_add_edge( sched, sched->link[ r ].txn_idx, txn_idx );
+          }
+          ele->writer      = txn_idx;
+          ele->reader_head = FD_TXN_SCHED_IDX_NULL;
+        } else {
+          ulong link_idx          = sched->link_cnt++;
+          sched->link[ link_idx ] = (fd_txn_sched_link_t){ .txn_idx = txn_idx, .next = ele->reader_head };
+          ele->reader_head        = link_idx;
+        }
+      }
+    }
+
+    fd_txn_sched_acct_map_delete( fd_txn_sched_acct_map_leave( acct_map ) );
+  } FD_SCRATCH_SCOPE_END;
+
+  return sched;
+}
+
+/* fd_txn_sched_release finalizes txn_idx and releases the txns it was
+   the last unfinalized predecessor of. */
+
+static inline void
+fd_txn_sched_release( fd_txn_sched_t *           sched,
+                      fd_txn_sched_finalize_fn_t finalize,
+                      void *                     ctx,
+                      ulong                      txn_idx ) {
+  finalize( ctx, txn_idx );
+  for( ulong l = sched->succ_head[ txn_idx ]; l != FD_TXN_SCHED_IDX_NULL; l = sched->link[ l ].next ) {
+    sched->in_deg[ sched->link[ l ].txn_idx ]--;
+  }
+}
+
+ulong
+fd_txn_sched_run( fd_txn_sched_t *           sched,
+                  fd_tpool_t *               tpool,
+                  ulong                      t0,
+                  ulong                      t1,
+                  fd_txn_sched_prepare_fn_t  prepare,
+                  fd_tpool_task_t            execute,
+                  void *                     execute_tpool,
+                  fd_txn_sched_finalize_fn_t finalize,
+                  void *                     ctx ) {
+  ulong txn_cnt = sched->txn_cnt;
+  ulong done    = 0UL;
+
+  /* Txns are admitted (prepared) in block order.  next is the next txn
+     to admit; it is admitted once all of its predecessors have been
+     finalized. */
+
+  ulong next = 0UL;
+
+  if( !tpool || t1-t0<=1UL ) {
+
+    /* No workers, execute on the caller in block order.  Every earlier
+       txn is finalized by the time a txn is admitted. */
+
+    for( ; next < txn_cnt; next++ ) {
+      if( !prepare( ctx, next ) ) {
+        execute( execute_tpool, t0,t1, ctx, NULL,0UL, 0UL,txn_cnt, next,next+1UL, t0,t0+1UL );
+      }
+      fd_txn_sched_release( sched, finalize, ctx, next );
+      done++;
+    }
+    return done;
+  }
+
+  FD_SCRATCH_SCOPE_BEGIN {
+
+    /* busy[ w-t0 ] is the txn running on worker w, IDX_NULL if idle */
+
+    ulong * busy     = fd_scratch_alloc( alignof(ulong), (t1-t0) * sizeof(ulong) );
+    ulong   busy_cnt = 0UL;
+    for( ulong w = t0; w < t1; w++ ) busy[ w-t0 ] = FD_TXN_SCHED_IDX_NULL;
+
+    while( (next < txn_cnt) | (busy_cnt>0UL) ) {
+      int progress = 0;
+
+      /* Finalize completed txns.  This may release more txns. */
+
+      for( ulong w = t0+1UL; w < t1; w++ ) {
+        ulong txn_idx = busy[ w-t0 ];
+        if( txn_idx==FD_TXN_SCHED_IDX_NULL || fd_tpool_worker_state( tpool, w )==FD_TPOOL_WORKER_STATE_EXEC ) continue;
+        busy[ w-t0 ] = FD_TXN_SCHED_IDX_NULL;
+        busy_cnt--;
+        fd_txn_sched_release( sched, finalize, ctx, txn_idx );
+        done++;
+        progress = 1;
+      }
+
+      /* Admit released txns in order and hand them to idle workers */
+
+      for( ulong w = t0+1UL; w < t1; w++ ) {
+        if( busy[ w-t0 ]!=FD_TXN_SCHED_IDX_NULL ) continue;
+        while( (next < txn_cnt) && !sched->in_deg[ next ] ) {
+          ulong txn_idx = next++;
+          progress = 1;
+          if( FD_UNLIKELY( prepare( ctx, txn_idx ) ) ) {
+            fd_txn_sched_release( sched, finalize, ctx, txn_idx );
+            done++;
+            continue;
+          }
+          fd_tpool_exec( tpool, w, execute, execute_tpool, t0,t1, ctx, NULL,0UL, 0UL,txn_cnt, txn_idx,txn_idx+1UL, w,w+1UL );
+          busy[ w-t0 ] = txn_idx;
+          busy_cnt++;
+          break;
+        }
+      }
+
+      if( !progress ) FD_SPIN_PAUSE();
+    }
+
+  } FD_SCRATCH_SCOPE_END;
+
+  return done;
+}
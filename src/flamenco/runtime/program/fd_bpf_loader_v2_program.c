@@ -6,8 +6,10 @@
 #include "../../../ballet/sbpf/fd_sbpf_loader.h"
 #include "../../vm/fd_vm_syscalls.h"
 #include "../../vm/fd_vm_interp.h"
+#include "../../vm/fd_vm_jit.h"
 #include "../../vm/fd_vm_disasm.h"
 #include "fd_bpf_loader_serialization.h"
+#include "fd_bpf_program_util.h"
 
 #include <stdio.h>
 
@@ -42,51 +44,11 @@ fd_bpf_loader_v2_is_executable( fd_exec_slot_ctx_t * slot_ctx,
   return 0;
 }
 
-int
-fd_bpf_loader_v2_user_execute( fd_exec_instr_ctx_t ctx ) {
-  // FIXME: the program account is not in the instruction accounts?
-  fd_borrowed_account_t * program_acc_view = NULL;
-  int read_result = fd_txn_borrowed_account_view_idx( ctx.txn_ctx, ctx.instr->program_id, &program_acc_view );
-  if (FD_UNLIKELY(read_result != FD_ACC_MGR_SUCCESS)) {
-    return FD_EXECUTOR_INSTR_ERR_MISSING_ACC;
-  }
-
-  fd_account_meta_t const * metadata = program_acc_view->const_meta;
-  uchar const * program_data               = program_acc_view->const_data;
-  ulong program_data_len = metadata->dlen;
-
-  long dt = -fd_log_wallclock();
-  fd_sbpf_elf_info_t elf_info;
-  if (fd_sbpf_elf_peek( &elf_info, program_data, program_data_len, false ) == NULL) {
-    return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
-  }
-
-  /* Allocate rodata segment */
-
-  void * rodata = fd_valloc_malloc( ctx.valloc, FD_SBPF_PROG_RODATA_ALIGN,  elf_info.rodata_footprint );
-  FD_TEST( rodata );
-
-  /* Allocate program buffer */
-
-  ulong  prog_align     = fd_sbpf_program_align();
-  ulong  prog_footprint = fd_sbpf_program_footprint( &elf_info );
-  fd_sbpf_program_t * prog = fd_sbpf_program_new( fd_valloc_malloc( ctx.valloc, prog_align, prog_footprint ), &elf_info, rodata );
-  FD_TEST( prog );
-
-  /* Allocate syscalls */
-
-  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_new( fd_valloc_malloc( ctx.valloc, fd_sbpf_syscalls_align(), fd_sbpf_syscalls_footprint() ) );
-  FD_TEST( syscalls );
-
-  fd_vm_syscall_register_all( syscalls );
-  /* Load program */
-
-  if(  0!=fd_sbpf_program_load( prog, program_data, program_data_len, syscalls, false ) ) {
-    FD_LOG_ERR(( "fd_sbpf_program_load() failed: %s", fd_sbpf_strerror() ));
-  }
-  dt += fd_log_wallclock();
-  (void)dt;
-  // FD_LOG_WARNING(( "sbpf load: %32J - time: %6.6f ms", ctx.instr->program_id_pubkey.key, (double)dt*1e-6 ));
+static int
+fd_bpf_loader_v2_user_execute_prog( fd_exec_instr_ctx_t           ctx,
+                                    fd_account_meta_t const *     metadata,
+                                    fd_sbpf_validated_program_t * prog ) {
+  fd_sbpf_syscalls_t * syscalls = fd_bpf_syscalls();
 
   ulong input_sz = 0;
   ulong pre_lens[256];
@@ -98,9 +60,6 @@ fd_bpf_loader_v2_user_execute( fd_exec_instr_ctx_t ctx ) {
   }
 
   if( input==NULL ) {
-    fd_valloc_free( ctx.valloc,  fd_sbpf_program_delete( prog ) );
-    fd_valloc_free( ctx.valloc,  fd_sbpf_syscalls_delete( syscalls ) );
-    fd_valloc_free( ctx.valloc, rodata);
     return FD_EXECUTOR_INSTR_ERR_MISSING_ACC;
   }
 
@@ -109,14 +68,14 @@ fd_bpf_loader_v2_user_execute( fd_exec_instr_ctx_t ctx ) {
     .program_counter     = 0,
     .instruction_counter = 0,
     .compute_meter       = ctx.txn_ctx->compute_meter,
-    .instrs              = (fd_sbpf_instr_t const *)fd_type_pun_const( prog->text ),
+    .instrs              = (fd_sbpf_instr_t const *)fd_type_pun_const( fd_sbpf_validated_program_rodata( prog ) + ( prog->text_off ) ),
     .instrs_sz           = prog->text_cnt,
     .instrs_offset       = prog->text_off,
     .syscall_map         = syscalls,
     .calldests           = prog->calldests,
     .input               = input,
     .input_sz            = input_sz,
-    .read_only           = (uchar *)fd_type_pun_const(prog->rodata),
+    .read_only           = fd_sbpf_validated_program_rodata( prog ),
     .read_only_sz        = prog->rodata_sz,
     .heap_sz = FD_VM_DEFAULT_HEAP_SZ,
     /* TODO configure heap allocator */
@@ -164,10 +123,10 @@ if (memcmp(signature, sig, 64) == 0) {
   if (memcmp(signature, sig, 64) == 0) {
     interp_res = fd_vm_interp_instrs_trace( &vm_ctx );
   } else {
-    interp_res = fd_vm_interp_instrs( &vm_ctx );
+    interp_res = fd_vm_jit_instrs( &vm_ctx, prog->text_hash );
   }
 #else
-  interp_res = fd_vm_interp_instrs( &vm_ctx );
+  interp_res = fd_vm_jit_instrs( &vm_ctx, prog->text_hash );
 #endif
   if( interp_res != 0 ) {
     FD_LOG_ERR(( "fd_vm_interp_instrs() failed: %lu", interp_res ));
@@ -255,10 +214,6 @@ if (memcmp(signature, sig, 64) == 0) {
 #endif
   ctx.txn_ctx->compute_meter = vm_ctx.compute_meter;
 
-  fd_valloc_free( ctx.valloc,  fd_sbpf_program_delete( prog ) );
-  fd_valloc_free( ctx.valloc,  fd_sbpf_syscalls_delete( syscalls ) );
-  fd_valloc_free( ctx.valloc, rodata);
-
 #ifdef VLOG
   FD_LOG_WARNING(( "fd_vm_interp_instrs() success: %lu, ic: %lu, pc: %lu, ep: %lu, r0: %lu, fault: %lu, cus: %lu", interp_res, vm_ctx.instruction_counter, vm_ctx.program_counter, vm_ctx.entrypoint, vm_ctx.register_file[0], vm_ctx.cond_fault, vm_ctx.compute_meter ));
 #endif
@@ -285,6 +240,28 @@ if (memcmp(signature, sig, 64) == 0) {
   return 0;
 }
 
+int
+fd_bpf_loader_v2_user_execute( fd_exec_instr_ctx_t ctx ) {
+  // FIXME: the program account is not in the instruction accounts?
+  fd_borrowed_account_t * program_acc_view = NULL;
+  int read_result = fd_txn_borrowed_account_view_idx( ctx.txn_ctx, ctx.instr->program_id, &program_acc_view );
+  if (FD_UNLIKELY(read_result != FD_ACC_MGR_SUCCESS)) {
+    return FD_EXECUTOR_INSTR_ERR_MISSING_ACC;
+  }
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    /* Loader v2 programs are immutable, so a cache entry is never stale.
+       Programs deployed in the current block are not in the cache yet. */
+    fd_sbpf_validated_program_t * prog = NULL;
+    if( FD_UNLIKELY( fd_bpf_load_cache_entry( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) &&
+                     fd_bpf_load_program( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) ) ) {
+      return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
+    }
+
+    return fd_bpf_loader_v2_user_execute_prog( ctx, program_acc_view->const_meta, prog );
+  } FD_SCRATCH_SCOPE_END;
+}
+
 int
 fd_bpf_loader_v2_program_execute( fd_exec_instr_ctx_t ctx ) {
   do {
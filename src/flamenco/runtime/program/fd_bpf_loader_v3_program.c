@@ -10,6 +10,7 @@
 #include "../sysvar/fd_sysvar_cache.h"
 #include "../../vm/fd_vm_syscalls.h"
 #include "../../vm/fd_vm_interp.h"
+#include "../../vm/fd_vm_jit.h"
 #include "../../vm/fd_vm_disasm.h"
 #include "fd_bpf_loader_serialization.h"
 #include "fd_bpf_program_util.h"
@@ -346,12 +347,7 @@ execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t * prog ) {
   /* TODO: This will be updated once belt-sanding is merged in. I am not changing
      the existing VM setup/invocation. */
 
-  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_new( fd_valloc_malloc( instr_ctx->valloc,
-                                                                          fd_sbpf_syscalls_align(),
-                                                                          fd_sbpf_syscalls_footprint() ) );
-  FD_TEST( syscalls );
-
-  fd_vm_syscall_register_all( syscalls );
+  fd_sbpf_syscalls_t * syscalls = fd_bpf_syscalls();
 
   /* https://github.com/anza-xyz/agave/blob/574bae8fefc0ed256b55340b9d87b7689bcdf222/programs/bpf_loader/src/lib.rs#L1362-L1368 */
   ulong input_sz = 0;
@@ -429,10 +425,10 @@ execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t * prog ) {
     if( memcmp( signature, sig, 64UL ) == 0 ) {
       interp_res = fd_vm_interp_instrs_trace( &vm_ctx );
     } else {
-      interp_res = fd_vm_interp_instrs( &vm_ctx );
+      interp_res = fd_vm_jit_instrs( &vm_ctx, prog->text_hash );
     }
   #else
-    interp_res = fd_vm_interp_instrs( &vm_ctx );
+    interp_res = fd_vm_jit_instrs( &vm_ctx, prog->text_hash );
   #endif
 
   if( FD_UNLIKELY( interp_res!=0UL ) ) {
@@ -1591,7 +1587,8 @@ fd_bpf_loader_v3_program_execute( fd_exec_instr_ctx_t ctx ) {
     }
 
     fd_sbpf_validated_program_t * prog = NULL;
-    if( FD_UNLIKELY( fd_bpf_load_cache_entry( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) ) ) {
+    if( FD_UNLIKELY( fd_bpf_load_cache_entry( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) &&
+                     fd_bpf_load_program( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) ) ) {
       FD_LOG_WARNING(( "Program cache load for program failed" ));
       return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
     }
@@ -1651,6 +1648,17 @@ fd_bpf_loader_v3_program_execute( fd_exec_instr_ctx_t ctx ) {
       return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
     }
 
+    /* Cache entries are versioned by the deployment slot of the program
+       data they were built from.  An entry built from an older version
+       of the program (e.g. one upgraded on this fork since the entry was
+       created) must not be run. */
+    if( FD_UNLIKELY( prog->last_updated_slot!=program_data_slot ) ) {
+      if( FD_UNLIKELY( fd_bpf_load_program( ctx.slot_ctx, &ctx.instr->program_id_pubkey, &prog ) ) ) {
+        FD_LOG_WARNING(( "Program load for stale program cache entry failed" ));
+        return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
+      }
+    }
+
     return execute( &ctx, prog );
   } FD_SCRATCH_SCOPE_END;
 }
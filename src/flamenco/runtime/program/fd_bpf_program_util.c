@@ -2,6 +2,7 @@
 #include "fd_bpf_loader_v2_program.h"
 #include "fd_bpf_loader_v3_program.h"
 #include "../../vm/fd_vm_syscalls.h"
+#include "../../../ballet/sha256/fd_sha256.h"
 #include "../fd_acc_mgr.h"
 #include "../context/fd_exec_slot_ctx.h"
 
@@ -43,6 +44,38 @@ fd_sbpf_validated_program_rodata( fd_sbpf_validated_program_t * prog ) {
   return (uchar *)fd_type_pun(prog) + l;
 }
 
+/* The syscall table only depends on the feature-independent set of
+   syscalls registered by fd_vm_syscall_register_all, so a single table
+   is built on first use and shared read-only by every program load and
+   invocation. */
+
+static fd_sbpf_syscalls_t fd_bpf_syscalls_mem[ 1UL<<12 ];
+static fd_sbpf_syscalls_t * fd_bpf_syscalls_shared;
+static volatile int         fd_bpf_syscalls_state; /* 0 uninit, 1 initializing, 2 ready */
+
+fd_sbpf_syscalls_t *
+fd_bpf_syscalls( void ) {
+  if( FD_LIKELY( fd_bpf_syscalls_state==2 ) ) {
+    FD_COMPILER_MFENCE();
+    return fd_bpf_syscalls_shared;
+  }
+
+  if( !FD_ATOMIC_CAS( &fd_bpf_syscalls_state, 0, 1 ) ) {
+    FD_TEST( fd_sbpf_syscalls_footprint()<=sizeof(fd_bpf_syscalls_mem) );
+    fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( fd_bpf_syscalls_mem ) );
+    FD_TEST( syscalls );
+    fd_vm_syscall_register_all( syscalls );
+    fd_bpf_syscalls_shared = syscalls;
+    FD_COMPILER_MFENCE();
+    fd_bpf_syscalls_state = 2;
+    FD_COMPILER_MFENCE();
+  } else {
+    while( fd_bpf_syscalls_state!=2 ) FD_SPIN_PAUSE();
+    FD_COMPILER_MFENCE();
+  }
+  return fd_bpf_syscalls_shared;
+}
+
 int
 fd_bpf_get_executable_program_content_for_loader_v2( fd_exec_slot_ctx_t * slot_ctx,
                                                      fd_pubkey_t const * program_pubkey,
@@ -64,7 +97,8 @@ int
 fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_exec_slot_ctx_t * slot_ctx,
                                                               fd_pubkey_t const * program_pubkey,
                                                               uchar const ** program_data,
-                                                              ulong * program_data_len ) {
+                                                              ulong * program_data_len,
+                                                              ulong * programdata_slot ) {
   FD_SCRATCH_SCOPE_BEGIN {
     FD_BORROWED_ACCOUNT_DECL( program_rec );
     int read_result = fd_acc_mgr_view( slot_ctx->acc_mgr, slot_ctx->funk_txn, program_pubkey, program_rec );
@@ -103,8 +137,21 @@ fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_exec_slot_ctx_t
       return -1;
     }
 
+    fd_bpf_upgradeable_loader_state_t programdata_state;
+    fd_bincode_decode_ctx_t programdata_ctx = {
+      .data    = programdata_rec->const_data,
+      .dataend = programdata_rec->const_data + PROGRAMDATA_METADATA_SIZE,
+      .valloc  = fd_scratch_virtual(),
+    };
+    if( fd_bpf_upgradeable_loader_state_decode( &programdata_state, &programdata_ctx ) ||
+        !fd_bpf_upgradeable_loader_state_is_program_data( &programdata_state ) ) {
+      FD_LOG_DEBUG(( "invalid programdata account state" ));
+      return -1;
+    }
+
     *program_data_len = programdata_rec->const_meta->dlen - PROGRAMDATA_METADATA_SIZE;
     *program_data = programdata_rec->const_data + PROGRAMDATA_METADATA_SIZE;
+    *programdata_slot = programdata_state.inner.program_data.slot;
 
     return 0;
   } FD_SCRATCH_SCOPE_END;
@@ -121,60 +168,47 @@ fd_acc_mgr_cache_key( fd_pubkey_t const * pubkey ) {
   return id;
 }
 
-int
-fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t * slot_ctx,
-                                       fd_pubkey_t const *  program_pubkey ) {
-  FD_SCRATCH_SCOPE_BEGIN {
-    fd_funk_t *       funk = slot_ctx->acc_mgr->funk;
-    fd_funk_txn_t *       funk_txn = slot_ctx->funk_txn;
-    fd_funk_rec_key_t id   = fd_acc_mgr_cache_key( program_pubkey );
-
-    uchar const * program_data = NULL;
-    ulong program_data_len = 0;
-    if( fd_bpf_loader_v3_is_executable( slot_ctx, program_pubkey ) == 0 ) {
-      if( fd_bpf_get_executable_program_content_for_upgradeable_loader( slot_ctx, program_pubkey, &program_data, &program_data_len ) != 0 ) {
-        return -1;
-      }
-    } else if( fd_bpf_loader_v2_is_executable( slot_ctx, program_pubkey ) == 0) {
-      if( fd_bpf_get_executable_program_content_for_loader_v2( slot_ctx, program_pubkey, &program_data, &program_data_len ) != 0 ) {
-        return -1;
-      }
-    } else {
-      return -1;
-    }
-
-    fd_sbpf_elf_info_t elf_info;
-    if( fd_sbpf_elf_peek( &elf_info, program_data, program_data_len, false ) == NULL ) {
-      FD_LOG_WARNING(( "fd_sbpf_elf_peek() failed: %s", fd_sbpf_strerror() ));
-      return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
-    }
+/* fd_bpf_get_executable_program_content returns the ELF of the program
+   at program_pubkey and the version of that ELF: the slot it was last
+   deployed or upgraded in for upgradeable programs and 0 for loader v2
+   programs, which cannot change. */
+
+static int
+fd_bpf_get_executable_program_content( fd_exec_slot_ctx_t * slot_ctx,
+                                       fd_pubkey_t const *  program_pubkey,
+                                       uchar const **       program_data,
+                                       ulong *              program_data_len,
+                                       ulong *              version ) {
+  *version = 0UL;
+  if( fd_bpf_loader_v3_is_executable( slot_ctx, program_pubkey ) == 0 ) {
+    return fd_bpf_get_executable_program_content_for_upgradeable_loader( slot_ctx, program_pubkey, program_data, program_data_len, version );
+  } else if( fd_bpf_loader_v2_is_executable( slot_ctx, program_pubkey ) == 0) {
+    return fd_bpf_get_executable_program_content_for_loader_v2( slot_ctx, program_pubkey, program_data, program_data_len );
+  }
+  return -1;
+}
 
-    int funk_err = FD_FUNK_SUCCESS;
-    fd_funk_rec_t * rec = fd_funk_rec_write_prepare( funk, funk_txn, &id, fd_sbpf_validated_program_footprint( &elf_info ), 1, NULL, &funk_err );
-    if( rec == NULL || funk_err != FD_FUNK_SUCCESS ) {
-      return -1;
-    }
+/* fd_bpf_validated_program_load loads the ELF at program_data into
+   validated_prog, which has the footprint required by elf_info. */
 
-    uchar * val = fd_funk_val( rec, fd_funk_wksp( funk ) );
-    fd_sbpf_validated_program_t * validated_prog = (fd_sbpf_validated_program_t *)val;
-    validated_prog->rodata_sz = elf_info.rodata_sz;
+static int
+fd_bpf_validated_program_load( fd_sbpf_validated_program_t * validated_prog,
+                               fd_sbpf_elf_info_t const *    elf_info,
+                               uchar const *                 program_data,
+                               ulong                         program_data_len,
+                               ulong                         version ) {
+  FD_SCRATCH_SCOPE_BEGIN {
+    validated_prog->rodata_sz = elf_info->rodata_sz;
     uchar * rodata = fd_sbpf_validated_program_rodata( validated_prog );
 
     ulong  prog_align     = fd_sbpf_program_align();
-    ulong  prog_footprint = fd_sbpf_program_footprint( &elf_info );
-    fd_sbpf_program_t * prog = fd_sbpf_program_new(  fd_scratch_alloc( prog_align, prog_footprint ), &elf_info, rodata );
+    ulong  prog_footprint = fd_sbpf_program_footprint( elf_info );
+    fd_sbpf_program_t * prog = fd_sbpf_program_new(  fd_scratch_alloc( prog_align, prog_footprint ), elf_info, rodata );
     FD_TEST( prog );
 
-    /* Allocate syscalls */
-
-    fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_new( fd_scratch_alloc( fd_sbpf_syscalls_align(), fd_sbpf_syscalls_footprint() ) );
-    FD_TEST( syscalls );
-
-    fd_vm_syscall_register_all( syscalls );
-
     /* Load program */
 
-    if( 0!=fd_sbpf_program_load( prog, program_data, program_data_len, syscalls, false ) ) {
+    if( 0!=fd_sbpf_program_load( prog, program_data, program_data_len, fd_bpf_syscalls(), false ) ) {
       FD_LOG_DEBUG(( "fd_sbpf_program_load() failed: %s", fd_sbpf_strerror() ));
       return -1;
     }
@@ -182,15 +216,77 @@ fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t * slot_ctx,
     fd_memcpy( validated_prog->calldests, prog->calldests, fd_sbpf_calldests_footprint(prog->rodata_sz/8UL) );
 
     validated_prog->entry_pc = prog->entry_pc;
-    validated_prog->last_updated_slot = slot_ctx->slot_bank.slot;
+    validated_prog->last_updated_slot = version;
     validated_prog->text_off = prog->text_off;
     validated_prog->text_cnt = prog->text_cnt;
     validated_prog->rodata_sz = prog->rodata_sz;
+    fd_sha256_hash( prog->text, prog->text_cnt*sizeof(fd_sbpf_instr_t), validated_prog->text_hash );
 
     return 0;
   } FD_SCRATCH_SCOPE_END;
 }
 
+int
+fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t * slot_ctx,
+                                       fd_pubkey_t const *  program_pubkey ) {
+  fd_funk_t *       funk = slot_ctx->acc_mgr->funk;
+  fd_funk_txn_t *       funk_txn = slot_ctx->funk_txn;
+  fd_funk_rec_key_t id   = fd_acc_mgr_cache_key( program_pubkey );
+
+  uchar const * program_data = NULL;
+  ulong program_data_len = 0;
+  ulong version = 0;
+  if( fd_bpf_get_executable_program_content( slot_ctx, program_pubkey, &program_data, &program_data_len, &version ) != 0 ) {
+    return -1;
+  }
+
+  fd_sbpf_elf_info_t elf_info;
+  if( fd_sbpf_elf_peek( &elf_info, program_data, program_data_len, false ) == NULL ) {
+    FD_LOG_WARNING(( "fd_sbpf_elf_peek() failed: %s", fd_sbpf_strerror() ));
+    return FD_EXECUTOR_INSTR_ERR_INVALID_ACC_DATA;
+  }
+
+  int funk_err = FD_FUNK_SUCCESS;
+  fd_funk_rec_t * rec = fd_funk_rec_write_prepare( funk, funk_txn, &id, fd_sbpf_validated_program_footprint( &elf_info ), 1, NULL, &funk_err );
+  if( rec == NULL || funk_err != FD_FUNK_SUCCESS ) {
+    return -1;
+  }
+
+  fd_sbpf_validated_program_t * validated_prog = (fd_sbpf_validated_program_t *)fd_funk_val( rec, fd_funk_wksp( funk ) );
+  if( fd_bpf_validated_program_load( validated_prog, &elf_info, program_data, program_data_len, version ) != 0 ) {
+    /* Don't leave a half built entry behind */
+    fd_funk_rec_remove( funk, rec, 1 );
+    return -1;
+  }
+
+  return 0;
+}
+
+int
+fd_bpf_load_program( fd_exec_slot_ctx_t *           slot_ctx,
+                     fd_pubkey_t const *            program_pubkey,
+                     fd_sbpf_validated_program_t ** valid_prog ) {
+  uchar const * program_data = NULL;
+  ulong program_data_len = 0;
+  ulong version = 0;
+  if( fd_bpf_get_executable_program_content( slot_ctx, program_pubkey, &program_data, &program_data_len, &version ) != 0 ) {
+    return -1;
+  }
+
+  fd_sbpf_elf_info_t elf_info;
+  if( fd_sbpf_elf_peek( &elf_info, program_data, program_data_len, false ) == NULL ) {
+    return -1;
+  }
+
+  fd_sbpf_validated_program_t * validated_prog = fd_scratch_alloc( fd_sbpf_validated_program_align(), fd_sbpf_validated_program_footprint( &elf_info ) );
+  if( fd_bpf_validated_program_load( validated_prog, &elf_info, program_data, program_data_len, version ) != 0 ) {
+    return -1;
+  }
+
+  *valid_prog = validated_prog;
+  return 0;
+}
+
 static void FD_FN_UNUSED
 fd_bpf_scan_task( void * tpool,
                   ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
@@ -8,12 +8,14 @@
 struct fd_sbpf_validated_program {
   ulong magic;
 
-  ulong last_updated_slot;
+  ulong last_updated_slot; /* Deployment slot of the programdata the entry was built from, 0 for loader v2 */
   ulong entry_pc;
   ulong text_cnt;
   ulong text_off;
   ulong rodata_sz;
 
+  uchar text_hash[ 32 ]; /* SHA-256 of the loaded text, keys the JIT cache */
+
   fd_sbpf_calldests_t calldests[];
 
   // uchar rodata[];
@@ -59,6 +61,24 @@ fd_bpf_load_cache_entry( fd_exec_slot_ctx_t * slot_ctx,
                          fd_pubkey_t const * program_pubkey,
                          fd_sbpf_validated_program_t ** valid_prog );
 
+/* fd_bpf_load_program loads the program at program_pubkey as visible
+   from slot_ctx into scratch memory, bypassing the program cache.  Used
+   when the cache entry is missing or stale, e.g. the program was
+   upgraded earlier in the current block.  Requires a scratch frame.
+   Returns 0 on success and -1 on failure. */
+
+int
+fd_bpf_load_program( fd_exec_slot_ctx_t *           slot_ctx,
+                     fd_pubkey_t const *            program_pubkey,
+                     fd_sbpf_validated_program_t ** valid_prog );
+
+/* fd_bpf_syscalls returns the process wide syscall table used to load
+   and run programs.  The table is built on first call and must not be
+   modified.  Thread safe. */
+
+fd_sbpf_syscalls_t *
+fd_bpf_syscalls( void );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_runtime_program_fd_bpf_program_util_h */
@@ -0,0 +1,195 @@
+#include "fd_blockstore.h"
+
+#define TEST_SLOT_CNT (16UL)
+
+/* Each block is a single microblock whose hash is filled with a byte
+   derived from (slot, gen).  A writer changing gen must never be seen
+   half done by a volatile reader. */
+
+static uchar
+test_hash_byte( ulong slot, ulong gen ) {
+  return (uchar)( slot*31UL + gen );
+}
+
+/* test_block_insert adds a complete block for slot with parent to the
+   blockstore, without going through shred insertion, and returns its
+   microblock header. */
+
+static fd_microblock_hdr_t *
+test_block_insert( fd_blockstore_t * blockstore, ulong slot, ulong parent ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+
+  fd_block_t *       block  = fd_wksp_alloc_laddr( wksp, alignof(fd_block_t),          sizeof(fd_block_t),          1UL );
+  uchar *            data   = fd_wksp_alloc_laddr( wksp, alignof(fd_microblock_hdr_t), sizeof(fd_microblock_hdr_t), 1UL );
+  fd_block_micro_t * micros = fd_wksp_alloc_laddr( wksp, alignof(fd_block_micro_t),    sizeof(fd_block_micro_t),    1UL );
+  FD_TEST( block && data && micros );
+
+  fd_microblock_hdr_t * hdr = (fd_microblock_hdr_t *)data;
+  fd_memset( hdr, 0, sizeof(fd_microblock_hdr_t) );
+  fd_memset( hdr->hash, test_hash_byte( slot, 0UL ), 32UL );
+  micros[0].off = 0UL;
+
+  fd_memset( block, 0, sizeof(fd_block_t) );
+  block->data_gaddr   = fd_wksp_gaddr_fast( wksp, data   );
+  block->data_sz      = sizeof(fd_microblock_hdr_t);
+  block->micros_gaddr = fd_wksp_gaddr_fast( wksp, micros );
+  block->micros_cnt   = 1UL;
+
+  fd_blockstore_start_write( blockstore );
+  fd_blockstore_slot_map_t * slot_entry = fd_blockstore_slot_map_insert( fd_blockstore_slot_map( blockstore ), &slot );
+  FD_TEST( slot_entry );
+  fd_memset( &slot_entry->slot_meta, 0, sizeof(fd_slot_meta_t) );
+  slot_entry->slot_meta.slot        = slot;
+  slot_entry->slot_meta.parent_slot = parent;
+  slot_entry->block_gaddr           = fd_wksp_gaddr_fast( wksp, block );
+  fd_blockstore_end_write( blockstore );
+  return hdr;
+}
+
+/* test_hash_check checks that hash is a complete hash of slot, from
+   any gen, and returns the gen. */
+
+static ulong
+test_hash_check( fd_hash_t const * hash, ulong slot ) {
+  ulong gen = (ulong)(uchar)( hash->uc[0] - test_hash_byte( slot, 0UL ) );
+  for( ulong i=0UL; i<32UL; i++ ) FD_TEST( hash->uc[i]==test_hash_byte( slot, gen ) );
+  return gen;
+}
+
+static fd_blockstore_t *       test_blockstore;
+static fd_microblock_hdr_t *   test_hdr[ TEST_SLOT_CNT ];
+static volatile int            test_halt;
+
+/* test_writer rewrites the block hashes byte by byte, and takes blocks
+   in and out of the slot map, under the write lock until halted. */
+
+static int
+test_writer( int argc, char ** argv ) {
+  (void)argc; (void)argv;
+  fd_blockstore_t * blockstore = test_blockstore;
+  ulong gen = 0UL;
+  while( !test_halt ) {
+    gen++;
+    ulong slot = 1UL + gen%(TEST_SLOT_CNT-1UL);
+
+    fd_blockstore_start_write( blockstore );
+    for( ulong i=0UL; i<32UL; i++ ) FD_VOLATILE( test_hdr[ slot ]->hash[i] ) = test_hash_byte( slot, gen );
+    fd_blockstore_slot_map_t * slot_entry = fd_blockstore_slot_map_query( fd_blockstore_slot_map( blockstore ), &slot, NULL );
+    ulong block_gaddr = slot_entry->block_gaddr;
+    if( gen&1UL ) {
+      /* Remove and reinsert the entry */
+      fd_blockstore_slot_map_remove( fd_blockstore_slot_map( blockstore ), &slot );
+      fd_blockstore_end_write( blockstore );
+      fd_blockstore_start_write( blockstore );
+      slot_entry = fd_blockstore_slot_map_insert( fd_blockstore_slot_map( blockstore ), &slot );
+      FD_TEST( slot_entry );
+      fd_memset( &slot_entry->slot_meta, 0, sizeof(fd_slot_meta_t) );
+      slot_entry->slot_meta.slot        = slot;
+      slot_entry->slot_meta.parent_slot = slot-1UL;
+      slot_entry->block_gaddr           = block_gaddr;
+    }
+    fd_blockstore_end_write( blockstore );
+  }
+  return 0;
+}
+
+int
+main( int argc, char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 32768UL  );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 ) );
+  ulong        iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 1000000UL );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * blockstore_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint(), 1UL );
+  FD_TEST( blockstore_mem );
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new( blockstore_mem, 1UL, 42UL, 1024UL, 64UL, 10 ) );
+  FD_TEST( blockstore );
+
+  for( ulong slot=1UL; slot<TEST_SLOT_CNT; slot++ ) test_hdr[ slot ] = test_block_insert( blockstore, slot, slot-1UL );
+
+  /* A slot with a slot meta but no block yet */
+
+  ulong incomplete_slot = TEST_SLOT_CNT;
+  fd_blockstore_start_write( blockstore );
+  fd_blockstore_slot_map_t * slot_entry = fd_blockstore_slot_map_insert( fd_blockstore_slot_map( blockstore ), &incomplete_slot );
+  FD_TEST( slot_entry );
+  fd_memset( &slot_entry->slot_meta, 0, sizeof(fd_slot_meta_t) );
+  slot_entry->slot_meta.slot        = incomplete_slot;
+  slot_entry->slot_meta.parent_slot = incomplete_slot-1UL;
+  slot_entry->block_gaddr           = 0UL;
+  fd_blockstore_end_write( blockstore );
+
+  /* The volatile readers agree with the locked ones */
+
+  for( ulong slot=1UL; slot<TEST_SLOT_CNT; slot++ ) {
+    fd_hash_t hash[1];
+    FD_TEST( fd_blockstore_block_hash_query_volatile( blockstore, slot, hash )==FD_BLOCKSTORE_OK );
+    FD_TEST( test_hash_check( hash, slot )==0UL );
+    fd_blockstore_start_read( blockstore );
+    FD_TEST( !memcmp( fd_blockstore_block_hash_query( blockstore, slot ), hash, sizeof(fd_hash_t) ) );
+    FD_TEST( fd_blockstore_parent_slot_query( blockstore, slot )==slot-1UL );
+    fd_blockstore_end_read( blockstore );
+    FD_TEST( fd_blockstore_parent_slot_query_volatile( blockstore, slot )==slot-1UL );
+
+    fd_block_t     blk[1];
+    fd_slot_meta_t slot_meta[1];
+    FD_TEST( fd_blockstore_slot_meta_query_volatile( blockstore, slot, blk, slot_meta )==FD_BLOCKSTORE_OK );
+    FD_TEST( slot_meta->slot==slot && slot_meta->parent_slot==slot-1UL && blk->micros_cnt==1UL );
+  }
+
+  fd_hash_t      hash[1];
+  fd_block_t     blk[1];
+  fd_slot_meta_t slot_meta[1];
+  FD_TEST( fd_blockstore_block_hash_query_volatile( blockstore, incomplete_slot, hash )==FD_BLOCKSTORE_ERR_SLOT_MISSING );
+  FD_TEST( fd_blockstore_parent_slot_query_volatile( blockstore, incomplete_slot )==incomplete_slot-1UL );
+  FD_TEST( fd_blockstore_slot_meta_query_volatile( blockstore, incomplete_slot, blk, slot_meta )==FD_BLOCKSTORE_ERR_SLOT_MISSING );
+  FD_TEST( fd_blockstore_slot_meta_query_volatile( blockstore, incomplete_slot, NULL, slot_meta )==FD_BLOCKSTORE_OK );
+  FD_TEST( slot_meta->parent_slot==incomplete_slot-1UL );
+
+  ulong missing_slot = TEST_SLOT_CNT+1UL;
+  FD_TEST( fd_blockstore_block_hash_query_volatile( blockstore, missing_slot, hash )==FD_BLOCKSTORE_ERR_SLOT_MISSING );
+  FD_TEST( fd_blockstore_parent_slot_query_volatile( blockstore, missing_slot )==FD_SLOT_NULL );
+  FD_TEST( fd_blockstore_slot_meta_query_volatile( blockstore, missing_slot, NULL, slot_meta )==FD_BLOCKSTORE_ERR_SLOT_MISSING );
+
+  /* Read while another tile rewrites hashes and moves slot map entries.
+     Every hash read must be complete, and a slot is at worst briefly
+     missing. */
+
+  if( FD_UNLIKELY( fd_tile_cnt()<2UL ) ) {
+    FD_LOG_WARNING(( "skip: concurrent test needs at least 2 tiles" ));
+  } else {
+    test_blockstore = blockstore;
+    test_halt       = 0;
+    fd_tile_exec_t * writer = fd_tile_exec_new( 1UL, test_writer, 0, NULL );
+    FD_TEST( writer );
+
+    ulong found_cnt = 0UL;
+    ulong new_cnt   = 0UL;
+    for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+      ulong slot = 1UL + iter%(TEST_SLOT_CNT-1UL);
+      if( fd_blockstore_block_hash_query_volatile( blockstore, slot, hash )==FD_BLOCKSTORE_OK ) {
+        found_cnt++;
+        new_cnt += !!test_hash_check( hash, slot );
+      }
+      ulong parent_slot = fd_blockstore_parent_slot_query_volatile( blockstore, slot );
+      FD_TEST( parent_slot==slot-1UL || parent_slot==FD_SLOT_NULL );
+    }
+
+    test_halt = 1;
+    FD_TEST( !fd_tile_exec_delete( writer, NULL ) );
+    FD_LOG_NOTICE(( "%lu of %lu hash reads found the slot, %lu of those saw a rewritten hash", found_cnt, iter_cnt, new_cnt ));
+    FD_TEST( found_cnt );
+  }
+
+  fd_wksp_free_laddr( fd_blockstore_delete( fd_blockstore_leave( blockstore ) ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
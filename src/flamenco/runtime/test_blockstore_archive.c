@@ -0,0 +1,278 @@
+#include "fd_blockstore_archive.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEST_TXN_CNT    (4UL)
+#define TEST_TXN_SZ     (128UL)
+#define TEST_SHRED_CNT  (2UL)
+#define TEST_MERKLE_SZ  (32UL)
+#define TEST_DATA_SZ    (TEST_TXN_CNT*TEST_TXN_SZ)
+
+/* Each txn of each block is filled with a byte pattern derived from
+   (slot, txn_idx), its signature starting at byte 1 like a real txn. */
+
+static uchar
+test_txn_byte( ulong slot, ulong txn_idx, ulong off ) {
+  return (uchar)( slot*131UL + txn_idx*17UL + off );
+}
+
+static void
+test_txn_sig( ulong slot, ulong txn_idx, uchar sig[ static FD_ED25519_SIG_SZ ] ) {
+  for( ulong i=0UL; i<FD_ED25519_SIG_SZ; i++ ) sig[i] = test_txn_byte( slot, txn_idx, 1UL+i );
+}
+
+/* test_block_insert adds a complete block for slot with parent to the
+   blockstore, without going through shred insertion. */
+
+static void
+test_block_insert( fd_blockstore_t * blockstore, ulong slot, ulong parent ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+
+  fd_block_t *         block  = fd_wksp_alloc_laddr( wksp, alignof(fd_block_t),         sizeof(fd_block_t),                        1UL );
+  uchar *              data   = fd_wksp_alloc_laddr( wksp, 128UL,                       TEST_DATA_SZ,                              1UL );
+  fd_block_txn_ref_t * txns   = fd_wksp_alloc_laddr( wksp, alignof(fd_block_txn_ref_t), TEST_TXN_CNT*sizeof(fd_block_txn_ref_t),   1UL );
+  fd_block_shred_t *   shreds = fd_wksp_alloc_laddr( wksp, alignof(fd_block_shred_t),   TEST_SHRED_CNT*sizeof(fd_block_shred_t),   1UL );
+  fd_block_micro_t *   micros = fd_wksp_alloc_laddr( wksp, alignof(fd_block_micro_t),   sizeof(fd_block_micro_t),                  1UL );
+  FD_TEST( block && data && txns && shreds && micros );
+
+  for( ulong j=0UL; j<TEST_TXN_CNT; j++ ) {
+    for( ulong i=0UL; i<TEST_TXN_SZ; i++ ) data[ j*TEST_TXN_SZ+i ] = test_txn_byte( slot, j, i );
+    txns[j].txn_off = j*TEST_TXN_SZ;
+    txns[j].id_off  = j*TEST_TXN_SZ + 1UL;
+    txns[j].sz      = TEST_TXN_SZ;
+  }
+
+  fd_memset( shreds, 0, TEST_SHRED_CNT*sizeof(fd_block_shred_t) );
+  for( ulong i=0UL; i<TEST_SHRED_CNT; i++ ) {
+    shreds[i].hdr.variant   = FD_SHRED_TYPE_MERKLE_DATA;
+    shreds[i].hdr.slot      = slot;
+    shreds[i].hdr.idx       = (uint)i;
+    shreds[i].hdr.data.size = (ushort)( FD_SHRED_DATA_HEADER_SZ + TEST_DATA_SZ/TEST_SHRED_CNT );
+    fd_memset( shreds[i].merkle, (int)( slot+i ), TEST_MERKLE_SZ );
+    shreds[i].merkle_sz     = TEST_MERKLE_SZ;
+    shreds[i].off           = i*( TEST_DATA_SZ/TEST_SHRED_CNT );
+  }
+  micros[0].off = 0UL;
+
+  fd_memset( block, 0, sizeof(fd_block_t) );
+  block->ts           = (long)slot*1000L;
+  block->height       = slot;
+  block->bank_hash.ul[0] = slot;
+  block->data_gaddr   = fd_wksp_gaddr_fast( wksp, data   );
+  block->data_sz      = TEST_DATA_SZ;
+  block->shreds_gaddr = fd_wksp_gaddr_fast( wksp, shreds );
+  block->shreds_cnt   = TEST_SHRED_CNT;
+  block->micros_gaddr = fd_wksp_gaddr_fast( wksp, micros );
+  block->micros_cnt   = 1UL;
+  block->txns_gaddr   = fd_wksp_gaddr_fast( wksp, txns   );
+  block->txns_cnt     = TEST_TXN_CNT;
+
+  fd_blockstore_start_write( blockstore );
+  fd_blockstore_slot_map_t * slot_entry = fd_blockstore_slot_map_insert( fd_blockstore_slot_map( blockstore ), &slot );
+  FD_TEST( slot_entry );
+  fd_memset( &slot_entry->slot_meta, 0, sizeof(fd_slot_meta_t) );
+  slot_entry->slot_meta.slot        = slot;
+  slot_entry->slot_meta.parent_slot = parent;
+  slot_entry->block_gaddr           = fd_wksp_gaddr_fast( wksp, block );
+  fd_blockstore_end_write( blockstore );
+}
+
+static ulong
+test_file_sz( char const * path ) {
+  struct stat st;
+  FD_TEST( !stat( path, &st ) );
+  return (ulong)st.st_size;
+}
+
+/* test_slot_check verifies everything archived for slot can be read
+   back. */
+
+static void
+test_slot_check( fd_blockstore_archive_t * archive, ulong slot ) {
+  fd_blockstore_archive_rec_t const * rec = fd_blockstore_archive_rec_query( archive, slot );
+  FD_TEST( rec );
+  FD_TEST( rec->slot==slot && rec->parent_slot==slot-1UL );
+  FD_TEST( rec->ts==(long)slot*1000L && rec->height==slot && rec->bank_hash.ul[0]==slot );
+  FD_TEST( rec->txns_cnt==TEST_TXN_CNT && rec->micros_cnt==1UL && rec->data_sz==TEST_DATA_SZ );
+  FD_TEST( fd_blockstore_archive_parent_slot_query( archive, slot )==slot-1UL );
+
+  uchar buf[ FD_SHRED_MAX_SZ ];
+  for( uint i=0U; i<TEST_SHRED_CNT; i++ ) {
+    long sz = fd_blockstore_archive_shred_query_copy_data( archive, slot, i, buf, sizeof(buf) );
+    ulong payload_sz = TEST_DATA_SZ/TEST_SHRED_CNT;
+    FD_TEST( sz==(long)fd_ulong_max( FD_SHRED_DATA_HEADER_SZ + payload_sz + TEST_MERKLE_SZ, FD_SHRED_MIN_SZ ) );
+    fd_shred_t const * shred = (fd_shred_t const *)buf;
+    FD_TEST( shred->slot==slot && shred->idx==i );
+    for( ulong k=0UL; k<payload_sz; k++ ) {
+      ulong off = i*payload_sz + k;
+      FD_TEST( buf[ FD_SHRED_DATA_HEADER_SZ+k ]==test_txn_byte( slot, off/TEST_TXN_SZ, off%TEST_TXN_SZ ) );
+    }
+    FD_TEST( buf[ FD_SHRED_DATA_HEADER_SZ+payload_sz ]==(uchar)( slot+i ) );
+  }
+  FD_TEST( fd_blockstore_archive_shred_query_copy_data( archive, slot, UINT_MAX, buf, sizeof(buf) )>0L );
+  FD_TEST( fd_blockstore_archive_shred_query_copy_data( archive, slot, (uint)TEST_SHRED_CNT, buf, sizeof(buf) )==-1L );
+
+  for( ulong j=0UL; j<TEST_TXN_CNT; j++ ) {
+    uchar sig[ FD_ED25519_SIG_SZ ]; test_txn_sig( slot, j, sig );
+    fd_blockstore_txn_map_t txn[1];
+    long                    ts;
+    uchar                   txn_data[ FD_TXN_MTU ];
+    FD_TEST( fd_blockstore_archive_txn_query( archive, sig, txn, &ts, txn_data )==FD_BLOCKSTORE_OK );
+    FD_TEST( txn->slot==slot && txn->offset==j*TEST_TXN_SZ && txn->sz==TEST_TXN_SZ && !txn->meta_gaddr );
+    FD_TEST( ts==(long)slot*1000L );
+    for( ulong i=0UL; i<TEST_TXN_SZ; i++ ) FD_TEST( txn_data[i]==test_txn_byte( slot, j, i ) );
+  }
+}
+
+static void
+test_slot_missing( fd_blockstore_archive_t * archive, ulong slot ) {
+  uchar buf[ FD_SHRED_MAX_SZ ];
+  uchar sig[ FD_ED25519_SIG_SZ ]; test_txn_sig( slot, 0UL, sig );
+  fd_blockstore_txn_map_t txn[1];
+  FD_TEST( !fd_blockstore_archive_rec_query( archive, slot ) );
+  FD_TEST( fd_blockstore_archive_parent_slot_query( archive, slot )==FD_SLOT_NULL );
+  FD_TEST( fd_blockstore_archive_shred_query_copy_data( archive, slot, 0U, buf, sizeof(buf) )==-1L );
+  FD_TEST( fd_blockstore_archive_txn_query( archive, sig, txn, NULL, NULL )==FD_BLOCKSTORE_ERR_TXN_MISSING );
+}
+
+int
+main( int argc, char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 32768UL  );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 ) );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * blockstore_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint(), 1UL );
+  FD_TEST( blockstore_mem );
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new( blockstore_mem, 1UL, 42UL, 1024UL, 64UL, 10 ) );
+  FD_TEST( blockstore );
+
+  char path[ 64 ];
+  FD_TEST( fd_cstr_printf_check( path, sizeof(path), NULL, "/tmp/test_blockstore_archive.%ld", (long)getpid() ) );
+  unlink( path );
+  ulong const file_max = 1UL<<24;
+
+  for( ulong slot=1UL; slot<=12UL; slot++ ) test_block_insert( blockstore, slot, slot-1UL );
+
+  /* Write */
+
+  ulong const slot_max   = 16UL;
+  int   const lg_txn_max = 6;
+  void * archive_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_archive_align(), fd_blockstore_archive_footprint( slot_max, lg_txn_max ), 1UL );
+  FD_TEST( archive_mem );
+  fd_blockstore_archive_t * archive = fd_blockstore_archive_join( fd_blockstore_archive_new( archive_mem, 7UL, slot_max, lg_txn_max ) );
+  FD_TEST( archive );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 1 )==FD_BLOCKSTORE_OK );
+  FD_TEST( fd_blockstore_archive_sync( archive, blockstore, 8UL )==8UL );
+  FD_TEST( fd_blockstore_archive_sync( archive, blockstore, 8UL )==0UL ); /* already archived */
+  FD_TEST( archive->rec_cnt==8UL );
+  for( ulong slot=1UL; slot<=8UL; slot++ ) test_slot_check( archive, slot );
+  test_slot_missing( archive, 9UL );
+  FD_TEST( fd_blockstore_archive_block( archive, blockstore, 100UL )==FD_BLOCKSTORE_ERR_SLOT_MISSING );
+
+  /* txn queries on the blockstore fall back to the archive once
+     attached */
+
+  uchar sig[ FD_ED25519_SIG_SZ ]; test_txn_sig( 3UL, 2UL, sig );
+  fd_blockstore_txn_map_t txn[1];
+  uchar                   txn_data[ FD_TXN_MTU ];
+  long                    ts = 0L;
+  FD_TEST( fd_blockstore_txn_query_volatile( blockstore, sig, txn, &ts, txn_data )==FD_BLOCKSTORE_ERR_TXN_MISSING );
+  fd_blockstore_archive_attach( archive, blockstore );
+  FD_TEST( fd_blockstore_txn_query_volatile( blockstore, sig, txn, &ts, txn_data )==FD_BLOCKSTORE_OK );
+  FD_TEST( txn->slot==3UL && txn->sz==TEST_TXN_SZ && ts==3000L );
+  FD_TEST( txn_data[0]==test_txn_byte( 3UL, 2UL, 0UL ) );
+  FD_TEST( fd_blockstore_txn_query_volatile( blockstore, sig, txn, NULL, NULL )==FD_BLOCKSTORE_OK );
+  fd_blockstore_archive_detach( blockstore );
+  FD_TEST( fd_blockstore_txn_query_volatile( blockstore, sig, txn, &ts, txn_data )==FD_BLOCKSTORE_ERR_TXN_MISSING );
+
+  /* Reopen read-only and writable, nothing is lost */
+
+  ulong file_sz = test_file_sz( path );
+  fd_blockstore_archive_close( archive );
+  test_slot_missing( archive, 1UL );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 0 )==FD_BLOCKSTORE_OK );
+  for( ulong slot=1UL; slot<=8UL; slot++ ) test_slot_check( archive, slot );
+  FD_TEST( fd_blockstore_archive_block( archive, blockstore, 9UL )==FD_BLOCKSTORE_ERR_UNKNOWN ); /* read-only */
+  fd_blockstore_archive_close( archive );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 1 )==FD_BLOCKSTORE_OK );
+  FD_TEST( test_file_sz( path )==file_sz );
+  FD_TEST( archive->rec_cnt==8UL );
+  for( ulong slot=1UL; slot<=8UL; slot++ ) test_slot_check( archive, slot );
+  fd_blockstore_archive_close( archive );
+
+  /* A torn record at the end is truncated on a writable open */
+
+  int fd = open( path, O_WRONLY | O_APPEND );
+  FD_TEST( fd>=0 );
+  uchar torn[ 2UL*FD_BLOCKSTORE_ARCHIVE_REC_ALIGN ];
+  fd_memset( torn, 0xa5, sizeof(torn) );
+  FD_TEST( write( fd, torn, sizeof(torn) )==(long)sizeof(torn) );
+  FD_TEST( !close( fd ) );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 0 )==FD_BLOCKSTORE_OK );
+  FD_TEST( archive->rec_cnt==8UL );
+  fd_blockstore_archive_close( archive );
+  FD_TEST( test_file_sz( path )==file_sz + sizeof(torn) );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 1 )==FD_BLOCKSTORE_OK );
+  FD_TEST( test_file_sz( path )==file_sz );
+  fd_blockstore_archive_close( archive );
+
+  fd_wksp_free_laddr( fd_blockstore_archive_delete( fd_blockstore_archive_leave( archive ) ) );
+
+  /* Indices smaller than the file keep the most recent records and never
+     stop archiving or truncate the file */
+
+  ulong const small_slot_max   = 4UL;
+  int   const small_lg_txn_max = 3; /* two blocks worth of txns */
+  archive_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_archive_align(), fd_blockstore_archive_footprint( small_slot_max, small_lg_txn_max ), 1UL );
+  FD_TEST( archive_mem );
+  archive = fd_blockstore_archive_join( fd_blockstore_archive_new( archive_mem, 7UL, small_slot_max, small_lg_txn_max ) );
+  FD_TEST( archive );
+
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 1 )==FD_BLOCKSTORE_OK );
+  FD_TEST( test_file_sz( path )==file_sz );
+  FD_TEST( archive->rec_cnt==8UL );
+  FD_TEST( archive->slot_lo==7UL && archive->slot_hi==8UL );
+  for( ulong slot=1UL; slot<=6UL; slot++ ) test_slot_missing( archive, slot );
+  for( ulong slot=7UL; slot<=8UL; slot++ ) test_slot_check( archive, slot );
+
+  FD_TEST( fd_blockstore_archive_sync( archive, blockstore, 12UL )==4UL );
+  FD_TEST( archive->rec_cnt==12UL );
+  FD_TEST( archive->slot_lo==11UL && archive->slot_hi==12UL );
+  for( ulong slot=1UL; slot<=10UL; slot++ ) test_slot_missing( archive, slot );
+  for( ulong slot=11UL; slot<=12UL; slot++ ) test_slot_check( archive, slot );
+  FD_TEST( fd_blockstore_archive_txn_map_key_cnt( archive->txn_map )==2UL*TEST_TXN_CNT );
+  fd_blockstore_archive_close( archive );
+
+  /* Every record written by the small archive is still in the file */
+
+  fd_wksp_free_laddr( fd_blockstore_archive_delete( fd_blockstore_archive_leave( archive ) ) );
+  archive_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_archive_align(), fd_blockstore_archive_footprint( slot_max, lg_txn_max ), 1UL );
+  archive = fd_blockstore_archive_join( fd_blockstore_archive_new( archive_mem, 7UL, slot_max, lg_txn_max ) );
+  FD_TEST( archive );
+  FD_TEST( fd_blockstore_archive_open( archive, path, file_max, 0 )==FD_BLOCKSTORE_OK );
+  FD_TEST( archive->rec_cnt==12UL );
+  for( ulong slot=1UL; slot<=12UL; slot++ ) test_slot_check( archive, slot );
+  fd_blockstore_archive_close( archive );
+  fd_wksp_free_laddr( fd_blockstore_archive_delete( fd_blockstore_archive_leave( archive ) ) );
+
+  unlink( path );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,228 @@
+#include "fd_hashes.h"
+#include "fd_acc_mgr.h"
+#include "context/fd_exec_epoch_ctx.h"
+#include "context/fd_exec_slot_ctx.h"
+#include "../../ballet/lthash/fd_lthash.h"
+
+#define TEST_ACC_CNT   (512UL)  /* Accounts at genesis */
+#define TEST_ACC_MAX  (1024UL)  /* Accounts ever */
+#define TEST_SLOT_CNT   (24UL)
+#define TEST_DEPTH       (4UL)  /* Unpublished slots kept around */
+#define TEST_WRITE_MAX  (48UL)  /* Accounts written per call */
+
+static fd_pubkey_t
+test_acc_key( ulong i ) {
+  fd_pubkey_t key = {0};
+  key.uc[0] = (uchar)( i*131UL ); /* spread over the accounts hash buckets */
+  key.ul[1] = i+1UL;
+  key.ul[3] = 0x5eed5eed5eed5eedUL;
+  return key;
+}
+
+/* test_acc_write gives account i random contents in txn.  About one
+   write in eight kills the account. */
+
+static void
+test_acc_write( fd_acc_mgr_t *  acc_mgr,
+                fd_funk_txn_t * txn,
+                ulong           i,
+                fd_rng_t *      rng ) {
+  fd_pubkey_t key  = test_acc_key( i );
+  ulong       dlen = fd_rng_ulong_roll( rng, 200UL );
+  fd_account_meta_t * meta = fd_acc_mgr_modify_raw( acc_mgr, txn, &key, 1, dlen, NULL, NULL, NULL );
+  FD_TEST( meta );
+  meta->dlen            = dlen;
+  meta->info.lamports   = fd_rng_uint_roll( rng, 8U ) ? 1UL+fd_rng_ulong_roll( rng, 1000000UL ) : 0UL;
+  meta->info.rent_epoch = fd_rng_ulong( rng );
+  meta->info.owner[0]   = fd_rng_uchar( rng );
+  uchar * data = (uchar *)meta + meta->hlen;
+  for( ulong j=0UL; j<dlen; j++ ) data[ j ] = fd_rng_uchar( rng );
+}
+
+/* test_update hashes the bank of the current slot, serially or over
+   the tpool, and checks the maintained accounts lthash against a full
+   recompute. */
+
+static void
+test_update( fd_exec_slot_ctx_t * slot_ctx,
+             fd_tpool_t *         tpool,
+             ulong                max_workers ) {
+  fd_hash_t bank_hash;
+  if( tpool ) FD_TEST( !fd_update_hash_bank_tpool( slot_ctx, NULL, &bank_hash, 0UL, tpool, max_workers ) );
+  else        FD_TEST( !fd_update_hash_bank      ( slot_ctx, NULL, &bank_hash, 0UL                     ) );
+  fd_accounts_check_lthash( slot_ctx );
+}
+
+/* test_accounts_hash checks that the parallel accounts hash of the root
+   matches the serial one. */
+
+static void
+test_accounts_hash( fd_exec_slot_ctx_t * slot_ctx,
+                    fd_tpool_t *         tpool,
+                    ulong                max_workers ) {
+  fd_hash_t expected; fd_hash_t actual;
+  FD_TEST( !fd_accounts_hash( slot_ctx, &expected, NULL, 0UL, 0 ) );
+  FD_TEST( !fd_accounts_hash_tpool( slot_ctx, &actual, tpool, max_workers ) );
+  FD_TEST( !memcmp( expected.hash, actual.hash, sizeof(fd_hash_t) ) );
+}
+
+static void
+test_replay( fd_exec_slot_ctx_t * slot_ctx,
+             fd_tpool_t *         tpool,
+             ulong                max_workers,
+             fd_rng_t *           rng ) {
+  fd_acc_mgr_t * acc_mgr = slot_ctx->acc_mgr;
+  fd_funk_t *    funk    = acc_mgr->funk;
+
+  /* Genesis modifies the root in place, the lthash is computed from
+     scratch */
+
+  slot_ctx->funk_txn       = NULL;
+  slot_ctx->slot_bank.slot = 0UL;
+  for( ulong i=0UL; i<TEST_ACC_CNT; i++ ) test_acc_write( acc_mgr, NULL, i, rng );
+  test_update( slot_ctx, NULL, 0UL );
+  test_accounts_hash( slot_ctx, tpool, max_workers );
+
+  fd_funk_txn_t * txns[ TEST_SLOT_CNT+1UL ] = {0};
+  ulong published = 0UL;
+  ulong acc_cnt   = TEST_ACC_CNT;
+  uchar touched[ TEST_ACC_MAX ];
+
+  for( ulong slot=1UL; slot<=TEST_SLOT_CNT; slot++ ) {
+    fd_funk_txn_xid_t xid = { .ul = { slot, 0x5eedUL } };
+    txns[ slot ] = fd_funk_txn_prepare( funk, txns[ slot-1UL ], &xid, 1 );
+    FD_TEST( txns[ slot ] );
+    slot_ctx->funk_txn       = txns[ slot ];
+    slot_ctx->slot_bank.slot = slot;
+    fd_tpool_t * slot_tpool  = (slot & 1UL) ? tpool : NULL;
+
+    /* Modify some accounts, create some */
+
+    fd_memset( touched, 0, sizeof(touched) );
+    ulong write_cnt = 1UL + fd_rng_ulong_roll( rng, TEST_WRITE_MAX );
+    for( ulong j=0UL; j<write_cnt; j++ ) {
+      ulong i = fd_rng_ulong_roll( rng, acc_cnt );
+      if( fd_rng_uint_roll( rng, 8U )==0U && acc_cnt<TEST_ACC_MAX ) i = acc_cnt++;
+      touched[ i ] = 1;
+      test_acc_write( acc_mgr, txns[ slot ], i, rng );
+    }
+    test_update( slot_ctx, slot_tpool, max_workers );
+
+    /* Hashing the bank again without changes doesn't move the lthash */
+
+    uchar lthash[ FD_LTHASH_LEN_BYTES ];
+    fd_memcpy( lthash, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES );
+    test_update( slot_ctx, slot_tpool, max_workers );
+    FD_TEST( !memcmp( lthash, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES ) );
+
+    /* Accounts modified after the bank was hashed are picked up by
+       hashing it again */
+
+    for( ulong j=0UL; j<4UL; j++ ) {
+      ulong i = fd_rng_ulong_roll( rng, acc_cnt );
+      if( touched[ i ] ) continue;
+      test_acc_write( acc_mgr, txns[ slot ], i, rng );
+    }
+    test_update( slot_ctx, slot_tpool, max_workers );
+
+    /* Root slots older than TEST_DEPTH.  Publishing doesn't change
+       what the current slot sees. */
+
+    if( slot>TEST_DEPTH ) {
+      published = slot-TEST_DEPTH;
+      FD_TEST( fd_funk_txn_publish( funk, txns[ published ], 1 ) );
+      fd_accounts_check_lthash( slot_ctx );
+      test_accounts_hash( slot_ctx, tpool, max_workers );
+    }
+  }
+  FD_TEST( published );
+
+  FD_TEST( fd_funk_txn_publish( funk, txns[ TEST_SLOT_CNT ], 1 ) );
+  slot_ctx->funk_txn = NULL;
+  fd_accounts_check_lthash( slot_ctx );
+  test_accounts_hash( slot_ctx, tpool, max_workers );
+
+  /* A full recompute of a maintained lthash gives the same value */
+
+  uchar lthash[ FD_LTHASH_LEN_BYTES ];
+  fd_memcpy( lthash, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES );
+  fd_memset( slot_ctx->slot_bank.lthash, 0, FD_LTHASH_LEN_BYTES );
+  FD_TEST( !fd_accounts_init_lthash_tpool( slot_ctx, tpool, max_workers ) );
+  FD_TEST( !memcmp( lthash, slot_ctx->slot_bank.lthash, FD_LTHASH_LEN_BYTES ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal"        );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 32768UL         );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s)", page_cnt, _page_sz ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_alloc_t * alloc = fd_alloc_join( fd_alloc_new( fd_wksp_alloc_laddr( wksp, fd_alloc_align(), fd_alloc_footprint(), 41UL ), 41UL ), 0UL );
+  FD_TEST( alloc );
+  fd_valloc_t valloc = fd_alloc_virtual( alloc );
+
+  static uchar smem[ 1UL<<20 ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+  ulong fmem[ 16 ];
+  fd_scratch_attach( smem, fmem, sizeof(smem), 16UL );
+
+  ulong tile_cnt = fd_tile_cnt();
+  fd_tpool_t * tpool = NULL;
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: parallel hashing tests require at least 2 tiles (use --tile-cpus)" ));
+  } else {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL ) );
+  }
+
+  /* Once with each account hash version */
+
+  for( int ignore_slot=0; ignore_slot<2; ignore_slot++ ) {
+    ulong const funk_tag = 42UL;
+    fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), funk_tag ), funk_tag, 1234UL, 2UL*TEST_SLOT_CNT, 4UL*TEST_ACC_MAX ) );
+    FD_TEST( funk );
+    fd_funk_start_write( funk );
+    fd_acc_mgr_t * acc_mgr = fd_acc_mgr_new( fd_wksp_alloc_laddr( wksp, FD_ACC_MGR_ALIGN, FD_ACC_MGR_FOOTPRINT, 1UL ), funk );
+    FD_TEST( acc_mgr );
+
+    fd_exec_epoch_ctx_t * epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new(
+        fd_wksp_alloc_laddr( wksp, fd_exec_epoch_ctx_align(), fd_exec_epoch_ctx_footprint( 16UL ), 1UL ), 16UL ) );
+    fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new(
+        fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, 1UL ), valloc ) );
+    FD_TEST( epoch_ctx && slot_ctx );
+    slot_ctx->epoch_ctx     = epoch_ctx;
+    slot_ctx->acc_mgr       = acc_mgr;
+    slot_ctx->enable_lthash = 1;
+
+    fd_features_disable_all( &epoch_ctx->features );
+    if( ignore_slot ) epoch_ctx->features.account_hash_ignore_slot = 0UL;
+    fd_exec_epoch_ctx_epoch_bank( epoch_ctx )->eah_start_slot = ULONG_MAX;
+
+    test_replay( slot_ctx, tpool, tile_cnt, rng );
+
+    fd_funk_end_write( funk );
+    fd_wksp_free_laddr( fd_funk_delete( fd_funk_leave( funk ) ) );
+    FD_LOG_NOTICE(( "pass (account_hash_ignore_slot %s)", ignore_slot ? "active" : "inactive" ));
+  }
+
+  if( tpool ) FD_TEST( fd_tpool_fini( tpool ) );
+  fd_scratch_detach( NULL );
+  fd_wksp_free_laddr( fd_alloc_delete( fd_alloc_leave( alloc ) ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
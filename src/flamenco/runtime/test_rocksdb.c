@@ -0,0 +1,214 @@
+#include "fd_rocksdb.h"
+#include <stdlib.h>
+
+/* test_rocksdb builds a small rocksdb holding one complete slot of
+   legacy data shreds with its block time, height and bank hash, and
+   checks that reading a block (fd_rocksdb_block_read) and inserting it
+   (fd_rocksdb_block_insert) produces the same blockstore block as
+   fd_rocksdb_import_block_blockstore. */
+
+#define TEST_SLOT       (42UL)
+#define TEST_BAD_SLOT   (43UL)
+#define TEST_SHRED_CNT  (3UL)
+#define TEST_MICRO_CNT  (2UL)
+#define TEST_BLOCK_TIME (1700000000L)
+#define TEST_HEIGHT     (77UL)
+
+/* The block: one entry batch holding TEST_MICRO_CNT microblocks without
+   transactions */
+
+static uchar test_payload[ sizeof(ulong) + TEST_MICRO_CNT*sizeof(fd_microblock_hdr_t) ];
+
+static void
+test_payload_init( void ) {
+  FD_STORE( ulong, test_payload, TEST_MICRO_CNT );
+  for( ulong j=0UL; j<TEST_MICRO_CNT; j++ ) {
+    fd_microblock_hdr_t hdr = { .hash_cnt = j+1UL, .txn_cnt = 0UL };
+    fd_memset( hdr.hash, (int)( 0x10UL+j ), sizeof(hdr.hash) );
+    fd_memcpy( test_payload + sizeof(ulong) + j*sizeof(fd_microblock_hdr_t), &hdr, sizeof(fd_microblock_hdr_t) );
+  }
+}
+
+static void
+test_shred_key( char key[ 16 ], ulong slot, ulong idx ) {
+  FD_STORE( ulong, key,   fd_ulong_bswap( slot ) );
+  FD_STORE( ulong, key+8, fd_ulong_bswap( idx  ) );
+}
+
+/* test_shred_put stores shred idx of slot holding payload bytes
+   [off,off+sz) */
+
+static void
+test_shred_put( fd_rocksdb_t * db,
+                ulong          slot,
+                ulong          idx,
+                ulong          off,
+                ulong          sz,
+                int            last ) {
+  uchar buf[ FD_SHRED_MIN_SZ ] = {0};
+  fd_shred_t * shred = (fd_shred_t *)buf;
+  shred->variant         = 0xa5; /* legacy data */
+  shred->slot            = slot;
+  shred->idx             = (uint)idx;
+  shred->fec_set_idx     = 0U;
+  shred->data.parent_off = 1;
+  shred->data.flags      = last ? (uchar)( FD_SHRED_DATA_FLAG_SLOT_COMPLETE|FD_SHRED_DATA_FLAG_DATA_COMPLETE ) : (uchar)0;
+  shred->data.size       = (ushort)( FD_SHRED_DATA_HEADER_SZ+sz );
+  fd_memcpy( buf+FD_SHRED_DATA_HEADER_SZ, test_payload+off, sz );
+  FD_TEST( fd_shred_parse( buf, shred->data.size )==shred );
+
+  char key[ 16 ];
+  test_shred_key( key, slot, idx );
+  FD_TEST( !fd_rocksdb_insert_entry( db, FD_ROCKSDB_CFIDX_DATA_SHRED, key, sizeof(key), (char const *)buf, shred->data.size ) );
+}
+
+static void
+test_db_create( char const * path, fd_hash_t const * bank_hash ) {
+  fd_rocksdb_t db[1];
+  fd_rocksdb_new( db, path );
+
+  ulong chunk = ( sizeof(test_payload)+TEST_SHRED_CNT-1UL )/TEST_SHRED_CNT;
+  for( ulong i=0UL; i<TEST_SHRED_CNT; i++ ) {
+    ulong off = i*chunk;
+    ulong sz  = fd_ulong_min( chunk, sizeof(test_payload)-off );
+    test_shred_put( db, TEST_SLOT, i, off, sz, i==TEST_SHRED_CNT-1UL );
+  }
+
+  ulong slot_be = fd_ulong_bswap( TEST_SLOT );
+  long  ts      = TEST_BLOCK_TIME;
+  ulong height  = TEST_HEIGHT;
+  FD_TEST( !fd_rocksdb_insert_entry( db, FD_ROCKSDB_CFIDX_BLOCKTIME,    (char const *)&slot_be, sizeof(ulong), (char const *)&ts,     sizeof(long)  ) );
+  FD_TEST( !fd_rocksdb_insert_entry( db, FD_ROCKSDB_CFIDX_BLOCK_HEIGHT, (char const *)&slot_be, sizeof(ulong), (char const *)&height, sizeof(ulong) ) );
+
+  fd_frozen_hash_versioned_t versioned = { .discriminant = fd_frozen_hash_versioned_enum_current };
+  versioned.inner.current.frozen_hash = *bank_hash;
+  uchar enc[ 64 ];
+  fd_bincode_encode_ctx_t encode = { .data = enc, .dataend = enc+sizeof(enc) };
+  FD_TEST( fd_frozen_hash_versioned_encode( &versioned, &encode )==FD_BINCODE_SUCCESS );
+  ulong enc_sz = (ulong)encode.data - (ulong)enc;
+  FD_TEST( !fd_rocksdb_insert_entry( db, FD_ROCKSDB_CFIDX_BANK_HASHES, (char const *)&slot_be, sizeof(ulong), (char const *)enc, enc_sz ) );
+
+  /* A slot with a malformed key between its first and second shred */
+
+  test_shred_put( db, TEST_BAD_SLOT, 0UL, 0UL, 16UL, 0 );
+  test_shred_put( db, TEST_BAD_SLOT, 1UL, 0UL, 16UL, 1 );
+  char bad_key[ 17 ] = {0};
+  test_shred_key( bad_key, TEST_BAD_SLOT, 0UL );
+  FD_TEST( !fd_rocksdb_insert_entry( db, FD_ROCKSDB_CFIDX_DATA_SHRED, bad_key, sizeof(bad_key), "x", 1UL ) );
+
+  fd_rocksdb_destroy( db );
+}
+
+static fd_blockstore_t *
+test_blockstore_new( fd_wksp_t * wksp, ulong seed ) {
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint(), 1UL );
+  FD_TEST( mem );
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new( mem, 1UL, seed, 1024UL, 64UL, 10 ) );
+  FD_TEST( blockstore );
+  return blockstore;
+}
+
+/* test_block_check checks that blockstore holds the test block with
+   the given bank hash */
+
+static void
+test_block_check( fd_blockstore_t * blockstore, fd_hash_t const * bank_hash ) {
+  fd_blockstore_start_read( blockstore );
+  fd_block_t * blk = fd_blockstore_block_query( blockstore, TEST_SLOT );
+  FD_TEST( blk );
+  FD_TEST( blk->data_sz==sizeof(test_payload) );
+  FD_TEST( !memcmp( fd_blockstore_block_data_laddr( blockstore, blk ), test_payload, sizeof(test_payload) ) );
+  FD_TEST( blk->micros_cnt==TEST_MICRO_CNT );
+  FD_TEST( blk->shreds_cnt==TEST_SHRED_CNT );
+  FD_TEST( blk->ts==TEST_BLOCK_TIME*(long)1e9 );
+  FD_TEST( blk->height==TEST_HEIGHT );
+  FD_TEST( !memcmp( blk->bank_hash.hash, bank_hash->hash, 32UL ) );
+  fd_blockstore_end_read( blockstore );
+}
+
+int
+main( int argc, char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 65536UL  );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 ) );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  char path[] = "/tmp/test_rocksdb.XXXXXX";
+  FD_TEST( mkdtemp( path ) );
+
+  fd_hash_t bank_hash[1];     fd_memset( bank_hash->hash,     0xab, 32UL );
+  fd_hash_t hash_override[1]; fd_memset( hash_override->hash, 0xfe, 32UL );
+
+  test_payload_init();
+  test_db_create( path, bank_hash );
+
+  fd_rocksdb_t db[1];
+  char * err = fd_rocksdb_init( db, path );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "fd_rocksdb_init failed: %s", err ));
+
+  fd_slot_meta_t m = { .slot = TEST_SLOT, .received = TEST_SHRED_CNT };
+
+  /* Reading does not need a blockstore */
+
+  fd_rocksdb_block_t block[1] = {0};
+  FD_TEST( !fd_rocksdb_block_read( db, &m, block, NULL ) );
+  FD_TEST( block->slot==TEST_SLOT );
+  FD_TEST( block->shred_cnt==TEST_SHRED_CNT );
+  FD_TEST( block->has_ts && block->ts==TEST_BLOCK_TIME*(long)1e9 );
+  FD_TEST( block->height==TEST_HEIGHT );
+  FD_TEST( block->has_bank_hash && !memcmp( block->bank_hash.hash, bank_hash->hash, 32UL ) );
+
+  /* Read then insert matches the combined import */
+
+  fd_blockstore_t * split_store    = test_blockstore_new( wksp, 42UL );
+  fd_blockstore_t * combined_store = test_blockstore_new( wksp, 43UL );
+
+  FD_TEST( !fd_rocksdb_block_insert( db, block, split_store, 0 ) );
+  FD_TEST( !fd_rocksdb_import_block_blockstore( db, &m, combined_store, 0, NULL ) );
+  test_block_check( split_store,    bank_hash );
+  test_block_check( combined_store, bank_hash );
+
+  /* The hash override replaces the bank hash from rocksdb */
+
+  fd_blockstore_t * override_store = test_blockstore_new( wksp, 44UL );
+  FD_TEST( !fd_rocksdb_block_read( db, &m, block, hash_override->hash ) );
+  FD_TEST( block->has_bank_hash && !memcmp( block->bank_hash.hash, hash_override->hash, 32UL ) );
+  FD_TEST( !fd_rocksdb_block_insert( db, block, override_store, 0 ) );
+  test_block_check( override_store, hash_override );
+
+  /* A malformed shred key ends the read without failing it, leaving
+     the shreds before it.  The block is reused from above. */
+
+  fd_slot_meta_t bad_m = { .slot = TEST_BAD_SLOT, .received = 2UL };
+  FD_TEST( !fd_rocksdb_block_read( db, &bad_m, block, NULL ) );
+  FD_TEST( block->slot==TEST_BAD_SLOT );
+  FD_TEST( block->shred_cnt==1UL );
+  FD_TEST( !block->has_ts && !block->height && !block->has_bank_hash );
+
+  /* Shreds missing from rocksdb fail the read */
+
+  fd_slot_meta_t missing_m = { .slot = TEST_SLOT, .received = TEST_SHRED_CNT+1UL };
+  FD_TEST( fd_rocksdb_block_read( db, &missing_m, block, NULL )==-1 );
+
+  fd_rocksdb_block_destroy( block );
+  fd_rocksdb_destroy( db );
+
+  rocksdb_options_t * opts = rocksdb_options_create();
+  err = NULL;
+  rocksdb_destroy_db( opts, path, &err );
+  if( FD_UNLIKELY( err ) ) { FD_LOG_WARNING(( "rocksdb_destroy_db failed: %s", err )); free( err ); }
+  rocksdb_options_destroy( opts );
+
+  fd_wksp_free_laddr( fd_blockstore_delete( fd_blockstore_leave( override_store ) ) );
+  fd_wksp_free_laddr( fd_blockstore_delete( fd_blockstore_leave( combined_store ) ) );
+  fd_wksp_free_laddr( fd_blockstore_delete( fd_blockstore_leave( split_store    ) ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
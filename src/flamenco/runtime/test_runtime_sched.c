@@ -0,0 +1,289 @@
+#include "fd_runtime.h"
+#include "../fd_flamenco.h"
+#include "fd_acc_mgr.h"
+#include "fd_system_ids.h"
+#include "context/fd_exec_epoch_ctx.h"
+#include "context/fd_exec_slot_ctx.h"
+#include "sysvar/fd_sysvar_cache.h"
+#include "sysvar/fd_sysvar_recent_hashes.h"
+#include "sysvar/fd_sysvar_rent.h"
+#include "../txn/fd_txn_generate.h"
+
+/* Executes a batch of system transfers with dependent fee payers
+   through fd_runtime_execute_txns_in_waves_tpool and checks that the
+   result matches executing the txns one at a time in block order. */
+
+#define TEST_ACC_CNT (6UL)
+
+static uchar const test_blockhash[ 32 ] = { 0xb1, 0x0c, 0x4a, 0x54 };
+
+static fd_pubkey_t
+test_acc_key( ulong i ) {
+  fd_pubkey_t key = {0};
+  key.uc[0] = (uchar)( i*131UL );
+  key.ul[1] = i+1UL;
+  key.ul[3] = 0x5eed5eed5eed5eedUL;
+  return key;
+}
+
+static void
+test_acc_fund( fd_acc_mgr_t * acc_mgr,
+               ulong          i,
+               ulong          lamports ) {
+  fd_pubkey_t key = test_acc_key( i );
+  fd_account_meta_t * meta = fd_acc_mgr_modify_raw( acc_mgr, NULL, &key, 1, 0UL, NULL, NULL, NULL );
+  FD_TEST( meta );
+  meta->dlen            = 0UL;
+  meta->info.lamports   = lamports;
+  meta->info.rent_epoch = ULONG_MAX;
+}
+
+static ulong
+test_acc_lamports( fd_acc_mgr_t *  acc_mgr,
+                   fd_funk_txn_t * txn,
+                   ulong           i ) {
+  fd_pubkey_t key = test_acc_key( i );
+  FD_BORROWED_ACCOUNT_DECL( rec );
+  if( fd_acc_mgr_view( acc_mgr, txn, &key, rec ) ) return 0UL;
+  return rec->const_meta->info.lamports;
+}
+
+/* test_txn_transfer makes txn_p a system transfer of lamports from
+   account from (the fee payer) to account to. */
+
+static void
+test_txn_transfer( fd_txn_p_t * txn_p,
+                   ulong        from,
+                   ulong        to,
+                   ulong        lamports ) {
+  fd_pubkey_t signer     = test_acc_key( from );
+  fd_pubkey_t recipient  = test_acc_key( to   );
+  fd_pubkey_t system_acc = fd_solana_system_program_id;
+
+  fd_txn_accounts_t accts = {
+    .signature_cnt         = 1,
+    .readonly_signed_cnt   = 0,
+    .readonly_unsigned_cnt = 1,
+    .acct_cnt              = 3,
+    .signers_w             = &signer,
+    .signers_r             = NULL,
+    .non_signers_w         = &recipient,
+    .non_signers_r         = &system_acc
+  };
+
+  uchar meta[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+  fd_memset( txn_p, 0, sizeof(fd_txn_p_t) );
+  FD_TEST( fd_txn_base_generate( meta, txn_p->payload, 1UL, &accts, (uchar *)test_blockhash ) );
+
+  /* Signatures are not verified here, they only need to be distinct */
+  FD_STORE( ulong, txn_p->payload+1UL, fd_ulong_hash( (from<<32) | to ) );
+
+  fd_system_program_instruction_t instr = {
+    .discriminant = fd_system_program_instruction_enum_transfer,
+    .inner        = { .transfer = lamports }
+  };
+  uchar instr_buf[ 32 ];
+  fd_bincode_encode_ctx_t encode = { .data = instr_buf, .dataend = instr_buf + sizeof(instr_buf) };
+  FD_TEST( !fd_system_program_instruction_encode( &instr, &encode ) );
+  uchar instr_accts[ 2 ] = { 0, 1 };
+  txn_p->payload_sz = fd_txn_add_instr( meta, txn_p->payload, 2, instr_accts, 2UL, instr_buf, (ulong)((uchar *)encode.data - instr_buf) );
+
+  FD_TEST( fd_txn_parse( txn_p->payload, txn_p->payload_sz, TXN( txn_p ), NULL ) );
+}
+
+/* A funds B, and B pays the fee of the next txn and funds C, which in
+   turn pays for a later txn.  D and E are independent of these.  F
+   does not exist and its txn is rejected. */
+
+#define A 0UL
+#define B 1UL
+#define C 2UL
+#define D 3UL
+#define E 4UL
+#define F 5UL
+
+static struct { ulong from; ulong to; ulong lamports; } const test_batch[] = {
+  { A, B, 1000000000UL },
+  { B, C,  100000000UL },
+  { D, E,  200000000UL },
+  { F, A,          1UL },
+  { C, D,   10000000UL },
+  { A, C,  500000000UL },
+};
+
+#define TEST_TXN_CNT (sizeof(test_batch)/sizeof(test_batch[0]))
+
+static void
+test_slot_reset( fd_exec_slot_ctx_t * slot_ctx,
+                 fd_funk_txn_t *      funk_txn ) {
+  slot_ctx->funk_txn                      = funk_txn;
+  slot_ctx->slot_bank.collected_fees      = 0UL;
+  slot_ctx->slot_bank.transaction_count   = 0UL;
+  slot_ctx->signature_cnt                 = 0UL;
+  slot_ctx->total_compute_units_requested = 0UL;
+}
+
+static void
+test_sched( fd_exec_slot_ctx_t * slot_ctx,
+            fd_tpool_t *         tpool,
+            ulong                max_workers ) {
+  fd_acc_mgr_t * acc_mgr = slot_ctx->acc_mgr;
+  fd_funk_t *    funk    = acc_mgr->funk;
+
+  fd_funk_start_write( funk );
+  fd_funk_txn_xid_t xid_batch  = { .ul = { 1UL, 0x5eedUL } };
+  fd_funk_txn_xid_t xid_serial = { .ul = { 1UL, 0xfeedUL } };
+  fd_funk_txn_t * txn_batch  = fd_funk_txn_prepare( funk, NULL, &xid_batch,  1 );
+  fd_funk_txn_t * txn_serial = fd_funk_txn_prepare( funk, NULL, &xid_serial, 1 );
+  FD_TEST( txn_batch && txn_serial );
+  fd_funk_end_write( funk );
+
+  static fd_txn_p_t txns_batch [ TEST_TXN_CNT ];
+  static fd_txn_p_t txns_serial[ TEST_TXN_CNT ];
+  for( ulong i=0UL; i<TEST_TXN_CNT; i++ ) {
+    test_txn_transfer( &txns_batch [ i ], test_batch[ i ].from, test_batch[ i ].to, test_batch[ i ].lamports );
+    test_txn_transfer( &txns_serial[ i ], test_batch[ i ].from, test_batch[ i ].to, test_batch[ i ].lamports );
+  }
+
+  /* The whole batch at once */
+
+  test_slot_reset( slot_ctx, txn_batch );
+  fd_runtime_execute_txns_in_waves_tpool( slot_ctx, NULL, txns_batch, TEST_TXN_CNT, tpool, max_workers );
+  ulong batch_fees = slot_ctx->slot_bank.collected_fees;
+  ulong batch_sigs = slot_ctx->signature_cnt;
+
+  /* One txn at a time, in block order */
+
+  test_slot_reset( slot_ctx, txn_serial );
+  for( ulong i=0UL; i<TEST_TXN_CNT; i++ ) {
+    fd_runtime_execute_txns_in_waves_tpool( slot_ctx, NULL, &txns_serial[ i ], 1UL, tpool, max_workers );
+  }
+  ulong serial_fees = slot_ctx->slot_bank.collected_fees;
+  ulong serial_sigs = slot_ctx->signature_cnt;
+
+  for( ulong i=0UL; i<TEST_TXN_CNT; i++ ) {
+    FD_TEST( !txns_batch[ i ].flags==!txns_serial[ i ].flags );
+    FD_TEST( !txns_batch[ i ].flags==(test_batch[ i ].from==F) );
+  }
+  FD_TEST( batch_fees==serial_fees && batch_fees );
+  FD_TEST( batch_sigs==serial_sigs );
+
+  ulong total = 0UL;
+  for( ulong i=0UL; i<TEST_ACC_CNT; i++ ) {
+    ulong lamports = test_acc_lamports( acc_mgr, txn_batch, i );
+    FD_TEST( lamports==test_acc_lamports( acc_mgr, txn_serial, i ) );
+    total += lamports;
+  }
+  FD_TEST( test_acc_lamports( acc_mgr, txn_batch, E )==200000000UL );
+  FD_TEST( test_acc_lamports( acc_mgr, txn_batch, B )==1000000000UL - 100000000UL - batch_fees/5UL );
+  FD_TEST( total + batch_fees==10000000000UL + 5000000000UL );
+
+  fd_funk_start_write( funk );
+  FD_TEST( fd_funk_txn_cancel( funk, txn_batch,  1 ) );
+  FD_TEST( fd_funk_txn_cancel( funk, txn_serial, 1 ) );
+  fd_funk_end_write( funk );
+  slot_ctx->funk_txn = NULL;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_flamenco_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal"        );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 32768UL         );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s)", page_cnt, _page_sz ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_alloc_t * alloc = fd_alloc_join( fd_alloc_new( fd_wksp_alloc_laddr( wksp, fd_alloc_align(), fd_alloc_footprint(), 41UL ), 41UL ), 0UL );
+  FD_TEST( alloc );
+  fd_valloc_t valloc = fd_alloc_virtual( alloc );
+
+  static uchar smem[ 1UL<<20 ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+  ulong fmem[ 64 ];
+  fd_scratch_attach( smem, fmem, sizeof(smem), 64UL );
+
+  /* Workers execute txns and need their own scratch */
+
+  ulong tile_cnt = fd_tile_cnt();
+  fd_tpool_t * tpool = NULL;
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "only testing serial dispatch, parallel execution requires at least 2 tiles (use --tile-cpus)" ));
+  } else {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    ulong   scratch_sz  = fd_scratch_smem_footprint( 1UL<<20 );
+    uchar * scratch_mem = fd_wksp_alloc_laddr( wksp, FD_SCRATCH_SMEM_ALIGN, scratch_sz*(tile_cnt-1UL), 1UL );
+    FD_TEST( scratch_mem );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, scratch_mem + scratch_sz*(tile_idx-1UL), scratch_sz ) );
+  }
+
+  ulong const funk_tag = 42UL;
+  fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), funk_tag ), funk_tag, 1234UL, 16UL, 1024UL ) );
+  FD_TEST( funk );
+  fd_acc_mgr_t * acc_mgr = fd_acc_mgr_new( fd_wksp_alloc_laddr( wksp, FD_ACC_MGR_ALIGN, FD_ACC_MGR_FOOTPRINT, 1UL ), funk );
+  FD_TEST( acc_mgr );
+
+  fd_exec_epoch_ctx_t * epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new(
+      fd_wksp_alloc_laddr( wksp, fd_exec_epoch_ctx_align(), fd_exec_epoch_ctx_footprint( 16UL ), 1UL ), 16UL ) );
+  fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new(
+      fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, 1UL ), valloc ) );
+  FD_TEST( epoch_ctx && slot_ctx );
+  slot_ctx->epoch_ctx = epoch_ctx;
+  slot_ctx->acc_mgr   = acc_mgr;
+
+  fd_features_disable_all( &epoch_ctx->features );
+  fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( epoch_ctx );
+  epoch_bank->rent.lamports_per_uint8_year = 3480UL;
+  epoch_bank->rent.exemption_threshold     = 2.0;
+  epoch_bank->rent.burn_percent            = 50;
+
+  /* The block hash queue only holds the blockhash of the test txns */
+
+  fd_slot_bank_t * slot_bank = &slot_ctx->slot_bank;
+  slot_bank->slot                                    = 1UL;
+  slot_bank->fee_rate_governor.target_lamports_per_signature = 10000UL;
+  slot_bank->lamports_per_signature                  = 5000UL;
+  slot_bank->recent_block_hashes.hashes = deq_fd_block_block_hash_entry_t_alloc( valloc, FD_SYSVAR_RECENT_HASHES_CAP );
+  fd_block_block_hash_entry_t * recent = deq_fd_block_block_hash_entry_t_push_tail_nocopy( slot_bank->recent_block_hashes.hashes );
+  fd_block_block_hash_entry_new( recent );
+  fd_memcpy( recent->blockhash.hash, test_blockhash, sizeof(fd_hash_t) );
+  recent->fee_calculator.lamports_per_signature = 5000UL;
+
+  slot_bank->block_hash_queue.ages_pool = fd_hash_hash_age_pair_t_map_alloc( valloc, 16UL );
+  fd_hash_hash_age_pair_t_mapnode_t * age = fd_hash_hash_age_pair_t_map_acquire( slot_bank->block_hash_queue.ages_pool );
+  fd_memcpy( age->elem.key.hash, test_blockhash, sizeof(fd_hash_t) );
+  age->elem.val = (fd_hash_age_t){ .hash_index = 0UL, .fee_calculator = { .lamports_per_signature = 5000UL } };
+  fd_hash_hash_age_pair_t_map_insert( slot_bank->block_hash_queue.ages_pool, &slot_bank->block_hash_queue.ages_root, age );
+  slot_bank->block_hash_queue.last_hash = fd_valloc_malloc( valloc, FD_HASH_ALIGN, FD_HASH_FOOTPRINT );
+  fd_memcpy( slot_bank->block_hash_queue.last_hash, test_blockhash, sizeof(fd_hash_t) );
+  slot_bank->block_hash_queue.max_age = FD_BLOCKHASH_QUEUE_MAX_ENTRIES;
+
+  /* Genesis: the rent sysvar and the funded accounts */
+
+  fd_funk_start_write( funk );
+  fd_sysvar_rent_init( slot_ctx );
+  fd_sysvar_cache_restore( slot_ctx->sysvar_cache, acc_mgr, NULL );
+  FD_TEST( fd_sysvar_cache_rent( slot_ctx->sysvar_cache ) );
+  test_acc_fund( acc_mgr, A, 10000000000UL );
+  test_acc_fund( acc_mgr, D,  5000000000UL );
+  fd_funk_end_write( funk );
+
+  test_sched( slot_ctx, NULL,  1UL      );
+  if( tpool ) test_sched( slot_ctx, tpool, tile_cnt );
+
+  if( tpool ) FD_TEST( fd_tpool_fini( tpool ) );
+  fd_scratch_detach( NULL );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_flamenco_halt();
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,311 @@
+#include "fd_txn_sched.h"
+
+/* The txns of the test operate on a table of ulong account values.
+   Executing a txn mixes the values of all of its accounts into a digest
+   (reading the shared table like a worker reading funk) and finalizing
+   it stores a value derived from the digest into each writable account.
+   Preparing a txn charges a "fee" to its first account if it is
+   writable.  The final table only matches serial execution in block
+   order if every txn observed the writes of the earlier txns it
+   conflicts with, and none of the later ones. */
+
+#define TEST_ACCT_CNT    (64UL)
+#define TEST_TXN_MAX     (128UL)
+#define TEST_TXN_ACCT_MAX (8UL)
+
+#define SCRATCH_MAX (1UL<<22)
+#define SCRATCH_DEPTH (16UL)
+static uchar scratch_mem [ SCRATCH_MAX ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+static ulong scratch_fmem[ SCRATCH_DEPTH ] __attribute__((aligned(FD_SCRATCH_FMEM_ALIGN)));
+
+static fd_pubkey_t test_key[ TEST_ACCT_CNT ];
+
+struct test_txn {
+  ulong acct_cnt;
+  ulong acct[ TEST_TXN_ACCT_MAX ];
+  int   writable[ TEST_TXN_ACCT_MAX ];
+  int   skip;
+  ulong spin;
+
+  ulong digest;
+  int   state; /* 0 pending, 1 prepared, 2 executed, 3 finalized */
+};
+typedef struct test_txn test_txn_t;
+
+struct test_ctx {
+  test_txn_t * txn;
+  ulong        txn_cnt;
+  ulong *      val;
+  ulong        prep_cnt;
+  ulong        fini_cnt;
+  ulong        inflight_max;
+};
+typedef struct test_ctx test_ctx_t;
+
+static inline ulong
+test_fee( ulong val, ulong txn_idx ) {
+  return fd_ulong_hash( val ^ (txn_idx<<32) ^ 0x5a5aUL );
+}
+
+static inline ulong
+test_digest( test_txn_t const * txn, ulong txn_idx, ulong const * val ) {
+  ulong h = fd_ulong_hash( txn_idx );
+  for( ulong j=0UL; j<txn->acct_cnt; j++ ) h = fd_ulong_hash( h ^ val[ txn->acct[j] ] ) + j;
+  return h;
+}
+
+static inline ulong
+test_store( ulong digest, ulong j ) {
+  return fd_ulong_hash( digest + j*0x9e3779b97f4a7c15UL );
+}
+
+static int
+txn_conflict( test_txn_t const * a, test_txn_t const * b ) {
+  for( ulong i=0UL; i<a->acct_cnt; i++ ) {
+    for( ulong j=0UL; j<b->acct_cnt; j++ ) {
+      if( a->acct[i]!=b->acct[j] || !a->acct[i] ) continue;
+      if( a->writable[i] | b->writable[j] ) return 1;
+    }
+  }
+  return 0;
+}
+
+static int
+test_prepare( void * _ctx, ulong txn_idx ) {
+  test_ctx_t * ctx = (test_ctx_t *)_ctx;
+  test_txn_t * txn = ctx->txn + txn_idx;
+
+  /* Txns are admitted in block order.  Every earlier conflicting txn
+     must be finalized, no later one may have started. */
+  FD_TEST( txn_idx==ctx->prep_cnt );
+  FD_TEST( txn->state==0 );
+  for( ulong i=0UL; i<ctx->txn_cnt; i++ ) {
+    if( i==txn_idx || !txn_conflict( txn, ctx->txn+i ) ) continue;
+    if( i<txn_idx ) FD_TEST( ctx->txn[i].state==3 );
+    else            FD_TEST( ctx->txn[i].state==0 );
+  }
+
+  txn->state = 1;
+  ctx->prep_cnt++;
+  ctx->inflight_max = fd_ulong_max( ctx->inflight_max, ctx->prep_cnt - ctx->fini_cnt );
+  if( txn->skip ) return 1;
+  if( txn->writable[0] ) ctx->val[ txn->acct[0] ] = test_fee( ctx->val[ txn->acct[0] ], txn_idx );
+  return 0;
+}
+
+static void
+test_execute( void * tpool,
+              ulong t0 FD_PARAM_UNUSED, ulong t1 FD_PARAM_UNUSED,
+              void * args,
+              void * reduce FD_PARAM_UNUSED, ulong stride FD_PARAM_UNUSED,
+              ulong l0 FD_PARAM_UNUSED, ulong l1 FD_PARAM_UNUSED,
+              ulong m0, ulong m1,
+              ulong n0 FD_PARAM_UNUSED, ulong n1 FD_PARAM_UNUSED ) {
+  test_ctx_t * ctx = (test_ctx_t *)args;
+  test_txn_t * txn = (test_txn_t *)tpool + m0;
+  FD_TEST( m1==m0+1UL );
+  FD_TEST( txn->state==1 );
+
+  long deadline = fd_log_wallclock() + (long)txn->spin;
+  while( fd_log_wallclock()<deadline ) FD_SPIN_PAUSE();
+
+  txn->digest = test_digest( txn, m0, ctx->val );
+  FD_COMPILER_MFENCE();
+  txn->state  = 2;
+}
+
+static void
+test_finalize( void * _ctx, ulong txn_idx ) {
+  test_ctx_t * ctx = (test_ctx_t *)_ctx;
+  test_txn_t * txn = ctx->txn + txn_idx;
+
+  FD_TEST( txn->state==( txn->skip ? 1 : 2 ) );
+  if( !txn->skip ) {
+    for( ulong j=0UL; j<txn->acct_cnt; j++ ) {
+      if( txn->writable[j] ) ctx->val[ txn->acct[j] ] = test_store( txn->digest, j );
+    }
+  }
+  txn->state = 3;
+  ctx->fini_cnt++;
+}
+
+/* test_serial applies txns in block order */
+
+static void
+test_serial( test_txn_t const * txn, ulong txn_cnt, ulong * val ) {
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    if( txn[i].skip ) continue;
+    if( txn[i].writable[0] ) val[ txn[i].acct[0] ] = test_fee( val[ txn[i].acct[0] ], i );
+    ulong digest = test_digest( txn+i, i, val );
+    for( ulong j=0UL; j<txn[i].acct_cnt; j++ ) {
+      if( txn[i].writable[j] ) val[ txn[i].acct[j] ] = test_store( digest, j );
+    }
+  }
+}
+
+/* test_gen generates txn_cnt txns over the first acct_cnt accounts.
+   Account 0 has the all-zero address.  Accounts in a txn are distinct.
+   If hot is set, every txn writes account 1. */
+
+static void
+test_gen( test_txn_t * txn,
+          ulong        txn_cnt,
+          ulong        acct_cnt,
+          int          hot,
+          ulong        spin_max,
+          fd_rng_t *   rng ) {
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    test_txn_t * t = txn+i;
+    fd_memset( t, 0, sizeof(test_txn_t) );
+    t->acct_cnt = 1UL + fd_rng_ulong_roll( rng, fd_ulong_min( acct_cnt, TEST_TXN_ACCT_MAX ) );
+    for( ulong j=0UL; j<t->acct_cnt; j++ ) {
+      ulong acct;
+      for(;;) {
+        acct = fd_rng_ulong_roll( rng, acct_cnt );
+        int dup = 0;
+        for( ulong k=0UL; k<j; k++ ) dup |= t->acct[k]==acct;
+        if( !dup ) break;
+      }
+      t->acct[j]     = acct;
+      t->writable[j] = acct ? (int)fd_rng_uint_roll( rng, 2U ) : 0;
+    }
+    if( hot ) {
+      t->acct[0]     = 1UL;
+      t->writable[0] = 1;
+      for( ulong j=1UL; j<t->acct_cnt; j++ ) if( t->acct[j]==1UL ) t->acct[j] = 0UL, t->writable[j] = 0;
+    }
+    t->skip = !fd_rng_uint_roll( rng, 16U );
+    t->spin = spin_max ? fd_rng_ulong_roll( rng, spin_max ) : 0UL;
+  }
+}
+
+static ulong
+test_run( test_txn_t *   txn,
+          ulong          txn_cnt,
+          fd_tpool_t *   tpool,
+          ulong          t0,
+          ulong          t1,
+          fd_rng_t *     rng ) {
+  ulong val[ TEST_ACCT_CNT ];
+  ulong ref[ TEST_ACCT_CNT ];
+  for( ulong i=0UL; i<TEST_ACCT_CNT; i++ ) val[i] = ref[i] = fd_rng_ulong( rng );
+  test_serial( txn, txn_cnt, ref );
+
+  test_ctx_t ctx = { .txn = txn, .txn_cnt = txn_cnt, .val = val };
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    ulong *               acct_off = fd_scratch_alloc( alignof(ulong), (txn_cnt+1UL)*sizeof(ulong) );
+    fd_txn_sched_acct_t * acct     = fd_scratch_alloc( alignof(fd_txn_sched_acct_t), txn_cnt*TEST_TXN_ACCT_MAX*sizeof(fd_txn_sched_acct_t) );
+    acct_off[0] = 0UL;
+    for( ulong i=0UL; i<txn_cnt; i++ ) {
+      for( ulong j=0UL; j<txn[i].acct_cnt; j++ ) {
+        acct[ acct_off[i]+j ] = (fd_txn_sched_acct_t){ .pubkey = &test_key[ txn[i].acct[j] ], .writable = txn[i].writable[j] };
+      }
+      acct_off[i+1UL] = acct_off[i] + txn[i].acct_cnt;
+    }
+
+    fd_txn_sched_t sched[1];
+    FD_TEST( fd_txn_sched_build( sched, txn_cnt, acct_off, acct )==sched );
+    FD_TEST( sched->link_cnt<=3UL*acct_off[ txn_cnt ] );
+
+    /* Only the first txn(s) touching each account have no predecessors */
+    for( ulong i=0UL; i<txn_cnt; i++ ) {
+      int first = 1;
+      for( ulong k=0UL; k<i; k++ ) first &= !txn_conflict( txn+i, txn+k );
+      FD_TEST( (sched->in_deg[i]==0UL)==first );
+    }
+
+    FD_TEST( fd_txn_sched_run( sched, tpool, t0, t1, test_prepare, test_execute, txn, test_finalize, &ctx )==txn_cnt );
+  } FD_SCRATCH_SCOPE_END;
+
+  FD_TEST( ctx.prep_cnt==txn_cnt && ctx.fini_cnt==txn_cnt );
+  for( ulong i=0UL; i<txn_cnt; i++ ) FD_TEST( txn[i].state==3 );
+  FD_TEST( !memcmp( val, ref, sizeof(val) ) );
+  if( tpool ) for( ulong w=t0+1UL; w<t1; w++ ) FD_TEST( fd_tpool_worker_state( tpool, w )==FD_TPOOL_WORKER_STATE_IDLE );
+  return ctx.inflight_max;
+}
+
+static void
+test_sched( test_txn_t * txn,
+            fd_tpool_t * tpool,
+            ulong        t0,
+            ulong        t1,
+            fd_rng_t *   rng ) {
+  ulong worker_cnt = tpool ? t1-t0-1UL : 0UL;
+  ulong spin_max   = tpool ? 2000UL : 0UL;
+
+  /* Empty batch */
+  FD_TEST( test_run( txn, 0UL, tpool, t0, t1, rng )==0UL );
+
+  /* Random conflicts, from dense to sparse */
+  for( ulong acct_cnt=2UL; acct_cnt<=TEST_ACCT_CNT; acct_cnt<<=1 ) {
+    for( ulong iter=0UL; iter<4UL; iter++ ) {
+      ulong txn_cnt = 1UL + fd_rng_ulong_roll( rng, TEST_TXN_MAX );
+      test_gen( txn, txn_cnt, acct_cnt, 0, spin_max, rng );
+      ulong inflight = test_run( txn, txn_cnt, tpool, t0, t1, rng );
+      FD_TEST( inflight>=1UL && inflight<=fd_ulong_max( worker_cnt, 1UL ) + 1UL );
+    }
+  }
+
+  /* A hot account serializes the txns that write it */
+  test_gen( txn, TEST_TXN_MAX, TEST_ACCT_CNT, 1, spin_max, rng );
+  test_run( txn, TEST_TXN_MAX, tpool, t0, t1, rng );
+
+  /* Independent txns run concurrently */
+  for( ulong i=0UL; i<TEST_TXN_MAX; i++ ) {
+    fd_memset( txn+i, 0, sizeof(test_txn_t) );
+    txn[i].acct_cnt    = 2UL;
+    txn[i].acct[0]     = 1UL + (i % (TEST_ACCT_CNT-1UL));
+    txn[i].writable[0] = 1;
+    txn[i].acct[1]     = 0UL;
+    txn[i].spin        = spin_max;
+  }
+  ulong txn_cnt  = TEST_ACCT_CNT-1UL;
+  ulong inflight = test_run( txn, txn_cnt, tpool, t0, t1, rng );
+  if( worker_cnt>1UL ) FD_TEST( inflight>1UL );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_scratch_attach( scratch_mem, scratch_fmem, SCRATCH_MAX, SCRATCH_DEPTH );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  fd_memset( test_key, 0, sizeof(test_key) );
+  for( ulong i=1UL; i<TEST_ACCT_CNT; i++ ) {
+    for( ulong j=0UL; j<4UL; j++ ) test_key[i].ul[j] = fd_rng_ulong( rng );
+  }
+
+  static test_txn_t txn[ TEST_TXN_MAX ];
+
+  /* On the caller */
+
+  test_sched( txn, NULL, 0UL, 0UL, rng );
+
+  /* On tpool workers */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: tpool txn sched test requires at least 2 tiles (use --tile-cpus)" ));
+  } else {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    fd_tpool_t * tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL ) );
+
+    test_sched( txn, tpool, 0UL, tile_cnt, rng );
+
+    FD_TEST( fd_tpool_fini( tpool ) );
+  }
+
+  fd_scratch_detach( NULL );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -1,6 +1,7 @@
 #define FD_SCRATCH_USE_HANDHOLDING 1
 #include "../../fd_flamenco_base.h"
 #include "fd_exec_instr_test.h"
+#include "../../vm/fd_vm_jit.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/types.h>
@@ -55,6 +56,9 @@ main( int     argc,
       char ** argv ) {
   fd_boot( &argc, &argv );
 
+  /* --vm-jit 1 runs the fixtures' sBPF programs as native code */
+  fd_vm_jit_enable( fd_env_strip_cmdline_int( &argc, &argv, "--vm-jit", NULL, 0 ) );
+
   /* TODO switch to leap API and set up a thread pool once available */
   ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
   if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
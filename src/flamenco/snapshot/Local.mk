@@ -23,6 +23,17 @@ $(call add-objs,fd_snapshot,fd_flamenco)
 
 $(call add-hdrs,fd_snapshot_loader.h)
 $(call add-objs,fd_snapshot_loader,fd_flamenco)
+ifdef FD_HAS_HOSTED
+$(call make-unit-test,test_snapshot_istream,test_snapshot_istream,fd_flamenco fd_util)
+$(call run-unit-test,test_snapshot_istream)
+endif
+
+$(call add-hdrs,fd_snapshot_create.h)
+$(call add-objs,fd_snapshot_create,fd_flamenco)
+ifdef FD_HAS_HOSTED
+$(call make-unit-test,test_snapshot_create,test_snapshot_create,fd_flamenco fd_funk fd_ballet fd_util)
+$(call run-unit-test,test_snapshot_create)
+endif
 
 $(call make-bin,fd_snapshot,fd_snapshot_main,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
 endif
@@ -128,7 +128,9 @@ restore_manifest( void *                 ctx,
 static void
 load_one_snapshot( fd_exec_slot_ctx_t * slot_ctx,
                    char *               source_cstr,
-                   fd_snapshot_name_t * name_out ) {
+                   fd_snapshot_name_t * name_out,
+                   fd_tpool_t *         tpool,
+                   ulong                max_workers ) {
 
   /* FIXME don't hardcode this param */
   static ulong const zstd_window_sz = 33554432UL;
@@ -143,10 +145,22 @@ load_one_snapshot( fd_exec_slot_ctx_t * slot_ctx,
   fd_funk_txn_t * funk_txn = slot_ctx->funk_txn;
 
   void * restore_mem = fd_valloc_malloc( valloc, fd_snapshot_restore_align(), fd_snapshot_restore_footprint() );
-  void * loader_mem  = fd_valloc_malloc( valloc, fd_snapshot_loader_align(),  fd_snapshot_loader_footprint( zstd_window_sz ) );
+  /* Split tpool workers [1,max_workers) between decompression and
+     account insertion.  Decompression runs asynchronously on workers
+     [1,1+worker_cnt).  Account insertion is dispatched by this thread,
+     masquerading as worker worker_cnt, to workers [1+worker_cnt,
+     max_workers). */
+
+  if( !tpool || max_workers<2UL ) { tpool = NULL; max_workers = 1UL; }
+  ulong worker_cnt = fd_ulong_max( (max_workers-1UL)/2UL, 1UL );
+  if( !tpool ) worker_cnt = 0UL;
+
+  void * loader_mem  = fd_valloc_malloc( valloc, fd_snapshot_loader_align(),  fd_snapshot_loader_footprint_tpool( zstd_window_sz, worker_cnt ) );
 
   fd_snapshot_restore_t * restore = fd_snapshot_restore_new( restore_mem, acc_mgr, funk_txn, valloc, slot_ctx, restore_manifest );
-  fd_snapshot_loader_t *  loader  = fd_snapshot_loader_new ( loader_mem, zstd_window_sz );
+  fd_snapshot_loader_t *  loader  = fd_snapshot_loader_new_tpool( loader_mem, zstd_window_sz, tpool, 1UL, 1UL+worker_cnt );
+  if( restore && max_workers>1UL+worker_cnt )
+    fd_snapshot_restore_set_tpool( restore, tpool, worker_cnt, max_workers, 0UL );
 
   if( FD_UNLIKELY( !restore || !loader ) ) {
     fd_valloc_free( valloc, fd_snapshot_loader_delete ( loader_mem  ) );
@@ -183,6 +197,17 @@ fd_snapshot_load( const char *         snapshotfile,
                   uint                 verify_hash,
                   uint                 check_hash,
                   int                  snapshot_type ) {
+  fd_snapshot_load_tpool( snapshotfile, slot_ctx, verify_hash, check_hash, snapshot_type, NULL, 0UL );
+}
+
+void
+fd_snapshot_load_tpool( const char *         snapshotfile,
+                        fd_exec_slot_ctx_t * slot_ctx,
+                        uint                 verify_hash,
+                        uint                 check_hash,
+                        int                  snapshot_type,
+                        fd_tpool_t *         tpool,
+                        ulong                max_workers ) {
 
   switch (snapshot_type) {
   case FD_SNAPSHOT_TYPE_UNSPECIFIED:
@@ -209,7 +234,7 @@ fd_snapshot_load( const char *         snapshotfile,
   char * snapshot_cstr = fd_scratch_alloc( 1UL, slen + 1 );
   fd_cstr_fini( fd_cstr_append_text( fd_cstr_init( snapshot_cstr ), snapshotfile, slen ) );
   fd_snapshot_name_t name = {0};
-  load_one_snapshot( slot_ctx, snapshot_cstr, &name );
+  load_one_snapshot( slot_ctx, snapshot_cstr, &name, tpool, max_workers );
   fd_hash_t const * fhash = &name.fhash;
   fd_scratch_pop();
 
@@ -250,6 +275,11 @@ fd_snapshot_load( const char *         snapshotfile,
     }
   }
 
+  /* Seed the running accounts lthash, which replay then maintains
+     incrementally.  Done before fd_hashes_load so the saved slot bank
+     carries it. */
+  if( slot_ctx->enable_lthash ) fd_accounts_init_lthash_tpool( slot_ctx, tpool, max_workers );
+
   fd_hashes_load(slot_ctx);
 
   fd_funk_end_write( slot_ctx->acc_mgr->funk );
@@ -56,6 +56,20 @@ fd_snapshot_load( const char *         source_cstr,
                   uint                 check_hash,
                   int                  snapshot_type );
 
+/* fd_snapshot_load_tpool is fd_snapshot_load that decompresses the
+   snapshot on tpool workers [1,max_workers).  The workers must be idle
+   and are reserved until the load returns.  tpool==NULL or
+   max_workers<2 is equivalent to fd_snapshot_load. */
+
+void
+fd_snapshot_load_tpool( const char *         source_cstr,
+                        fd_exec_slot_ctx_t * slot_ctx,
+                        uint                 verify_hash,
+                        uint                 check_hash,
+                        int                  snapshot_type,
+                        fd_tpool_t *         tpool,
+                        ulong                max_workers );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_snapshot_fd_snapshot_h */
@@ -0,0 +1,1076 @@
+#include "fd_snapshot_create.h"
+#include "../runtime/fd_acc_mgr.h"
+#include "../runtime/context/fd_exec_epoch_ctx.h"
+#include "../runtime/sysvar/fd_sysvar_epoch_schedule.h"
+#include "../nanopb/pb_decode.h"
+#include "../types/fd_solana_block.pb.h"
+#include "../../ballet/blake3/fd_blake3.h"
+#include "../../ballet/txn/fd_txn.h"
+#include "../../ballet/zstd/fd_zstd.h"
+#include "../../util/archive/fd_tar.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#pragma GCC diagnostic ignored "-Wformat"
+#pragma GCC diagnostic ignored "-Wformat-extra-args"
+
+/* FD_SNAPSHOT_CREATE_VERSION is the content of the "version" file. */
+
+#define FD_SNAPSHOT_CREATE_VERSION "1.2.0"
+
+/* fd_snapshot_create_accv_t describes an account vec.  The accounts of
+   an account vec are recs[rec0,rec0+rec_cnt). */
+
+struct fd_snapshot_create_accv {
+  ulong rec0;
+  ulong rec_cnt;
+  ulong sz;       /* serialized size, excl tar header and padding */
+  ulong id;
+};
+
+typedef struct fd_snapshot_create_accv fd_snapshot_create_accv_t;
+
+/* fd_snapshot_create_writer_t compresses a stream of tar records into
+   Zstandard frames and writes them out to a file. */
+
+struct fd_snapshot_create_writer {
+  fd_zstd_cstream_t * cstream;
+  uchar *             buf;      /* compressed output buffer, compress_bufsz bytes */
+  ulong               buf_sz;   /* bytes pending in buf */
+  int                 fd;
+  ulong               file_sz;  /* bytes written to fd */
+  ulong               accv0;    /* account vecs [accv0,accv1) of this worker */
+  ulong               accv1;
+  int                 err;
+};
+
+typedef struct fd_snapshot_create_writer fd_snapshot_create_writer_t;
+
+struct fd_snapshot_create_private {
+  ulong magic;
+
+  ulong worker_cnt;
+  int   compress_lvl;
+  ulong compress_bufsz;
+  ulong funk_rec_cnt;
+  ulong batch_acc_cnt;
+  ulong max_accv_sz;
+
+  ulong id0;        /* id of the first account vec */
+  ulong mtime;      /* tar mtime of the snapshot being created */
+  ulong slot;       /* slot of the snapshot being created */
+  fd_wksp_t * wksp; /* funk wksp of the snapshot being created */
+
+  int  fd;          /* output file, at path tmp_path */
+  char snap_path[ PATH_MAX ];
+  char tmp_path [ PATH_MAX ];
+
+  fd_funk_rec_t const **        recs;     /* funk_rec_cnt elements */
+  ulong                         rec_cnt;
+  fd_snapshot_create_accv_t *   accvs;    /* funk_rec_cnt elements */
+  ulong                         accv_cnt;
+  fd_snapshot_create_writer_t * workers;  /* worker_cnt elements */
+};
+
+#define FD_SNAPSHOT_CREATE_MAGIC (0xf17e5a9c3ea7e000UL) /* firedancer snapshot create version 0 */
+
+static uchar const fd_snapshot_create_zeros[ 2UL*sizeof(fd_tar_meta_t) ] = {0};
+
+FD_FN_CONST ulong
+fd_snapshot_create_align( void ) {
+  return FD_SNAPSHOT_CREATE_ALIGN;
+}
+
+ulong
+fd_snapshot_create_footprint( ulong worker_cnt,
+                              int   compress_lvl,
+                              ulong compress_bufsz,
+                              ulong funk_rec_cnt,
+                              ulong batch_acc_cnt ) {
+
+  if( FD_UNLIKELY( (!worker_cnt) | (worker_cnt>FD_TILE_MAX) ) ) return 0UL;
+  if( FD_UNLIKELY( (!compress_bufsz) | (!funk_rec_cnt) | (!batch_acc_cnt) ) ) return 0UL;
+  ulong cstream_footprint = fd_zstd_cstream_footprint( compress_lvl );
+  if( FD_UNLIKELY( !cstream_footprint ) ) return 0UL;
+
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, FD_SNAPSHOT_CREATE_ALIGN,              sizeof(fd_snapshot_create_t)                   );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_funk_rec_t const *),        funk_rec_cnt * sizeof(fd_funk_rec_t const *)   );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_snapshot_create_accv_t),    funk_rec_cnt * sizeof(fd_snapshot_create_accv_t) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_snapshot_create_writer_t),  worker_cnt * sizeof(fd_snapshot_create_writer_t) );
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    l = FD_LAYOUT_APPEND( l, fd_zstd_cstream_align(), cstream_footprint );
+    l = FD_LAYOUT_APPEND( l, 1UL,                     compress_bufsz    );
+  }
+  return FD_LAYOUT_FINI( l, FD_SNAPSHOT_CREATE_ALIGN );
+}
+
+fd_snapshot_create_t *
+fd_snapshot_create_new( void *               mem,
+                        fd_exec_slot_ctx_t * slot_ctx,
+                        const char *         snap_path,
+                        ulong                worker_cnt,
+                        int                  compress_lvl,
+                        ulong                compress_bufsz,
+                        ulong                funk_rec_cnt,
+                        ulong                batch_acc_cnt,
+                        ulong                max_accv_sz,
+                        fd_rng_t *           rng ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_snapshot_create_align() ) ) ) {
+    FD_LOG_WARNING(( "unaligned mem" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( (!slot_ctx) | (!snap_path) | (!rng) ) ) {
+    FD_LOG_WARNING(( "NULL slot_ctx, snap_path or rng" ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( !max_accv_sz ) ) {
+    FD_LOG_WARNING(( "zero max_accv_sz" ));
+    return NULL;
+  }
+  ulong footprint = fd_snapshot_create_footprint( worker_cnt, compress_lvl, compress_bufsz, funk_rec_cnt, batch_acc_cnt );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "invalid params (worker_cnt=%lu compress_lvl=%d compress_bufsz=%lu funk_rec_cnt=%lu batch_acc_cnt=%lu)",
+                     worker_cnt, compress_lvl, compress_bufsz, funk_rec_cnt, batch_acc_cnt ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( l, mem );
+  fd_snapshot_create_t * create = FD_SCRATCH_ALLOC_APPEND( l, FD_SNAPSHOT_CREATE_ALIGN, sizeof(fd_snapshot_create_t) );
+  fd_memset( create, 0, sizeof(fd_snapshot_create_t) );
+
+  create->worker_cnt     = worker_cnt;
+  create->compress_lvl   = compress_lvl;
+  create->compress_bufsz = compress_bufsz;
+  create->funk_rec_cnt   = funk_rec_cnt;
+  create->batch_acc_cnt  = batch_acc_cnt;
+  create->max_accv_sz    = max_accv_sz;
+  create->id0            = (ulong)fd_rng_uint( rng );
+  create->fd             = -1;
+
+  create->recs    = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_funk_rec_t const *),       funk_rec_cnt * sizeof(fd_funk_rec_t const *)     );
+  create->accvs   = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_snapshot_create_accv_t),   funk_rec_cnt * sizeof(fd_snapshot_create_accv_t) );
+  create->workers = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_snapshot_create_writer_t), worker_cnt * sizeof(fd_snapshot_create_writer_t) );
+
+  ulong cstream_footprint = fd_zstd_cstream_footprint( compress_lvl );
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    fd_snapshot_create_writer_t * w = &create->workers[ i ];
+    fd_memset( w, 0, sizeof(fd_snapshot_create_writer_t) );
+    w->cstream = fd_zstd_cstream_new( FD_SCRATCH_ALLOC_APPEND( l, fd_zstd_cstream_align(), cstream_footprint ), compress_lvl );
+    w->buf     = FD_SCRATCH_ALLOC_APPEND( l, 1UL, compress_bufsz );
+    w->fd      = -1;
+  }
+  FD_SCRATCH_ALLOC_FINI( l, FD_SNAPSHOT_CREATE_ALIGN );
+
+  /* Open the output file and the worker temp files next to it */
+
+  int path_ok = 1;
+  path_ok &= fd_cstr_printf_check( create->snap_path, PATH_MAX, NULL, "%s",     snap_path );
+  path_ok &= fd_cstr_printf_check( create->tmp_path,  PATH_MAX, NULL, "%s.tmp", snap_path );
+  if( FD_UNLIKELY( !path_ok ) ) {
+    FD_LOG_WARNING(( "snapshot path too long" ));
+    goto fail;
+  }
+
+  create->fd = open( create->tmp_path, O_CREAT|O_TRUNC|O_RDWR, 0644 );
+  if( FD_UNLIKELY( create->fd<0 ) ) {
+    FD_LOG_WARNING(( "open(%s) failed (%d-%s)", create->tmp_path, errno, fd_io_strerror( errno ) ));
+    goto fail;
+  }
+
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    char path[ PATH_MAX ];
+    if( FD_UNLIKELY( !fd_cstr_printf_check( path, PATH_MAX, NULL, "%s.XXXXXX", snap_path ) ) ) {
+      FD_LOG_WARNING(( "snapshot path too long" ));
+      goto fail;
+    }
+    int fd = mkstemp( path );
+    if( FD_UNLIKELY( fd<0 ) ) {
+      FD_LOG_WARNING(( "mkstemp(%s) failed (%d-%s)", path, errno, fd_io_strerror( errno ) ));
+      goto fail;
+    }
+    create->workers[ i ].fd = fd;
+    if( FD_UNLIKELY( 0!=unlink( path ) ) ) {
+      FD_LOG_WARNING(( "unlink(%s) failed (%d-%s)", path, errno, fd_io_strerror( errno ) ));
+      goto fail;
+    }
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( create->magic ) = FD_SNAPSHOT_CREATE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return create;
+
+fail:
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    if( create->workers[ i ].fd>=0 ) close( create->workers[ i ].fd );
+  }
+  if( create->fd>=0 ) {
+    close( create->fd );
+    unlink( create->tmp_path );
+  }
+  return NULL;
+}
+
+void *
+fd_snapshot_create_delete( fd_snapshot_create_t * create ) {
+
+  if( FD_UNLIKELY( !create ) ) return NULL;
+  if( FD_UNLIKELY( create->magic!=FD_SNAPSHOT_CREATE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  for( ulong i=0UL; i<create->worker_cnt; i++ ) {
+    fd_snapshot_create_writer_t * w = &create->workers[ i ];
+    fd_zstd_cstream_delete( w->cstream );
+    if( FD_UNLIKELY( 0!=close( w->fd ) ) )
+      FD_LOG_WARNING(( "close(%d) failed (%d-%s)", w->fd, errno, fd_io_strerror( errno ) ));
+  }
+
+  if( FD_UNLIKELY( 0!=close( create->fd ) ) )
+    FD_LOG_WARNING(( "close(%s) failed (%d-%s)", create->tmp_path, errno, fd_io_strerror( errno ) ));
+  unlink( create->tmp_path ); /* no-op after a successful create */
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( create->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return create;
+}
+
+/* Writer *************************************************************/
+
+/* fd_snapshot_create_writer_flush writes out the compressed bytes
+   pending in w's buffer.  Returns 0 on success and an errno compatible
+   error code on failure. */
+
+static int
+fd_snapshot_create_writer_flush( fd_snapshot_create_writer_t * w ) {
+  if( !w->buf_sz ) return 0;
+  ulong wsz;
+  int err = fd_io_write( w->fd, w->buf, w->buf_sz, w->buf_sz, &wsz );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "write failed (%d-%s)", err, fd_io_strerror( err ) ));
+    return err;
+  }
+  w->file_sz += w->buf_sz;
+  w->buf_sz   = 0UL;
+  return 0;
+}
+
+/* fd_snapshot_create_writer_append compresses sz bytes at data into the
+   current frame of w.  If end_frame is set, closes the frame afterwards.
+   Returns 0 on success and an errno compatible error code on failure. */
+
+static int
+fd_snapshot_create_writer_append( fd_snapshot_create_t *        create,
+                                  fd_snapshot_create_writer_t * w,
+                                  void const *                  data,
+                                  ulong                         sz,
+                                  int                           end_frame ) {
+
+  uchar const * in     = (uchar const *)data;
+  uchar const * in_end = in + sz;
+
+  for(;;) {
+    uchar * out     = w->buf + w->buf_sz;
+    uchar * out_end = w->buf + create->compress_bufsz;
+    ulong   errcode = 0UL;
+    int rc = fd_zstd_cstream_compress( w->cstream, &in, in_end, &out, out_end, end_frame, &errcode );
+    if( FD_UNLIKELY( rc>0 ) ) {
+      FD_LOG_WARNING(( "fd_zstd_cstream_compress failed (%lu)", errcode ));
+      fd_zstd_cstream_reset( w->cstream );
+      return rc;
+    }
+    w->buf_sz = (ulong)( out - w->buf );
+
+    if( w->buf_sz==create->compress_bufsz ) {
+      int err = fd_snapshot_create_writer_flush( w );
+      if( FD_UNLIKELY( err ) ) return err;
+    }
+    if( rc<0 ) break;                           /* frame done */
+    if( (!end_frame) & (in==in_end) ) break;
+  }
+  return 0;
+}
+
+/* fd_snapshot_create_writer_file appends a tar record for a regular
+   file of sz bytes and writes its content from data (if non-NULL,
+   otherwise the caller appends the content and padding itself). */
+
+static int
+fd_snapshot_create_writer_file( fd_snapshot_create_t *        create,
+                                fd_snapshot_create_writer_t * w,
+                                char const *                  name,
+                                void const *                  data,
+                                ulong                         sz ) {
+  fd_tar_meta_t meta[1];
+  if( FD_UNLIKELY( !fd_tar_meta_init_file( meta, name, sz, create->mtime ) ) ) {
+    FD_LOG_WARNING(( "failed to create tar header for %s", name ));
+    return EINVAL;
+  }
+  int err = fd_snapshot_create_writer_append( create, w, meta, sizeof(fd_tar_meta_t), 0 );
+  if( FD_UNLIKELY( err ) ) return err;
+  if( !data ) return 0;
+  err = fd_snapshot_create_writer_append( create, w, data, sz, 0 );
+  if( FD_UNLIKELY( err ) ) return err;
+  ulong pad_sz = fd_ulong_align_up( sz, sizeof(fd_tar_meta_t) ) - sz;
+  return fd_snapshot_create_writer_append( create, w, fd_snapshot_create_zeros, pad_sz, 0 );
+}
+
+/* Accounts ***********************************************************/
+
+/* fd_snapshot_create_acc_sz returns the size of the account stored in
+   rec in an account vec. */
+
+static ulong
+fd_snapshot_create_acc_sz( fd_snapshot_create_t const * create,
+                           fd_funk_rec_t const *        rec ) {
+  fd_account_meta_t const * meta = fd_funk_val_const( rec, create->wksp );
+  return fd_ulong_align_up( sizeof(fd_solana_account_hdr_t) + meta->dlen, FD_SNAPSHOT_ACC_ALIGN );
+}
+
+/* fd_snapshot_create_collect gathers the accounts visible from txn and
+   partitions them into account vecs.  Returns 0 on success and an
+   errno compatible error code on failure. */
+
+static int
+fd_snapshot_create_collect( fd_snapshot_create_t * create,
+                            fd_exec_slot_ctx_t *   slot_ctx ) {
+
+  fd_acc_mgr_t *  acc_mgr = slot_ctx->acc_mgr;
+  fd_funk_t *     funk    = acc_mgr->funk;
+  fd_funk_txn_t * txn     = slot_ctx->funk_txn;
+  fd_wksp_t *     wksp    = fd_funk_wksp( funk );
+  fd_funk_rec_t * rec_map = fd_funk_rec_map( funk, wksp );
+
+  create->rec_cnt  = 0UL;
+  create->accv_cnt = 0UL;
+
+  /* A record is exported if it is the version of its account visible
+     from txn.  This picks the newest version across txn and its
+     ancestors and skips records of other forks. */
+
+  for( fd_funk_rec_map_iter_t iter = fd_funk_rec_map_iter_init( rec_map );
+       !fd_funk_rec_map_iter_done( rec_map, iter );
+       iter = fd_funk_rec_map_iter_next( rec_map, iter ) ) {
+    fd_funk_rec_t const * rec = fd_funk_rec_map_iter_ele_const( rec_map, iter );
+    if( !fd_funk_key_is_acc( rec->pair.key ) ) continue;
+    if( rec->flags & FD_FUNK_REC_FLAG_ERASE ) continue;
+    if( fd_funk_rec_query_global( funk, txn, rec->pair.key )!=rec ) continue;
+
+    fd_account_meta_t const * meta = fd_funk_val_const( rec, wksp );
+    if( FD_UNLIKELY( !meta || fd_funk_val_sz( rec )<sizeof(fd_account_meta_t) ) ) continue;
+    if( FD_UNLIKELY( meta->magic!=FD_ACCOUNT_META_MAGIC ) ) continue;
+    if( FD_UNLIKELY( fd_funk_val_sz( rec )<meta->hlen+meta->dlen ) ) {
+      FD_LOG_WARNING(( "account %32J is corrupt (val_sz=%lu hlen=%u dlen=%lu)",
+                       fd_funk_key_to_acc( rec->pair.key )->key, (ulong)fd_funk_val_sz( rec ), (uint)meta->hlen, meta->dlen ));
+      return EINVAL;
+    }
+    if( !meta->info.lamports ) continue; /* dead account */
+
+    create->recs[ create->rec_cnt++ ] = rec;
+  }
+
+  /* Partition into account vecs */
+
+  for( ulong i=0UL; i<create->rec_cnt; i++ ) {
+    ulong acc_sz = fd_snapshot_create_acc_sz( create, create->recs[ i ] );
+    fd_snapshot_create_accv_t * accv = create->accv_cnt ? &create->accvs[ create->accv_cnt-1UL ] : NULL;
+    if( !accv || accv->rec_cnt>=create->batch_acc_cnt || accv->sz+acc_sz>create->max_accv_sz ) {
+      accv = &create->accvs[ create->accv_cnt ];
+      accv->rec0    = i;
+      accv->rec_cnt = 0UL;
+      accv->sz      = 0UL;
+      accv->id      = create->id0 + create->accv_cnt;
+      create->accv_cnt++;
+    }
+    accv->rec_cnt++;
+    accv->sz += acc_sz;
+  }
+
+  return 0;
+}
+
+/* fd_snapshot_create_write_accv appends the tar record of the given
+   account vec to w as a single Zstandard frame. */
+
+static int
+fd_snapshot_create_write_accv( fd_snapshot_create_t *            create,
+                               fd_snapshot_create_writer_t *     w,
+                               fd_snapshot_create_accv_t const * accv ) {
+
+  char name[ FD_TAR_NAME_SZ ];
+  if( FD_UNLIKELY( !fd_cstr_printf_check( name, FD_TAR_NAME_SZ, NULL, "accounts/%lu.%lu", create->slot, accv->id ) ) )
+    return EINVAL;
+  int err = fd_snapshot_create_writer_file( create, w, name, NULL, accv->sz );
+  if( FD_UNLIKELY( err ) ) return err;
+
+  for( ulong i=0UL; i<accv->rec_cnt; i++ ) {
+    fd_funk_rec_t const *     rec  = create->recs[ accv->rec0 + i ];
+    fd_account_meta_t const * meta = fd_funk_val_const( rec, create->wksp );
+    uchar const *             data = (uchar const *)meta + meta->hlen;
+
+    fd_solana_account_hdr_t hdr[1];
+    fd_memset( hdr, 0, sizeof(fd_solana_account_hdr_t) );
+    hdr->meta.data_len = meta->dlen;
+    fd_memcpy( hdr->meta.pubkey, fd_funk_key_to_acc( rec->pair.key ), sizeof(fd_pubkey_t) );
+    fd_memcpy( &hdr->info, &meta->info, sizeof(fd_solana_account_meta_t) );
+    fd_memcpy( hdr->hash.hash, meta->hash, sizeof(fd_hash_t) );
+
+    ulong pad_sz = fd_ulong_align_up( meta->dlen, FD_SNAPSHOT_ACC_ALIGN ) - meta->dlen;
+    if( FD_UNLIKELY( (err = fd_snapshot_create_writer_append( create, w, hdr, sizeof(fd_solana_account_hdr_t), 0 )) ) ) return err;
+    if( FD_UNLIKELY( (err = fd_snapshot_create_writer_append( create, w, data, meta->dlen,                     0 )) ) ) return err;
+    if( FD_UNLIKELY( (err = fd_snapshot_create_writer_append( create, w, fd_snapshot_create_zeros, pad_sz,     0 )) ) ) return err;
+  }
+
+  ulong pad_sz = fd_ulong_align_up( accv->sz, sizeof(fd_tar_meta_t) ) - accv->sz;
+  return fd_snapshot_create_writer_append( create, w, fd_snapshot_create_zeros, pad_sz, 1 );
+}
+
+/* fd_snapshot_create_worker writes the account vecs assigned to w to
+   its temp file. */
+
+static int
+fd_snapshot_create_worker( fd_snapshot_create_t *        create,
+                           fd_snapshot_create_writer_t * w ) {
+
+  w->buf_sz  = 0UL;
+  w->file_sz = 0UL;
+  fd_zstd_cstream_reset( w->cstream );
+  if( FD_UNLIKELY( 0!=ftruncate( w->fd, 0L ) || lseek( w->fd, 0L, SEEK_SET )<0L ) ) {
+    FD_LOG_WARNING(( "failed to truncate temp file (%d-%s)", errno, fd_io_strerror( errno ) ));
+    return errno;
+  }
+
+  for( ulong i=w->accv0; i<w->accv1; i++ ) {
+    int err = fd_snapshot_create_write_accv( create, w, &create->accvs[ i ] );
+    if( FD_UNLIKELY( err ) ) return err;
+  }
+  return fd_snapshot_create_writer_flush( w );
+}
+
+#if FD_HAS_ATOMIC
+
+static void
+fd_snapshot_create_task( void * tpool,
+                         ulong  t0,     ulong t1,
+                         void * args,
+                         void * reduce, ulong stride,
+                         ulong  l0,     ulong l1,
+                         ulong  m0,     ulong m1,
+                         ulong  n0,     ulong n1 ) {
+  (void)t0; (void)t1; (void)args; (void)reduce; (void)stride;
+  (void)l0; (void)l1; (void)m1; (void)n0; (void)n1;
+  fd_snapshot_create_t *        create = (fd_snapshot_create_t *)tpool;
+  fd_snapshot_create_writer_t * w      = &create->workers[ m0 ];
+  w->err = fd_snapshot_create_worker( create, w );
+}
+
+#endif /* FD_HAS_ATOMIC */
+
+/* Status cache *******************************************************/
+
+/* The status cache file is a bincode Vec<BankSlotDelta>.  Each delta
+   is a rooted slot covered by the status cache of the bank (up to
+   MAX_CACHE_ENTRIES slots back) and holds a map
+
+     recent blockhash -> ( key_index, Vec<( key slice, Result<(),TransactionError> )> )
+
+   Each txn of the slot has an entry for its message hash and one for
+   its first signature.  Keys are truncated to CACHED_KEY_SIZE bytes
+   starting at key_index (always 0 here).  The status cache is built
+   from the blocks in the blockstore, walking parents from the snapshot
+   slot.  The walk stops at the first slot without block data (e.g.
+   the slot the runtime was booted from). */
+
+#define FD_SNAPSHOT_CREATE_STATUS_SLOT_MAX (300UL) /* MAX_CACHE_ENTRIES */
+#define FD_SNAPSHOT_CREATE_STATUS_KEY_SZ   (20UL)  /* CACHED_KEY_SIZE */
+
+struct fd_snapshot_create_status {
+  fd_hash_t blockhash;
+  uchar     msg_key[ FD_SNAPSHOT_CREATE_STATUS_KEY_SZ ];
+  uchar     sig_key[ FD_SNAPSHOT_CREATE_STATUS_KEY_SZ ];
+  ulong     err_off;  /* bincode TransactionError at errs+err_off */
+  ulong     err_sz;   /* 0 if the txn succeeded */
+};
+
+typedef struct fd_snapshot_create_status fd_snapshot_create_status_t;
+
+#define SORT_NAME        fd_snapshot_create_status_sort
+#define SORT_KEY_T       fd_snapshot_create_status_t
+#define SORT_BEFORE(a,b) (memcmp( (a).blockhash.hash, (b).blockhash.hash, sizeof(fd_hash_t) )<0)
+#include "../../util/tmpl/fd_sort.c"
+
+struct fd_snapshot_create_status_cache {
+  fd_valloc_t                   valloc;
+  ulong                         slot_cnt;
+  ulong                         slots [ FD_SNAPSHOT_CREATE_STATUS_SLOT_MAX    ];
+  ulong                         entry0[ FD_SNAPSHOT_CREATE_STATUS_SLOT_MAX+1UL ]; /* entries of slot i are [entry0[i],entry0[i+1]) */
+  fd_snapshot_create_status_t * entries;
+  ulong                         entry_cnt;
+  uchar *                       errs;
+  ulong                         errs_sz;
+  ulong                         errs_max;
+};
+
+typedef struct fd_snapshot_create_status_cache fd_snapshot_create_status_cache_t;
+
+/* fd_snapshot_create_status_err appends the TransactionError of a txn
+   recorded in the blockstore txn metadata meta to cache->errs.  Txns
+   without metadata are taken as succeeded. */
+
+static int
+fd_snapshot_create_status_err( fd_snapshot_create_status_cache_t * cache,
+                               fd_snapshot_create_status_t *       status,
+                               fd_blockstore_t *                   blockstore,
+                               fd_blockstore_txn_map_t const *     meta ) {
+  status->err_off = cache->errs_sz;
+  status->err_sz  = 0UL;
+  if( !meta || !meta->meta_gaddr ) return 0;
+
+  fd_solblock_TransactionStatusMeta txn_status = {0};
+  pb_istream_t stream = pb_istream_from_buffer( fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), meta->meta_gaddr ), meta->meta_sz );
+  if( FD_UNLIKELY( !pb_decode( &stream, fd_solblock_TransactionStatusMeta_fields, &txn_status ) ) ) {
+    FD_LOG_WARNING(( "failed to decode txn status (%s)", PB_GET_ERROR( &stream ) ));
+    return 0;
+  }
+
+  int err = 0;
+  if( txn_status.has_err && txn_status.err.err ) {
+    ulong sz = txn_status.err.err->size;
+    if( cache->errs_sz+sz > cache->errs_max ) {
+      ulong   errs_max = fd_ulong_max( 2UL*cache->errs_max, cache->errs_sz+sz );
+      uchar * errs     = fd_valloc_malloc( cache->valloc, 1UL, errs_max );
+      if( FD_UNLIKELY( !errs ) ) {
+        err = ENOMEM;
+        goto done;
+      }
+      if( cache->errs ) {
+        fd_memcpy( errs, cache->errs, cache->errs_sz );
+        fd_valloc_free( cache->valloc, cache->errs );
+      }
+      cache->errs     = errs;
+      cache->errs_max = errs_max;
+    }
+    fd_memcpy( cache->errs + cache->errs_sz, txn_status.err.err->bytes, sz );
+    cache->errs_sz += sz;
+    status->err_sz  = sz;
+  }
+
+done:
+  pb_release( fd_solblock_TransactionStatusMeta_fields, &txn_status );
+  return err;
+}
+
+/* fd_snapshot_create_status_collect gathers the txn statuses of the
+   slots of the status cache from blockstore.  The caller holds a read
+   lock on blockstore. */
+
+static int
+fd_snapshot_create_status_collect( fd_snapshot_create_status_cache_t * cache,
+                                   fd_blockstore_t *                   blockstore,
+                                   ulong                               slot ) {
+
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+
+  /* Find the slots and bound the number of txns */
+
+  ulong txn_max = 0UL;
+  for( ulong s=slot; cache->slot_cnt<FD_SNAPSHOT_CREATE_STATUS_SLOT_MAX; ) {
+    fd_block_t * block = fd_blockstore_block_query( blockstore, s );
+    if( !block || block->data_gaddr==ULONG_MAX ) break;
+    cache->slots[ cache->slot_cnt++ ] = s;
+    txn_max += block->txns_cnt;
+    ulong parent = fd_blockstore_parent_slot_query( blockstore, s );
+    if( parent==FD_SLOT_NULL || parent>=s ) break;
+    s = parent;
+  }
+  if( txn_max ) {
+    cache->entries = fd_valloc_malloc( cache->valloc, alignof(fd_snapshot_create_status_t), txn_max*sizeof(fd_snapshot_create_status_t) );
+    if( FD_UNLIKELY( !cache->entries ) ) return ENOMEM;
+  }
+
+  fd_blake3_t blake3[1];
+  for( ulong i=0UL; i<cache->slot_cnt; i++ ) {
+    fd_block_t *               block = fd_blockstore_block_query( blockstore, cache->slots[ i ] );
+    uchar const *              data  = fd_wksp_laddr_fast( wksp, block->data_gaddr );
+    fd_block_txn_ref_t const * refs  = fd_wksp_laddr_fast( wksp, block->txns_gaddr );
+
+    cache->entry0[ i ] = cache->entry_cnt;
+    for( ulong j=0UL; j<block->txns_cnt; j++ ) {
+      if( j && refs[ j ].txn_off==refs[ j-1UL ].txn_off ) continue; /* one ref per signature */
+
+      uchar const * raw = data + refs[ j ].txn_off;
+      uchar         txn_buf[ FD_TXN_MAX_SZ ];
+      if( FD_UNLIKELY( !fd_txn_parse( raw, refs[ j ].sz, txn_buf, NULL ) ) ) {
+        FD_LOG_WARNING(( "failed to parse txn at offset %lu of slot %lu", refs[ j ].txn_off, cache->slots[ i ] ));
+        return EINVAL;
+      }
+      fd_txn_t const * txn = (fd_txn_t const *)txn_buf;
+
+      fd_snapshot_create_status_t * status = &cache->entries[ cache->entry_cnt++ ];
+      fd_memcpy( status->blockhash.hash, raw + txn->recent_blockhash_off, sizeof(fd_hash_t) );
+
+      fd_hash_t msg_hash[1];
+      fd_blake3_init( blake3 );
+      fd_blake3_append( blake3, "solana-tx-message-v1", 20UL );
+      fd_blake3_append( blake3, raw + txn->message_off, refs[ j ].sz - txn->message_off );
+      fd_blake3_fini( blake3, msg_hash->hash );
+      fd_memcpy( status->msg_key, msg_hash->hash,           FD_SNAPSHOT_CREATE_STATUS_KEY_SZ );
+      fd_memcpy( status->sig_key, raw + txn->signature_off, FD_SNAPSHOT_CREATE_STATUS_KEY_SZ );
+
+      int err = fd_snapshot_create_status_err( cache, status, blockstore, fd_blockstore_txn_query( blockstore, raw + txn->signature_off ) );
+      if( FD_UNLIKELY( err ) ) return err;
+    }
+  }
+  cache->entry0[ cache->slot_cnt ] = cache->entry_cnt;
+  return 0;
+}
+
+/* fd_snapshot_create_status_encode encodes the status cache.  If buf is
+   NULL, only returns the encoded size.  Entries of each slot must be
+   sorted by recent blockhash. */
+
+static ulong
+fd_snapshot_create_status_encode( fd_snapshot_create_status_cache_t const * cache,
+                                  uchar *                                   buf,
+                                  ulong                                     buf_sz ) {
+
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+buf_sz };
+  ulong sz = 0UL;
+# define ENCODE( name, type, val ) do {                                    \
+    sz += sizeof(type);                                                    \
+    if( buf ) FD_TEST( !fd_bincode_##name##_encode( (val), &encode ) );    \
+  } while(0)
+# define ENCODE_BYTES( ptr, n ) do {                                       \
+    sz += (n);                                                             \
+    if( buf ) FD_TEST( !fd_bincode_bytes_encode( (ptr), (n), &encode ) );  \
+  } while(0)
+  ENCODE( uint64, ulong, cache->slot_cnt );
+  for( ulong i=0UL; i<cache->slot_cnt; i++ ) {
+    fd_snapshot_create_status_t const * e0 = cache->entries + cache->entry0[ i     ];
+    fd_snapshot_create_status_t const * e1 = cache->entries + cache->entry0[ i+1UL ];
+
+    ulong group_cnt = 0UL;
+    for( fd_snapshot_create_status_t const * e=e0; e<e1; e++ ) {
+      group_cnt += ( e==e0 || !!memcmp( e->blockhash.hash, e[-1].blockhash.hash, sizeof(fd_hash_t) ) );
+    }
+
+    ENCODE( uint64, ulong, cache->slots[ i ] );
+    ENCODE( uint8,  uchar, 1 );                  /* is_root */
+    ENCODE( uint64, ulong, group_cnt );
+    for( fd_snapshot_create_status_t const * g0=e0; g0<e1; ) {
+      fd_snapshot_create_status_t const * g1 = g0+1;
+      while( g1<e1 && !memcmp( g1->blockhash.hash, g0->blockhash.hash, sizeof(fd_hash_t) ) ) g1++;
+
+      ENCODE_BYTES( g0->blockhash.hash, sizeof(fd_hash_t) );
+      ENCODE( uint64, ulong, 0UL );              /* key_index */
+      ENCODE( uint64, ulong, 2UL*(ulong)(g1-g0) );
+      for( fd_snapshot_create_status_t const * e=g0; e<g1; e++ ) {
+        for( ulong k=0UL; k<2UL; k++ ) {
+          ENCODE_BYTES( k ? e->sig_key : e->msg_key, FD_SNAPSHOT_CREATE_STATUS_KEY_SZ );
+          ENCODE( uint32, uint,  e->err_sz ? 1U : 0U );  /* Result::{Ok,Err} */
+          if( e->err_sz ) ENCODE_BYTES( cache->errs + e->err_off, e->err_sz );
+        }
+      }
+      g0 = g1;
+    }
+  }
+
+# undef ENCODE
+# undef ENCODE_BYTES
+  return sz;
+}
+
+/* fd_snapshot_create_write_status_cache appends the status cache of
+   slot_ctx to w. */
+
+static int
+fd_snapshot_create_write_status_cache( fd_snapshot_create_t *        create,
+                                       fd_snapshot_create_writer_t * w,
+                                       fd_exec_slot_ctx_t *          slot_ctx ) {
+
+  fd_snapshot_create_status_cache_t cache[1];
+  fd_memset( cache, 0, sizeof(fd_snapshot_create_status_cache_t) );
+  cache->valloc = slot_ctx->valloc;
+
+  int     err = 0;
+  uchar * buf = NULL;
+
+  fd_blockstore_t * blockstore = slot_ctx->blockstore;
+  if( blockstore ) {
+    fd_blockstore_start_read( blockstore );
+    err = fd_snapshot_create_status_collect( cache, blockstore, create->slot );
+    fd_blockstore_end_read( blockstore );
+    if( FD_UNLIKELY( err ) ) goto done;
+  }
+
+  for( ulong i=0UL; i<cache->slot_cnt; i++ ) {
+    fd_snapshot_create_status_sort_inplace( cache->entries + cache->entry0[ i ], cache->entry0[ i+1UL ] - cache->entry0[ i ] );
+  }
+
+  ulong sz = fd_snapshot_create_status_encode( cache, NULL, 0UL );
+  buf = fd_valloc_malloc( cache->valloc, 1UL, sz );
+  if( FD_UNLIKELY( !buf ) ) {
+    err = ENOMEM;
+    goto done;
+  }
+  fd_snapshot_create_status_encode( cache, buf, sz );
+  err = fd_snapshot_create_writer_file( create, w, "snapshots/status_cache", buf, sz );
+
+done:
+  if( buf            ) fd_valloc_free( cache->valloc, buf            );
+  if( cache->entries ) fd_valloc_free( cache->valloc, cache->entries );
+  if( cache->errs    ) fd_valloc_free( cache->valloc, cache->errs    );
+  if( FD_UNLIKELY( err==ENOMEM ) ) FD_LOG_WARNING(( "out of memory while creating status cache" ));
+  return err;
+}
+
+/* Manifest ***********************************************************/
+
+/* fd_snapshot_create_tick_height derives the tick height of the bank of
+   slot_ctx from the ticks of its block in the blockstore.  A snapshot
+   can only be taken of a complete bank, whose tick height is its max
+   tick height.  Returns EINVAL if the block is known to be incomplete.
+   Without a block (e.g. the bank was booted from a snapshot), the bank
+   is assumed to be complete. */
+
+static int
+fd_snapshot_create_tick_height( fd_exec_slot_ctx_t * slot_ctx,
+                                ulong *              tick_height_out ) {
+
+  fd_slot_bank_t const * slot_bank      = &slot_ctx->slot_bank;
+  ulong                  ticks_per_slot = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx )->ticks_per_slot;
+  ulong                  tick_height    = slot_bank->max_tick_height;
+
+  fd_blockstore_t * blockstore = slot_ctx->blockstore;
+  if( blockstore ) {
+    fd_blockstore_start_read( blockstore );
+    fd_block_t * block = fd_blockstore_block_query( blockstore, slot_bank->slot );
+    if( block && block->data_gaddr!=ULONG_MAX ) {
+      /* The block of a slot has the ticks of the skipped slots
+         between its parent and itself */
+      fd_wksp_t *              wksp   = fd_blockstore_wksp( blockstore );
+      uchar const *            data   = fd_wksp_laddr_fast( wksp, block->data_gaddr );
+      fd_block_micro_t const * micros = fd_wksp_laddr_fast( wksp, block->micros_gaddr );
+      ulong ticks = 0UL;
+      for( ulong i=0UL; i<block->micros_cnt; i++ ) {
+        fd_microblock_hdr_t const * hdr = (fd_microblock_hdr_t const *)( data + micros[ i ].off );
+        ticks += !hdr->txn_cnt;
+      }
+      ulong slot_cnt = slot_bank->slot - slot_bank->prev_slot;
+      tick_height = slot_bank->max_tick_height - fd_ulong_min( slot_cnt*ticks_per_slot, slot_bank->max_tick_height ) + ticks;
+    }
+    fd_blockstore_end_read( blockstore );
+  }
+
+  if( FD_UNLIKELY( tick_height!=slot_bank->max_tick_height ) ) {
+    FD_LOG_WARNING(( "bank of slot %lu is not complete (tick_height=%lu max_tick_height=%lu)",
+                     slot_bank->slot, tick_height, slot_bank->max_tick_height ));
+    return EINVAL;
+  }
+  *tick_height_out = tick_height;
+  return 0;
+}
+
+
+/* fd_snapshot_create_write_manifest appends the snapshot manifest of
+   slot_ctx to w.  This is the inverse of fd_exec_slot_ctx_recover. */
+
+static int
+fd_snapshot_create_write_manifest( fd_snapshot_create_t *        create,
+                                   fd_snapshot_create_writer_t * w,
+                                   fd_exec_slot_ctx_t *          slot_ctx ) {
+
+  fd_valloc_t       valloc     = slot_ctx->valloc;
+  fd_slot_bank_t *  slot_bank  = &slot_ctx->slot_bank;
+  fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx );
+  ulong             epoch      = fd_slot_to_epoch( &epoch_bank->epoch_schedule, slot_bank->slot, NULL );
+
+  fd_solana_manifest_t manifest[1];
+  fd_memset( manifest, 0, sizeof(fd_solana_manifest_t) );
+
+  int                       err      = ENOMEM;
+  uchar *                   buf      = NULL;
+  fd_hash_hash_age_pair_t * ages     = NULL;
+  fd_snapshot_acc_vec_t *   acc_vecs = NULL;
+
+  /* Bank */
+
+  ulong tick_height;
+  err = fd_snapshot_create_tick_height( slot_ctx, &tick_height );
+  if( FD_UNLIKELY( err ) ) return err;
+  err = ENOMEM;
+
+  fd_deserializable_versioned_bank_t * bank = &manifest->bank;
+
+  fd_block_hash_queue_t * bhq = &slot_bank->block_hash_queue;
+  ulong ages_cnt = bhq->ages_root ? fd_hash_hash_age_pair_t_map_size( bhq->ages_pool, bhq->ages_root ) : 0UL;
+  if( ages_cnt ) {
+    ages = fd_valloc_malloc( valloc, alignof(fd_hash_hash_age_pair_t), ages_cnt*sizeof(fd_hash_hash_age_pair_t) );
+    if( FD_UNLIKELY( !ages ) ) goto done;
+    ulong i = 0UL;
+    for( fd_hash_hash_age_pair_t_mapnode_t * n = fd_hash_hash_age_pair_t_map_minimum( bhq->ages_pool, bhq->ages_root );
+         n;
+         n = fd_hash_hash_age_pair_t_map_successor( bhq->ages_pool, n ) ) {
+      ages[ i++ ] = n->elem;
+    }
+  }
+  bank->blockhash_queue.last_hash_index = bhq->last_hash_index;
+  bank->blockhash_queue.last_hash       = bhq->last_hash;
+  bank->blockhash_queue.ages_len        = ages_cnt;
+  bank->blockhash_queue.ages            = ages;
+  bank->blockhash_queue.max_age         = bhq->max_age;
+
+  bank->hard_forks            = slot_bank->hard_forks;  /* shallow copy, not destroyed */
+  bank->hash                  = slot_bank->banks_hash;
+  bank->parent_slot           = slot_bank->prev_slot;
+  bank->transaction_count     = slot_bank->transaction_count;
+  bank->tick_height           = tick_height;
+  bank->capitalization        = slot_bank->capitalization;
+  bank->max_tick_height       = slot_bank->max_tick_height;
+  bank->hashes_per_tick       = &epoch_bank->hashes_per_tick;
+  bank->ticks_per_slot        = epoch_bank->ticks_per_slot;
+  bank->ns_per_slot           = epoch_bank->ns_per_slot;
+  bank->genesis_creation_time = epoch_bank->genesis_creation_time;
+  bank->slots_per_year        = epoch_bank->slots_per_year;
+  bank->slot                  = slot_bank->slot;
+  bank->epoch                 = epoch;
+  bank->block_height          = slot_bank->block_height;
+  bank->collector_fees        = slot_bank->collected_fees;
+  bank->fee_calculator.lamports_per_signature = slot_bank->lamports_per_signature;
+  bank->fee_rate_governor     = slot_bank->fee_rate_governor;
+  bank->collected_rent        = slot_bank->collected_rent;
+  bank->rent_collector.epoch          = epoch;
+  bank->rent_collector.epoch_schedule = epoch_bank->epoch_schedule;
+  bank->rent_collector.slots_per_year = epoch_bank->slots_per_year;
+  bank->rent_collector.rent           = epoch_bank->rent;
+  bank->epoch_schedule        = epoch_bank->epoch_schedule;
+  bank->inflation             = epoch_bank->inflation;
+  bank->stakes                = epoch_bank->stakes;  /* shallow copy, not destroyed */
+
+  /* Recover expects the EpochStakes of the current and the next epoch */
+
+  fd_epoch_epoch_stakes_pair_t epoch_stakes[2];
+  fd_memset( epoch_stakes, 0, sizeof(epoch_stakes) );
+  fd_vote_accounts_t const * vote_accounts[2] = { &slot_bank->epoch_stakes, &epoch_bank->next_epoch_stakes };
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_vote_accounts_t const * va = vote_accounts[ i ];
+    epoch_stakes[ i ].key                        = epoch + i;
+    epoch_stakes[ i ].value.stakes.vote_accounts = *va;
+    epoch_stakes[ i ].value.stakes.epoch         = epoch + i;
+    ulong total_stake = 0UL;
+    if( va->vote_accounts_root ) {
+      for( fd_vote_accounts_pair_t_mapnode_t * n = fd_vote_accounts_pair_t_map_minimum( va->vote_accounts_pool, va->vote_accounts_root );
+           n;
+           n = fd_vote_accounts_pair_t_map_successor( va->vote_accounts_pool, n ) ) {
+        total_stake += n->elem.stake;
+      }
+    }
+    epoch_stakes[ i ].value.total_stake = total_stake;
+  }
+  bank->epoch_stakes_len = 2UL;
+  bank->epoch_stakes     = epoch_stakes;
+
+  /* AccountsDb */
+
+  fd_snapshot_slot_acc_vecs_t storage[1];
+  if( create->accv_cnt ) {
+    acc_vecs = fd_valloc_malloc( valloc, alignof(fd_snapshot_acc_vec_t), create->accv_cnt*sizeof(fd_snapshot_acc_vec_t) );
+    if( FD_UNLIKELY( !acc_vecs ) ) goto done;
+    for( ulong i=0UL; i<create->accv_cnt; i++ ) {
+      acc_vecs[ i ].id      = create->accvs[ i ].id;
+      acc_vecs[ i ].file_sz = create->accvs[ i ].sz;
+    }
+    storage->slot             = create->slot;
+    storage->account_vecs_len = create->accv_cnt;
+    storage->account_vecs     = acc_vecs;
+    manifest->accounts_db.storages_len = 1UL;
+    manifest->accounts_db.storages     = storage;
+  }
+  manifest->accounts_db.version             = 1UL;
+  manifest->accounts_db.slot                = create->slot;
+  manifest->accounts_db.bank_hash_info.hash = slot_bank->banks_hash;
+
+  manifest->lamports_per_signature = slot_bank->lamports_per_signature;
+  manifest->epoch_account_hash     = &slot_bank->epoch_account_hash;
+
+  /* Serialize */
+
+  ulong sz = fd_solana_manifest_size( manifest );
+  buf = fd_valloc_malloc( valloc, 1UL, sz );
+  if( FD_UNLIKELY( !buf ) ) goto done;
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sz };
+  if( FD_UNLIKELY( fd_solana_manifest_encode( manifest, &encode )!=FD_BINCODE_SUCCESS ) ) {
+    FD_LOG_WARNING(( "failed to encode manifest" ));
+    err = EINVAL;
+    goto done;
+  }
+
+  char name[ FD_TAR_NAME_SZ ];
+  FD_TEST( fd_cstr_printf_check( name, FD_TAR_NAME_SZ, NULL, "snapshots/%lu/%lu", create->slot, create->slot ) );
+  err = fd_snapshot_create_writer_file( create, w, name, buf, sz );
+
+done:
+  if( acc_vecs ) fd_valloc_free( valloc, acc_vecs );
+  if( ages     ) fd_valloc_free( valloc, ages     );
+  if( buf      ) fd_valloc_free( valloc, buf      );
+  if( FD_UNLIKELY( err==ENOMEM ) ) FD_LOG_WARNING(( "out of memory while creating manifest" ));
+  return err;
+}
+
+/* Create *************************************************************/
+
+/* fd_snapshot_create_append_file copies the content of the temp file
+   of worker src to the output file through dst's buffer. */
+
+static int
+fd_snapshot_create_append_file( fd_snapshot_create_writer_t *       dst,
+                                fd_snapshot_create_writer_t const * src,
+                                ulong                               buf_max ) {
+  if( FD_UNLIKELY( lseek( src->fd, 0L, SEEK_SET )<0L ) ) {
+    FD_LOG_WARNING(( "lseek failed (%d-%s)", errno, fd_io_strerror( errno ) ));
+    return errno;
+  }
+  ulong rem = src->file_sz;
+  while( rem ) {
+    ulong chunk = fd_ulong_min( rem, buf_max );
+    ulong rsz;
+    int err = fd_io_read( src->fd, dst->buf, chunk, chunk, &rsz );
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "read failed (%d-%s)", err, err<0 ? "unexpected EOF" : fd_io_strerror( err ) ));
+      return err<0 ? EIO : err;
+    }
+    dst->buf_sz = rsz;
+    err = fd_snapshot_create_writer_flush( dst );
+    if( FD_UNLIKELY( err ) ) return err;
+    rem -= rsz;
+  }
+  return 0;
+}
+
+int
+fd_snapshot_create_tpool( fd_snapshot_create_t * create,
+                          fd_exec_slot_ctx_t *   slot_ctx,
+                          fd_tpool_t *           tpool,
+                          ulong                  max_workers ) {
+
+  if( FD_UNLIKELY( !create || create->magic!=FD_SNAPSHOT_CREATE_MAGIC ) ) {
+    FD_LOG_WARNING(( "invalid create object" ));
+    return 0;
+  }
+  if( FD_UNLIKELY( !slot_ctx ) ) {
+    FD_LOG_WARNING(( "NULL slot_ctx" ));
+    return 0;
+  }
+
+  long dt = -fd_log_wallclock();
+
+  create->slot  = slot_ctx->slot_bank.slot;
+  create->mtime = (ulong)fd_log_wallclock() / (ulong)1e9;
+  create->wksp  = fd_funk_wksp( slot_ctx->acc_mgr->funk );
+
+  if( FD_UNLIKELY( fd_snapshot_create_collect( create, slot_ctx ) ) ) return 0;
+
+  /* Assign contiguous ranges of account vecs to workers */
+
+  ulong worker_cnt = 1UL;
+# if FD_HAS_ATOMIC
+  if( tpool ) worker_cnt = fd_ulong_max( fd_ulong_min( create->worker_cnt, max_workers ), 1UL );
+# else
+  (void)tpool; (void)max_workers;
+# endif
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    fd_snapshot_create_writer_t * w = &create->workers[ i ];
+    FD_TPOOL_PARTITION( 0UL, create->accv_cnt, 1UL, i, worker_cnt, w->accv0, w->accv1 );
+  }
+
+  /* The output file starts with a frame holding the version file, the
+     status cache and the manifest.  Worker 0's compressor
+     is borrowed for the frames written directly to the output file. */
+
+  fd_snapshot_create_writer_t out[1];
+  *out         = create->workers[ 0 ];
+  out->fd      = create->fd;
+  out->buf_sz  = 0UL;
+  out->file_sz = 0UL;
+  fd_zstd_cstream_reset( out->cstream );
+  if( FD_UNLIKELY( 0!=ftruncate( out->fd, 0L ) || lseek( out->fd, 0L, SEEK_SET )<0L ) ) {
+    FD_LOG_WARNING(( "failed to truncate %s (%d-%s)", create->tmp_path, errno, fd_io_strerror( errno ) ));
+    return 0;
+  }
+
+  if( FD_UNLIKELY( fd_snapshot_create_writer_file( create, out, "version", FD_SNAPSHOT_CREATE_VERSION, sizeof(FD_SNAPSHOT_CREATE_VERSION)-1UL ) ) ) return 0;
+  if( FD_UNLIKELY( fd_snapshot_create_write_status_cache( create, out, slot_ctx ) ) ) return 0;
+  if( FD_UNLIKELY( fd_snapshot_create_write_manifest( create, out, slot_ctx ) ) ) return 0;
+  if( FD_UNLIKELY( fd_snapshot_create_writer_append( create, out, NULL, 0UL, 1 ) ) ) return 0;
+  if( FD_UNLIKELY( fd_snapshot_create_writer_flush( out ) ) ) return 0;
+
+  /* Serialize account vecs */
+
+# if FD_HAS_ATOMIC
+  if( worker_cnt>1UL ) {
+    fd_tpool_exec_all_rrobin( tpool, 0UL, worker_cnt, fd_snapshot_create_task, create, NULL, NULL, 1UL, 0UL, worker_cnt );
+  } else
+# endif
+  {
+    create->workers[ 0 ].err = fd_snapshot_create_worker( create, &create->workers[ 0 ] );
+  }
+
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    if( FD_UNLIKELY( create->workers[ i ].err ) ) {
+      FD_LOG_WARNING(( "snapshot worker %lu failed (%d-%s)", i, create->workers[ i ].err, fd_io_strerror( create->workers[ i ].err ) ));
+      return 0;
+    }
+  }
+
+  /* Concatenate worker files and close the tar */
+
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    if( FD_UNLIKELY( fd_snapshot_create_append_file( out, &create->workers[ i ], create->compress_bufsz ) ) ) return 0;
+  }
+  fd_zstd_cstream_reset( out->cstream );
+  if( FD_UNLIKELY( fd_snapshot_create_writer_append( create, out, fd_snapshot_create_zeros, sizeof(fd_snapshot_create_zeros), 1 ) ) ) return 0;
+  if( FD_UNLIKELY( fd_snapshot_create_writer_flush( out ) ) ) return 0;
+
+  if( FD_UNLIKELY( 0!=fsync( create->fd ) ) ) {
+    FD_LOG_WARNING(( "fsync(%s) failed (%d-%s)", create->tmp_path, errno, fd_io_strerror( errno ) ));
+    return 0;
+  }
+  if( FD_UNLIKELY( 0!=rename( create->tmp_path, create->snap_path ) ) ) {
+    FD_LOG_WARNING(( "rename(%s,%s) failed (%d-%s)", create->tmp_path, create->snap_path, errno, fd_io_strerror( errno ) ));
+    return 0;
+  }
+
+  /* Start over with a new output file, such that creating another
+     snapshot does not clobber this one */
+
+  close( create->fd );
+  create->fd = open( create->tmp_path, O_CREAT|O_TRUNC|O_RDWR, 0644 );
+  if( FD_UNLIKELY( create->fd<0 ) )
+    FD_LOG_ERR(( "open(%s) failed (%d-%s)", create->tmp_path, errno, fd_io_strerror( errno ) ));
+
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "created snapshot %s at slot %lu (%lu accounts in %lu account vecs, %lu workers, %lu bytes, %.3f s)",
+                  create->snap_path, create->slot, create->rec_cnt, create->accv_cnt, worker_cnt, out->file_sz, (double)dt/1e9 ));
+  return 1;
+}
+
+int
+fd_snapshot_create( fd_snapshot_create_t * create,
+                    fd_exec_slot_ctx_t *   slot_ctx ) {
+  return fd_snapshot_create_tpool( create, slot_ctx, NULL, 0UL );
+}
@@ -2,10 +2,25 @@
 #define HEADER_fd_src_flamenco_snapshot_fd_snapshot_create_h
 
 /* fd_snapshot_create.h provides APIs for creating a Labs-compatible
-   snapshot from a slot execution context. */
-
-#include "../fd_flamenco_base.h"
+   snapshot from a slot execution context.
+
+   The snapshot is a .tar.zst stream made of concatenated Zstandard
+   frames (which is itself a valid Zstandard stream).  The first frame
+   holds the version file, the status cache and the manifest.  Then
+   there is one frame per account vec, and a final frame holding the
+   tar EOF marker.  Account vecs are serialized and compressed in
+   parallel: each worker handles a disjoint range of account vecs and
+   writes its frames to its own temporary file.  Once all workers are
+   done, the temporary files are concatenated in order into the
+   snapshot file.
+
+   The accounts written are the ones visible from the slot context's
+   funk transaction, read directly from the funk workspace.  Erased and
+   zero-lamport accounts are left out. */
+
+#include "fd_snapshot_base.h"
 #include "../runtime/context/fd_exec_slot_ctx.h"
+#include "../../util/tpool/fd_tpool.h"
 
 struct fd_snapshot_create_private;
 typedef struct fd_snapshot_create_private fd_snapshot_create_t;
@@ -15,12 +30,14 @@ FD_PROTOTYPES_BEGIN
 /* fd_snapshot_create_{align,footprint} return required memory region
    parameters for the fd_snapshot_create_t object.
 
-   worker_cnt is the number of workers for parallel snapshot create
-   (treated as 1UL parallel mode not available). compress_lvl is the
+   worker_cnt is the max number of workers for parallel snapshot create
+   (in [1,FD_TILE_MAX]).  Each worker has its own compressor, write
+   buffer and temporary file.  compress_lvl is the
    Zstandard compression level.  compress_bufsz is the in-memory buffer
    for writes (larger buffers results in less frequent but larger write
    ops).  funk_rec_cnt is the number of slots in the funk rec hashmap.
-   batch_acc_cnt is the max number of accounts per account vec.
+   batch_acc_cnt is the max number of accounts per account vec.  Returns
+   0 if any parameter is invalid.
 
    Resulting footprint approximates
 
@@ -43,9 +60,11 @@ fd_snapshot_create_footprint( ulong worker_cnt,
    the final snapshot path.  May create temporary files adject to
    snap_path.  {worker_cnt,compress_lvl,compress_bufsz,funk_rec_cnt,
    batch_acc_cnt} must match arguments to footprint when mem was
-   created.  On failure, returns NULL. Reasons for failure include
-   invalid memory region or invalid file descriptor.  Logs reasons for
-   failure. */
+   created.  max_accv_sz is the target max size of an account vec in
+   bytes (account vecs holding a single larger account may exceed it).
+   rng is used to pick account vec ids.  On failure, returns NULL.
+   Reasons for failure include invalid memory region or invalid file
+   descriptor.  Logs reasons for failure. */
 
 fd_snapshot_create_t *
 fd_snapshot_create_new( void *               mem,
@@ -60,20 +79,41 @@ fd_snapshot_create_new( void *               mem,
                         fd_rng_t *           rng );
 
 /* fd_snapshot_create_delete destroys the given snapshot create object
-   and frees any resources.  Returns memory region and fd back to caller. */
+   and frees any resources (closes and removes temporary files).
+   Returns memory region back to caller. */
 
 void *
 fd_snapshot_create_delete( fd_snapshot_create_t * create );
 
 /* fd_snapshot_create exports the 'snapshot manifest' and a copy of all
    accounts from the slot ctx that the create object is attached to.
-   Writes a .tar.zst stream out to the fd.  Returns 1 on success, and
-   0 on failure.  Reason for failure is logged. */
+   Writes a .tar.zst stream to snap_path (via a temporary file which is
+   renamed on success).  Returns 1 on success, and 0 on failure.
+   Reason for failure is logged.
+
+   Accounts are those visible from slot_ctx->funk_txn.  Accounts with
+   zero lamports are not exported.  The funk must not be modified
+   while the snapshot is created.  The bank of slot_ctx must be
+   complete (i.e. have all the ticks of its slot).  The status cache
+   is built from the blocks of slot_ctx->blockstore (if any), under
+   its read lock.  Same as fd_snapshot_create_tpool with no tpool, i.e.
+   runs a single worker on the caller. */
 
 int
 fd_snapshot_create( fd_snapshot_create_t * create,
                     fd_exec_slot_ctx_t *   slot_ctx );
 
+/* fd_snapshot_create_tpool is fd_snapshot_create with account vecs
+   serialized on tpool threads [0,max_workers).  The caller masquerades
+   as thread 0.  At most the worker_cnt given to fd_snapshot_create_new
+   workers are used. */
+
+int
+fd_snapshot_create_tpool( fd_snapshot_create_t * create,
+                          fd_exec_slot_ctx_t *   slot_ctx,
+                          fd_tpool_t *           tpool,
+                          ulong                  max_workers );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_snapshot_fd_snapshot_create_h */
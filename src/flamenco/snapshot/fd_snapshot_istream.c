@@ -70,6 +70,389 @@ fd_io_istream_zstd_read( void *  _this,
 fd_io_istream_vt_t const fd_io_istream_zstd_vt =
   { .read = fd_io_istream_zstd_read };
 
+/* fd_io_istream_zstd_para_t ******************************************/
+
+ulong
+fd_io_istream_zstd_para_align( void ) {
+  return fd_ulong_max( alignof(fd_io_istream_zstd_para_t), fd_zstd_dstream_align() );
+}
+
+ulong
+fd_io_istream_zstd_para_footprint( ulong slot_cnt,
+                                   ulong window_sz,
+                                   ulong in_max,
+                                   ulong out_max ) {
+  if( FD_UNLIKELY( (!slot_cnt) | (slot_cnt>FD_TILE_MAX) | (!in_max) | (out_max<2UL) | (out_max&1UL) ) ) return 0UL;
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof(fd_io_istream_zstd_para_t),      sizeof(fd_io_istream_zstd_para_t)                );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_io_istream_zstd_para_slot_t), slot_cnt*sizeof(fd_io_istream_zstd_para_slot_t) );
+  l = FD_LAYOUT_APPEND( l, 1UL,                                     in_max                                           );
+  for( ulong i=0UL; i<slot_cnt; i++ ) {
+    l = FD_LAYOUT_APPEND( l, fd_zstd_dstream_align(), fd_zstd_dstream_footprint( window_sz ) );
+    l = FD_LAYOUT_APPEND( l, 1UL,                     out_max                                );
+  }
+  return FD_LAYOUT_FINI( l, fd_io_istream_zstd_para_align() );
+}
+
+fd_io_istream_zstd_para_t *
+fd_io_istream_zstd_para_new( void *              mem,
+                             fd_tpool_t *        tpool,
+                             ulong               t0,
+                             ulong               t1,
+                             ulong               window_sz,
+                             ulong               in_max,
+                             ulong               out_max,
+                             fd_io_istream_obj_t src ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_io_istream_zstd_para_align() ) ) ) {
+    FD_LOG_WARNING(( "unaligned mem" ));
+    return NULL;
+  }
+
+  if( tpool ) {
+    if( FD_UNLIKELY( (!t0) | (t0>=t1) | (t1>fd_tpool_worker_cnt( tpool )) ) ) {
+      FD_LOG_WARNING(( "bad worker range [%lu,%lu)", t0, t1 ));
+      return NULL;
+    }
+  } else {
+    t0 = 0UL; t1 = 1UL;
+  }
+  ulong slot_cnt = t1-t0;
+
+  if( FD_UNLIKELY( !fd_io_istream_zstd_para_footprint( slot_cnt, window_sz, in_max, out_max ) ) ) {
+    FD_LOG_WARNING(( "bad params" ));
+    return NULL;
+  }
+
+  FD_SCRATCH_ALLOC_INIT( l, mem );
+  fd_io_istream_zstd_para_t *      this   = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_io_istream_zstd_para_t),      sizeof(fd_io_istream_zstd_para_t)                );
+  fd_io_istream_zstd_para_slot_t * slot   = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_io_istream_zstd_para_slot_t), slot_cnt*sizeof(fd_io_istream_zstd_para_slot_t) );
+  uchar *                          in_buf = FD_SCRATCH_ALLOC_APPEND( l, 1UL,                                     in_max                                           );
+  for( ulong i=0UL; i<slot_cnt; i++ ) {
+    void * dstream_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_zstd_dstream_align(), fd_zstd_dstream_footprint( window_sz ) );
+    uchar * out_buf    = FD_SCRATCH_ALLOC_APPEND( l, 1UL,                     out_max                                );
+    slot[i] = (fd_io_istream_zstd_para_slot_t){
+      .dstream  = fd_zstd_dstream_new( dstream_mem, window_sz ),
+      .out_buf  = out_buf,
+      .out_half = out_max/2UL
+    };
+    if( FD_UNLIKELY( !slot[i].dstream ) ) return NULL;
+  }
+  FD_SCRATCH_ALLOC_FINI( l, fd_io_istream_zstd_para_align() );
+
+  *this = (fd_io_istream_zstd_para_t){
+    .src      = src,
+    .tpool    = tpool,
+    .t0       = t0,
+    .in_buf   = in_buf,
+    .in_max   = in_max,
+    .stage    = in_buf,
+    .slot     = slot,
+    .slot_cnt = slot_cnt
+  };
+  return this;
+}
+
+/* fd_io_istream_zstd_para_wait waits for the task of the given slot (if
+   any) and makes its output half available to the reader. */
+
+static void
+fd_io_istream_zstd_para_wait( fd_io_istream_zstd_para_t * this,
+                              ulong                       slot_idx ) {
+  fd_io_istream_zstd_para_slot_t * slot = this->slot + slot_idx;
+  if( !slot->busy ) return;
+  fd_tpool_wait( this->tpool, this->t0 + slot_idx );
+  FD_COMPILER_MFENCE();
+  slot->busy = 0;
+  slot->out_cnt++;
+}
+
+void *
+fd_io_istream_zstd_para_delete( fd_io_istream_zstd_para_t * this ) {
+  if( FD_UNLIKELY( !this ) ) return NULL;
+  for( ulong i=0UL; i<this->slot_cnt; i++ ) {
+    fd_io_istream_zstd_para_wait( this, i );
+    fd_zstd_dstream_delete( this->slot[i].dstream );
+  }
+  fd_memset( this, 0, sizeof(fd_io_istream_zstd_para_t) );
+  return (void *)this;
+}
+
+/* fd_io_istream_zstd_para_task decompresses as much of the slot's frame
+   as fits into output half out_wr.  Runs on a tpool worker. */
+
+static void
+fd_io_istream_zstd_para_task( void * tpool,
+                              ulong  t0,      ulong t1,
+                              void * args,
+                              void * reduce,  ulong stride,
+                              ulong  l0,      ulong l1,
+                              ulong  m0,      ulong m1,
+                              ulong  n0,      ulong n1 ) {
+  (void)tpool; (void)t0; (void)t1; (void)reduce; (void)stride;
+  (void)l0; (void)l1; (void)m0; (void)m1; (void)n0; (void)n1;
+
+  fd_io_istream_zstd_para_slot_t * slot = args;
+
+  uchar * out0    = slot->out_buf + slot->out_wr*slot->out_half;
+  uchar * out     = out0;
+  uchar * out_end = out0 + slot->out_half;
+  int     err;
+  for(;;) {
+    err = fd_zstd_dstream_read( slot->dstream, &slot->in_cur, slot->in_end, &out, out_end, NULL );
+    if( err                   ) break;              /* frame done (-1) or failed */
+    if( out==out_end          ) break;              /* half full, more to come */
+    if( slot->in_cur==slot->in_end ) { err = EPROTO; break; }  /* truncated frame */
+  }
+  if( FD_UNLIKELY( err>0 ) ) fd_zstd_dstream_reset( slot->dstream );
+
+  slot->out_sz[ slot->out_wr ] = (ulong)out - (ulong)out0;
+  slot->err                    = err;
+}
+
+/* fd_io_istream_zstd_para_dispatch continues decompressing the frame
+   of the given slot into its free output half.  Requires the slot to
+   be idle, its frame incomplete and a free output half. */
+
+static void
+fd_io_istream_zstd_para_dispatch( fd_io_istream_zstd_para_t * this,
+                                  ulong                       slot_idx ) {
+  fd_io_istream_zstd_para_slot_t * slot = this->slot + slot_idx;
+  slot->out_wr = (slot->out_rd + slot->out_cnt) & 1U;
+  if( !this->tpool ) {
+    fd_io_istream_zstd_para_task( NULL, 0UL, 0UL, slot, NULL, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+    slot->out_cnt++;
+    return;
+  }
+  slot->busy = 1;
+  FD_COMPILER_MFENCE();
+  fd_tpool_exec( this->tpool, this->t0 + slot_idx, fd_io_istream_zstd_para_task,
+                 NULL, 0UL, 0UL, slot, NULL, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+}
+
+/* fd_io_istream_zstd_para_pump collects the output of finished workers
+   and redispatches every frame in flight that is incomplete and has a
+   free output half.  Does not block. */
+
+static void
+fd_io_istream_zstd_para_pump( fd_io_istream_zstd_para_t * this ) {
+  for( ulong i=0UL; i<this->cnt; i++ ) {
+    ulong slot_idx = (this->head + i) % this->slot_cnt;
+    fd_io_istream_zstd_para_slot_t * slot = this->slot + slot_idx;
+    if( slot->busy ) {
+      if( fd_tpool_worker_state( this->tpool, this->t0 + slot_idx )==FD_TPOOL_WORKER_STATE_EXEC ) continue;
+      fd_io_istream_zstd_para_wait( this, slot_idx );
+    }
+    if( (!slot->err) & (slot->out_cnt<2U) ) fd_io_istream_zstd_para_dispatch( this, slot_idx );
+  }
+}
+
+/* fd_io_istream_zstd_para_limit returns the end of the space the stage
+   can grow into: the first frame in flight after the stage if the
+   frames in flight wrap around, the end of the arena otherwise. */
+
+static uchar const *
+fd_io_istream_zstd_para_limit( fd_io_istream_zstd_para_t const * this ) {
+  uchar const * end = this->in_buf + this->in_max;
+  if( !this->cnt ) return end;
+  uchar const * head_beg = this->slot[ this->head ].in_beg;
+  return head_beg>this->stage ? head_beg : end;
+}
+
+/* fd_io_istream_zstd_para_fill splits frames off the source and hands
+   them to free slots until all slots are in use, the arena is full or
+   the source is exhausted.  Switches to stream mode if the arena cannot
+   hold the next frame.  Returns 0 on success and errno-like on
+   failure. */
+
+static int
+fd_io_istream_zstd_para_fill( fd_io_istream_zstd_para_t * this ) {
+  for(;;) {
+
+    /* Hand out complete frames */
+
+    while( (this->cnt < this->slot_cnt) & (this->stage_sz>0UL) ) {
+      ulong frame_sz = fd_zstd_frame_sz( this->stage, this->stage_sz );
+      if( FD_UNLIKELY( frame_sz==ULONG_MAX ) ) {
+        FD_LOG_WARNING(( "corrupt zstd frame" ));
+        return EPROTO;
+      }
+      if( !frame_sz ) break;
+
+      ulong slot_idx = (this->head + this->cnt) % this->slot_cnt;
+      fd_io_istream_zstd_para_slot_t * slot = this->slot + slot_idx;
+      slot->in_beg  = this->stage;
+      slot->in_cur  = this->stage;
+      slot->in_end  = this->stage + frame_sz;
+      slot->out_off = 0UL;
+      slot->out_rd  = 0U;
+      slot->out_cnt = 0U;
+      slot->err     = 0;
+      this->stage    += frame_sz;
+      this->stage_sz -= frame_sz;
+      this->cnt++;
+      fd_io_istream_zstd_para_dispatch( this, slot_idx );
+    }
+    if( this->cnt==this->slot_cnt ) return 0;
+
+    if( this->src_eof ) {
+      if( FD_UNLIKELY( this->stage_sz ) ) {
+        FD_LOG_WARNING(( "unexpected EOF in zstd frame" ));
+        return EPROTO;
+      }
+      return 0;
+    }
+
+    /* Make room for the rest of the frame */
+
+    uchar const * limit = fd_io_istream_zstd_para_limit( this );
+    if( this->stage + this->stage_sz == limit ) {
+      int wrap = limit==this->in_buf + this->in_max && this->stage!=this->in_buf;
+      if( wrap && this->cnt ) wrap = this->stage_sz < (ulong)( this->slot[ this->head ].in_beg - this->in_buf );
+      if( wrap ) {
+        memmove( this->in_buf, this->stage, this->stage_sz );
+        this->stage = this->in_buf;
+        continue;
+      }
+      if( this->cnt ) return 0;  /* wait for frames in flight to drain */
+      FD_LOG_NOTICE(( "zstd frame exceeds %lu bytes, decompressing it single-threaded", this->in_max ));
+      this->stream = 1;
+      this->dirty  = 0;
+      return 0;
+    }
+
+    ulong in_sz = 0UL;
+    int read_err = fd_io_istream_obj_read( &this->src, this->stage + this->stage_sz, (ulong)( limit - (this->stage + this->stage_sz) ), &in_sz );
+    if( FD_LIKELY( read_err==0 ) ) this->stage_sz += in_sz;
+    else if( read_err<0 )          this->src_eof   = 1;
+    else {
+      FD_LOG_DEBUG(( "failed to read from source (%d-%s)", read_err, fd_io_strerror( read_err ) ));
+      return read_err;
+    }
+
+    /* Don't block on the source while decompressed data is ready */
+
+    if( this->cnt && !in_sz ) return 0;
+  }
+}
+
+/* fd_io_istream_zstd_para_read_stream decompresses a frame larger than
+   the arena while it is read from the source, like
+   fd_io_istream_zstd_read, using the head slot's dstream and the whole
+   arena as input buffer.  Returns to parallel mode at the end of the
+   frame. */
+
+static int
+fd_io_istream_zstd_para_read_stream( fd_io_istream_zstd_para_t * this,
+                                     void *                      dst,
+                                     ulong                       dst_max,
+                                     ulong *                     dst_sz ) {
+
+  fd_io_istream_zstd_para_slot_t * slot = this->slot + this->head;
+
+  if( (!this->dirty) & (!this->stage_sz) ) {
+    /* needs refill */
+    ulong in_sz = 0UL;
+    int read_err = fd_io_istream_obj_read( &this->src, this->in_buf, this->in_max, &in_sz );
+    if( FD_LIKELY( read_err==0 ) ) { /* ok */ }
+    else if( read_err<0 ) {
+      FD_LOG_WARNING(( "unexpected EOF in zstd frame" ));
+      return EPROTO;
+    } else {
+      FD_LOG_DEBUG(( "failed to read from source (%d-%s)", read_err, fd_io_strerror( read_err ) ));
+      return read_err;
+    }
+    this->stage    = this->in_buf;
+    this->stage_sz = in_sz;
+    if( FD_UNLIKELY( in_sz==0 ) ) {
+      *dst_sz = 0UL;
+      return 0;
+    }
+  }
+
+  uchar const * in      = this->stage;
+  uchar *       out     = dst;
+  uchar *       out_end = out + dst_max;
+  int zstd_err = fd_zstd_dstream_read( slot->dstream, &in, this->stage + this->stage_sz, &out, out_end, NULL );
+  if( FD_UNLIKELY( zstd_err>0 ) ) {
+    FD_LOG_WARNING(( "fd_zstd_dstream_read failed" ));
+    return EPROTO;
+  }
+  this->stage_sz -= (ulong)( in - this->stage );
+  this->stage     = (uchar *)in;
+  this->dirty     = (out==out_end);
+  if( zstd_err<0 ) {
+    /* End of frame.  The stage starts at the next frame boundary. */
+    this->stream = 0;
+    this->dirty  = 0;
+  }
+
+  *dst_sz = (ulong)out - (ulong)dst;
+  return 0;
+}
+
+int
+fd_io_istream_zstd_para_read( void *  _this,
+                              void *  dst,
+                              ulong   dst_max,
+                              ulong * dst_sz ) {
+
+  fd_io_istream_zstd_para_t * restrict this = _this;
+
+  for(;;) {
+    if( FD_UNLIKELY( this->stream ) ) return fd_io_istream_zstd_para_read_stream( this, dst, dst_max, dst_sz );
+
+    int fill_err = fd_io_istream_zstd_para_fill( this );
+    if( FD_UNLIKELY( fill_err ) ) return fill_err;
+    if( FD_UNLIKELY( this->stream ) ) continue;
+    if( FD_UNLIKELY( !this->cnt ) ) return -1; /* EOF */
+
+    if( this->tpool ) fd_io_istream_zstd_para_pump( this );
+
+    ulong slot_idx = this->head;
+    fd_io_istream_zstd_para_slot_t * slot = this->slot + slot_idx;
+    if( !slot->out_cnt ) fd_io_istream_zstd_para_wait( this, slot_idx );
+    if( FD_UNLIKELY( (!slot->busy) & (slot->err>0) ) ) {
+      FD_LOG_WARNING(( "fd_zstd_dstream_read failed" ));
+      return slot->err;
+    }
+
+    ulong sz = 0UL;
+    if( slot->out_cnt ) {
+      uint rd = slot->out_rd;
+      sz = fd_ulong_min( dst_max, slot->out_sz[ rd ] - slot->out_off );
+      fd_memcpy( dst, slot->out_buf + rd*slot->out_half + slot->out_off, sz );
+      slot->out_off += sz;
+      if( slot->out_off==slot->out_sz[ rd ] ) {
+        /* Half drained, refill it while the other half is read */
+        slot->out_off = 0UL;
+        slot->out_rd  = rd^1U;
+        slot->out_cnt--;
+        if( (!slot->busy) && (!slot->err) ) fd_io_istream_zstd_para_dispatch( this, slot_idx );
+      }
+    }
+
+    if( (!slot->busy) && (!slot->out_cnt) && slot->err<0 ) {
+      /* Frame done, release slot */
+      this->head = (this->head+1UL) % this->slot_cnt;
+      this->cnt--;
+    }
+
+    if( sz ) {
+      *dst_sz = sz;
+      return 0;
+    }
+  }
+}
+
+fd_io_istream_vt_t const fd_io_istream_zstd_para_vt =
+  { .read = fd_io_istream_zstd_para_read };
+
 #endif /* FD_HAS_ZSTD */
 
 /* fd_io_istream_file_t ***********************************************/
@@ -30,6 +30,15 @@ struct fd_snapshot_loader {
   fd_zstd_dstream_t *  zstd;
   fd_io_istream_zstd_t vzstd[1];
 
+  /* Parallel Zstandard decompressor (tpool!=NULL) */
+
+  fd_tpool_t *                tpool;
+  ulong                       t0;
+  ulong                       t1;
+  ulong                       zstd_window_sz;
+  void *                      zstd_para_mem;
+  fd_io_istream_zstd_para_t * vzstd_para;
+
   /* Tar reader */
 
   fd_tar_reader_t    tar[1];
@@ -53,11 +62,27 @@ fd_snapshot_loader_align( void ) {
   return fd_ulong_max( alignof(fd_snapshot_loader_t), fd_zstd_dstream_align() );
 }
 
+static ulong
+fd_snapshot_loader_zstd_para_footprint( ulong zstd_window_sz,
+                                        ulong worker_cnt ) {
+  if( !worker_cnt ) return 0UL;
+  return fd_io_istream_zstd_para_footprint( worker_cnt, zstd_window_sz,
+                                            FD_SNAPSHOT_LOADER_ZSTD_IN_MAX,
+                                            FD_SNAPSHOT_LOADER_ZSTD_OUT_MAX );
+}
+
 ulong
 fd_snapshot_loader_footprint( ulong zstd_window_sz ) {
+  return fd_snapshot_loader_footprint_tpool( zstd_window_sz, 0UL );
+}
+
+ulong
+fd_snapshot_loader_footprint_tpool( ulong zstd_window_sz,
+                                    ulong worker_cnt ) {
   ulong l = FD_LAYOUT_INIT;
-  l = FD_LAYOUT_APPEND( l, alignof(fd_snapshot_loader_t), sizeof(fd_snapshot_loader_t) );
-  l = FD_LAYOUT_APPEND( l, fd_zstd_dstream_align(),       fd_zstd_dstream_footprint( zstd_window_sz ) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_snapshot_loader_t),      sizeof(fd_snapshot_loader_t) );
+  l = FD_LAYOUT_APPEND( l, fd_zstd_dstream_align(),            fd_zstd_dstream_footprint( zstd_window_sz ) );
+  l = FD_LAYOUT_APPEND( l, fd_io_istream_zstd_para_align(),    fd_snapshot_loader_zstd_para_footprint( zstd_window_sz, worker_cnt ) );
   /* FIXME add test ensuring zstd dstream align > alignof loader */
   return FD_LAYOUT_FINI( l, fd_snapshot_loader_align() );
 }
@@ -65,6 +90,15 @@ fd_snapshot_loader_footprint( ulong zstd_window_sz ) {
 fd_snapshot_loader_t *
 fd_snapshot_loader_new( void * mem,
                         ulong  zstd_window_sz ) {
+  return fd_snapshot_loader_new_tpool( mem, zstd_window_sz, NULL, 0UL, 0UL );
+}
+
+fd_snapshot_loader_t *
+fd_snapshot_loader_new_tpool( void *       mem,
+                              ulong        zstd_window_sz,
+                              fd_tpool_t * tpool,
+                              ulong        t0,
+                              ulong        t1 ) {
 
   if( FD_UNLIKELY( !mem ) ) {
     FD_LOG_WARNING(( "NULL mem" ));
@@ -76,13 +110,34 @@ fd_snapshot_loader_new( void * mem,
     return NULL;
   }
 
+  if( tpool ) {
+    if( FD_UNLIKELY( (!t0) | (t0>=t1) | (t1>fd_tpool_worker_cnt( tpool )) ) ) {
+      FD_LOG_WARNING(( "bad worker range [%lu,%lu)", t0, t1 ));
+      return NULL;
+    }
+  } else {
+    t0 = t1 = 0UL;
+  }
+
   FD_SCRATCH_ALLOC_INIT( l, mem );
-  fd_snapshot_loader_t * loader   = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_snapshot_loader_t), sizeof(fd_snapshot_loader_t) );
-  void *                 zstd_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_zstd_dstream_align(),       fd_zstd_dstream_footprint( zstd_window_sz ) );
+  fd_snapshot_loader_t * loader    = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_snapshot_loader_t),   sizeof(fd_snapshot_loader_t) );
+  void *                 zstd_mem  = FD_SCRATCH_ALLOC_APPEND( l, fd_zstd_dstream_align(),         fd_zstd_dstream_footprint( zstd_window_sz ) );
+  void *                 para_mem  = FD_SCRATCH_ALLOC_APPEND( l, fd_io_istream_zstd_para_align(), fd_snapshot_loader_zstd_para_footprint( zstd_window_sz, t1-t0 ) );
   FD_SCRATCH_ALLOC_FINI( l, fd_snapshot_loader_align() );
 
   loader->zstd = fd_zstd_dstream_new( zstd_mem, zstd_window_sz );
 
+  /* No source is open yet.  delete closes these if they are valid */
+  loader->snapshot_fd      = -1;
+  loader->vhttp->socket_fd = -1;
+
+  loader->tpool          = tpool;
+  loader->t0             = t0;
+  loader->t1             = t1;
+  loader->zstd_window_sz = zstd_window_sz;
+  loader->zstd_para_mem  = tpool ? para_mem : NULL;
+  loader->vzstd_para     = NULL;
+
   FD_COMPILER_MFENCE();
   loader->magic = FD_SNAPSHOT_LOADER_MAGIC;
   FD_COMPILER_MFENCE();
@@ -103,6 +158,8 @@ fd_snapshot_loader_delete( fd_snapshot_loader_t * loader ) {
   fd_zstd_dstream_delete   ( loader->zstd  );
   fd_tar_io_reader_delete  ( loader->vtar  );
   fd_io_istream_zstd_delete( loader->vzstd );
+  fd_io_istream_zstd_para_delete( loader->vzstd_para );
+  loader->vzstd_para = NULL;
   fd_io_istream_file_delete( loader->vfile );
   fd_snapshot_http_delete  ( loader->vhttp );
   fd_tar_reader_delete     ( loader->tar   );
@@ -169,14 +226,28 @@ fd_snapshot_loader_init( fd_snapshot_loader_t *    d,
     return NULL;
   }
 
-  fd_zstd_dstream_reset( d->zstd );
+  fd_io_istream_obj_t vunzstd;
+  if( d->tpool ) {
+    d->vzstd_para = fd_io_istream_zstd_para_new( d->zstd_para_mem, d->tpool, d->t0, d->t1, d->zstd_window_sz,
+                                                 FD_SNAPSHOT_LOADER_ZSTD_IN_MAX,
+                                                 FD_SNAPSHOT_LOADER_ZSTD_OUT_MAX,
+                                                 d->vsrc );
+    if( FD_UNLIKELY( !d->vzstd_para ) ) {
+      FD_LOG_WARNING(( "Failed to create fd_io_istream_zstd_para_t" ));
+      return NULL;
+    }
+    vunzstd = fd_io_istream_zstd_para_virtual( d->vzstd_para );
+  } else {
+    fd_zstd_dstream_reset( d->zstd );
 
-  if( FD_UNLIKELY( !fd_io_istream_zstd_new( d->vzstd, d->zstd, d->vsrc ) ) ) {
-    FD_LOG_WARNING(( "Failed to create fd_io_istream_zstd_t" ));
-    return NULL;
+    if( FD_UNLIKELY( !fd_io_istream_zstd_new( d->vzstd, d->zstd, d->vsrc ) ) ) {
+      FD_LOG_WARNING(( "Failed to create fd_io_istream_zstd_t" ));
+      return NULL;
+    }
+    vunzstd = fd_io_istream_zstd_virtual( d->vzstd );
   }
 
-  if( FD_UNLIKELY( !fd_tar_io_reader_new( d->vtar, d->tar, fd_io_istream_zstd_virtual( d->vzstd ) ) ) ) {
+  if( FD_UNLIKELY( !fd_tar_io_reader_new( d->vtar, d->tar, vunzstd ) ) ) {
     FD_LOG_WARNING(( "Failed to create fd_tar_io_reader_t" ));
     return NULL;
   }
@@ -191,7 +262,15 @@ fd_snapshot_loader_advance( fd_snapshot_loader_t * dumper ) {
 
   int untar_err = fd_tar_io_reader_advance( vtar );
   if( untar_err==0 )     { /* ok */ }
-  else if( untar_err<0 ) { /* EOF */ return -1; }
+  else if( untar_err<0 ) {
+    /* EOF, restore any accounts still batched up */
+    int restore_err = fd_snapshot_restore_flush( dumper->restore );
+    if( FD_UNLIKELY( restore_err ) ) {
+      FD_LOG_WARNING(( "Failed to load snapshot (%d-%s)", restore_err, fd_io_strerror( restore_err ) ));
+      return restore_err;
+    }
+    return -1;
+  }
   else {
     FD_LOG_WARNING(( "Failed to load snapshot (%d-%s)", untar_err, fd_io_strerror( untar_err ) ));
     return untar_err;
@@ -9,12 +9,24 @@
 
    This header provides high-level APIs for streaming loading of a
    snapshot from the local file system or over HTTP (regular sockets).
-   The loader is currently a single-threaded streaming pipeline.  This
-   is subject to change to the tile architecture in the future. */
+   The loader is a streaming pipeline driven by the caller's thread.
+   Optionally, the unzstd stage can be spread across tpool workers
+   (see fd_snapshot_loader_new_tpool).  This is subject to change to
+   the tile architecture in the future. */
 
 #include "../snapshot/fd_snapshot.h"
 #include "../snapshot/fd_snapshot_restore.h"
 
+/* FD_SNAPSHOT_LOADER_ZSTD_IN_MAX is the size of the compressed input
+   buffer shared by all workers of parallel decompression.  It bounds
+   the compressed size of the frames in flight.  Snapshot archives are
+   made of zstd frames of up to 100 MB compressed.  Larger frames are
+   decompressed single-threaded.  FD_SNAPSHOT_LOADER_ZSTD_OUT_MAX is the
+   per-worker output buffer size. */
+
+#define FD_SNAPSHOT_LOADER_ZSTD_IN_MAX (268435456UL) /* 256 MiB */
+#define FD_SNAPSHOT_LOADER_ZSTD_OUT_MAX  (8388608UL) /*   8 MiB */
+
 /* fd_snapshot_loader_t manages file descriptors and buffers used during
    snapshot load. */
 
@@ -62,6 +74,26 @@ fd_snapshot_loader_t *
 fd_snapshot_loader_new( void * mem,
                         ulong  zstd_window_sz );
 
+/* fd_snapshot_loader_{footprint,new}_tpool are variants of the above
+   that decompress the snapshot on tpool workers [t0,t1) (worker_cnt is
+   t1-t0).  Requires 0<t0<t1<=fd_tpool_worker_cnt(tpool).  The workers
+   are reserved for the loader from init until delete.  Needs roughly
+   FD_SNAPSHOT_LOADER_ZSTD_IN_MAX bytes of memory plus
+   FD_SNAPSHOT_LOADER_ZSTD_OUT_MAX + zstd_window_sz bytes per worker.
+   worker_cnt==0 / tpool==NULL are equivalent to the single-threaded
+   footprint / new. */
+
+ulong
+fd_snapshot_loader_footprint_tpool( ulong zstd_window_sz,
+                                    ulong worker_cnt );
+
+fd_snapshot_loader_t *
+fd_snapshot_loader_new_tpool( void *       mem,
+                              ulong        zstd_window_sz,
+                              fd_tpool_t * tpool,
+                              ulong        t0,
+                              ulong        t1 );
+
 void *
 fd_snapshot_loader_delete( fd_snapshot_loader_t * loader );
 
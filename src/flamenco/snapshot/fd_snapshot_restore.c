@@ -110,11 +110,275 @@ void *
 fd_snapshot_restore_delete( fd_snapshot_restore_t * self ) {
   if( FD_UNLIKELY( !self ) ) return NULL;
   fd_snapshot_restore_discard_buf( self );
+  fd_valloc_free( self->valloc, self->batch      );
+  fd_valloc_free( self->valloc, self->batch_accv );
+  fd_valloc_free( self->valloc, self->batch_rec  );
   fd_snapshot_accv_map_delete( fd_snapshot_accv_map_leave( self->accv_map ) );
   fd_memset( self, 0, sizeof(fd_snapshot_restore_t) );
   return (void *)self;
 }
 
+fd_snapshot_restore_t *
+fd_snapshot_restore_set_tpool( fd_snapshot_restore_t * restore,
+                               fd_tpool_t *            tpool,
+                               ulong                   t0,
+                               ulong                   t1,
+                               ulong                   batch_max ) {
+# if FD_HAS_ATOMIC
+  if( FD_UNLIKELY( (!tpool) | (t0>=t1) | (t1-t0<2UL) | (t1>fd_tpool_worker_cnt( tpool )) ) ) return restore;
+  if( !batch_max ) batch_max = FD_SNAPSHOT_RESTORE_BATCH_MAX;
+  restore->tpool     = tpool;
+  restore->tpool_t0  = t0;
+  restore->tpool_t1  = t1;
+  restore->batch_max = batch_max;
+# else
+  (void)tpool; (void)t0; (void)t1; (void)batch_max;
+# endif
+  return restore;
+}
+
+/* Parallel account insertion *****************************************/
+
+#if FD_HAS_ATOMIC
+
+/* fd_snapshot_restore_shard returns the shard in [0,shard_cnt) that
+   owns the account with the given pubkey. */
+
+FD_FN_PURE static inline ulong
+fd_snapshot_restore_shard( fd_pubkey_t const * key,
+                           ulong               shard_cnt ) {
+  return (ulong)( ( (uint128)fd_ulong_hash( key->ul[0] ) * (uint128)shard_cnt ) >> 64 );
+}
+
+/* fd_snapshot_restore_rec_is_newer returns 1 if rec holds an account
+   revision from a slot newer than slot. */
+
+static int
+fd_snapshot_restore_rec_is_newer( fd_funk_rec_t const * rec,
+                                  fd_wksp_t *           wksp,
+                                  ulong                 slot ) {
+  if( rec->flags & FD_FUNK_REC_FLAG_ERASE ) return 0;
+  if( fd_funk_val_sz( rec ) < sizeof(fd_account_meta_t) ) return 0;
+  fd_account_meta_t const * meta = fd_funk_val_const( rec, wksp );
+  return ( meta && meta->magic==FD_ACCOUNT_META_MAGIC && meta->slot > slot );
+}
+
+/* fd_snapshot_restore_batch_insert writes the account with header hdr
+   and content data found in an account vec of the given slot to funk.
+   Stores the record written at *out_rec (NULL if a newer revision
+   already exists).  Returns errno-compatible error code. */
+
+static int
+fd_snapshot_restore_batch_insert( fd_snapshot_restore_t const *   restore,
+                                  fd_solana_account_hdr_t const * hdr,
+                                  uchar const *                   data,
+                                  ulong                           slot,
+                                  fd_funk_rec_t **                out_rec ) {
+
+  fd_funk_t *         funk  = restore->acc_mgr->funk;
+  fd_funk_txn_t *     txn   = restore->funk_txn;
+  fd_wksp_t *         wksp  = fd_funk_wksp( funk );
+  fd_pubkey_t const * key   = fd_type_pun_const( hdr->meta.pubkey );
+  fd_funk_rec_key_t   id    = fd_acc_funk_key( key );
+  ulong               dlen  = hdr->meta.data_len;
+  char                key_cstr[ FD_BASE58_ENCODED_32_SZ ];
+
+  *out_rec = NULL;
+
+  /* A newer revision may live in an ancestor of txn */
+  if( txn ) {
+    fd_funk_rec_t const * prev = fd_funk_rec_query_global( funk, txn, &id );
+    if( prev && fd_snapshot_restore_rec_is_newer( prev, wksp, slot ) ) return 0;
+  }
+
+  int funk_err = FD_FUNK_SUCCESS;
+  fd_funk_rec_t * rec = (fd_funk_rec_t *)fd_funk_rec_insert_para( funk, txn, &id, &funk_err );
+  if( FD_UNLIKELY( !rec ) ) {
+    FD_LOG_WARNING(( "fd_funk_rec_insert_para(%s) failed (%i-%s)", fd_acct_addr_cstr( key_cstr, key->uc ), funk_err, fd_funk_strerror( funk_err ) ));
+    return ENOMEM;
+  }
+  if( fd_snapshot_restore_rec_is_newer( rec, wksp, slot ) ) return 0;
+
+  /* Values are allocated from the funk heap (which unlike the speed
+     load area is thread safe) */
+  if( FD_UNLIKELY( !fd_funk_val_truncate( rec, sizeof(fd_account_meta_t)+dlen, fd_funk_alloc( funk, wksp ), wksp, &funk_err ) ) ) {
+    FD_LOG_WARNING(( "fd_funk_val_truncate(%s) failed (%i-%s)", fd_acct_addr_cstr( key_cstr, key->uc ), funk_err, fd_funk_strerror( funk_err ) ));
+    return ENOMEM;
+  }
+
+  fd_account_meta_t * meta = fd_funk_val( rec, wksp );
+  if( FD_UNLIKELY( !meta ) ) return ENOMEM;
+  fd_account_meta_init( meta );
+  meta->dlen = dlen;
+  meta->slot = slot;
+  memcpy( &meta->hash, hdr->hash.uc, 32UL );
+  memcpy( &meta->info, &hdr->info, sizeof(fd_solana_account_meta_t) );
+  fd_memcpy( (uchar *)meta + meta->hlen, data, dlen );
+
+  *out_rec = rec;
+  return 0;
+}
+
+/* fd_snapshot_restore_batch_shard restores the accounts of the given
+   shard from the batch.  Every shard walks the whole batch (which keeps
+   the account indexing consistent without coordination), validating
+   the account vecs in the same way as the serial path.  Only shard 0
+   logs validation errors.  Returns errno-compatible error code. */
+
+static int
+fd_snapshot_restore_batch_shard( fd_snapshot_restore_t * restore,
+                                 ulong                   shard,
+                                 ulong                   shard_cnt ) {
+
+  int  log     = (shard==0UL);
+  ulong acc_idx = 0UL;
+  char key_cstr[ FD_BASE58_ENCODED_32_SZ ];
+
+  for( ulong i=0UL; i < restore->batch_accv_cnt; i++ ) {
+    fd_snapshot_restore_batch_accv_t const * accv = &restore->batch_accv[ i ];
+
+    uchar const * p   = restore->batch + accv->off;
+    ulong         rem = accv->sz;
+
+    while( rem ) {
+
+      if( FD_UNLIKELY( rem < sizeof(fd_solana_account_hdr_t) ) ) {
+        if( log ) FD_LOG_WARNING(( "encountered unexpected EOF while reading account header" ));
+        return EINVAL;
+      }
+      fd_solana_account_hdr_t const * hdr = fd_type_pun_const( p );
+      fd_pubkey_t const *             key = fd_type_pun_const( hdr->meta.pubkey );
+      p   += sizeof(fd_solana_account_hdr_t);
+      rem -= sizeof(fd_solana_account_hdr_t);
+
+      ulong data_sz = hdr->meta.data_len;
+      if( FD_UNLIKELY( data_sz > FD_ACC_SZ_MAX ) ) {
+        if( log ) {
+          FD_LOG_WARNING(( "accounts/%lu.%lu: account %s too large: data_len=%lu",
+                           accv->slot, accv->id, fd_acct_addr_cstr( key_cstr, key->uc ), data_sz ));
+          FD_LOG_HEXDUMP_WARNING(( "account header", hdr, sizeof(fd_solana_account_hdr_t) ));
+        }
+        return EINVAL;
+      }
+      if( FD_UNLIKELY( data_sz > rem ) ) {
+        if( log ) {
+          FD_LOG_WARNING(( "accounts/%lu.%lu: account %s data exceeds past end of account vec (acc_sz=%lu accv_sz=%lu)",
+                           accv->slot, accv->id, fd_acct_addr_cstr( key_cstr, key->uc ), data_sz, rem ));
+          FD_LOG_HEXDUMP_WARNING(( "account header", hdr, sizeof(fd_solana_account_hdr_t) ));
+        }
+        return EINVAL;
+      }
+
+      if( fd_snapshot_restore_shard( key, shard_cnt )==shard ) {
+        int err = fd_snapshot_restore_batch_insert( restore, hdr, p, accv->slot, &restore->batch_rec[ acc_idx ] );
+        if( FD_UNLIKELY( err ) ) return err;
+      }
+      acc_idx++;
+
+      ulong pad_sz = fd_ulong_min( fd_ulong_align_up( data_sz, FD_SNAPSHOT_ACC_ALIGN ) - data_sz, rem - data_sz );
+      p   += data_sz + pad_sz;
+      rem -= data_sz + pad_sz;
+    }
+  }
+
+  if( log ) restore->batch_acc_cnt = acc_idx;
+  return 0;
+}
+
+static void
+fd_snapshot_restore_batch_task( void * tpool,
+                                ulong  t0,     ulong t1,
+                                void * args,
+                                void * reduce, ulong stride,
+                                ulong  l0,     ulong l1,
+                                ulong  m0,     ulong m1,
+                                ulong  n0,     ulong n1 ) {
+  (void)t0; (void)t1; (void)args; (void)reduce; (void)stride;
+  (void)l0; (void)m1; (void)n0; (void)n1;
+  fd_snapshot_restore_t * restore = (fd_snapshot_restore_t *)tpool;
+  restore->batch_err[ m0 ] = fd_snapshot_restore_batch_shard( restore, m0, l1 );
+}
+
+#endif /* FD_HAS_ATOMIC */
+
+int
+fd_snapshot_restore_flush( fd_snapshot_restore_t * restore ) {
+
+  if( restore->failed ) return EINVAL;
+  if( !restore->batch_accv_cnt ) return 0;
+
+# if FD_HAS_ATOMIC
+  ulong shard_cnt = restore->tpool_t1 - restore->tpool_t0;
+  fd_tpool_exec_all_rrobin( restore->tpool, restore->tpool_t0, restore->tpool_t1,
+                            fd_snapshot_restore_batch_task, restore, NULL, NULL, 1UL, 0UL, shard_cnt );
+
+  for( ulong shard=0UL; shard<shard_cnt; shard++ ) {
+    int err = restore->batch_err[ shard ];
+    if( FD_UNLIKELY( err ) ) {
+      FD_LOG_WARNING(( "Failed to restore batch of %lu account vecs", restore->batch_accv_cnt ));
+      restore->failed = 1;
+      return err;
+    }
+  }
+
+  /* Rent partitions are not thread safe */
+  for( ulong i=0UL; i < restore->batch_acc_cnt; i++ ) {
+    fd_funk_rec_t * rec = restore->batch_rec[ i ];
+    if( rec ) fd_acc_mgr_part_set( restore->acc_mgr, rec );
+    restore->batch_rec[ i ] = NULL;
+  }
+# endif
+
+  restore->batch_sz       = 0UL;
+  restore->batch_accv_cnt = 0UL;
+  restore->batch_acc_cnt  = 0UL;
+  return 0;
+}
+
+/* fd_snapshot_restore_batch_prepare sets up the account vec
+   (slot,id) of sz bytes to be read into the batch.  Flushes the batch
+   first if the account vec doesn't fit.  Returns errno-compatible error
+   code. */
+
+static int
+fd_snapshot_restore_batch_prepare( fd_snapshot_restore_t * restore,
+                                   ulong                   slot,
+                                   ulong                   id,
+                                   ulong                   sz ) {
+
+  if( FD_UNLIKELY( !restore->batch ) ) {
+    ulong rec_max     = restore->batch_max / sizeof(fd_solana_account_hdr_t);
+    restore->batch      = fd_valloc_malloc( restore->valloc, 1UL, restore->batch_max );
+    restore->batch_accv = fd_valloc_malloc( restore->valloc, alignof(fd_snapshot_restore_batch_accv_t),
+                                            FD_SNAPSHOT_RESTORE_BATCH_ACCV_MAX*sizeof(fd_snapshot_restore_batch_accv_t) );
+    restore->batch_rec  = fd_valloc_malloc( restore->valloc, alignof(fd_funk_rec_t *), fd_ulong_max( rec_max, 1UL )*sizeof(fd_funk_rec_t *) );
+    if( FD_UNLIKELY( (!restore->batch) | (!restore->batch_accv) | (!restore->batch_rec) ) ) {
+      FD_LOG_WARNING(( "Failed to allocate %lu byte account batch while restoring accounts from snapshot", restore->batch_max ));
+      restore->failed = 1;
+      return ENOMEM;
+    }
+    fd_memset( restore->batch_rec, 0, fd_ulong_max( rec_max, 1UL )*sizeof(fd_funk_rec_t *) );
+  }
+
+  if( ( restore->batch_sz + sz > restore->batch_max ) |
+      ( restore->batch_accv_cnt >= FD_SNAPSHOT_RESTORE_BATCH_ACCV_MAX ) ) {
+    int err = fd_snapshot_restore_flush( restore );
+    if( FD_UNLIKELY( err ) ) return err;
+  }
+
+  fd_snapshot_restore_batch_accv_t * accv = &restore->batch_accv[ restore->batch_accv_cnt++ ];
+  accv->slot = slot;
+  accv->id   = id;
+  accv->off  = restore->batch_sz;
+  accv->sz   = sz;
+
+  restore->accv_sz   = sz;
+  restore->accv_slot = slot;
+  restore->accv_id   = id;
+  restore->state     = STATE_BATCH_ACCV;
+  return 0;
+}
+
 /* Streaming state machine ********************************************/
 
 /* fd_snapshot_expect_account_hdr sets up the snapshot restore to
@@ -349,6 +613,20 @@ fd_snapshot_restore_accv_prepare( fd_snapshot_restore_t * const restore,
     restore->failed = 1;
     return EINVAL;
   }
+  /* Batch up for parallel insertion if enabled */
+  if( restore->tpool ) {
+    if( sz==0UL ) {
+      restore->state = STATE_IGNORE;
+      return 0;
+    }
+    if( FD_LIKELY( sz <= restore->batch_max ) )
+      return fd_snapshot_restore_batch_prepare( restore, slot, id, sz );
+
+    /* Keep batched accounts ahead of this one */
+    int err = fd_snapshot_restore_flush( restore );
+    if( FD_UNLIKELY( err ) ) return err;
+  }
+
   restore->accv_sz   = sz;
   restore->accv_slot = slot;
   restore->accv_id   = id;
@@ -515,6 +793,21 @@ fd_snapshot_read_account_chunk( fd_snapshot_restore_t * restore,
   return buf;
 }
 
+/* fd_snapshot_read_batch_chunk copies partial account vec content into
+   the batch. */
+
+static uchar const *
+fd_snapshot_read_batch_chunk( fd_snapshot_restore_t * restore,
+                              uchar const *           buf,
+                              ulong                   bufsz ) {
+  ulong sz = fd_ulong_min( bufsz, restore->accv_sz );
+  fd_memcpy( restore->batch + restore->batch_sz, buf, sz );
+  restore->batch_sz += sz;
+  restore->accv_sz  -= sz;
+  if( restore->accv_sz == 0UL ) restore->state = STATE_IGNORE;
+  return buf+sz;
+}
+
 /* fd_snapshot_read_manifest_chunk reads partial manifest content. */
 
 static uchar const *
@@ -555,6 +848,8 @@ fd_snapshot_restore_chunk1( fd_snapshot_restore_t * restore,
     return fd_snapshot_read_account_chunk    ( restore, buf, bufsz );
   case STATE_READ_MANIFEST:
     return fd_snapshot_read_manifest_chunk   ( restore, buf, bufsz );
+  case STATE_BATCH_ACCV:
+    return fd_snapshot_read_batch_chunk      ( restore, buf, bufsz );
   default:
     __builtin_unreachable();
   }
@@ -18,6 +18,12 @@
 #include "fd_snapshot_base.h"
 #include "../../util/archive/fd_tar.h"
 #include "../runtime/context/fd_exec_slot_ctx.h"
+#include "../../util/tpool/fd_tpool.h"
+
+/* FD_SNAPSHOT_RESTORE_BATCH_MAX is the default byte capacity of the
+   account vec batch used for parallel account insertion. */
+
+#define FD_SNAPSHOT_RESTORE_BATCH_MAX (1UL<<27) /* 128 MiB */
 
 /* fd_snapshot_restore_t implements a streaming TAR reader that parses
    archive records on the fly.  Records include the manifest (at the
@@ -91,6 +97,42 @@ fd_snapshot_restore_new( void *                               mem,
 void *
 fd_snapshot_restore_delete( fd_snapshot_restore_t * self );
 
+/* fd_snapshot_restore_set_tpool enables parallel account insertion on
+   tpool threads [t0,t1).  The caller of fd_snapshot_restore_chunk /
+   fd_snapshot_restore_flush masquerades as thread t0 (i.e. tpool
+   worker t0 is not used and can be busy with something else); t1-t0
+   must be at least 2 for this to have any effect.
+
+   Account vecs up to batch_max bytes (0 selects
+   FD_SNAPSHOT_RESTORE_BATCH_MAX) are then copied into a batch buffer
+   instead of being restored as they stream in.  Once the batch is full
+   (and on fd_snapshot_restore_flush), the batch is split t1-t0 ways by
+   pubkey hash.  Each thread scans the whole batch and inserts the
+   accounts of its shard directly with fd_funk_rec_insert_para (the
+   highest slot wins, as in the serial path).  Since the shards are
+   disjoint, no account is ever touched by two threads.  Larger account
+   vecs are restored serially after flushing the batch.
+
+   Requires FD_HAS_ATOMIC; is a no-op otherwise.  Should be called before
+   any file is provided.  Returns restore. */
+
+fd_snapshot_restore_t *
+fd_snapshot_restore_set_tpool( fd_snapshot_restore_t * restore,
+                               fd_tpool_t *            tpool,
+                               ulong                   t0,
+                               ulong                   t1,
+                               ulong                   batch_max );
+
+/* fd_snapshot_restore_flush inserts all accounts buffered for parallel
+   insertion.  Must be called once the last file has been provided
+   (fd_snapshot_loader_advance does so on EOF).  Returns 0 on success
+   and an errno-compatible error code on failure (e.g. EINVAL on a
+   malformed account vec, ENOMEM if funk is full).  No-op if parallel
+   insertion is not enabled. */
+
+int
+fd_snapshot_restore_flush( fd_snapshot_restore_t * restore );
+
 /* fd_snapshot_restore_file provides a file to fd_snapshot_restore_t.
    restore is a fd_snapshot_restore_t pointer.  meta is the TAR file
    header of the file.  sz is the size of the file.  Suitable as a
@@ -59,6 +59,19 @@ typedef struct fd_snapshot_accv_map fd_snapshot_accv_map_t;
 #define MAP_KEY_HASH(k0)      fd_snapshot_accv_key_hash(k0)
 #include "../../util/tmpl/fd_map.c"
 
+/* Account vecs buffered for parallel insertion are described by
+   fd_snapshot_restore_batch_accv_t.  [off,off+sz) is the account vec
+   content within the batch buffer. */
+
+struct fd_snapshot_restore_batch_accv {
+  ulong slot;
+  ulong id;
+  ulong off;
+  ulong sz;
+};
+
+typedef struct fd_snapshot_restore_batch_accv fd_snapshot_restore_batch_accv_t;
+
 /* Main snapshot restore **********************************************/
 
 struct fd_snapshot_restore {
@@ -97,6 +110,27 @@ struct fd_snapshot_restore {
   uchar * acc_data;  /* pointer into funk acc data pending write */
   ulong   acc_pad;   /* padding size at end of account */
 
+  /* Parallel account insertion (see fd_snapshot_restore_set_tpool).
+     Account vecs are copied whole into the batch buffer and inserted
+     by tpool threads [tpool_t0,tpool_t1) when the batch fills up or on
+     fd_snapshot_restore_flush.  tpool==NULL indicates serial
+     insertion.  Batch memory is allocated from valloc on first use.
+     batch_rec[i] is the record written for the i-th account of the
+     batch (NULL if skipped). */
+
+  fd_tpool_t * tpool;
+  ulong        tpool_t0;
+  ulong        tpool_t1;
+
+  uchar *                            batch;           /* batch buffer, NULL if not allocated yet */
+  ulong                              batch_sz;        /* bytes buffered */
+  ulong                              batch_max;       /* byte capacity of batch */
+  fd_snapshot_restore_batch_accv_t * batch_accv;      /* account vecs buffered */
+  ulong                              batch_accv_cnt;
+  fd_funk_rec_t **                   batch_rec;       /* indexed by account, batch_max/sizeof(fd_solana_account_hdr_t) entries */
+  ulong                              batch_acc_cnt;   /* accounts in batch, set by flush */
+  int                                batch_err[ FD_TILE_MAX ];  /* indexed by shard */
+
   /* Consumer callback */
 
   fd_snapshot_restore_cb_manifest_fn_t cb_manifest;
@@ -111,5 +145,11 @@ struct fd_snapshot_restore {
 #define STATE_READ_ACCOUNT_HDR  ((uchar)2)  /* reading account hdr (buffered) */
 #define STATE_READ_ACCOUNT_DATA ((uchar)3)  /* reading account data (direct copy into funk) */
 #define STATE_DONE              ((uchar)4)  /* expect no more data */
+#define STATE_BATCH_ACCV        ((uchar)5)  /* reading account vec into batch (direct copy) */
+
+/* FD_SNAPSHOT_RESTORE_BATCH_ACCV_MAX is the max number of account vecs
+   in a batch. */
+
+#define FD_SNAPSHOT_RESTORE_BATCH_ACCV_MAX (65536UL)
 
 #endif /* HEADER_fd_src_flamenco_snapshot_fd_snapshot_restore_private_h */
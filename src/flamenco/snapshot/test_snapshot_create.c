@@ -0,0 +1,670 @@
+#include "fd_snapshot_create.h"
+#include "fd_snapshot_loader.h"
+#include "fd_snapshot_restore.h"
+#include "../runtime/fd_acc_mgr.h"
+#include "../runtime/context/fd_exec_epoch_ctx.h"
+#include "../types/fd_solana_block.pb.h"
+#include "../nanopb/pb_encode.h"
+#include "../../ballet/base58/fd_base58.h"
+#include "../../ballet/blake3/fd_blake3.h"
+#include "../../ballet/block/fd_microblock.h"
+#include "../../ballet/txn/fd_txn.h"
+#include "../../ballet/zstd/fd_zstd.h"
+#include "../../util/archive/fd_tar.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define TEST_SLOT          (1000UL)
+#define TEST_PARENT_SLOT   ( 998UL)  /* slot 999 was skipped */
+#define TEST_TICKS_PER_SLOT  (64UL)
+#define TEST_ACC_CNT        (256UL)
+#define TEST_TXN_MAX         (64UL)
+#define TEST_TXN_SZ         (171UL)  /* 1 sig, 2 accounts, 1 instruction with 1 byte of data */
+#define TEST_ERR_SZ           (4UL)
+
+/* test_txn describes a txn put into a block of the blockstore */
+
+struct test_txn {
+  ulong     slot;
+  fd_hash_t blockhash;
+  uchar     sig[ FD_ED25519_SIG_SZ ];
+  fd_hash_t msg_hash;
+  uchar     err[ TEST_ERR_SZ ];
+  int       has_err;
+  int       found_sig;
+  int       found_msg;
+};
+
+typedef struct test_txn test_txn_t;
+
+static test_txn_t test_txns[ TEST_TXN_MAX ];
+static ulong      test_txn_cnt;
+static fd_hash_t  test_blockhashes[ 2 ];
+
+static fd_pubkey_t
+test_acc_key( ulong i ) {
+  fd_pubkey_t key = {0};
+  key.ul[0] = i+1UL;
+  key.ul[3] = 0x5eed5eed5eed5eedUL;
+  return key;
+}
+
+static ulong
+test_acc_dlen( ulong i ) {
+  return (i*37UL) % 1500UL;
+}
+
+static ulong
+test_acc_lamports( ulong i ) {
+  return (i%17UL)==3UL ? 0UL : 1000000UL+i; /* some dead accounts */
+}
+
+static void
+test_acc_insert( fd_acc_mgr_t * acc_mgr,
+                 ulong          i ) {
+  fd_pubkey_t key  = test_acc_key( i );
+  ulong       dlen = test_acc_dlen( i );
+  fd_account_meta_t * meta = fd_acc_mgr_modify_raw( acc_mgr, NULL, &key, 1, dlen, NULL, NULL, NULL );
+  FD_TEST( meta );
+  meta->dlen           = dlen;
+  meta->info.lamports  = test_acc_lamports( i );
+  meta->info.rent_epoch = i;
+  meta->info.executable = (uchar)( (i%5UL)==0UL );
+  meta->info.owner[0]   = (uchar)i;
+  meta->hash[0]         = (uchar)( i+1UL );
+  uchar * data = (uchar *)meta + meta->hlen;
+  for( ulong j=0UL; j<dlen; j++ ) data[ j ] = (uchar)( i+j );
+}
+
+/* test_txn_write writes a legacy txn with a single signature to out and
+   records it in test_txns. */
+
+static void
+test_txn_write( uchar *    out,
+                ulong      slot,
+                fd_rng_t * rng,
+                int        has_err ) {
+  FD_TEST( test_txn_cnt<TEST_TXN_MAX );
+  test_txn_t * t = &test_txns[ test_txn_cnt++ ];
+  fd_memset( t, 0, sizeof(test_txn_t) );
+  t->slot      = slot;
+  t->blockhash = test_blockhashes[ fd_rng_uint_roll( rng, 2U ) ];
+  t->has_err   = has_err;
+  for( ulong i=0UL; i<FD_ED25519_SIG_SZ; i++ ) t->sig[ i ] = fd_rng_uchar( rng );
+  if( has_err ) {
+    t->err[0] = 6; /* InsufficientFundsForFee */
+  }
+
+  uchar * p = out;
+  *p++ = 1;                                               /* signature cnt */
+  fd_memcpy( p, t->sig, FD_ED25519_SIG_SZ ); p += FD_ED25519_SIG_SZ;
+  uchar * msg = p;
+  *p++ = 1; *p++ = 0; *p++ = 1;                           /* header */
+  *p++ = 2;                                               /* account cnt */
+  for( ulong i=0UL; i<64UL; i++ ) *p++ = fd_rng_uchar( rng );
+  fd_memcpy( p, t->blockhash.hash, sizeof(fd_hash_t) ); p += sizeof(fd_hash_t);
+  *p++ = 1;                                               /* instruction cnt */
+  *p++ = 1; *p++ = 1; *p++ = 0; *p++ = 1; *p++ = 42;      /* program, accounts, data */
+  FD_TEST( (ulong)( p-out )==TEST_TXN_SZ );
+
+  uchar txn_buf[ FD_TXN_MAX_SZ ];
+  FD_TEST( fd_txn_parse( out, TEST_TXN_SZ, txn_buf, NULL ) );
+
+  fd_blake3_t blake3[1];
+  fd_blake3_init( blake3 );
+  fd_blake3_append( blake3, "solana-tx-message-v1", 20UL );
+  fd_blake3_append( blake3, msg, (ulong)( p-msg ) );
+  fd_blake3_fini( blake3, t->msg_hash.hash );
+}
+
+/* test_txn_meta records the status of t in the blockstore txn map, the
+   way it is found in a ledger. */
+
+static void
+test_txn_meta( fd_blockstore_t *  blockstore,
+               test_txn_t const * t ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+
+  uchar err_mem[ PB_BYTES_ARRAY_T_ALLOCSIZE( TEST_ERR_SZ ) ] __attribute__((aligned(8)));
+  pb_bytes_array_t * err = (pb_bytes_array_t *)err_mem;
+  err->size = TEST_ERR_SZ;
+  fd_memcpy( err->bytes, t->err, TEST_ERR_SZ );
+  fd_solblock_TransactionStatusMeta txn_status = {0};
+  txn_status.has_err = 1;
+  txn_status.err.err = err;
+  txn_status.fee     = 5000UL;
+
+  uchar * buf = fd_wksp_alloc_laddr( wksp, 1UL, 256UL, 1UL );
+  FD_TEST( buf );
+  pb_ostream_t stream = pb_ostream_from_buffer( buf, 256UL );
+  FD_TEST( pb_encode( &stream, fd_solblock_TransactionStatusMeta_fields, &txn_status ) );
+
+  fd_blockstore_txn_key_t key;
+  fd_memcpy( &key, t->sig, sizeof(key) );
+  fd_blockstore_txn_map_t * ele = fd_blockstore_txn_map_insert( fd_blockstore_txn_map( blockstore ), &key );
+  FD_TEST( ele );
+  ele->slot       = t->slot;
+  ele->meta_gaddr = fd_wksp_gaddr_fast( wksp, buf );
+  ele->meta_sz    = stream.bytes_written;
+  ele->meta_owned = 0;
+}
+
+/* test_block_insert adds a block for slot with parent to the
+   blockstore.  The block has tick_cnt ticks and a microblock with
+   txn_cnt txns after every 16 ticks. */
+
+static void
+test_block_insert( fd_blockstore_t * blockstore,
+                   ulong             slot,
+                   ulong             parent,
+                   ulong             tick_cnt,
+                   ulong             txn_cnt,
+                   fd_rng_t *        rng ) {
+  fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
+
+  ulong batch_cnt = tick_cnt/16UL;
+  ulong micro_cnt = tick_cnt + batch_cnt;
+  ulong data_max  = sizeof(ulong) + micro_cnt*sizeof(fd_microblock_hdr_t) + batch_cnt*txn_cnt*TEST_TXN_SZ;
+
+  fd_block_t *         block  = fd_wksp_alloc_laddr( wksp, alignof(fd_block_t),         sizeof(fd_block_t),                                 1UL );
+  uchar *              data   = fd_wksp_alloc_laddr( wksp, 128UL,                       data_max,                                           1UL );
+  fd_block_micro_t *   micros = fd_wksp_alloc_laddr( wksp, alignof(fd_block_micro_t),   micro_cnt*sizeof(fd_block_micro_t),                 1UL );
+  fd_block_txn_ref_t * txns   = fd_wksp_alloc_laddr( wksp, alignof(fd_block_txn_ref_t), fd_ulong_max( batch_cnt*txn_cnt, 1UL )*sizeof(fd_block_txn_ref_t), 1UL );
+  FD_TEST( block && data && micros && txns );
+
+  ulong off      = 0UL;
+  ulong m        = 0UL;
+  ulong txns_cnt = 0UL;
+  FD_STORE( ulong, data, micro_cnt ); off += sizeof(ulong);
+  for( ulong i=0UL; i<tick_cnt; i++ ) {
+    if( (i%16UL)==15UL ) {
+      fd_microblock_hdr_t * hdr = (fd_microblock_hdr_t *)( data+off );
+      fd_memset( hdr, 0, sizeof(fd_microblock_hdr_t) );
+      hdr->hash_cnt = 1UL;
+      hdr->txn_cnt  = txn_cnt;
+      micros[ m++ ].off = off;
+      off += sizeof(fd_microblock_hdr_t);
+      for( ulong j=0UL; j<txn_cnt; j++ ) {
+        test_txn_write( data+off, slot, rng, j==1UL );
+        txns[ txns_cnt ].txn_off = off;
+        txns[ txns_cnt ].id_off  = off+1UL;
+        txns[ txns_cnt ].sz      = TEST_TXN_SZ;
+        txns_cnt++;
+        if( test_txns[ test_txn_cnt-1UL ].has_err ) test_txn_meta( blockstore, &test_txns[ test_txn_cnt-1UL ] );
+        off += TEST_TXN_SZ;
+      }
+    }
+    fd_microblock_hdr_t * hdr = (fd_microblock_hdr_t *)( data+off );
+    fd_memset( hdr, 0, sizeof(fd_microblock_hdr_t) );
+    hdr->hash_cnt = 12500UL;
+    micros[ m++ ].off = off;
+    off += sizeof(fd_microblock_hdr_t);
+  }
+  FD_TEST( off==data_max && m==micro_cnt );
+
+  fd_memset( block, 0, sizeof(fd_block_t) );
+  block->data_gaddr   = fd_wksp_gaddr_fast( wksp, data   );
+  block->data_sz      = data_max;
+  block->micros_gaddr = fd_wksp_gaddr_fast( wksp, micros );
+  block->micros_cnt   = micro_cnt;
+  block->txns_gaddr   = fd_wksp_gaddr_fast( wksp, txns   );
+  block->txns_cnt     = txns_cnt;
+
+  fd_blockstore_start_write( blockstore );
+  fd_blockstore_slot_map_t * slot_entry = fd_blockstore_slot_map_insert( fd_blockstore_slot_map( blockstore ), &slot );
+  FD_TEST( slot_entry );
+  fd_memset( &slot_entry->slot_meta, 0, sizeof(fd_slot_meta_t) );
+  slot_entry->slot_meta.slot        = slot;
+  slot_entry->slot_meta.parent_slot = parent;
+  slot_entry->block_gaddr           = fd_wksp_gaddr_fast( wksp, block );
+  fd_blockstore_end_write( blockstore );
+}
+
+/* test_bank_init populates the bank of slot_ctx */
+
+static void
+test_bank_init( fd_exec_slot_ctx_t * slot_ctx,
+                fd_rng_t *           rng ) {
+  fd_valloc_t       valloc     = slot_ctx->valloc;
+  fd_slot_bank_t *  slot_bank  = &slot_ctx->slot_bank;
+  fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( slot_ctx->epoch_ctx );
+
+  epoch_bank->ticks_per_slot                          = TEST_TICKS_PER_SLOT;
+  epoch_bank->hashes_per_tick                         = 12500UL;
+  epoch_bank->ns_per_slot                             = 400000000UL;
+  epoch_bank->genesis_creation_time                   = 1584368940UL;
+  epoch_bank->slots_per_year                          = 78892314.983999997;
+  epoch_bank->epoch_schedule.slots_per_epoch          = 432000UL;
+  epoch_bank->epoch_schedule.leader_schedule_slot_offset = 432000UL;
+  epoch_bank->rent.lamports_per_uint8_year            = 3480UL;
+  epoch_bank->rent.exemption_threshold                = 2.0;
+  epoch_bank->rent.burn_percent                       = 50;
+  epoch_bank->inflation.initial                       = 0.08;
+
+  slot_bank->slot                   = TEST_SLOT;
+  slot_bank->prev_slot              = TEST_PARENT_SLOT;
+  slot_bank->max_tick_height        = TEST_TICKS_PER_SLOT*( TEST_SLOT+1UL );
+  slot_bank->capitalization         = 555555555555UL;
+  slot_bank->block_height           = 990UL;
+  slot_bank->lamports_per_signature = 5000UL;
+  slot_bank->transaction_count      = 123456UL;
+  slot_bank->collected_fees         = 77UL;
+  slot_bank->collected_rent         = 88UL;
+  for( ulong i=0UL; i<32UL; i++ ) slot_bank->banks_hash.uc[ i ]         = fd_rng_uchar( rng );
+  for( ulong i=0UL; i<32UL; i++ ) slot_bank->epoch_account_hash.uc[ i ] = fd_rng_uchar( rng );
+
+  slot_bank->hard_forks.hard_forks_len = 2UL;
+  slot_bank->hard_forks.hard_forks     = fd_valloc_malloc( valloc, alignof(fd_slot_pair_t), 2UL*sizeof(fd_slot_pair_t) );
+  FD_TEST( slot_bank->hard_forks.hard_forks );
+  slot_bank->hard_forks.hard_forks[0] = (fd_slot_pair_t){ .slot =   10UL, .val = 1UL };
+  slot_bank->hard_forks.hard_forks[1] = (fd_slot_pair_t){ .slot =  500UL, .val = 2UL };
+  slot_bank->last_restart_slot.slot   = 500UL;
+
+  fd_block_hash_queue_t * bhq = &slot_bank->block_hash_queue;
+  bhq->last_hash_index = 7UL;
+  bhq->max_age         = 300UL;
+  bhq->last_hash       = fd_valloc_malloc( valloc, FD_HASH_ALIGN, FD_HASH_FOOTPRINT );
+  bhq->ages_pool       = fd_hash_hash_age_pair_t_map_alloc( valloc, 400 );
+  bhq->ages_root       = NULL;
+  FD_TEST( bhq->last_hash && bhq->ages_pool );
+  for( ulong i=0UL; i<4UL; i++ ) {
+    fd_hash_hash_age_pair_t_mapnode_t * node = fd_hash_hash_age_pair_t_map_acquire( bhq->ages_pool );
+    fd_memset( &node->elem, 0, sizeof(fd_hash_hash_age_pair_t) );
+    for( ulong j=0UL; j<32UL; j++ ) node->elem.key.uc[ j ] = fd_rng_uchar( rng );
+    node->elem.val.hash_index                            = 4UL+i;
+    node->elem.val.timestamp                             = 1700000000UL+i;
+    node->elem.val.fee_calculator.lamports_per_signature = 5000UL;
+    if( i<2UL ) test_blockhashes[ i ] = node->elem.key;
+    if( i==3UL ) *bhq->last_hash = node->elem.key;
+    fd_hash_hash_age_pair_t_map_insert( bhq->ages_pool, &bhq->ages_root, node );
+  }
+}
+
+/* Restore ************************************************************/
+
+static ulong test_restore_tick_height;
+
+static int
+test_restore_manifest( void *                 ctx,
+                       fd_solana_manifest_t * manifest ) {
+  test_restore_tick_height = manifest->bank.tick_height;
+  return fd_exec_slot_ctx_recover( ctx, manifest ) ? 0 : EINVAL;
+}
+
+struct test_status_cache {
+  uchar * buf;
+  ulong   sz;
+  ulong   max;
+  int     in_status_cache;
+};
+
+typedef struct test_status_cache test_status_cache_t;
+
+static int
+test_tar_file( void *                cb_arg,
+               fd_tar_meta_t const * meta,
+               ulong                 sz ) {
+  test_status_cache_t * sc = cb_arg;
+  sc->in_status_cache = !strcmp( meta->name, "snapshots/status_cache" );
+  if( sc->in_status_cache ) FD_TEST( sz<=sc->max );
+  return 0;
+}
+
+static int
+test_tar_read( void *       cb_arg,
+               void const * buf,
+               ulong        bufsz ) {
+  test_status_cache_t * sc = cb_arg;
+  if( !sc->in_status_cache ) return 0;
+  fd_memcpy( sc->buf+sc->sz, buf, bufsz );
+  sc->sz += bufsz;
+  return 0;
+}
+
+static fd_tar_read_vtable_t const test_tar_vt = { .file = test_tar_file, .read = test_tar_read };
+
+/* test_status_cache_check extracts the status cache from the snapshot
+   at path and checks that it has every txn of test_txns. */
+
+static void
+test_status_cache_check( fd_wksp_t *  wksp,
+                         char const * path ) {
+
+  FILE * file = fopen( path, "rb" );
+  FD_TEST( file );
+  FD_TEST( !fseek( file, 0L, SEEK_END ) );
+  ulong zsz = (ulong)ftell( file );
+  FD_TEST( !fseek( file, 0L, SEEK_SET ) );
+
+  ulong   window_sz = 1UL<<23;
+  uchar * zbuf      = fd_wksp_alloc_laddr( wksp, 1UL, zsz, 1UL );
+  ulong   out_max   = 1UL<<20;
+  uchar * out       = fd_wksp_alloc_laddr( wksp, 1UL, out_max, 1UL );
+  void *  dmem      = fd_wksp_alloc_laddr( wksp, fd_zstd_dstream_align(), fd_zstd_dstream_footprint( window_sz ), 1UL );
+  test_status_cache_t sc = { .max = 1UL<<20 };
+  sc.buf = fd_wksp_alloc_laddr( wksp, 1UL, sc.max, 1UL );
+  FD_TEST( zbuf && out && dmem && sc.buf );
+  FD_TEST( fread( zbuf, 1UL, zsz, file )==zsz );
+  FD_TEST( !fclose( file ) );
+
+  fd_zstd_dstream_t * dstream = fd_zstd_dstream_new( dmem, window_sz );
+  fd_tar_reader_t     reader[1];
+  FD_TEST( fd_tar_reader_new( reader, &test_tar_vt, &sc ) );
+
+  uchar const * in     = zbuf;
+  uchar const * in_end = zbuf + zsz;
+  int           eof    = 0;
+  while( in<in_end && !eof ) {
+    uchar * o  = out;
+    int     rc = fd_zstd_dstream_read( dstream, &in, in_end, &o, out+out_max, NULL );
+    FD_TEST( rc==0 || rc==-1 );
+    int err = fd_tar_read( reader, out, (ulong)( o-out ) );
+    FD_TEST( err==0 || err==-1 );
+    eof = err==-1;
+  }
+  FD_TEST( eof );
+  fd_tar_reader_delete( reader );
+  fd_zstd_dstream_delete( dstream );
+
+  /* Decode Vec<BankSlotDelta> */
+
+  for( ulong i=0UL; i<test_txn_cnt; i++ ) test_txns[ i ].found_sig = test_txns[ i ].found_msg = 0;
+
+  fd_bincode_decode_ctx_t decode = { .data = sc.buf, .dataend = sc.buf+sc.sz };
+  ulong slot_cnt; FD_TEST( !fd_bincode_uint64_decode( &slot_cnt, &decode ) );
+  FD_TEST( slot_cnt==3UL );
+  static ulong const slots[3] = { TEST_SLOT, TEST_PARENT_SLOT, TEST_PARENT_SLOT-1UL };
+  for( ulong i=0UL; i<slot_cnt; i++ ) {
+    ulong slot;      FD_TEST( !fd_bincode_uint64_decode( &slot,      &decode ) );
+    uchar is_root;   FD_TEST( !fd_bincode_uint8_decode ( &is_root,   &decode ) );
+    ulong group_cnt; FD_TEST( !fd_bincode_uint64_decode( &group_cnt, &decode ) );
+    FD_TEST( slot==slots[ i ] && is_root==1 && group_cnt>=1UL && group_cnt<=2UL );
+    for( ulong g=0UL; g<group_cnt; g++ ) {
+      fd_hash_t blockhash;
+      FD_TEST( !fd_bincode_bytes_decode( blockhash.hash, sizeof(fd_hash_t), &decode ) );
+      ulong key_index; FD_TEST( !fd_bincode_uint64_decode( &key_index, &decode ) );
+      ulong key_cnt;   FD_TEST( !fd_bincode_uint64_decode( &key_cnt,   &decode ) );
+      FD_TEST( key_index==0UL );
+      for( ulong k=0UL; k<key_cnt; k++ ) {
+        uchar key[ 20 ];
+        uint  result;
+        FD_TEST( !fd_bincode_bytes_decode( key, 20UL, &decode ) );
+        FD_TEST( !fd_bincode_uint32_decode( &result, &decode ) );
+        uchar err[ TEST_ERR_SZ ];
+        if( result ) {
+          FD_TEST( result==1U );
+          FD_TEST( !fd_bincode_bytes_decode( err, TEST_ERR_SZ, &decode ) );
+        }
+
+        test_txn_t * t = NULL;
+        for( ulong j=0UL; j<test_txn_cnt; j++ ) {
+          if( !memcmp( key, test_txns[ j ].sig, 20UL ) ) { FD_TEST( !test_txns[ j ].found_sig ); test_txns[ j ].found_sig = 1; t = &test_txns[ j ]; }
+          if( !memcmp( key, test_txns[ j ].msg_hash.hash, 20UL ) ) { FD_TEST( !test_txns[ j ].found_msg ); test_txns[ j ].found_msg = 1; t = &test_txns[ j ]; }
+        }
+        FD_TEST( t );
+        FD_TEST( t->slot==slot );
+        FD_TEST( !memcmp( t->blockhash.hash, blockhash.hash, sizeof(fd_hash_t) ) );
+        FD_TEST( !!result==t->has_err );
+        if( result ) FD_TEST( !memcmp( err, t->err, TEST_ERR_SZ ) );
+      }
+    }
+  }
+  FD_TEST( decode.data==decode.dataend );
+  for( ulong i=0UL; i<test_txn_cnt; i++ ) FD_TEST( test_txns[ i ].found_sig && test_txns[ i ].found_msg );
+
+  fd_wksp_free_laddr( sc.buf );
+  fd_wksp_free_laddr( dmem   );
+  fd_wksp_free_laddr( out    );
+  fd_wksp_free_laddr( zbuf   );
+}
+
+/* test_restore_check loads the snapshot at path into a new funk and
+   slot context and compares them against src. */
+
+static void
+test_restore_check( fd_wksp_t *                  wksp,
+                    fd_valloc_t                  valloc,
+                    char *                       path,
+                    fd_exec_slot_ctx_t const *   src ) {
+
+  ulong const funk_tag = 43UL;
+  fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), funk_tag ), funk_tag, 1234UL, 16UL, 1024UL ) );
+  FD_TEST( funk );
+  fd_funk_start_write( funk );
+  fd_acc_mgr_t * acc_mgr = fd_acc_mgr_new( fd_wksp_alloc_laddr( wksp, FD_ACC_MGR_ALIGN, FD_ACC_MGR_FOOTPRINT, 1UL ), funk );
+
+  fd_exec_epoch_ctx_t * epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new(
+      fd_wksp_alloc_laddr( wksp, fd_exec_epoch_ctx_align(), fd_exec_epoch_ctx_footprint( 16UL ), 1UL ), 16UL ) );
+  fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new(
+      fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, 1UL ), valloc ) );
+  FD_TEST( acc_mgr && epoch_ctx && slot_ctx );
+  slot_ctx->epoch_ctx = epoch_ctx;
+  slot_ctx->acc_mgr   = acc_mgr;
+
+  ulong const window_sz = 1UL<<23;
+  void * restore_mem = fd_wksp_alloc_laddr( wksp, fd_snapshot_restore_align(), fd_snapshot_restore_footprint(),       1UL );
+  void * loader_mem  = fd_wksp_alloc_laddr( wksp, fd_snapshot_loader_align(),  fd_snapshot_loader_footprint( window_sz ), 1UL );
+  fd_snapshot_restore_t * restore = fd_snapshot_restore_new( restore_mem, acc_mgr, NULL, valloc, slot_ctx, test_restore_manifest );
+  fd_snapshot_loader_t *  loader  = fd_snapshot_loader_new( loader_mem, window_sz );
+  FD_TEST( restore && loader );
+
+  fd_snapshot_src_t src_[1];
+  FD_TEST( fd_snapshot_src_parse( src_, path ) );
+  FD_TEST( fd_snapshot_loader_init( loader, restore, src_, 0UL ) );
+  test_restore_tick_height = 0UL;
+  for(;;) {
+    int err = fd_snapshot_loader_advance( loader );
+    if( err==-1 ) break;
+    FD_TEST( !err );
+  }
+  fd_snapshot_loader_delete( loader );
+  fd_snapshot_restore_delete( restore );
+
+  /* Bank */
+
+  fd_slot_bank_t const *  s0 = &src->slot_bank;
+  fd_slot_bank_t const *  s1 = &slot_ctx->slot_bank;
+  fd_epoch_bank_t const * e0 = fd_exec_epoch_ctx_epoch_bank( src->epoch_ctx );
+  fd_epoch_bank_t const * e1 = fd_exec_epoch_ctx_epoch_bank( epoch_ctx );
+
+  FD_TEST( s1->slot==s0->slot );
+  FD_TEST( s1->prev_slot==s0->prev_slot );
+  FD_TEST( s1->max_tick_height==s0->max_tick_height );
+  FD_TEST( test_restore_tick_height==s0->max_tick_height );
+  FD_TEST( s1->capitalization==s0->capitalization );
+  FD_TEST( s1->block_height==s0->block_height );
+  FD_TEST( s1->lamports_per_signature==s0->lamports_per_signature );
+  FD_TEST( s1->transaction_count==s0->transaction_count );
+  FD_TEST( s1->collected_fees==s0->collected_fees );
+  FD_TEST( s1->collected_rent==s0->collected_rent );
+  FD_TEST( !memcmp( s1->banks_hash.hash,         s0->banks_hash.hash,         sizeof(fd_hash_t) ) );
+  FD_TEST( !memcmp( s1->epoch_account_hash.hash, s0->epoch_account_hash.hash, sizeof(fd_hash_t) ) );
+  FD_TEST( e1->ticks_per_slot==e0->ticks_per_slot );
+  FD_TEST( e1->hashes_per_tick==e0->hashes_per_tick );
+  FD_TEST( e1->epoch_schedule.slots_per_epoch==e0->epoch_schedule.slots_per_epoch );
+
+  FD_TEST( s1->hard_forks.hard_forks_len==s0->hard_forks.hard_forks_len );
+  FD_TEST( !memcmp( s1->hard_forks.hard_forks, s0->hard_forks.hard_forks, s0->hard_forks.hard_forks_len*sizeof(fd_slot_pair_t) ) );
+  FD_TEST( s1->last_restart_slot.slot==s0->last_restart_slot.slot );
+
+  fd_block_hash_queue_t const * q0 = &s0->block_hash_queue;
+  fd_block_hash_queue_t const * q1 = &s1->block_hash_queue;
+  FD_TEST( q1->last_hash_index==q0->last_hash_index );
+  FD_TEST( q1->max_age==q0->max_age );
+  FD_TEST( !memcmp( q1->last_hash->hash, q0->last_hash->hash, sizeof(fd_hash_t) ) );
+  FD_TEST( fd_hash_hash_age_pair_t_map_size( q1->ages_pool, q1->ages_root )==fd_hash_hash_age_pair_t_map_size( q0->ages_pool, q0->ages_root ) );
+  for( fd_hash_hash_age_pair_t_mapnode_t * n = fd_hash_hash_age_pair_t_map_minimum( q0->ages_pool, q0->ages_root );
+       n;
+       n = fd_hash_hash_age_pair_t_map_successor( q0->ages_pool, n ) ) {
+    fd_hash_hash_age_pair_t_mapnode_t * m = fd_hash_hash_age_pair_t_map_find( q1->ages_pool, q1->ages_root, n );
+    FD_TEST( m );
+    FD_TEST( !memcmp( &m->elem, &n->elem, sizeof(fd_hash_hash_age_pair_t) ) );
+  }
+
+  /* Accounts */
+
+  for( ulong i=0UL; i<TEST_ACC_CNT; i++ ) {
+    fd_pubkey_t key = test_acc_key( i );
+    fd_account_meta_t const * meta = fd_acc_mgr_view_raw( acc_mgr, NULL, &key, NULL, NULL );
+    if( !test_acc_lamports( i ) ) {
+      FD_TEST( !meta );
+      continue;
+    }
+    FD_TEST( meta );
+    FD_TEST( meta->dlen==test_acc_dlen( i ) );
+    FD_TEST( meta->info.lamports==test_acc_lamports( i ) );
+    FD_TEST( meta->info.rent_epoch==i );
+    FD_TEST( meta->info.executable==(uchar)( (i%5UL)==0UL ) );
+    FD_TEST( meta->info.owner[0]==(uchar)i );
+    uchar const * data = (uchar const *)meta + meta->hlen;
+    for( ulong j=0UL; j<meta->dlen; j++ ) FD_TEST( data[ j ]==(uchar)( i+j ) );
+  }
+
+  fd_exec_slot_ctx_free( slot_ctx );
+  fd_exec_epoch_ctx_epoch_bank_delete( epoch_ctx );
+  fd_wksp_free_laddr( fd_exec_epoch_ctx_delete( fd_exec_epoch_ctx_leave( epoch_ctx ) ) );
+  fd_wksp_free_laddr( loader_mem  );
+  fd_wksp_free_laddr( restore_mem );
+  fd_wksp_free_laddr( fd_acc_mgr_delete( acc_mgr ) );
+  fd_funk_end_write( funk );
+  fd_wksp_free_laddr( fd_funk_delete( fd_funk_leave( funk ) ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal"        );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 131072UL        );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s)", page_cnt, _page_sz ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_alloc_t * alloc = fd_alloc_join( fd_alloc_new( fd_wksp_alloc_laddr( wksp, fd_alloc_align(), fd_alloc_footprint(), 41UL ), 41UL ), 0UL );
+  FD_TEST( alloc );
+  fd_valloc_t valloc = fd_alloc_virtual( alloc );
+
+  static uchar smem[ 1UL<<20 ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+  ulong fmem[ 16 ];
+  fd_scratch_attach( smem, fmem, sizeof(smem), 16UL );
+
+  /* Source funk, blockstore and slot context */
+
+  ulong const funk_tag = 42UL;
+  fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), funk_tag ), funk_tag, 4321UL, 16UL, 1024UL ) );
+  FD_TEST( funk );
+  fd_funk_start_write( funk );
+  fd_acc_mgr_t * acc_mgr = fd_acc_mgr_new( fd_wksp_alloc_laddr( wksp, FD_ACC_MGR_ALIGN, FD_ACC_MGR_FOOTPRINT, 1UL ), funk );
+  FD_TEST( acc_mgr );
+
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new(
+      fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint(), 1UL ), 1UL, 42UL, 1024UL, 64UL, 10 ) );
+  FD_TEST( blockstore );
+
+  fd_exec_epoch_ctx_t * epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new(
+      fd_wksp_alloc_laddr( wksp, fd_exec_epoch_ctx_align(), fd_exec_epoch_ctx_footprint( 16UL ), 1UL ), 16UL ) );
+  fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new(
+      fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, 1UL ), valloc ) );
+  FD_TEST( epoch_ctx && slot_ctx );
+  slot_ctx->epoch_ctx  = epoch_ctx;
+  slot_ctx->acc_mgr    = acc_mgr;
+  slot_ctx->blockstore = blockstore;
+
+  for( ulong i=0UL; i<TEST_ACC_CNT; i++ ) test_acc_insert( acc_mgr, i );
+  test_bank_init( slot_ctx, rng );
+
+  /* Blocks TEST_SLOT -> TEST_PARENT_SLOT -> TEST_PARENT_SLOT-1 on top
+     of the slot the runtime was booted from.  The block of TEST_SLOT
+     has the ticks of the skipped slot. */
+
+  fd_slot_bank_t boot_bank[1];
+  fd_slot_bank_new( boot_bank );
+  boot_bank->slot      = TEST_PARENT_SLOT-2UL;
+  boot_bank->prev_slot = TEST_PARENT_SLOT-3UL;
+  fd_blockstore_start_write( blockstore );
+  fd_blockstore_snapshot_insert( blockstore, boot_bank );
+  fd_blockstore_end_write( blockstore );
+  test_block_insert( blockstore, TEST_PARENT_SLOT-1UL, TEST_PARENT_SLOT-2UL, TEST_TICKS_PER_SLOT,     3UL, rng );
+  test_block_insert( blockstore, TEST_PARENT_SLOT,     TEST_PARENT_SLOT-1UL, TEST_TICKS_PER_SLOT,     2UL, rng );
+  test_block_insert( blockstore, TEST_SLOT,            TEST_PARENT_SLOT,     2UL*TEST_TICKS_PER_SLOT, 3UL, rng );
+
+  /* Snapshot path */
+
+  char dir[] = "/tmp/test_snapshot_create.XXXXXX";
+  FD_TEST( mkdtemp( dir ) );
+  char hash_cstr[ FD_BASE58_ENCODED_32_SZ ];
+  fd_base58_encode_32( slot_ctx->slot_bank.banks_hash.uc, NULL, hash_cstr );
+  char path[ PATH_MAX ];
+  FD_TEST( fd_cstr_printf_check( path, PATH_MAX, NULL, "%s/snapshot-%lu-%s.tar.zst", dir, TEST_SLOT, hash_cstr ) );
+
+  ulong const worker_max     = 4UL;
+  ulong const compress_bufsz = 1UL<<16;
+  ulong const funk_rec_cnt   = fd_funk_rec_max( funk );
+  ulong const batch_acc_cnt  = 16UL;
+  ulong const max_accv_sz    = 1UL<<14;
+  void * create_mem = fd_wksp_alloc_laddr( wksp, fd_snapshot_create_align(),
+      fd_snapshot_create_footprint( worker_max, 3, compress_bufsz, funk_rec_cnt, batch_acc_cnt ), 1UL );
+  fd_snapshot_create_t * create = fd_snapshot_create_new( create_mem, slot_ctx, path, worker_max, 3, compress_bufsz, funk_rec_cnt, batch_acc_cnt, max_accv_sz, rng );
+  FD_TEST( create );
+
+  /* Serial create */
+
+  FD_TEST( fd_snapshot_create( create, slot_ctx ) );
+  test_restore_check( wksp, valloc, path, slot_ctx );
+  test_status_cache_check( wksp, path );
+
+  /* Parallel create */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: parallel snapshot create test requires at least 2 tiles (use --tile-cpus)" ));
+  } else {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    fd_tpool_t * tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL ) );
+
+    FD_TEST( !unlink( path ) );
+    FD_TEST( fd_snapshot_create_tpool( create, slot_ctx, tpool, tile_cnt ) );
+    test_restore_check( wksp, valloc, path, slot_ctx );
+    test_status_cache_check( wksp, path );
+
+    FD_TEST( fd_tpool_fini( tpool ) );
+  }
+
+  /* A bank missing ticks is not complete (the block of TEST_SLOT only
+     has the ticks of two slots but would need three) */
+
+  FD_TEST( !unlink( path ) );
+  slot_ctx->slot_bank.prev_slot = TEST_PARENT_SLOT-1UL;
+  FD_TEST( !fd_snapshot_create( create, slot_ctx ) );
+  FD_TEST( access( path, F_OK ) );
+  slot_ctx->slot_bank.prev_slot = TEST_PARENT_SLOT;
+
+  fd_wksp_free_laddr( fd_snapshot_create_delete( create ) );
+  FD_TEST( !rmdir( dir ) );
+  fd_exec_slot_ctx_free( slot_ctx );
+  fd_exec_epoch_ctx_epoch_bank_delete( epoch_ctx );
+  fd_wksp_free_laddr( fd_exec_epoch_ctx_delete( fd_exec_epoch_ctx_leave( epoch_ctx ) ) );
+  fd_wksp_free_laddr( fd_blockstore_leave( blockstore ) );
+  fd_wksp_free_laddr( fd_acc_mgr_delete( acc_mgr ) );
+  fd_funk_end_write( funk );
+  fd_wksp_free_laddr( fd_funk_delete( fd_funk_leave( funk ) ) );
+  fd_scratch_detach( NULL );
+  fd_wksp_free_laddr( fd_alloc_delete( fd_alloc_leave( alloc ) ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,272 @@
+#include "fd_snapshot_istream.h"
+#include "../../ballet/zstd/fd_zstd.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+/* test_src_t is an in-memory fd_io_istream source that returns at most
+   chunk_max bytes per read (to exercise partial frames). */
+
+struct test_src {
+  uchar const * buf;
+  ulong         sz;
+  ulong         off;
+  ulong         chunk_max;
+  fd_rng_t *    rng;
+};
+
+typedef struct test_src test_src_t;
+
+static int
+test_src_read( void *  _this,
+               void *  dst,
+               ulong   dst_max,
+               ulong * dst_sz ) {
+  test_src_t * this = _this;
+  if( this->off==this->sz ) return -1;
+  ulong sz = fd_ulong_min( fd_ulong_min( dst_max, this->sz - this->off ), 1UL + fd_rng_ulong_roll( this->rng, this->chunk_max ) );
+  fd_memcpy( dst, this->buf + this->off, sz );
+  this->off += sz;
+  *dst_sz = sz;
+  return 0;
+}
+
+static fd_io_istream_vt_t const test_src_vt = { .read = test_src_read };
+
+#define TEST_DATA_MAX (1UL<<21)
+
+static uchar test_data[ TEST_DATA_MAX ];  /* decompressed */
+static uchar test_comp[ TEST_DATA_MAX+(1UL<<16) ];
+static uchar test_out [ TEST_DATA_MAX ];
+
+/* test_gen fills test_data with data_sz bytes and compresses it to
+   frames of frame_sz bytes each, except for a frame of big_sz random
+   (incompressible) bytes at big_off (if big_sz!=0).  Returns the
+   compressed size. */
+
+static ulong
+test_gen( fd_zstd_cstream_t * cstream,
+          fd_rng_t *          rng,
+          ulong               data_sz,
+          ulong               frame_sz,
+          ulong               big_off,
+          ulong               big_sz ) {
+  FD_TEST( data_sz<=TEST_DATA_MAX );
+  for( ulong i=0UL; i<data_sz; i++ ) {
+    int random = (i>=big_off) & (i<big_off+big_sz);
+    test_data[ i ] = random ? fd_rng_uchar( rng ) : (uchar)( (i/64UL) ^ (fd_rng_uint_roll( rng, 8U )==0U) );
+  }
+
+  uchar * out     = test_comp;
+  uchar * out_end = test_comp + sizeof(test_comp);
+  ulong   off     = 0UL;
+  while( off<data_sz ) {
+    ulong sz = frame_sz;
+    if( big_sz && off==big_off ) sz = big_sz;
+    else if( big_sz && off<big_off ) sz = fd_ulong_min( sz, big_off-off );
+    sz = fd_ulong_min( sz, data_sz-off );
+
+    uchar const * in     = test_data + off;
+    uchar const * in_end = in + sz;
+    fd_zstd_cstream_reset( cstream );
+    for(;;) {
+      int rc = fd_zstd_cstream_compress( cstream, &in, in_end, &out, out_end, 1, NULL );
+      FD_TEST( rc<=0 );
+      if( rc==-1 ) break;
+    }
+    off += sz;
+  }
+  return (ulong)( out - test_comp );
+}
+
+/* test_read reads the decompressed stream in chunks of random size
+   and returns the final error code (-1 on EOF). */
+
+static int
+test_read( fd_io_istream_zstd_para_t * para,
+           fd_rng_t *                  rng,
+           ulong *                     out_sz ) {
+  ulong off = 0UL;
+  for(;;) {
+    ulong sz  = 0UL;
+    ulong max = fd_ulong_min( 1UL + fd_rng_ulong_roll( rng, 20000UL ), sizeof(test_out) - off );
+    int   err = fd_io_istream_zstd_para_read( para, test_out + off, max, &sz );
+    if( err ) { *out_sz = off; return err; }
+    FD_TEST( sz<=max );
+    off += sz;
+  }
+}
+
+/* test_roundtrip decompresses test_comp[0,comp_sz) and checks that it
+   matches test_data[0,data_sz).  Returns the max number of frames in
+   flight. */
+
+static ulong
+test_roundtrip( void *              mem,
+                fd_tpool_t *        tpool,
+                ulong               t0,
+                ulong               t1,
+                ulong               in_max,
+                ulong               out_max,
+                ulong               comp_sz,
+                ulong               data_sz,
+                fd_rng_t *          rng,
+                int                 expect_stream ) {
+  test_src_t src = { .buf = test_comp, .sz = comp_sz, .chunk_max = in_max/3UL, .rng = rng };
+  fd_io_istream_obj_t vsrc = { .this = &src, .vt = &test_src_vt };
+  fd_io_istream_zstd_para_t * para = fd_io_istream_zstd_para_new( mem, tpool, t0, t1, 1UL<<20, in_max, out_max, vsrc );
+  FD_TEST( para );
+
+  int   stream  = 0;
+  ulong cnt_max = 0UL;
+  ulong off     = 0UL;
+  for(;;) {
+    ulong sz  = 0UL;
+    ulong max = fd_ulong_min( 1UL + fd_rng_ulong_roll( rng, 20000UL ), sizeof(test_out) - off );
+    int   err = fd_io_istream_zstd_para_read( para, test_out + off, max, &sz );
+    stream |= para->stream;
+    cnt_max = fd_ulong_max( cnt_max, para->cnt );
+    if( err ) { FD_TEST( err==-1 ); break; }
+    off += sz;
+  }
+  FD_TEST( off==data_sz );
+  FD_TEST( !memcmp( test_out, test_data, data_sz ) );
+  FD_TEST( stream==expect_stream );
+  FD_TEST( !para->stream );  /* back to parallel mode after the big frame */
+  FD_TEST( !para->cnt );
+  FD_TEST( src.off==src.sz );
+  FD_TEST( fd_io_istream_zstd_para_delete( para )==mem );
+  return cnt_max;
+}
+
+static void
+test_fail( void *              mem,
+           fd_tpool_t *        tpool,
+           ulong               t0,
+           ulong               t1,
+           ulong               in_max,
+           ulong               out_max,
+           ulong               comp_sz,
+           fd_rng_t *          rng ) {
+  test_src_t src = { .buf = test_comp, .sz = comp_sz, .chunk_max = in_max/3UL, .rng = rng };
+  fd_io_istream_obj_t vsrc = { .this = &src, .vt = &test_src_vt };
+  fd_io_istream_zstd_para_t * para = fd_io_istream_zstd_para_new( mem, tpool, t0, t1, 1UL<<20, in_max, out_max, vsrc );
+  FD_TEST( para );
+  ulong out_sz;
+  FD_TEST( test_read( para, rng, &out_sz )==EPROTO );
+  FD_TEST( fd_io_istream_zstd_para_delete( para )==mem );
+}
+
+static void
+test_para( void *              mem,
+           fd_tpool_t *        tpool,
+           ulong               t0,
+           ulong               t1,
+           fd_zstd_cstream_t * cstream,
+           fd_rng_t *          rng ) {
+
+  ulong const in_max  = 1UL<<16;
+  ulong const out_max = 1UL<<16;
+
+  /* Many frames, each decompressing to several output halves.  The
+     frames in flight wrap around the arena many times. */
+
+  ulong data_sz = 1UL<<21;
+  ulong comp_sz = test_gen( cstream, rng, data_sz, 123456UL, 0UL, 0UL );
+  ulong cnt_max = test_roundtrip( mem, tpool, t0, t1, in_max, out_max, comp_sz, data_sz, rng, 0 );
+  FD_TEST( cnt_max==fd_ulong_min( fd_ulong_max( t1-t0, 1UL ), 2UL ) );  /* two frames fit into the arena */
+
+  /* A frame larger than the arena in the middle of the stream is
+     streamed, frames after it are decompressed in parallel again. */
+
+  data_sz = 3UL<<19;
+  comp_sz = test_gen( cstream, rng, data_sz, 100000UL, 300000UL, 3UL*in_max );
+  test_roundtrip( mem, tpool, t0, t1, in_max, out_max, comp_sz, data_sz, rng, 1 );
+
+  /* Single frame larger than the arena */
+
+  data_sz = 5UL*in_max;
+  comp_sz = test_gen( cstream, rng, data_sz, data_sz, 0UL, data_sz );
+  test_roundtrip( mem, tpool, t0, t1, in_max, out_max, comp_sz, data_sz, rng, 1 );
+
+  /* Empty stream */
+
+  test_roundtrip( mem, tpool, t0, t1, in_max, out_max, 0UL, 0UL, rng, 0 );
+
+  /* Truncated streams fail */
+
+  data_sz = 1UL<<18;
+  comp_sz = test_gen( cstream, rng, data_sz, 100000UL, 0UL, 0UL );
+  test_fail( mem, tpool, t0, t1, in_max, out_max, comp_sz-1UL, rng );
+  comp_sz = test_gen( cstream, rng, data_sz, 100000UL, 100000UL, 2UL*in_max );
+  test_fail( mem, tpool, t0, t1, in_max, out_max, 150000UL, rng );  /* inside the big frame */
+
+  /* Corrupt frame */
+
+  comp_sz = test_gen( cstream, rng, data_sz, 100000UL, 0UL, 0UL );
+  test_comp[ comp_sz/2UL ] ^= 0xff;
+  test_comp[ comp_sz/2UL+1UL ] ^= 0xff;
+  test_fail( mem, tpool, t0, t1, in_max, out_max, comp_sz, rng );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* The compressed input buffer is shared, only the output buffers and
+     decompressors grow with the worker count */
+
+  ulong const window_sz = 1UL<<20;
+  ulong const in_max    = 1UL<<16;
+  ulong const out_max   = 1UL<<16;
+  FD_TEST( !fd_io_istream_zstd_para_footprint( 0UL, window_sz, in_max, out_max     ) );
+  FD_TEST( !fd_io_istream_zstd_para_footprint( 1UL, window_sz, 0UL,    out_max     ) );
+  FD_TEST( !fd_io_istream_zstd_para_footprint( 1UL, window_sz, in_max, out_max+1UL ) );
+  ulong fp1 = fd_io_istream_zstd_para_footprint( 1UL, window_sz, in_max, out_max );
+  ulong fp8 = fd_io_istream_zstd_para_footprint( 8UL, window_sz, in_max, out_max );
+  FD_TEST( fp1 && fp8 );
+  FD_TEST( fp8 - fp1 <= 7UL*( sizeof(fd_io_istream_zstd_para_slot_t) + fd_zstd_dstream_footprint( window_sz ) + out_max + fd_zstd_dstream_align() ) );
+
+  int   const lvl   = 3;
+  void *      cmem  = aligned_alloc( fd_zstd_cstream_align(), fd_ulong_align_up( fd_zstd_cstream_footprint( lvl ), fd_zstd_cstream_align() ) );
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( cmem, lvl );
+  FD_TEST( cstream );
+
+  /* Synchronous */
+
+  void * mem = aligned_alloc( fd_io_istream_zstd_para_align(), fd_ulong_align_up( fp1, fd_io_istream_zstd_para_align() ) );
+  FD_TEST( mem );
+  test_para( mem, NULL, 0UL, 0UL, cstream, rng );
+  free( mem );
+
+  /* On tpool workers */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: parallel zstd test requires at least 2 tiles (use --tile-cpus)" ));
+  } else {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    fd_tpool_t * tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL ) );
+
+    ulong fp = fd_io_istream_zstd_para_footprint( tile_cnt-1UL, window_sz, in_max, out_max );
+    mem = aligned_alloc( fd_io_istream_zstd_para_align(), fd_ulong_align_up( fp, fd_io_istream_zstd_para_align() ) );
+    FD_TEST( mem );
+    test_para( mem, tpool, 1UL, tile_cnt, cstream, rng );
+    free( mem );
+
+    FD_TEST( fd_tpool_fini( tpool ) );
+  }
+
+  free( fd_zstd_cstream_delete( cstream ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -15,6 +15,33 @@ _set_accv_sz( fd_snapshot_restore_t * restore,
   FD_TEST( fd_snapshot_accv_map_query( restore->accv_map, key, NULL ) == rec );
 }
 
+/* _append_acc appends an account to the AppendVec being built at buf.
+   Returns the new AppendVec size. */
+
+static ulong
+_append_acc( uchar *      buf,
+             ulong        off,
+             ulong        key,
+             ulong        lamports,
+             char const * data,
+             ulong        data_sz ) {
+  fd_solana_account_hdr_t hdr = { .meta = { .data_len = data_sz }, .info = { .lamports = lamports } };
+  memcpy( hdr.meta.pubkey, &key, sizeof(ulong) );
+  memcpy( buf+off, &hdr, sizeof(fd_solana_account_hdr_t) );
+  off += sizeof(fd_solana_account_hdr_t);
+  memcpy( buf+off, data, data_sz );
+  return fd_ulong_align_up( off+data_sz, FD_SNAPSHOT_ACC_ALIGN );
+}
+
+static fd_account_meta_t const *
+_view_acc( fd_acc_mgr_t *  acc_mgr,
+           fd_funk_txn_t * txn,
+           ulong           key ) {
+  fd_pubkey_t pubkey[1] = {0};
+  memcpy( pubkey, &key, sizeof(ulong) );
+  return fd_acc_mgr_view_raw( acc_mgr, txn, pubkey, NULL, NULL );
+}
+
 static int                    _cb_retcode    = 0;
 static fd_solana_manifest_t * _cb_v_manifest = NULL;
 static void *                 _cb_v_ctx      = NULL;
@@ -551,6 +578,113 @@ main( int     argc,
     fd_snapshot_restore_delete( restore );
   } while(0);
 
+  /* Parallel account insertion */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: parallel account insertion test requires at least 2 tiles (use --tile-cpus)" ));
+  } else do {
+    static uchar _tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+    fd_tpool_t * tpool = fd_tpool_init( _tpool_mem, tile_cnt );
+    FD_TEST( tpool );
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ )
+      FD_TEST( fd_tpool_worker_push( tpool, tile_idx, NULL, 0UL ) );
+
+    fd_snapshot_restore_t * restore = NEW_RESTORE_POST_MANIFEST();
+    FD_TEST( restore );
+    FD_TEST( fd_snapshot_restore_set_tpool( restore, tpool, 0UL, tile_cnt, 2048UL )==restore );
+    FD_TEST( restore->tpool );
+    restore->funk_txn = fd_funk_txn_prepare( funk, NULL, xid, 0 );
+    FD_TEST( restore->funk_txn );
+
+    /* Account (key 9, slot 9) already present */
+    do {
+      fd_pubkey_t key[1] = {{ .ul = {9} }};
+      fd_account_meta_t * meta = fd_acc_mgr_modify_raw( acc_mgr, restore->funk_txn, key, 1, 4UL, NULL, NULL, NULL );
+      FD_TEST( meta );
+      meta->dlen          =  4UL;
+      meta->info.lamports = 90UL;
+      meta->slot          =  9UL;
+      memcpy( (uchar *)meta + meta->hlen, "ABCD", 4UL );
+    } while(0);
+
+    /* AppendVecs with overlapping accounts, the highest slot wins
+       regardless of order.  Keys 100.. are spread over all shards and
+       the batch is small enough to be flushed midway. */
+
+    static uchar accv[ 4096 ];
+    ulong const acc_cnt = 64UL;
+
+    ulong accv_sz = 0UL;
+    accv_sz = _append_acc( accv, accv_sz,  9UL, 1UL, "XXXX",  4UL );
+    accv_sz = _append_acc( accv, accv_sz, 10UL, 2UL, "Hi :)", 5UL );
+    accv_sz = _append_acc( accv, accv_sz, 11UL, 3UL, "",      0UL );
+    _set_accv_sz( restore, 8UL, 1UL, accv_sz );
+    fd_tar_meta_t meta81 = { .name = "accounts/8.1", .typeflag = FD_TAR_TYPE_REGULAR };
+    FD_TEST( 0==fd_snapshot_restore_file( restore, &meta81, accv_sz + 7UL ) );
+    FD_TEST( restore->state == STATE_BATCH_ACCV );
+    for( ulong j=0UL; j<accv_sz+7UL; j++ ) FD_TEST( 0==fd_snapshot_restore_chunk( restore, accv+j, 1UL ) );
+    FD_TEST( restore->state == STATE_IGNORE );
+
+    accv_sz = 0UL;
+    accv_sz = _append_acc( accv, accv_sz, 10UL, 4UL, "old", 3UL );
+    accv_sz = _append_acc( accv, accv_sz, 12UL, 5UL, "new", 3UL );
+    _set_accv_sz( restore, 7UL, 1UL, accv_sz );
+    fd_tar_meta_t meta71 = { .name = "accounts/7.1", .typeflag = FD_TAR_TYPE_REGULAR };
+    FD_TEST( 0==fd_snapshot_restore_file( restore, &meta71, accv_sz ) );
+    FD_TEST( 0==fd_snapshot_restore_chunk( restore, accv, accv_sz ) );
+
+    for( ulong i=0UL; i<acc_cnt; i+=8UL ) {
+      accv_sz = 0UL;
+      for( ulong j=i; j<i+8UL; j++ ) accv_sz = _append_acc( accv, accv_sz, 100UL+j, 1000UL+j, "data", 4UL );
+      _set_accv_sz( restore, 6UL, 1UL+i, accv_sz );
+      fd_tar_meta_t meta = { .typeflag = FD_TAR_TYPE_REGULAR };
+      FD_TEST( fd_cstr_printf_check( meta.name, sizeof(meta.name), NULL, "accounts/6.%lu", 1UL+i ) );
+      FD_TEST( 0==fd_snapshot_restore_file( restore, &meta, accv_sz ) );
+      FD_TEST( 0==fd_snapshot_restore_chunk( restore, accv, accv_sz ) );
+    }
+
+    accv_sz = _append_acc( accv, 0UL, 12UL, 6UL, "older", 5UL );
+    _set_accv_sz( restore, 6UL, 999UL, accv_sz );
+    fd_tar_meta_t meta6 = { .name = "accounts/6.999", .typeflag = FD_TAR_TYPE_REGULAR };
+    FD_TEST( 0==fd_snapshot_restore_file( restore, &meta6, accv_sz ) );
+    FD_TEST( 0==fd_snapshot_restore_chunk( restore, accv, accv_sz ) );
+
+    FD_TEST( 0==fd_snapshot_restore_flush( restore ) );
+    FD_TEST( restore->batch_accv_cnt == 0UL );
+
+    fd_account_meta_t const * acc;
+    acc = _view_acc( acc_mgr, restore->funk_txn,  9UL );
+    FD_TEST( acc && acc->slot==9UL && acc->info.lamports==90UL && 0==memcmp( (uchar const *)acc + acc->hlen, "ABCD", 4UL ) );
+    acc = _view_acc( acc_mgr, restore->funk_txn, 10UL );
+    FD_TEST( acc && acc->slot==8UL && acc->dlen==5UL && acc->info.lamports==2UL && 0==memcmp( (uchar const *)acc + acc->hlen, "Hi :)", 5UL ) );
+    acc = _view_acc( acc_mgr, restore->funk_txn, 11UL );
+    FD_TEST( acc && acc->slot==8UL && acc->dlen==0UL && acc->info.lamports==3UL );
+    acc = _view_acc( acc_mgr, restore->funk_txn, 12UL );
+    FD_TEST( acc && acc->slot==7UL && acc->dlen==3UL && 0==memcmp( (uchar const *)acc + acc->hlen, "new", 3UL ) );
+    for( ulong j=0UL; j<acc_cnt; j++ ) {
+      acc = _view_acc( acc_mgr, restore->funk_txn, 100UL+j );
+      FD_TEST( acc && acc->magic==FD_ACCOUNT_META_MAGIC && acc->slot==6UL && acc->info.lamports==1000UL+j );
+      FD_TEST( 0==memcmp( (uchar const *)acc + acc->hlen, "data", 4UL ) );
+    }
+    FD_TEST( !fd_funk_verify( funk ) );
+
+    /* Torn AppendVec fails on flush */
+
+    accv_sz = _append_acc( accv, 0UL, 13UL, 1UL, "torn", 4UL );
+    _set_accv_sz( restore, 5UL, 1UL, accv_sz-8UL+2UL );
+    fd_tar_meta_t meta5 = { .name = "accounts/5.1", .typeflag = FD_TAR_TYPE_REGULAR };
+    FD_TEST( 0==fd_snapshot_restore_file( restore, &meta5, accv_sz ) );
+    FD_TEST( 0==fd_snapshot_restore_chunk( restore, accv, accv_sz ) );
+    FD_TEST( EINVAL==fd_snapshot_restore_flush( restore ) );
+    FD_TEST( restore->failed == 1 );
+
+    fd_funk_txn_cancel( funk, restore->funk_txn, 0 );
+    fd_snapshot_restore_delete( restore );
+
+    FD_TEST( fd_tpool_fini( tpool ) );
+  } while(0);
+
 # undef NEW_RESTORE_POST_MANIFEST
 
   /* Clean up */
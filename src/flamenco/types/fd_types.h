@@ -2386,6 +2386,7 @@ struct __attribute__((aligned(16UL))) fd_slot_bank {
   ulong transaction_count;
   uchar lthash[2048];
   fd_block_hash_queue_t block_hash_queue;
+  fd_hard_forks_t hard_forks;
 };
 typedef struct fd_slot_bank fd_slot_bank_t;
 #define FD_SLOT_BANK_FOOTPRINT sizeof(fd_slot_bank_t)
@@ -2413,6 +2414,7 @@ struct __attribute__((aligned(16UL))) fd_slot_bank_off {
   uint transaction_count_off;
   uint lthash_off;
   uint block_hash_queue_off;
+  uint hard_forks_off;
 };
 typedef struct fd_slot_bank_off fd_slot_bank_off_t;
 #define FD_SLOT_BANK_OFF_FOOTPRINT sizeof(fd_slot_bank_off_t)
@@ -0,0 +1,1275 @@
+#define _DEFAULT_SOURCE
+#include "fd_vm_jit.h"
+#include "fd_vm_interp.h"
+
+#include "../../ballet/murmur3/fd_murmur3.h"
+#include "../../ballet/sha256/fd_sha256.h"
+#include "../../util/bits/fd_sat.h"
+
+#if FD_HAS_X86 && FD_HAS_HOSTED
+
+#include <sys/mman.h>
+
+/* fd_vm_jit_frame_t holds the interpreter's local variables while
+   generated code runs.  Generated code keeps a pointer to it in rbx and
+   addresses fields by offset. */
+
+struct fd_vm_jit_frame {
+  fd_vm_exec_context_t * ctx;
+  void const * const *   code_tab;   /* Native address of each pc */
+  uint const *           cnt_tab;    /* cnt_tab[pc] is pc minus the number of LDQs before pc */
+  ulong                  instrs_cnt;
+
+  ulong start;        /* cnt_tab value at the current block's first instruction */
+  ulong due;          /* due_insn_cnt */
+  ulong prev;         /* previous_instruction_meter */
+  ulong meter;        /* compute_meter */
+  ulong ic;           /* instruction_counter */
+  ulong pc;           /* program_counter on exit */
+  ulong cond_fault;
+  ulong exit;         /* FD_VM_JIT_EXIT_* */
+
+  /* Memory region table, indexed by vm_addr>>32.  An access of sz
+     bytes at region offset off is valid iff off+sz<=rd_sz (wr_sz for
+     stores) and !(off & gap). */
+
+  ulong region_base [ 5 ];
+  ulong region_rd_sz[ 5 ];
+  ulong region_wr_sz[ 5 ];
+  ulong region_gap  [ 5 ];
+};
+
+typedef struct fd_vm_jit_frame fd_vm_jit_frame_t;
+
+#define FD_VM_JIT_EXIT_HALT   (0UL) /* Frame state is final */
+#define FD_VM_JIT_EXIT_FAULT  (1UL) /* Memory access violation at pc */
+#define FD_VM_JIT_EXIT_BUDGET (2UL) /* Compute budget exhausted before pc */
+
+typedef void (* fd_vm_jit_entry_fn_t)( fd_vm_jit_frame_t * frame );
+
+struct fd_vm_jit_prog {
+  ulong                map_sz;
+  ulong                instrs_cnt;
+  ulong                ref_cnt;    /* Users, plus one while cached */
+  ulong                last_use;   /* Cache clock at the last query */
+  uchar                key[ 32 ];
+  fd_vm_jit_entry_fn_t entry;
+  void const **        code_tab;   /* indexed [0,instrs_cnt] */
+  uint *               cnt_tab;    /* indexed [0,instrs_cnt] */
+};
+
+/* Helpers called from generated code ********************************/
+
+/* These reproduce the interpreter's CALL_IMM, CALL_REG and EXIT cases
+   (see fd_vm_interp_dispatch_tab.c).  The register file has been
+   spilled to ctx->register_file.  They return the next pc to execute
+   or ULONG_MAX if execution should stop (frame->pc, frame->exit and
+   frame->cond_fault set). */
+
+static ulong
+fd_vm_jit_private_halt( fd_vm_jit_frame_t * frame,
+                        ulong               pc,
+                        ulong               exit,
+                        ulong               cond_fault ) {
+  frame->pc         = pc;
+  frame->exit       = exit;
+  frame->cond_fault = cond_fault;
+  return ULONG_MAX;
+}
+
+/* fd_vm_jit_private_branch_post is BRANCH_POST_CODE: tallies the
+   block that ended at the branch and enters the block at next. */
+
+static ulong
+fd_vm_jit_private_branch_post( fd_vm_jit_frame_t * frame,
+                               ulong               next,
+                               ulong               insns ) {
+  frame->ic  += insns;
+  frame->due += insns;
+  if( FD_UNLIKELY( frame->due>=frame->prev ) ) return fd_vm_jit_private_halt( frame, next, FD_VM_JIT_EXIT_BUDGET, 0UL );
+  /* The interpreter does not bounds check dynamic branch targets */
+  if( FD_UNLIKELY( next>=frame->instrs_cnt ) ) return fd_vm_jit_private_halt( frame, next, FD_VM_JIT_EXIT_FAULT, 0UL );
+  frame->start = frame->cnt_tab[ next ];
+  return next;
+}
+
+static ulong
+fd_vm_jit_private_call_imm( fd_vm_jit_frame_t * frame,
+                            ulong               pc,
+                            ulong               imm ) {
+  fd_vm_exec_context_t * ctx = frame->ctx;
+  ulong *                reg = ctx->register_file;
+
+  /* Flush the current block before a possible cross-program
+     invocation */
+
+  ulong insns = frame->cnt_tab[ pc+1UL ] - frame->start;
+  frame->due += insns;
+  frame->ic  += insns;
+  if( FD_UNLIKELY( frame->due>=frame->prev ) ) return fd_vm_jit_private_halt( frame, pc, FD_VM_JIT_EXIT_BUDGET, 0UL );
+
+  frame->meter -= frame->due;
+  frame->due    = 0UL;
+  ctx->due_insn_cnt = 0UL;
+  ctx->previous_instruction_meter = frame->prev = ctx->compute_meter = frame->meter;
+
+  ulong cond_fault = 0UL;
+  ulong next       = pc+1UL;
+
+  fd_sbpf_syscalls_t * syscall = fd_sbpf_syscalls_query( ctx->syscall_map, (uint)imm, NULL );
+  if( !syscall ) {
+    reg[10] += 0x2000;
+    fd_vm_stack_push( &ctx->stack, pc, &reg[6] );
+    uint target_pc = fd_pchash_inverse( (uint)imm );
+    if( fd_sbpf_calldests_test( ctx->calldests, target_pc ) && target_pc<ctx->instrs_sz ) {
+      next = target_pc;
+    } else if( imm==0x71e3cf81 ) {
+      next = (ulong)ctx->entrypoint + 1UL;
+    } else {
+      cond_fault = 1UL;
+    }
+  } else {
+    ctx->compute_meter = frame->meter;
+    cond_fault = ((fd_vm_syscall_fn_ptr_t)( syscall->func_ptr ))( ctx, reg[1], reg[2], reg[3], reg[4], reg[5], &reg[0] );
+    frame->meter = ctx->compute_meter;
+  }
+
+  frame->prev = frame->meter;
+  ctx->previous_instruction_meter = frame->prev;
+  if( FD_UNLIKELY( cond_fault ) ) return fd_vm_jit_private_halt( frame, pc, FD_VM_JIT_EXIT_HALT, cond_fault );
+
+  return fd_vm_jit_private_branch_post( frame, next, 0UL );
+}
+
+static ulong
+fd_vm_jit_private_call_reg( fd_vm_jit_frame_t * frame,
+                            ulong               pc,
+                            ulong               imm ) {
+  fd_vm_exec_context_t * ctx = frame->ctx;
+  ulong *                reg = ctx->register_file;
+
+  ulong insns      = frame->cnt_tab[ pc+1UL ] - frame->start;
+  ulong start_addr = reg[ imm ] & FD_VM_MEM_MAP_REGION_SZ;
+  reg[10] += 0x2000;
+  ulong cond_fault = fd_vm_stack_push( &ctx->stack, pc, &reg[6] );
+  long  next       = (long)( (start_addr / 8UL)-1UL ) - (long)ctx->instrs_offset / 8L;
+  if( FD_UNLIKELY( cond_fault ) ) return fd_vm_jit_private_halt( frame, (ulong)next, FD_VM_JIT_EXIT_HALT, cond_fault );
+
+  return fd_vm_jit_private_branch_post( frame, (ulong)(next+1L), insns );
+}
+
+static ulong
+fd_vm_jit_private_exit( fd_vm_jit_frame_t * frame,
+                        ulong               pc,
+                        ulong               imm ) {
+  (void)imm;
+  fd_vm_exec_context_t * ctx = frame->ctx;
+  ulong *                reg = ctx->register_file;
+
+  ulong insns = frame->cnt_tab[ pc+1UL ] - frame->start;
+  reg[10] -= 0x2000;
+  if( ctx->stack.frames_used==0UL ) {
+    frame->due += insns;
+    if( FD_UNLIKELY( frame->due>frame->prev ) ) return fd_vm_jit_private_halt( frame, pc, FD_VM_JIT_EXIT_BUDGET, 0UL );
+    return fd_vm_jit_private_halt( frame, pc, FD_VM_JIT_EXIT_HALT, 0UL );
+  }
+  ulong ret_pc;
+  fd_vm_stack_pop( &ctx->stack, &ret_pc, &reg[6] );
+  return fd_vm_jit_private_branch_post( frame, ret_pc+1UL, insns );
+}
+
+/* x86-64 emitter ****************************************************/
+
+#define RAX (0)
+#define RCX (1)
+#define RDX (2)
+#define RBX (3)
+#define RSP (4)
+#define RBP (5)
+#define RSI (6)
+#define RDI (7)
+#define R8  (8)
+#define R9  (9)
+#define R10 (10)
+#define R11 (11)
+#define R12 (12)
+#define R13 (13)
+#define R14 (14)
+#define R15 (15)
+
+#define NOIDX (-1)
+
+/* Host register holding each sBPF register.  rax, rcx and rdx are
+   scratch, rbx points to the frame. */
+
+static const int fd_vm_jit_reg[ 11 ] = { RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15, RBP };
+
+/* Condition codes */
+
+#define CC_B  (0x2)
+#define CC_AE (0x3)
+#define CC_E  (0x4)
+#define CC_NE (0x5)
+#define CC_BE (0x6)
+#define CC_A  (0x7)
+#define CC_L  (0xc)
+#define CC_GE (0xd)
+#define CC_LE (0xe)
+#define CC_G  (0xf)
+
+/* Group opcode extensions */
+
+#define EXT_ADD (0)
+#define EXT_OR  (1)
+#define EXT_AND (4)
+#define EXT_SUB (5)
+#define EXT_XOR (6)
+#define EXT_CMP (7)
+#define EXT_SHL (4)
+#define EXT_SHR (5)
+#define EXT_SAR (7)
+#define EXT_NEG (3)
+#define EXT_DIV (6)
+
+/* Largest code emitted for a single sBPF instruction and for a stub */
+
+#define FD_VM_JIT_INSTR_CODE_MAX (256UL)
+#define FD_VM_JIT_STUB_CODE_MAX  (32UL)
+
+struct fd_vm_jit_patch {
+  uint at;  /* Offset of a rel32 in the code */
+  uint to;  /* Target pc or stub index */
+};
+typedef struct fd_vm_jit_patch fd_vm_jit_patch_t;
+
+struct fd_vm_jit_stub {
+  uint pc;
+  uint exit;
+};
+typedef struct fd_vm_jit_stub fd_vm_jit_stub_t;
+
+struct fd_vm_jit_emit {
+  uchar *             code;
+  ulong               sz;
+  uint const *        cnt_tab;
+
+  fd_vm_jit_patch_t * label_patch;  /* rel32s to the code of a pc */
+  ulong               label_patch_cnt;
+  fd_vm_jit_patch_t * stub_patch;   /* rel32s to a stub */
+  ulong               stub_patch_cnt;
+  fd_vm_jit_stub_t *  stub;
+  ulong               stub_cnt;
+
+  ulong               exit_spill;   /* Offset of the spill-and-return epilogue */
+  ulong               exit_ret;     /* Offset of the return epilogue */
+};
+typedef struct fd_vm_jit_emit fd_vm_jit_emit_t;
+
+static inline void emit1( fd_vm_jit_emit_t * e, ulong b ) { e->code[ e->sz++ ] = (uchar)b; }
+static inline void emit4( fd_vm_jit_emit_t * e, ulong w ) { FD_STORE( uint,  e->code + e->sz, (uint)w ); e->sz += 4UL; }
+static inline void emit8( fd_vm_jit_emit_t * e, ulong w ) { FD_STORE( ulong, e->code + e->sz, w       ); e->sz += 8UL; }
+
+static inline void
+emit_rex( fd_vm_jit_emit_t * e,
+          int                w,
+          int                r,
+          int                x,
+          int                b,
+          int                force ) {
+  ulong rex = 0x40UL | ((ulong)w<<3) | ((ulong)((r>>3)&1)<<2) | ((ulong)((x>>3)&1)<<1) | (ulong)((b>>3)&1);
+  if( rex!=0x40UL || force ) emit1( e, rex );
+}
+
+static inline void
+emit_opc( fd_vm_jit_emit_t * e,
+          uint               opc ) {
+  if( opc>0xffU ) emit1( e, opc>>8 );
+  emit1( e, opc & 0xffU );
+}
+
+/* emit_mem emits the ModRM (and SIB, disp) for [base + index*8 + disp] */
+
+static void
+emit_mem( fd_vm_jit_emit_t * e,
+          int                r,
+          int                base,
+          int                index,
+          int                disp ) {
+  ulong mod = ( disp==0 && (base&7)!=RBP ) ? 0UL : ( disp>=-128 && disp<=127 ) ? 1UL : 2UL;
+  if( index==NOIDX && (base&7)!=RSP ) {
+    emit1( e, (mod<<6) | ((ulong)(r&7)<<3) | (ulong)(base&7) );
+  } else {
+    emit1( e, (mod<<6) | ((ulong)(r&7)<<3) | 4UL );
+    if( index==NOIDX ) emit1( e, (4UL<<3) | (ulong)(base&7) );
+    else               emit1( e, (3UL<<6) | ((ulong)(index&7)<<3) | (ulong)(base&7) );
+  }
+  if(      mod==1UL ) emit1( e, (ulong)(uint)disp );
+  else if( mod==2UL ) emit4( e, (ulong)(uint)disp );
+}
+
+/* op r/m(m), r   (register direct) */
+
+static void
+emit_rr( fd_vm_jit_emit_t * e,
+         int                w,
+         uint               opc,
+         int                r,
+         int                m ) {
+  emit_rex( e, w, r, 0, m, 0 );
+  emit_opc( e, opc );
+  emit1( e, 0xc0UL | ((ulong)(r&7)<<3) | (ulong)(m&7) );
+}
+
+/* op r, [base + index*8 + disp]  (or op [..], r depending on opc) */
+
+static void
+emit_rm( fd_vm_jit_emit_t * e,
+         int                w,
+         uint               opc,
+         int                r,
+         int                base,
+         int                index,
+         int                disp ) {
+  emit_rex( e, w, r, index==NOIDX ? 0 : index, base, 0 );
+  emit_opc( e, opc );
+  emit_mem( e, r, base, index, disp );
+}
+
+/* Group 1 ALU op with an immediate: op r/m, simm32 */
+
+static void
+emit_alu_ri( fd_vm_jit_emit_t * e,
+             int                w,
+             int                ext,
+             int                m,
+             uint               imm ) {
+  emit_rex( e, w, 0, 0, m, 0 );
+  if( (int)imm>=-128 && (int)imm<=127 ) {
+    emit1( e, 0x83UL ); emit1( e, 0xc0UL | ((ulong)ext<<3) | (ulong)(m&7) ); emit1( e, imm );
+  } else {
+    emit1( e, 0x81UL ); emit1( e, 0xc0UL | ((ulong)ext<<3) | (ulong)(m&7) ); emit4( e, imm );
+  }
+}
+
+/* mov r32, imm32 (zero extends) */
+
+static void
+emit_mov_ri32( fd_vm_jit_emit_t * e,
+               int                r,
+               uint               imm ) {
+  emit_rex( e, 0, 0, 0, r, 0 );
+  emit1( e, 0xb8UL + (ulong)(r&7) );
+  emit4( e, imm );
+}
+
+/* mov r64, imm64 */
+
+static void
+emit_mov_ri64( fd_vm_jit_emit_t * e,
+               int                r,
+               ulong              imm ) {
+  if( imm<=0xffffffffUL ) {
+    emit_mov_ri32( e, r, (uint)imm );
+  } else if( (long)imm>=(long)INT_MIN && (long)imm<=(long)INT_MAX ) {
+    emit_rex( e, 1, 0, 0, r, 0 ); emit1( e, 0xc7UL ); emit1( e, 0xc0UL | (ulong)(r&7) ); emit4( e, (uint)imm );
+  } else {
+    emit_rex( e, 1, 0, 0, r, 0 ); emit1( e, 0xb8UL + (ulong)(r&7) ); emit8( e, imm );
+  }
+}
+
+/* mov qword [rbx + disp], simm32 */
+
+static void
+emit_frame_st_imm( fd_vm_jit_emit_t * e,
+                   int                disp,
+                   uint               imm ) {
+  emit_rex( e, 1, 0, 0, RBX, 0 ); emit1( e, 0xc7UL ); emit_mem( e, 0, RBX, NOIDX, disp ); emit4( e, imm );
+}
+
+static void
+emit_shift_ri( fd_vm_jit_emit_t * e,
+               int                w,
+               int                ext,
+               int                m,
+               uint               imm ) {
+  emit_rex( e, w, 0, 0, m, 0 );
+  emit1( e, 0xc1UL ); emit1( e, 0xc0UL | ((ulong)ext<<3) | (ulong)(m&7) ); emit1( e, imm );
+}
+
+/* Unary group 2/3 op on r/m (shift by cl, neg, div) */
+
+static void
+emit_unary( fd_vm_jit_emit_t * e,
+            int                w,
+            uint               opc,
+            int                ext,
+            int                m ) {
+  emit_rex( e, w, 0, 0, m, 0 );
+  emit1( e, opc ); emit1( e, 0xc0UL | ((ulong)ext<<3) | (ulong)(m&7) );
+}
+
+/* Returns the offset of the rel32 to patch */
+
+static ulong
+emit_jcc32( fd_vm_jit_emit_t * e,
+            int                cc ) {
+  emit1( e, 0x0fUL ); emit1( e, 0x80UL | (ulong)cc ); emit4( e, 0UL );
+  return e->sz - 4UL;
+}
+
+static ulong
+emit_jmp32( fd_vm_jit_emit_t * e ) {
+  emit1( e, 0xe9UL ); emit4( e, 0UL );
+  return e->sz - 4UL;
+}
+
+static void
+patch_rel32( fd_vm_jit_emit_t * e,
+             ulong              at,
+             ulong              to ) {
+  FD_STORE( uint, e->code + at, (uint)(int)( (long)to - (long)(at+4UL) ) );
+}
+
+static void
+emit_jcc_label( fd_vm_jit_emit_t * e,
+                int                cc,
+                ulong              pc ) {
+  ulong at = cc<0 ? emit_jmp32( e ) : emit_jcc32( e, cc );
+  e->label_patch[ e->label_patch_cnt++ ] = (fd_vm_jit_patch_t){ .at = (uint)at, .to = (uint)pc };
+}
+
+/* emit_jcc_stub emits a conditional jump to a stub that stops
+   execution with the given exit code and pc. */
+
+static void
+emit_jcc_stub( fd_vm_jit_emit_t * e,
+               int                cc,
+               ulong              stub_idx ) {
+  ulong at = emit_jcc32( e, cc );
+  e->stub_patch[ e->stub_patch_cnt++ ] = (fd_vm_jit_patch_t){ .at = (uint)at, .to = (uint)stub_idx };
+}
+
+static ulong
+new_stub( fd_vm_jit_emit_t * e,
+          ulong              pc,
+          ulong              exit ) {
+  e->stub[ e->stub_cnt ] = (fd_vm_jit_stub_t){ .pc = (uint)pc, .exit = (uint)exit };
+  return e->stub_cnt++;
+}
+
+#define FRAME(f) ((int)offsetof( fd_vm_jit_frame_t, f ))
+#define REGFILE(i) ((int)( offsetof( fd_vm_exec_context_t, register_file ) + (i)*sizeof(ulong) ))
+
+static void
+emit_spill( fd_vm_jit_emit_t * e ) {
+  emit_rm( e, 1, 0x8b, RAX, RBX, NOIDX, FRAME( ctx ) );                               /* mov rax, [rbx+ctx] */
+  for( ulong i=0UL; i<11UL; i++ ) emit_rm( e, 1, 0x89, fd_vm_jit_reg[ i ], RAX, NOIDX, REGFILE( i ) );
+}
+
+static void
+emit_fill( fd_vm_jit_emit_t * e ) {
+  emit_rm( e, 1, 0x8b, RAX, RBX, NOIDX, FRAME( ctx ) );
+  for( ulong i=0UL; i<11UL; i++ ) emit_rm( e, 1, 0x8b, fd_vm_jit_reg[ i ], RAX, NOIDX, REGFILE( i ) );
+}
+
+/* emit_dispatch jumps to the code of the pc in rcx */
+
+static void
+emit_dispatch( fd_vm_jit_emit_t * e ) {
+  emit_rm( e, 1, 0x8b, RDX, RBX, NOIDX, FRAME( code_tab ) );                          /* mov rdx, [rbx+code_tab] */
+  emit1( e, 0xffUL ); emit_mem( e, 4, RDX, RCX, 0 );                                   /* jmp [rdx+rcx*8]         */
+}
+
+static void
+emit_prologue( fd_vm_jit_emit_t * e ) {
+  emit1( e, 0x53UL );                                 /* push rbx */
+  emit1( e, 0x55UL );                                 /* push rbp */
+  emit1( e, 0x41UL ); emit1( e, 0x54UL );             /* push r12 */
+  emit1( e, 0x41UL ); emit1( e, 0x55UL );             /* push r13 */
+  emit1( e, 0x41UL ); emit1( e, 0x56UL );             /* push r14 */
+  emit1( e, 0x41UL ); emit1( e, 0x57UL );             /* push r15 */
+  emit_alu_ri( e, 1, EXT_SUB, RSP, 8U );              /* align the stack for helper calls */
+  emit_rr( e, 1, 0x89, RDI, RBX );                    /* mov rbx, rdi */
+  emit_fill( e );
+  emit_rm( e, 1, 0x8b, RCX, RBX, NOIDX, FRAME( pc ) );
+  emit_dispatch( e );
+
+  e->exit_spill = e->sz;
+  emit_spill( e );
+  e->exit_ret = e->sz;
+  emit_alu_ri( e, 1, EXT_ADD, RSP, 8U );
+  emit1( e, 0x41UL ); emit1( e, 0x5fUL );             /* pop r15 */
+  emit1( e, 0x41UL ); emit1( e, 0x5eUL );             /* pop r14 */
+  emit1( e, 0x41UL ); emit1( e, 0x5dUL );             /* pop r13 */
+  emit1( e, 0x41UL ); emit1( e, 0x5cUL );             /* pop r12 */
+  emit1( e, 0x5dUL );                                 /* pop rbp */
+  emit1( e, 0x5bUL );                                 /* pop rbx */
+  emit1( e, 0xc3UL );                                 /* ret     */
+}
+
+/* emit_tally charges the instructions of the block ending at pc (the
+   branch instruction).  Leaves the new due_insn_cnt in rax. */
+
+static void
+emit_tally( fd_vm_jit_emit_t * e,
+            ulong              pc ) {
+  emit_mov_ri32( e, RAX, e->cnt_tab[ pc+1UL ] );
+  emit_rm( e, 1, 0x2b, RAX, RBX, NOIDX, FRAME( start ) );  /* sub rax, [start] */
+  emit_rm( e, 1, 0x01, RAX, RBX, NOIDX, FRAME( ic    ) );  /* add [ic], rax    */
+  emit_rm( e, 1, 0x03, RAX, RBX, NOIDX, FRAME( due   ) );  /* add rax, [due]   */
+  emit_rm( e, 1, 0x89, RAX, RBX, NOIDX, FRAME( due   ) );  /* mov [due], rax   */
+}
+
+/* emit_enter checks the budget (due_insn_cnt in rax) and starts a new
+   block at pc. */
+
+static void
+emit_enter( fd_vm_jit_emit_t * e,
+            ulong              pc ) {
+  emit_rm( e, 1, 0x3b, RAX, RBX, NOIDX, FRAME( prev ) );   /* cmp rax, [prev] */
+  emit_jcc_stub( e, CC_AE, new_stub( e, pc, FD_VM_JIT_EXIT_BUDGET ) );
+  emit_frame_st_imm( e, FRAME( start ), e->cnt_tab[ pc ] );
+}
+
+/* emit_translate leaves in rax the host address of the sz byte access
+   at the address in rax, or jumps to an access violation stub for pc. */
+
+static void
+emit_translate( fd_vm_jit_emit_t * e,
+                ulong              pc,
+                ulong              sz,
+                int                write ) {
+  ulong stub = new_stub( e, pc, FD_VM_JIT_EXIT_FAULT );
+  emit_rr( e, 1, 0x89, RAX, RDX );                                         /* mov rdx, rax      */
+  emit_shift_ri( e, 1, EXT_SHR, RDX, 32U );                                /* shr rdx, 32       */
+  emit_alu_ri( e, 1, EXT_CMP, RDX, 4U );                                   /* cmp rdx, 4        */
+  emit_jcc_stub( e, CC_A, stub );
+  emit_rr( e, 0, 0x89, RAX, RAX );                                         /* mov eax, eax      */
+  emit_rm( e, 1, 0x8d, RCX, RAX, NOIDX, (int)sz );                         /* lea rcx, [rax+sz] */
+  emit_rm( e, 1, 0x3b, RCX, RBX, RDX, write ? FRAME( region_wr_sz ) : FRAME( region_rd_sz ) );
+  emit_jcc_stub( e, CC_A, stub );
+  emit_rm( e, 1, 0x85, RAX, RBX, RDX, FRAME( region_gap ) );               /* test rax, [gap]   */
+  emit_jcc_stub( e, CC_NE, stub );
+  emit_rm( e, 1, 0x03, RAX, RBX, RDX, FRAME( region_base ) );              /* add rax, [base]   */
+}
+
+/* emit_helper spills the register file, calls fn( frame, pc, imm ) and
+   continues at the pc it returns. */
+
+static void
+emit_helper( fd_vm_jit_emit_t * e,
+             ulong              fn,
+             ulong              pc,
+             uint               imm ) {
+  emit_spill( e );
+  emit_rr( e, 1, 0x89, RBX, RDI );                     /* mov rdi, rbx   */
+  emit_mov_ri32( e, RSI, (uint)pc );
+  emit_mov_ri32( e, RDX, imm );
+  emit_rex( e, 1, 0, 0, RAX, 0 ); emit1( e, 0xb8UL ); emit8( e, fn );
+  emit1( e, 0xffUL ); emit1( e, 0xd0UL );              /* call rax       */
+  emit_alu_ri( e, 1, EXT_CMP, RAX, 0xffffffffU );      /* cmp rax, -1    */
+  patch_rel32( e, emit_jcc32( e, CC_E ), e->exit_ret );
+  emit_rr( e, 1, 0x89, RAX, RCX );                     /* mov rcx, rax   */
+  emit_fill( e );
+  emit_dispatch( e );
+}
+
+/* emit_cmp_imm compares r against instr.imm, zero or sign extended to
+   64 bits to match the interpreter. */
+
+static void
+emit_cmp_imm( fd_vm_jit_emit_t * e,
+              int                r,
+              uint               imm,
+              int                zext,
+              int                test ) {
+  if( zext && imm>0x7fffffffU ) {
+    emit_mov_ri32( e, RCX, imm );
+    emit_rr( e, 1, test ? 0x85 : 0x39, RCX, r );
+  } else if( test ) {
+    emit_rex( e, 1, 0, 0, r, 0 ); emit1( e, 0xf7UL ); emit1( e, 0xc0UL | (ulong)(r&7) ); emit4( e, imm );
+  } else {
+    emit_alu_ri( e, 1, EXT_CMP, r, imm );
+  }
+}
+
+/* fd_vm_jit_emit_instr emits the code for the instruction at pc.
+   Returns the number of instructions consumed (2 for LDQ) or 0 if the
+   instruction is not supported. */
+
+static ulong
+fd_vm_jit_emit_instr( fd_vm_jit_emit_t *      e,
+                      fd_sbpf_instr_t const * instrs,
+                      ulong                   instrs_cnt,
+                      ulong                   pc ) {
+  fd_sbpf_instr_t instr = instrs[ pc ];
+  if( FD_UNLIKELY( instr.dst_reg>10 || instr.src_reg>10 ) ) return 0UL;
+  int  dst = fd_vm_jit_reg[ instr.dst_reg ];
+  int  src = fd_vm_jit_reg[ instr.src_reg ];
+  uint imm = instr.imm;
+
+  /* Branch target */
+  long target = (long)pc + 1L + (long)instr.offset;
+
+  switch( instr.opcode.raw ) {
+
+  /* ALU32: result zero extended */
+  case 0x04: emit_alu_ri( e, 0, EXT_ADD, dst, imm );  break;  /* ADD_IMM  */
+  case 0x0c: emit_rr( e, 0, 0x01, src, dst );         break;  /* ADD_REG  */
+  case 0x14: emit_alu_ri( e, 0, EXT_SUB, dst, imm );  break;  /* SUB_IMM  */
+  case 0x1c: emit_rr( e, 0, 0x29, src, dst );         break;  /* SUB_REG  */
+  case 0x24:                                                  /* MUL_IMM  */
+    emit_rex( e, 0, dst, 0, dst, 0 ); emit1( e, 0x69UL ); emit1( e, 0xc0UL | ((ulong)(dst&7)<<3) | (ulong)(dst&7) ); emit4( e, imm );
+    break;
+  case 0x2c: emit_rr( e, 0, 0x0faf, dst, src );       break;  /* MUL_REG  */
+  case 0x44: emit_alu_ri( e, 0, EXT_OR,  dst, imm );  break;  /* OR_IMM   */
+  case 0x4c: emit_rr( e, 0, 0x09, src, dst );         break;  /* OR_REG   */
+  case 0x54: emit_alu_ri( e, 0, EXT_AND, dst, imm );  break;  /* AND_IMM  */
+  case 0x5c: emit_rr( e, 0, 0x21, src, dst );         break;  /* AND_REG  */
+  case 0xa4: emit_alu_ri( e, 0, EXT_XOR, dst, imm );  break;  /* XOR_IMM  */
+  case 0xac: emit_rr( e, 0, 0x31, src, dst );         break;  /* XOR_REG  */
+  case 0xb4: emit_mov_ri32( e, dst, imm );            break;  /* MOV_IMM  */
+  case 0xbc: emit_rr( e, 0, 0x89, src, dst );         break;  /* MOV_REG  */
+  case 0x84: emit_unary( e, 0, 0xf7, EXT_NEG, dst );  break;  /* NEG      */
+
+  /* Shift counts are masked like the host shifts the interpreter
+     compiles to */
+  case 0x64: emit_shift_ri( e, 0, EXT_SHL, dst, imm & 31U ); break;                          /* LSH_IMM  */
+  case 0x74: emit_shift_ri( e, 0, EXT_SHR, dst, imm & 31U ); break;                          /* RSH_IMM  */
+  case 0xc4: emit_shift_ri( e, 0, EXT_SAR, dst, imm & 31U ); break;                          /* ARSH_IMM */
+  case 0x6c: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 0, 0xd3, EXT_SHL, dst ); break; /* LSH_REG  */
+  case 0x7c: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 0, 0xd3, EXT_SHR, dst ); break; /* RSH_REG  */
+  case 0xcc: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 0, 0xd3, EXT_SAR, dst ); break; /* ARSH_REG */
+
+  case 0x34:                                                  /* DIV_IMM  */
+  case 0x94:                                                  /* MOD_IMM  */
+    if( !imm ) {
+      if( instr.opcode.raw==0x34 ) emit_rr( e, 0, 0x31, dst, dst );  /* xor dst32, dst32 */
+      else                         emit_rr( e, 0, 0x89, dst, dst );  /* mov dst32, dst32 */
+      break;
+    }
+    emit_rr( e, 0, 0x89, dst, RAX );
+    emit_rr( e, 0, 0x31, RDX, RDX );
+    emit_mov_ri32( e, RCX, imm );
+    emit_unary( e, 0, 0xf7, EXT_DIV, RCX );
+    emit_rr( e, 0, 0x89, instr.opcode.raw==0x34 ? RAX : RDX, dst );
+    break;
+
+  case 0x3c:                                                  /* DIV_REG  */
+  case 0x9c: {                                                /* MOD_REG  */
+    emit_rr( e, 0, 0x89, src, RCX );
+    emit_rr( e, 0, 0x85, RCX, RCX );                          /* test ecx, ecx */
+    emit1( e, 0x74UL ); ulong jz = e->sz; emit1( e, 0UL );    /* jz .zero      */
+    emit_rr( e, 0, 0x89, dst, RAX );
+    emit_rr( e, 0, 0x31, RDX, RDX );
+    emit_unary( e, 0, 0xf7, EXT_DIV, RCX );
+    emit_rr( e, 0, 0x89, instr.opcode.raw==0x3c ? RAX : RDX, dst );
+    emit1( e, 0xebUL ); ulong jmp = e->sz; emit1( e, 0UL );   /* jmp .done     */
+    e->code[ jz ] = (uchar)( e->sz - (jz+1UL) );
+    if( instr.opcode.raw==0x3c ) emit_rr( e, 0, 0x31, dst, dst );
+    else                         emit_rr( e, 0, 0x89, dst, dst );
+    e->code[ jmp ] = (uchar)( e->sz - (jmp+1UL) );
+    break;
+  }
+
+  /* ALU64 (immediates sign extended unless noted) */
+  case 0x07: emit_alu_ri( e, 1, EXT_ADD, dst, imm );  break;  /* ADD64_IMM  */
+  case 0x0f: emit_rr( e, 1, 0x01, src, dst );         break;  /* ADD64_REG  */
+  case 0x17: emit_alu_ri( e, 1, EXT_SUB, dst, imm );  break;  /* SUB64_IMM  */
+  case 0x1f: emit_rr( e, 1, 0x29, src, dst );         break;  /* SUB64_REG  */
+  case 0x27:                                                  /* MUL64_IMM  */
+    emit_rex( e, 1, dst, 0, dst, 0 ); emit1( e, 0x69UL ); emit1( e, 0xc0UL | ((ulong)(dst&7)<<3) | (ulong)(dst&7) ); emit4( e, imm );
+    break;
+  case 0x2f: emit_rr( e, 1, 0x0faf, dst, src );       break;  /* MUL64_REG  */
+  case 0x47: emit_alu_ri( e, 1, EXT_OR,  dst, imm );  break;  /* OR64_IMM   */
+  case 0x4f: emit_rr( e, 1, 0x09, src, dst );         break;  /* OR64_REG   */
+  case 0x57: emit_alu_ri( e, 1, EXT_AND, dst, imm );  break;  /* AND64_IMM  */
+  case 0x5f: emit_rr( e, 1, 0x21, src, dst );         break;  /* AND64_REG  */
+  case 0xa7: emit_alu_ri( e, 1, EXT_XOR, dst, imm );  break;  /* XOR64_IMM  */
+  case 0xaf: emit_rr( e, 1, 0x31, src, dst );         break;  /* XOR64_REG  */
+  case 0xb7: emit_mov_ri64( e, dst, (ulong)(long)(int)imm ); break; /* MOV64_IMM */
+  case 0xbf: emit_rr( e, 1, 0x89, src, dst );         break;  /* MOV64_REG  */
+  case 0x87: emit_unary( e, 1, 0xf7, EXT_NEG, dst );  break;  /* NEG64      */
+  case 0x67: emit_shift_ri( e, 1, EXT_SHL, dst, imm & 63U ); break;                          /* LSH64_IMM  */
+  case 0x77: emit_shift_ri( e, 1, EXT_SHR, dst, imm & 63U ); break;                          /* RSH64_IMM  */
+  case 0xc7: emit_shift_ri( e, 1, EXT_SAR, dst, imm & 63U ); break;                          /* ARSH64_IMM */
+  case 0x6f: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 1, 0xd3, EXT_SHL, dst ); break; /* LSH64_REG  */
+  case 0x7f: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 1, 0xd3, EXT_SHR, dst ); break; /* RSH64_REG  */
+  case 0xcf: emit_rr( e, 0, 0x89, src, RCX ); emit_unary( e, 1, 0xd3, EXT_SAR, dst ); break; /* ARSH64_REG */
+
+  case 0x37:                                                  /* DIV64_IMM (imm zero extended) */
+  case 0x97:                                                  /* MOD64_IMM (imm zero extended) */
+    if( !imm ) {
+      if( instr.opcode.raw==0x37 ) emit_rr( e, 0, 0x31, dst, dst );
+      break;
+    }
+    emit_rr( e, 1, 0x89, dst, RAX );
+    emit_rr( e, 0, 0x31, RDX, RDX );
+    emit_mov_ri32( e, RCX, imm );
+    emit_unary( e, 1, 0xf7, EXT_DIV, RCX );
+    emit_rr( e, 1, 0x89, instr.opcode.raw==0x37 ? RAX : RDX, dst );
+    break;
+
+  case 0x3f:                                                  /* DIV64_REG */
+  case 0x9f: {                                                /* MOD64_REG */
+    emit_rr( e, 1, 0x89, src, RCX );
+    emit_rr( e, 1, 0x85, RCX, RCX );
+    emit1( e, 0x74UL ); ulong jz = e->sz; emit1( e, 0UL );
+    emit_rr( e, 1, 0x89, dst, RAX );
+    emit_rr( e, 0, 0x31, RDX, RDX );
+    emit_unary( e, 1, 0xf7, EXT_DIV, RCX );
+    emit_rr( e, 1, 0x89, instr.opcode.raw==0x3f ? RAX : RDX, dst );
+    if( instr.opcode.raw==0x3f ) {
+      emit1( e, 0xebUL ); ulong jmp = e->sz; emit1( e, 0UL );
+      e->code[ jz ] = (uchar)( e->sz - (jz+1UL) );
+      emit_rr( e, 0, 0x31, dst, dst );
+      e->code[ jmp ] = (uchar)( e->sz - (jmp+1UL) );
+    } else {
+      e->code[ jz ] = (uchar)( e->sz - (jz+1UL) );
+    }
+    break;
+  }
+
+  case 0xd4: break;                                           /* END_LE (host is LE) */
+  case 0xdc:                                                  /* END_BE */
+    if( imm==16U ) {
+      emit1( e, 0x66UL ); emit_rex( e, 0, 0, 0, dst, 0 );     /* rol dst16, 8 */
+      emit1( e, 0xc1UL ); emit1( e, 0xc0UL | (ulong)(dst&7) ); emit1( e, 8UL );
+      emit_rr( e, 0, 0x0fb7, dst, dst );                      /* movzx dst32, dst16 */
+    } else if( imm==32U || imm==64U ) {
+      emit_rex( e, imm==64U, 0, 0, dst, 0 ); emit1( e, 0x0fUL ); emit1( e, 0xc8UL + (ulong)(dst&7) );
+    }
+    break;
+
+  case 0x18:                                                  /* LDQ */
+    if( FD_UNLIKELY( pc+1UL>=instrs_cnt ) ) return 0UL;
+    emit_mov_ri64( e, dst, (ulong)imm | ((ulong)instrs[ pc+1UL ].imm << 32) );
+    return 2UL;
+
+  /* Loads: dst = zero extended [src+offset] */
+  case 0x71: case 0x69: case 0x61: case 0x79: {
+    ulong sz = instr.opcode.raw==0x71 ? 1UL : instr.opcode.raw==0x69 ? 2UL : instr.opcode.raw==0x61 ? 4UL : 8UL;
+    emit_rm( e, 1, 0x8d, RAX, src, NOIDX, instr.offset );     /* lea rax, [src+off] */
+    emit_translate( e, pc, sz, 0 );
+    switch( sz ) {
+    case 1UL: emit_rm( e, 0, 0x0fb6, dst, RAX, NOIDX, 0 ); break;
+    case 2UL: emit_rm( e, 0, 0x0fb7, dst, RAX, NOIDX, 0 ); break;
+    case 4UL: emit_rm( e, 0, 0x8b,   dst, RAX, NOIDX, 0 ); break;
+    default:  emit_rm( e, 1, 0x8b,   dst, RAX, NOIDX, 0 ); break;
+    }
+    break;
+  }
+
+  /* Stores: [dst+offset] = src or imm (imm zero extended) */
+  case 0x72: case 0x6a: case 0x62: case 0x7a:
+  case 0x73: case 0x6b: case 0x63: case 0x7b: {
+    static const ulong st_sz[ 4 ] = { 4UL, 2UL, 1UL, 8UL }; /* by size mode: W H B DW */
+    ulong sz  = st_sz[ ( instr.opcode.raw>>3 ) & 3U ];
+    int   val = src;
+    emit_rm( e, 1, 0x8d, RAX, dst, NOIDX, instr.offset );     /* lea rax, [dst+off] */
+    emit_translate( e, pc, sz, 1 );
+    if( (instr.opcode.raw & 7U)==2U ) { emit_mov_ri32( e, RCX, imm ); val = RCX; }
+    switch( sz ) {
+    case 1UL: emit_rex( e, 0, val, 0, RAX, (val&7)>=4 ); emit1( e, 0x88UL ); emit_mem( e, val, RAX, NOIDX, 0 ); break;
+    case 2UL: emit1( e, 0x66UL ); emit_rm( e, 0, 0x89, val, RAX, NOIDX, 0 ); break;
+    case 4UL: emit_rm( e, 0, 0x89, val, RAX, NOIDX, 0 ); break;
+    default:  emit_rm( e, 1, 0x89, val, RAX, NOIDX, 0 ); break;
+    }
+    break;
+  }
+
+  case 0x05:                                                  /* JA */
+    if( FD_UNLIKELY( target<0L || target>=(long)instrs_cnt ) ) return 0UL;
+    emit_tally( e, pc );
+    emit_enter( e, (ulong)target );
+    if( (ulong)target!=pc+1UL ) emit_jcc_label( e, -1, (ulong)target );
+    break;
+
+  case 0x15: case 0x1d: case 0x25: case 0x2d: case 0x35: case 0x3d:
+  case 0x45: case 0x4d: case 0x55: case 0x5d: case 0x65: case 0x6d:
+  case 0x75: case 0x7d: case 0xa5: case 0xad: case 0xb5: case 0xbd:
+  case 0xc5: case 0xcd: case 0xd5: case 0xdd: {
+    if( FD_UNLIKELY( target<0L || target>=(long)instrs_cnt ) ) return 0UL;
+    emit_tally( e, pc );
+    if( (ulong)target==pc+1UL ) {
+      emit_enter( e, pc+1UL );
+      break;
+    }
+
+    /* Condition code and operand extension per the interpreter */
+    int cc; int zext = 0; int test = 0;
+    switch( instr.opcode.raw>>4 ) {
+    case 0x1: cc = CC_E;  break;                      /* JEQ  */
+    case 0x2: cc = CC_A;  break;                      /* JGT  */
+    case 0x3: cc = CC_AE; zext = 1; break;            /* JGE  */
+    case 0x4: cc = CC_NE; zext = 1; test = 1; break;  /* JSET */
+    case 0x5: cc = CC_NE; break;                      /* JNE  */
+    case 0x6: cc = CC_G;  break;                      /* JSGT */
+    case 0x7: cc = CC_GE; zext = 1; break;            /* JSGE */
+    case 0xa: cc = CC_B;  zext = 1; break;            /* JLT  */
+    case 0xb: cc = CC_BE; zext = 1; break;            /* JLE  */
+    case 0xc: cc = CC_L;  zext = 1; break;            /* JSLT */
+    default:  cc = CC_LE; zext = 1; break;            /* JSLE */
+    }
+    if( instr.opcode.raw & 0x8U ) emit_rr( e, 1, test ? 0x85 : 0x39, src, dst );
+    else                          emit_cmp_imm( e, dst, imm, zext, test );
+
+    emit1( e, 0x70UL | (ulong)(cc^1) ); ulong jn = e->sz; emit1( e, 0UL );  /* j!cc .not_taken */
+    emit_enter( e, (ulong)target );
+    emit_jcc_label( e, -1, (ulong)target );
+    e->code[ jn ] = (uchar)( e->sz - (jn+1UL) );
+    emit_enter( e, pc+1UL );
+    break;
+  }
+
+  case 0x85: emit_helper( e, (ulong)fd_vm_jit_private_call_imm, pc, imm ); break; /* CALL_IMM */
+  case 0x8d:                                                                      /* CALL_REG */
+    if( FD_UNLIKELY( imm>10U ) ) return 0UL;
+    emit_helper( e, (ulong)fd_vm_jit_private_call_reg, pc, imm );
+    break;
+  case 0x95: emit_helper( e, (ulong)fd_vm_jit_private_exit, pc, 0U ); break;     /* EXIT */
+
+  default:
+    return 0UL;
+  }
+  return 1UL;
+}
+
+/* Compiler **********************************************************/
+
+/* Number of programs currently mapped */
+
+static ulong fd_vm_jit_prog_live;
+
+fd_vm_jit_prog_t *
+fd_vm_jit_compile( fd_sbpf_instr_t const * instrs,
+                   ulong                   instrs_cnt ) {
+  if( FD_UNLIKELY( !instrs || !instrs_cnt || instrs_cnt>FD_VM_JIT_INSTR_MAX ) ) return NULL;
+
+  /* Layout: prog header, code_tab, cnt_tab, then the code on its own
+     pages.  Worst case code size: every instruction at its max plus
+     two stubs each, the ADDL stubs, the prologue and the fall off the
+     end stub. */
+
+  ulong page_sz  = 4096UL;
+  ulong hdr_sz   = fd_ulong_align_up( sizeof(fd_vm_jit_prog_t) + (instrs_cnt+1UL)*sizeof(void *) + (instrs_cnt+1UL)*sizeof(uint), page_sz );
+  ulong code_max = instrs_cnt*( FD_VM_JIT_INSTR_CODE_MAX + 3UL*FD_VM_JIT_STUB_CODE_MAX ) + 4096UL;
+  ulong map_sz   = hdr_sz + fd_ulong_align_up( code_max, page_sz );
+
+  uchar * map = mmap( NULL, map_sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(%lu KiB) failed", map_sz>>10 ));
+    return NULL;
+  }
+
+  ulong   scratch_sz = fd_ulong_align_up( instrs_cnt*( 3UL*sizeof(fd_vm_jit_patch_t) + 2UL*sizeof(fd_vm_jit_patch_t) + 2UL*sizeof(fd_vm_jit_stub_t) ) + 64UL, page_sz );
+  uchar * scratch    = mmap( NULL, scratch_sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+  if( FD_UNLIKELY( scratch==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(%lu KiB) failed", scratch_sz>>10 ));
+    munmap( map, map_sz );
+    return NULL;
+  }
+
+  fd_vm_jit_prog_t * prog = (fd_vm_jit_prog_t *)map;
+  prog->map_sz     = map_sz;
+  prog->instrs_cnt = instrs_cnt;
+  prog->ref_cnt    = 1UL;
+  prog->last_use   = 0UL;
+  prog->code_tab   = (void const **)( map + sizeof(fd_vm_jit_prog_t) );
+  prog->cnt_tab    = (uint *)( prog->code_tab + instrs_cnt + 1UL );
+
+  ulong cnt = 0UL;
+  for( ulong pc=0UL; pc<instrs_cnt; pc++ ) {
+    prog->cnt_tab[ pc ] = (uint)cnt;
+    cnt += (ulong)( instrs[ pc ].opcode.raw!=0x18 );
+  }
+  prog->cnt_tab[ instrs_cnt ] = (uint)cnt;
+
+  fd_vm_jit_emit_t e[1] = {{
+    .code        = map + hdr_sz,
+    .sz          = 0UL,
+    .cnt_tab     = prog->cnt_tab,
+    .label_patch = (fd_vm_jit_patch_t *)scratch,
+    .stub_patch  = (fd_vm_jit_patch_t *)scratch + 2UL*instrs_cnt,
+    .stub        = (fd_vm_jit_stub_t  *)( (fd_vm_jit_patch_t *)scratch + 5UL*instrs_cnt ),
+  }};
+
+  /* code_tab holds code offsets until the end */
+  ulong * label = (ulong *)prog->code_tab;
+
+  emit_prologue( e );
+
+  for( ulong pc=0UL; pc<instrs_cnt; ) {
+    label[ pc ] = e->sz;
+    ulong ulen = fd_vm_jit_emit_instr( e, instrs, instrs_cnt, pc );
+    if( FD_UNLIKELY( !ulen ) ) goto fail;
+    FD_TEST( e->sz + FD_VM_JIT_INSTR_CODE_MAX <= code_max );
+    pc += ulen;
+  }
+
+  /* Falling off the end of the program */
+
+  label[ instrs_cnt ] = e->sz;
+  emit_frame_st_imm( e, FRAME( pc   ), (uint)instrs_cnt );
+  emit_frame_st_imm( e, FRAME( exit ), (uint)FD_VM_JIT_EXIT_FAULT );
+  patch_rel32( e, emit_jmp32( e ), e->exit_spill );
+
+  /* Budget and access violation stubs */
+
+  for( ulong i=0UL; i<e->stub_cnt; i++ ) {
+    ulong off = e->sz;
+    emit_frame_st_imm( e, FRAME( pc   ), e->stub[ i ].pc   );
+    emit_frame_st_imm( e, FRAME( exit ), e->stub[ i ].exit );
+    patch_rel32( e, emit_jmp32( e ), e->exit_spill );
+    e->stub[ i ].pc = (uint)off;
+  }
+  for( ulong i=0UL; i<e->stub_patch_cnt; i++ ) patch_rel32( e, e->stub_patch[ i ].at, e->stub[ e->stub_patch[ i ].to ].pc );
+
+  /* The second half of an LDQ is only reachable through an indirect
+     call, in which case the interpreter executes it as ADD_IMM */
+
+  for( ulong pc=0UL; pc+1UL<instrs_cnt; pc++ ) {
+    if( instrs[ pc ].opcode.raw!=0x18 ) continue;
+    fd_sbpf_instr_t addl = instrs[ pc+1UL ];
+    label[ pc+1UL ] = e->sz;
+    if( FD_UNLIKELY( addl.dst_reg>10 ) ) goto fail;
+    emit_alu_ri( e, 0, EXT_ADD, fd_vm_jit_reg[ addl.dst_reg ], addl.imm );
+    emit_jcc_label( e, -1, pc+2UL );
+    pc++;
+  }
+
+  for( ulong i=0UL; i<e->label_patch_cnt; i++ ) patch_rel32( e, e->label_patch[ i ].at, label[ e->label_patch[ i ].to ] );
+
+  FD_TEST( e->sz<=code_max );
+
+  for( ulong pc=0UL; pc<=instrs_cnt; pc++ ) prog->code_tab[ pc ] = e->code + label[ pc ];
+  prog->entry = (fd_vm_jit_entry_fn_t)(ulong)e->code;
+
+  munmap( scratch, scratch_sz );
+  if( FD_UNLIKELY( mprotect( e->code, map_sz-hdr_sz, PROT_READ|PROT_EXEC ) ) ) {
+    FD_LOG_WARNING(( "mprotect failed" ));
+    munmap( map, map_sz );
+    return NULL;
+  }
+  FD_ATOMIC_FETCH_AND_ADD( &fd_vm_jit_prog_live, 1UL );
+  return prog;
+
+fail:
+  munmap( scratch, scratch_sz );
+  munmap( map, map_sz );
+  return NULL;
+}
+
+void
+fd_vm_jit_delete( fd_vm_jit_prog_t * prog ) {
+  if( FD_UNLIKELY( !prog ) ) return;
+  munmap( prog, prog->map_sz );
+  FD_ATOMIC_FETCH_AND_SUB( &fd_vm_jit_prog_live, 1UL );
+}
+
+ulong
+fd_vm_jit_prog_cnt( void ) {
+  return FD_VOLATILE_CONST( fd_vm_jit_prog_live );
+}
+
+/* Execution *********************************************************/
+
+ulong
+fd_vm_jit_exec( fd_vm_jit_prog_t const * prog,
+                fd_vm_exec_context_t *   ctx ) {
+
+  /* Same prologue as fd_vm_interp_instrs */
+
+  fd_vm_jit_frame_t frame[1] = {{
+    .ctx        = ctx,
+    .code_tab   = prog->code_tab,
+    .cnt_tab    = prog->cnt_tab,
+    .instrs_cnt = prog->instrs_cnt,
+    .due        = ctx->due_insn_cnt,
+    .prev       = ctx->previous_instruction_meter,
+    .ic         = ctx->instruction_counter,
+    .pc         = (ulong)ctx->entrypoint,
+    .exit       = FD_VM_JIT_EXIT_HALT,
+  }};
+
+  ulong heap_cus_consumed = fd_ulong_sat_mul( fd_ulong_sat_sub( ctx->heap_sz / (32*1024), 1 ), vm_compute_budget.heap_cost );
+  frame->cond_fault = fd_vm_consume_compute_meter( ctx, heap_cus_consumed );
+  frame->meter      = ctx->compute_meter;
+
+  if( FD_LIKELY( !frame->cond_fault ) ) {
+    if( FD_UNLIKELY( frame->pc>=prog->instrs_cnt ) ) {
+      frame->cond_fault = 1UL;
+    } else {
+      frame->start = prog->cnt_tab[ frame->pc ];
+
+      frame->region_base [ 1 ] = (ulong)ctx->read_only;
+      frame->region_rd_sz[ 1 ] = ctx->read_only_sz;
+      frame->region_base [ 2 ] = (ulong)ctx->stack.data;
+      frame->region_rd_sz[ 2 ] = FD_VM_STACK_MAX_DEPTH * FD_VM_STACK_FRAME_WITH_GUARD_SZ;
+      frame->region_wr_sz[ 2 ] = FD_VM_STACK_MAX_DEPTH * FD_VM_STACK_FRAME_WITH_GUARD_SZ;
+      frame->region_gap  [ 2 ] = 1UL<<12;
+      frame->region_base [ 3 ] = (ulong)ctx->heap;
+      frame->region_rd_sz[ 3 ] = ctx->heap_sz;
+      frame->region_wr_sz[ 3 ] = ctx->heap_sz;
+      frame->region_base [ 4 ] = (ulong)ctx->input;
+      frame->region_rd_sz[ 4 ] = ctx->input_sz;
+      frame->region_wr_sz[ 4 ] = ctx->input_sz;
+
+      prog->entry( frame );
+
+      switch( frame->exit ) {
+      case FD_VM_JIT_EXIT_FAULT:
+        frame->cond_fault = 1UL;
+        break;
+      case FD_VM_JIT_EXIT_BUDGET:
+        frame->meter      = 0UL;
+        frame->due        = 0UL;
+        frame->prev       = 0UL;
+        frame->cond_fault = 1UL;
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  /* Same epilogue as fd_vm_interp_instrs */
+
+  ctx->compute_meter              = fd_ulong_sat_sub( frame->meter, frame->due );
+  ctx->due_insn_cnt               = 0UL;
+  ctx->previous_instruction_meter = ctx->compute_meter;
+  ctx->program_counter            = frame->pc;
+  ctx->instruction_counter        = frame->ic;
+  ctx->cond_fault                 = frame->cond_fault;
+  return 0UL;
+}
+
+/* Cache *************************************************************/
+
+/* Open addressed by key with linear probing, at most half full.  The
+   table and the cache clock are protected by a spin lock.  Lookups are
+   short compared to running a program, so readers take it too: that
+   lets a lookup acquire a reference on the program before an evictor
+   can drop the cache's reference.  A program is unmapped when its last
+   reference is released, so evicting a program that is still running
+   is safe. */
+
+#define FD_VM_JIT_CACHE_PROG_MAX (FD_VM_JIT_CACHE_SLOT_CNT/2UL)
+
+static fd_vm_jit_prog_t * fd_vm_jit_cache[ FD_VM_JIT_CACHE_SLOT_CNT ];
+static ulong              fd_vm_jit_cache_cnt;
+static ulong              fd_vm_jit_cache_clock;
+static volatile int       fd_vm_jit_cache_lock;
+
+static inline void
+fd_vm_jit_cache_lock_acquire( void ) {
+  while( FD_UNLIKELY( FD_ATOMIC_CAS( &fd_vm_jit_cache_lock, 0, 1 ) ) ) FD_SPIN_PAUSE();
+  FD_COMPILER_MFENCE();
+}
+
+static inline void
+fd_vm_jit_cache_lock_release( void ) {
+  FD_COMPILER_MFENCE();
+  fd_vm_jit_cache_lock = 0;
+}
+
+static inline ulong
+fd_vm_jit_cache_home( uchar const * key ) {
+  return FD_LOAD( ulong, key ) & (FD_VM_JIT_CACHE_SLOT_CNT-1UL);
+}
+
+/* fd_vm_jit_cache_slot returns the slot holding the program for key or
+   the empty slot where it would go.  The table is never full so this
+   terminates.  Caller holds the lock. */
+
+static ulong
+fd_vm_jit_cache_slot( uchar const * key,
+                      ulong         instrs_cnt ) {
+  ulong slot = fd_vm_jit_cache_home( key );
+  for(;;) {
+    fd_vm_jit_prog_t const * prog = fd_vm_jit_cache[ slot ];
+    if( !prog ) break;
+    if( prog->instrs_cnt==instrs_cnt && !memcmp( prog->key, key, 32UL ) ) break;
+    slot = (slot+1UL) & (FD_VM_JIT_CACHE_SLOT_CNT-1UL);
+  }
+  return slot;
+}
+
+/* fd_vm_jit_cache_remove unlinks the program at slot and returns it.
+   Later entries of the same probe run are shifted back into the hole so
+   lookups need no tombstones.  Caller holds the lock. */
+
+static fd_vm_jit_prog_t *
+fd_vm_jit_cache_remove( ulong slot ) {
+  fd_vm_jit_prog_t * prog = fd_vm_jit_cache[ slot ];
+  fd_vm_jit_cache[ slot ] = NULL;
+  fd_vm_jit_cache_cnt--;
+
+  ulong hole = slot;
+  for(;;) {
+    slot = (slot+1UL) & (FD_VM_JIT_CACHE_SLOT_CNT-1UL);
+    fd_vm_jit_prog_t * next = fd_vm_jit_cache[ slot ];
+    if( !next ) break;
+    ulong home = fd_vm_jit_cache_home( next->key );
+    /* next can move into the hole iff the hole is on its probe path */
+    if( ( (slot-home) & (FD_VM_JIT_CACHE_SLOT_CNT-1UL) )>=( (slot-hole) & (FD_VM_JIT_CACHE_SLOT_CNT-1UL) ) ) {
+      fd_vm_jit_cache[ hole ] = next;
+      fd_vm_jit_cache[ slot ] = NULL;
+      hole = slot;
+    }
+  }
+  return prog;
+}
+
+/* fd_vm_jit_cache_acquire returns the cached program for key with a
+   reference acquired, or NULL on miss.  If fresh is non-NULL, it is
+   inserted on miss (taking over fresh's initial reference) and
+   returned, evicting the least recently used program if the cache is
+   full.  The evicted program is returned in *_evict; the caller drops
+   the cache's reference to it outside the lock. */
+
+static fd_vm_jit_prog_t *
+fd_vm_jit_cache_acquire( uchar const *       key,
+                         ulong               instrs_cnt,
+                         fd_vm_jit_prog_t *  fresh,
+                         fd_vm_jit_prog_t ** _evict ) {
+  *_evict = NULL;
+  fd_vm_jit_cache_lock_acquire();
+
+  ulong              slot = fd_vm_jit_cache_slot( key, instrs_cnt );
+  fd_vm_jit_prog_t * prog = fd_vm_jit_cache[ slot ];
+
+  if( !prog && fresh ) {
+    if( FD_UNLIKELY( fd_vm_jit_cache_cnt>=FD_VM_JIT_CACHE_PROG_MAX ) ) {
+      ulong lru_slot = 0UL;
+      ulong lru_use  = ULONG_MAX;
+      for( ulong i=0UL; i<FD_VM_JIT_CACHE_SLOT_CNT; i++ ) {
+        fd_vm_jit_prog_t const * p = fd_vm_jit_cache[ i ];
+        if( p && p->last_use<lru_use ) { lru_slot = i; lru_use = p->last_use; }
+      }
+      *_evict = fd_vm_jit_cache_remove( lru_slot );
+      slot    = fd_vm_jit_cache_slot( key, instrs_cnt ); /* entries might have shifted */
+    }
+    fd_vm_jit_cache[ slot ] = fresh;
+    fd_vm_jit_cache_cnt++;
+    prog = fresh;
+  }
+
+  if( FD_LIKELY( prog ) ) {
+    prog->last_use = ++fd_vm_jit_cache_clock;
+    FD_ATOMIC_FETCH_AND_ADD( &prog->ref_cnt, 1UL );
+  }
+
+  fd_vm_jit_cache_lock_release();
+  return prog;
+}
+
+fd_vm_jit_prog_t const *
+fd_vm_jit_cache_query( uchar const *           key,
+                       fd_sbpf_instr_t const * instrs,
+                       ulong                   instrs_cnt ) {
+  fd_vm_jit_prog_t * evict;
+  fd_vm_jit_prog_t * prog = fd_vm_jit_cache_acquire( key, instrs_cnt, NULL, &evict );
+  if( FD_LIKELY( prog ) ) return prog;
+
+  /* Compile outside the lock, another thread might beat us to it */
+
+  fd_vm_jit_prog_t * fresh = fd_vm_jit_compile( instrs, instrs_cnt );
+  if( FD_UNLIKELY( !fresh ) ) return NULL;
+  memcpy( fresh->key, key, 32UL );
+
+  prog = fd_vm_jit_cache_acquire( key, instrs_cnt, fresh, &evict );
+  if( FD_UNLIKELY( prog!=fresh ) ) fd_vm_jit_delete( fresh );
+  fd_vm_jit_cache_release( evict );
+  return prog;
+}
+
+void
+fd_vm_jit_cache_release( fd_vm_jit_prog_t const * prog ) {
+  if( FD_UNLIKELY( !prog ) ) return;
+  fd_vm_jit_prog_t * p = (fd_vm_jit_prog_t *)prog;
+  if( FD_ATOMIC_FETCH_AND_SUB( &p->ref_cnt, 1UL )==1UL ) fd_vm_jit_delete( p );
+}
+
+void
+fd_vm_jit_cache_clear( void ) {
+  fd_vm_jit_cache_lock_acquire();
+  for( ulong i=0UL; i<FD_VM_JIT_CACHE_SLOT_CNT; i++ ) {
+    fd_vm_jit_prog_t * prog = fd_vm_jit_cache[ i ];
+    fd_vm_jit_cache[ i ] = NULL;
+    fd_vm_jit_cache_release( prog );
+  }
+  fd_vm_jit_cache_cnt = 0UL;
+  fd_vm_jit_cache_lock_release();
+}
+
+#else /* JIT not available on this target */
+
+fd_vm_jit_prog_t *
+fd_vm_jit_compile( fd_sbpf_instr_t const * instrs,
+                   ulong                   instrs_cnt ) {
+  (void)instrs; (void)instrs_cnt;
+  return NULL;
+}
+
+void
+fd_vm_jit_delete( fd_vm_jit_prog_t * prog ) {
+  (void)prog;
+}
+
+ulong
+fd_vm_jit_exec( fd_vm_jit_prog_t const * prog,
+                fd_vm_exec_context_t *   ctx ) {
+  (void)prog;
+  return fd_vm_interp_instrs( ctx );
+}
+
+ulong
+fd_vm_jit_prog_cnt( void ) {
+  return 0UL;
+}
+
+fd_vm_jit_prog_t const *
+fd_vm_jit_cache_query( uchar const *           key,
+                       fd_sbpf_instr_t const * instrs,
+                       ulong                   instrs_cnt ) {
+  (void)key; (void)instrs; (void)instrs_cnt;
+  return NULL;
+}
+
+void
+fd_vm_jit_cache_release( fd_vm_jit_prog_t const * prog ) {
+  (void)prog;
+}
+
+void
+fd_vm_jit_cache_clear( void ) {}
+
+#endif
+
+static volatile int fd_vm_jit_on;
+
+void
+fd_vm_jit_enable( int enabled ) {
+  fd_vm_jit_on = !!enabled;
+}
+
+int
+fd_vm_jit_enabled( void ) {
+  return fd_vm_jit_on;
+}
+
+ulong
+fd_vm_jit_instrs( fd_vm_exec_context_t * ctx,
+                  uchar const *          key ) {
+  if( FD_LIKELY( !fd_vm_jit_on ) ) return fd_vm_interp_instrs( ctx );
+
+  uchar _key[ 32 ];
+  if( !key ) key = fd_sha256_hash( ctx->instrs, ctx->instrs_sz*sizeof(fd_sbpf_instr_t), _key );
+
+  fd_vm_jit_prog_t const * prog = fd_vm_jit_cache_query( key, ctx->instrs, ctx->instrs_sz );
+  if( FD_UNLIKELY( !prog ) ) return fd_vm_interp_instrs( ctx );
+  ulong res = fd_vm_jit_exec( prog, ctx );
+  fd_vm_jit_cache_release( prog );
+  return res;
+}
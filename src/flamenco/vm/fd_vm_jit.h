@@ -0,0 +1,140 @@
+#ifndef HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+#define HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+
+/* fd_vm_jit translates a validated sBPF program ahead of time into
+   x86-64 machine code.  The generated code is a drop-in replacement
+   for fd_vm_interp_instrs: given the same execution context, it leaves
+   the context (register file, program counter, instruction counter,
+   compute meter, fault state, VM memory) in exactly the same state the
+   interpreter would.
+
+   Code generation summary:
+
+   - sBPF registers r0..r10 live in host registers for the whole run.
+
+   - Loads and stores do the region translation of
+     fd_vm_translate_vm_to_host_private inline against a small per-run
+     region table (host base, readable size, writable size, gap mask).
+
+   - Compute units are metered per basic block like the interpreter
+     does: every branch charges the instructions executed since the
+     block was entered and faults once the budget is exhausted.
+
+   - Calls, syscalls and exits are rare relative to ALU and memory
+     ops, so they spill the register file and go through C helpers that
+     reproduce the interpreter's bookkeeping exactly.
+
+   Compiled programs are cached process-wide, keyed by a SHA-256 of the
+   program text, so a program is translated once and reused across
+   invocations and threads.  When the cache is full, the least recently
+   used program is evicted and unmapped once no thread runs it anymore.
+
+   The JIT is off by default and has to be turned on for the process
+   with fd_vm_jit_enable.  While off, fd_vm_jit_instrs is just
+   fd_vm_interp_instrs.
+
+   The JIT is only available on x86-64 hosted targets.  Elsewhere (and
+   for programs the JIT does not handle, e.g. opcodes the interpreter
+   does not implement either), fd_vm_jit_instrs falls back to
+   fd_vm_interp_instrs. */
+
+#include "fd_vm_context.h"
+
+/* FD_VM_JIT_INSTR_MAX is the largest program (in instructions) the JIT
+   will compile. */
+
+#define FD_VM_JIT_INSTR_MAX (1UL<<24)
+
+/* FD_VM_JIT_CACHE_SLOT_CNT is the number of slots of the process-wide
+   cache.  Power of two.  The cache holds at most half as many
+   programs. */
+
+#define FD_VM_JIT_CACHE_SLOT_CNT (4096UL)
+
+struct fd_vm_jit_prog;
+typedef struct fd_vm_jit_prog fd_vm_jit_prog_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vm_jit_compile translates the instrs_cnt instructions at instrs
+   into native code.  The program should have passed
+   fd_vm_context_validate.  Returns a handle to the compiled program on
+   success and NULL on failure (unsupported platform, opcode or operand,
+   program too large, out of memory).  The returned program does not
+   reference instrs.  Compilation does not depend on the syscall table,
+   call destinations, entrypoint or memory regions; those are taken from
+   the execution context at run time. */
+
+fd_vm_jit_prog_t *
+fd_vm_jit_compile( fd_sbpf_instr_t const * instrs,
+                   ulong                   instrs_cnt );
+
+/* fd_vm_jit_delete frees a program returned by fd_vm_jit_compile.  The
+   program must not be in use or in the cache. */
+
+void
+fd_vm_jit_delete( fd_vm_jit_prog_t * prog );
+
+/* fd_vm_jit_prog_cnt returns the number of compiled programs currently
+   mapped by the process (cached, in use or not yet deleted). */
+
+ulong
+fd_vm_jit_prog_cnt( void );
+
+/* fd_vm_jit_exec runs prog (compiled from ctx->instrs) on ctx.  Has the
+   same contract as fd_vm_interp_instrs. */
+
+ulong
+fd_vm_jit_exec( fd_vm_jit_prog_t const * prog,
+                fd_vm_exec_context_t *   ctx );
+
+/* fd_vm_jit_cache_query returns the compiled program for instrs,
+   identified by key (32 byte SHA-256 of the instrs_cnt instructions at
+   instrs).  Compiles and caches the program on miss, evicting the least
+   recently used program if the cache is full.  Returns NULL if the
+   program could not be compiled.  The returned program stays mapped
+   (even if evicted meanwhile) until the caller gives it back with
+   fd_vm_jit_cache_release.  Safe to call concurrently. */
+
+fd_vm_jit_prog_t const *
+fd_vm_jit_cache_query( uchar const *           key,
+                       fd_sbpf_instr_t const * instrs,
+                       ulong                   instrs_cnt );
+
+/* fd_vm_jit_cache_release releases a program returned by
+   fd_vm_jit_cache_query.  NULL is a no-op. */
+
+void
+fd_vm_jit_cache_release( fd_vm_jit_prog_t const * prog );
+
+/* fd_vm_jit_cache_clear evicts all programs from the cache.  Programs
+   still in use are unmapped when released. */
+
+void
+fd_vm_jit_cache_clear( void );
+
+/* fd_vm_jit_enable turns native execution by fd_vm_jit_instrs on
+   (enabled non-zero) or off for the whole process.
+   fd_vm_jit_enabled returns the current setting.  Off by default. */
+
+void
+fd_vm_jit_enable( int enabled );
+
+int
+fd_vm_jit_enabled( void );
+
+/* fd_vm_jit_instrs runs the sBPF program from the context until
+   completion or a fault occurs using the cached native code for it,
+   falling back to the interpreter when the JIT is disabled or no native
+   code is available.
+   key is the SHA-256 of the program text (ctx->instrs_sz instructions
+   at ctx->instrs); if NULL, it is computed here.  Has the same contract
+   as fd_vm_interp_instrs. */
+
+ulong
+fd_vm_jit_instrs( fd_vm_exec_context_t * ctx,
+                  uchar const *          key );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_vm_fd_vm_jit_h */
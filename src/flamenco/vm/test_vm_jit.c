@@ -0,0 +1,451 @@
+#include "../fd_flamenco_base.h"
+#include "fd_vm_jit.h"
+#include "fd_vm_interp.h"
+#include "fd_vm_syscalls.h"
+#include "../../ballet/murmur3/fd_murmur3.h"
+#include "../../ballet/sha256/fd_sha256.h"
+
+#if FD_HAS_X86 && FD_HAS_HOSTED
+
+/* Differential test: random programs are run through both the
+   interpreter and the JIT and must leave identical VM state behind. */
+
+#define INSTR_MAX     (512UL)
+#define INPUT_SZ      (256UL)
+#define HEAP_SZ       (64UL*1024UL)
+#define STACK_CMP_SZ  (FD_VM_STACK_MAX_DEPTH * FD_VM_STACK_FRAME_WITH_GUARD_SZ)
+
+static fd_vm_exec_context_t ctx_ref[1];
+static fd_vm_exec_context_t ctx_jit[1];
+
+static uchar input_ref[ INPUT_SZ ];
+static uchar input_jit[ INPUT_SZ ];
+static uchar rodata   [ INPUT_SZ ];
+
+static fd_sbpf_instr_t instrs[ INSTR_MAX ];
+
+static fd_sbpf_syscalls_t * syscalls;
+static fd_sbpf_calldests_t * calldests;
+
+static uint accumulator_id;
+
+static ulong
+accumulator_syscall( void *  _ctx,
+                     ulong   arg0,
+                     ulong   arg1,
+                     ulong   arg2,
+                     ulong   arg3,
+                     ulong   arg4,
+                     ulong * ret ) {
+  (void)_ctx;
+  *ret = arg0 + arg1 + arg2 + arg3 + arg4;
+  return 0UL;
+}
+
+static inline fd_sbpf_instr_t
+instr( ulong opcode,
+       ulong dst,
+       ulong src,
+       long  off,
+       ulong imm ) {
+  return (fd_sbpf_instr_t){ .opcode.raw = (uchar)opcode, .dst_reg = (uchar)( dst & 0xfUL ), .src_reg = (uchar)( src & 0xfUL ), .offset = (short)off, .imm = (uint)imm };
+}
+
+/* Immediates biased towards the interesting edges */
+
+static uint
+rand_imm( fd_rng_t * rng ) {
+  switch( fd_rng_uint_roll( rng, 6U ) ) {
+  case 0:  return 0U;
+  case 1:  return fd_rng_uint_roll( rng, 64U );
+  case 2:  return (uint)-(int)fd_rng_uint_roll( rng, 64U );
+  case 3:  return 0x80000000U | fd_rng_uint_roll( rng, 4U );
+  default: return fd_rng_uint( rng );
+  }
+}
+
+/* r1, r2 and r10 hold input, heap and stack pointers and are never
+   written to by ALU ops so that memory ops mostly hit valid memory.  r9
+   only ever holds a valid CALL_REG target (the interpreter does not
+   bounds check those). */
+
+static ulong
+rand_dst( fd_rng_t * rng ) {
+  static const uchar dst[ 7 ] = { 0, 3, 4, 5, 6, 7, 8 };
+  return dst[ fd_rng_uint_roll( rng, 7U ) ];
+}
+
+static ulong
+gen_program( fd_rng_t * rng ) {
+  static const uchar alu[] = {
+    0x04, 0x0c, 0x14, 0x1c, 0x24, 0x2c, 0x34, 0x3c, 0x44, 0x4c, 0x54, 0x5c, 0x64, 0x6c, 0x74, 0x7c,
+    0x84, 0x94, 0x9c, 0xa4, 0xac, 0xb4, 0xbc, 0xc4, 0xcc, 0xd4, 0xdc,
+    0x07, 0x0f, 0x17, 0x1f, 0x27, 0x2f, 0x37, 0x3f, 0x47, 0x4f, 0x57, 0x5f, 0x67, 0x6f, 0x77, 0x7f,
+    0x87, 0x97, 0x9f, 0xa7, 0xaf, 0xb7, 0xbf, 0xc7, 0xcf };
+  static const uchar jmp[] = {
+    0x05, 0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d, 0x45, 0x4d, 0x55, 0x5d, 0x65, 0x6d,
+    0x75, 0x7d, 0xa5, 0xad, 0xb5, 0xbd, 0xc5, 0xcd, 0xd5, 0xdd };
+  static const uchar mem[] = {
+    0x61, 0x69, 0x71, 0x79, 0x62, 0x6a, 0x72, 0x7a, 0x63, 0x6b, 0x73, 0x7b };
+
+  ulong cnt = 16UL + fd_rng_ulong_roll( rng, INSTR_MAX-16UL );
+  fd_sbpf_calldests_null( calldests );
+
+  for( ulong pc=0UL; pc<cnt-1UL; pc++ ) {
+    uint r = fd_rng_uint_roll( rng, 100U );
+    if( r<45U ) {
+      ulong op = alu[ fd_rng_uint_roll( rng, sizeof(alu) ) ];
+      ulong imm = rand_imm( rng );
+      if( op==0xd4 || op==0xdc ) imm = 16U<<fd_rng_uint_roll( rng, 3U );
+      instrs[ pc ] = instr( op, rand_dst( rng ), fd_rng_uint_roll( rng, 11U ), 0L, imm );
+    } else if( r<65U ) {
+      ulong op  = jmp[ fd_rng_uint_roll( rng, sizeof(jmp) ) ];
+      /* Mostly forward, some backward (loops end when the budget runs out) */
+      long  tgt = fd_rng_uint_roll( rng, 4U ) ? (long)pc + 1L + (long)fd_rng_uint_roll( rng, 16U ) : (long)fd_rng_ulong_roll( rng, cnt );
+      if( tgt>=(long)cnt ) tgt = (long)cnt-1L;
+      instrs[ pc ] = instr( op, fd_rng_uint_roll( rng, 10U ), fd_rng_uint_roll( rng, 11U ), tgt-(long)pc-1L, rand_imm( rng ) );
+    } else if( r<85U ) {
+      ulong op   = mem[ fd_rng_uint_roll( rng, sizeof(mem) ) ];
+      ulong base; long off;
+      switch( fd_rng_uint_roll( rng, 4U ) ) {
+      case 0:  base = 2UL;  off = (long)fd_rng_uint_roll( rng, 128U ) - 8L;                          break;
+      case 1:  base = 10UL; off = (long)fd_rng_uint_roll( rng, 0x2400U ) - 0x1200L;                  break;
+      default: base = 1UL;  off = (long)fd_rng_uint_roll( rng, (uint)INPUT_SZ+16U ) - 8L;           break;
+      }
+      if( (op & 7UL)==1UL ) instrs[ pc ] = instr( op, rand_dst( rng ), base, off, 0UL );
+      else                  instrs[ pc ] = instr( op, base, fd_rng_uint_roll( rng, 11U ), off, rand_imm( rng ) );
+    } else if( r<88U && pc+2UL<cnt ) {
+      instrs[ pc   ] = instr( 0x18, rand_dst( rng ), 0UL, 0L, rand_imm( rng ) );
+      instrs[ pc+1 ] = instr( 0x00, 0UL, 0UL, 0L, rand_imm( rng ) );
+      pc++;
+    } else if( r<92U ) {
+      instrs[ pc ] = instr( 0x85, 0UL, 1UL, 0L, accumulator_id );
+    } else if( r<95U ) {
+      ulong tgt = fd_rng_ulong_roll( rng, cnt );
+      fd_sbpf_calldests_insert( calldests, tgt );
+      instrs[ pc ] = instr( 0x85, 0UL, 1UL, 0L, fd_pchash( (uint)tgt ) );
+    } else if( r<96U && pc+3UL<cnt ) {
+      ulong tgt = fd_rng_ulong_roll( rng, cnt );
+      instrs[ pc   ] = instr( 0x18, 9UL, 0UL, 0L, (tgt*8UL) );
+      instrs[ pc+1 ] = instr( 0x00, 0UL, 0UL, 0L, 0UL );
+      instrs[ pc+2 ] = instr( 0x8d, 0UL, 0UL, 0L, 9UL );
+      pc += 2UL;
+    } else {
+      instrs[ pc ] = instr( 0x95, 0UL, 0UL, 0L, 0UL );
+    }
+  }
+  instrs[ cnt-1UL ] = instr( 0x95, 0UL, 0UL, 0L, 0UL );
+
+  /* The second half of an LDQ is not a valid jump target */
+  for( ulong pc=0UL; pc<cnt; pc++ ) {
+    uint op = instrs[ pc ].opcode.raw;
+    if( (op & 7U)!=5U || (op>>4)==8U || (op>>4)==9U ) continue; /* not a jump, or call / exit */
+    long tgt = (long)pc + 1L + (long)instrs[ pc ].offset;
+    if( tgt>0L && instrs[ tgt ].opcode.raw==0x00 ) instrs[ pc ].offset = (short)( instrs[ pc ].offset-1 );
+  }
+  return cnt;
+}
+
+static void
+init_ctx( fd_vm_exec_context_t * ctx,
+          uchar *                input,
+          ulong                  cnt,
+          ulong                  entry,
+          ulong                  budget,
+          ulong                  heap_sz,
+          ulong const *          reg ) {
+  memset( ctx, 0, sizeof(fd_vm_exec_context_t) );
+  ctx->entrypoint                 = (long)entry;
+  ctx->instrs                     = instrs;
+  ctx->instrs_sz                  = cnt;
+  ctx->syscall_map                = syscalls;
+  ctx->calldests                  = calldests;
+  ctx->compute_meter              = budget;
+  ctx->previous_instruction_meter = budget;
+  ctx->input                      = input;
+  ctx->input_sz                   = INPUT_SZ;
+  ctx->read_only                  = rodata;
+  ctx->read_only_sz               = INPUT_SZ;
+  ctx->heap_sz                    = heap_sz;
+  memcpy( ctx->register_file, reg, sizeof(ctx->register_file) );
+}
+
+static void
+check_same( ulong iter ) {
+  int ok = 1;
+  for( ulong i=0UL; i<11UL; i++ ) {
+    if( ctx_ref->register_file[i]!=ctx_jit->register_file[i] ) {
+      FD_LOG_WARNING(( "iter %lu: r%lu interp 0x%lx jit 0x%lx", iter, i, ctx_ref->register_file[i], ctx_jit->register_file[i] ));
+      ok = 0;
+    }
+  }
+# define CHECK_FIELD(f) do {                                                                              \
+    if( ctx_ref->f!=ctx_jit->f ) {                                                                        \
+      FD_LOG_WARNING(( "iter %lu: " #f " interp %lu jit %lu", iter, (ulong)ctx_ref->f, (ulong)ctx_jit->f )); \
+      ok = 0;                                                                                             \
+    }                                                                                                     \
+  } while(0)
+  CHECK_FIELD( program_counter            );
+  CHECK_FIELD( instruction_counter        );
+  CHECK_FIELD( compute_meter              );
+  CHECK_FIELD( due_insn_cnt               );
+  CHECK_FIELD( previous_instruction_meter );
+  CHECK_FIELD( cond_fault                 );
+  CHECK_FIELD( stack.frames_used          );
+# undef CHECK_FIELD
+  if( memcmp( input_ref, input_jit, INPUT_SZ ) ) { FD_LOG_WARNING(( "iter %lu: input differs", iter )); ok = 0; }
+  if( memcmp( ctx_ref->heap, ctx_jit->heap, HEAP_SZ ) ) { FD_LOG_WARNING(( "iter %lu: heap differs", iter )); ok = 0; }
+  if( memcmp( ctx_ref->stack.data, ctx_jit->stack.data, STACK_CMP_SZ ) ) { FD_LOG_WARNING(( "iter %lu: stack differs", iter )); ok = 0; }
+  if( memcmp( ctx_ref->stack.frames, ctx_jit->stack.frames, ctx_ref->stack.frames_used*sizeof(fd_vm_shadow_stack_frame_t) ) ) {
+    FD_LOG_WARNING(( "iter %lu: shadow stack differs", iter )); ok = 0;
+  }
+  if( !ok ) FD_LOG_ERR(( "fail" ));
+}
+
+static void
+test_random( fd_rng_t * rng,
+             ulong      iter_cnt ) {
+  ulong run_cnt = 0UL;
+  ulong fault_cnt = 0UL;
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong cnt = gen_program( rng );
+
+    ulong reg[ 11 ];
+    for( ulong i=0UL; i<11UL; i++ ) reg[ i ] = fd_rng_ulong( rng ) >> fd_rng_uint_roll( rng, 64U );
+    reg[  1 ] = FD_VM_MEM_MAP_INPUT_REGION_START;
+    reg[  2 ] = FD_VM_MEM_MAP_HEAP_REGION_START;
+    reg[  9 ] = 0UL;
+    reg[ 10 ] = FD_VM_MEM_MAP_STACK_REGION_START + 0x1000;
+    for( ulong i=0UL; i<INPUT_SZ; i++ ) input_ref[ i ] = input_jit[ i ] = (uchar)fd_rng_uint( rng );
+
+    ulong entry   = fd_rng_uint_roll( rng, 4U ) ? 0UL : fd_rng_ulong_roll( rng, cnt );
+    ulong budget  = fd_rng_uint_roll( rng, 8U ) ? 20000UL : fd_rng_ulong_roll( rng, 64UL );
+    /* Heaps over 32 KiB are charged against the meter but not the
+       previous instruction meter, which can make the interpreter's
+       meter wrap around at the next call.  Stick to the free size. */
+    ulong heap_sz = 32UL*1024UL;
+
+    init_ctx( ctx_ref, input_ref, cnt, entry, budget, heap_sz, reg );
+    init_ctx( ctx_jit, input_jit, cnt, entry, budget, heap_sz, reg );
+
+    if( fd_vm_context_validate( ctx_ref )!=FD_VM_SBPF_VALIDATE_SUCCESS ) continue;
+    run_cnt++;
+
+    fd_vm_jit_prog_t * prog = fd_vm_jit_compile( instrs, cnt );
+    FD_TEST( prog );
+
+    FD_TEST( !fd_vm_interp_instrs( ctx_ref ) );
+    FD_TEST( !fd_vm_jit_exec( prog, ctx_jit ) );
+    check_same( iter );
+    fault_cnt += (ulong)!!ctx_ref->cond_fault;
+
+    fd_vm_jit_delete( prog );
+  }
+  FD_LOG_NOTICE(( "%lu random programs matched (%lu valid, %lu faulted)", iter_cnt, run_cnt, fault_cnt ));
+  FD_TEST( run_cnt>iter_cnt/2UL );
+}
+
+static void
+test_reject( void ) {
+  instrs[ 0 ] = instr( 0x16, 0UL, 0UL, 0L, 0UL ); /* JEQ32_IMM is not implemented by the interpreter */
+  instrs[ 1 ] = instr( 0x95, 0UL, 0UL, 0L, 0UL );
+  FD_TEST( !fd_vm_jit_compile( instrs, 2UL ) );
+  instrs[ 0 ] = instr( 0x05, 0UL, 0UL, 5L, 0UL ); /* Jump out of bounds */
+  FD_TEST( !fd_vm_jit_compile( instrs, 2UL ) );
+  instrs[ 0 ] = instr( 0x18, 0UL, 0UL, 0L, 0UL ); /* Truncated LDQ */
+  FD_TEST( !fd_vm_jit_compile( instrs, 1UL ) );
+  FD_TEST( !fd_vm_jit_compile( instrs, 0UL ) );
+  FD_TEST( !fd_vm_jit_compile( NULL,   2UL ) );
+}
+
+static void
+test_cache( void ) {
+  ulong cnt = 0UL;
+  instrs[ cnt++ ] = instr( 0xb7, 0UL, 0UL, 0L, 42UL );
+  instrs[ cnt++ ] = instr( 0x95, 0UL, 0UL, 0L, 0UL  );
+
+  uchar key[ 32 ];
+  fd_sha256_hash( instrs, cnt*sizeof(fd_sbpf_instr_t), key );
+  fd_vm_jit_prog_t const * prog = fd_vm_jit_cache_query( key, instrs, cnt );
+  FD_TEST( prog );
+  FD_TEST( fd_vm_jit_cache_query( key, instrs, cnt )==prog );
+  fd_vm_jit_cache_release( prog );
+  fd_vm_jit_cache_release( prog );
+
+  /* Disabled by default: the interpreter runs and nothing is compiled */
+
+  fd_vm_jit_cache_clear();
+  FD_TEST( !fd_vm_jit_enabled() );
+  FD_TEST( !fd_vm_jit_prog_cnt() );
+
+  ulong reg[ 11 ] = {0};
+  init_ctx( ctx_jit, input_jit, cnt, 0UL, 100UL, 0UL, reg );
+  FD_TEST( !fd_vm_jit_instrs( ctx_jit, NULL ) );
+  FD_TEST( ctx_jit->register_file[0]==42UL && !ctx_jit->cond_fault && ctx_jit->compute_meter==98UL );
+  FD_TEST( !fd_vm_jit_prog_cnt() );
+
+  fd_vm_jit_enable( 1 );
+  init_ctx( ctx_jit, input_jit, cnt, 0UL, 100UL, 0UL, reg );
+  FD_TEST( !fd_vm_jit_instrs( ctx_jit, NULL ) );
+  FD_TEST( ctx_jit->register_file[0]==42UL && !ctx_jit->cond_fault && ctx_jit->compute_meter==98UL );
+  FD_TEST( fd_vm_jit_prog_cnt()==1UL );
+
+  /* Heap charge */
+  init_ctx( ctx_jit, input_jit, cnt, 0UL, 100UL, HEAP_SZ, reg );
+  init_ctx( ctx_ref, input_ref, cnt, 0UL, 100UL, HEAP_SZ, reg );
+  FD_TEST( !fd_vm_jit_instrs( ctx_jit, key ) );
+  FD_TEST( !fd_vm_interp_instrs( ctx_ref ) );
+  check_same( ULONG_MAX );
+  FD_TEST( ctx_jit->compute_meter<98UL );
+
+  fd_vm_jit_enable( 0 );
+  fd_vm_jit_cache_clear();
+  FD_TEST( !fd_vm_jit_prog_cnt() );
+}
+
+/* Filling the cache evicts the least recently used programs and unmaps
+   them, except while they are still in use. */
+
+static void
+test_cache_evict( void ) {
+  ulong const prog_max = FD_VM_JIT_CACHE_SLOT_CNT/2UL;
+  ulong const cnt      = 2UL;
+  ulong       reg[ 11 ] = {0};
+
+  fd_sbpf_instr_t hot_instrs[ 2 ] = { instr( 0xb7, 0UL, 0UL, 0L, 0x1000000UL ), instr( 0x95, 0UL, 0UL, 0L, 0UL ) };
+  uchar hot_key[ 32 ];
+  fd_sha256_hash( hot_instrs, sizeof(hot_instrs), hot_key );
+  fd_vm_jit_prog_t const * hot = fd_vm_jit_cache_query( hot_key, hot_instrs, cnt );
+  FD_TEST( hot );
+  fd_vm_jit_cache_release( hot );
+
+  /* Hold on to the first program while it gets evicted */
+
+  fd_vm_jit_prog_t const * held = NULL;
+  for( ulong i=0UL; i<2UL*prog_max; i++ ) {
+    instrs[ 0 ] = instr( 0xb7, 0UL, 0UL, 0L, i );
+    instrs[ 1 ] = instr( 0x95, 0UL, 0UL, 0L, 0UL );
+    uchar key[ 32 ];
+    fd_sha256_hash( instrs, cnt*sizeof(fd_sbpf_instr_t), key );
+    fd_vm_jit_prog_t const * prog = fd_vm_jit_cache_query( key, instrs, cnt );
+    FD_TEST( prog );
+    if( !i ) held = prog;
+    else     fd_vm_jit_cache_release( prog );
+
+    /* Keep the hot program recently used */
+    FD_TEST( fd_vm_jit_cache_query( hot_key, hot_instrs, cnt )==hot );
+    fd_vm_jit_cache_release( hot );
+
+    FD_TEST( fd_vm_jit_prog_cnt()<=prog_max+1UL );
+  }
+  FD_TEST( fd_vm_jit_prog_cnt()==prog_max+1UL );
+
+  /* The held program was evicted but still runs */
+
+  instrs[ 0 ] = instr( 0xb7, 0UL, 0UL, 0L, 0UL );
+  init_ctx( ctx_jit, input_jit, cnt, 0UL, 100UL, 0UL, reg );
+  ctx_jit->register_file[0] = 1UL;
+  FD_TEST( !fd_vm_jit_exec( held, ctx_jit ) );
+  FD_TEST( ctx_jit->register_file[0]==0UL && !ctx_jit->cond_fault );
+  fd_vm_jit_cache_release( held );
+  FD_TEST( fd_vm_jit_prog_cnt()==prog_max );
+
+  /* The most recent programs are still cached and are found after the
+     backward shifts done by evictions (a hit compiles nothing) */
+
+  for( ulong i=prog_max+1UL; i<2UL*prog_max; i++ ) {
+    instrs[ 0 ] = instr( 0xb7, 0UL, 0UL, 0L, i );
+    uchar key[ 32 ];
+    fd_sha256_hash( instrs, cnt*sizeof(fd_sbpf_instr_t), key );
+    fd_vm_jit_prog_t const * prog = fd_vm_jit_cache_query( key, instrs, cnt );
+    FD_TEST( prog );
+    fd_vm_jit_cache_release( prog );
+    FD_TEST( fd_vm_jit_prog_cnt()==prog_max );
+  }
+
+  fd_vm_jit_cache_clear();
+  FD_TEST( !fd_vm_jit_prog_cnt() );
+}
+
+static void
+bench( fd_rng_t * rng ) {
+  /* Tight loop of random ALU ops, counted down in r9 */
+  ulong cnt = 0UL;
+  instrs[ cnt++ ] = instr( 0xb7, 9UL, 0UL, 0L, 1000000UL );
+  for( ulong i=0UL; i<30UL; i++ ) {
+    static const uchar op[] = { 0x07, 0x0f, 0x17, 0x1f, 0x27, 0x2f, 0x47, 0x4f, 0x57, 0x5f, 0xa7, 0xaf, 0x67, 0x77, 0xbf };
+    instrs[ cnt++ ] = instr( op[ fd_rng_uint_roll( rng, sizeof(op) ) ], fd_rng_uint_roll( rng, 9U ), fd_rng_uint_roll( rng, 9U ), 0L, fd_rng_uint_roll( rng, 32U ) );
+  }
+  instrs[ cnt ] = instr( 0x17, 9UL, 0UL, 0L, 1UL );   cnt++;
+  instrs[ cnt ] = instr( 0x55, 9UL, 0UL, -32L, 0UL ); cnt++;
+  instrs[ cnt ] = instr( 0x95, 0UL, 0UL, 0L, 0UL );   cnt++;
+
+  fd_vm_jit_prog_t * prog = fd_vm_jit_compile( instrs, cnt );
+  FD_TEST( prog );
+
+  ulong reg[ 11 ] = {0};
+  init_ctx( ctx_ref, input_ref, cnt, 0UL, ULONG_MAX>>1, 0UL, reg );
+  init_ctx( ctx_jit, input_jit, cnt, 0UL, ULONG_MAX>>1, 0UL, reg );
+
+  long dt_ref = -fd_log_wallclock(); fd_vm_interp_instrs( ctx_ref );    dt_ref += fd_log_wallclock();
+  long dt_jit = -fd_log_wallclock(); fd_vm_jit_exec( prog, ctx_jit );   dt_jit += fd_log_wallclock();
+  check_same( ULONG_MAX );
+
+  double ic = (double)ctx_ref->instruction_counter;
+  FD_LOG_NOTICE(( "interp: %.1f Minstr/s", 1e3*ic/(double)dt_ref ));
+  FD_LOG_NOTICE(( "jit:    %.1f Minstr/s", 1e3*ic/(double)dt_jit ));
+
+  fd_vm_jit_delete( prog );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 4096UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  static uchar syscalls_mem[ 1UL<<17 ] __attribute__((aligned(64)));
+  FD_TEST( fd_sbpf_syscalls_footprint()<=sizeof(syscalls_mem) );
+  syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( syscalls_mem ) );
+  accumulator_id = fd_murmur3_32( "accumulator", 11UL, 0U );
+  fd_sbpf_syscalls_t * accumulator = fd_sbpf_syscalls_insert( syscalls, accumulator_id );
+  accumulator->func_ptr = accumulator_syscall;
+  accumulator->name     = "accumulator";
+  FD_TEST( fd_sbpf_syscalls_query( syscalls, accumulator_id, NULL ) );
+
+  static uchar calldests_mem[ 4096 ] __attribute__((aligned(64)));
+  FD_TEST( fd_sbpf_calldests_footprint( INSTR_MAX )<=sizeof(calldests_mem) );
+  calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, INSTR_MAX ) );
+
+  for( ulong i=0UL; i<INPUT_SZ; i++ ) rodata[ i ] = (uchar)i;
+
+  test_reject();
+  test_cache();
+  test_cache_evict();
+  test_random( rng, iter_cnt );
+  bench( rng );
+
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+  fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( syscalls ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_X86 and FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
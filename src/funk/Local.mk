@@ -19,4 +19,6 @@ $(call make-unit-test,test_funk,test_funk,fd_funk fd_util)
 $(call run-unit-test,test_funk)
 ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_funk_concur,test_funk_concur,fd_funk fd_util)
+$(call make-unit-test,test_funk_rec_para,test_funk_rec_para,fd_funk fd_util)
+$(call run-unit-test,test_funk_rec_para)
 endif
\ No newline at end of file
@@ -395,6 +395,133 @@ fd_funk_rec_insert( fd_funk_t *               funk,
   return rec;
 }
 
+#if FD_HAS_ATOMIC
+
+fd_funk_rec_t const *
+fd_funk_rec_insert_para( fd_funk_t *               funk,
+                         fd_funk_txn_t *           txn,
+                         fd_funk_rec_key_t const * key,
+                         int *                     opt_err ) {
+
+  if( FD_UNLIKELY( (!funk) |     /* NULL funk */
+                   (!key ) ) ) { /* NULL key */
+    fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_INVAL );
+    return NULL;
+  }
+  fd_funk_check_write( funk );
+
+  fd_wksp_t * wksp = fd_funk_wksp( funk );
+
+  fd_funk_rec_t * rec_map = fd_funk_rec_map( funk, wksp );
+
+  ulong rec_max = funk->rec_max;
+
+  ulong                  txn_idx;
+  ulong *                _rec_head_idx;
+  ulong *                _rec_tail_idx;
+  fd_funk_xid_key_pair_t pair[1];
+
+  if( !txn ) { /* Modifying last published */
+
+    if( FD_UNLIKELY( fd_funk_last_publish_is_frozen( funk ) ) ) {
+      fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_FROZEN );
+      return NULL;
+    }
+
+    txn_idx       = FD_FUNK_TXN_IDX_NULL;
+    _rec_head_idx = &funk->rec_head_idx;
+    _rec_tail_idx = &funk->rec_tail_idx;
+
+    fd_funk_xid_key_pair_init( pair, fd_funk_root( funk ), key );
+
+  } else { /* Modifying in-prep */
+
+    fd_funk_txn_t * txn_map = fd_funk_txn_map( funk, wksp );
+
+    ulong txn_max = funk->txn_max;
+
+    txn_idx       = (ulong)(txn - txn_map);
+    _rec_head_idx = &txn->rec_head_idx;
+    _rec_tail_idx = &txn->rec_tail_idx;
+
+    if( FD_UNLIKELY( (txn_idx>=txn_max) /* Out of map */ | (txn!=(txn_map+txn_idx)) /* Bad alignment */ ) ) {
+      fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_INVAL );
+      return NULL;
+    }
+
+    if( FD_UNLIKELY( !fd_funk_txn_map_query_const( txn_map, fd_funk_txn_xid( txn ), NULL ) ) ) {
+      fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_INVAL );
+      return NULL;
+    }
+
+    if( FD_UNLIKELY( fd_funk_txn_is_frozen( txn ) ) ) {
+      fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_FROZEN );
+      return NULL;
+    }
+
+    fd_funk_xid_key_pair_init( pair, fd_funk_txn_xid( txn ), key );
+
+  }
+
+  /* Holding the chain lock serializes this against concurrent inserts
+     of the same key (and any other key that hashes to this chain). */
+
+  ulong list_idx = fd_funk_rec_map_list_lock( rec_map, pair );
+
+  fd_funk_rec_t * rec = (fd_funk_rec_t *)fd_funk_rec_map_query_const( rec_map, pair, NULL );
+
+  if( FD_UNLIKELY( rec ) ) { /* Already a record present, see fd_funk_rec_insert about ERASE */
+    rec->flags &= ~FD_FUNK_REC_FLAG_ERASE;
+    fd_funk_rec_map_list_unlock( rec_map, list_idx );
+    fd_int_store_if( !!opt_err, opt_err, FD_FUNK_SUCCESS );
+    return rec;
+  }
+
+  rec = fd_funk_rec_map_insert_locked_prepare( rec_map, pair );
+  if( FD_UNLIKELY( !rec ) ) {
+    fd_funk_rec_map_list_unlock( rec_map, list_idx );
+    fd_int_store_if( !!opt_err, opt_err, FD_FUNK_ERR_REC );
+    return NULL;
+  }
+
+  ulong rec_idx = (ulong)(rec - rec_map);
+  if( FD_UNLIKELY( rec_idx>=rec_max ) ) FD_LOG_CRIT(( "memory corruption detected (bad idx)" ));
+
+  /* Initialize the record before publishing it so that concurrent
+     queries never see a partially initialized record. */
+
+  rec->next_idx = FD_FUNK_REC_IDX_NULL;
+  rec->txn_cidx = fd_funk_txn_cidx( txn_idx );
+  rec->tag      = 0U;
+  rec->flags    = 0UL;
+  fd_funk_val_init( rec );
+  fd_funk_part_init( rec );
+
+  /* Append rec to txn's record list.  Swapping the tail claims our
+     position in the list, linking the predecessor can then be done
+     without further synchronization because nobody else will ever
+     link to it.  Nobody traverses the list until the concurrent
+     inserts are done. */
+
+  ulong rec_prev_idx = FD_ATOMIC_XCHG( _rec_tail_idx, rec_idx );
+  rec->prev_idx = rec_prev_idx;
+  if( fd_funk_rec_idx_is_null( rec_prev_idx ) ) {
+    *_rec_head_idx = rec_idx;
+  } else {
+    if( FD_UNLIKELY( rec_prev_idx>=rec_max ) ) FD_LOG_CRIT(( "memory corruption detected (bad_idx)" ));
+    rec_map[ rec_prev_idx ].next_idx = rec_idx;
+  }
+
+  fd_funk_rec_map_insert_locked_publish( rec_map, rec );
+
+  fd_funk_rec_map_list_unlock( rec_map, list_idx );
+
+  fd_int_store_if( !!opt_err, opt_err, FD_FUNK_SUCCESS );
+  return rec;
+}
+
+#endif /* FD_HAS_ATOMIC */
+
 int
 fd_funk_rec_remove( fd_funk_t *     funk,
                     fd_funk_rec_t * rec,
@@ -399,6 +399,37 @@ fd_funk_rec_insert( fd_funk_t *               funk,
                     fd_funk_rec_key_t const * key,
                     int *                     opt_err );
 
+#if FD_HAS_ATOMIC
+
+/* fd_funk_rec_insert_para is fd_funk_rec_insert that multiple threads
+   can call concurrently (e.g. from tpool workers) within a single
+   fd_funk_start_write / fd_funk_end_write block held by the
+   dispatching thread.  It differs from fd_funk_rec_insert in that, if
+   txn (NULL for the last published transaction) already has a record
+   for key, that record is returned (with its ERASE flag cleared)
+   instead of failing with FD_FUNK_ERR_KEY.  Thus, threads racing to
+   insert the same key all get the same record.
+
+   Synchronization is per record map chain, so inserts of different
+   keys rarely contend.  The order in which concurrently inserted
+   records appear in txn's record list is unspecified.
+
+   Concurrent inserts are safe with each other, with queries (e.g.
+   fd_funk_rec_query / fd_funk_rec_query_global) and with value
+   operations on other records.  A new record is fully initialized
+   (empty value, no flags, no partition) before queries can find it.
+   They are not safe with any other funk operation that modifies the
+   record or transaction maps (e.g. fd_funk_rec_insert,
+   fd_funk_rec_remove, transaction prepare / publish / cancel). */
+
+fd_funk_rec_t const *
+fd_funk_rec_insert_para( fd_funk_t *               funk,
+                         fd_funk_txn_t *           txn,
+                         fd_funk_rec_key_t const * key,
+                         int *                     opt_err );
+
+#endif
+
 /* fd_funk_rec_remove removes the live record pointed to by rec from
    the funk.  Returns FD_FUNK_SUCCESS (0) on success and a FD_FUNK_ERR_*
    (negative) on failure.  Reasons for failure include:
@@ -0,0 +1,153 @@
+#include "fd_funk.h"
+
+#if FD_HAS_HOSTED && FD_HAS_ATOMIC
+
+#include <pthread.h>
+
+#define THREAD_CNT (4UL)
+#define KEY_CNT    (4096UL)
+
+static fd_funk_t *     funk;
+static fd_funk_txn_t * txn;
+
+static fd_funk_rec_t const * recs[ THREAD_CNT ][ KEY_CNT ];
+
+static volatile int go;
+
+static fd_funk_rec_key_t *
+test_key( fd_funk_rec_key_t * key,
+          ulong               i ) {
+  fd_memset( key, 0, sizeof(fd_funk_rec_key_t) );
+  key->ul[0] = i;
+  return key;
+}
+
+static void *
+insert_thread( void * arg ) {
+  ulong t = (ulong)arg;
+
+  while( !go ) FD_SPIN_PAUSE();
+
+  /* Every thread inserts every key, each in a different order */
+
+  ulong stride = 2UL*t + 1UL; /* Odd, so coprime with KEY_CNT */
+  fd_funk_rec_key_t key[1];
+  for( ulong j=0UL; j<KEY_CNT; j++ ) {
+    ulong i = (j*stride + t) & (KEY_CNT-1UL);
+    int err;
+    fd_funk_rec_t const * rec = fd_funk_rec_insert_para( funk, txn, test_key( key, i ), &err );
+    FD_TEST( rec && !err );
+    FD_TEST( fd_funk_rec_key_eq( fd_funk_rec_key( rec ), key ) );
+    FD_TEST( fd_funk_rec_query( funk, txn, key )==rec );
+    recs[ t ][ i ] = rec;
+
+    /* Another thread may be inserting the key we insert next.  If it
+       is already visible, it must be fully initialized. */
+
+    fd_funk_rec_t const * peek = fd_funk_rec_query( funk, txn, test_key( key, (i+stride) & (KEY_CNT-1UL) ) );
+    if( peek ) {
+      FD_TEST( fd_funk_rec_key_eq( fd_funk_rec_key( peek ), key ) );
+      FD_TEST( fd_funk_txn_idx( peek->txn_cidx )==(ulong)(txn - fd_funk_txn_map( funk, fd_funk_wksp( funk ) )) );
+      FD_TEST( !fd_funk_val_sz( peek ) && !(peek->flags & FD_FUNK_REC_FLAG_ERASE) );
+    }
+  }
+
+  return NULL;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL,      "gigantic" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL,             1UL );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+  ulong        wksp_tag = fd_env_strip_cmdline_ulong( &argc, &argv, "--wksp-tag", NULL,          1234UL );
+  ulong        seed     = fd_env_strip_cmdline_ulong( &argc, &argv, "--seed",     NULL,          5678UL );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * shmem = fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), wksp_tag );
+  FD_TEST( shmem );
+
+  funk = fd_funk_join( fd_funk_new( shmem, wksp_tag, seed, 4UL, KEY_CNT+1UL ) );
+  FD_TEST( funk );
+
+  fd_funk_start_write( funk );
+
+  fd_funk_txn_xid_t xid[1] = {{ .ul = { 1UL, 2UL, 3UL, 4UL } }};
+  txn = fd_funk_txn_prepare( funk, NULL, xid, 0 );
+  FD_TEST( txn );
+
+  /* Bad inputs */
+
+  fd_funk_rec_key_t key[1]; test_key( key, 0UL );
+  int err;
+  FD_TEST( !fd_funk_rec_insert_para( NULL, txn,  key,  &err ) && err==FD_FUNK_ERR_INVAL  );
+  FD_TEST( !fd_funk_rec_insert_para( funk, txn,  NULL, &err ) && err==FD_FUNK_ERR_INVAL  );
+  FD_TEST( !fd_funk_rec_insert_para( funk, NULL, key,  &err ) && err==FD_FUNK_ERR_FROZEN ); /* last published has a child */
+
+  /* Concurrent inserts of overlapping keys */
+
+  pthread_t thr[ THREAD_CNT ];
+  for( ulong t=0UL; t<THREAD_CNT; t++ ) FD_TEST( !pthread_create( &thr[t], NULL, insert_thread, (void *)t ) );
+  go = 1;
+  for( ulong t=0UL; t<THREAD_CNT; t++ ) FD_TEST( !pthread_join( thr[t], NULL ) );
+
+  for( ulong i=0UL; i<KEY_CNT; i++ )
+    for( ulong t=1UL; t<THREAD_CNT; t++ ) FD_TEST( recs[ t ][ i ]==recs[ 0 ][ i ] );
+
+  fd_funk_rec_t * rec_map = fd_funk_rec_map( funk, wksp );
+  FD_TEST( fd_funk_rec_map_key_cnt( rec_map )==KEY_CNT );
+
+  ulong cnt = 0UL;
+  for( fd_funk_rec_t const * rec = fd_funk_txn_first_rec( funk, txn ); rec; rec = fd_funk_txn_next_rec( funk, rec ) ) cnt++;
+  FD_TEST( cnt==KEY_CNT );
+
+  FD_TEST( !fd_funk_verify( funk ) );
+
+  /* Map is full */
+
+  FD_TEST( fd_funk_rec_insert_para( funk, txn, test_key( key, KEY_CNT ), &err ) && !err );
+  FD_TEST( !fd_funk_rec_insert_para( funk, txn, test_key( key, KEY_CNT+1UL ), &err ) && err==FD_FUNK_ERR_REC );
+
+  /* Records inserted this way publish like any other */
+
+  FD_TEST( fd_funk_txn_publish( funk, txn, 0 )==1UL );
+  FD_TEST( fd_funk_rec_map_key_cnt( rec_map )==KEY_CNT+1UL );
+  FD_TEST( !fd_funk_verify( funk ) );
+
+  /* Inserting into the last published transaction */
+
+  FD_TEST( fd_funk_rec_remove( funk, fd_funk_rec_modify( funk, fd_funk_rec_query( funk, NULL, test_key( key, KEY_CNT ) ) ), 1 )==FD_FUNK_SUCCESS );
+  fd_funk_rec_t const * rec = fd_funk_rec_insert_para( funk, NULL, key, &err );
+  FD_TEST( rec && !err && fd_funk_rec_query( funk, NULL, key )==rec );
+  FD_TEST( fd_funk_rec_insert_para( funk, NULL, test_key( key, 0UL ), &err )==fd_funk_rec_query( funk, NULL, key ) && !err );
+  FD_TEST( fd_funk_rec_map_key_cnt( rec_map )==KEY_CNT+1UL );
+  FD_TEST( !fd_funk_verify( funk ) );
+
+  fd_funk_end_write( funk );
+
+  FD_TEST( fd_funk_delete( fd_funk_leave( funk ) )==shmem );
+  fd_wksp_free_laddr( shmem );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_ATOMIC capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
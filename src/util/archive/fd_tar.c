@@ -181,3 +181,42 @@ fd_tar_set_octal( char  buf[ static 12 ],
   }
   return val==0UL;
 }
+
+fd_tar_meta_t *
+fd_tar_meta_init_file( fd_tar_meta_t * meta,
+                       char const *    name,
+                       ulong           sz,
+                       ulong           mtime ) {
+
+  fd_memset( meta, 0, sizeof(fd_tar_meta_t) );
+
+  ulong name_len = strlen( name );
+  if( FD_UNLIKELY( name_len>=FD_TAR_NAME_SZ ) ) return NULL;
+  fd_memcpy( meta->name, name, name_len );
+
+  fd_memcpy( meta->mode, "0000644", 8UL );
+  fd_memcpy( meta->uid,  "0000000", 8UL );
+  fd_memcpy( meta->gid,  "0000000", 8UL );
+  if( FD_UNLIKELY( !fd_tar_meta_set_size ( meta, sz    ) ) ) return NULL;
+  if( FD_UNLIKELY( !fd_tar_meta_set_mtime( meta, mtime ) ) ) return NULL;
+  meta->typeflag = FD_TAR_TYPE_REGULAR;
+  fd_memcpy( meta->magic,   FD_TAR_MAGIC, 6UL );  /* incl NUL */
+  fd_memcpy( meta->version, "00",         2UL );
+
+  /* The checksum is the sum of all header bytes, with the checksum
+     field itself taken as spaces.  Stored as 6 octal digits, NUL and
+     space. */
+
+  fd_memset( meta->chksum, ' ', sizeof(meta->chksum) );
+  uchar const * b = (uchar const *)meta;
+  ulong chksum = 0UL;
+  for( ulong i=0UL; i<sizeof(fd_tar_meta_t); i++ ) chksum += b[ i ];
+  for( int i=5; i>=0; i-- ) {
+    meta->chksum[ i ] = (char)( '0' + (char)( chksum&7UL ) );
+    chksum>>=3;
+  }
+  meta->chksum[ 6 ] = '\0';
+  meta->chksum[ 7 ] = ' ';
+
+  return meta;
+}
@@ -91,6 +91,19 @@ fd_tar_meta_set_mtime( fd_tar_meta_t * meta,
   return fd_tar_set_octal( meta->mtime, mtime );
 }
 
+/* fd_tar_meta_init_file initializes meta as the POSIX ustar header of
+   a regular file at path name (a cstr) with sz bytes of content and the
+   given modification time (in seconds since the UNIX epoch), including
+   the header checksum.  Returns meta on success.  Returns NULL if name
+   does not fit FD_TAR_NAME_SZ-1 chars or sz/mtime cannot be
+   represented. */
+
+fd_tar_meta_t *
+fd_tar_meta_init_file( fd_tar_meta_t * meta,
+                       char const *    name,
+                       ulong           sz,
+                       ulong           mtime );
+
 FD_PROTOTYPES_END
 
 /* Streaming reader ***************************************************/
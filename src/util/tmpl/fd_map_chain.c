@@ -165,7 +165,22 @@
                             ulong           sentinel, // Value to return on failure
                             myele_t const * pool );   // Current local join to element storage
 
-     // The mymap_ele_{insert,remove,query,query_const} variants are the
+     // mymap_idx_query_safe is the same as mymap_idx_query_const but
+     // can run concurrently with insert/remove operations.  The chain
+     // walk never leaves element storage indexed [0,ele_max) and gives
+     // up after ele_max steps, so a query racing a writer will neither
+     // crash nor spin forever.  The result may be wrong in that case
+     // and it is up to the application to validate it (e.g. with a
+     // sequence lock).
+
+     ulong                                           // Index of found element on success, sentinel on failure
+     mymap_idx_query_safe( mymap_t const * join,     // Current local join to element map
+                           ulong const *   key,      // Points to the key to find in the caller's address space
+                           ulong           sentinel, // Value to return on failure
+                           myele_t const * pool,     // Current local join to element storage
+                           ulong           ele_max );// Element storage size
+
+     // The mymap_ele_{insert,remove,query,query_const,query_safe} variants are the
      // same as the above but use pointers in the caller's address
      // instead of pool element storage indices.
 
@@ -192,6 +207,13 @@
                             myele_t const * sentinel, // Value to return if key not in map
                             myele_t const * pool );   // Current local join to element storage
 
+     myele_t const *                                 // Found element on success (will be from pool), sentinel on failure
+     mymap_ele_query_safe( mymap_t const * join,     // Current local join to element map
+                           ulong const *   key,      // Points to the key to find in the caller's address space
+                           myele_t const * sentinel, // Value to return if key not in map
+                           myele_t const * pool,     // Current local join to element storage
+                           ulong           ele_max );// Element storage size
+
      // mymap_iter_* support fast iteration over all the elements in a
      // map.  The iteration will be in a random order but the order will
      // be identical if repeated with no insert/remove/query operations
@@ -586,6 +608,13 @@ MAP_(idx_query_const)( MAP_(t) const *   join,
                        ulong             sentinel,
                        MAP_ELE_T const * pool );
 
+FD_FN_PURE ulong
+MAP_(idx_query_safe)( MAP_(t) const *   join,
+                      MAP_KEY_T const * key,
+                      ulong             sentinel,
+                      MAP_ELE_T const * pool,
+                      ulong             ele_max );
+
 #if MAP_MULTI!=0
 
 FD_FN_PURE ulong
@@ -811,6 +840,30 @@ MAP_(idx_query_const)( MAP_(t) const *   join,
   return sentinel;
 }
 
+FD_FN_PURE MAP_IMPL_STATIC ulong
+MAP_(idx_query_safe)( MAP_(t) const *   join,
+                      MAP_KEY_T const * key,
+                      ulong             sentinel,
+                      MAP_ELE_T const * pool,
+                      ulong             ele_max ) {
+  MAP_(private_t) const * map = MAP_(private_const)( join );
+
+  /* Find the key.  The chain may be modified under us, so bound the
+     walk and never follow an index outside the element storage. */
+
+  MAP_IDX_T const * cur = MAP_(private_chain_const)( map ) + MAP_(private_chain_idx)( key, map->seed, map->chain_cnt );
+  for( ulong i=0UL; i<ele_max; i++ ) {
+    ulong ele_idx = MAP_(private_unbox)( FD_VOLATILE_CONST( *cur ) );
+    if( FD_UNLIKELY( MAP_(private_idx_is_null)( ele_idx ) || ele_idx>=ele_max ) ) break; /* optimize for found */
+    if( FD_LIKELY( MAP_(key_eq)( key, &pool[ ele_idx ].MAP_KEY ) ) ) return ele_idx; /* optimize for found */
+    cur = &pool[ ele_idx ].MAP_NEXT;
+  }
+
+  /* Not found */
+
+  return sentinel;
+}
+
 #if MAP_MULTI!=0
 
 FD_FN_PURE MAP_IMPL_STATIC ulong
@@ -948,6 +1001,16 @@ MAP_(ele_query_const)( MAP_(t) const *   join,
   return fd_ptr_if( !MAP_(private_idx_is_null)( ele_idx ), (MAP_ELE_T const *)( (ulong)pool + (ele_idx * sizeof(MAP_ELE_T)) ), sentinel );
 }
 
+FD_FN_PURE static inline MAP_ELE_T const *
+MAP_(ele_query_safe)( MAP_(t) const *   join,
+                      MAP_KEY_T const * key,
+                      MAP_ELE_T const * sentinel,
+                      MAP_ELE_T const * pool,
+                      ulong             ele_max ) {
+  ulong ele_idx = MAP_(idx_query_safe)( join, key, MAP_(private_idx_null)(), pool, ele_max );
+  return fd_ptr_if( !MAP_(private_idx_is_null)( ele_idx ), (MAP_ELE_T const *)( (ulong)pool + (ele_idx * sizeof(MAP_ELE_T)) ), sentinel );
+}
+
 #if MAP_MULTI!=0
 
 FD_FN_PURE static inline MAP_ELE_T const *        // Found element on success (will be from pool), sentinel on failure
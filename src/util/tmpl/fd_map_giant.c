@@ -159,6 +159,35 @@
 
     mymap_t const * mymap_query_safe( mymap_t const * join, ulong const * key, mymap_t const * sentinel );
 
+    // mymap_list_lock acquires the lock on the list that holds (or would
+    // hold) the key pointed to by key and returns the list's index.
+    // Blocks while another thread holds the lock.  mymap_list_unlock
+    // releases the lock on the list list_idx (as returned by
+    // mymap_list_lock).
+    //
+    // mymap_insert_locked_prepare and mymap_insert_locked_publish
+    // split mymap_insert for a caller that holds the lock on key's
+    // list.  As such, inserts of keys in different lists can proceed
+    // concurrently and concurrent inserts of the same key are
+    // serialized (callers should query_const with the lock held to
+    // detect a duplicate).  prepare allocates an element and maps it to
+    // key but does not make it visible yet (unlike mymap_insert, it
+    // returns NULL if the map is full).  The caller then initializes
+    // the rest of the element and publishes it, at which point
+    // concurrent query_const can find it.  A prepared element must be
+    // published before the list is unlocked.
+    //
+    // These can run concurrently with each other and with
+    // mymap_query_const but assume there are no concurrent
+    // remove/query/query2/push_free_ele operations (which modify lists
+    // or the free stack without locks).  Only available on targets with
+    // FD_HAS_ATOMIC.
+
+    ulong     mymap_list_lock            ( mymap_t * join, ulong const * key );
+    void      mymap_list_unlock          ( mymap_t * join, ulong list_idx    );
+    mymap_t * mymap_insert_locked_prepare( mymap_t * join, ulong const * key );
+    void      mymap_insert_locked_publish( mymap_t * join, mymap_t * ele     );
+
     // mymap_iter_* allow for iteration over all the keys inserted into
     // a mymap.  The iteration will be in a random order but the order
     // will be identical if repeated with no insert/remove/query
@@ -547,6 +576,26 @@ MAP_T *
 MAP_(push_free_ele)( MAP_T * join,
                      MAP_T * ele );
 
+#if FD_HAS_ATOMIC
+
+ulong
+MAP_(list_lock)( MAP_T *           join,
+                 MAP_KEY_T const * key );
+
+void
+MAP_(list_unlock)( MAP_T * join,
+                   ulong   list_idx );
+
+MAP_T *
+MAP_(insert_locked_prepare)( MAP_T *           join,
+                             MAP_KEY_T const * key );
+
+void
+MAP_(insert_locked_publish)( MAP_T * join,
+                             MAP_T * ele );
+
+#endif
+
 FD_PROTOTYPES_END
 
 #else /* need implementations */
@@ -806,6 +855,94 @@ MAP_(insert_free_ele)( MAP_T *           join,
   return ele;
 }
 
+#if FD_HAS_ATOMIC
+
+/* The lock on a list is bit 63 (the tag bit) of its head.  The tag of
+   a list head is otherwise always clear and readers ignore it when
+   unboxing the head idx. */
+
+MAP_IMPL_STATIC ulong
+MAP_(list_lock)( MAP_T *           join,
+                 MAP_KEY_T const * key ) {
+  MAP_(private_t) * map = MAP_(private)( join );
+
+  ulong   list_idx = MAP_(private_list_idx)( key, map->seed, map->list_cnt );
+  ulong * head     = MAP_(private_list)( map ) + list_idx;
+
+  for(;;) {
+    ulong cur = FD_VOLATILE_CONST( *head );
+    if( FD_LIKELY( !MAP_(private_unbox_tag)( cur ) ) &&
+        FD_LIKELY( FD_ATOMIC_CAS( head, cur, cur | (1UL<<63) )==cur ) ) break;
+    FD_SPIN_PAUSE();
+  }
+
+  FD_COMPILER_MFENCE();
+  return list_idx;
+}
+
+MAP_IMPL_STATIC void
+MAP_(list_unlock)( MAP_T * join,
+                   ulong   list_idx ) {
+  MAP_(private_t) * map = MAP_(private)( join );
+
+  ulong * head = MAP_(private_list)( map ) + list_idx;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *head ) = MAP_(private_box_next)( MAP_(private_unbox_idx)( *head ), 0 );
+  FD_COMPILER_MFENCE();
+}
+
+MAP_IMPL_STATIC MAP_T *
+MAP_(insert_locked_prepare)( MAP_T *           join,
+                             MAP_KEY_T const * key ) {
+  MAP_(private_t) * map = MAP_(private)( join );
+
+  /* Pop the free stack to allocate an element.  Only pops can run
+     concurrently with this (per contract), so an element cannot return
+     to the top of the stack once popped and there is no ABA hazard. */
+
+  ulong   ele_idx;
+  MAP_T * ele;
+  for(;;) {
+    ulong top = FD_VOLATILE_CONST( map->free_stack );
+    ele_idx = MAP_(private_unbox_idx)( top );
+    if( FD_UNLIKELY( MAP_(private_is_null)( ele_idx ) ) ) return NULL; /* Full */
+    ele = join + ele_idx;
+    if( FD_LIKELY( FD_ATOMIC_CAS( &map->free_stack, top, FD_VOLATILE_CONST( ele->MAP_NEXT ) )==top ) ) break;
+    FD_SPIN_PAUSE();
+  }
+  FD_ATOMIC_FETCH_AND_ADD( &map->key_cnt, 1UL );
+
+  /* Map the element to key.  It is not on any list yet so nobody else
+     can see it. */
+
+  MAP_(key_copy)( &ele->MAP_KEY, key );
+#if MAP_MEMOIZE
+  ele->MAP_HASH = MAP_KEY_HASH( (key), (map->seed) );
+#endif
+
+  return ele;
+}
+
+MAP_IMPL_STATIC void
+MAP_(insert_locked_publish)( MAP_T * join,
+                             MAP_T * ele ) {
+  MAP_(private_t) * map = MAP_(private)( join );
+
+  /* Push the element onto its (locked) list.  Everything the caller
+     wrote to the element becomes visible to concurrent query_const no
+     later than the element itself.  The lock bit stays set. */
+
+  ulong   ele_idx = (ulong)(ele - join);
+  ulong * head    = MAP_(private_list)( map ) + MAP_(private_list_idx)( &ele->MAP_KEY, map->seed, map->list_cnt );
+  ele->MAP_NEXT = MAP_(private_box_next)( MAP_(private_unbox_idx)( *head ), 0 );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( *head ) = MAP_(private_box_next)( ele_idx, 1 );
+  FD_COMPILER_MFENCE();
+}
+
+#endif /* FD_HAS_ATOMIC */
+
 MAP_IMPL_STATIC MAP_T *
 MAP_(remove)( MAP_T *           join,
               MAP_KEY_T const * key ) {
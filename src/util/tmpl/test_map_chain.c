@@ -180,10 +180,12 @@ main( int     argc,
       for( ulong j=0UL; j<i; j++ ) {
         pair_t const * p = map_ele_query_const( map, &tst[j].mykey, NULL, pool );
         FD_TEST( p && p->val==tst[j].val );
+        FD_TEST( map_ele_query_safe( map, &tst[j].mykey, NULL, pool, pool_max )==p );
       }
 
       /* Make sure ki isn't already in the map */
       FD_TEST( map_ele_query_const( map, &ki, (pair_t *)1UL, pool )==(pair_t *)1UL );
+      FD_TEST( map_ele_query_safe ( map, &ki, (pair_t *)1UL, pool, pool_max )==(pair_t *)1UL );
 
       /* Insert the value */
       pair_t * p = pool_ele_acquire( pool );
@@ -296,10 +296,27 @@ fd_quic_gen_keys(
   }
   keys->iv_sz = iv_sz;
 
+  fd_quic_crypto_keys_expand( keys );
+
   return FD_QUIC_SUCCESS;
 }
 
 
+void
+fd_quic_crypto_keys_expand( fd_quic_crypto_keys_t * keys ) {
+  /* TODO this is hardcoded to AES-128 */
+  static uchar const zero_iv[ 12 ] = {0};
+  if( keys->pkt_key_sz ) fd_aes_128_gcm_init( &keys->pkt_cipher, keys->pkt_key, zero_iv );
+  if( keys->hp_key_sz  ) fd_aes_set_encrypt_key( keys->hp_key, 128, &keys->hp_cipher );
+}
+
+
+void
+fd_quic_crypto_keys_clear( fd_quic_crypto_keys_t * keys ) {
+  fd_memset_explicit( keys, 0, sizeof(fd_quic_crypto_keys_t) );
+}
+
+
 /* generates packet key and iv key
    used by key update
 
@@ -343,6 +360,8 @@ fd_quic_gen_new_keys(
   }
   keys->iv_sz = iv_sz;
 
+  fd_quic_crypto_keys_expand( keys );
+
   return FD_QUIC_SUCCESS;
 }
 
@@ -432,8 +451,8 @@ fd_quic_crypto_encrypt(
   // Initial packets cipher uses AEAD_AES_128_GCM with keys derived from the Destination Connection ID field of the
   // first Initial packet sent by the client; see rfc9001 Section 5.2.
 
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, pkt_keys->pkt_key, nonce );
+  fd_aes_gcm_t pkt_cipher[1] = { pkt_keys->pkt_cipher };
+  fd_aes_gcm_setiv( pkt_cipher, nonce );
 
   /* cipher_text is start of encrypted packet bytes, which starts after the header */
   uchar * cipher_text = out + hdr_sz;
@@ -441,6 +460,7 @@ fd_quic_crypto_encrypt(
   uchar * pkt_end     = tag + FD_QUIC_CRYPTO_TAG_SZ;
 
   fd_aes_gcm_aead_encrypt( pkt_cipher, cipher_text, pkt, pkt_sz, hdr, hdr_sz, tag );
+  fd_memset_explicit( pkt_cipher, 0, sizeof(fd_aes_gcm_t) );
 
   *out_sz = (ulong)( pkt_end - out );
 
@@ -450,10 +470,8 @@ fd_quic_crypto_encrypt(
      so shorter packet numbers means sample starts later in the cipher text */
   uchar const * sample = pkt_number + 4;
 
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( hp_keys->hp_key, 128, ecb );
   uchar hp_cipher[16];
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, &hp_keys->hp_cipher );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -524,8 +542,8 @@ fd_quic_crypto_decrypt(
   uchar * const gcm_tag = buf_end - FD_QUIC_CRYPTO_TAG_SZ;
   ulong   const gcm_sz  = (ulong)( gcm_tag - out );
 
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, keys->pkt_key, nonce );
+  fd_aes_gcm_t pkt_cipher[1] = { keys->pkt_cipher };
+  fd_aes_gcm_setiv( pkt_cipher, nonce );
 
   int decrypt_ok =
    fd_aes_gcm_aead_decrypt( pkt_cipher,
@@ -533,6 +551,7 @@ fd_quic_crypto_decrypt(
                             gcm_sz,      /* size of plaintext */
                             hdr, hdr_sz, /* associated data */
                             gcm_tag      /* auth tag */ );
+  fd_memset_explicit( pkt_cipher, 0, sizeof(fd_aes_gcm_t) );
   if( FD_UNLIKELY( !decrypt_ok ) ) {
    FD_DEBUG( FD_LOG_WARNING(( "fd_aes_gcm_aead_decrypt failed" )) );
    return FD_QUIC_FAILED;
@@ -570,11 +589,8 @@ fd_quic_crypto_decrypt_hdr(
 
   uchar * sample = buf + sample_off;
 
-  /* TODO this is hardcoded to AES-128 */
   uchar hp_cipher[16];
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( keys->hp_key, 128, ecb );
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, &keys->hp_cipher );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -598,12 +614,38 @@ int
 fd_quic_crypto_lookup_suite( uchar major,
                              uchar minor );
 
+/* getrandom(2) is a syscall, which costs far more than anything else
+   done per Initial packet.  A server under a handshake flood needs
+   fresh bytes at least once per Initial (new conn ID) and again for
+   each Retry token, so the bytes are fetched in bulk into a per-thread
+   buffer and handed out from there.  Bytes are never handed out
+   twice.  256 bytes is the largest request getrandom(2) guarantees
+   not to short-read on. */
+
+#define FD_QUIC_CRYPTO_RAND_BUF_SZ (256UL)
+
+static FD_TL uchar fd_quic_crypto_rand_buf[ FD_QUIC_CRYPTO_RAND_BUF_SZ ];
+static FD_TL ulong fd_quic_crypto_rand_off = FD_QUIC_CRYPTO_RAND_BUF_SZ;
+
 int
 fd_quic_crypto_rand( uchar * buf,
                      ulong   buf_sz ) {
-  /* TODO buffer */
-  if( FD_UNLIKELY( (long)buf_sz!=getrandom( buf, buf_sz, 0 ) ) )
-    return FD_QUIC_FAILED;
+  if( FD_UNLIKELY( buf_sz>FD_QUIC_CRYPTO_RAND_BUF_SZ ) ) {
+    if( FD_UNLIKELY( (long)buf_sz!=getrandom( buf, buf_sz, 0 ) ) )
+      return FD_QUIC_FAILED;
+    return FD_QUIC_SUCCESS;
+  }
+
+  if( FD_UNLIKELY( buf_sz > FD_QUIC_CRYPTO_RAND_BUF_SZ-fd_quic_crypto_rand_off ) ) {
+    if( FD_UNLIKELY( (long)FD_QUIC_CRYPTO_RAND_BUF_SZ!=getrandom( fd_quic_crypto_rand_buf, FD_QUIC_CRYPTO_RAND_BUF_SZ, 0 ) ) )
+      return FD_QUIC_FAILED;
+    fd_quic_crypto_rand_off = 0UL;
+  }
+
+  uchar * src = fd_quic_crypto_rand_buf + fd_quic_crypto_rand_off;
+  fd_memcpy( buf, src, buf_sz );
+  fd_memset( src, 0, buf_sz );
+  fd_quic_crypto_rand_off += buf_sz;
   return FD_QUIC_SUCCESS;
 }
 
@@ -4,6 +4,7 @@
 #include "../fd_quic_common.h"
 #include "../fd_quic_conn_id.h"
 #include "../../../ballet/hmac/fd_hmac.h"
+#include "../../../ballet/aes/fd_aes_gcm.h"
 
 /* Defines the crypto suites used by QUIC v1.
 
@@ -82,6 +83,14 @@ struct fd_quic_crypto_keys {
   /* header protection */
   uchar hp_key[FD_QUIC_KEY_MAX_SZ];
   ulong hp_key_sz;
+
+  /* expanded cipher state for pkt_key and hp_key, populated by
+     fd_quic_crypto_keys_expand.  Expanding the AES key schedules and
+     the GHASH tables costs more than protecting a small packet, so it
+     is done once per key rather than once per packet.  pkt_cipher is
+     used as a template, the IV is set per packet. */
+  fd_aes_gcm_t pkt_cipher;
+  fd_aes_key_t hp_cipher;
 };
 
 /* crypto context */
@@ -203,7 +212,8 @@ struct fd_quic_crypto_secrets {
 /* fd_quic_crypto_rand retrieves cryptographic quality random bytes
    into given memory region.  buf points to first byte of buffer in
    local address space.  buf_sz is the number of bytes to fill.  Current
-   backend is getrandom(2) (>=256-bit security level on Linux).
+   backend is getrandom(2) (>=256-bit security level on Linux), read in
+   bulk into a thread-local buffer to amortize the syscall.
    Return value in FD_QUIC_{SUCCESS,FAILURE}.  Reasons for failure
    include lack of entropy, in which case caller should wait and retry.
    buf_sz in [1,INT_MAX] but should be reasonably small (max KiB-ish) */
@@ -349,6 +359,22 @@ fd_quic_gen_keys(
     ulong                    secret_sz );
 
 
+/* fd_quic_crypto_keys_expand populates the expanded cipher state in
+   keys from keys->pkt_key and keys->hp_key.  Keys with a zero size are
+   skipped.  Must be called whenever pkt_key or hp_key change.
+   fd_quic_gen_keys and fd_quic_gen_new_keys do this automatically. */
+void
+fd_quic_crypto_keys_expand( fd_quic_crypto_keys_t * keys );
+
+
+/* fd_quic_crypto_keys_clear scrubs all key material in keys, including
+   the expanded cipher state (whose first round key is the raw key and
+   which holds the GHASH key).  Must be called whenever a set of keys is
+   discarded.  The scrub is not elided by the optimizer. */
+void
+fd_quic_crypto_keys_clear( fd_quic_crypto_keys_t * keys );
+
+
 /* generates packet key and iv key
    used by key update
 
@@ -27,12 +27,6 @@
 #define CONN_ID(CONN_ID) (CONN_ID)->conn_id[0], (CONN_ID)->conn_id[1], (CONN_ID)->conn_id[2], (CONN_ID)->conn_id[3],  \
                          (CONN_ID)->conn_id[4], (CONN_ID)->conn_id[5], (CONN_ID)->conn_id[6], (CONN_ID)->conn_id[7]
 
-/* Declare priority queue for time based processing */
-#define PRQ_NAME      service_queue
-#define PRQ_T         fd_quic_event_t
-#define PRQ_TIMEOUT_T ulong
-#include "../../util/tmpl/fd_prq.c"
-
 /* Declare map type for stream_id -> stream* */
 #define MAP_NAME              fd_quic_stream_map
 #define MAP_KEY               stream_id
@@ -72,7 +66,6 @@ struct fd_quic_layout {
   ulong conns_off;       /* offset of connection mem region  */
   ulong conn_footprint;  /* sizeof a conn                    */
   ulong conn_map_off;    /* offset of conn map mem region    */
-  ulong event_queue_off; /* offset of event queue mem region */
   int   lg_slot_cnt;     /* see conn_map_new                 */
   ulong tls_off;         /* offset of fd_quic_tls_t          */
   ulong stream_pool_off; /* offset of the stream pool        */
@@ -135,17 +128,10 @@ fd_quic_footprint_ext( fd_quic_limits_t const * limits,
   if( FD_UNLIKELY( !conn_map_footprint ) ) { FD_LOG_WARNING(( "invalid fd_quic_conn_map_footprint" )); return 0UL; }
   offs                    += conn_map_footprint;
 
-  /* allocate space for events priority queue */
-  offs                        = fd_ulong_align_up( offs, service_queue_align() );
-  layout->event_queue_off     = offs;
-  ulong event_queue_footprint = service_queue_footprint( conn_cnt + 1 );
-  if( FD_UNLIKELY( !event_queue_footprint ) ) { FD_LOG_WARNING(( "invalid service_queue_footprint" )); return 0UL; }
-  offs                       += event_queue_footprint;
-
   /* allocate space for fd_quic_tls_t */
   offs                 = fd_ulong_align_up( offs, fd_quic_tls_align() );
   layout->tls_off      = offs;
-  ulong tls_footprint  = fd_quic_tls_footprint( limits->handshake_cnt );
+  ulong tls_footprint  = fd_quic_tls_footprint( limits->handshake_cnt, !!limits->hs_service_max );
   if( FD_UNLIKELY( !tls_footprint ) ) { FD_LOG_WARNING(( "invalid fd_quic_tls_footprint" )); return 0UL; }
   offs                += tls_footprint;
 
@@ -445,15 +431,14 @@ fd_quic_init( fd_quic_t * quic ) {
     return NULL;
   }
 
-  /* State: Initialize service queue */
+  /* State: Initialize service wheel (slots already cleared above).
+     Pick the smallest tick such that the wheel spans at least two
+     service intervals. */
 
-  ulong  service_queue_laddr = (ulong)quic + layout.event_queue_off;
-  void * v_service_queue = service_queue_new( (void *)service_queue_laddr, limits->conn_cnt+1U );
-  state->service_queue = service_queue_join( v_service_queue );
-  if( FD_UNLIKELY( !state->service_queue ) ) {
-    FD_LOG_WARNING(( "NULL service_queue" ));
-    return NULL;
-  }
+  ulong service_interval = fd_quic_get_service_interval( quic );
+  int   svc_tick_lg      = 0;
+  while( ( (FD_QUIC_SVC_SLOT_CNT/2UL)<<svc_tick_lg ) < service_interval ) svc_tick_lg++;
+  state->svc_tick_lg = svc_tick_lg;
 
   /* Check TX AIO */
 
@@ -466,6 +451,7 @@ fd_quic_init( fd_quic_t * quic ) {
 
   fd_quic_tls_cfg_t tls_cfg = {
     .max_concur_handshakes = limits->handshake_cnt,
+    .rx_defer              = !!limits->hs_service_max,
 
     /* set up callbacks */
     .alert_cb              = fd_quic_tls_cb_alert,
@@ -500,6 +486,7 @@ fd_quic_init( fd_quic_t * quic ) {
   ulong cs_tree_laddr = (ulong)quic + layout.cs_tree_off;
   state->cs_tree = (fd_quic_cs_tree_t*)cs_tree_laddr;
   fd_quic_cs_tree_init( state->cs_tree, ( limits->conn_cnt << 1UL ) + 1UL );
+  state->assign_cursor = 0UL;
 
   fd_rng_new( state->_rng, 0UL, 0UL );
 
@@ -816,10 +803,11 @@ fd_quic_fini( fd_quic_t * quic ) {
 
   fd_quic_tls_delete( state->tls ); state->tls = NULL;
 
-  /* Delete service queue */
+  /* Reset service wheel */
 
-  service_queue_delete( service_queue_leave( state->service_queue ) );
-  state->service_queue = NULL;
+  memset( state->svc_slot, 0, sizeof(state->svc_slot) );
+  memset( state->svc_used, 0, sizeof(state->svc_used) );
+  state->svc_cnt = 0UL;
 
   /* Delete conn ID map */
 
@@ -1367,14 +1355,6 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
         return FD_QUIC_PARSE_FAIL;
       }
 
-      /* Early check: Is conn free? */
-
-      if( FD_UNLIKELY( !state->conns ) ) {
-        FD_DEBUG( FD_LOG_DEBUG(( "ignoring conn request: no free conn slots" )) );
-        quic->metrics.conn_err_no_slots_cnt++;
-        return FD_QUIC_PARSE_FAIL; /* FIXME better error code? */
-      }
-
       /* Pick a new conn ID for ourselves, which the peer will address us
          with in the future (via dest conn ID). */
 
@@ -1559,6 +1539,18 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
         metrics->conn_retry_cnt++;
       }
 
+      /* Is conn free?  This is deliberately checked after Retry
+         handling: sending a Retry and rejecting a bad token are both
+         stateless, so a handshake flood that fills up the conn slots
+         does not stop other clients from getting their address
+         validated. */
+
+      if( FD_UNLIKELY( !state->conns ) ) {
+        FD_DEBUG( FD_LOG_DEBUG(( "ignoring conn request: no free conn slots" )) );
+        quic->metrics.conn_err_no_slots_cnt++;
+        return FD_QUIC_PARSE_FAIL; /* FIXME better error code? */
+      }
+
       /* Allocate new conn */
 
       conn = fd_quic_conn_create( quic,
@@ -2251,6 +2243,124 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *           quic,
   return tot_sz;
 }
 
+/* fd_quic_svc_insert adds conn to the service wheel, to be serviced
+   no earlier than timeout.  The slot is clamped to the current
+   revolution of the wheel, so a timeout beyond the wheel's horizon
+   fires early rather than wrapping around. */
+
+static void
+fd_quic_svc_insert( fd_quic_state_t * state,
+                    fd_quic_conn_t *  conn,
+                    ulong             timeout ) {
+  int   lg   = state->svc_tick_lg;
+  ulong tick = ( timeout + (1UL<<lg) - 1UL ) >> lg;
+
+  /* an empty wheel can be moved to any position up to the present.
+     Moving it past the present would clamp later inserts with an
+     earlier timeout up to this tick. */
+  if( !state->svc_cnt ) state->svc_tick = fd_ulong_min( tick, state->now >> lg );
+
+  tick = fd_ulong_max( tick, state->svc_tick );
+  tick = fd_ulong_min( tick, state->svc_tick + FD_QUIC_SVC_SLOT_CNT - 1UL );
+
+  ulong            slot = tick & (FD_QUIC_SVC_SLOT_CNT-1UL);
+  fd_quic_conn_t * head = state->svc_slot[ slot ];
+
+  conn->svc_slot = (uint)slot;
+  conn->svc_prev = NULL;
+  conn->svc_next = head;
+  if( head ) head->svc_prev = conn;
+  state->svc_slot[ slot ] = conn;
+
+  state->svc_used[ slot>>6 ] |= 1UL<<(slot&63UL);
+  state->svc_cnt++;
+}
+
+/* fd_quic_svc_remove unlinks conn from the service wheel */
+
+static void
+fd_quic_svc_remove( fd_quic_state_t * state,
+                    fd_quic_conn_t *  conn ) {
+  ulong            slot = conn->svc_slot;
+  fd_quic_conn_t * prev = conn->svc_prev;
+  fd_quic_conn_t * next = conn->svc_next;
+
+  if( next ) next->svc_prev = prev;
+  if( prev ) prev->svc_next = next;
+  else {
+    state->svc_slot[ slot ] = next;
+    if( !next ) state->svc_used[ slot>>6 ] &= ~( 1UL<<(slot&63UL) );
+  }
+
+  conn->svc_prev = NULL;
+  conn->svc_next = NULL;
+  state->svc_cnt--;
+}
+
+/* fd_quic_svc_rebase moves every conn in the service wheel into the
+   slot of tick and moves the cursor there.  Used when the wheel fell
+   behind by more than a revolution, at which point every scheduled
+   conn is due.  O(number of scheduled conns). */
+
+static void
+fd_quic_svc_rebase( fd_quic_state_t * state,
+                    ulong             tick ) {
+  ulong            dst_slot = tick & (FD_QUIC_SVC_SLOT_CNT-1UL);
+  fd_quic_conn_t * head     = NULL;
+
+  for( ulong w=0UL; w<FD_QUIC_SVC_SLOT_CNT/64UL; w++ ) {
+    ulong bits = state->svc_used[ w ];
+    state->svc_used[ w ] = 0UL;
+    while( bits ) {
+      ulong slot = (w<<6) + (ulong)fd_ulong_find_lsb( bits );
+      bits = fd_ulong_pop_lsb( bits );
+
+      fd_quic_conn_t * conn = state->svc_slot[ slot ];
+      state->svc_slot[ slot ] = NULL;
+      while( conn ) {
+        fd_quic_conn_t * next = conn->svc_next;
+        conn->svc_slot = (uint)dst_slot;
+        conn->svc_prev = NULL;
+        conn->svc_next = head;
+        if( head ) head->svc_prev = conn;
+        head = conn;
+        conn = next;
+      }
+    }
+  }
+
+  state->svc_slot[ dst_slot ] = head;
+  if( head ) state->svc_used[ dst_slot>>6 ] |= 1UL<<(dst_slot&63UL);
+  state->svc_tick = tick;
+}
+
+/* fd_quic_svc_next_tick returns the tick of the earliest non-empty
+   slot in the service wheel, or ~0UL if the wheel is empty.  Scans the
+   occupancy bitmap starting at the current tick, wrapping around. */
+
+static ulong
+fd_quic_svc_next_tick( fd_quic_state_t const * state ) {
+  if( !state->svc_cnt ) return ~0UL;
+
+  ulong const word_cnt = FD_QUIC_SVC_SLOT_CNT / 64UL;
+  ulong const start    = state->svc_tick & (FD_QUIC_SVC_SLOT_CNT-1UL);
+
+  ulong w    = start>>6;
+  ulong bits = state->svc_used[ w ] & ( ~0UL << (start&63UL) );
+
+  /* j==word_cnt revisits the first word for the bits below start */
+  for( ulong j=0UL; j<=word_cnt; j++ ) {
+    if( bits ) {
+      ulong slot = (w<<6) + (ulong)fd_ulong_find_lsb( bits );
+      return state->svc_tick + ( ( slot - start ) & (FD_QUIC_SVC_SLOT_CNT-1UL) );
+    }
+    w    = (w+1UL) % word_cnt;
+    bits = state->svc_used[ w ];
+  }
+
+  return ~0UL; /* unreachable */
+}
+
 void
 fd_quic_schedule_conn( fd_quic_conn_t * conn ) {
 
@@ -2261,33 +2371,12 @@ fd_quic_schedule_conn( fd_quic_conn_t * conn ) {
 
   /* scheduled? */
   if( conn->in_service ) {
-    /* find conn in events, then remove, update, insert */
-    fd_quic_event_t * event     = NULL;
-    ulong             event_idx = 0;
-    ulong             cnt   = service_queue_cnt( state->service_queue );
-    for( ulong j = 0; j < cnt; ++j ) {
-      fd_quic_event_t * cur_event = state->service_queue + j;
-      if( cur_event->conn == conn ) {
-        event     = cur_event;
-        event_idx = j;
-        break;
-      }
-    }
-
-    if( FD_LIKELY( event ) ) {
-      /* remove key */
-      service_queue_remove( state->service_queue, event_idx );
-
-      /* TODO can use a priority queue key-reduce operation, which may be done more
-         quickly than remove, insert */
-    }
+    fd_quic_svc_remove( state, conn );
   }
 
   timeout = fd_ulong_max( timeout, state->now + 1UL );
 
-  /* insert key */
-  fd_quic_event_t event[1] = {{ .timeout = timeout, .conn = conn }};
-  service_queue_insert( state->service_queue, event );
+  fd_quic_svc_insert( state, conn, timeout );
 
   conn->sched_service_time = timeout;
   conn->next_service_time  = timeout;
@@ -2328,27 +2417,7 @@ fd_quic_reschedule_conn( fd_quic_conn_t * conn,
       return;
     }
 
-    /* find conn in events, then remove, update, insert */
-    fd_quic_event_t * event     = NULL;
-    ulong             event_idx = 0;
-    ulong             cnt   = service_queue_cnt( state->service_queue );
-    for( ulong j = 0; j < cnt; ++j ) {
-      fd_quic_event_t * cur_event = state->service_queue + j;
-      if( cur_event->conn == conn ) {
-        event     = cur_event;
-        event_idx = j;
-        break;
-      }
-    }
-
-    if( FD_LIKELY( event ) ) {
-      /* remove key */
-      service_queue_remove( state->service_queue, event_idx );
-
-      /* TODO can use a priority queue key-reduce operation, which may be done more
-         quickly than remove, insert */
-    }
-
+    /* move to the earlier slot */
     conn->next_service_time = timeout;
     fd_quic_schedule_conn( conn );
 
@@ -3131,6 +3200,11 @@ fd_quic_tls_cb_handshake_complete( fd_quic_tls_hs_t * hs,
         conn->handshake_complete = 1;
         conn->state              = FD_QUIC_CONN_STATE_HANDSHAKE_COMPLETE;
 
+        /* remember who the peer authenticated as */
+        if( conn->server ) {
+          fd_memcpy( conn->peer_identity, hs->hs.srv.client_pubkey, 32UL );
+        }
+
         /* handle transport params */
         uchar const * peer_transport_params_raw    = NULL;
         ulong         peer_transport_params_raw_sz = 0;
@@ -3245,6 +3319,58 @@ fd_quic_tls_cb_handshake_complete( fd_quic_tls_hs_t * hs,
   }
 }
 
+/* fd_quic_conn_tls_rx forwards received handshake data to fd_quic_tls
+   and advances the handshake.  On failure, sets conn to ABORT with the
+   appropriate reason and returns FD_QUIC_TLS_FAILED. */
+
+static int
+fd_quic_conn_tls_rx( fd_quic_conn_t * conn,
+                     uint             enc_level,
+                     uchar const *    data,
+                     ulong            data_sz ) {
+  int provide_rc = fd_quic_tls_provide_data( conn->tls_hs, enc_level, data, data_sz );
+  if( provide_rc == FD_QUIC_TLS_FAILED ) {
+    /* if TLS fails, abort connection */
+    fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_CRYPTO_BUFFER_EXCEEDED, __LINE__ );
+    return FD_QUIC_TLS_FAILED;
+  }
+
+  int process_rc = fd_quic_tls_process( conn->tls_hs );
+  if( process_rc == FD_QUIC_TLS_FAILED ) {
+    FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_tls_process error at" )); )
+
+    /* if TLS fails, ABORT connection */
+
+    /* if TLS returns an error, we present that as reason:
+         FD_QUIC_CONN_REASON_CRYPTO_BASE + tls-alert
+       otherwise, send INTERNAL_ERROR */
+    uint alert = conn->tls_hs->alert;
+    if( alert == 0u ) {
+      fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_INTERNAL_ERROR, __LINE__ );
+    } else {
+      fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_CRYPTO_BASE + alert, __LINE__ );
+    }
+    return FD_QUIC_TLS_FAILED;
+  }
+
+  return FD_QUIC_TLS_SUCCESS;
+}
+
+/* fd_quic_conn_tls_rx_deferred forwards handshake data previously
+   buffered via fd_quic_tls_defer_data.  Returns like
+   fd_quic_conn_tls_rx. */
+
+static int
+fd_quic_conn_tls_rx_deferred( fd_quic_conn_t * conn ) {
+  fd_quic_tls_hs_t * hs = conn->tls_hs;
+
+  ulong defer_sz = hs->rx_defer_sz;
+  hs->rx_defer_sz = 0u;
+  if( !defer_sz ) return FD_QUIC_TLS_SUCCESS;
+
+  return fd_quic_conn_tls_rx( conn, hs->rx_defer_enc_level, fd_quic_tls_hs_rx_defer_buf( hs ), defer_sz );
+}
+
 static ulong
 fd_quic_frame_handle_crypto_frame( void *                   vp_context,
                                    fd_quic_crypto_frame_t * crypto,
@@ -3279,35 +3405,25 @@ fd_quic_frame_handle_crypto_frame( void *                   vp_context,
     rcv_sz -= skip;
     uchar const * crypto_data = crypto->crypto_data + skip;
 
-    int provide_rc = fd_quic_tls_provide_data( conn->tls_hs,
-                                               context.pkt->enc_level,
-                                               crypto_data,
-                                               rcv_sz );
-    if( provide_rc == FD_QUIC_TLS_FAILED ) {
-      /* if TLS fails, abort connection */
-      fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_CRYPTO_BUFFER_EXCEEDED, __LINE__ );
-
-      return FD_QUIC_PARSE_FAIL;
-    }
-
-    int process_rc = fd_quic_tls_process( conn->tls_hs );
-    if( process_rc == FD_QUIC_TLS_FAILED ) {
-      FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_tls_process error at" )); )
-
-      /* if TLS fails, ABORT connection */
-
-      /* if TLS returns an error, we present that as reason:
-           FD_QUIC_CONN_REASON_CRYPTO_BASE + tls-alert
-         otherwise, send INTERNAL_ERROR */
-      uint alert = conn->tls_hs->alert;
-      if( alert == 0u ) {
-        fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_INTERNAL_ERROR, __LINE__ );
-      } else {
-        fd_quic_conn_error( conn, FD_QUIC_CONN_REASON_CRYPTO_BASE + alert, __LINE__ );
+    /* A server configured with hs_service_max leaves the ClientHello
+       for fd_quic_conn_service, which limits the number of handshakes
+       advanced per fd_quic_service call.  Anything arriving while data
+       is still deferred must queue up behind it. */
+    int defer = conn->tls_hs->rx_defer_sz ||
+                ( conn->server &&
+                  enc_level == fd_quic_enc_level_initial_id &&
+                  context.quic->limits.hs_service_max );
+
+    if( defer &&
+        fd_quic_tls_defer_data( conn->tls_hs, enc_level, crypto_data, rcv_sz ) == FD_QUIC_TLS_SUCCESS ) {
+      fd_quic_reschedule_conn( conn, 0 );
+    } else {
+      /* process inline, flushing anything deferred first */
+      if( FD_UNLIKELY( fd_quic_conn_tls_rx_deferred( conn ) == FD_QUIC_TLS_FAILED ||
+                       fd_quic_conn_tls_rx( conn, enc_level, crypto_data, rcv_sz ) == FD_QUIC_TLS_FAILED ) ) {
+        /* don't process any more frames on this connection */
+        return FD_QUIC_PARSE_FAIL;
       }
-
-      /* don't process any more frames on this connection */
-      return FD_QUIC_PARSE_FAIL;
     }
 
     /* successful, update rx_crypto_offset */
@@ -3329,7 +3445,8 @@ fd_quic_service( fd_quic_t * quic ) {
 
   ulong now = fd_quic_now( quic );
 
-  state->now = now;
+  state->now            = now;
+  state->hs_service_rem = quic->limits.hs_service_max;
 
   /* do we need to assign streams to connections? */
   if( FD_LIKELY( state->flags & FD_QUIC_FLAGS_ASSIGN_STREAMS ) ) {
@@ -3337,24 +3454,32 @@ fd_quic_service( fd_quic_t * quic ) {
     fd_quic_assign_streams( quic );
   }
 
-  /* service events */
-  fd_quic_conn_t * conn = NULL;
-  while( service_queue_cnt( state->service_queue ) ) {
-    fd_quic_event_t * event = &state->service_queue[0];
+  /* service expired slots of the service wheel */
+  ulong due_tick = now >> state->svc_tick_lg;
 
-    /* copy before removing event */
-    conn = event->conn;
+  /* if service was not called for more than a revolution, everything
+     in the wheel is due.  Gather all conns in the slot of due_tick so
+     that they are all serviced below.  The margin of one slot ensures
+     conns rescheduled below always land after due_tick. */
+  if( FD_UNLIKELY( due_tick > state->svc_tick + FD_QUIC_SVC_SLOT_CNT - 2UL ) ) {
+    fd_quic_svc_rebase( state, due_tick );
+  }
 
-    ulong service_time = event->timeout;
-    if( now < service_time ) {
+  fd_quic_conn_t * conn = NULL;
+  for(;;) {
+    ulong tick = fd_quic_svc_next_tick( state );
+    if( tick > due_tick ) {
       break;
     }
+    state->svc_tick = tick;
+
+    conn = state->svc_slot[ tick & (FD_QUIC_SVC_SLOT_CNT-1UL) ];
 
     /* set an initial next_service_time */
     conn->next_service_time = now + fd_quic_get_service_interval( quic );
 
-    /* remove event, later reinserted at new time */
-    service_queue_remove_min( state->service_queue );
+    /* remove from wheel, later reinserted at new time */
+    fd_quic_svc_remove( state, conn );
 
     /* unset "in service queue" */
     conn->in_service = 0;
@@ -3416,6 +3541,7 @@ fd_quic_service( fd_quic_t * quic ) {
         }
     }
   }
+  state->svc_tick = fd_ulong_max( state->svc_tick, due_tick + 1UL );
 
   FD_DEBUG(
     t1 = fd_quic_now( quic );
@@ -4736,7 +4862,6 @@ fd_quic_conn_tx( fd_quic_t *      quic,
 
 void
 fd_quic_conn_service( fd_quic_t * quic, fd_quic_conn_t * conn, ulong now ) {
-  (void)now;
 
   /* handle expiry on pkt_meta */
   fd_quic_pkt_meta_retry( quic, conn, 0 /* don't force */, ~0u /* enc_level */ );
@@ -4753,6 +4878,21 @@ fd_quic_conn_service( fd_quic_t * quic, fd_quic_conn_t * conn, ulong now ) {
     case FD_QUIC_CONN_STATE_HANDSHAKE_COMPLETE:
       {
         if( conn->tls_hs ) {
+          /* handshake data deferred by the crypto frame handler */
+          if( FD_UNLIKELY( conn->tls_hs->rx_defer_sz ) ) {
+            fd_quic_state_t * state = fd_quic_get_state( quic );
+            if( !state->hs_service_rem ) {
+              /* out of budget, retry in the next fd_quic_service call */
+              fd_quic_reschedule_conn( conn, now+1UL );
+              break;
+            }
+            state->hs_service_rem--;
+            if( FD_UNLIKELY( fd_quic_conn_tls_rx_deferred( conn ) == FD_QUIC_TLS_FAILED ) ) {
+              quic->metrics.conn_err_tls_fail_cnt++;
+              return;
+            }
+          }
+
           /* call process on TLS */
           int process_rc = fd_quic_tls_process( conn->tls_hs );
           if( process_rc == FD_QUIC_TLS_FAILED ) {
@@ -4879,11 +5019,10 @@ fd_quic_conn_free( fd_quic_t *      quic,
     }
   }
 
-  /* no need to remove this connection from the events queue
+  /* no need to remove this connection from the service wheel
      free is called from two places:
-       fini    - service will never be called again. All events are destroyed
-       service - removes event before calling free. Event only allowed to be
-       enqueued once */
+       fini    - service will never be called again. The wheel is reset
+       service - removes conn from the wheel before calling free */
 
   /* remove all stream ids from map, and free stream */
 
@@ -4959,24 +5098,14 @@ fd_quic_conn_free( fd_quic_t *      quic,
 
   quic->metrics.conn_active_cnt--;
 
-  /* clear keys */
+  /* clear keys, including the expanded cipher state */
   for( ulong j = 0U; j < 4U; ++j ) {
     for( ulong k = 0U; k < 2U; ++k ) {
-      fd_memset( conn->keys[j][k].pkt_key, 0x42, sizeof( conn->keys[0][0].pkt_key ) );
-      fd_memset( conn->keys[j][k].hp_key,  0x43, sizeof( conn->keys[0][0].hp_key  ) );
-      fd_memset( conn->keys[j][k].iv,      0x45, sizeof( conn->keys[0][0].iv      ) );
-      conn->keys[j][k].pkt_key_sz = 0;
-      conn->keys[j][k].hp_key_sz  = 0;
-      conn->keys[j][k].iv_sz      = 0;
+      fd_quic_crypto_keys_clear( &conn->keys[j][k] );
     }
   }
   for( ulong k = 0U; k < 2U; ++k ) {
-    fd_memset( conn->new_keys[k].pkt_key, 0x42, sizeof( conn->new_keys[0].pkt_key ) );
-    fd_memset( conn->new_keys[k].hp_key,  0x43, sizeof( conn->new_keys[0].hp_key  ) );
-    fd_memset( conn->new_keys[k].iv,      0x45, sizeof( conn->new_keys[0].iv      ) );
-    conn->new_keys[k].pkt_key_sz = 0;
-    conn->new_keys[k].hp_key_sz  = 0;
-    conn->new_keys[k].iv_sz      = 0;
+    fd_quic_crypto_keys_clear( &conn->new_keys[k] );
   }
 }
 
@@ -5225,6 +5354,7 @@ fd_quic_conn_create( fd_quic_t *               quic,
   conn->handshake_done_ackd = 0;
   conn->hs_data_empty       = 0;
   conn->tls_hs              = NULL; /* created later */
+  fd_memset( conn->peer_identity, 0, sizeof(conn->peer_identity) );
 
   /* initialize stream_id members */
   for( ulong j = 0; j < 4; ++j ) conn->min_stream_id[j]      = j; /* invariant: minup_stream_id[j]%3    = j */
@@ -5234,6 +5364,7 @@ fd_quic_conn_create( fd_quic_t *               quic,
   for( ulong j = 0; j < 4; ++j ) conn->next_stream_id[j]     = j;
   for( ulong j = 0; j < 4; ++j ) conn->max_concur_streams[j] = 0; /* set below via set_max_streams          */
   for( ulong j = 0; j < 4; ++j ) conn->cur_stream_cnt[j]     = 0;
+  conn->stream_weight = 1UL;
 
   /* points to free tx space */
   conn->tx_ptr = conn->tx_buf;
@@ -5351,8 +5482,9 @@ fd_quic_get_next_wakeup( fd_quic_t * quic ) {
   }
 
   ulong t = ~(ulong)0;
-  if( service_queue_cnt( state->service_queue ) ) {
-    t = state->service_queue[0].timeout;
+  ulong tick = fd_quic_svc_next_tick( state );
+  if( tick != ~0UL ) {
+    t = tick << state->svc_tick_lg;
   }
 
   return t;
@@ -5697,10 +5829,12 @@ fd_quic_reclaim_pkt_meta( fd_quic_conn_t *     conn,
       COPY_KEY(1,pkt_key);
       COPY_KEY(1,iv);
 #     undef COPY_KEY
+      conn->keys[enc_level][0].pkt_cipher = conn->new_keys[0].pkt_cipher;
+      conn->keys[enc_level][1].pkt_cipher = conn->new_keys[1].pkt_cipher;
 
-      /* finally zero out new_keys */
-      fd_memset( &conn->new_keys[0], 0, sizeof( fd_quic_crypto_keys_t ) );
-      fd_memset( &conn->new_keys[1], 0, sizeof( fd_quic_crypto_keys_t ) );
+      /* finally scrub new_keys */
+      fd_quic_crypto_keys_clear( &conn->new_keys[0] );
+      fd_quic_crypto_keys_clear( &conn->new_keys[1] );
 
       /* copy secrets */
       fd_memcpy( &conn->secrets.secret[enc_level][0][0],
@@ -7040,9 +7174,13 @@ fd_quic_assign_streams( fd_quic_t * quic ) {
   /* connections fairly                                                   */
   /* The user sets a target number of concurrently usable streams to each */
   /* connection. Across all the connections, it is possible that this     */
-  /* target cannot be reached. So we use a policy that assigns available  */
-  /* streams randomly by weight, where the weight is the difference       */
-  /* between the current number of valid streams and the target.          */
+  /* target cannot be reached. So we use a weighted fair queue: every     */
+  /* connection is weighted by its shortfall from its target, times its  */
+  /* stream_weight, and available streams are dealt out in proportion to */
+  /* the weights.  The queue position is a fraction of the total cs_tree  */
+  /* weight that moves by the golden ratio on each pick, which spreads    */
+  /* picks evenly, so that over any run of picks each connection gets     */
+  /* close to its share.                                                  */
   /* The result is that if the targets can be fulfullied, they will be,   */
   /* otherwise, they will be distributed fairly                           */
   /* The user may terminate connections to free up streams for higher     */
@@ -7052,7 +7190,6 @@ fd_quic_assign_streams( fd_quic_t * quic ) {
   fd_quic_state_t *       state       = fd_quic_get_state( quic );
   fd_quic_cs_tree_t *     cs_tree     = state->cs_tree;
   fd_quic_stream_pool_t * stream_pool = state->stream_pool;
-  fd_rng_t *              rng         = fd_rng_join( state->_rng );
 
   /* we want to reserve 1 stream for each connection */
   /* TODO could add a config for larger reservations */
@@ -7065,7 +7202,8 @@ fd_quic_assign_streams( fd_quic_t * quic ) {
 
   while( FD_LIKELY( avail_streams > 0UL ) ) {
     /* if total weights over all connections is zero, we're done */
-    if( FD_UNLIKELY( fd_quic_cs_tree_total( cs_tree ) == 0 ) ) break;
+    ulong total = fd_quic_cs_tree_total( cs_tree );
+    if( FD_UNLIKELY( total == 0 ) ) break;
 
     /* obtain stream from stream pool */
     fd_quic_stream_t * stream = fd_quic_stream_pool_alloc( stream_pool );
@@ -7076,8 +7214,14 @@ fd_quic_assign_streams( fd_quic_t * quic ) {
     fd_quic_stream_init( stream );
     FD_QUIC_STREAM_LIST_INIT_STREAM( stream );
 
-    /* choose weighted random cs_tree index */
-    ulong idx = fd_quic_choose_weighted_index( cs_tree, rng );
+    /* choose the next cs_tree index in the fair queue */
+    state->assign_cursor += 0x9e3779b97f4a7c15UL; /* 2^64 / golden ratio */
+#if FD_HAS_INT128
+    ulong target = (ulong)( ( (uint128)state->assign_cursor * (uint128)total ) >> 64 );
+#else
+    ulong target = fd_ulong_min( (ulong)( (double)state->assign_cursor / 18446744073709551616.0 * (double)total ), total-1UL );
+#endif
+    ulong idx = fd_quic_cs_tree_find( cs_tree, target );
 
     /* idx maps to connection and dirtype thusly:  */
     /*   idx = ( conn_idx << 1 ) + dirtype             */
@@ -7105,8 +7249,6 @@ fd_quic_assign_streams( fd_quic_t * quic ) {
 
     avail_streams--;
   }
-
-  fd_rng_leave( rng );
 }
 
 
@@ -7228,10 +7370,7 @@ fd_quic_cs_tree_update( fd_quic_cs_tree_t * cs_tree, ulong idx, ulong new_value
 ulong
 fd_quic_choose_weighted_index( fd_quic_cs_tree_t * cs_tree,
                                fd_rng_t *          rng ) {
-  ulong   cnt      = cs_tree->cnt;
-  ulong * values   = cs_tree->values;
-  ulong   node_idx = 1UL;
-  ulong   total    = values[1UL]; /* the root is at 1 */
+  ulong   total    = cs_tree->values[1UL]; /* the root is at 1 */
 
   ulong   target   = fd_rng_ulong_roll( rng, total ); /* return rand in [0,total) */
 
@@ -7239,6 +7378,16 @@ fd_quic_choose_weighted_index( fd_quic_cs_tree_t * cs_tree,
     FD_LOG_ERR(( "rng error" ));
   }
 
+  return fd_quic_cs_tree_find( cs_tree, target );
+}
+
+ulong
+fd_quic_cs_tree_find( fd_quic_cs_tree_t * cs_tree,
+                      ulong               target ) {
+  ulong   cnt      = cs_tree->cnt;
+  ulong * values   = cs_tree->values;
+  ulong   node_idx = 1UL;
+
   /* logic here is a branch-reduced version of:
 
        while( FD_LIKELY( node_idx < cnt ) ) {
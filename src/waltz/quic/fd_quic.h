@@ -121,6 +121,17 @@ struct __attribute__((aligned(16UL))) fd_quic_limits {
   /* the user consumes rx directly from the network buffer */
 
   ulong  stream_pool_cnt;  /* instance-wide, number of streams in stream pool */
+
+  /* hs_service_max: (server only) if non-zero, ClientHellos are not
+     processed as they arrive.  Instead, they are buffered and at most
+     hs_service_max of them are processed per fd_quic_service call.
+     Bounds the time spent on handshake crypto (key exchange and
+     CertificateVerify signing) in one service call.  The crypto still
+     runs on the caller's thread, so a burst of new connections is
+     spread out over several service calls rather than taken off the
+     path of established ones.  Zero processes handshakes inline, and
+     reserves no memory for buffering ClientHellos. */
+  ulong  hs_service_max;
 };
 typedef struct fd_quic_limits fd_quic_limits_t;
 
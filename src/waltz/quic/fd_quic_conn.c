@@ -95,6 +95,7 @@ fd_quic_conn_footprint_ext( fd_quic_limits_t const * limits,
   off                  += inflight_pkt_cnt * sizeof(fd_quic_ack_t);
 
   /* align total footprint */
+  off = fd_ulong_align_up( off, fd_quic_conn_align() );
 
   return off;
 }
@@ -261,6 +262,22 @@ fd_quic_conn_get_max_streams( fd_quic_conn_t * conn, uint dirtype ) {
   return conn->max_concur_streams[type];
 }
 
+FD_QUIC_API void
+fd_quic_conn_set_stream_weight( fd_quic_conn_t * conn, ulong weight ) {
+  if( FD_UNLIKELY( weight<1UL || weight>FD_QUIC_CONN_STREAM_WEIGHT_MAX ) ) {
+    FD_LOG_WARNING(( "fd_quic_conn_set_stream_weight called with invalid weight %lu", weight ));
+    return;
+  }
+
+  conn->stream_weight = weight;
+
+  fd_quic_conn_update_weight( conn, FD_QUIC_TYPE_UNIDIR );
+  fd_quic_conn_update_weight( conn, FD_QUIC_TYPE_BIDIR  );
+
+  /* reassign the streams on the next fd_quic_service */
+  fd_quic_get_state( conn->quic )->flags |= FD_QUIC_FLAGS_ASSIGN_STREAMS;
+}
+
 /* update the tree weight
    called whenever weight may have changed */
 void
@@ -287,9 +304,11 @@ fd_quic_conn_update_weight( fd_quic_conn_t * conn, uint dirtype ) {
 
   /* determine the weight */
 
+  /* the shortfall from the target, scaled by the stream weight */
   ulong weight = fd_ulong_if( tgt_sup_stream_id > sup_stream_id,
                               ( tgt_sup_stream_id - sup_stream_id ) >> 2UL,
                               0UL );
+  weight *= conn->stream_weight;
 
   if( conn->state != FD_QUIC_CONN_STATE_ACTIVE &&
       conn->state != FD_QUIC_CONN_STATE_HANDSHAKE_COMPLETE ) {
@@ -86,7 +86,10 @@ struct fd_quic_conn {
 
   ulong              next_service_time;   /* time service should be called next */
   ulong              sched_service_time;  /* time service is scheduled for, if in_service=1 */
-  int                in_service;          /* whether the conn is in the service queue */
+  int                in_service;          /* whether the conn is in the service wheel */
+  uint               svc_slot;            /* service wheel slot, if in_service=1 */
+  fd_quic_conn_t *   svc_prev;            /* service wheel list links, if in_service=1 */
+  fd_quic_conn_t *   svc_next;
   uchar              called_conn_new;     /* whether we need to call conn_final on teardown */
 
   /* we can have multiple connection ids */
@@ -131,6 +134,11 @@ struct fd_quic_conn {
   int                hs_data_empty;       /* has all hs_data been consumed? */
   fd_quic_tls_hs_t * tls_hs;
 
+  /* peer_identity: Ed25519 public key the peer authenticated with via
+     its TLS client certificate.  Valid from the conn_new callback on.
+     All zeros if the peer didn't present one (or we're the client). */
+  uchar              peer_identity[ 32 ];
+
   /* expected handshake data offset - one per encryption level
      data received lower than this on a new packet is a protocol error
        duplicate packets should already have been dropped
@@ -196,6 +204,11 @@ struct fd_quic_conn {
   ulong max_concur_streams[4];  /* user set concurrent max */
   ulong cur_stream_cnt[4];      /* current number of streams by type */
 
+  /* stream_weight scales the share of the stream pool given to this
+     conn when the pool is contended (see fd_quic_assign_streams).
+     Defaults to 1, may be adjusted via fd_quic_conn_set_stream_weight */
+  ulong stream_weight;
+
   /* stream id limits */
   /* limits->stream_cnt */
   /*   used to size stream_map, and provides an upper limit on the temporary limits */
@@ -390,6 +403,22 @@ FD_QUIC_API ulong
 fd_quic_conn_get_max_streams( fd_quic_conn_t * conn, uint type );
 
 
+/* fd_quic_conn_set_stream_weight sets the priority of conn for streams
+   from the shared stream pool.  Free streams are dealt out by
+   fd_quic_service in a weighted fair queue over the conns short of
+   their max_streams target.  Each conn is weighted by its shortfall
+   from the target times weight.  E.g. a conn with weight 8 receives 8
+   streams for every one a conn with weight 1 and the same shortfall
+   receives.  May be called on live conns, takes effect on
+   the next fd_quic_service.  weight must be in
+   [1,FD_QUIC_CONN_STREAM_WEIGHT_MAX]. */
+
+#define FD_QUIC_CONN_STREAM_WEIGHT_MAX (1UL<<16)
+
+FD_QUIC_API void
+fd_quic_conn_set_stream_weight( fd_quic_conn_t * conn, ulong weight );
+
+
 /* update the tree weight
    called whenever weight may have changed */
 void
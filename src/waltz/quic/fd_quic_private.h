@@ -36,14 +36,15 @@ enum {
 
 #define FD_QUIC_MAGIC (0xdadf8cfa01cc5460UL)
 
-/* events for time based processing */
-struct fd_quic_event {
-  ulong            timeout;
-
-  fd_quic_conn_t * conn; /* connection or NULL */
-  /* possibly "type", etc., for other kinds of service */
-};
-typedef struct fd_quic_event fd_quic_event_t;
+/* Connections awaiting service are kept in a hashed timer wheel of
+   FD_QUIC_SVC_SLOT_CNT slots.  Each slot spans 2^svc_tick_lg ns and
+   holds a doubly linked list of conns (see svc_prev/svc_next).  The
+   tick size is picked at init such that the wheel covers at least
+   twice the service interval.  Since fd_quic_reschedule_conn never
+   schedules further out than one service interval, every scheduled
+   conn lies within one revolution of the wheel, so insert, remove,
+   and expiry are O(1). */
+#define FD_QUIC_SVC_SLOT_CNT (1024UL)
 
 /* structure for a cummulative summation tree */
 struct fd_quic_cs_tree {
@@ -62,6 +63,8 @@ struct __attribute__((aligned(16UL))) fd_quic_state_private {
 
   ulong now; /* the time we entered into fd_quic_service, or fd_quic_aio_cb_receive */
 
+  ulong hs_service_rem; /* deferred handshakes left to process in this fd_quic_service call */
+
   /* Pointer to TLS state (part of quic memory region) */
 
   fd_quic_tls_t * tls;
@@ -84,10 +87,19 @@ struct __attribute__((aligned(16UL))) fd_quic_state_private {
   fd_quic_conn_t *        conns;          /* free list of unused connections */
   ulong                   free_conns;     /* count of free connections */
   fd_quic_conn_map_t *    conn_map;       /* map connection ids -> connection */
-  fd_quic_event_t *       service_queue;  /* priority queue of connections by service time */
+
+  /* service timer wheel */
+  fd_quic_conn_t *        svc_slot[ FD_QUIC_SVC_SLOT_CNT ];       /* list head per slot, NULL if empty */
+  ulong                   svc_used[ FD_QUIC_SVC_SLOT_CNT / 64UL ]; /* bit i set iff svc_slot[i] non-empty */
+  ulong                   svc_tick;       /* lowest tick that may hold a scheduled conn */
+  ulong                   svc_cnt;        /* number of scheduled conns */
+  int                     svc_tick_lg;    /* log2 of tick duration in ns */
+
   fd_quic_stream_pool_t * stream_pool;    /* stream pool */
 
   fd_quic_cs_tree_t *     cs_tree;        /* cummulative summation tree */
+  ulong                   assign_cursor;  /* position of the stream assignment fair queue, */
+                                          /* as a fraction of the total cs_tree weight */
   fd_rng_t                _rng[1];        /* random number generator */
 
   /* need to be able to access connections by index */
@@ -174,6 +186,11 @@ ulong
 fd_quic_get_service_interval( fd_quic_t * quic );
 
 
+/* schedule a connection for service at conn->next_service_time,
+   moving it if already scheduled */
+void
+fd_quic_schedule_conn( fd_quic_conn_t * conn );
+
 /* reschedule a connection */
 void
 fd_quic_reschedule_conn( fd_quic_conn_t * conn,
@@ -390,9 +407,9 @@ fd_quic_conn_error( fd_quic_conn_t * conn,
 /* connections fairly                                                   */
 /* The user sets a target number of concurrently usable streams to each */
 /* connection. Across all the connections, it is possible that this     */
-/* target cannot be reached. So we use a policy that assigns available  */
-/* streams randomly by weight, where the weight is the difference       */
-/* between the current number of valid streams and the target.          */
+/* target cannot be reached. So we use a weighted fair queue: every     */
+/* connection short of its target is weighted by its stream_weight, and */
+/* available streams are dealt out in proportion to the weights.        */
 /* The result is that if the targets can be fulfullied, they will be,   */
 /* otherwise, they will be distributed fairly                           */
 /* The user may terminate connections to free up streams for higher     */
@@ -419,6 +436,11 @@ fd_quic_cs_tree_get_weight( fd_quic_cs_tree_t * cs_tree, ulong idx );
 ulong
 fd_quic_choose_weighted_index( fd_quic_cs_tree_t * cs_tree, fd_rng_t * rng );
 
+/* fd_quic_cs_tree_find returns the index whose range of the cumulative */
+/* weight contains target. target must be in [0,total)                  */
+ulong
+fd_quic_cs_tree_find( fd_quic_cs_tree_t * cs_tree, ulong target );
+
 /* fd_quic_cs_tree_total returns the total value across all the leaves in */
 /* the supplied cs_tree                                                   */
 static inline ulong
@@ -5,16 +5,23 @@ $(call add-objs,fd_quic_stream_spam fd_quic_sandbox fd_quic_test_helpers,fd_quic
 # fd_quic unit tests
 $(call make-unit-test,test_quic_hs,         test_quic_hs,         fd_quic fd_tls fd_ballet fd_waltz fd_util)
 $(call make-unit-test,test_quic_streams,    test_quic_streams,    fd_quic fd_tls fd_ballet fd_waltz fd_util)
+$(call make-unit-test,test_quic_hs_defer,   test_quic_hs_defer,   fd_quic fd_tls fd_ballet fd_waltz fd_util)
 $(call make-unit-test,test_quic_conn,       test_quic_conn,       fd_quic fd_tls fd_ballet fd_waltz fd_util)
 $(call make-unit-test,test_quic_drops,      test_quic_drops,      fd_quic fd_tls fd_ballet fd_waltz fd_util fd_fibre)
 $(call make-unit-test,test_quic_bw,         test_quic_bw,         fd_quic fd_tls fd_ballet fd_waltz fd_util)
 $(call make-unit-test,test_quic_layout,     test_quic_layout,                                              fd_util)
 $(call make-unit-test,test_quic_conformance,test_quic_conformance,fd_quic fd_tls fd_tango fd_ballet fd_waltz fd_util)
+$(call make-unit-test,test_quic_svc,        test_quic_svc,        fd_quic fd_tls fd_tango fd_ballet fd_waltz fd_util)
+$(call make-unit-test,test_quic_stream_weight,test_quic_stream_weight,fd_quic fd_tls fd_tango fd_ballet fd_waltz fd_util)
 # $(call run-unit-test,test_quic_hs)
 $(call run-unit-test,test_quic_streams)
+$(call run-unit-test,test_quic_hs_defer)
 #$(call run-unit-test,test_quic_conn) -- broken because of fd_ip
 #$(call run-unit-test,test_quic_bw) -- broken because of fd_ip
 $(call run-unit-test,test_quic_layout)
+$(call run-unit-test,test_quic_conformance)
+$(call run-unit-test,test_quic_svc)
+$(call run-unit-test,test_quic_stream_weight)
 
 # fd_quic_tls unit tests
 $(call make-unit-test,test_quic_tls_hs,test_quic_tls_hs,fd_quic fd_tls fd_ballet fd_util)
@@ -27,7 +27,7 @@
 #include <assert.h>
 
 static fd_quic_crypto_suite_t const * suite;
-static fd_quic_crypto_keys_t const    keys[1] = {{
+static fd_quic_crypto_keys_t          keys[1] = {{
   .pkt_key    = {0},
   .pkt_key_sz = 32UL,
   .iv         = {0},
@@ -48,6 +48,7 @@ LLVMFuzzerInitialize( int *    pargc,
   static fd_quic_crypto_ctx_t crypto_ctx[1];
   fd_quic_crypto_ctx_init( crypto_ctx );
   suite = &crypto_ctx->suites[ TLS_AES_128_GCM_SHA256_ID ];
+  fd_quic_crypto_keys_expand( keys );
   return 0;
 }
 
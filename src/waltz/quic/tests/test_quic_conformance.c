@@ -3,6 +3,7 @@
 
 #include "fd_quic_sandbox.h"
 #include "../fd_quic_proto.h"
+#include "../fd_quic_private.h"
 
 /* RFC 9000 Section 4.1. Data Flow Control
 
@@ -59,6 +60,52 @@ test_quic_stream_limit_enforcement( fd_quic_sandbox_t * sandbox,
   FD_TEST( conn->reason == FD_QUIC_CONN_REASON_STREAM_LIMIT_ERROR );
 }
 
+/* fd_quic_conn_free must scrub all key material of the conn, including
+   the expanded AES key schedules and GHASH key cached per key. */
+
+static int
+test_mem_is_zero( void const * mem,
+                  ulong        sz ) {
+  uchar const * p = (uchar const *)mem;
+  for( ulong j=0UL; j<sz; j++ ) if( p[j] ) return 0;
+  return 1;
+}
+
+static void
+test_keys_populate( fd_quic_crypto_keys_t * keys,
+                    fd_rng_t *              rng ) {
+  for( ulong j=0UL; j<FD_QUIC_KEY_MAX_SZ; j++ ) {
+    keys->pkt_key[j] = fd_rng_uchar( rng );
+    keys->hp_key [j] = fd_rng_uchar( rng );
+    keys->iv     [j] = fd_rng_uchar( rng );
+  }
+  keys->pkt_key_sz = 16UL;
+  keys->hp_key_sz  = 16UL;
+  keys->iv_sz      = 12UL;
+  fd_quic_crypto_keys_expand( keys );
+  FD_TEST( !test_mem_is_zero( &keys->pkt_cipher, sizeof(fd_aes_gcm_t) ) );
+  FD_TEST( !test_mem_is_zero( &keys->hp_cipher,  sizeof(fd_aes_key_t) ) );
+}
+
+static __attribute__ ((noinline)) void
+test_quic_conn_free_clears_keys( fd_quic_sandbox_t * sandbox,
+                                 fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_conn_t * conn = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( conn );
+
+  for( ulong j=0UL; j<4UL; j++ ) {
+    for( ulong k=0UL; k<2UL; k++ ) test_keys_populate( &conn->keys[j][k], rng );
+  }
+  for( ulong k=0UL; k<2UL; k++ ) test_keys_populate( &conn->new_keys[k], rng );
+
+  fd_quic_conn_free( sandbox->quic, conn );
+
+  FD_TEST( test_mem_is_zero( conn->keys,     sizeof(conn->keys)     ) );
+  FD_TEST( test_mem_is_zero( conn->new_keys, sizeof(conn->new_keys) ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -102,6 +149,7 @@ main( int     argc,
 
   test_quic_stream_data_limit_enforcement( sandbox, rng );
   test_quic_stream_limit_enforcement     ( sandbox, rng );
+  test_quic_conn_free_clears_keys        ( sandbox, rng );
 
   /* Wind down */
 
@@ -118,11 +118,30 @@ test_secret_gen( uchar const * expected_output,
   FD_TEST( 0==memcmp( new_secret, expected_output, output_sz ) );
 }
 
+/* test_rand checks that fd_quic_crypto_rand does not hand out the same
+   buffered bytes twice, including across buffer refills and requests
+   larger than the buffer. */
+
+void
+test_rand( void ) {
+  static uchar out[ 64UL ][ 32UL ];
+  for( ulong i=0UL; i<64UL; i++ ) {
+    FD_TEST( fd_quic_crypto_rand( out[i], 8UL+(i%3UL)*12UL )==FD_QUIC_SUCCESS );
+    for( ulong j=0UL; j<i; j++ ) FD_TEST( 0!=memcmp( out[i], out[j], 8UL ) );
+  }
+
+  uchar big[ 1024UL ] = {0};
+  FD_TEST( fd_quic_crypto_rand( big, sizeof(big) )==FD_QUIC_SUCCESS );
+  FD_TEST( 0!=memcmp( big, big+512UL, 512UL ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
   fd_boot( &argc, &argv );
 
+  test_rand();
+
   /*   initial_secret = HKDF-Extract(initial_salt, */
   /*                                 client_dst_connection_id) */
 
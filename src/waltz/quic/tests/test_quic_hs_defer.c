@@ -0,0 +1,187 @@
+/* test_quic_hs_defer checks that a server with hs_service_max set
+   leaves incoming ClientHellos for fd_quic_service, and advances at
+   most hs_service_max of them per call. */
+
+#include "../fd_quic.h"
+#include "../fd_quic_private.h"
+#include "fd_quic_test_helpers.h"
+
+#define TEST_CONN_CNT (3UL)
+
+ulong server_complete = 0UL;
+
+void
+my_connection_new( fd_quic_conn_t * conn,
+                   void *           vp_context ) {
+  (void)conn; (void)vp_context;
+  server_complete++;
+}
+
+/* global "clock" */
+ulong now = 123;
+
+ulong test_clock( void * ctx ) {
+  (void)ctx;
+  return now;
+}
+
+/* test_deferred_cnt returns the number of server conns that hold
+   handshake data not yet provided to fd_tls.  Also returns the number
+   of live server conns in *live_cnt. */
+
+static ulong
+test_deferred_cnt( fd_quic_t * quic,
+                   ulong *     live_cnt ) {
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+  ulong deferred_cnt = 0UL;
+  *live_cnt = 0UL;
+  for( ulong j=0UL; j<quic->limits.conn_cnt; j++ ) {
+    fd_quic_conn_t * conn = fd_quic_conn_at_idx( state, j );
+    if( conn->state==FD_QUIC_CONN_STATE_INVALID ) continue;
+    (*live_cnt)++;
+    deferred_cnt += ( conn->tls_hs && conn->tls_hs->rx_defer_sz );
+  }
+  return deferred_cnt;
+}
+
+/* test_run services both sides until the server completed
+   expected_cnt handshakes */
+
+static void
+test_run( fd_quic_t * server_quic,
+          fd_quic_t * client_quic,
+          ulong       expected_cnt ) {
+  for( ulong j=0UL; j<64UL; j++ ) {
+    if( server_complete==expected_cnt ) return;
+
+    ulong next_wakeup = fd_ulong_min( fd_quic_get_next_wakeup( client_quic ),
+                                      fd_quic_get_next_wakeup( server_quic ) );
+    FD_TEST( next_wakeup!=~0UL );
+    now = fd_ulong_max( now+1UL, next_wakeup );
+
+    fd_quic_service( client_quic );
+    fd_quic_service( server_quic );
+  }
+  FD_LOG_ERR(( "handshakes did not complete (%lu of %lu)", server_complete, expected_cnt ));
+}
+
+static fd_quic_conn_t *
+test_connect( fd_quic_t * client_quic,
+              fd_quic_t * server_quic ) {
+  fd_quic_conn_t * conn = fd_quic_connect(
+      client_quic,
+      server_quic->config.net.ip_addr,
+      server_quic->config.net.listen_udp_port,
+      server_quic->config.sni );
+  FD_TEST( conn );
+  return conn;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+
+  fd_boot          ( &argc, &argv );
+  fd_quic_test_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"                   );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL                          );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx",  NULL, fd_shmem_numa_idx( cpu_idx ) );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_quic_limits_t quic_limits = {
+    .conn_cnt           = 2*TEST_CONN_CNT,
+    .conn_id_cnt        = 4,
+    .conn_id_sparsity   = 4.0,
+    .handshake_cnt      = 2*TEST_CONN_CNT,
+    .stream_cnt         = { 20, 20, 20, 20 },
+    .initial_stream_cnt = { 20, 20, 20, 20 },
+    .inflight_pkt_cnt   = 100,
+    .tx_buf_sz          = 1<<15,
+    .stream_pool_cnt    = 512
+  };
+
+  fd_quic_t * inline_quic = fd_quic_new_anonymous( wksp, &quic_limits, FD_QUIC_ROLE_SERVER, rng );
+  fd_quic_t * client_quic = fd_quic_new_anonymous( wksp, &quic_limits, FD_QUIC_ROLE_CLIENT, rng );
+  quic_limits.hs_service_max = 1UL;
+  fd_quic_t * defer_quic  = fd_quic_new_anonymous( wksp, &quic_limits, FD_QUIC_ROLE_SERVER, rng );
+  FD_TEST( inline_quic && defer_quic && client_quic );
+
+  /* Buffering ClientHellos takes memory only when enabled */
+  FD_TEST( fd_quic_footprint( &quic_limits ) > fd_quic_footprint( &inline_quic->limits ) );
+
+  inline_quic->cb.now              = test_clock;
+  inline_quic->cb.conn_new         = my_connection_new;
+  defer_quic->cb.now               = test_clock;
+  defer_quic->cb.conn_new          = my_connection_new;
+  client_quic->cb.now              = test_clock;
+
+  fd_quic_virtual_pair_t vp;
+  fd_quic_virtual_pair_init( &vp, inline_quic, client_quic );
+
+  FD_TEST( fd_quic_init( inline_quic ) );
+  FD_TEST( fd_quic_init( client_quic ) );
+
+  ulong live_cnt;
+
+  /* With hs_service_max zero, the server processes the ClientHello
+     as soon as it arrives */
+
+  FD_LOG_NOTICE(( "Testing inline handshake" ));
+  FD_TEST( inline_quic->limits.hs_service_max==0UL );
+  test_connect( client_quic, inline_quic );
+  now = fd_ulong_max( now, fd_quic_get_next_wakeup( client_quic ) );
+  fd_quic_service( client_quic );
+  FD_TEST( test_deferred_cnt( inline_quic, &live_cnt )==0UL );
+  FD_TEST( live_cnt==1UL );
+  test_run( inline_quic, client_quic, 1UL );
+
+  fd_quic_virtual_pair_fini( &vp );
+
+  /* With hs_service_max set, ClientHellos wait for fd_quic_service,
+     which advances one of them per call */
+
+  FD_LOG_NOTICE(( "Testing deferred handshakes" ));
+  fd_quic_virtual_pair_init( &vp, defer_quic, client_quic );
+  FD_TEST( fd_quic_init( defer_quic ) );
+
+  for( ulong j=0UL; j<TEST_CONN_CNT; j++ ) test_connect( client_quic, defer_quic );
+  now = fd_ulong_max( now, fd_quic_get_next_wakeup( client_quic ) );
+  fd_quic_service( client_quic );
+  FD_TEST( test_deferred_cnt( defer_quic, &live_cnt )==TEST_CONN_CNT );
+  FD_TEST( live_cnt==TEST_CONN_CNT );
+
+  for( ulong j=1UL; j<=TEST_CONN_CNT; j++ ) {
+    now = fd_ulong_max( now+1UL, fd_quic_get_next_wakeup( defer_quic ) );
+    fd_quic_service( defer_quic );
+    FD_TEST( test_deferred_cnt( defer_quic, &live_cnt )==TEST_CONN_CNT-j );
+    FD_TEST( server_complete==1UL );
+  }
+
+  test_run( defer_quic, client_quic, 1UL+TEST_CONN_CNT );
+  FD_TEST( defer_quic->metrics.conn_err_tls_fail_cnt==0UL );
+
+  FD_LOG_NOTICE(( "Cleaning up" ));
+  fd_quic_virtual_pair_fini( &vp );
+  fd_wksp_free_laddr( fd_quic_delete( fd_quic_leave( fd_quic_fini( inline_quic ) ) ) );
+  fd_wksp_free_laddr( fd_quic_delete( fd_quic_leave( fd_quic_fini( defer_quic  ) ) ) );
+  fd_wksp_free_laddr( fd_quic_delete( fd_quic_leave( fd_quic_fini( client_quic ) ) ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_quic_test_halt();
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,201 @@
+/* test_quic_stream_weight checks that fd_quic_service shares a
+   contended stream pool between conns in proportion to their shortfall
+   from their stream limit times their stream weight, the way the quic
+   tile weighs staked and unstaked peers. */
+
+#include "fd_quic_sandbox.h"
+#include "../fd_quic_private.h"
+
+#define TEST_POOL_CNT      (64UL)
+#define TEST_STAKED_CNT    (128UL) /* stream limit of a staked peer */
+#define TEST_UNSTAKED_CNT  (32UL)  /* stream limit of an unstaked peer */
+#define TEST_STAKED_WEIGHT (8UL)
+
+static ulong
+test_stream_cnt( fd_quic_conn_t const * conn ) {
+  return conn->cur_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_CLIENT ];
+}
+
+/* One staked conn and three unstaked conns ask for more streams than
+   the pool holds, while another conn holds all of it.  Once that conn
+   goes away, the staked conn, with a weight of 8 and a 4 times larger
+   limit, receives most of the streams. */
+
+static __attribute__ ((noinline)) void
+test_quic_stream_weight_share( fd_quic_sandbox_t * sandbox,
+                               fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t *       quic  = sandbox->quic;
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+
+  fd_quic_conn_t * hog = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( hog );
+  fd_quic_conn_t * conn[ 4 ];
+  for( ulong j=0UL; j<4UL; j++ ) {
+    conn[ j ] = fd_quic_sandbox_new_conn_established( sandbox, rng );
+    FD_TEST( conn[ j ] );
+  }
+
+  /* One stream stays reserved for each unused conn */
+
+  fd_quic_conn_set_max_streams( hog, FD_QUIC_TYPE_UNIDIR, TEST_STAKED_CNT );
+  FD_TEST( test_stream_cnt( hog )==TEST_POOL_CNT-state->free_conns );
+
+  fd_quic_conn_set_stream_weight( conn[ 0 ], TEST_STAKED_WEIGHT );
+  fd_quic_conn_set_max_streams( conn[ 0 ], FD_QUIC_TYPE_UNIDIR, TEST_STAKED_CNT );
+  for( ulong j=1UL; j<4UL; j++ ) fd_quic_conn_set_max_streams( conn[ j ], FD_QUIC_TYPE_UNIDIR, TEST_UNSTAKED_CNT );
+  for( ulong j=0UL; j<4UL; j++ ) FD_TEST( !test_stream_cnt( conn[ j ] ) );
+
+  fd_quic_conn_free( quic, hog );
+  ulong avail = TEST_POOL_CNT - state->free_conns;
+  fd_quic_service( quic );
+  FD_TEST( fd_quic_stream_pool_avail( state->stream_pool )==state->free_conns );
+
+  ulong staked_cnt = test_stream_cnt( conn[ 0 ] );
+  ulong total_cnt  = staked_cnt;
+  for( ulong j=1UL; j<4UL; j++ ) {
+    ulong cnt = test_stream_cnt( conn[ j ] );
+    FD_LOG_NOTICE(( "unstaked conn %lu: %lu streams", j, cnt ));
+    FD_TEST( staked_cnt>=TEST_STAKED_WEIGHT*cnt );
+    total_cnt += cnt;
+  }
+  FD_LOG_NOTICE(( "staked conn: %lu streams of %lu", staked_cnt, avail ));
+  FD_TEST( total_cnt==avail );
+
+  /* The staked peer goes away, and an unstaked peer turns out to be
+     staked.  The weight of the live conn is raised, and the streams
+     that came free go mostly to it. */
+
+  ulong before[ 4 ];
+  for( ulong j=1UL; j<4UL; j++ ) before[ j ] = test_stream_cnt( conn[ j ] );
+  fd_quic_conn_free( quic, conn[ 0 ] );
+  fd_quic_conn_set_stream_weight( conn[ 1 ], TEST_STAKED_WEIGHT );
+  fd_quic_conn_set_max_streams( conn[ 1 ], FD_QUIC_TYPE_UNIDIR, TEST_STAKED_CNT );
+  fd_quic_service( quic );
+
+  ulong gain1 = test_stream_cnt( conn[ 1 ] ) - before[ 1 ];
+  ulong gain2 = test_stream_cnt( conn[ 2 ] ) - before[ 2 ];
+  ulong gain3 = test_stream_cnt( conn[ 3 ] ) - before[ 3 ];
+  FD_LOG_NOTICE(( "after reweighing: gained %lu vs %lu and %lu streams", gain1, gain2, gain3 ));
+  FD_TEST( gain1>=4UL*fd_ulong_max( gain2, gain3 ) );
+  FD_TEST( gain1+gain2+gain3==staked_cnt-1UL ); /* the freed conn slot reserves one */
+
+  for( ulong j=1UL; j<4UL; j++ ) fd_quic_conn_free( quic, conn[ j ] );
+}
+
+/* At equal weight, a conn further from its limit receives more of a
+   contended pool. */
+
+static __attribute__ ((noinline)) void
+test_quic_stream_weight_shortfall( fd_quic_sandbox_t * sandbox,
+                                   fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t * quic = sandbox->quic;
+
+  fd_quic_conn_t * hog = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( hog );
+  fd_quic_conn_t * conn[ 2 ];
+  for( ulong j=0UL; j<2UL; j++ ) {
+    conn[ j ] = fd_quic_sandbox_new_conn_established( sandbox, rng );
+    FD_TEST( conn[ j ] );
+  }
+
+  fd_quic_conn_set_max_streams( hog,       FD_QUIC_TYPE_UNIDIR, TEST_STAKED_CNT   );
+  fd_quic_conn_set_max_streams( conn[ 0 ], FD_QUIC_TYPE_UNIDIR, TEST_STAKED_CNT   );
+  fd_quic_conn_set_max_streams( conn[ 1 ], FD_QUIC_TYPE_UNIDIR, TEST_UNSTAKED_CNT );
+  fd_quic_conn_free( quic, hog );
+  fd_quic_service( quic );
+
+  ulong cnt0 = test_stream_cnt( conn[ 0 ] );
+  ulong cnt1 = test_stream_cnt( conn[ 1 ] );
+  FD_LOG_NOTICE(( "limit %lu: %lu streams, limit %lu: %lu streams", TEST_STAKED_CNT, cnt0, TEST_UNSTAKED_CNT, cnt1 ));
+  FD_TEST( cnt1 );
+  FD_TEST( cnt0>=2UL*cnt1 );
+
+  for( ulong j=0UL; j<2UL; j++ ) fd_quic_conn_free( quic, conn[ j ] );
+}
+
+/* Without contention, every conn gets its full limit regardless of
+   weight. */
+
+static __attribute__ ((noinline)) void
+test_quic_stream_weight_uncontended( fd_quic_sandbox_t * sandbox,
+                                     fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t * quic = sandbox->quic;
+
+  fd_quic_conn_t * conn[ 2 ];
+  for( ulong j=0UL; j<2UL; j++ ) {
+    conn[ j ] = fd_quic_sandbox_new_conn_established( sandbox, rng );
+    FD_TEST( conn[ j ] );
+    fd_quic_conn_set_max_streams( conn[ j ], FD_QUIC_TYPE_UNIDIR, 8UL );
+  }
+  fd_quic_conn_set_stream_weight( conn[ 0 ], TEST_STAKED_WEIGHT );
+  fd_quic_service( quic );
+
+  FD_TEST( test_stream_cnt( conn[ 0 ] )==8UL );
+  FD_TEST( test_stream_cnt( conn[ 1 ] )==8UL );
+
+  for( ulong j=0UL; j<2UL; j++ ) fd_quic_conn_free( quic, conn[ j ] );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",  NULL, "normal"                   );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt", NULL, 65536UL                    );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong ( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx(cpu_idx) );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  fd_quic_limits_t quic_limits[1] = {{
+    .conn_cnt         = 8UL,
+    .conn_id_cnt      = 16UL,
+    .handshake_cnt    = 8UL,
+    .inflight_pkt_cnt = 64UL,
+    .tx_buf_sz        = 4096UL,
+    .stream_cnt        [ FD_QUIC_STREAM_TYPE_UNI_CLIENT ] = TEST_STAKED_CNT,
+    .initial_stream_cnt[ FD_QUIC_STREAM_TYPE_UNI_CLIENT ] = TEST_UNSTAKED_CNT,
+    .stream_pool_cnt  = TEST_POOL_CNT
+  }};
+
+  ulong const pkt_cnt = 128UL;
+  ulong const pkt_mtu = 1232UL;
+
+  FD_LOG_NOTICE(( "Creating anonymous workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * sandbox_mem = fd_wksp_alloc_laddr(
+      /* wksp  */ wksp,
+      /* align */ fd_quic_sandbox_align(),
+      /* size  */ fd_quic_sandbox_footprint( quic_limits, pkt_cnt, pkt_mtu ),
+      /* tag   */ 1UL );
+
+  fd_quic_sandbox_t * sandbox = fd_quic_sandbox_join( fd_quic_sandbox_new(
+      sandbox_mem, quic_limits, pkt_cnt, pkt_mtu ) );
+  FD_TEST( sandbox );
+
+  test_quic_stream_weight_share      ( sandbox, rng );
+  test_quic_stream_weight_shortfall  ( sandbox, rng );
+  test_quic_stream_weight_uncontended( sandbox, rng );
+
+  fd_wksp_free_laddr( fd_quic_sandbox_delete( fd_quic_sandbox_leave( sandbox ) ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -193,6 +193,12 @@ main( int     argc,
     }
   }
 
+  /* server learned the client's identity, and can prioritize it */
+  FD_TEST( server_conn );
+  FD_TEST( 0==memcmp( server_conn->peer_identity, client_quic->config.identity_public_key, 32UL ) );
+  fd_quic_conn_set_stream_weight( server_conn, 4UL );
+  FD_TEST( server_conn->stream_weight==4UL );
+
   FD_LOG_NOTICE(( "Running" ));
 
   long cum_sent_cnt = 0L;
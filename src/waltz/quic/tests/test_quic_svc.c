@@ -0,0 +1,245 @@
+/* test_quic_svc exercises the conn service timer wheel of fd_quic. */
+
+#include "fd_quic_sandbox.h"
+#include "../fd_quic_private.h"
+
+/* test_svc_tick returns the wheel tick of time t. */
+
+static ulong
+test_svc_tick( fd_quic_state_t const * state,
+               ulong                   t ) {
+  return t >> state->svc_tick_lg;
+}
+
+/* test_svc_schedule (re)schedules conn for service at t. */
+
+static void
+test_svc_schedule( fd_quic_conn_t * conn,
+                   ulong            t ) {
+  conn->next_service_time = t;
+  fd_quic_schedule_conn( conn );
+}
+
+/* An insert into an empty wheel must not move the cursor past the
+   present.  Otherwise, a later insert with an earlier timeout (e.g. a
+   new conn, which is scheduled at now) is clamped up to the first
+   insert's tick. */
+
+static __attribute__ ((noinline)) void
+test_quic_svc_empty_insert( fd_quic_sandbox_t * sandbox,
+                            fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t *       quic  = sandbox->quic;
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+  ulong const       ival  = fd_quic_get_service_interval( quic );
+  ulong const       tick  = 1UL<<state->svc_tick_lg;
+
+  state->now = 1000000UL;
+
+  fd_quic_conn_t * conn0 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( conn0 );
+  FD_TEST( state->svc_cnt==1UL );
+
+  /* Push conn0 out by a service interval.  This removes and reinserts
+     it, so the insert sees an empty wheel. */
+
+  test_svc_schedule( conn0, state->now + ival );
+  FD_TEST( state->svc_cnt==1UL );
+  FD_TEST( state->svc_tick<=test_svc_tick( state, state->now ) );
+  FD_TEST( fd_quic_get_next_wakeup( quic ) >= state->now + ival - tick );
+  FD_TEST( fd_quic_get_next_wakeup( quic ) <= state->now + ival + tick );
+
+  /* A new conn is scheduled at now and has to be up next */
+
+  fd_quic_conn_t * conn1 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( conn1 );
+  FD_TEST( state->svc_cnt==2UL );
+  FD_TEST( fd_quic_get_next_wakeup( quic ) <= state->now + 2UL*tick );
+
+  sandbox->wallclock = state->now + 2UL*tick;
+  fd_quic_service( quic );
+  FD_TEST( conn1->in_service );
+  FD_TEST( conn1->sched_service_time > sandbox->wallclock );
+  FD_TEST( conn0->sched_service_time==1000000UL + ival ); /* not serviced yet */
+}
+
+/* Inserts past the end of the slot array wrap around to the start and
+   are still returned in time order. */
+
+static __attribute__ ((noinline)) void
+test_quic_svc_wrap( fd_quic_sandbox_t * sandbox,
+                    fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t *       quic  = sandbox->quic;
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+  int const         lg    = state->svc_tick_lg;
+
+  /* Place the cursor 4 slots before the end of the slot array */
+
+  ulong t0 = ( 7UL*FD_QUIC_SVC_SLOT_CNT - 4UL ) << lg;
+  sandbox->wallclock = t0;
+  fd_quic_service( quic );
+  FD_TEST( state->now==t0 );
+
+  fd_quic_conn_t * conn0 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  fd_quic_conn_t * conn1 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( conn0 && conn1 );
+
+  test_svc_schedule( conn0, t0 + ( 10UL<<lg ) );
+  test_svc_schedule( conn1, t0 + (  2UL<<lg ) );
+  FD_TEST( conn0->svc_slot < 8UL );                      /* wrapped */
+  FD_TEST( conn1->svc_slot==FD_QUIC_SVC_SLOT_CNT-2UL );  /* not wrapped */
+  FD_TEST( fd_quic_get_next_wakeup( quic )==t0 + ( 2UL<<lg ) );
+
+  sandbox->wallclock = t0 + ( 2UL<<lg );
+  fd_quic_service( quic );
+  FD_TEST( conn1->sched_service_time > sandbox->wallclock );
+  FD_TEST( conn0->sched_service_time==t0 + ( 10UL<<lg ) );
+  FD_TEST( fd_quic_get_next_wakeup( quic )==t0 + ( 10UL<<lg ) );
+
+  sandbox->wallclock = t0 + ( 10UL<<lg );
+  fd_quic_service( quic );
+  FD_TEST( conn0->sched_service_time > sandbox->wallclock );
+}
+
+/* Timeouts beyond the horizon of the wheel fire early at the last slot
+   instead of wrapping around to an earlier slot. */
+
+static __attribute__ ((noinline)) void
+test_quic_svc_clamp( fd_quic_sandbox_t * sandbox,
+                     fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t *       quic  = sandbox->quic;
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+  int const         lg    = state->svc_tick_lg;
+
+  ulong t0 = 1000000UL;
+  sandbox->wallclock = t0;
+  fd_quic_service( quic );
+
+  fd_quic_conn_t * conn0 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  fd_quic_conn_t * conn1 = fd_quic_sandbox_new_conn_established( sandbox, rng );
+  FD_TEST( conn0 && conn1 );
+
+  test_svc_schedule( conn0, t0 + ( 1UL<<lg ) );
+  test_svc_schedule( conn1, t0 + ( 5UL*FD_QUIC_SVC_SLOT_CNT<<lg ) );
+
+  ulong horizon = ( state->svc_tick + FD_QUIC_SVC_SLOT_CNT - 1UL ) << lg;
+  FD_TEST( conn1->svc_slot==( (horizon>>lg) & (FD_QUIC_SVC_SLOT_CNT-1UL) ) );
+  FD_TEST( fd_quic_get_next_wakeup( quic ) <= t0 + ( 2UL<<lg ) );
+
+  /* conn1 is still pending right before the horizon */
+
+  sandbox->wallclock = horizon - 1UL;
+  fd_quic_service( quic );
+  FD_TEST( conn1->sched_service_time==t0 + ( 5UL*FD_QUIC_SVC_SLOT_CNT<<lg ) );
+  FD_TEST( fd_quic_get_next_wakeup( quic )==horizon );
+
+  sandbox->wallclock = horizon;
+  fd_quic_service( quic );
+  FD_TEST( conn1->sched_service_time > horizon );
+}
+
+/* If fd_quic_service is not called for more than a revolution, every
+   conn in the wheel is serviced on the next call, including those in
+   the slot right after the cursor. */
+
+static __attribute__ ((noinline)) void
+test_quic_svc_overrun( fd_quic_sandbox_t * sandbox,
+                       fd_rng_t *          rng ) {
+
+  fd_quic_sandbox_init( sandbox, FD_QUIC_ROLE_SERVER );
+  fd_quic_t *       quic  = sandbox->quic;
+  fd_quic_state_t * state = fd_quic_get_state( quic );
+  int const         lg    = state->svc_tick_lg;
+
+  ulong t0 = 1000000UL;
+  sandbox->wallclock = t0;
+  fd_quic_service( quic );
+
+# define CONN_CNT 8UL
+  fd_quic_conn_t * conn[ CONN_CNT ];
+  for( ulong j=0UL; j<CONN_CNT; j++ ) {
+    conn[j] = fd_quic_sandbox_new_conn_established( sandbox, rng );
+    FD_TEST( conn[j] );
+  }
+
+  /* Spread conns over the wheel, including the last slot of the
+     revolution */
+
+  ulong base = state->svc_tick;
+  for( ulong j=0UL; j<CONN_CNT; j++ ) {
+    ulong t = ( base + 1UL + j*( (FD_QUIC_SVC_SLOT_CNT-2UL)/(CONN_CNT-1UL) ) ) << lg;
+    test_svc_schedule( conn[j], t );
+  }
+  FD_TEST( conn[CONN_CNT-1UL]->svc_slot==( (base+FD_QUIC_SVC_SLOT_CNT-1UL) & (FD_QUIC_SVC_SLOT_CNT-1UL) ) );
+
+  /* Skip ahead by several revolutions in one step */
+
+  ulong t1 = ( base + 3UL*FD_QUIC_SVC_SLOT_CNT + 7UL ) << lg;
+  sandbox->wallclock = t1;
+  fd_quic_service( quic );
+
+  for( ulong j=0UL; j<CONN_CNT; j++ ) {
+    FD_TEST( conn[j]->in_service );
+    FD_TEST( conn[j]->sched_service_time > t1 );
+  }
+  FD_TEST( state->svc_cnt==CONN_CNT );
+  FD_TEST( state->svc_tick > test_svc_tick( state, t1 ) );
+  FD_TEST( fd_quic_get_next_wakeup( quic ) > t1 );
+# undef CONN_CNT
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",  NULL, "gigantic"                 );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt", NULL, 2UL                        );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong ( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx(cpu_idx) );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  fd_quic_limits_t quic_limits[1] = {{0}};
+  fd_quic_limits_from_env( &argc, &argv, quic_limits );
+
+  ulong const pkt_cnt = 128UL;
+  ulong const pkt_mtu = 1232UL;
+
+  FD_LOG_NOTICE(( "Creating anonymous workspace with --page-cnt %lu --page-sz %s pages on --numa-idx %lu", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  void * sandbox_mem = fd_wksp_alloc_laddr(
+      /* wksp  */ wksp,
+      /* align */ fd_quic_sandbox_align(),
+      /* size  */ fd_quic_sandbox_footprint( quic_limits, pkt_cnt, pkt_mtu ),
+      /* tag   */ 1UL );
+
+  fd_quic_sandbox_t * sandbox = fd_quic_sandbox_join( fd_quic_sandbox_new(
+      sandbox_mem, quic_limits, pkt_cnt, pkt_mtu ) );
+  FD_TEST( sandbox );
+
+  test_quic_svc_empty_insert( sandbox, rng );
+  test_quic_svc_wrap        ( sandbox, rng );
+  test_quic_svc_clamp       ( sandbox, rng );
+  test_quic_svc_overrun     ( sandbox, rng );
+
+  fd_wksp_free_laddr( fd_quic_sandbox_delete( fd_quic_sandbox_leave( sandbox ) ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
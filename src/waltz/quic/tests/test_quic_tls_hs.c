@@ -98,7 +98,7 @@ main( int     argc,
   fflush( stdout );
 
   ulong tls_align     = fd_quic_tls_align();
-  ulong tls_footprint = fd_quic_tls_footprint( cfg.max_concur_handshakes );
+  ulong tls_footprint = fd_quic_tls_footprint( cfg.max_concur_handshakes, cfg.rx_defer );
 
   FD_LOG_INFO(( "fd_quic_tls_t align:     %lu bytes", tls_align     ));
   FD_LOG_INFO(( "fd_quic_tls_t footprint: %lu bytes", tls_footprint ));
@@ -72,11 +72,13 @@ fd_quic_tls_align( void ) {
 struct fd_quic_tls_layout {
   ulong handshakes_off;
   ulong handshakes_used_off;
+  ulong rx_defer_bufs_off;
 };
 typedef struct fd_quic_tls_layout fd_quic_tls_layout_t;
 
 ulong
 fd_quic_tls_footprint_ext( ulong handshake_cnt,
+                           int   rx_defer,
                            fd_quic_tls_layout_t * layout ) {
 
   ulong off  = sizeof( fd_quic_tls_t );
@@ -89,13 +91,19 @@ fd_quic_tls_footprint_ext( ulong handshake_cnt,
   layout->handshakes_used_off = off;
         off += handshake_cnt; /* used handshakes */
 
+        /* no align required */
+  layout->rx_defer_bufs_off = off;
+  if( rx_defer )
+        off += handshake_cnt * FD_QUIC_TLS_RX_DEFER_SZ;
+
   return off;
 }
 
 ulong
-fd_quic_tls_footprint( ulong handshake_cnt ) {
+fd_quic_tls_footprint( ulong handshake_cnt,
+                       int   rx_defer ) {
   fd_quic_tls_layout_t layout;
-  return fd_quic_tls_footprint_ext( handshake_cnt, &layout );
+  return fd_quic_tls_footprint_ext( handshake_cnt, rx_defer, &layout );
 }
 
 static void
@@ -124,7 +132,7 @@ fd_quic_tls_new( void *              mem,
   ulong handshake_cnt = cfg->max_concur_handshakes;
 
   fd_quic_tls_layout_t layout = {0};
-  ulong footprint = fd_quic_tls_footprint_ext( handshake_cnt, &layout );
+  ulong footprint = fd_quic_tls_footprint_ext( handshake_cnt, cfg->rx_defer, &layout );
   if( FD_UNLIKELY( !footprint ) ) {
     FD_LOG_WARNING(( "invalid footprint for config" ));
     return NULL;
@@ -149,6 +157,8 @@ fd_quic_tls_new( void *              mem,
   // set all to free
   fd_memset( used_handshakes, 0, (ulong)self->max_concur_handshakes );
 
+  self->rx_defer_bufs = cfg->rx_defer ? (uchar *)mem + layout.rx_defer_bufs_off : NULL;
+
   /* Initialize fd_tls */
   fd_quic_tls_init( &self->tls, cfg->signer, cfg->cert_public_key );
 
@@ -362,6 +372,24 @@ fd_quic_tls_provide_data( fd_quic_tls_hs_t * self,
   return FD_QUIC_TLS_SUCCESS;
 }
 
+int
+fd_quic_tls_defer_data( fd_quic_tls_hs_t * self,
+                        uint               enc_level,
+                        uchar const *      data,
+                        ulong              data_sz ) {
+
+  ulong defer_sz = self->rx_defer_sz;
+  if( FD_UNLIKELY( !self->quic_tls->rx_defer_bufs                   ) ) return FD_QUIC_TLS_FAILED;
+  if( FD_UNLIKELY( defer_sz && self->rx_defer_enc_level!=enc_level ) ) return FD_QUIC_TLS_FAILED;
+  if( FD_UNLIKELY( data_sz > FD_QUIC_TLS_RX_DEFER_SZ - defer_sz     ) ) return FD_QUIC_TLS_FAILED;
+
+  fd_memcpy( fd_quic_tls_hs_rx_defer_buf( self ) + defer_sz, data, data_sz );
+  self->rx_defer_enc_level = enc_level;
+  self->rx_defer_sz        = (uint)( defer_sz + data_sz );
+
+  return FD_QUIC_TLS_SUCCESS;
+}
+
 int
 fd_quic_tls_process( fd_quic_tls_hs_t * self ) {
   if( self->state != FD_QUIC_TLS_HS_STATE_NEED_SERVICE ) return FD_QUIC_TLS_SUCCESS;
@@ -63,6 +63,11 @@
    must be a multiple of FD_QUIC_TLS_HS_DATA_ALIGN */
 #define FD_QUIC_TLS_HS_DATA_SZ  (1u<<14u)
 
+/* number of bytes allocated for received handshake data whose
+   processing was deferred (see fd_quic_tls_defer_data).  Large enough
+   for a typical ClientHello. */
+#define FD_QUIC_TLS_RX_DEFER_SZ (2048u)
+
 /* callback function prototypes */
 
 typedef void
@@ -95,6 +100,11 @@ struct fd_quic_tls_cfg {
 
   ulong          max_concur_handshakes;
 
+  /* rx_defer: if non-zero, a FD_QUIC_TLS_RX_DEFER_SZ byte buffer is
+     reserved for each handshake so fd_quic_tls_defer_data can be
+     used */
+  int            rx_defer;
+
   /* Signing callback for TLS 1.3 CertificateVerify. Context of the
      signer must outlive the tls object. */
   fd_tls_sign_t signer;
@@ -127,6 +137,10 @@ struct __attribute__((aligned(128))) fd_quic_tls {
   fd_quic_tls_hs_t *                   handshakes;
   uchar *                              used_handshakes;
 
+  /* FD_QUIC_TLS_RX_DEFER_SZ bytes of deferred handshake data per
+     handshake, NULL if rx_defer was not requested */
+  uchar *                              rx_defer_bufs;
+
   /* ssl related */
   fd_tls_t tls;
 };
@@ -190,6 +204,13 @@ struct fd_quic_tls_hs {
   /* TLS alert code */
   uint  alert;
 
+  /* received handshake data not yet provided to fd_tls, kept in
+     fd_quic_tls_hs_rx_defer_buf
+     rx_defer_sz==0 implies nothing is deferred
+     all deferred data belongs to rx_defer_enc_level */
+  uint  rx_defer_enc_level;
+  uint  rx_defer_sz;
+
   /* buffer peer's QUIC transport params.  TODO This is annoying and a
      remnant from OpenSSL times.  fd_quic_conn already has a transport
      params buffer.  Instead, we should callback chain as such when the
@@ -209,8 +230,13 @@ struct fd_quic_tls_hs {
 ulong
 fd_quic_tls_align( void );
 
+/* fd_quic_tls_footprint returns the footprint of an fd_quic_tls_t for
+   handshake_cnt handshakes.  rx_defer should match the rx_defer config
+   later given to fd_quic_tls_new. */
+
 ulong
-fd_quic_tls_footprint( ulong handshake_cnt );
+fd_quic_tls_footprint( ulong handshake_cnt,
+                       int   rx_defer );
 
 /* fd_quic_tls_new formats an unused memory region for use as an
    fd_quic_tls_t object and joins the caller to it */
@@ -262,6 +288,34 @@ fd_quic_tls_provide_data( fd_quic_tls_hs_t * self,
                           uchar const *      data,
                           ulong              data_sz );
 
+/* fd_quic_tls_defer_data buffers an incoming QUIC CRYPTO frame instead
+   of forwarding it to the TLS implementation.  This allows the caller
+   to postpone the expensive part of the handshake (key exchange and
+   CertificateVerify signing) to a later point in time.  Deferred data
+   is appended to any data deferred earlier.  The caller later forwards
+   the buffered bytes via fd_quic_tls_provide_data using
+   fd_quic_tls_hs_rx_defer_buf, rx_defer_sz and rx_defer_enc_level.
+
+   returns
+     FD_QUIC_TLS_SUCCESS  data was buffered
+     FD_QUIC_TLS_FAILED   deferral is not enabled, data did not fit, or
+                          has a different enc_level than data already
+                          deferred.  Nothing was buffered. */
+int
+fd_quic_tls_defer_data( fd_quic_tls_hs_t * self,
+                        uint               enc_level,
+                        uchar const *      data,
+                        ulong              data_sz );
+
+/* fd_quic_tls_hs_rx_defer_buf returns the buffer holding the data
+   deferred by fd_quic_tls_defer_data.  Only valid if the fd_quic_tls_t
+   was created with rx_defer. */
+
+static inline uchar *
+fd_quic_tls_hs_rx_defer_buf( fd_quic_tls_hs_t * self ) {
+  fd_quic_tls_t * quic_tls = self->quic_tls;
+  return quic_tls->rx_defer_bufs + (ulong)( self - quic_tls->handshakes ) * FD_QUIC_TLS_RX_DEFER_SZ;
+}
 
 /* fd_quic_tls_get_hs_data
 